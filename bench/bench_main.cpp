@@ -0,0 +1,5 @@
+#include <benchmark/benchmark.h>
+
+#include "nll/instrumentation/allocation_hooks.hpp"
+
+BENCHMARK_MAIN();
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace nll {
+namespace bench {
+
+/// @brief Smallest and largest container sizes every size sweep covers, from
+/// a few cache lines to well past the last level cache
+constexpr std::int64_t kMinSize = 1 << 4;
+constexpr std::int64_t kMaxSize = 1 << 24;
+
+/// @brief Generates the keys 0..count-1 in increasing order
+inline std::vector<int> SequentialKeys(std::size_t count) {
+  std::vector<int> keys(count);
+  std::iota(keys.begin(), keys.end(), 0);
+  return keys;
+}
+
+/// @brief Generates the keys 0..count-1 in a random order
+inline std::vector<int> ShuffledKeys(std::size_t count, unsigned seed = 42) {
+  auto keys = SequentialKeys(count);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(seed));
+  return keys;
+}
+
+/// @brief Sweeps kMinSize..kMaxSize, each with keys visited in sequential
+/// (random=0) and shuffled (random=1) order. Use with ->Apply().
+inline void SizesAndPatterns(benchmark::internal::Benchmark* benchmark) {
+  benchmark
+      ->ArgsProduct({benchmark::CreateRange(kMinSize, kMaxSize, 8), {0, 1}})
+      ->ArgNames({"size", "random"});
+}
+
+/// @brief Generates the keys for a SizesAndPatterns benchmark
+inline std::vector<int> KeysFor(const benchmark::State& state) {
+  auto count = static_cast<std::size_t>(state.range(0));
+  return state.range(1) ? ShuffledKeys(count) : SequentialKeys(count);
+}
+
+/// @brief Draws count keys from 0..universe-1 with Zipf's law: key k comes
+/// up with probability proportional to 1 / (k + 1)^skew, so a few keys
+/// dominate like in real caching workloads. skew 0.99 is YCSB's default.
+inline std::vector<int> ZipfianKeys(std::size_t count, std::size_t universe,
+                                    double skew = 0.99, unsigned seed = 42) {
+  std::vector<double> cdf(universe);
+  double total = 0;
+  for (std::size_t k = 0; k < universe; k++) {
+    total += 1.0 / std::pow(static_cast<double>(k + 1), skew);
+    cdf[k] = total;
+  }
+  std::mt19937 random(seed);
+  std::uniform_real_distribution<double> uniform(0, total);
+  std::vector<int> keys(count);
+  for (auto& key : keys) {
+    auto it = std::lower_bound(cdf.begin(), cdf.end(), uniform(random));
+    key = static_cast<int>(
+        std::min<std::size_t>(it - cdf.begin(), universe - 1));
+  }
+  return keys;
+}
+
+}  // namespace bench
+}  // namespace nll
@@ -0,0 +1,123 @@
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "scoped_counters.hpp"
+#include "nll/collections/cache.hpp"
+
+namespace {
+
+/// @brief Distinct keys of the workload; the cache holds 1/16 of them
+constexpr std::size_t kUniverse = 1 << 20;
+constexpr std::size_t kCapacity = kUniverse / 16;
+/// @brief Operations each thread replays, a power of two for cheap wrapping
+constexpr std::size_t kOperations = 1 << 18;
+
+/// @brief Zipfian keys, a different stream per thread
+std::vector<int> ThreadKeys(const benchmark::State& state) {
+  return nll::bench::ZipfianKeys(kOperations, kUniverse, 0.99,
+                                 42 + static_cast<unsigned>(
+                                          state.thread_index()));
+}
+
+nll::CacheOptions Options(nll::EvictionPolicy policy) {
+  nll::CacheOptions options;
+  options.capacity = kCapacity;
+  options.policy = policy;
+  return options;
+}
+
+/// @brief Single threaded Cache behind one mutex, the simplest thread safe
+/// cache to compare sharding against
+class MutexCache {
+ public:
+  explicit MutexCache(const nll::CacheOptions& options) : cache(options) {}
+
+  std::optional<int> Get(int key) {
+    std::lock_guard guard(mutex);
+    return cache.Get(key);
+  }
+
+  bool Put(int key, int value) {
+    std::lock_guard guard(mutex);
+    return cache.Put(key, value);
+  }
+
+  nll::CacheStats Stats() const { return cache.Stats(); }
+
+ private:
+  std::mutex mutex;
+  nll::Cache<int, int> cache;
+};
+
+}  // namespace
+
+/// @brief Cache-aside reads: every thread looks up Zipfian keys and puts the
+/// ones it misses, sharing one cache. Reports the hit rate the policy
+/// reached.
+template <class TCache, nll::EvictionPolicy kPolicy>
+static void BM_CacheZipfian(benchmark::State& state) {
+  static std::unique_ptr<TCache> cache;
+  static nll::CacheStats warm;
+  auto keys = ThreadKeys(state);
+  if (state.thread_index() == 0) {
+    // Fill the cache first so the hit rate is the steady state one
+    cache = std::make_unique<TCache>(Options(kPolicy));
+    for (auto key : keys) {
+      if (!cache->Get(key)) {
+        cache->Put(key, key);
+      }
+    }
+    warm = cache->Stats();
+  }
+  // Allocations are counted across threads, hardware events on the first
+  std::optional<nll::bench::ScopedCounters> counters;
+  if (state.thread_index() == 0) {
+    counters.emplace(state);
+  }
+  std::size_t i = 0;
+  for (auto _ : state) {
+    auto key = keys[i++ & (kOperations - 1)];
+    auto value = cache->Get(key);
+    if (!value) {
+      cache->Put(key, key);
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    auto stats = cache->Stats();
+    stats.hits -= warm.hits;
+    stats.misses -= warm.misses;
+    state.counters["hit_rate"] = stats.HitRate();
+    cache.reset();
+  }
+}
+
+using SingleThreadedCache = nll::Cache<int, int>;
+using ShardedCache = nll::ConcurrentCache<int, int>;
+
+BENCHMARK_TEMPLATE(BM_CacheZipfian, SingleThreadedCache,
+                   nll::EvictionPolicy::kLru);
+BENCHMARK_TEMPLATE(BM_CacheZipfian, SingleThreadedCache,
+                   nll::EvictionPolicy::kClock);
+BENCHMARK_TEMPLATE(BM_CacheZipfian, SingleThreadedCache,
+                   nll::EvictionPolicy::kTinyLfu);
+BENCHMARK_TEMPLATE(BM_CacheZipfian, MutexCache, nll::EvictionPolicy::kLru)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_CacheZipfian, ShardedCache, nll::EvictionPolicy::kLru)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_CacheZipfian, ShardedCache, nll::EvictionPolicy::kClock)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_CacheZipfian, ShardedCache,
+                   nll::EvictionPolicy::kTinyLfu)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
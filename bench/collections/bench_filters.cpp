@@ -0,0 +1,176 @@
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <unordered_set>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "nll/collections/bloom_filter.hpp"
+#include "nll/collections/cuckoo_filter.hpp"
+#include "nll/collections/hashmap.hpp"
+#include "scoped_counters.hpp"
+
+namespace {
+
+/// @brief Keys never inserted: the inserted keys are 0..size-1
+std::vector<int> MissingKeys(std::size_t count) {
+  auto keys = nll::bench::ShuffledKeys(count, 7);
+  for (auto& key : keys) {
+    key = -key - 1;
+  }
+  return keys;
+}
+
+/// @brief Sweeps filter sizes at a 1% false positive rate
+void FilterSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->RangeMultiplier(16)
+      ->Range(1 << 10, 1 << 22)
+      ->ArgName("size");
+}
+
+/// @brief Sweeps false positive rates of 10^-1 to 10^-max_exponent
+template <int max_exponent>
+void FalsePositiveRates(benchmark::internal::Benchmark* benchmark) {
+  benchmark->DenseRange(1, max_exponent)->ArgName("rate_exponent");
+}
+
+/// @brief Reports the false positive rate measured over keys that were never
+/// inserted, and the memory spent per inserted key
+template <class TFilter>
+void ReportAccuracy(benchmark::State& state, const TFilter& filter,
+                    std::size_t inserted) {
+  auto missing = MissingKeys(std::max<std::size_t>(inserted, 100000));
+  std::size_t accepted = 0;
+  for (auto key : missing) {
+    accepted += filter.MayContain(key);
+  }
+  state.counters["fpr"] =
+      static_cast<double>(accepted) / static_cast<double>(missing.size());
+  state.counters["bits_per_key"] =
+      8.0 * static_cast<double>(filter.MemoryBytes()) /
+      static_cast<double>(inserted);
+}
+
+template <class TFilter>
+void BuildFilter(TFilter& filter, std::size_t size) {
+  auto keys = nll::bench::SequentialKeys(size);
+  filter.InsertBatch(keys.begin(), keys.end());
+}
+
+}  // namespace
+
+/// @brief Negative lookups one at a time, the use a filter is there for
+template <class TFilter>
+static void BM_FilterMayContain(benchmark::State& state) {
+  auto size = static_cast<std::size_t>(state.range(0));
+  TFilter filter(size, 0.01);
+  BuildFilter(filter, size);
+  auto queries = MissingKeys(size);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto key : queries) {
+      benchmark::DoNotOptimize(filter.MayContain(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+  ReportAccuracy(state, filter, size);
+}
+
+/// @brief The same lookups through MayContainBatch, which prefetches ahead
+template <class TFilter>
+static void BM_FilterMayContainBatch(benchmark::State& state) {
+  auto size = static_cast<std::size_t>(state.range(0));
+  TFilter filter(size, 0.01);
+  BuildFilter(filter, size);
+  auto queries = MissingKeys(size);
+  std::vector<char> results(queries.size());
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    filter.MayContainBatch(queries.begin(), queries.end(), results.begin());
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+template <class TFilter>
+static void BM_FilterInsertBatch(benchmark::State& state) {
+  auto size = static_cast<std::size_t>(state.range(0));
+  auto keys = nll::bench::ShuffledKeys(size);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    TFilter filter(size, 0.01);
+    filter.InsertBatch(keys.begin(), keys.end());
+    benchmark::DoNotOptimize(filter.MemoryBytes());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+/// @brief Exact membership the filters stand in for
+static void BM_HashmapContainsMissingKeys(benchmark::State& state) {
+  auto size = static_cast<std::size_t>(state.range(0));
+  nll::Hashmap<int, bool> map;
+  for (auto key : nll::bench::SequentialKeys(size)) {
+    map.Insert(key, true);
+  }
+  auto queries = MissingKeys(size);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto key : queries) {
+      benchmark::DoNotOptimize(map.Contains(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+static void BM_StdUnorderedSetCountMissingKeys(benchmark::State& state) {
+  auto size = static_cast<std::size_t>(state.range(0));
+  auto keys = nll::bench::SequentialKeys(size);
+  std::unordered_set<int> set(keys.begin(), keys.end());
+  auto queries = MissingKeys(size);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto key : queries) {
+      benchmark::DoNotOptimize(set.count(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+/// @brief Measured false positive rate and bits per key against the target.
+/// The timing is incidental; the counters are the result. The key count
+/// fills a cuckoo filter to 92%: its bucket count is a power of two, so
+/// other sizes can leave up to half the table empty.
+template <class TFilter>
+static void BM_FilterAccuracy(benchmark::State& state) {
+  constexpr std::size_t kSize = 60000;
+  auto target = std::pow(10.0, -static_cast<double>(state.range(0)));
+  TFilter filter(kSize, target);
+  for (auto _ : state) {
+    BuildFilter(filter, kSize);
+  }
+  state.counters["target_fpr"] = target;
+  ReportAccuracy(state, filter, kSize);
+}
+
+using BloomFilter = nll::BlockedBloomFilter<int>;
+using CuckooFilter8 = nll::CuckooFilter<int, std::hash<int>, std::uint8_t>;
+using CuckooFilter16 = nll::CuckooFilter<int>;
+
+BENCHMARK_TEMPLATE(BM_FilterMayContain, BloomFilter)->Apply(FilterSizes);
+BENCHMARK_TEMPLATE(BM_FilterMayContain, CuckooFilter16)->Apply(FilterSizes);
+BENCHMARK_TEMPLATE(BM_FilterMayContainBatch, BloomFilter)->Apply(FilterSizes);
+BENCHMARK_TEMPLATE(BM_FilterMayContainBatch, CuckooFilter16)
+    ->Apply(FilterSizes);
+BENCHMARK_TEMPLATE(BM_FilterInsertBatch, BloomFilter)->Apply(FilterSizes);
+BENCHMARK_TEMPLATE(BM_FilterInsertBatch, CuckooFilter16)->Apply(FilterSizes);
+BENCHMARK(BM_HashmapContainsMissingKeys)->Apply(FilterSizes);
+BENCHMARK(BM_StdUnorderedSetCountMissingKeys)->Apply(FilterSizes);
+// Fingerprints of 8 bits reach 3%, of 16 bits about 0.01%
+BENCHMARK_TEMPLATE(BM_FilterAccuracy, BloomFilter)
+    ->Apply(FalsePositiveRates<4>);
+BENCHMARK_TEMPLATE(BM_FilterAccuracy, CuckooFilter8)
+    ->Apply(FalsePositiveRates<1>);
+BENCHMARK_TEMPLATE(BM_FilterAccuracy, CuckooFilter16)
+    ->Apply(FalsePositiveRates<3>);
@@ -0,0 +1,149 @@
+#include "nll/collections/frozen_hashmap.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "nll/collections/hashmap.hpp"
+#include "nll/instrumentation/allocation_tracker.hpp"
+#include "scoped_counters.hpp"
+
+namespace {
+
+using IntFrozenHashmap = nll::FrozenHashmap<int, int>;
+
+/// @brief Sizes and lookup orders, stopping at 4M keys so the setup builds
+/// stay short
+void FrozenSizesAndPatterns(benchmark::internal::Benchmark* benchmark) {
+  benchmark
+      ->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 22, 8), {0, 1}})
+      ->ArgNames({"size", "random"});
+}
+
+std::vector<std::pair<int, int>> EntriesFor(const benchmark::State& state) {
+  std::vector<std::pair<int, int>> entries;
+  for (auto key : nll::bench::SequentialKeys(state.range(0))) {
+    entries.emplace_back(key, key);
+  }
+  return entries;
+}
+
+void ReportBytesPerKey(benchmark::State& state, std::size_t bytes) {
+  state.counters["bytes_per_key"] =
+      static_cast<double>(bytes) / static_cast<double>(state.range(0));
+}
+
+/// @brief Reports the heap the container returned by build keeps live
+template <class TBuild>
+auto BuildAndReportBytes(benchmark::State& state, TBuild build) {
+  auto before = nll::instrumentation::AllocationTracker::Snapshot();
+  auto container = build();
+  auto after = nll::instrumentation::AllocationTracker::Snapshot();
+  ReportBytesPerKey(state, after.LiveBytes() - before.LiveBytes());
+  return container;
+}
+
+template <class TMap>
+void LookupEveryKey(benchmark::State& state, const TMap& map) {
+  auto keys = nll::bench::KeysFor(state);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto key : keys) {
+      benchmark::DoNotOptimize(map.Find(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+}  // namespace
+
+/// @brief Builds the perfect hash function and the table. bytes_per_key
+/// counts the pilots and entries the map keeps.
+static void BM_FrozenHashmapBuild(benchmark::State& state) {
+  auto entries = EntriesFor(state);
+  std::size_t bytes = 0;
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    auto map = IntFrozenHashmap::FromRange(entries.begin(), entries.end());
+    bytes = map.SizeInBytes();
+    benchmark::DoNotOptimize(map);
+  }
+  state.SetItemsProcessed(state.iterations() * entries.size());
+  ReportBytesPerKey(state, bytes);
+}
+
+static void BM_FrozenHashmapFind(benchmark::State& state) {
+  auto entries = EntriesFor(state);
+  auto map = BuildAndReportBytes(state, [&] {
+    return IntFrozenHashmap::FromRange(entries.begin(), entries.end());
+  });
+  LookupEveryKey(state, map);
+}
+
+/// @brief Lookups straight from a mapped file, pages faulted in up front
+static void BM_MappedFrozenHashmapFind(benchmark::State& state) {
+  auto entries = EntriesFor(state);
+  auto path = (std::filesystem::temp_directory_path() /
+               "nll_bench_frozen_hashmap.bin")
+                  .string();
+  IntFrozenHashmap::FromRange(entries.begin(), entries.end())
+      .WriteFile(path);
+  nll::FrozenHashmapFileOptions options;
+  options.populate = true;
+  {
+    auto map = IntFrozenHashmap::MapFile(path, options);
+    ReportBytesPerKey(state, std::filesystem::file_size(path));
+    LookupEveryKey(state, map);
+  }
+  std::filesystem::remove(path);
+}
+
+static void BM_HashmapFind(benchmark::State& state) {
+  auto entries = EntriesFor(state);
+  auto map = BuildAndReportBytes(state, [&] {
+    nll::Hashmap<int, int> map;
+    for (const auto& [key, value] : entries) {
+      map.Insert(key, value);
+    }
+    return map;
+  });
+  auto keys = nll::bench::KeysFor(state);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto key : keys) {
+      benchmark::DoNotOptimize(map.Find(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_StdUnorderedMapFind(benchmark::State& state) {
+  auto entries = EntriesFor(state);
+  auto map = BuildAndReportBytes(state, [&] {
+    return std::unordered_map<int, int>(entries.begin(), entries.end());
+  });
+  auto keys = nll::bench::KeysFor(state);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto key : keys) {
+      benchmark::DoNotOptimize(map.find(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK(BM_FrozenHashmapBuild)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 22)
+    ->ArgName("size")
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FrozenHashmapFind)->Apply(FrozenSizesAndPatterns);
+BENCHMARK(BM_MappedFrozenHashmapFind)->Apply(FrozenSizesAndPatterns);
+BENCHMARK(BM_HashmapFind)->Apply(FrozenSizesAndPatterns);
+BENCHMARK(BM_StdUnorderedMapFind)->Apply(FrozenSizesAndPatterns);
@@ -0,0 +1,146 @@
+#include "nll/collections/hashmap.hpp"
+
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "nll/instrumentation/tracking_allocator.hpp"
+#include "scoped_counters.hpp"
+
+static void BM_HashmapInsert(benchmark::State& state) {
+  auto keys = nll::bench::KeysFor(state);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::Hashmap<int, int> map;
+    for (auto key : keys) {
+      map.Insert(key, key);
+    }
+    benchmark::DoNotOptimize(map.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_StdUnorderedMapInsert(benchmark::State& state) {
+  using Allocator =
+      nll::instrumentation::TrackingAllocator<std::pair<const int, int>>;
+  auto keys = nll::bench::KeysFor(state);
+  nll::instrumentation::MemoryStats memory;
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+                       Allocator>
+        map(0, std::hash<int>(), std::equal_to<int>(), Allocator(&memory));
+    for (auto key : keys) {
+      map.insert_or_assign(key, key);
+    }
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+  state.counters["peak_bytes_per_entry"] =
+      static_cast<double>(memory.peak_bytes) / keys.size();
+}
+
+static void BM_HashmapGet(benchmark::State& state) {
+  auto keys = nll::bench::KeysFor(state);
+  nll::Hashmap<int, int> map;
+  for (auto key : nll::bench::SequentialKeys(keys.size())) {
+    map.Insert(key, key);
+  }
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto key : keys) {
+      benchmark::DoNotOptimize(map.Get(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_StdUnorderedMapAt(benchmark::State& state) {
+  auto keys = nll::bench::KeysFor(state);
+  std::unordered_map<int, int> map;
+  for (auto key : nll::bench::SequentialKeys(keys.size())) {
+    map.emplace(key, key);
+  }
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto key : keys) {
+      benchmark::DoNotOptimize(map.at(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_HashmapContainsMissing(benchmark::State& state) {
+  auto keys = nll::bench::KeysFor(state);
+  nll::Hashmap<int, int> map;
+  for (auto key : keys) {
+    map.Insert(key, key);
+  }
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto key : keys) {
+      benchmark::DoNotOptimize(map.Contains(-key - 1));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_StdUnorderedMapCountMissing(benchmark::State& state) {
+  auto keys = nll::bench::KeysFor(state);
+  std::unordered_map<int, int> map;
+  for (auto key : keys) {
+    map.emplace(key, key);
+  }
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto key : keys) {
+      benchmark::DoNotOptimize(map.count(-key - 1));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+/// @brief Get under a tuning policy. A stats-enabled twin of the map,
+/// filled and probed outside the timed loop, reports the chain walk and
+/// bucket overhead behind the timing.
+template <class TPolicy>
+static void BM_HashmapGetWithPolicy(benchmark::State& state) {
+  auto keys = nll::bench::KeysFor(state);
+  nll::Hashmap<int, int, TPolicy> map;
+  nll::Hashmap<int, int, nll::WithStats<TPolicy>> twin;
+  for (auto key : nll::bench::SequentialKeys(keys.size())) {
+    map.Insert(key, key);
+    twin.Insert(key, key);
+  }
+  for (auto key : keys) {
+    benchmark::DoNotOptimize(twin.Get(key));
+  }
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto key : keys) {
+      benchmark::DoNotOptimize(map.Get(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+  state.counters["probes_per_get"] = twin.Stats().MeanProbeLength();
+  state.counters["buckets_per_entry"] =
+      static_cast<double>(map.BucketCount()) / map.Size();
+}
+
+BENCHMARK(BM_HashmapInsert)->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK(BM_StdUnorderedMapInsert)->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK(BM_HashmapGet)->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK(BM_StdUnorderedMapAt)->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK(BM_HashmapContainsMissing)->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK(BM_StdUnorderedMapCountMissing)
+    ->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK_TEMPLATE(BM_HashmapGetWithPolicy, nll::DefaultHashmapPolicy)
+    ->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK_TEMPLATE(BM_HashmapGetWithPolicy, nll::FastHashmapPolicy)
+    ->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK_TEMPLATE(BM_HashmapGetWithPolicy, nll::CompactHashmapPolicy)
+    ->Apply(nll::bench::SizesAndPatterns);
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "nll/collections/dary_heap.hpp"
+#include "nll/collections/pairing_heap.hpp"
+#include "nll/collections/radix_heap.hpp"
+#include "scoped_counters.hpp"
+
+namespace {
+
+using StdMinHeap =
+    std::priority_queue<int, std::vector<int>, std::greater<int>>;
+using RadixMinHeap = nll::RadixHeap<std::uint32_t, int>;
+
+// One push and pop interface over every heap, all min-heaps of int keys
+
+template <class THeap>
+void Push(THeap& heap, int key) {
+  heap.Push(key);
+}
+
+template <class THeap>
+int Pop(THeap& heap) {
+  return heap.Pop();
+}
+
+void Push(StdMinHeap& heap, int key) { heap.push(key); }
+
+int Pop(StdMinHeap& heap) {
+  auto key = heap.top();
+  heap.pop();
+  return key;
+}
+
+void Push(RadixMinHeap& heap, int key) {
+  heap.Push(static_cast<std::uint32_t>(key), key);
+}
+
+int Pop(RadixMinHeap& heap) { return heap.Pop().second; }
+
+template <class THeap>
+bool IsEmpty(THeap& heap) {
+  return heap.Empty();
+}
+
+bool IsEmpty(StdMinHeap& heap) { return heap.empty(); }
+
+/// @brief Gaps between successive keys of the hold model, exponentially
+/// distributed like the event times of a simulation
+std::vector<int> HoldIncrements(std::size_t count) {
+  std::mt19937 random(13);
+  std::exponential_distribution<double> distribution(1.0 / 1000);
+  std::vector<int> increments(count);
+  for (auto& increment : increments) {
+    increment = static_cast<int>(distribution(random));
+  }
+  return increments;
+}
+
+void HoldSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->RangeMultiplier(8)
+      ->Range(nll::bench::kMinSize, 1 << 20)
+      ->ArgName("size");
+}
+
+}  // namespace
+
+/// @brief Heapsort-like mix: every key pushed, then every key popped
+template <class THeap>
+static void BM_HeapPushThenPop(benchmark::State& state) {
+  auto keys = nll::bench::KeysFor(state);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    THeap heap;
+    for (auto key : keys) {
+      Push(heap, key);
+    }
+    long sum = 0;
+    while (!IsEmpty(heap)) {
+      sum += Pop(heap);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size() * 2);
+}
+
+/// @brief Hold model, the steady state of schedulers and event queues: the
+/// heap stays at size, and each operation pops the minimum and pushes it
+/// back later by a random gap. Keys only grow, so the radix heap applies.
+template <class THeap>
+static void BM_HeapHold(benchmark::State& state) {
+  auto size = static_cast<std::size_t>(state.range(0));
+  constexpr std::size_t kOperations = 1 << 16;
+  auto increments = HoldIncrements(size + kOperations);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto heap = std::make_unique<THeap>();
+    for (std::size_t i = 0; i < size; i++) {
+      Push(*heap, increments[i]);
+    }
+    state.ResumeTiming();
+    for (std::size_t i = 0; i < kOperations; i++) {
+      Push(*heap, Pop(*heap) + increments[size + i]);
+    }
+    state.PauseTiming();
+    heap.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * kOperations);
+}
+
+/// @brief Building a heap of n keys at once, bottom-up in O(n)
+static void BM_DaryHeapHeapify(benchmark::State& state) {
+  auto keys = nll::bench::KeysFor(state);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::DaryHeap<int> heap(keys);
+    benchmark::DoNotOptimize(heap.Top());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_StdMakeHeap(benchmark::State& state) {
+  auto keys = nll::bench::KeysFor(state);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    auto heap = keys;
+    std::make_heap(heap.begin(), heap.end(), std::greater<int>());
+    benchmark::DoNotOptimize(heap.front());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+using BinaryHeap = nll::DaryHeap<int, 2>;
+using QuaternaryHeap = nll::DaryHeap<int, 4>;
+using OctonaryHeap = nll::DaryHeap<int, 8>;
+using IntPairingHeap = nll::PairingHeap<int>;
+
+BENCHMARK_TEMPLATE(BM_HeapPushThenPop, BinaryHeap)
+    ->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK_TEMPLATE(BM_HeapPushThenPop, QuaternaryHeap)
+    ->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK_TEMPLATE(BM_HeapPushThenPop, OctonaryHeap)
+    ->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK_TEMPLATE(BM_HeapPushThenPop, IntPairingHeap)
+    ->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK_TEMPLATE(BM_HeapPushThenPop, RadixMinHeap)
+    ->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK_TEMPLATE(BM_HeapPushThenPop, StdMinHeap)
+    ->Apply(nll::bench::SizesAndPatterns);
+
+BENCHMARK_TEMPLATE(BM_HeapHold, BinaryHeap)->Apply(HoldSizes);
+BENCHMARK_TEMPLATE(BM_HeapHold, QuaternaryHeap)->Apply(HoldSizes);
+BENCHMARK_TEMPLATE(BM_HeapHold, OctonaryHeap)->Apply(HoldSizes);
+BENCHMARK_TEMPLATE(BM_HeapHold, IntPairingHeap)->Apply(HoldSizes);
+BENCHMARK_TEMPLATE(BM_HeapHold, RadixMinHeap)->Apply(HoldSizes);
+BENCHMARK_TEMPLATE(BM_HeapHold, StdMinHeap)->Apply(HoldSizes);
+
+BENCHMARK(BM_DaryHeapHeapify)->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK(BM_StdMakeHeap)->Apply(nll::bench::SizesAndPatterns);
@@ -0,0 +1,51 @@
+#include "nll/collections/indexed_heap.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "scoped_counters.hpp"
+
+static void BM_IndexedHeapPushPop(benchmark::State& state) {
+  auto priorities = nll::bench::KeysFor(state);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::IndexedDaryHeap<int> heap(priorities.size());
+    for (std::uint32_t i = 0; i < priorities.size(); i++) {
+      heap.Push(i, priorities[i]);
+    }
+    long sum = 0;
+    while (!heap.Empty()) {
+      sum += heap.Pop().second;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * priorities.size() * 2);
+}
+
+static void BM_StdPriorityQueuePushPop(benchmark::State& state) {
+  auto priorities = nll::bench::KeysFor(state);
+  using Entry = std::pair<int, std::uint32_t>;
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    for (std::uint32_t i = 0; i < priorities.size(); i++) {
+      heap.emplace(priorities[i], i);
+    }
+    long sum = 0;
+    while (!heap.empty()) {
+      sum += heap.top().first;
+      heap.pop();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * priorities.size() * 2);
+}
+
+BENCHMARK(BM_IndexedHeapPushPop)->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK(BM_StdPriorityQueuePushPop)->Apply(nll::bench::SizesAndPatterns);
@@ -0,0 +1,163 @@
+#include "nll/collections/linked_list.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <list>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "scoped_counters.hpp"
+
+namespace {
+
+using nll::bench::kMaxSize;
+using nll::bench::kMinSize;
+
+// Every find walks half the list on average, so probe a fixed handful of keys
+constexpr std::size_t kNumProbes = 16;
+
+std::vector<int> Probes(std::size_t count) {
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> pick(0, static_cast<int>(count) - 1);
+  std::vector<int> probes(kNumProbes);
+  for (auto& probe : probes) {
+    probe = pick(rng);
+  }
+  return probes;
+}
+
+}  // namespace
+
+static void BM_LinkedListFind(benchmark::State& state) {
+  nll::SinglyLinkedList<int> list{};
+  for (auto key : nll::bench::ShuffledKeys(state.range(0))) {
+    list.PushBack(key);
+  }
+  auto probes = Probes(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto probe : probes) {
+      benchmark::DoNotOptimize(std::find(list.begin(), list.end(), probe));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+static void BM_StdListFind(benchmark::State& state) {
+  auto keys = nll::bench::ShuffledKeys(state.range(0));
+  std::list<int> list(keys.begin(), keys.end());
+  auto probes = Probes(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto probe : probes) {
+      benchmark::DoNotOptimize(std::find(list.begin(), list.end(), probe));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+static void BM_StdVectorFind(benchmark::State& state) {
+  auto keys = nll::bench::ShuffledKeys(state.range(0));
+  auto probes = Probes(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto probe : probes) {
+      benchmark::DoNotOptimize(std::find(keys.begin(), keys.end(), probe));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+static void BM_LinkedListPushBack(benchmark::State& state) {
+  auto keys = nll::bench::SequentialKeys(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::SinglyLinkedList<int> list{};
+    for (auto key : keys) {
+      list.PushBack(key);
+    }
+    benchmark::DoNotOptimize(list.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_LinkedListPushFront(benchmark::State& state) {
+  auto keys = nll::bench::SequentialKeys(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::SinglyLinkedList<int> list{};
+    for (auto key : keys) {
+      list.PushFront(key);
+    }
+    benchmark::DoNotOptimize(list.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_StdDequePushBack(benchmark::State& state) {
+  auto keys = nll::bench::SequentialKeys(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::deque<int> deque;
+    for (auto key : keys) {
+      deque.push_back(key);
+    }
+    benchmark::DoNotOptimize(deque.size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_StdDequePushFront(benchmark::State& state) {
+  auto keys = nll::bench::SequentialKeys(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::deque<int> deque;
+    for (auto key : keys) {
+      deque.push_front(key);
+    }
+    benchmark::DoNotOptimize(deque.size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_LinkedListTraverse(benchmark::State& state) {
+  nll::SinglyLinkedList<int> list{};
+  for (auto key : nll::bench::SequentialKeys(state.range(0))) {
+    list.PushBack(key);
+  }
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    long sum = 0;
+    for (auto value : list) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * list.Size());
+}
+
+static void BM_StdVectorTraverse(benchmark::State& state) {
+  auto keys = nll::bench::SequentialKeys(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    long sum = 0;
+    for (auto value : keys) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK(BM_LinkedListFind)->Range(kMinSize, kMaxSize);
+BENCHMARK(BM_StdListFind)->Range(kMinSize, kMaxSize);
+BENCHMARK(BM_StdVectorFind)->Range(kMinSize, kMaxSize);
+BENCHMARK(BM_LinkedListPushBack)->Range(kMinSize, kMaxSize);
+BENCHMARK(BM_LinkedListPushFront)->Range(kMinSize, kMaxSize);
+BENCHMARK(BM_StdDequePushBack)->Range(kMinSize, kMaxSize);
+BENCHMARK(BM_StdDequePushFront)->Range(kMinSize, kMaxSize);
+BENCHMARK(BM_LinkedListTraverse)->Range(kMinSize, kMaxSize);
+BENCHMARK(BM_StdVectorTraverse)->Range(kMinSize, kMaxSize);
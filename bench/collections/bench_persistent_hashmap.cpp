@@ -0,0 +1,154 @@
+#include "nll/collections/persistent_hashmap.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "nll/collections/hashmap.hpp"
+#include "scoped_counters.hpp"
+
+namespace {
+
+using IntPersistentHashmap = nll::PersistentHashmap<int, int>;
+
+/// @brief Sizes and key orders up to 1M keys, as every persistent insert
+/// allocates a path of nodes
+void PersistentSizesAndPatterns(benchmark::internal::Benchmark* benchmark) {
+  benchmark
+      ->ArgsProduct({benchmark::CreateRange(nll::bench::kMinSize, 1 << 20, 8),
+                     {0, 1}})
+      ->ArgNames({"size", "random"});
+}
+
+IntPersistentHashmap MapOf(std::size_t size) {
+  auto transient = IntPersistentHashmap().AsTransient();
+  for (auto key : nll::bench::SequentialKeys(size)) {
+    transient.Insert(key, key);
+  }
+  return transient.Persistent();
+}
+
+}  // namespace
+
+/// @brief Inserts one key at a time, each a new version copying its path
+static void BM_PersistentHashmapInsert(benchmark::State& state) {
+  auto keys = nll::bench::KeysFor(state);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    IntPersistentHashmap map;
+    for (auto key : keys) {
+      map = map.Insert(key, key);
+    }
+    benchmark::DoNotOptimize(map.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+/// @brief The same inserts as one batch through a transient
+static void BM_TransientHashmapInsert(benchmark::State& state) {
+  auto keys = nll::bench::KeysFor(state);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    auto transient = IntPersistentHashmap().AsTransient();
+    for (auto key : keys) {
+      transient.Insert(key, key);
+    }
+    benchmark::DoNotOptimize(transient.Persistent().Size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_PersistentHashmapFind(benchmark::State& state) {
+  auto keys = nll::bench::KeysFor(state);
+  auto map = MapOf(keys.size());
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto key : keys) {
+      benchmark::DoNotOptimize(map.Find(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+/// @brief Taking a snapshot of the published version, whatever its size
+static void BM_VersionedHashmapSnapshot(benchmark::State& state) {
+  nll::VersionedHashmap<int, int> map(MapOf(state.range(0)));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    auto snapshot = map.Snapshot();
+    benchmark::DoNotOptimize(snapshot);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief The alternative: copying a mutable map for every snapshot
+static void BM_HashmapCopySnapshot(benchmark::State& state) {
+  nll::Hashmap<int, int> map;
+  for (auto key : nll::bench::SequentialKeys(state.range(0))) {
+    map.Insert(key, key);
+  }
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    auto snapshot = map;
+    benchmark::DoNotOptimize(snapshot);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief Thread 0 keeps publishing batches of 16 updates while the other
+/// threads take a snapshot per 64 lookups. Reports each role's rate.
+static void BM_VersionedHashmapReadWithWriter(benchmark::State& state) {
+  constexpr int kKeys = 1 << 16;
+  static std::unique_ptr<nll::VersionedHashmap<int, int>> map;
+  if (state.thread_index() == 0) {
+    map = std::make_unique<nll::VersionedHashmap<int, int>>(MapOf(kKeys));
+  }
+  std::mt19937 random(state.thread_index());
+  std::uniform_int_distribution<int> keys(0, kKeys - 1);
+  std::int64_t operations = 0;
+  // Allocations are counted across threads, hardware events on the first
+  std::optional<nll::bench::ScopedCounters> counters;
+  if (state.thread_index() == 0) {
+    counters.emplace(state);
+  }
+  for (auto _ : state) {
+    if (state.thread_index() == 0) {
+      map->Update([&](auto& transient) {
+        for (int i = 0; i < 16; i++) {
+          transient.Insert(keys(random), i);
+        }
+      });
+      operations += 16;
+    } else {
+      auto snapshot = map->Snapshot();
+      for (int i = 0; i < 64; i++) {
+        benchmark::DoNotOptimize(snapshot.Find(keys(random)));
+      }
+      operations += 64;
+    }
+  }
+  state.counters[state.thread_index() == 0 ? "updates" : "lookups"] =
+      benchmark::Counter(static_cast<double>(operations),
+                         benchmark::Counter::kIsRate);
+  if (state.thread_index() == 0) {
+    map.reset();
+  }
+}
+
+BENCHMARK(BM_PersistentHashmapInsert)->Apply(PersistentSizesAndPatterns);
+BENCHMARK(BM_TransientHashmapInsert)->Apply(PersistentSizesAndPatterns);
+BENCHMARK(BM_PersistentHashmapFind)->Apply(PersistentSizesAndPatterns);
+BENCHMARK(BM_VersionedHashmapSnapshot)
+    ->RangeMultiplier(64)
+    ->Range(nll::bench::kMinSize, 1 << 20)
+    ->ArgName("size");
+BENCHMARK(BM_HashmapCopySnapshot)
+    ->RangeMultiplier(64)
+    ->Range(nll::bench::kMinSize, 1 << 20)
+    ->ArgName("size");
+BENCHMARK(BM_VersionedHashmapReadWithWriter)->ThreadRange(2, 8)->UseRealTime();
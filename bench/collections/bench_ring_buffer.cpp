@@ -0,0 +1,66 @@
+#include "nll/collections/ring_buffer.hpp"
+
+#include <algorithm>
+#include <deque>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "scoped_counters.hpp"
+
+namespace {
+
+// RingBuffer's capacity is a template argument, so the size sweep is the
+// number of values streamed through a fixed buffer, in bursts that fill it
+// halfway
+constexpr std::size_t kCapacity = 1024;
+constexpr std::size_t kBurst = kCapacity / 2;
+
+}  // namespace
+
+using nll::bench::kMaxSize;
+using nll::bench::kMinSize;
+
+static void BM_RingBufferStream(benchmark::State& state) {
+  auto count = static_cast<std::size_t>(state.range(0));
+  auto burst = std::min(kBurst, count);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::RingBuffer<int, kCapacity> buffer{};
+    long sum = 0;
+    for (std::size_t done = 0; done < count; done += burst) {
+      for (std::size_t i = 0; i < burst; i++) {
+        buffer.Push(static_cast<int>(i));
+      }
+      while (!buffer.Empty()) {
+        sum += buffer.Pop();
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BM_StdDequeStream(benchmark::State& state) {
+  auto count = static_cast<std::size_t>(state.range(0));
+  auto burst = std::min(kBurst, count);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::deque<int> buffer;
+    long sum = 0;
+    for (std::size_t done = 0; done < count; done += burst) {
+      for (std::size_t i = 0; i < burst; i++) {
+        buffer.push_back(static_cast<int>(i));
+      }
+      while (!buffer.empty()) {
+        sum += buffer.front();
+        buffer.pop_front();
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_RingBufferStream)->Range(kMinSize, kMaxSize);
+BENCHMARK(BM_StdDequeStream)->Range(kMinSize, kMaxSize);
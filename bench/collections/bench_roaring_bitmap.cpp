@@ -0,0 +1,268 @@
+#include "nll/collections/roaring_bitmap.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "nll/collections/hashmap.hpp"
+#include "nll/collections/set.hpp"
+#include "nll/instrumentation/allocation_tracker.hpp"
+#include "scoped_counters.hpp"
+
+namespace {
+
+/// @brief Sweeps set sizes, with the IDs stride apart: 1 is a dense range,
+/// 8 fills bitmap containers, 64 array containers and 4097 leaves 16 IDs
+/// per container. The last is odd because Hashmap buckets integers by their
+/// low bits, so a power of two would put every ID in one chain.
+void SizesAndStrides(benchmark::internal::Benchmark* benchmark) {
+  benchmark
+      ->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 18, 16),
+                     {1, 8, 64, 4097}})
+      ->ArgNames({"size", "stride"});
+}
+
+/// @brief IDs for a SizesAndStrides benchmark. The second operand of a set
+/// operation starts halfway through the first, so they overlap by half.
+std::vector<std::uint32_t> IdsFor(const benchmark::State& state,
+                                  bool second_operand = false) {
+  auto size = static_cast<std::uint32_t>(state.range(0));
+  auto stride = static_cast<std::uint32_t>(state.range(1));
+  auto first = second_operand ? size / 2 * stride : 0;
+  std::vector<std::uint32_t> ids(size);
+  for (std::uint32_t i = 0; i < size; i++) {
+    ids[i] = first + i * stride;
+  }
+  return ids;
+}
+
+void ReportBytesPerId(benchmark::State& state, std::size_t bytes) {
+  state.counters["bytes_per_id"] =
+      static_cast<double>(bytes) / static_cast<double>(state.range(0));
+}
+
+/// @brief Reports the heap a container returned by build keeps live. The
+/// allocation hooks see every container alike, whatever its allocator.
+template <class TBuild>
+void ReportLiveBytesPerId(benchmark::State& state, TBuild build) {
+  auto before = nll::instrumentation::AllocationTracker::Snapshot();
+  auto container = build();
+  auto after = nll::instrumentation::AllocationTracker::Snapshot();
+  benchmark::DoNotOptimize(container);
+  ReportBytesPerId(state, after.LiveBytes() - before.LiveBytes());
+}
+
+}  // namespace
+
+/// @brief Builds a set of IDs; the counters compare its memory before and
+/// after RunOptimize
+static void BM_RoaringBitmapBuild(benchmark::State& state) {
+  auto ids = IdsFor(state);
+  std::size_t bytes = 0;
+  std::size_t optimized_bytes = 0;
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::RoaringBitmap bitmap(ids.begin(), ids.end());
+    bytes = bitmap.MemoryBytes();
+    bitmap.RunOptimize();
+    optimized_bytes = bitmap.MemoryBytes();
+    benchmark::DoNotOptimize(bitmap.Cardinality());
+  }
+  state.SetItemsProcessed(state.iterations() * ids.size());
+  ReportBytesPerId(state, bytes);
+  state.counters["optimized_bytes_per_id"] =
+      static_cast<double>(optimized_bytes) / static_cast<double>(ids.size());
+}
+
+/// @brief The string-keyed nll::Set, holding the IDs in decimal
+static void BM_SetBuildIds(benchmark::State& state) {
+  auto ids = IdsFor(state);
+  std::vector<std::string> keys;
+  for (auto id : ids) {
+    keys.push_back(std::to_string(id));
+  }
+  ReportLiveBytesPerId(state, [&keys] {
+    nll::Set set;
+    for (const auto& key : keys) {
+      set.Add(key);
+    }
+    return set;
+  });
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::Set set;
+    for (const auto& key : keys) {
+      set.Add(key);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * ids.size());
+}
+
+static void BM_HashmapBuildIds(benchmark::State& state) {
+  auto ids = IdsFor(state);
+  auto build = [&ids] {
+    nll::Hashmap<std::uint32_t, bool> map;
+    for (auto id : ids) {
+      map.Insert(id, true);
+    }
+    return map;
+  };
+  ReportLiveBytesPerId(state, build);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(build().Size());
+  }
+  state.SetItemsProcessed(state.iterations() * ids.size());
+}
+
+static void BM_StdUnorderedSetBuildIds(benchmark::State& state) {
+  auto ids = IdsFor(state);
+  auto build = [&ids] {
+    return std::unordered_set<std::uint32_t>(ids.begin(), ids.end());
+  };
+  ReportLiveBytesPerId(state, build);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(build().size());
+  }
+  state.SetItemsProcessed(state.iterations() * ids.size());
+}
+
+static void BM_RoaringBitmapContains(benchmark::State& state) {
+  auto ids = IdsFor(state);
+  nll::RoaringBitmap bitmap(ids.begin(), ids.end());
+  auto probes = IdsFor(state, true);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto id : probes) {
+      benchmark::DoNotOptimize(bitmap.Contains(id));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+static void BM_HashmapContainsIds(benchmark::State& state) {
+  auto ids = IdsFor(state);
+  nll::Hashmap<std::uint32_t, bool> map;
+  for (auto id : ids) {
+    map.Insert(id, true);
+  }
+  auto probes = IdsFor(state, true);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto id : probes) {
+      benchmark::DoNotOptimize(map.Contains(id));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+/// @brief Set operations; items are the IDs of both operands
+template <nll::RoaringBitmap (*kOperation)(const nll::RoaringBitmap&,
+                                           const nll::RoaringBitmap&)>
+static void BM_RoaringBitmapOperation(benchmark::State& state) {
+  auto ids_a = IdsFor(state);
+  auto ids_b = IdsFor(state, true);
+  nll::RoaringBitmap a(ids_a.begin(), ids_a.end());
+  nll::RoaringBitmap b(ids_b.begin(), ids_b.end());
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    auto result = kOperation(a, b);
+    benchmark::DoNotOptimize(result.Empty());
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * ids_a.size());
+}
+
+/// @brief Intersection with a hash map: probe one map with the other's IDs,
+/// which the caller has to keep on the side since Hashmap cannot iterate
+static void BM_HashmapIntersectIds(benchmark::State& state) {
+  auto ids_a = IdsFor(state);
+  auto ids_b = IdsFor(state, true);
+  nll::Hashmap<std::uint32_t, bool> a;
+  for (auto id : ids_a) {
+    a.Insert(id, true);
+  }
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::Hashmap<std::uint32_t, bool> result;
+    for (auto id : ids_b) {
+      if (a.Contains(id)) {
+        result.Insert(id, true);
+      }
+    }
+    benchmark::DoNotOptimize(result.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * ids_a.size());
+}
+
+static void BM_HashmapUnionIds(benchmark::State& state) {
+  auto ids_a = IdsFor(state);
+  auto ids_b = IdsFor(state, true);
+  nll::Hashmap<std::uint32_t, bool> a;
+  for (auto id : ids_a) {
+    a.Insert(id, true);
+  }
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    auto result = a;
+    for (auto id : ids_b) {
+      result.Insert(id, true);
+    }
+    benchmark::DoNotOptimize(result.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * ids_a.size());
+}
+
+static void BM_StdUnorderedSetIntersectIds(benchmark::State& state) {
+  auto ids_a = IdsFor(state);
+  auto ids_b = IdsFor(state, true);
+  std::unordered_set<std::uint32_t> a(ids_a.begin(), ids_a.end());
+  std::unordered_set<std::uint32_t> b(ids_b.begin(), ids_b.end());
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::unordered_set<std::uint32_t> result;
+    for (auto id : b) {
+      if (a.count(id)) {
+        result.insert(id);
+      }
+    }
+    benchmark::DoNotOptimize(result.size());
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * ids_a.size());
+}
+
+static void BM_RoaringBitmapIterate(benchmark::State& state) {
+  auto ids = IdsFor(state);
+  nll::RoaringBitmap bitmap(ids.begin(), ids.end());
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::uint64_t sum = 0;
+    for (auto id : bitmap) {
+      sum += id;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * ids.size());
+}
+
+BENCHMARK(BM_RoaringBitmapBuild)->Apply(SizesAndStrides);
+BENCHMARK(BM_SetBuildIds)->Apply(SizesAndStrides);
+BENCHMARK(BM_HashmapBuildIds)->Apply(SizesAndStrides);
+BENCHMARK(BM_StdUnorderedSetBuildIds)->Apply(SizesAndStrides);
+BENCHMARK(BM_RoaringBitmapContains)->Apply(SizesAndStrides);
+BENCHMARK(BM_HashmapContainsIds)->Apply(SizesAndStrides);
+BENCHMARK_TEMPLATE(BM_RoaringBitmapOperation, nll::RoaringBitmap::Union)
+    ->Apply(SizesAndStrides);
+BENCHMARK_TEMPLATE(BM_RoaringBitmapOperation,
+                   nll::RoaringBitmap::Intersection)
+    ->Apply(SizesAndStrides);
+BENCHMARK_TEMPLATE(BM_RoaringBitmapOperation, nll::RoaringBitmap::Difference)
+    ->Apply(SizesAndStrides);
+BENCHMARK(BM_HashmapUnionIds)->Apply(SizesAndStrides);
+BENCHMARK(BM_HashmapIntersectIds)->Apply(SizesAndStrides);
+BENCHMARK(BM_StdUnorderedSetIntersectIds)->Apply(SizesAndStrides);
+BENCHMARK(BM_RoaringBitmapIterate)->Apply(SizesAndStrides);
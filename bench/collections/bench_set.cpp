@@ -0,0 +1,109 @@
+#include "nll/collections/set.hpp"
+
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "scoped_counters.hpp"
+
+namespace {
+
+/// @brief String keys for a SizesAndPatterns benchmark
+std::vector<std::string> StringKeysFor(const benchmark::State& state) {
+  std::vector<std::string> keys;
+  for (auto key : nll::bench::KeysFor(state)) {
+    keys.push_back("nll-bench-key-" + std::to_string(key));
+  }
+  return keys;
+}
+
+}  // namespace
+
+static void BM_SetAdd(benchmark::State& state) {
+  auto keys = StringKeysFor(state);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::Set set;
+    for (const auto& key : keys) {
+      set.Add(key);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_StdUnorderedSetInsert(benchmark::State& state) {
+  auto keys = StringKeysFor(state);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::unordered_set<std::string> set;
+    for (const auto& key : keys) {
+      set.insert(key);
+    }
+    benchmark::DoNotOptimize(set.size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_StdSetInsert(benchmark::State& state) {
+  auto keys = StringKeysFor(state);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::set<std::string> set;
+    for (const auto& key : keys) {
+      set.insert(key);
+    }
+    benchmark::DoNotOptimize(set.size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_SetContains(benchmark::State& state) {
+  auto keys = StringKeysFor(state);
+  nll::Set set;
+  for (const auto& key : keys) {
+    set.Add(key);
+  }
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (const auto& key : keys) {
+      benchmark::DoNotOptimize(set.Contains(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_StdUnorderedSetCount(benchmark::State& state) {
+  auto keys = StringKeysFor(state);
+  std::unordered_set<std::string> set(keys.begin(), keys.end());
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (const auto& key : keys) {
+      benchmark::DoNotOptimize(set.count(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_StdSetCount(benchmark::State& state) {
+  auto keys = StringKeysFor(state);
+  std::set<std::string> set(keys.begin(), keys.end());
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (const auto& key : keys) {
+      benchmark::DoNotOptimize(set.count(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK(BM_SetAdd)->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK(BM_StdUnorderedSetInsert)->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK(BM_StdSetInsert)->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK(BM_SetContains)->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK(BM_StdUnorderedSetCount)->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK(BM_StdSetCount)->Apply(nll::bench::SizesAndPatterns);
@@ -0,0 +1,81 @@
+#include "nll/collections/stack.hpp"
+
+#include <stack>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "scoped_counters.hpp"
+
+using nll::bench::kMaxSize;
+using nll::bench::kMinSize;
+
+static void BM_StackPushPop(benchmark::State& state) {
+  auto keys = nll::bench::SequentialKeys(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::Stack<int> stack;
+    for (auto key : keys) {
+      stack.Push(key);
+    }
+    long sum = 0;
+    while (!stack.Empty()) {
+      sum += stack.Pop();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size() * 2);
+}
+
+static void BM_StdStackPushPop(benchmark::State& state) {
+  auto keys = nll::bench::SequentialKeys(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::stack<int, std::vector<int>> stack;
+    for (auto key : keys) {
+      stack.push(key);
+    }
+    long sum = 0;
+    while (!stack.empty()) {
+      sum += stack.top();
+      stack.pop();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size() * 2);
+}
+
+static void BM_StackIterate(benchmark::State& state) {
+  nll::Stack<int> stack;
+  for (auto key : nll::bench::SequentialKeys(state.range(0))) {
+    stack.Push(key);
+  }
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    long sum = 0;
+    for (auto value : stack) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * stack.Size());
+}
+
+static void BM_StdVectorReverseIterate(benchmark::State& state) {
+  auto keys = nll::bench::SequentialKeys(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    long sum = 0;
+    for (auto it = keys.rbegin(); it != keys.rend(); ++it) {
+      sum += *it;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK(BM_StackPushPop)->Range(kMinSize, kMaxSize);
+BENCHMARK(BM_StdStackPushPop)->Range(kMinSize, kMaxSize);
+BENCHMARK(BM_StackIterate)->Range(kMinSize, kMaxSize);
+BENCHMARK(BM_StdVectorReverseIterate)->Range(kMinSize, kMaxSize);
@@ -0,0 +1,255 @@
+#include "nll/collections/timer_wheel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "scoped_counters.hpp"
+
+namespace {
+
+using Connection = std::uint32_t;
+
+/// @brief Timeouts are drawn from [1, kSpread] ticks, a minute at 1 ms
+constexpr std::uint64_t kSpread = 1 << 16;
+/// @brief Churn advances the clock one tick per kOpsPerTick reschedules
+constexpr std::size_t kOpsPerTick = 64;
+
+/// @brief Pre-drawn delays and connections, so the timed loops only touch
+/// the timers
+struct Workload {
+  std::vector<std::uint64_t> delays;
+  std::vector<Connection> connections;
+};
+
+const Workload& Draws(std::size_t live) {
+  static Workload workload;
+  if (workload.delays.size() != live) {
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<std::uint64_t> delay(1, kSpread);
+    workload.delays.resize(live);
+    workload.connections.resize(live);
+    for (std::size_t i = 0; i < live; i++) {
+      workload.delays[i] = delay(random);
+      workload.connections[i] = static_cast<Connection>(random() % live);
+    }
+  }
+  return workload;
+}
+
+class WheelTimers {
+ public:
+  using Handle = nll::TimerId;
+
+  explicit WheelTimers(std::size_t connections) {
+    wheel.Reserve(connections);
+  }
+
+  Handle Schedule(std::uint64_t delay, Connection connection) {
+    return wheel.Schedule(delay, connection);
+  }
+
+  void Cancel(Handle handle) { wheel.Cancel(handle); }
+
+  template <class F>
+  std::size_t Advance(std::uint64_t ticks, F&& on_expire) {
+    return wheel.Advance(
+        ticks, [&](Connection& connection) { on_expire(connection); });
+  }
+
+ private:
+  nll::TimerWheel<Connection> wheel;
+};
+
+/// @brief Stale entries a lazily cancelling heap holds at most in Churn:
+/// each operation leaves one behind until its deadline passes
+constexpr std::size_t kMaxStale = kSpread * kOpsPerTick;
+
+/// @brief The usual heap baseline: a binary min-heap of deadlines that
+/// cancels lazily, bumping the connection's generation and skipping stale
+/// entries once they surface, as a heap cannot erase from the middle
+class HeapTimers {
+ public:
+  using Handle = std::pair<Connection, std::uint32_t>;
+
+  explicit HeapTimers(std::size_t connections)
+      : generations(connections, 0) {
+    std::vector<Entry> storage;
+    storage.reserve(connections + kMaxStale);
+    heap = Heap(std::greater<Entry>{}, std::move(storage));
+  }
+
+  Handle Schedule(std::uint64_t delay, Connection connection) {
+    auto generation = generations[connection];
+    heap.push(Entry{now + delay, connection, generation});
+    return {connection, generation};
+  }
+
+  void Cancel(Handle handle) {
+    if (generations[handle.first] == handle.second) {
+      generations[handle.first]++;
+    }
+  }
+
+  template <class F>
+  std::size_t Advance(std::uint64_t ticks, F&& on_expire) {
+    now += ticks;
+    std::size_t fired = 0;
+    while (!heap.empty() && heap.top().deadline <= now) {
+      auto entry = heap.top();
+      heap.pop();
+      if (generations[entry.connection] == entry.generation) {
+        generations[entry.connection]++;
+        fired++;
+        on_expire(entry.connection);
+      }
+    }
+    return fired;
+  }
+
+ private:
+  struct Entry {
+    std::uint64_t deadline;
+    Connection connection;
+    std::uint32_t generation;
+
+    bool operator>(const Entry& other) const {
+      return deadline > other.deadline;
+    }
+  };
+  using Heap =
+      std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>;
+
+  Heap heap;
+  std::vector<std::uint32_t> generations;
+  std::uint64_t now = 0;
+};
+
+/// @brief Arms one timer per connection, returning the handles
+template <class TTimers>
+std::vector<typename TTimers::Handle> ArmAll(TTimers& timers,
+                                             const Workload& workload) {
+  std::vector<typename TTimers::Handle> handles(workload.delays.size());
+  for (std::size_t i = 0; i < handles.size(); i++) {
+    handles[i] =
+        timers.Schedule(workload.delays[i], static_cast<Connection>(i));
+  }
+  return handles;
+}
+
+/// @brief Schedules state.range(0) timers into empty, presized timers
+template <class TTimers>
+void BM_Schedule(benchmark::State& state) {
+  auto live = static_cast<std::size_t>(state.range(0));
+  const auto& workload = Draws(live);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    TTimers timers(live);
+    state.ResumeTiming();
+    auto handles = ArmAll(timers, workload);
+    benchmark::DoNotOptimize(handles.data());
+  }
+  state.SetItemsProcessed(state.iterations() * live);
+}
+
+/// @brief Cancels state.range(0) live timers in random order. The heap's
+/// cancel only marks the entry, its cost shows up in Expire and Churn.
+template <class TTimers>
+void BM_Cancel(benchmark::State& state) {
+  auto live = static_cast<std::size_t>(state.range(0));
+  const auto& workload = Draws(live);
+  std::vector<Connection> order(live);
+  std::iota(order.begin(), order.end(), Connection{0});
+  std::shuffle(order.begin(), order.end(), std::mt19937(7));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    TTimers timers(live);
+    auto handles = ArmAll(timers, workload);
+    state.ResumeTiming();
+    for (auto connection : order) {
+      timers.Cancel(handles[connection]);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * live);
+}
+
+/// @brief Fires state.range(0) live timers, one tick at a time until all
+/// are due
+template <class TTimers>
+void BM_Expire(benchmark::State& state) {
+  auto live = static_cast<std::size_t>(state.range(0));
+  const auto& workload = Draws(live);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    TTimers timers(live);
+    ArmAll(timers, workload);
+    state.ResumeTiming();
+    std::uint64_t sum = 0;
+    for (std::uint64_t tick = 0; tick < kSpread; tick++) {
+      timers.Advance(1, [&](Connection connection) { sum += connection; });
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * live);
+}
+
+/// @brief Steady state of an idle timeout table: state.range(0) live timers,
+/// each operation refreshes a random connection's timeout, and the clock
+/// ticks every kOpsPerTick operations, re-arming whatever fired
+template <class TTimers>
+void BM_Churn(benchmark::State& state) {
+  auto live = static_cast<std::size_t>(state.range(0));
+  const auto& workload = Draws(live);
+  TTimers timers(live);
+  auto handles = ArmAll(timers, workload);
+  auto rearm = [&](Connection connection) {
+    handles[connection] = timers.Schedule(kSpread, connection);
+  };
+  std::size_t op = 0;
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    auto connection = workload.connections[op];
+    timers.Cancel(handles[connection]);
+    handles[connection] = timers.Schedule(workload.delays[op], connection);
+    if (++op % kOpsPerTick == 0) {
+      timers.Advance(1, rearm);
+    }
+    if (op == live) {
+      op = 0;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void LiveTimers(benchmark::internal::Benchmark* benchmark) {
+  benchmark->Arg(1'000'000)
+      ->Arg(10'000'000)
+      ->ArgName("live")
+      ->Unit(benchmark::kMillisecond);
+}
+
+void LiveTimersChurn(benchmark::internal::Benchmark* benchmark) {
+  benchmark->Arg(1'000'000)->Arg(10'000'000)->ArgName("live");
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_Schedule, WheelTimers)->Apply(LiveTimers);
+BENCHMARK_TEMPLATE(BM_Schedule, HeapTimers)->Apply(LiveTimers);
+BENCHMARK_TEMPLATE(BM_Cancel, WheelTimers)->Apply(LiveTimers);
+BENCHMARK_TEMPLATE(BM_Cancel, HeapTimers)->Apply(LiveTimers);
+BENCHMARK_TEMPLATE(BM_Expire, WheelTimers)->Apply(LiveTimers);
+BENCHMARK_TEMPLATE(BM_Expire, HeapTimers)->Apply(LiveTimers);
+BENCHMARK_TEMPLATE(BM_Churn, WheelTimers)->Apply(LiveTimersChurn);
+BENCHMARK_TEMPLATE(BM_Churn, HeapTimers)->Apply(LiveTimersChurn);
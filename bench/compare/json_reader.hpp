@@ -0,0 +1,309 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+
+namespace nll {
+namespace bench {
+namespace json {
+
+/// @brief A parsed JSON document. Only the member matching type is set.
+/// Objects keep their members in file order.
+struct Value {
+  enum class Type { kNull, kBool, kNumber, kString, kArray, kObject };
+
+  Type type = Type::kNull;
+  bool boolean = false;
+  double number = 0;
+  std::string string;
+  std::vector<Value> elements;
+  std::vector<std::string> keys;
+  std::vector<Value> members;
+
+  bool IsNumber() const { return type == Type::kNumber; }
+  bool IsString() const { return type == Type::kString; }
+  bool IsArray() const { return type == Type::kArray; }
+  bool IsObject() const { return type == Type::kObject; }
+
+  /// @brief Finds the member named key of an object
+  /// @return the member, or nullptr if there is none or this is not an
+  /// object
+  const Value* Find(const std::string& key) const {
+    for (std::size_t i = 0; i < keys.size(); i++) {
+      if (keys[i] == key) {
+        return &members[i];
+      }
+    }
+    return nullptr;
+  }
+};
+
+namespace detail {
+
+class Parser {
+ public:
+  explicit Parser(const std::string& text) : text(text) {}
+
+  Value ParseDocument() {
+    auto value = ParseValue(0);
+    SkipWhitespace();
+    if (position != text.size()) {
+      Fail("trailing characters");
+    }
+    return value;
+  }
+
+ private:
+  // Deep enough for any benchmark output, shallow enough not to overflow
+  // the stack on hostile input
+  static constexpr std::size_t kMaxDepth = 256;
+
+  const std::string& text;
+  std::size_t position = 0;
+
+  [[noreturn]] void Fail(const char* what) const {
+    throw std::runtime_error(
+        fmt::format("invalid json at offset {}: {}", position, what));
+  }
+
+  void SkipWhitespace() {
+    while (position < text.size() &&
+           (text[position] == ' ' || text[position] == '\t' ||
+            text[position] == '\n' || text[position] == '\r')) {
+      position++;
+    }
+  }
+
+  bool Consume(char c) {
+    SkipWhitespace();
+    if (position < text.size() && text[position] == c) {
+      position++;
+      return true;
+    }
+    return false;
+  }
+
+  void Expect(char c) {
+    if (!Consume(c)) {
+      Fail(fmt::format("expected '{}'", c).c_str());
+    }
+  }
+
+  bool ConsumeWord(const char* word) {
+    std::size_t length = std::char_traits<char>::length(word);
+    if (text.compare(position, length, word) == 0) {
+      position += length;
+      return true;
+    }
+    return false;
+  }
+
+  Value ParseValue(std::size_t depth) {
+    if (depth > kMaxDepth) {
+      Fail("nesting too deep");
+    }
+    SkipWhitespace();
+    if (position == text.size()) {
+      Fail("unexpected end of input");
+    }
+    Value value;
+    char c = text[position];
+    if (c == '{') {
+      position++;
+      value.type = Value::Type::kObject;
+      if (Consume('}')) {
+        return value;
+      }
+      do {
+        SkipWhitespace();
+        if (position == text.size() || text[position] != '"') {
+          Fail("expected a member name");
+        }
+        value.keys.push_back(ParseString());
+        Expect(':');
+        value.members.push_back(ParseValue(depth + 1));
+      } while (Consume(','));
+      Expect('}');
+    } else if (c == '[') {
+      position++;
+      value.type = Value::Type::kArray;
+      if (Consume(']')) {
+        return value;
+      }
+      do {
+        value.elements.push_back(ParseValue(depth + 1));
+      } while (Consume(','));
+      Expect(']');
+    } else if (c == '"') {
+      value.type = Value::Type::kString;
+      value.string = ParseString();
+    } else if (ConsumeWord("true") || ConsumeWord("false")) {
+      value.type = Value::Type::kBool;
+      value.boolean = c == 't';
+    } else if (ConsumeWord("null")) {
+      value.type = Value::Type::kNull;
+    } else {
+      value.type = Value::Type::kNumber;
+      value.number = ParseNumber();
+    }
+    return value;
+  }
+
+  double ParseNumber() {
+    auto start = position;
+    auto digits = [&] {
+      auto first = position;
+      while (position < text.size() && text[position] >= '0' &&
+             text[position] <= '9') {
+        position++;
+      }
+      return position > first;
+    };
+    if (position < text.size() && text[position] == '-') {
+      position++;
+    }
+    if (!digits()) {
+      Fail("expected a value");
+    }
+    if (position < text.size() && text[position] == '.') {
+      position++;
+      if (!digits()) {
+        Fail("expected digits after '.'");
+      }
+    }
+    if (position < text.size() &&
+        (text[position] == 'e' || text[position] == 'E')) {
+      position++;
+      if (position < text.size() &&
+          (text[position] == '+' || text[position] == '-')) {
+        position++;
+      }
+      if (!digits()) {
+        Fail("expected exponent digits");
+      }
+    }
+    return std::strtod(text.substr(start, position - start).c_str(), nullptr);
+  }
+
+  unsigned ParseHex4() {
+    if (position + 4 > text.size()) {
+      Fail("truncated \\u escape");
+    }
+    unsigned code = 0;
+    for (int i = 0; i < 4; i++) {
+      char c = text[position++];
+      code <<= 4;
+      if (c >= '0' && c <= '9') {
+        code |= static_cast<unsigned>(c - '0');
+      } else if (c >= 'a' && c <= 'f') {
+        code |= static_cast<unsigned>(c - 'a' + 10);
+      } else if (c >= 'A' && c <= 'F') {
+        code |= static_cast<unsigned>(c - 'A' + 10);
+      } else {
+        Fail("invalid \\u escape");
+      }
+    }
+    return code;
+  }
+
+  static void AppendUtf8(std::string& out, unsigned code) {
+    if (code < 0x80) {
+      out += static_cast<char>(code);
+    } else if (code < 0x800) {
+      out += static_cast<char>(0xC0 | (code >> 6));
+      out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+      out += static_cast<char>(0xE0 | (code >> 12));
+      out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+      out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+      out += static_cast<char>(0xF0 | (code >> 18));
+      out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+      out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+      out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+  }
+
+  std::string ParseString() {
+    position++;  // opening quote
+    std::string out;
+    while (true) {
+      if (position == text.size()) {
+        Fail("unterminated string");
+      }
+      char c = text[position++];
+      if (c == '"') {
+        return out;
+      }
+      if (static_cast<unsigned char>(c) < 0x20) {
+        Fail("control character in string");
+      }
+      if (c != '\\') {
+        out += c;
+        continue;
+      }
+      if (position == text.size()) {
+        Fail("unterminated string");
+      }
+      char escape = text[position++];
+      switch (escape) {
+        case '"':
+        case '\\':
+        case '/':
+          out += escape;
+          break;
+        case 'b':
+          out += '\b';
+          break;
+        case 'f':
+          out += '\f';
+          break;
+        case 'n':
+          out += '\n';
+          break;
+        case 'r':
+          out += '\r';
+          break;
+        case 't':
+          out += '\t';
+          break;
+        case 'u': {
+          auto code = ParseHex4();
+          // A high surrogate followed by a low one encodes a code point
+          // above U+FFFF
+          if (code >= 0xD800 && code < 0xDC00 &&
+              text.compare(position, 2, "\\u") == 0) {
+            position += 2;
+            auto low = ParseHex4();
+            if (low < 0xDC00 || low >= 0xE000) {
+              Fail("unpaired surrogate");
+            }
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+          }
+          AppendUtf8(out, code);
+          break;
+        }
+        default:
+          Fail("invalid escape");
+      }
+    }
+  }
+};
+
+}  // namespace detail
+
+/// @brief Parses a complete JSON document (RFC 8259)
+/// @throws std::runtime_error with the offending offset if text is not valid
+/// JSON
+inline Value Parse(const std::string& text) {
+  return detail::Parser(text).ParseDocument();
+}
+
+}  // namespace json
+}  // namespace bench
+}  // namespace nll
@@ -0,0 +1,338 @@
+// Compares two Google Benchmark JSON outputs, typically a committed baseline
+// and a fresh run, and fails when a benchmark got significantly slower.
+//
+//   nll_bench_compare [options] <baseline.json> <contender.json>
+//
+// Benchmarks are matched by run name. Each repetition is one sample; a
+// two-sided Mann-Whitney U test decides whether the two runs differ, and the
+// Hodges-Lehmann estimate of the shift in log time gives the time ratio with
+// its confidence interval. Run the benchmarks with --benchmark_repetitions
+// of 5 or more and without --benchmark_report_aggregates_only, which drops
+// the repetitions from the file; with fewer samples no test can reach
+// significance and the comparison is only reported.
+//
+// Exit status: 0 when nothing regressed, 1 when a benchmark is significantly
+// slower by more than the threshold, 2 on bad arguments or input.
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "compare/json_reader.hpp"
+#include "compare/statistics.hpp"
+
+namespace {
+
+using nll::bench::json::Value;
+namespace statistics = nll::bench::statistics;
+
+struct Options {
+  std::string baseline_path;
+  std::string contender_path;
+  std::string metric = "cpu_time";
+  double alpha = 0.05;
+  // Relative change below which a significant difference is still reported
+  // as unchanged
+  double threshold = 0.05;
+};
+
+/// @brief Samples of one benchmark in nanoseconds, in file order
+using Samples = std::map<std::string, std::vector<double>>;
+
+struct Comparison {
+  std::string name;
+  double baseline_median = 0;
+  double contender_median = 0;
+  // contender / baseline time ratio with its confidence interval
+  double ratio = 1;
+  double ratio_lower = 1;
+  double ratio_upper = 1;
+  double p_value = 1;
+  bool testable = false;
+};
+
+enum class Verdict { kUnchanged, kFaster, kSlower, kUntested };
+
+[[noreturn]] void Usage(const std::string& error) {
+  fmt::print(stderr,
+             "error: {}\n"
+             "usage: nll_bench_compare [--metric=cpu_time|real_time] "
+             "[--alpha=P] [--threshold=PERCENT] <baseline.json> "
+             "<contender.json>\n",
+             error);
+  std::exit(2);
+}
+
+double ParseNumber(const std::string& text, const std::string& option) {
+  char* end = nullptr;
+  double value = std::strtod(text.c_str(), &end);
+  if (text.empty() || *end != '\0') {
+    Usage(fmt::format("{} expects a number, got '{}'", option, text));
+  }
+  return value;
+}
+
+Options ParseOptions(int argc, char** argv) {
+  Options options;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; i++) {
+    std::string argument = argv[i];
+    auto value = [&](const std::string& option) -> std::string {
+      return argument.substr(option.size() + 1);
+    };
+    if (argument.rfind("--metric=", 0) == 0) {
+      options.metric = value("--metric");
+      if (options.metric != "cpu_time" && options.metric != "real_time") {
+        Usage("--metric must be cpu_time or real_time");
+      }
+    } else if (argument.rfind("--alpha=", 0) == 0) {
+      options.alpha = ParseNumber(value("--alpha"), "--alpha");
+      if (options.alpha <= 0 || options.alpha >= 1) {
+        Usage("--alpha must be in (0, 1)");
+      }
+    } else if (argument.rfind("--threshold=", 0) == 0) {
+      options.threshold =
+          ParseNumber(value("--threshold"), "--threshold") / 100;
+      if (options.threshold < 0) {
+        Usage("--threshold must not be negative");
+      }
+    } else if (argument == "--help" || argument == "-h") {
+      Usage("no comparison requested");
+    } else if (argument.rfind("--", 0) == 0) {
+      Usage(fmt::format("unknown option {}", argument));
+    } else {
+      paths.push_back(argument);
+    }
+  }
+  if (paths.size() != 2) {
+    Usage("expected a baseline and a contender file");
+  }
+  options.baseline_path = paths[0];
+  options.contender_path = paths[1];
+  return options;
+}
+
+double NanosecondsPer(const std::string& unit) {
+  if (unit == "ns") {
+    return 1;
+  }
+  if (unit == "us") {
+    return 1e3;
+  }
+  if (unit == "ms") {
+    return 1e6;
+  }
+  if (unit == "s") {
+    return 1e9;
+  }
+  throw std::runtime_error(fmt::format("unknown time unit {}", unit));
+}
+
+std::string StringMember(const Value& object, const std::string& key) {
+  auto* member = object.Find(key);
+  return member && member->IsString() ? member->string : std::string();
+}
+
+/// @brief Reads the per-repetition times of every benchmark in a file.
+/// Aggregates are skipped; a benchmark that only has aggregates (from
+/// --benchmark_report_aggregates_only) contributes its mean as one sample.
+Samples LoadSamples(const std::string& path, const std::string& metric) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error(fmt::format("cannot open {}", path));
+  }
+  std::stringstream text;
+  text << file.rdbuf();
+  Value document;
+  try {
+    document = nll::bench::json::Parse(text.str());
+  } catch (const std::runtime_error& error) {
+    throw std::runtime_error(fmt::format("{}: {}", path, error.what()));
+  }
+  auto* benchmarks = document.Find("benchmarks");
+  if (!benchmarks || !benchmarks->IsArray()) {
+    throw std::runtime_error(
+        fmt::format("{} is not a Google Benchmark JSON output", path));
+  }
+
+  Samples samples;
+  Samples means;
+  for (const auto& benchmark : benchmarks->elements) {
+    auto* time = benchmark.Find(metric);
+    auto* error = benchmark.Find("error_occurred");
+    if (!time || !time->IsNumber() || (error && error->boolean)) {
+      continue;
+    }
+    auto name = StringMember(benchmark, "run_name");
+    if (name.empty()) {
+      name = StringMember(benchmark, "name");
+    }
+    auto unit = StringMember(benchmark, "time_unit");
+    auto nanoseconds =
+        time->number * NanosecondsPer(unit.empty() ? "ns" : unit);
+    auto run_type = StringMember(benchmark, "run_type");
+    if (run_type == "aggregate") {
+      if (StringMember(benchmark, "aggregate_name") == "mean") {
+        means[name].push_back(nanoseconds);
+      }
+    } else {
+      samples[name].push_back(nanoseconds);
+    }
+  }
+  for (auto& [name, mean] : means) {
+    samples.emplace(name, mean);
+  }
+  return samples;
+}
+
+Comparison Compare(const std::string& name, const std::vector<double>& before,
+                   const std::vector<double>& after, const Options& options) {
+  Comparison comparison;
+  comparison.name = name;
+  comparison.baseline_median = statistics::Median(before);
+  comparison.contender_median = statistics::Median(after);
+
+  // Timings are compared as logarithms, so the shift is a ratio and a
+  // benchmark taking 1 ms weighs the same as one taking 1 ns
+  std::vector<double> log_before;
+  std::vector<double> log_after;
+  for (auto time : before) {
+    log_before.push_back(std::log(time));
+  }
+  for (auto time : after) {
+    log_after.push_back(std::log(time));
+  }
+  auto shift = statistics::HodgesLehmannShift(log_before, log_after,
+                                              1 - options.alpha);
+  comparison.ratio = std::exp(shift.estimate);
+  comparison.ratio_lower = std::exp(shift.lower);
+  comparison.ratio_upper = std::exp(shift.upper);
+  comparison.testable = statistics::MinimumPValue(before.size(),
+                                                  after.size()) < options.alpha;
+  comparison.p_value = statistics::MannWhitneyU(log_before, log_after).p_value;
+  return comparison;
+}
+
+Verdict Judge(const Comparison& comparison, const Options& options) {
+  if (!comparison.testable) {
+    return Verdict::kUntested;
+  }
+  if (comparison.p_value >= options.alpha) {
+    return Verdict::kUnchanged;
+  }
+  if (comparison.ratio > 1 + options.threshold) {
+    return Verdict::kSlower;
+  }
+  if (comparison.ratio < 1 - options.threshold) {
+    return Verdict::kFaster;
+  }
+  return Verdict::kUnchanged;
+}
+
+std::string FormatTime(double nanoseconds) {
+  if (nanoseconds >= 1e9) {
+    return fmt::format("{:.3g} s", nanoseconds / 1e9);
+  }
+  if (nanoseconds >= 1e6) {
+    return fmt::format("{:.3g} ms", nanoseconds / 1e6);
+  }
+  if (nanoseconds >= 1e3) {
+    return fmt::format("{:.3g} us", nanoseconds / 1e3);
+  }
+  return fmt::format("{:.3g} ns", nanoseconds);
+}
+
+std::string FormatChange(double ratio) {
+  return fmt::format("{:+.1f}%", (ratio - 1) * 100);
+}
+
+const char* VerdictName(Verdict verdict) {
+  switch (verdict) {
+    case Verdict::kFaster:
+      return "faster";
+    case Verdict::kSlower:
+      return "SLOWER";
+    case Verdict::kUntested:
+      return "untested";
+    case Verdict::kUnchanged:
+      break;
+  }
+  return "";
+}
+
+int Run(const Options& options) {
+  auto baseline = LoadSamples(options.baseline_path, options.metric);
+  auto contender = LoadSamples(options.contender_path, options.metric);
+
+  std::vector<Comparison> comparisons;
+  std::vector<std::string> missing;
+  std::size_t name_width = 9;
+  for (const auto& [name, before] : baseline) {
+    auto after = contender.find(name);
+    if (after == contender.end()) {
+      missing.push_back(name);
+      continue;
+    }
+    comparisons.push_back(Compare(name, before, after->second, options));
+    name_width = std::max(name_width, name.size());
+  }
+
+  fmt::print("{:<{}}  {:>10}  {:>10}  {:>8}  {:>19}  {:>7}\n", "Benchmark",
+             name_width, "Baseline", "Contender", "Change",
+             fmt::format("{:.0f}% CI", (1 - options.alpha) * 100), "p");
+  std::size_t slower = 0;
+  std::size_t faster = 0;
+  std::size_t untested = 0;
+  for (const auto& comparison : comparisons) {
+    auto verdict = Judge(comparison, options);
+    slower += verdict == Verdict::kSlower;
+    faster += verdict == Verdict::kFaster;
+    untested += verdict == Verdict::kUntested;
+    fmt::print("{:<{}}  {:>10}  {:>10}  {:>8}  {:>19}  {:>7.3f}  {}\n",
+               comparison.name, name_width,
+               FormatTime(comparison.baseline_median),
+               FormatTime(comparison.contender_median),
+               FormatChange(comparison.ratio),
+               fmt::format("[{}, {}]", FormatChange(comparison.ratio_lower),
+                           FormatChange(comparison.ratio_upper)),
+               comparison.p_value, VerdictName(verdict));
+  }
+  for (const auto& [name, after] : contender) {
+    if (!baseline.count(name)) {
+      fmt::print("only in contender: {}\n", name);
+    }
+  }
+  for (const auto& name : missing) {
+    fmt::print("only in baseline: {}\n", name);
+  }
+
+  fmt::print("\n{} compared, {} slower, {} faster (threshold {:.1f}%, "
+             "alpha {})\n",
+             comparisons.size(), slower, faster, options.threshold * 100,
+             options.alpha);
+  if (untested > 0) {
+    fmt::print("{} benchmarks have too few repetitions to reach alpha {}; "
+               "rerun with --benchmark_repetitions=5 or more\n",
+               untested, options.alpha);
+  }
+  return slower > 0 ? 1 : 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  auto options = ParseOptions(argc, argv);
+  try {
+    return Run(options);
+  } catch (const std::exception& error) {
+    fmt::print(stderr, "error: {}\n", error.what());
+    return 2;
+  }
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace nll {
+namespace bench {
+namespace statistics {
+
+/// @brief Up to this many samples per side the Mann-Whitney U distribution
+/// is counted exactly; beyond it the normal approximation is within a few
+/// percent of it
+constexpr std::size_t kMaxExactSamples = 50;
+
+/// @brief Standard normal cumulative distribution function
+inline double NormalCdf(double z) {
+  return 0.5 * std::erfc(-z / std::sqrt(2.0));
+}
+
+/// @brief Inverse of NormalCdf, by bisection
+inline double NormalQuantile(double p) {
+  if (p <= 0 || p >= 1) {
+    throw std::invalid_argument("probability must be in (0, 1)!");
+  }
+  double low = -40;
+  double high = 40;
+  for (int i = 0; i < 200; i++) {
+    double middle = (low + high) / 2;
+    (NormalCdf(middle) < p ? low : high) = middle;
+  }
+  return (low + high) / 2;
+}
+
+inline double Median(std::vector<double> values) {
+  if (values.empty()) {
+    throw std::invalid_argument("median of no values!");
+  }
+  auto middle = values.begin() + values.size() / 2;
+  std::nth_element(values.begin(), middle, values.end());
+  if (values.size() % 2 == 1) {
+    return *middle;
+  }
+  return (*middle + *std::max_element(values.begin(), middle)) / 2;
+}
+
+/// @brief Null distribution of the Mann-Whitney U statistic for two untied
+/// samples of sizes m and n: element u is the probability that U = u when
+/// both samples come from the same distribution
+inline std::vector<double> MannWhitneyDistribution(std::size_t m,
+                                                   std::size_t n) {
+  auto max_u = m * n;
+  // counts[j][v]: orderings of i x's and j y's where U = v, built up one x at
+  // a time. The largest element is either an x above all j y's or a y, so
+  // c(i, j, v) = c(i - 1, j, v - j) + c(i, j - 1, v).
+  std::vector<std::vector<double>> counts(
+      n + 1, std::vector<double>(max_u + 1, 0));
+  for (auto& row : counts) {
+    row[0] = 1;
+  }
+  for (std::size_t i = 1; i <= m; i++) {
+    std::vector<std::vector<double>> next(n + 1,
+                                          std::vector<double>(max_u + 1, 0));
+    next[0][0] = 1;
+    for (std::size_t j = 1; j <= n; j++) {
+      for (std::size_t v = 0; v <= i * j; v++) {
+        next[j][v] = (v >= j ? counts[j][v - j] : 0) + next[j - 1][v];
+      }
+    }
+    counts = std::move(next);
+  }
+  auto distribution = std::move(counts[n]);
+  auto total =
+      std::accumulate(distribution.begin(), distribution.end(), 0.0);
+  for (auto& probability : distribution) {
+    probability /= total;
+  }
+  return distribution;
+}
+
+/// @brief Probability that the U statistic of two untied samples of sizes m
+/// and n is at most u under the null hypothesis
+inline double MannWhitneyCdf(std::size_t m, std::size_t n, double u) {
+  if (u < 0) {
+    return 0;
+  }
+  auto distribution = MannWhitneyDistribution(m, n);
+  auto last = std::min(static_cast<std::size_t>(u), m * n);
+  return std::accumulate(distribution.begin(),
+                         distribution.begin() + last + 1, 0.0);
+}
+
+/// @brief Smallest two-sided p-value any pair of samples of sizes m and n
+/// can reach, 2 / C(m + n, m). If it is not below the significance level,
+/// no difference can ever be detected with that many repetitions.
+inline double MinimumPValue(std::size_t m, std::size_t n) {
+  double orderings = 1;
+  for (std::size_t i = 1; i <= m; i++) {
+    orderings *= static_cast<double>(n + i) / static_cast<double>(i);
+  }
+  return std::min(1.0, 2 / orderings);
+}
+
+struct MannWhitneyResult {
+  /// @brief Pairs (x, y) with x > y, ties counting one half
+  double u = 0;
+  /// @brief Two-sided p-value for the samples coming from distributions
+  /// with the same median
+  double p_value = 1;
+  /// @brief Whether p_value is exact rather than a normal approximation
+  bool exact = false;
+};
+
+/// @brief Two-sided Mann-Whitney U (Wilcoxon rank-sum) test. It assumes
+/// nothing about the shape of the distributions, which suits benchmark
+/// timings: skewed, with outliers from interrupts and frequency changes.
+inline MannWhitneyResult MannWhitneyU(const std::vector<double>& x,
+                                      const std::vector<double>& y) {
+  if (x.empty() || y.empty()) {
+    throw std::invalid_argument("both samples need at least one value!");
+  }
+  auto m = x.size();
+  auto n = y.size();
+  std::vector<std::pair<double, bool>> pooled;
+  pooled.reserve(m + n);
+  for (auto value : x) {
+    pooled.emplace_back(value, true);
+  }
+  for (auto value : y) {
+    pooled.emplace_back(value, false);
+  }
+  std::sort(pooled.begin(), pooled.end());
+
+  // Ranks start at 1, tied values share the mean of their ranks
+  double x_rank_sum = 0;
+  double tie_term = 0;
+  bool ties = false;
+  for (std::size_t i = 0; i < pooled.size();) {
+    auto j = i;
+    while (j < pooled.size() && pooled[j].first == pooled[i].first) {
+      j++;
+    }
+    double rank = (static_cast<double>(i + j) + 1) / 2;
+    double tied = static_cast<double>(j - i);
+    ties = ties || tied > 1;
+    tie_term += tied * tied * tied - tied;
+    for (auto k = i; k < j; k++) {
+      x_rank_sum += pooled[k].second ? rank : 0;
+    }
+    i = j;
+  }
+
+  MannWhitneyResult result;
+  auto md = static_cast<double>(m);
+  auto nd = static_cast<double>(n);
+  result.u = x_rank_sum - md * (md + 1) / 2;
+  double mean = md * nd / 2;
+  double smaller_u = std::min(result.u, md * nd - result.u);
+  if (!ties && m <= kMaxExactSamples && n <= kMaxExactSamples) {
+    result.exact = true;
+    result.p_value = std::min(1.0, 2 * MannWhitneyCdf(m, n, smaller_u));
+    return result;
+  }
+  double total = md + nd;
+  double variance =
+      md * nd / 12 * ((total + 1) - tie_term / (total * (total - 1)));
+  if (variance <= 0) {
+    // Every value is the same
+    result.p_value = 1;
+    return result;
+  }
+  // Continuity correction: U moves in steps of 1/2 at worst
+  double z = (mean - smaller_u - 0.5) / std::sqrt(variance);
+  result.p_value = std::min(1.0, 2 * NormalCdf(-std::max(0.0, z)));
+  return result;
+}
+
+struct ShiftEstimate {
+  /// @brief Hodges-Lehmann estimate: the median of all differences y - x
+  double estimate = 0;
+  double lower = 0;
+  double upper = 0;
+};
+
+/// @brief Estimates how far y is shifted from x, with a distribution-free
+/// confidence interval read off the sorted pairwise differences at the
+/// ranks the Mann-Whitney critical value gives (Moses). With too few
+/// samples for the requested confidence the interval spans every
+/// difference.
+inline ShiftEstimate HodgesLehmannShift(const std::vector<double>& x,
+                                        const std::vector<double>& y,
+                                        double confidence = 0.95) {
+  if (x.empty() || y.empty()) {
+    throw std::invalid_argument("both samples need at least one value!");
+  }
+  if (confidence <= 0 || confidence >= 1) {
+    throw std::invalid_argument("confidence must be in (0, 1)!");
+  }
+  std::vector<double> differences;
+  differences.reserve(x.size() * y.size());
+  for (auto a : x) {
+    for (auto b : y) {
+      differences.push_back(b - a);
+    }
+  }
+  std::sort(differences.begin(), differences.end());
+
+  // critical: the largest c with P(U <= c) <= (1 - confidence) / 2, so the
+  // interval drops the critical smallest and largest differences
+  auto m = x.size();
+  auto n = y.size();
+  double tail = (1 - confidence) / 2;
+  std::ptrdiff_t critical = -1;
+  if (m <= kMaxExactSamples && n <= kMaxExactSamples) {
+    auto distribution = MannWhitneyDistribution(m, n);
+    double cumulative = distribution[0];
+    while (cumulative <= tail) {
+      critical++;
+      cumulative += distribution[critical + 1];
+    }
+  } else {
+    auto md = static_cast<double>(m);
+    auto nd = static_cast<double>(n);
+    critical = static_cast<std::ptrdiff_t>(
+        std::floor(md * nd / 2 - 0.5 +
+                   NormalQuantile(tail) *
+                       std::sqrt(md * nd * (md + nd + 1) / 12)));
+  }
+  auto drop = static_cast<std::size_t>(std::max<std::ptrdiff_t>(0, critical));
+  drop = std::min(drop, (differences.size() - 1) / 2);
+
+  ShiftEstimate shift;
+  shift.estimate = Median(differences);
+  shift.lower = differences[drop];
+  shift.upper = differences[differences.size() - 1 - drop];
+  return shift;
+}
+
+}  // namespace statistics
+}  // namespace bench
+}  // namespace nll
@@ -0,0 +1,88 @@
+#include "nll/geometry/point.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "nll/geometry/triangles.hpp"
+#include "scoped_counters.hpp"
+
+namespace {
+
+std::vector<nll::geometry::Point2d> RandomPoints(std::size_t count) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> coordinate(-1000.0, 1000.0);
+  std::vector<nll::geometry::Point2d> points;
+  points.reserve(count);
+  for (std::size_t i = 0; i < count; i++) {
+    points.emplace_back(coordinate(rng), coordinate(rng));
+  }
+  return points;
+}
+
+}  // namespace
+
+static void BM_Point2Norm(benchmark::State& state) {
+  auto points = RandomPoints(state.range(0));
+  auto order = nll::bench::KeysFor(state);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    double sum = 0;
+    for (auto i : order) {
+      sum += points[i].norm();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * order.size());
+}
+
+static void BM_StdHypot(benchmark::State& state) {
+  auto points = RandomPoints(state.range(0));
+  auto order = nll::bench::KeysFor(state);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    double sum = 0;
+    for (auto i : order) {
+      sum += std::hypot(points[i].x, points[i].y);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * order.size());
+}
+
+static void BM_Point2Arithmetic(benchmark::State& state) {
+  auto points = RandomPoints(state.range(0));
+  auto order = nll::bench::KeysFor(state);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::geometry::Point2d centroid(0, 0);
+    for (auto i : order) {
+      centroid = centroid + points[i];
+    }
+    benchmark::DoNotOptimize(centroid / static_cast<double>(order.size()));
+  }
+  state.SetItemsProcessed(state.iterations() * order.size());
+}
+
+static void BM_AreaOfTriangle(benchmark::State& state) {
+  auto points = RandomPoints(state.range(0) + 2);
+  auto order = nll::bench::KeysFor(state);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    double sum = 0;
+    for (auto i : order) {
+      sum += nll::geometry::areaOfTriangle(points[i], points[i + 1],
+                                           points[i + 2]);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * order.size());
+}
+
+BENCHMARK(BM_Point2Norm)->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK(BM_StdHypot)->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK(BM_Point2Arithmetic)->Apply(nll::bench::SizesAndPatterns);
+BENCHMARK(BM_AreaOfTriangle)->Apply(nll::bench::SizesAndPatterns);
@@ -0,0 +1,219 @@
+#include "nll/graph/adaptive_radix_tree.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "nll/collections/hashmap.hpp"
+#include "scoped_counters.hpp"
+
+namespace {
+
+/// @brief 1K to 1M keys; URL sets past that take long to build
+void RadixSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->RangeMultiplier(8)->Range(1 << 10, 1 << 20)->ArgName("size");
+}
+
+template <class TKey>
+using RadixTree = nll::binary_tree::AdaptiveRadixTree<TKey, std::uint32_t>;
+
+/// @brief URL-like keys: a few hosts and sections sharing long prefixes,
+/// then a numeric id, like a crawler's or a cache's key set
+std::vector<std::string> UrlKeys(std::size_t count) {
+  static const char* kSections[] = {"articles", "images", "users", "api/v2",
+                                    "static/js", "search"};
+  std::mt19937 random(42);
+  std::vector<std::string> keys(count);
+  for (auto& key : keys) {
+    key = "https://www.host" + std::to_string(random() % 64) + ".com/" +
+          kSections[random() % 6] + "/" + std::to_string(random());
+  }
+  return keys;
+}
+
+/// @brief Uniformly random 64-bit integer keys
+std::vector<std::uint64_t> IntegerKeys(std::size_t count) {
+  std::mt19937_64 random(42);
+  std::vector<std::uint64_t> keys(count);
+  for (auto& key : keys) {
+    key = random();
+  }
+  return keys;
+}
+
+template <class TKey>
+std::vector<TKey> KeysOf(std::size_t count);
+
+template <>
+std::vector<std::string> KeysOf<std::string>(std::size_t count) {
+  return UrlKeys(count);
+}
+
+template <>
+std::vector<std::uint64_t> KeysOf<std::uint64_t>(std::size_t count) {
+  return IntegerKeys(count);
+}
+
+/// @brief The same keys in another order, so lookups do not follow inserts
+template <class TKey>
+std::vector<TKey> ProbesOf(std::vector<TKey> keys) {
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+  return keys;
+}
+
+template <class TKey>
+struct RadixTreeOps {
+  using Map = RadixTree<TKey>;
+  static void Insert(Map& map, const TKey& key) { map.Insert(key, 0); }
+  static bool Find(const Map& map, const TKey& key) {
+    return map.Find(key) != nullptr;
+  }
+};
+
+template <class TKey>
+struct HashmapOps {
+  using Map = nll::Hashmap<TKey, std::uint32_t>;
+  static void Insert(Map& map, const TKey& key) { map.Insert(key, 0); }
+  static bool Find(Map& map, const TKey& key) {
+    return map.Find(key) != nullptr;
+  }
+};
+
+template <class TKey>
+struct StdMapOps {
+  using Map = std::map<TKey, std::uint32_t>;
+  static void Insert(Map& map, const TKey& key) { map.emplace(key, 0); }
+  static bool Find(const Map& map, const TKey& key) {
+    return map.find(key) != map.end();
+  }
+};
+
+template <class TOps, class TKey>
+typename TOps::Map MapOf(const std::vector<TKey>& keys) {
+  typename TOps::Map map;
+  for (const auto& key : keys) {
+    TOps::Insert(map, key);
+  }
+  return map;
+}
+
+template <class TOps, class TKey>
+void BM_Insert(benchmark::State& state) {
+  auto keys = KeysOf<TKey>(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    auto map = MapOf<TOps>(keys);
+    benchmark::DoNotOptimize(map);
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <class TOps, class TKey>
+void BM_Find(benchmark::State& state) {
+  auto keys = KeysOf<TKey>(state.range(0));
+  auto map = MapOf<TOps>(keys);
+  auto probes = ProbesOf(keys);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (const auto& probe : probes) {
+      benchmark::DoNotOptimize(TOps::Find(map, probe));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+/// @brief Visits every URL under one host and section, about 1/384 of the
+/// keys
+static void BM_RadixTreeScanPrefix(benchmark::State& state) {
+  auto keys = UrlKeys(state.range(0));
+  auto map = MapOf<RadixTreeOps<std::string>>(keys);
+  nll::bench::ScopedCounters counters(state);
+  std::size_t visited = 0;
+  for (auto _ : state) {
+    visited = map.ScanPrefix("https://www.host7.com/users/",
+                             [](const std::string&, std::uint32_t) {
+                               return true;
+                             });
+    benchmark::DoNotOptimize(visited);
+  }
+  state.SetItemsProcessed(state.iterations() * visited);
+}
+
+static void BM_StdMapScanPrefix(benchmark::State& state) {
+  auto keys = UrlKeys(state.range(0));
+  auto map = MapOf<StdMapOps<std::string>>(keys);
+  const std::string prefix = "https://www.host7.com/users/";
+  nll::bench::ScopedCounters counters(state);
+  std::size_t visited = 0;
+  for (auto _ : state) {
+    visited = 0;
+    for (auto it = map.lower_bound(prefix);
+         it != map.end() && it->first.compare(0, prefix.size(), prefix) == 0;
+         ++it) {
+      visited++;
+    }
+    benchmark::DoNotOptimize(visited);
+  }
+  state.SetItemsProcessed(state.iterations() * visited);
+}
+
+/// @brief Walks every integer key in order
+static void BM_RadixTreeOrderedScan(benchmark::State& state) {
+  auto map = MapOf<RadixTreeOps<std::uint64_t>>(IntegerKeys(state.range(0)));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::uint64_t sum = 0;
+    map.ForEach([&](std::uint64_t key, std::uint32_t) { sum += key; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * map.Size());
+}
+
+static void BM_StdMapOrderedScan(benchmark::State& state) {
+  auto map = MapOf<StdMapOps<std::uint64_t>>(IntegerKeys(state.range(0)));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::uint64_t sum = 0;
+    for (const auto& entry : map) {
+      sum += entry.first;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * map.size());
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_Insert, RadixTreeOps<std::string>, std::string)
+    ->Apply(RadixSizes);
+BENCHMARK_TEMPLATE(BM_Insert, HashmapOps<std::string>, std::string)
+    ->Apply(RadixSizes);
+BENCHMARK_TEMPLATE(BM_Insert, StdMapOps<std::string>, std::string)
+    ->Apply(RadixSizes);
+BENCHMARK_TEMPLATE(BM_Insert, RadixTreeOps<std::uint64_t>, std::uint64_t)
+    ->Apply(RadixSizes);
+BENCHMARK_TEMPLATE(BM_Insert, HashmapOps<std::uint64_t>, std::uint64_t)
+    ->Apply(RadixSizes);
+BENCHMARK_TEMPLATE(BM_Insert, StdMapOps<std::uint64_t>, std::uint64_t)
+    ->Apply(RadixSizes);
+BENCHMARK_TEMPLATE(BM_Find, RadixTreeOps<std::string>, std::string)
+    ->Apply(RadixSizes);
+BENCHMARK_TEMPLATE(BM_Find, HashmapOps<std::string>, std::string)
+    ->Apply(RadixSizes);
+BENCHMARK_TEMPLATE(BM_Find, StdMapOps<std::string>, std::string)
+    ->Apply(RadixSizes);
+BENCHMARK_TEMPLATE(BM_Find, RadixTreeOps<std::uint64_t>, std::uint64_t)
+    ->Apply(RadixSizes);
+BENCHMARK_TEMPLATE(BM_Find, HashmapOps<std::uint64_t>, std::uint64_t)
+    ->Apply(RadixSizes);
+BENCHMARK_TEMPLATE(BM_Find, StdMapOps<std::uint64_t>, std::uint64_t)
+    ->Apply(RadixSizes);
+BENCHMARK(BM_RadixTreeScanPrefix)->Apply(RadixSizes);
+BENCHMARK(BM_StdMapScanPrefix)->Apply(RadixSizes);
+BENCHMARK(BM_RadixTreeOrderedScan)->Apply(RadixSizes);
+BENCHMARK(BM_StdMapOrderedScan)->Apply(RadixSizes);
@@ -0,0 +1,86 @@
+#include "nll/graph/bfs.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "graph_generators.hpp"
+#include "scoped_counters.hpp"
+
+namespace {
+
+constexpr std::size_t kEdgeFactor = 16;
+
+nll::graph::CsrGraph32 MakeRmatGraph(unsigned scale) {
+  nll::graph::CsrBuildOptions options;
+  options.symmetrize = true;
+  options.deduplicate = true;
+  options.remove_self_loops = true;
+  return nll::graph::CsrGraph32::FromEdges(
+      nll::bench::RmatEdges(scale, kEdgeFactor), std::size_t{1} << scale,
+      options);
+}
+
+/// @brief Picks the highest degree vertex so the search covers the giant
+/// component rather than an isolated vertex
+std::uint32_t PickSource(const nll::graph::CsrGraph32& graph) {
+  std::uint32_t best = 0;
+  for (std::uint32_t v = 0; v < graph.NumVertices(); v++) {
+    if (graph.Degree(v) > graph.Degree(best)) {
+      best = v;
+    }
+  }
+  return best;
+}
+
+/// @brief Counts undirected edges inside the searched component, the Graph500
+/// definition of edges traversed
+std::size_t EdgesTraversed(const nll::graph::CsrGraph32& graph,
+                           const nll::graph::BfsResult<std::uint32_t>& result) {
+  std::size_t edges = 0;
+  for (std::uint32_t v = 0; v < graph.NumVertices(); v++) {
+    if (result.distances[v] != result.kUnreached) {
+      edges += graph.Degree(v);
+    }
+  }
+  return edges / 2;
+}
+
+void RunBfs(benchmark::State& state, bool direction_optimizing) {
+  auto graph = MakeRmatGraph(static_cast<unsigned>(state.range(0)));
+  auto source = PickSource(graph);
+  nll::graph::BfsOptions options;
+  options.num_threads = static_cast<unsigned>(state.range(1));
+  options.direction_optimizing = direction_optimizing;
+  std::size_t edges = 0;
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    auto result = nll::graph::BreadthFirstSearch(graph, source, options);
+    edges = EdgesTraversed(graph, result);
+    benchmark::DoNotOptimize(result.parents.data());
+  }
+  state.counters["TEPS"] = benchmark::Counter(
+      static_cast<double>(edges * state.iterations()),
+      benchmark::Counter::kIsRate);
+}
+
+}  // namespace
+
+static void BM_BfsRmatDirectionOptimizing(benchmark::State& state) {
+  RunBfs(state, true);
+}
+
+static void BM_BfsRmatTopDown(benchmark::State& state) {
+  RunBfs(state, false);
+}
+
+// Args are {RMAT scale, threads}
+BENCHMARK(BM_BfsRmatDirectionOptimizing)
+    ->ArgsProduct({{14, 18}, benchmark::CreateRange(1, 16, 2)})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_BfsRmatTopDown)
+    ->ArgsProduct({{14, 18}, benchmark::CreateRange(1, 16, 2)})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,153 @@
+#include "nll/graph/btree.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "nll/graph/ordered_map.hpp"
+#include "scoped_counters.hpp"
+
+namespace {
+
+using BPlusTree = nll::binary_tree::BPlusTree<std::uint32_t, std::uint32_t>;
+using ConcurrentBPlusTree =
+    nll::binary_tree::BPlusTree<std::uint32_t, std::uint32_t, true>;
+
+std::vector<std::uint32_t> RandomKeys(std::size_t count) {
+  std::mt19937 rng(42);
+  std::vector<std::uint32_t> keys(count);
+  for (auto& key : keys) {
+    key = rng();
+  }
+  return keys;
+}
+
+std::vector<std::pair<std::uint32_t, std::uint32_t>> SortedEntries(
+    std::size_t count) {
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> entries(count);
+  for (std::uint32_t i = 0; i < count; i++) {
+    entries[i] = {i * 2, i};
+  }
+  return entries;
+}
+
+}  // namespace
+
+static void BM_BPlusTreeInsert(benchmark::State& state) {
+  auto keys = RandomKeys(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    BPlusTree tree;
+    for (auto key : keys) {
+      tree.Insert(key, key);
+    }
+    benchmark::DoNotOptimize(tree.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_BPlusTreeLookup(benchmark::State& state) {
+  auto entries = SortedEntries(state.range(0));
+  auto tree = BPlusTree::FromSorted(entries);
+  auto probes = RandomKeys(1 << 12);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto probe : probes) {
+      benchmark::DoNotOptimize(tree.Find(probe % (2 * entries.size())));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+static void BM_OrderedMapLookupBaseline(benchmark::State& state) {
+  auto map = nll::binary_tree::OrderedMap<std::uint32_t, std::uint32_t>::
+      FromSorted(SortedEntries(state.range(0)));
+  auto probes = RandomKeys(1 << 12);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto probe : probes) {
+      benchmark::DoNotOptimize(map.Find(probe % (2 * map.Size())));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+static void BM_StdMapLookupBaseline(benchmark::State& state) {
+  auto entries = SortedEntries(state.range(0));
+  std::map<std::uint32_t, std::uint32_t> map(entries.begin(), entries.end());
+  auto probes = RandomKeys(1 << 12);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto probe : probes) {
+      benchmark::DoNotOptimize(map.find(probe % (2 * entries.size())));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+static void BM_BPlusTreeRangeScan(benchmark::State& state) {
+  auto tree = BPlusTree::FromSorted(SortedEntries(state.range(0)));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::uint64_t sum = 0;
+    tree.Scan(0, [&](std::uint32_t, std::uint32_t value) {
+      sum += value;
+      return true;
+    });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * tree.Size());
+}
+
+static void BM_BPlusTreeBulkLoad(benchmark::State& state) {
+  auto entries = SortedEntries(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    auto tree = BPlusTree::FromSorted(entries);
+    benchmark::DoNotOptimize(tree.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * entries.size());
+}
+
+/// @brief Each thread inserts its own slice of keys while also looking up
+/// keys from the whole range
+static void BM_ConcurrentBPlusTreeMixed(benchmark::State& state) {
+  auto num_threads = static_cast<std::size_t>(state.range(0));
+  auto keys = RandomKeys(1 << 18);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    ConcurrentBPlusTree tree;
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t] {
+        for (auto i = t; i < keys.size(); i += num_threads) {
+          tree.Insert(keys[i], keys[i]);
+          benchmark::DoNotOptimize(tree.Find(keys[i / 2]));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    benchmark::DoNotOptimize(tree.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size() * 2);
+}
+
+BENCHMARK(BM_BPlusTreeInsert)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_BPlusTreeLookup)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_OrderedMapLookupBaseline)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_StdMapLookupBaseline)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_BPlusTreeRangeScan)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_BPlusTreeBulkLoad)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_ConcurrentBPlusTreeMixed)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
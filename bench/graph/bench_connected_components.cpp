@@ -0,0 +1,109 @@
+#include "nll/graph/connected_components.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "graph_generators.hpp"
+#include "scoped_counters.hpp"
+
+namespace {
+
+/// @brief Sparse enough (average degree 2) that there are many components
+nll::graph::CsrGraph32 MakeSparseGraph(std::size_t num_vertices) {
+  nll::graph::CsrBuildOptions options;
+  options.symmetrize = true;
+  return nll::graph::CsrGraph32::FromEdges(
+      nll::bench::UniformRandomEdges(num_vertices, num_vertices),
+      num_vertices, options);
+}
+
+/// @brief Baseline: label every component with a sequential BFS
+std::vector<std::uint32_t> BfsLabeling(const nll::graph::CsrGraph32& graph) {
+  constexpr auto kUnlabeled = ~std::uint32_t{0};
+  std::vector<std::uint32_t> labels(graph.NumVertices(), kUnlabeled);
+  std::vector<std::uint32_t> queue;
+  for (std::uint32_t root = 0; root < graph.NumVertices(); root++) {
+    if (labels[root] != kUnlabeled) {
+      continue;
+    }
+    labels[root] = root;
+    queue.assign(1, root);
+    for (std::size_t head = 0; head < queue.size(); head++) {
+      for (auto v : graph.Neighbors(queue[head])) {
+        if (labels[v] == kUnlabeled) {
+          labels[v] = root;
+          queue.push_back(v);
+        }
+      }
+    }
+  }
+  return labels;
+}
+
+}  // namespace
+
+static void BM_ComponentsSequentialBfs(benchmark::State& state) {
+  auto graph = MakeSparseGraph(static_cast<std::size_t>(state.range(0)));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(BfsLabeling(graph).data());
+  }
+  state.SetItemsProcessed(state.iterations() * graph.NumEdges());
+}
+
+static void BM_ComponentsAfforest(benchmark::State& state) {
+  auto graph = MakeSparseGraph(static_cast<std::size_t>(state.range(0)));
+  nll::graph::ComponentsOptions options;
+  options.num_threads = static_cast<unsigned>(state.range(1));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        nll::graph::ConnectedComponents(graph, options).data());
+  }
+  state.SetItemsProcessed(state.iterations() * graph.NumEdges());
+}
+
+static void BM_DisjointSetUnionEdges(benchmark::State& state) {
+  auto num_vertices = static_cast<std::size_t>(state.range(0));
+  auto edges = nll::bench::UniformRandomEdges(num_vertices, num_vertices);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::graph::DisjointSet<> set(num_vertices);
+    for (const auto& edge : edges) {
+      set.Union(edge.first, edge.second);
+    }
+    benchmark::DoNotOptimize(set.NumSets());
+  }
+  state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+static void BM_ConcurrentDisjointSetUnionAll(benchmark::State& state) {
+  auto num_vertices = static_cast<std::size_t>(state.range(0));
+  auto edges = nll::bench::UniformRandomEdges(num_vertices, num_vertices);
+  auto num_threads = static_cast<unsigned>(state.range(1));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::graph::ConcurrentDisjointSet<> set(num_vertices);
+    set.UnionAll(edges, num_threads);
+    benchmark::DoNotOptimize(set.Find(0));
+  }
+  state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+BENCHMARK(BM_ComponentsSequentialBfs)
+    ->Range(1 << 12, 1 << 20)
+    ->Unit(benchmark::kMillisecond);
+// Args are {vertices, threads}
+BENCHMARK(BM_ComponentsAfforest)
+    ->ArgsProduct({{1 << 12, 1 << 16, 1 << 20}, {1, 2, 4, 8}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_DisjointSetUnionEdges)
+    ->Range(1 << 12, 1 << 20)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ConcurrentDisjointSetUnionAll)
+    ->ArgsProduct({{1 << 12, 1 << 16, 1 << 20}, {1, 2, 4, 8}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,124 @@
+#include "nll/graph/csr_graph.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "graph_generators.hpp"
+#include "scoped_counters.hpp"
+
+namespace {
+
+constexpr std::size_t kAverageDegree = 8;
+
+nll::graph::UnweightedGraph<std::uint32_t> MakeUnweightedGraph(
+    std::size_t num_vertices,
+    const std::vector<std::pair<std::uint32_t, std::uint32_t>>& edges) {
+  nll::graph::UnweightedGraph<std::uint32_t> graph;
+  for (std::uint32_t v = 0; v < num_vertices; v++) {
+    graph.AddNode(v);
+  }
+  for (const auto& edge : edges) {
+    graph.nodes[edge.first]->AddNeighbor(graph.nodes[edge.second].get());
+  }
+  return graph;
+}
+
+/// @brief Approximate heap footprint of an UnweightedGraph, ignoring malloc
+/// headers: one node allocation per vertex plus one adjacency vector each
+std::size_t UnweightedGraphBytes(
+    const nll::graph::UnweightedGraph<std::uint32_t>& graph) {
+  std::size_t bytes = graph.nodes.capacity() * sizeof(graph.nodes[0]);
+  for (const auto& node : graph.nodes) {
+    bytes += sizeof(*node) +
+             node->neighbors.capacity() * sizeof(node->neighbors[0]);
+  }
+  return bytes;
+}
+
+}  // namespace
+
+static void BM_CsrBuildFromEdges(benchmark::State& state) {
+  auto num_vertices = static_cast<std::size_t>(state.range(0));
+  auto edges = nll::bench::UniformRandomEdges(num_vertices,
+                                              num_vertices * kAverageDegree);
+  nll::graph::CsrBuildOptions options;
+  options.symmetrize = true;
+  options.deduplicate = state.range(1) != 0;
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    auto graph =
+        nll::graph::CsrGraph32::FromEdges(edges, num_vertices, options);
+    benchmark::DoNotOptimize(graph.Targets().data());
+  }
+  state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+static void BM_CsrMemoryPerEdge(benchmark::State& state) {
+  auto num_vertices = static_cast<std::size_t>(state.range(0));
+  auto edges = nll::bench::UniformRandomEdges(num_vertices,
+                                              num_vertices * kAverageDegree);
+  nll::graph::CsrBuildOptions options;
+  options.symmetrize = true;
+  auto csr = nll::graph::CsrGraph32::FromEdges(edges, num_vertices, options);
+  auto pointer_graph = MakeUnweightedGraph(num_vertices, edges);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(csr.MemoryBytes());
+  }
+  state.counters["csr_bytes_per_edge"] =
+      static_cast<double>(csr.MemoryBytes()) / csr.NumEdges();
+  state.counters["unweighted_bytes_per_edge"] =
+      static_cast<double>(UnweightedGraphBytes(pointer_graph)) /
+      csr.NumEdges();
+}
+
+static void BM_CsrTraversal(benchmark::State& state) {
+  auto num_vertices = static_cast<std::size_t>(state.range(0));
+  auto edges = nll::bench::UniformRandomEdges(num_vertices,
+                                              num_vertices * kAverageDegree);
+  nll::graph::CsrBuildOptions options;
+  options.symmetrize = true;
+  auto graph = nll::graph::CsrGraph32::FromEdges(edges, num_vertices, options);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::uint64_t sum = 0;
+    for (std::uint32_t v = 0; v < graph.NumVertices(); v++) {
+      for (auto neighbor : graph.Neighbors(v)) {
+        sum += neighbor;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * graph.NumEdges());
+}
+
+static void BM_UnweightedGraphTraversal(benchmark::State& state) {
+  auto num_vertices = static_cast<std::size_t>(state.range(0));
+  auto edges = nll::bench::UniformRandomEdges(num_vertices,
+                                              num_vertices * kAverageDegree);
+  auto graph = MakeUnweightedGraph(num_vertices, edges);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::uint64_t sum = 0;
+    for (const auto& node : graph.nodes) {
+      for (const auto* neighbor : node->neighbors) {
+        sum += neighbor->value;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * edges.size() * 2);
+}
+
+BENCHMARK(BM_CsrBuildFromEdges)
+    ->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 20, 8), {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CsrMemoryPerEdge)->Range(1 << 10, 1 << 18);
+BENCHMARK(BM_CsrTraversal)
+    ->Range(1 << 10, 1 << 20)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_UnweightedGraphTraversal)
+    ->Range(1 << 10, 1 << 20)
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,118 @@
+#include "nll/graph/graph_file.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "graph_generators.hpp"
+#include "scoped_counters.hpp"
+
+namespace {
+
+constexpr std::size_t kAverageDegree = 8;
+
+/// @brief Writes the same random graph as a text edge list and a graph file
+/// once per size, and hands out their paths
+struct GraphFiles {
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+  std::string text_path;
+  std::string binary_path;
+
+  explicit GraphFiles(std::size_t num_vertices) {
+    edges = nll::bench::UniformRandomEdges(num_vertices,
+                                           num_vertices * kAverageDegree);
+    auto directory = std::filesystem::temp_directory_path();
+    auto stem = "nll_bench_graph_" + std::to_string(num_vertices);
+    text_path = (directory / (stem + ".txt")).string();
+    binary_path = (directory / (stem + ".bin")).string();
+    {
+      std::ofstream text(text_path);
+      for (const auto& edge : edges) {
+        text << edge.first << ' ' << edge.second << '\n';
+      }
+    }
+    nll::graph::CsrBuildOptions options;
+    options.symmetrize = true;
+    nll::graph::WriteGraphFile(
+        binary_path,
+        nll::graph::CsrGraph32::FromEdges(edges, num_vertices, options));
+  }
+
+  ~GraphFiles() {
+    std::filesystem::remove(text_path);
+    std::filesystem::remove(binary_path);
+  }
+};
+
+}  // namespace
+
+static void BM_StartupUnweightedGraphAddNeighbor(benchmark::State& state) {
+  auto num_vertices = static_cast<std::size_t>(state.range(0));
+  GraphFiles files(num_vertices);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::graph::UnweightedGraph<std::uint32_t> graph;
+    for (std::uint32_t v = 0; v < num_vertices; v++) {
+      graph.AddNode(v);
+    }
+    for (const auto& edge : files.edges) {
+      graph.nodes[edge.first]->AddNeighbor(graph.nodes[edge.second].get());
+    }
+    benchmark::DoNotOptimize(graph.nodes.data());
+  }
+}
+
+static void BM_StartupCsrFromEdges(benchmark::State& state) {
+  auto num_vertices = static_cast<std::size_t>(state.range(0));
+  GraphFiles files(num_vertices);
+  nll::graph::CsrBuildOptions options;
+  options.symmetrize = true;
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    auto graph =
+        nll::graph::CsrGraph32::FromEdges(files.edges, num_vertices, options);
+    benchmark::DoNotOptimize(graph.Targets().data());
+  }
+}
+
+static void BM_StartupParseTextEdgeList(benchmark::State& state) {
+  GraphFiles files(static_cast<std::size_t>(state.range(0)));
+  nll::graph::CsrBuildOptions options;
+  options.symmetrize = true;
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    auto graph = nll::graph::ReadEdgeListFile<nll::graph::CsrGraph32>(
+        files.text_path, options);
+    benchmark::DoNotOptimize(graph.Targets().data());
+  }
+}
+
+static void BM_StartupMappedGraphFile(benchmark::State& state) {
+  GraphFiles files(static_cast<std::size_t>(state.range(0)));
+  nll::graph::GraphFileOptions options;
+  options.verify_checksums = state.range(1) != 0;
+  options.verify_ids = state.range(1) != 0;
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::graph::MappedGraphFile file(files.binary_path, options);
+    benchmark::DoNotOptimize(file.Graph<std::uint32_t>().NumEdges());
+  }
+}
+
+BENCHMARK(BM_StartupUnweightedGraphAddNeighbor)
+    ->Range(1 << 12, 1 << 20)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StartupCsrFromEdges)
+    ->Range(1 << 12, 1 << 20)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StartupParseTextEdgeList)
+    ->Range(1 << 12, 1 << 20)
+    ->Unit(benchmark::kMillisecond);
+// Args are {vertices, verify checksums and ids}
+BENCHMARK(BM_StartupMappedGraphFile)
+    ->ArgsProduct({benchmark::CreateRange(1 << 12, 1 << 20, 8), {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
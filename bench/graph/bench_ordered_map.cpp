@@ -0,0 +1,177 @@
+#include "nll/graph/ordered_map.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "scoped_counters.hpp"
+
+namespace {
+
+using OrderedMap = nll::binary_tree::OrderedMap<std::uint32_t, std::uint32_t>;
+
+std::vector<std::uint32_t> RandomKeys(std::size_t count) {
+  std::mt19937 rng(42);
+  std::vector<std::uint32_t> keys(count);
+  for (auto& key : keys) {
+    key = rng();
+  }
+  return keys;
+}
+
+std::vector<std::pair<std::uint32_t, std::uint32_t>> SortedEntries(
+    std::size_t count) {
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> entries(count);
+  for (std::uint32_t i = 0; i < count; i++) {
+    entries[i] = {i * 2, i};
+  }
+  return entries;
+}
+
+}  // namespace
+
+static void BM_OrderedMapInsert(benchmark::State& state) {
+  auto keys = RandomKeys(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    OrderedMap map;
+    for (auto key : keys) {
+      map.Insert(key, key);
+    }
+    benchmark::DoNotOptimize(map.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_StdMapInsert(benchmark::State& state) {
+  auto keys = RandomKeys(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::map<std::uint32_t, std::uint32_t> map;
+    for (auto key : keys) {
+      map[key] = key;
+    }
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_OrderedMapFind(benchmark::State& state) {
+  auto keys = RandomKeys(state.range(0));
+  OrderedMap map;
+  for (auto key : keys) {
+    map.Insert(key, key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto key : keys) {
+      benchmark::DoNotOptimize(map.Find(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_StdMapFind(benchmark::State& state) {
+  auto keys = RandomKeys(state.range(0));
+  std::map<std::uint32_t, std::uint32_t> map;
+  for (auto key : keys) {
+    map[key] = key;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto key : keys) {
+      benchmark::DoNotOptimize(map.find(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_OrderedMapLowerBound(benchmark::State& state) {
+  auto map = OrderedMap::FromSorted(SortedEntries(state.range(0)));
+  auto probes = RandomKeys(1 << 12);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto probe : probes) {
+      benchmark::DoNotOptimize(map.LowerBound(probe % (2 * state.range(0))));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+static void BM_StdMapLowerBound(benchmark::State& state) {
+  auto entries = SortedEntries(state.range(0));
+  std::map<std::uint32_t, std::uint32_t> map(entries.begin(), entries.end());
+  auto probes = RandomKeys(1 << 12);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto probe : probes) {
+      benchmark::DoNotOptimize(map.lower_bound(probe % (2 * state.range(0))));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+static void BM_OrderedMapRangeScan(benchmark::State& state) {
+  auto map = OrderedMap::FromSorted(SortedEntries(state.range(0)));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::uint64_t sum = 0;
+    for (auto entry : map) {
+      sum += entry.second;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * map.Size());
+}
+
+static void BM_StdMapRangeScan(benchmark::State& state) {
+  auto entries = SortedEntries(state.range(0));
+  std::map<std::uint32_t, std::uint32_t> map(entries.begin(), entries.end());
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::uint64_t sum = 0;
+    for (const auto& entry : map) {
+      sum += entry.second;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * map.size());
+}
+
+static void BM_OrderedMapFromSorted(benchmark::State& state) {
+  auto entries = SortedEntries(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    auto map = OrderedMap::FromSorted(entries);
+    benchmark::DoNotOptimize(map.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * entries.size());
+}
+
+static void BM_StdMapFromSorted(benchmark::State& state) {
+  auto entries = SortedEntries(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::map<std::uint32_t, std::uint32_t> map(entries.begin(), entries.end());
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * entries.size());
+}
+
+BENCHMARK(BM_OrderedMapInsert)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_StdMapInsert)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_OrderedMapFind)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_StdMapFind)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_OrderedMapLowerBound)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_StdMapLowerBound)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_OrderedMapRangeScan)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_StdMapRangeScan)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_OrderedMapFromSorted)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_StdMapFromSorted)->Range(1 << 10, 1 << 20);
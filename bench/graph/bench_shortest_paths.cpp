@@ -0,0 +1,113 @@
+#include "nll/graph/shortest_paths.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "graph_generators.hpp"
+#include "nll/graph/weighted_csr_graph.hpp"
+#include "scoped_counters.hpp"
+
+namespace {
+
+using IntGraph = nll::graph::WeightedCsrGraph<std::uint32_t>;
+using RealGraph = nll::graph::WeightedCsrGraph<double>;
+
+constexpr int kQueriesPerIteration = 8;
+
+/// @brief Fixed random sources, so every variant answers the same queries
+std::vector<std::uint32_t> QuerySources(std::size_t num_vertices) {
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<std::uint32_t> pick(
+      0, static_cast<std::uint32_t>(num_vertices - 1));
+  std::vector<std::uint32_t> sources(kQueriesPerIteration);
+  for (auto& source : sources) {
+    source = pick(rng);
+  }
+  return sources;
+}
+
+/// @brief Radius giving an average degree of about 8
+double GeometricRadius(std::size_t num_vertices) {
+  return std::sqrt(8.0 / (3.14159 * static_cast<double>(num_vertices)));
+}
+
+template <class TGraph>
+void RunDijkstra(benchmark::State& state, const TGraph& graph) {
+  auto sources = QuerySources(graph.NumVertices());
+  nll::graph::Dijkstra<TGraph> dijkstra(graph);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto source : sources) {
+      dijkstra.Run(source);
+    }
+    benchmark::DoNotOptimize(dijkstra.Distance(0));
+  }
+  state.SetItemsProcessed(state.iterations() * kQueriesPerIteration);
+}
+
+template <class TGraph>
+void RunDeltaStepping(benchmark::State& state, const TGraph& graph,
+                      double delta) {
+  auto sources = QuerySources(graph.NumVertices());
+  nll::graph::DeltaSteppingOptions options;
+  options.num_threads = static_cast<unsigned>(state.range(1));
+  options.delta = delta;
+  nll::graph::DeltaStepping<TGraph> delta_stepping(graph, options);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto source : sources) {
+      delta_stepping.Run(source);
+    }
+    benchmark::DoNotOptimize(delta_stepping.Distance(0));
+  }
+  state.SetItemsProcessed(state.iterations() * kQueriesPerIteration);
+}
+
+}  // namespace
+
+static void BM_DijkstraGrid(benchmark::State& state) {
+  auto graph = nll::bench::GridGraph<IntGraph>(
+      static_cast<std::size_t>(state.range(0)));
+  RunDijkstra(state, graph);
+}
+
+static void BM_DeltaSteppingGrid(benchmark::State& state) {
+  auto graph = nll::bench::GridGraph<IntGraph>(
+      static_cast<std::size_t>(state.range(0)));
+  RunDeltaStepping(state, graph, 100);
+}
+
+static void BM_DijkstraGeometric(benchmark::State& state) {
+  auto num_vertices = static_cast<std::size_t>(state.range(0));
+  auto graph = nll::bench::RandomGeometricGraph<RealGraph>(
+      num_vertices, GeometricRadius(num_vertices));
+  RunDijkstra(state, graph);
+}
+
+static void BM_DeltaSteppingGeometric(benchmark::State& state) {
+  auto num_vertices = static_cast<std::size_t>(state.range(0));
+  auto radius = GeometricRadius(num_vertices);
+  auto graph =
+      nll::bench::RandomGeometricGraph<RealGraph>(num_vertices, radius);
+  RunDeltaStepping(state, graph, radius);
+}
+
+// Grid args are {side, threads}, geometric args are {vertices, threads}
+BENCHMARK(BM_DijkstraGrid)
+    ->ArgsProduct({{64, 256, 1024}, {1}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DeltaSteppingGrid)
+    ->ArgsProduct({{64, 256, 1024}, {1, 2, 4, 8}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_DijkstraGeometric)
+    ->ArgsProduct({{1 << 12, 1 << 16, 1 << 20}, {1}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DeltaSteppingGeometric)
+    ->ArgsProduct({{1 << 12, 1 << 16, 1 << 20}, {1, 2, 4, 8}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
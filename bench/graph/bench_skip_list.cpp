@@ -0,0 +1,151 @@
+#include "nll/graph/skip_list.hpp"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "scoped_counters.hpp"
+
+namespace {
+
+using SkipList = nll::binary_tree::ConcurrentSkipList<std::uint32_t,
+                                                      std::uint32_t>;
+
+/// @brief The baseline: std::map behind one mutex
+class LockedStdMap {
+  std::map<std::uint32_t, std::uint32_t> map;
+  mutable std::mutex mutex;
+
+ public:
+  bool Insert(std::uint32_t key, std::uint32_t value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return map.emplace(key, value).second;
+  }
+
+  bool Contains(std::uint32_t key) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return map.count(key) != 0;
+  }
+
+  template <class TFunction>
+  std::size_t Scan(std::uint32_t from, TFunction&& fn) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t visited = 0;
+    for (auto it = map.lower_bound(from); it != map.end(); ++it) {
+      visited++;
+      if (!fn(it->first, it->second)) {
+        break;
+      }
+    }
+    return visited;
+  }
+};
+
+std::vector<std::uint32_t> RandomKeys(std::size_t count) {
+  std::mt19937 rng(42);
+  std::vector<std::uint32_t> keys(count);
+  for (auto& key : keys) {
+    key = rng();
+  }
+  return keys;
+}
+
+/// @brief Each of state.range(0) threads inserts its own slice of keys
+/// while also looking up keys from the whole range
+template <class TMap>
+void BM_Mixed(benchmark::State& state) {
+  auto num_threads = static_cast<std::size_t>(state.range(0));
+  auto keys = RandomKeys(1 << 18);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    TMap map;
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t] {
+        for (auto i = t; i < keys.size(); i += num_threads) {
+          map.Insert(keys[i], keys[i]);
+          benchmark::DoNotOptimize(map.Contains(keys[i / 2]));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size() * 2);
+}
+
+/// @brief Half of state.range(0) threads insert their slice of keys while
+/// the other half keep scanning 64 entries from random keys, like an index
+/// being filled while queried. Items are the inserts and scanned entries.
+template <class TMap>
+void BM_InsertWhileScanning(benchmark::State& state) {
+  auto num_threads = static_cast<std::size_t>(state.range(0));
+  auto writers = num_threads / 2;
+  auto keys = RandomKeys(1 << 18);
+  std::int64_t scanned = 0;
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    TMap map;
+    std::atomic<std::size_t> writers_left{writers};
+    std::atomic<std::int64_t> entries{0};
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t] {
+        if (t < writers) {
+          for (auto i = t; i < keys.size(); i += writers) {
+            map.Insert(keys[i], keys[i]);
+          }
+          writers_left.fetch_sub(1);
+          return;
+        }
+        std::mt19937 random(static_cast<unsigned>(t));
+        std::int64_t local = 0;
+        while (writers_left.load(std::memory_order_relaxed) > 0) {
+          local += map.Scan(random(), [n = 0](std::uint32_t,
+                                              std::uint32_t) mutable {
+            return ++n < 64;
+          });
+        }
+        entries.fetch_add(local);
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    scanned += entries.load();
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size() + scanned);
+  state.counters["scanned"] = benchmark::Counter(
+      static_cast<double>(scanned), benchmark::Counter::kIsRate);
+}
+
+void ThreadCounts(benchmark::internal::Benchmark* benchmark) {
+  benchmark->RangeMultiplier(2)
+      ->Range(1, 16)
+      ->ArgName("threads")
+      ->UseRealTime()
+      ->Unit(benchmark::kMillisecond);
+}
+
+void ScanningThreadCounts(benchmark::internal::Benchmark* benchmark) {
+  benchmark->RangeMultiplier(2)
+      ->Range(2, 16)
+      ->ArgName("threads")
+      ->UseRealTime()
+      ->Unit(benchmark::kMillisecond);
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_Mixed, SkipList)->Apply(ThreadCounts);
+BENCHMARK_TEMPLATE(BM_Mixed, LockedStdMap)->Apply(ThreadCounts);
+BENCHMARK_TEMPLATE(BM_InsertWhileScanning, SkipList)
+    ->Apply(ScanningThreadCounts);
+BENCHMARK_TEMPLATE(BM_InsertWhileScanning, LockedStdMap)
+    ->Apply(ScanningThreadCounts);
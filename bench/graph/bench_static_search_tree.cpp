@@ -0,0 +1,84 @@
+#include "nll/graph/static_search_tree.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "scoped_counters.hpp"
+
+namespace {
+
+constexpr std::size_t kNumProbes = 1 << 14;
+
+std::vector<std::uint32_t> SortedKeys(std::size_t count) {
+  std::vector<std::uint32_t> keys(count);
+  for (std::uint32_t i = 0; i < count; i++) {
+    keys[i] = i * 2;
+  }
+  return keys;
+}
+
+std::vector<std::uint32_t> Probes(std::size_t count) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<std::uint32_t> distribution(
+      0, static_cast<std::uint32_t>(2 * count));
+  std::vector<std::uint32_t> probes(kNumProbes);
+  for (auto& probe : probes) {
+    probe = distribution(rng);
+  }
+  return probes;
+}
+
+void SearchTree(benchmark::State& state,
+                nll::binary_tree::SearchTreeLayout layout) {
+  auto keys = SortedKeys(state.range(0));
+  nll::binary_tree::StaticSearchTree<std::uint32_t> tree(keys.begin(),
+                                                         keys.end(), layout);
+  auto probes = Probes(keys.size());
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::size_t sum = 0;
+    for (auto probe : probes) {
+      sum += tree.LowerBound(probe);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * probes.size());
+  state.counters["bytes"] = static_cast<double>(tree.MemoryBytes());
+}
+
+}  // namespace
+
+static void BM_StdLowerBound(benchmark::State& state) {
+  auto keys = SortedKeys(state.range(0));
+  auto probes = Probes(keys.size());
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    std::size_t sum = 0;
+    for (auto probe : probes) {
+      sum += std::lower_bound(keys.begin(), keys.end(), probe) - keys.begin();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * probes.size());
+  state.counters["bytes"] =
+      static_cast<double>(keys.size() * sizeof(keys[0]));
+}
+
+static void BM_EytzingerLowerBound(benchmark::State& state) {
+  SearchTree(state, nll::binary_tree::SearchTreeLayout::kEytzinger);
+}
+
+static void BM_VanEmdeBoasLowerBound(benchmark::State& state) {
+  SearchTree(state, nll::binary_tree::SearchTreeLayout::kVanEmdeBoas);
+}
+
+// 4 KiB of keys fits in L1, 64 MiB is well past any last level cache
+BENCHMARK(BM_StdLowerBound)->RangeMultiplier(4)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_EytzingerLowerBound)->RangeMultiplier(4)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_VanEmdeBoasLowerBound)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 24);
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "nll/graph/csr_graph.hpp"
+
+namespace nll {
+namespace bench {
+
+/// @brief Generates num_edges uniformly random directed edges
+template <class TVertex = std::uint32_t>
+std::vector<std::pair<TVertex, TVertex>> UniformRandomEdges(
+    std::size_t num_vertices, std::size_t num_edges, unsigned seed = 42) {
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<std::uint64_t> pick(0, num_vertices - 1);
+  std::vector<std::pair<TVertex, TVertex>> edges(num_edges);
+  for (auto& edge : edges) {
+    edge = {static_cast<TVertex>(pick(rng)), static_cast<TVertex>(pick(rng))};
+  }
+  return edges;
+}
+
+/// @brief Generates a Graph500 style RMAT/Kronecker edge list with
+/// 2^scale vertices and edge_factor * 2^scale edges. Vertex ids are
+/// permuted so high degree vertices are not clustered at low ids.
+template <class TVertex = std::uint32_t>
+std::vector<std::pair<TVertex, TVertex>> RmatEdges(unsigned scale,
+                                                   std::size_t edge_factor,
+                                                   unsigned seed = 42) {
+  constexpr double kA = 0.57;
+  constexpr double kB = 0.19;
+  constexpr double kC = 0.19;
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> coin(0.0, 1.0);
+  std::size_t num_vertices = std::size_t{1} << scale;
+  std::vector<std::pair<TVertex, TVertex>> edges(num_vertices * edge_factor);
+  for (auto& edge : edges) {
+    std::uint64_t src = 0;
+    std::uint64_t dst = 0;
+    for (unsigned level = 0; level < scale; level++) {
+      auto r = coin(rng);
+      src <<= 1;
+      dst <<= 1;
+      // Quadrants in order a (top left), b, c, d (bottom right)
+      if (r >= kA + kB) {
+        src |= 1;
+      }
+      if ((r >= kA && r < kA + kB) || r >= kA + kB + kC) {
+        dst |= 1;
+      }
+    }
+    edge = {static_cast<TVertex>(src), static_cast<TVertex>(dst)};
+  }
+  std::vector<TVertex> permutation(num_vertices);
+  for (std::size_t v = 0; v < num_vertices; v++) {
+    permutation[v] = static_cast<TVertex>(v);
+  }
+  std::shuffle(permutation.begin(), permutation.end(), rng);
+  for (auto& edge : edges) {
+    edge = {permutation[edge.first], permutation[edge.second]};
+  }
+  return edges;
+}
+
+/// @brief Generates a side x side 4-connected grid with integer weights in
+/// [1, max_weight], a rough stand-in for a road network
+template <class TGraph>
+TGraph GridGraph(std::size_t side, typename TGraph::Weight max_weight = 100,
+                 unsigned seed = 42) {
+  using TVertex = typename TGraph::VertexId;
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<std::uint64_t> weight(1, max_weight);
+  std::vector<typename TGraph::Edge> edges;
+  edges.reserve(side * side * 2);
+  for (std::size_t row = 0; row < side; row++) {
+    for (std::size_t col = 0; col < side; col++) {
+      auto v = static_cast<TVertex>(row * side + col);
+      if (col + 1 < side) {
+        edges.push_back({v, static_cast<TVertex>(v + 1),
+                         static_cast<typename TGraph::Weight>(weight(rng))});
+      }
+      if (row + 1 < side) {
+        edges.push_back({v, static_cast<TVertex>(v + side),
+                         static_cast<typename TGraph::Weight>(weight(rng))});
+      }
+    }
+  }
+  nll::graph::CsrBuildOptions options;
+  options.symmetrize = true;
+  return TGraph::FromEdges(edges, side * side, options);
+}
+
+/// @brief Generates a random geometric graph: points uniform in the unit
+/// square, connected when closer than radius, weighted by distance. Uses a
+/// cell grid of width radius so only neighboring cells are compared.
+template <class TGraph>
+TGraph RandomGeometricGraph(std::size_t num_vertices, double radius,
+                            unsigned seed = 42) {
+  using TVertex = typename TGraph::VertexId;
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> coordinate(0.0, 1.0);
+  std::vector<std::pair<double, double>> points(num_vertices);
+  for (auto& point : points) {
+    point = {coordinate(rng), coordinate(rng)};
+  }
+  auto cells_per_side =
+      std::max<std::size_t>(1, static_cast<std::size_t>(1.0 / radius));
+  auto cell_of = [&](double x) {
+    return std::min(cells_per_side - 1,
+                    static_cast<std::size_t>(x * cells_per_side));
+  };
+  std::vector<std::vector<TVertex>> cells(cells_per_side * cells_per_side);
+  for (std::size_t v = 0; v < num_vertices; v++) {
+    cells[cell_of(points[v].second) * cells_per_side +
+          cell_of(points[v].first)]
+        .push_back(static_cast<TVertex>(v));
+  }
+  std::vector<typename TGraph::Edge> edges;
+  for (std::size_t u = 0; u < num_vertices; u++) {
+    auto cx = cell_of(points[u].first);
+    auto cy = cell_of(points[u].second);
+    for (auto y = cy == 0 ? 0 : cy - 1;
+         y <= std::min(cy + 1, cells_per_side - 1); y++) {
+      for (auto x = cx == 0 ? 0 : cx - 1;
+           x <= std::min(cx + 1, cells_per_side - 1); x++) {
+        for (auto v : cells[y * cells_per_side + x]) {
+          auto dx = points[u].first - points[v].first;
+          auto dy = points[u].second - points[v].second;
+          auto distance = std::sqrt(dx * dx + dy * dy);
+          if (u < v && distance < radius) {
+            edges.push_back({static_cast<TVertex>(u), v,
+                             static_cast<typename TGraph::Weight>(distance)});
+          }
+        }
+      }
+    }
+  }
+  nll::graph::CsrBuildOptions options;
+  options.symmetrize = true;
+  return TGraph::FromEdges(edges, num_vertices, options);
+}
+
+}  // namespace bench
+}  // namespace nll
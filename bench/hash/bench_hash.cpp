@@ -0,0 +1,269 @@
+#include "nll/hash/hasher.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "nll/collections/hashmap.hpp"
+#include "nll/hash/hash_bytes.hpp"
+#include "nll/hash/mix.hpp"
+#include "scoped_counters.hpp"
+
+namespace {
+
+/// @brief Integer key patterns that defeat a weak hash or a modulo by a
+/// power of two
+enum class Pattern { kSequential, kStrided, kBitReversed, kRandom };
+
+std::uint64_t ReverseBits(std::uint64_t value) {
+  std::uint64_t reversed = 0;
+  for (int bit = 0; bit < 64; bit++) {
+    reversed = (reversed << 1) | ((value >> bit) & 1);
+  }
+  return reversed;
+}
+
+std::vector<std::uint64_t> KeysOf(Pattern pattern, std::size_t count) {
+  std::vector<std::uint64_t> keys(count);
+  std::mt19937_64 random(42);
+  for (std::size_t i = 0; i < count; i++) {
+    switch (pattern) {
+      case Pattern::kSequential:
+        keys[i] = i;
+        break;
+      case Pattern::kStrided:
+        // Same low 20 bits, like page-aligned addresses
+        keys[i] = static_cast<std::uint64_t>(i) << 20;
+        break;
+      case Pattern::kBitReversed:
+        // Only the high bits vary
+        keys[i] = ReverseBits(i);
+        break;
+      case Pattern::kRandom:
+        keys[i] = random();
+        break;
+    }
+  }
+  return keys;
+}
+
+/// @brief URL-like strings sharing a long prefix and differing in a few
+/// digits near the end
+std::vector<std::string> SharedPrefixKeys(std::size_t count) {
+  std::vector<std::string> keys(count);
+  for (std::size_t i = 0; i < count; i++) {
+    keys[i] = "https://example.com/api/v2/users/" + std::to_string(i) +
+              "/profile";
+  }
+  return keys;
+}
+
+/// @brief Bucket chain statistics of a filled map: the longest chain and
+/// the mean number of keys compared by a successful lookup
+template <class TMap>
+void ReportChains(benchmark::State& state, const TMap& map) {
+  auto histogram = map.ChainLengths();
+  double probes = 0;
+  for (std::size_t k = 0; k < histogram.size(); k++) {
+    probes += static_cast<double>(histogram[k]) * k * (k + 1) / 2;
+  }
+  state.counters["max_chain"] = static_cast<double>(histogram.size() - 1);
+  state.counters["probes_per_get"] = probes / map.Size();
+}
+
+template <class THash>
+using MapWith =
+    nll::Hashmap<std::uint64_t, std::uint64_t, nll::DefaultHashmapPolicy,
+                 std::allocator<std::pair<std::uint64_t, std::uint64_t>>,
+                 THash>;
+
+/// @brief Get of every key of pattern state.range(1) from a map of
+/// state.range(0) keys hashed with THash
+template <class THash>
+void BM_HashmapGetPattern(benchmark::State& state) {
+  auto keys = KeysOf(static_cast<Pattern>(state.range(1)),
+                     static_cast<std::size_t>(state.range(0)));
+  MapWith<THash> map;
+  for (auto key : keys) {
+    map.Insert(key, key);
+  }
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto key : keys) {
+      benchmark::DoNotOptimize(map.Get(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+  ReportChains(state, map);
+}
+
+/// @brief The reference: prime bucket counts and a modulo
+void BM_StdUnorderedMapAtPattern(benchmark::State& state) {
+  auto keys = KeysOf(static_cast<Pattern>(state.range(1)),
+                     static_cast<std::size_t>(state.range(0)));
+  std::unordered_map<std::uint64_t, std::uint64_t> map;
+  for (auto key : keys) {
+    map.emplace(key, key);
+  }
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto key : keys) {
+      benchmark::DoNotOptimize(map.at(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+/// @brief Get of shared-prefix strings from a map hashing them with THash
+template <class THash>
+void BM_HashmapGetSharedPrefix(benchmark::State& state) {
+  auto keys = SharedPrefixKeys(static_cast<std::size_t>(state.range(0)));
+  nll::Hashmap<std::string, std::size_t, nll::DefaultHashmapPolicy,
+               std::allocator<std::pair<std::string, std::size_t>>, THash>
+      map;
+  for (std::size_t i = 0; i < keys.size(); i++) {
+    map.Insert(keys[i], i);
+  }
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (const auto& key : keys) {
+      benchmark::DoNotOptimize(map.Get(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+  ReportChains(state, map);
+}
+
+/// @brief Raw string hashing throughput for inputs of state.range(0) bytes
+template <class THash>
+void BM_HashString(benchmark::State& state) {
+  std::string input(static_cast<std::size_t>(state.range(0)), 'k');
+  THash hasher;
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(input.data());
+    benchmark::DoNotOptimize(hasher(std::string_view(input)));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+/// @brief Hashes 4096 integer keys one at a time
+void BM_HashIntegers(benchmark::State& state) {
+  auto keys = KeysOf(Pattern::kRandom, 4096);
+  std::vector<std::uint64_t> hashes(keys.size());
+  nll::hash::Hasher<std::uint64_t> hasher;
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < keys.size(); i++) {
+      hashes[i] = hasher(keys[i]);
+    }
+    benchmark::DoNotOptimize(hashes.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+/// @brief Hashes the same keys with HashBatch, four per AVX2 instruction
+/// when built with -mavx2
+void BM_HashIntegersBatch(benchmark::State& state) {
+  auto keys = KeysOf(Pattern::kRandom, 4096);
+  std::vector<std::uint64_t> hashes(keys.size());
+  nll::hash::Hasher<std::uint64_t> hasher;
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::hash::HashBatch(hasher, keys.data(), keys.size(), hashes.data());
+    benchmark::DoNotOptimize(hashes.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+/// @brief Looks up random keys of a map of state.range(0) entries one
+/// Find at a time, each waiting on its own cache misses
+void BM_HashmapFind(benchmark::State& state) {
+  auto keys = KeysOf(Pattern::kRandom, static_cast<std::size_t>(
+                                           state.range(0)));
+  MapWith<nll::hash::Hasher<std::uint64_t>> map;
+  for (auto key : keys) {
+    map.Insert(key, key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (auto key : keys) {
+      benchmark::DoNotOptimize(map.Find(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+/// @brief The same lookups through FindBatch, which overlaps the misses
+void BM_HashmapFindBatch(benchmark::State& state) {
+  auto keys = KeysOf(Pattern::kRandom, static_cast<std::size_t>(
+                                           state.range(0)));
+  MapWith<nll::hash::Hasher<std::uint64_t>> map;
+  for (auto key : keys) {
+    map.Insert(key, key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+  std::vector<std::uint64_t*> values(keys.size());
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    map.FindBatch(keys.data(), keys.size(), values.data());
+    benchmark::DoNotOptimize(values.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+void SizesAndKeyPatterns(benchmark::internal::Benchmark* benchmark) {
+  benchmark
+      ->ArgsProduct({{1 << 12, 1 << 18},
+                     {static_cast<std::int64_t>(Pattern::kSequential),
+                      static_cast<std::int64_t>(Pattern::kStrided),
+                      static_cast<std::int64_t>(Pattern::kBitReversed),
+                      static_cast<std::int64_t>(Pattern::kRandom)}})
+      ->ArgNames({"size", "pattern"});
+}
+
+void StringSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->Arg(1 << 12)->Arg(1 << 18)->ArgName("size");
+}
+
+void InputLengths(benchmark::internal::Benchmark* benchmark) {
+  benchmark->RangeMultiplier(4)->Range(4, 4096)->ArgName("bytes");
+}
+
+void LookupSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->RangeMultiplier(16)->Range(1 << 12, 1 << 22)->ArgName("size");
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_HashmapGetPattern, nll::hash::Hasher<std::uint64_t>)
+    ->Apply(SizesAndKeyPatterns);
+BENCHMARK_TEMPLATE(BM_HashmapGetPattern, std::hash<std::uint64_t>)
+    ->Apply(SizesAndKeyPatterns);
+BENCHMARK(BM_StdUnorderedMapAtPattern)->Apply(SizesAndKeyPatterns);
+BENCHMARK_TEMPLATE(BM_HashmapGetSharedPrefix,
+                   nll::hash::Hasher<std::string_view>)
+    ->Apply(StringSizes);
+BENCHMARK_TEMPLATE(BM_HashmapGetSharedPrefix, std::hash<std::string>)
+    ->Apply(StringSizes);
+BENCHMARK_TEMPLATE(BM_HashString, nll::hash::Hasher<std::string_view>)
+    ->Apply(InputLengths);
+BENCHMARK_TEMPLATE(BM_HashString, std::hash<std::string_view>)
+    ->Apply(InputLengths);
+BENCHMARK(BM_HashIntegers);
+BENCHMARK(BM_HashIntegersBatch);
+BENCHMARK(BM_HashmapFind)->Apply(LookupSizes);
+BENCHMARK(BM_HashmapFindBatch)->Apply(LookupSizes);
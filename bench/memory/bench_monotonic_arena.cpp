@@ -0,0 +1,130 @@
+#include "nll/memory/monotonic_arena.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "nll/collections/hashmap.hpp"
+#include "nll/collections/linked_list.hpp"
+#include "nll/collections/set.hpp"
+#include "nll/collections/stack.hpp"
+#include "scoped_counters.hpp"
+
+using nll::bench::kMinSize;
+
+namespace {
+
+/// @brief Most fields a simulated request carries
+constexpr std::int64_t kMaxFields = 1 << 12;
+
+std::vector<std::string> RequestFields(std::size_t count) {
+  std::vector<std::string> fields;
+  for (auto key : nll::bench::ShuffledKeys(count)) {
+    // Longer than the small string buffer, so every copy allocates
+    fields.push_back("x-request-field-" + std::to_string(key));
+  }
+  return fields;
+}
+
+template <class TAllocator, class T>
+using Rebind =
+    typename std::allocator_traits<TAllocator>::template rebind_alloc<T>;
+
+/// @brief Handles one request: indexes its fields by name, keeps them in
+/// arrival order, stacks their positions and dedupes them, then drops it
+/// all. Every container and string draws from allocator.
+template <class TAllocator>
+std::size_t HandleRequest(const std::vector<std::string>& fields,
+                          const TAllocator& allocator) {
+  using String =
+      std::basic_string<char, std::char_traits<char>, Rebind<TAllocator, char>>;
+  using Entry = std::pair<String, std::size_t>;
+  nll::Hashmap<String, std::size_t, nll::DefaultHashmapPolicy,
+               Rebind<TAllocator, Entry>>
+      positions(allocator);
+  nll::SinglyLinkedList<String, Rebind<TAllocator, String>> order(allocator);
+  nll::Stack<std::size_t, Rebind<TAllocator, std::size_t>> pending(allocator);
+  nll::BasicSet<TAllocator> seen(allocator);
+  for (std::size_t i = 0; i < fields.size(); i++) {
+    String name(fields[i].data(), fields[i].size(), allocator);
+    // A plain copy would take the default resource, as pmr copies do
+    positions.Insert(String(name, allocator), i);
+    order.PushBack(std::move(name));
+    pending.Push(i);
+    seen.Add(fields[i]);
+  }
+  return positions.Size() + order.Size() + pending.Size();
+}
+
+}  // namespace
+
+static void BM_RequestDefaultHeap(benchmark::State& state) {
+  auto fields = RequestFields(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        HandleRequest(fields, std::allocator<char>()));
+  }
+  state.SetItemsProcessed(state.iterations() * fields.size());
+}
+
+/// @brief pmr containers on the heap, to separate the cost of virtual
+/// allocation calls from the gain of the arena
+static void BM_RequestPmrNewDelete(benchmark::State& state) {
+  auto fields = RequestFields(state.range(0));
+  std::pmr::polymorphic_allocator<char> allocator(
+      std::pmr::new_delete_resource());
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(HandleRequest(fields, allocator));
+  }
+  state.SetItemsProcessed(state.iterations() * fields.size());
+}
+
+static void BM_RequestMonotonicArena(benchmark::State& state) {
+  auto fields = RequestFields(state.range(0));
+  nll::memory::MonotonicArena arena;
+  std::pmr::polymorphic_allocator<char> allocator(&arena);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(HandleRequest(fields, allocator));
+    arena.Reset();
+  }
+  state.SetItemsProcessed(state.iterations() * fields.size());
+  state.counters["arena_bytes"] = static_cast<double>(arena.BytesReserved());
+}
+
+static void BM_RequestStdMonotonicBuffer(benchmark::State& state) {
+  auto fields = RequestFields(state.range(0));
+  std::pmr::monotonic_buffer_resource arena;
+  std::pmr::polymorphic_allocator<char> allocator(&arena);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(HandleRequest(fields, allocator));
+    arena.release();
+  }
+  state.SetItemsProcessed(state.iterations() * fields.size());
+}
+
+BENCHMARK(BM_RequestDefaultHeap)
+    ->RangeMultiplier(8)
+    ->Range(kMinSize, kMaxFields)
+    ->ArgName("fields");
+BENCHMARK(BM_RequestPmrNewDelete)
+    ->RangeMultiplier(8)
+    ->Range(kMinSize, kMaxFields)
+    ->ArgName("fields");
+BENCHMARK(BM_RequestMonotonicArena)
+    ->RangeMultiplier(8)
+    ->Range(kMinSize, kMaxFields)
+    ->ArgName("fields");
+BENCHMARK(BM_RequestStdMonotonicBuffer)
+    ->RangeMultiplier(8)
+    ->Range(kMinSize, kMaxFields)
+    ->ArgName("fields");
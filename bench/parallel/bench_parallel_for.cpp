@@ -0,0 +1,135 @@
+#include "nll/parallel/parallel_for.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "scoped_counters.hpp"
+
+namespace {
+
+/// @brief Elements of the fine grained loops
+constexpr std::int64_t kElements = 1 << 20;
+/// @brief Chunks of the coarse grained loop, each kCoarseWork iterations
+constexpr std::int64_t kCoarseChunks = 64;
+constexpr std::int64_t kCoarseWork = 1 << 14;
+
+/// @brief Pool with the given number of workers, kept across benchmarks so
+/// starting threads is not measured
+nll::parallel::ThreadPool& PoolWith(std::int64_t threads) {
+  static std::map<std::int64_t, std::unique_ptr<nll::parallel::ThreadPool>>
+      pools;
+  auto& pool = pools[threads];
+  if (!pool) {
+    nll::parallel::ThreadPoolOptions options;
+    options.threads = static_cast<std::size_t>(threads);
+    pool = std::make_unique<nll::parallel::ThreadPool>(options);
+  }
+  return *pool;
+}
+
+/// @brief A few nanoseconds of arithmetic standing in for a loop body
+double Work(std::int64_t i) { return std::sqrt(static_cast<double>(i) + 1); }
+
+void ThreadsAndGrains(benchmark::internal::Benchmark* benchmark) {
+  benchmark
+      ->ArgsProduct({{1, 2, 4, 8}, {0, 64, 1024, 16384}})
+      ->ArgNames({"threads", "grain"})
+      ->UseRealTime();
+}
+
+void Threads(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgsProduct({{1, 2, 4, 8}})->ArgNames({"threads"})->UseRealTime();
+}
+
+}  // namespace
+
+/// @brief Baseline for the fine grained loops
+static void BM_SerialFor(benchmark::State& state) {
+  std::vector<double> out(kElements);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    for (std::int64_t i = 0; i < kElements; i++) {
+      out[i] = Work(i);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+BENCHMARK(BM_SerialFor);
+
+/// @brief Nanoseconds of work per index, where the grain decides whether
+/// scheduling or the work dominates
+static void BM_ParallelForFine(benchmark::State& state) {
+  auto& pool = PoolWith(state.range(0));
+  auto grain = static_cast<std::size_t>(state.range(1));
+  std::vector<double> out(kElements);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::parallel::ParallelFor(
+        std::int64_t{0}, kElements, [&](std::int64_t i) { out[i] = Work(i); },
+        grain, pool);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+BENCHMARK(BM_ParallelForFine)->Apply(ThreadsAndGrains);
+
+/// @brief Few long iterations, which only scale if every worker gets some
+static void BM_ParallelForCoarse(benchmark::State& state) {
+  auto& pool = PoolWith(state.range(0));
+  std::vector<double> out(kCoarseChunks);
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::parallel::ParallelFor(
+        std::int64_t{0}, kCoarseChunks,
+        [&](std::int64_t chunk) {
+          double sum = 0;
+          for (std::int64_t i = 0; i < kCoarseWork; i++) {
+            sum += Work(chunk * kCoarseWork + i);
+          }
+          out[chunk] = sum;
+        },
+        1, pool);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kCoarseChunks * kCoarseWork);
+}
+BENCHMARK(BM_ParallelForCoarse)->Apply(Threads);
+
+static void BM_ParallelReduceSum(benchmark::State& state) {
+  auto& pool = PoolWith(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    auto sum = nll::parallel::ParallelReduce(
+        std::int64_t{0}, kElements, 0.0, Work,
+        [](double a, double b) { return a + b; }, 0, pool);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+BENCHMARK(BM_ParallelReduceSum)->Apply(Threads);
+
+/// @brief Cost of spawning, running and joining one empty task, the
+/// scheduling overhead every grain choice pays per chunk
+static void BM_TaskGroupSpawnOverhead(benchmark::State& state) {
+  constexpr int kTasks = 1024;
+  auto& pool = PoolWith(state.range(0));
+  std::atomic<int> ran{0};
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    nll::parallel::TaskGroup group(pool);
+    for (int i = 0; i < kTasks; i++) {
+      group.Run([&ran] { ran.fetch_add(1, std::memory_order_relaxed); });
+    }
+    group.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * kTasks);
+}
+BENCHMARK(BM_TaskGroupSpawnOverhead)->Apply(Threads);
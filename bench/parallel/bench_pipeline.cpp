@@ -0,0 +1,235 @@
+#include "nll/parallel/pipeline.hpp"
+
+#include <array>
+#include <charconv>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "scoped_counters.hpp"
+
+namespace {
+
+/// @brief Lines streamed through every pipeline, "user<k>,<value>"
+constexpr std::size_t kLines = 1 << 18;
+constexpr std::size_t kUsers = 64;
+
+struct Record {
+  std::uint32_t user;
+  std::int64_t value;
+};
+
+/// @brief Per user sums, the aggregate stage's output
+using Totals = std::array<std::int64_t, kUsers>;
+
+const std::vector<std::string>& Lines() {
+  static const auto lines = [] {
+    std::vector<std::string> lines;
+    for (std::size_t i = 0; i < kLines; i++) {
+      lines.push_back("user" + std::to_string(i % kUsers) + "," +
+                      std::to_string(i * 7919 % 100003));
+    }
+    return lines;
+  }();
+  return lines;
+}
+
+Record Parse(std::string_view line) {
+  auto comma = line.find(',');
+  Record record{};
+  std::from_chars(line.data() + 4, line.data() + comma, record.user);
+  std::from_chars(line.data() + comma + 1, line.data() + line.size(),
+                  record.value);
+  return record;
+}
+
+bool Keep(const Record& record) { return record.value % 3 != 0; }
+
+/// @brief The baseline: all three stages in one loop
+void BM_HandWrittenLoop(benchmark::State& state) {
+  const auto& lines = Lines();
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    Totals totals{};
+    for (const auto& line : lines) {
+      auto record = Parse(line);
+      if (Keep(record)) {
+        totals[record.user] += record.value;
+      }
+    }
+    benchmark::DoNotOptimize(totals);
+  }
+  state.SetItemsProcessed(state.iterations() * kLines);
+}
+
+nll::parallel::Generator<Record> ParseAll(
+    const std::vector<std::string>& lines) {
+  for (const auto& line : lines) {
+    co_yield Parse(line);
+  }
+}
+
+nll::parallel::Generator<Record> KeepAll(
+    nll::parallel::Generator<Record> records) {
+  for (auto& record : records) {
+    if (Keep(record)) {
+      co_yield record;
+    }
+  }
+}
+
+/// @brief Stages as nested generators: fused, one item at a time
+void BM_GeneratorChain(benchmark::State& state) {
+  const auto& lines = Lines();
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    Totals totals{};
+    for (auto& record : KeepAll(ParseAll(lines))) {
+      totals[record.user] += record.value;
+    }
+    benchmark::DoNotOptimize(totals);
+  }
+  state.SetItemsProcessed(state.iterations() * kLines);
+}
+
+using RecordChannel = nll::parallel::Channel<Record>;
+
+nll::parallel::Stage ParseStage(const std::vector<std::string>& lines,
+                                RecordChannel& out, std::size_t batch) {
+  nll::parallel::BatchWriter<Record> writer(out, batch);
+  for (const auto& line : lines) {
+    co_await writer.Push(Parse(line));
+  }
+  co_await writer.Flush();
+  out.Close();
+}
+
+nll::parallel::Stage FilterStage(RecordChannel& in, RecordChannel& out) {
+  while (auto batch = co_await in.Receive()) {
+    std::erase_if(*batch, [](const Record& record) { return !Keep(record); });
+    co_await out.Send(std::move(*batch));
+  }
+  out.Close();
+}
+
+nll::parallel::Stage AggregateStage(RecordChannel& in, Totals& totals) {
+  while (auto batch = co_await in.Receive()) {
+    for (const auto& record : *batch) {
+      totals[record.user] += record.value;
+    }
+  }
+}
+
+/// @brief Parse, filter and aggregate stages over channels, moving
+/// state.range(0) items per batch
+template <nll::parallel::PipelineMode kMode>
+void BM_Pipeline(benchmark::State& state) {
+  const auto& lines = Lines();
+  auto batch = static_cast<std::size_t>(state.range(0));
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    Totals totals{};
+    nll::parallel::Pipeline pipeline(kMode);
+    auto& parsed = pipeline.MakeChannel<Record>();
+    auto& kept = pipeline.MakeChannel<Record>();
+    pipeline.Add(ParseStage(lines, parsed, batch));
+    pipeline.Add(FilterStage(parsed, kept));
+    pipeline.Add(AggregateStage(kept, totals));
+    pipeline.Run();
+    benchmark::DoNotOptimize(totals);
+  }
+  state.SetItemsProcessed(state.iterations() * kLines);
+}
+
+/// @brief The usual hand-wired stage link: a bounded queue taking a lock
+/// per item, with nothing meaning end of stream
+template <class T>
+class BlockingQueue {
+ public:
+  void Push(std::optional<T> item) {
+    std::unique_lock lock(mutex);
+    not_full.wait(lock, [&] { return items.size() < kCapacity; });
+    items.push(std::move(item));
+    not_empty.notify_one();
+  }
+
+  std::optional<T> Pop() {
+    std::unique_lock lock(mutex);
+    not_empty.wait(lock, [&] { return !items.empty(); });
+    auto item = std::move(items.front());
+    items.pop();
+    not_full.notify_one();
+    return item;
+  }
+
+ private:
+  static constexpr std::size_t kCapacity = 1024;
+
+  std::mutex mutex;
+  std::condition_variable not_full;
+  std::condition_variable not_empty;
+  std::queue<std::optional<T>> items;
+};
+
+/// @brief A thread per stage and a queue between stages, item by item
+void BM_QueuePerStage(benchmark::State& state) {
+  const auto& lines = Lines();
+  nll::bench::ScopedCounters counters(state);
+  for (auto _ : state) {
+    Totals totals{};
+    BlockingQueue<Record> parsed;
+    BlockingQueue<Record> kept;
+    std::thread parse([&] {
+      for (const auto& line : lines) {
+        parsed.Push(Parse(line));
+      }
+      parsed.Push(std::nullopt);
+    });
+    std::thread filter([&] {
+      while (auto record = parsed.Pop()) {
+        if (Keep(*record)) {
+          kept.Push(record);
+        }
+      }
+      kept.Push(std::nullopt);
+    });
+    while (auto record = kept.Pop()) {
+      totals[record->user] += record->value;
+    }
+    parse.join();
+    filter.join();
+    benchmark::DoNotOptimize(totals);
+  }
+  state.SetItemsProcessed(state.iterations() * kLines);
+}
+
+void BatchSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->RangeMultiplier(8)
+      ->Range(8, 4096)
+      ->ArgName("batch")
+      ->UseRealTime()
+      ->Unit(benchmark::kMillisecond);
+}
+
+void EndToEnd(benchmark::internal::Benchmark* benchmark) {
+  benchmark->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+
+}  // namespace
+
+BENCHMARK(BM_HandWrittenLoop)->Apply(EndToEnd);
+BENCHMARK(BM_GeneratorChain)->Apply(EndToEnd);
+BENCHMARK_TEMPLATE(BM_Pipeline, nll::parallel::PipelineMode::kFused)
+    ->Apply(BatchSizes);
+BENCHMARK_TEMPLATE(BM_Pipeline, nll::parallel::PipelineMode::kThreaded)
+    ->Apply(BatchSizes);
+BENCHMARK(BM_QueuePerStage)->Apply(EndToEnd);
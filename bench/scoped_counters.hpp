@@ -0,0 +1,70 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include "nll/instrumentation/allocation_tracker.hpp"
+#include "nll/instrumentation/perf_counters.hpp"
+
+namespace nll {
+namespace bench {
+
+/// @brief Measures the rest of the enclosing scope, meant to be declared
+/// right before the benchmark loop, and reports per iteration user counters
+/// when it goes out of scope:
+///   allocs_per_op, alloc_bytes_per_op   from the allocation hooks
+///   cycles_per_op, cache_misses_per_op,
+///   branch_misses_per_op, ipc           when perf counters are available
+/// Allocations are counted across all threads, hardware events only on the
+/// thread running the benchmark.
+class ScopedCounters {
+ public:
+  explicit ScopedCounters(benchmark::State& state)
+      : state(state),
+        allocations(instrumentation::AllocationTracker::Snapshot()) {
+    Perf().Start();
+  }
+
+  ScopedCounters(const ScopedCounters&) = delete;
+  ScopedCounters& operator=(const ScopedCounters&) = delete;
+
+  ~ScopedCounters() {
+    auto events = Perf().Stop();
+    auto allocated =
+        instrumentation::AllocationTracker::Snapshot() - allocations;
+    if (instrumentation::AllocationTracker::Enabled()) {
+      state.counters["allocs_per_op"] =
+          PerIteration(static_cast<double>(allocated.allocations));
+      state.counters["alloc_bytes_per_op"] =
+          PerIteration(static_cast<double>(allocated.bytes_allocated));
+    }
+    if (Perf().Available()) {
+      state.counters["cycles_per_op"] =
+          PerIteration(static_cast<double>(events.cycles));
+      state.counters["cache_misses_per_op"] =
+          PerIteration(static_cast<double>(events.cache_misses));
+      state.counters["branch_misses_per_op"] =
+          PerIteration(static_cast<double>(events.branch_misses));
+      if (events.cycles > 0) {
+        state.counters["ipc"] = static_cast<double>(events.instructions) /
+                                static_cast<double>(events.cycles);
+      }
+    }
+  }
+
+ private:
+  benchmark::State& state;
+  instrumentation::AllocationStats allocations;
+
+  /// @brief Counters are opened once, by the benchmark thread
+  static instrumentation::PerfCounters& Perf() {
+    static instrumentation::PerfCounters counters;
+    return counters;
+  }
+
+  static benchmark::Counter PerIteration(double value) {
+    return benchmark::Counter(value, benchmark::Counter::kAvgIterations);
+  }
+};
+
+}  // namespace bench
+}  // namespace nll
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include <fmt/core.h>
+
+#include "nll/collections/filter_common.hpp"
+
+namespace nll {
+
+/// @brief Split block Bloom filter: each key sets one bit in each of the
+/// eight 32-bit words of a single 32-byte block, so an insert or a lookup
+/// touches one cache line no matter how many bits it tests. With AVX2 the
+/// eight bits are computed and tested in one vector operation. Costs about
+/// 10% more bits than a classic Bloom filter for the same false positive
+/// rate, in exchange for one cache miss per lookup instead of k.
+/// False negatives are impossible; keys cannot be removed.
+/// @tparam THash hash of keys; it is mixed further, so std::hash is fine
+template <class TKey, class THash = std::hash<TKey>>
+class BlockedBloomFilter {
+  static constexpr std::size_t kWordsPerBlock = 8;
+  static constexpr std::size_t kBitsPerBlock = kWordsPerBlock * 32;
+  static constexpr std::size_t kPrefetchDistance = 16;
+  static constexpr std::uint32_t kMagic = 0x46424c4e;  // "NLBF"
+  static constexpr std::uint8_t kVersion = 1;
+
+  struct alignas(32) Block {
+    std::uint32_t words[kWordsPerBlock];
+  };
+
+ public:
+  /// @brief Sizes the filter for expected_keys insertions at the given
+  /// false positive rate
+  /// @throws std::invalid_argument if the rate is not in (0, 1) or is too
+  /// low to reach with 64 bits per key
+  explicit BlockedBloomFilter(std::size_t expected_keys,
+                              double false_positive_rate = 0.01) {
+    auto bits_per_key = BitsPerKeyFor(false_positive_rate);
+    auto bits = std::ceil(static_cast<double>(std::max<std::size_t>(
+                              expected_keys, 1)) *
+                          bits_per_key);
+    auto num_blocks = static_cast<std::size_t>(
+        std::ceil(bits / static_cast<double>(kBitsPerBlock)));
+    if (num_blocks > UINT32_MAX) {
+      throw std::length_error(
+          fmt::format("{} blocks do not fit in 32-bit block indices",
+                      num_blocks));
+    }
+    blocks.assign(num_blocks, Block{});
+  }
+
+  /// @brief Estimated false positive rate with bits_per_key bits of filter
+  /// per inserted key. Block loads are Poisson distributed; a block holding
+  /// i keys answers yes to a random key when all eight of its bits are set.
+  static double FalsePositiveRate(double bits_per_key) {
+    if (!(bits_per_key > 0)) {
+      return 1;
+    }
+    double keys_per_block = kBitsPerBlock / bits_per_key;
+    auto last = static_cast<std::size_t>(
+        keys_per_block + 12 * std::sqrt(keys_per_block) + 32);
+    double rate = 0;
+    double poisson = std::exp(-keys_per_block);
+    for (std::size_t i = 0; i <= last; i++) {
+      double bit_set = 1 - std::pow(31.0 / 32.0, static_cast<double>(i));
+      rate += poisson * std::pow(bit_set, kWordsPerBlock);
+      poisson *= keys_per_block / static_cast<double>(i + 1);
+    }
+    return rate;
+  }
+
+  /// @brief Smallest bits per key, in steps of a quarter bit, that keeps
+  /// the false positive rate at or below the target
+  /// @throws std::invalid_argument if the target cannot be reached
+  static double BitsPerKeyFor(double false_positive_rate) {
+    if (!(false_positive_rate > 0 && false_positive_rate < 1)) {
+      throw std::invalid_argument(
+          "false positive rate must be between 0 and 1!");
+    }
+    for (double bits = 1; bits <= 64; bits += 0.25) {
+      if (FalsePositiveRate(bits) <= false_positive_rate) {
+        return bits;
+      }
+    }
+    throw std::invalid_argument(fmt::format(
+        "false positive rate {} needs more than 64 bits per key",
+        false_positive_rate));
+  }
+
+  /// @brief Adds a key
+  void Insert(const TKey& key) { InsertHash(Hash(key)); }
+
+  /// @brief Checks for a key: false means it was never inserted, true means
+  /// it probably was
+  bool MayContain(const TKey& key) const { return MayContainHash(Hash(key)); }
+
+  /// @brief Inserts every key of a range, prefetching the blocks of the keys
+  /// kPrefetchDistance ahead so their cache misses overlap
+  template <class TIterator>
+  void InsertBatch(TIterator first, TIterator last) {
+    ForEachPrefetched(first, last,
+                      [this](std::uint64_t hash) { InsertHash(hash); });
+  }
+
+  /// @brief Looks up every key of a range, prefetching like InsertBatch, and
+  /// writes one bool per key to out
+  /// @return the output iterator past the last result
+  template <class TIterator, class TOutput>
+  TOutput MayContainBatch(TIterator first, TIterator last, TOutput out) const {
+    ForEachPrefetched(first, last, [this, &out](std::uint64_t hash) {
+      *out = MayContainHash(hash);
+      ++out;
+    });
+    return out;
+  }
+
+  /// @brief Removes every key
+  void Clear() { std::fill(blocks.begin(), blocks.end(), Block{}); }
+
+  /// @brief Gets the number of 32-byte blocks
+  std::size_t BlockCount() const { return blocks.size(); }
+
+  /// @brief Gets the size of the bit array in bytes
+  std::size_t MemoryBytes() const { return blocks.size() * sizeof(Block); }
+
+  /// @brief Encodes the filter in a portable byte format. Reading it back
+  /// only makes sense with the same THash.
+  std::vector<std::uint8_t> Serialize() const {
+    std::vector<std::uint8_t> bytes;
+    bytes.reserve(13 + MemoryBytes());
+    detail::ByteWriter writer(bytes);
+    writer.Write(kMagic);
+    writer.Write(kVersion);
+    writer.Write(static_cast<std::uint64_t>(blocks.size()));
+    for (const auto& block : blocks) {
+      for (auto word : block.words) {
+        writer.Write(word);
+      }
+    }
+    return bytes;
+  }
+
+  /// @brief Decodes a filter written by Serialize
+  /// @throws std::invalid_argument if the bytes are not a serialized filter
+  static BlockedBloomFilter Deserialize(
+      const std::vector<std::uint8_t>& bytes) {
+    detail::ByteReader reader(bytes.data(), bytes.size());
+    if (reader.Read<std::uint32_t>() != kMagic ||
+        reader.Read<std::uint8_t>() != kVersion) {
+      throw std::invalid_argument("not a serialized bloom filter!");
+    }
+    auto num_blocks = reader.Read<std::uint64_t>();
+    if (num_blocks == 0 || num_blocks > UINT32_MAX ||
+        num_blocks > bytes.size() / sizeof(Block)) {
+      throw std::invalid_argument("serialized bloom filter is corrupt!");
+    }
+    BlockedBloomFilter filter;
+    filter.blocks.resize(num_blocks);
+    for (auto& block : filter.blocks) {
+      for (auto& word : block.words) {
+        word = reader.Read<std::uint32_t>();
+      }
+    }
+    if (!reader.AtEnd()) {
+      throw std::invalid_argument("serialized bloom filter is corrupt!");
+    }
+    return filter;
+  }
+
+ private:
+  std::vector<Block> blocks;
+  THash hasher{};
+
+  BlockedBloomFilter() = default;
+
+  std::uint64_t Hash(const TKey& key) const {
+    return detail::MixHash(static_cast<std::uint64_t>(hasher(key)));
+  }
+
+  // The high half of the hash picks the block, the low half the bits
+  const Block& BlockFor(std::uint64_t hash) const {
+    return blocks[detail::FastRange32(static_cast<std::uint32_t>(hash >> 32),
+                                      static_cast<std::uint32_t>(
+                                          blocks.size()))];
+  }
+
+  Block& BlockFor(std::uint64_t hash) {
+    return const_cast<Block&>(std::as_const(*this).BlockFor(hash));
+  }
+
+#if defined(__AVX2__)
+  /// @brief One bit per word: multiplying by eight odd salts and keeping
+  /// the top five bits gives eight independent bit positions
+  static __m256i Mask(std::uint32_t hash) {
+    const __m256i salts = _mm256_setr_epi32(
+        0x47b6137b, 0x44974d91, static_cast<int>(0x8824ad5b),
+        static_cast<int>(0xa2b7289d), 0x705495c7, 0x2df1424b,
+        static_cast<int>(0x9efc4947), 0x5c6bfb31);
+    auto positions = _mm256_srli_epi32(
+        _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(hash)), salts),
+        27);
+    return _mm256_sllv_epi32(_mm256_set1_epi32(1), positions);
+  }
+
+  void InsertHash(std::uint64_t hash) {
+    auto* words = reinterpret_cast<__m256i*>(BlockFor(hash).words);
+    _mm256_store_si256(words, _mm256_or_si256(_mm256_load_si256(words),
+                                              Mask(static_cast<std::uint32_t>(
+                                                  hash))));
+  }
+
+  bool MayContainHash(std::uint64_t hash) const {
+    auto* words = reinterpret_cast<const __m256i*>(BlockFor(hash).words);
+    // testc: every bit of the mask is set in the block
+    return _mm256_testc_si256(_mm256_load_si256(words),
+                              Mask(static_cast<std::uint32_t>(hash)));
+  }
+#else
+  static constexpr std::uint32_t kSalts[kWordsPerBlock] = {
+      0x47b6137b, 0x44974d91, 0x8824ad5b, 0xa2b7289d,
+      0x705495c7, 0x2df1424b, 0x9efc4947, 0x5c6bfb31};
+
+  static std::uint32_t BitFor(std::uint32_t hash, std::size_t word) {
+    return std::uint32_t{1} << ((hash * kSalts[word]) >> 27);
+  }
+
+  void InsertHash(std::uint64_t hash) {
+    auto& block = BlockFor(hash);
+    for (std::size_t i = 0; i < kWordsPerBlock; i++) {
+      block.words[i] |= BitFor(static_cast<std::uint32_t>(hash), i);
+    }
+  }
+
+  bool MayContainHash(std::uint64_t hash) const {
+    const auto& block = BlockFor(hash);
+    // No early exit: a fixed-length loop vectorizes and does not mispredict
+    std::uint32_t missing = 0;
+    for (std::size_t i = 0; i < kWordsPerBlock; i++) {
+      auto bit = BitFor(static_cast<std::uint32_t>(hash), i);
+      missing |= bit & ~block.words[i];
+    }
+    return missing == 0;
+  }
+#endif
+
+  template <class TIterator, class TVisit>
+  void ForEachPrefetched(TIterator first, TIterator last,
+                         TVisit visit) const {
+    std::uint64_t hashes[kPrefetchDistance];
+    std::size_t count = 0;
+    for (; first != last; ++first, ++count) {
+      auto hash = Hash(*first);
+      detail::PrefetchRead(&BlockFor(hash));
+      auto slot = count % kPrefetchDistance;
+      if (count >= kPrefetchDistance) {
+        visit(hashes[slot]);
+      }
+      hashes[slot] = hash;
+    }
+    auto pending = std::min(count, kPrefetchDistance);
+    for (auto i = count - pending; i < count; i++) {
+      visit(hashes[i % kPrefetchDistance]);
+    }
+  }
+};
+
+}  // namespace nll
@@ -0,0 +1,600 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "nll/collections/cache_policy.hpp"
+#include "nll/collections/filter_common.hpp"
+#include "nll/collections/hashmap.hpp"
+#include "nll/hash/hasher.hpp"
+
+namespace nll {
+
+namespace detail {
+
+/// @brief Lock of a CacheShard. The single threaded variant does nothing
+/// and compiles away.
+template <bool kConcurrent>
+struct CacheLock {
+  void lock() {}
+  bool try_lock() { return true; }
+  void unlock() {}
+  void lock_shared() {}
+  void unlock_shared() {}
+};
+
+/// @brief Readers share the lock, anything that relinks entries holds it
+/// exclusively
+template <>
+struct CacheLock<true> {
+  std::shared_mutex mutex;
+
+  void lock() { mutex.lock(); }
+  bool try_lock() { return mutex.try_lock(); }
+  void unlock() { mutex.unlock(); }
+  void lock_shared() { mutex.lock_shared(); }
+  void unlock_shared() { mutex.unlock_shared(); }
+};
+
+/// @brief One independently locked part of a Cache, holding the entries
+/// whose hash selects it. Entries live in a slab and are chained into
+/// doubly linked lists by slab index, so any entry can be unlinked or moved
+/// to a front in O(1); the index maps each key to its slot.
+///
+/// Concurrent reads only take the lock shared. CLOCK hits just set the
+/// entry's reference bit; LRU and TinyLFU hits are appended to a small lossy
+/// buffer that whoever next takes the lock exclusively replays. Every
+/// exclusive operation drains the buffer before relinking anything, so a
+/// buffered slot always still holds the entry that was read.
+template <class TKey, class TValue, class TWeigher, bool kConcurrent,
+          class THash>
+class CacheShard {
+  static constexpr std::uint32_t kNil =
+      std::numeric_limits<std::uint32_t>::max();
+  static constexpr std::size_t kReadBufferSize = 64;
+
+  /// @brief The lists entries are chained into. LRU and CLOCK keep every
+  /// entry in kMain; TinyLFU uses kMain as the probation segment of its
+  /// main area.
+  enum Segment : std::uint8_t { kMain, kProtected, kWindow };
+
+  struct Entry {
+    std::optional<std::pair<TKey, TValue>> item;
+    std::uint64_t hash = 0;
+    std::size_t weight = 0;
+    std::uint32_t prev = kNil;
+    std::uint32_t next = kNil;
+    Segment segment = kMain;
+    std::atomic<bool> referenced{false};
+  };
+
+  struct List {
+    std::uint32_t head = kNil;
+    std::uint32_t tail = kNil;
+    std::size_t weight = 0;
+  };
+
+  template <class T>
+  using Counter = std::conditional_t<kConcurrent, std::atomic<T>, T>;
+
+  CacheLock<kConcurrent> lock;
+  EvictionPolicy policy;
+  TWeigher weigher;
+  std::size_t capacity;
+  std::size_t window_capacity = 0;
+  std::size_t protected_capacity = 0;
+  std::size_t weight = 0;
+
+  // std::deque never moves its elements, which the atomics need
+  std::deque<Entry> entries;
+  std::vector<std::uint32_t> free_slots;
+  Hashmap<TKey, std::uint32_t, DefaultHashmapPolicy,
+          std::allocator<std::pair<TKey, std::uint32_t>>, THash>
+      index;
+  std::array<List, 3> lists;
+  FrequencySketch sketch;
+  std::size_t sketch_entries = 0;
+
+  std::array<std::atomic<std::uint32_t>, kReadBufferSize> read_buffer;
+  std::atomic<std::size_t> read_count{0};
+
+  Counter<std::uint64_t> hits{0};
+  Counter<std::uint64_t> misses{0};
+  std::uint64_t evictions = 0;
+  std::uint64_t evicted_weight = 0;
+
+  void PushFront(Segment segment, std::uint32_t slot) {
+    auto& entry = entries[slot];
+    auto& list = lists[segment];
+    entry.segment = segment;
+    entry.prev = kNil;
+    entry.next = list.head;
+    if (list.head != kNil) {
+      entries[list.head].prev = slot;
+    } else {
+      list.tail = slot;
+    }
+    list.head = slot;
+    list.weight += entry.weight;
+  }
+
+  void Unlink(std::uint32_t slot) {
+    auto& entry = entries[slot];
+    auto& list = lists[entry.segment];
+    if (entry.prev != kNil) {
+      entries[entry.prev].next = entry.next;
+    } else {
+      list.head = entry.next;
+    }
+    if (entry.next != kNil) {
+      entries[entry.next].prev = entry.prev;
+    } else {
+      list.tail = entry.prev;
+    }
+    list.weight -= entry.weight;
+  }
+
+  void MoveToFront(Segment segment, std::uint32_t slot) {
+    Unlink(slot);
+    PushFront(segment, slot);
+  }
+
+  std::uint32_t Allocate() {
+    if (!free_slots.empty()) {
+      auto slot = free_slots.back();
+      free_slots.pop_back();
+      return slot;
+    }
+    entries.emplace_back();
+    return static_cast<std::uint32_t>(entries.size() - 1);
+  }
+
+  /// @brief Unlinks the entry in slot and frees the slot
+  void Drop(std::uint32_t slot) {
+    auto& entry = entries[slot];
+    Unlink(slot);
+    index.Remove(entry.item->first);
+    weight -= entry.weight;
+    entry.item.reset();
+    entry.referenced.store(false, std::memory_order_relaxed);
+    free_slots.push_back(slot);
+  }
+
+  void Evict(std::uint32_t slot) {
+    evictions++;
+    evicted_weight += entries[slot].weight;
+    Drop(slot);
+  }
+
+  /// @brief Replays the reads buffered since the last drain. Needs the
+  /// exclusive lock.
+  void DrainReads() {
+    if constexpr (kConcurrent) {
+      auto count = std::min(read_count.load(std::memory_order_relaxed),
+                            kReadBufferSize);
+      for (std::size_t i = 0; i < count; i++) {
+        OnHit(read_buffer[i].load(std::memory_order_relaxed));
+      }
+      read_count.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /// @brief Buffers a read of slot, dropping it if the buffer is full. Needs
+  /// the shared lock.
+  /// @return true if the buffer is full and should be drained
+  bool RecordRead(std::uint32_t slot) {
+    auto position = read_count.fetch_add(1, std::memory_order_relaxed);
+    if (position < kReadBufferSize) {
+      read_buffer[position].store(slot, std::memory_order_relaxed);
+    }
+    return position + 1 >= kReadBufferSize;
+  }
+
+  void OnHit(std::uint32_t slot) {
+    if (policy == EvictionPolicy::kTinyLfu) {
+      sketch.Increment(entries[slot].hash);
+    }
+    Touch(slot);
+  }
+
+  /// @brief Marks slot as just used
+  void Touch(std::uint32_t slot) {
+    auto& entry = entries[slot];
+    switch (policy) {
+      case EvictionPolicy::kLru:
+        MoveToFront(kMain, slot);
+        break;
+      case EvictionPolicy::kClock:
+        entry.referenced.store(true, std::memory_order_relaxed);
+        break;
+      case EvictionPolicy::kTinyLfu:
+        if (entry.segment != kMain) {
+          MoveToFront(entry.segment, slot);
+          break;
+        }
+        // A hit on probation earns a place in the protected segment, whose
+        // least recent entries go back on probation
+        MoveToFront(kProtected, slot);
+        while (lists[kProtected].weight > protected_capacity &&
+               lists[kProtected].tail != slot) {
+          MoveToFront(kMain, lists[kProtected].tail);
+        }
+        break;
+    }
+  }
+
+  /// @brief Decides whether the TinyLFU candidate leaving the window enters
+  /// the main area, evicting main entries to make room. It is admitted only
+  /// if it is more popular than every entry that would have to go, ties
+  /// going to the incumbents, and all of them are checked before any is
+  /// evicted, so a rejected candidate costs the main area nothing.
+  bool Admit(std::uint32_t candidate) {
+    auto frequency = sketch.Frequency(entries[candidate].hash);
+    auto main_capacity = capacity - window_capacity;
+    auto over = [&] {
+      return lists[kMain].weight + lists[kProtected].weight +
+                 entries[candidate].weight >
+             main_capacity;
+    };
+    if (!over()) {
+      return true;
+    }
+    auto excess = lists[kMain].weight + lists[kProtected].weight +
+                  entries[candidate].weight - main_capacity;
+    std::size_t freed = 0;
+    for (auto segment : {kMain, kProtected}) {
+      for (auto slot = lists[segment].tail; slot != kNil && freed < excess;
+           slot = entries[slot].prev) {
+        if (frequency <= sketch.Frequency(entries[slot].hash)) {
+          return false;
+        }
+        freed += entries[slot].weight;
+      }
+    }
+    if (freed < excess) {
+      return false;
+    }
+    while (over()) {
+      Evict(lists[kMain].tail != kNil ? lists[kMain].tail
+                                      : lists[kProtected].tail);
+    }
+    return true;
+  }
+
+  /// @brief Picks the entry to evict next, never keep
+  std::uint32_t Victim(std::uint32_t keep) {
+    if (policy == EvictionPolicy::kClock) {
+      // The tail is the oldest entry; one used since it was last passed over
+      // gets a second chance at the front
+      while (true) {
+        auto slot = lists[kMain].tail;
+        auto& entry = entries[slot];
+        if (slot != keep &&
+            !entry.referenced.load(std::memory_order_relaxed)) {
+          return slot;
+        }
+        entry.referenced.store(false, std::memory_order_relaxed);
+        MoveToFront(kMain, slot);
+      }
+    }
+    for (auto segment : {kMain, kProtected, kWindow}) {
+      for (auto slot = lists[segment].tail; slot != kNil;
+           slot = entries[slot].prev) {
+        if (slot != keep) {
+          return slot;
+        }
+      }
+    }
+    return kNil;
+  }
+
+  /// @brief Evicts until the shard is back within capacity, never evicting
+  /// keep, the entry just written
+  void EvictIfNeeded(std::uint32_t keep) {
+    if (policy == EvictionPolicy::kTinyLfu) {
+      while (lists[kWindow].weight > window_capacity) {
+        auto candidate = lists[kWindow].tail;
+        if (Admit(candidate)) {
+          MoveToFront(kMain, candidate);
+        } else {
+          Evict(candidate);
+        }
+      }
+    }
+    // keep alone always fits, so there is a victim while over capacity
+    while (weight > capacity) {
+      Evict(Victim(keep));
+    }
+  }
+
+ public:
+  CacheShard(std::size_t capacity, EvictionPolicy policy,
+             const TWeigher& weigher)
+      : policy(policy), weigher(weigher), capacity(capacity) {
+    if (policy == EvictionPolicy::kTinyLfu) {
+      // A 1% window and 80% of the rest protected, Caffeine's defaults
+      window_capacity = std::max<std::size_t>(capacity / 100, 1);
+      protected_capacity = (capacity - window_capacity) / 5 * 4;
+      // Byte weighers make the capacity a poor guess at the entry count, so
+      // the sketch starts small and grows with the entries
+      sketch_entries = std::min<std::size_t>(capacity, 1 << 16);
+      sketch.EnsureCapacity(sketch_entries);
+    }
+  }
+
+  std::optional<TValue> Get(const TKey& key) {
+    std::optional<TValue> value;
+    bool drain = false;
+    {
+      std::shared_lock guard(lock);
+      auto* slot = index.Find(key);
+      if (slot == nullptr) {
+        misses++;
+        return std::nullopt;
+      }
+      auto& entry = entries[*slot];
+      value = entry.item->second;
+      hits++;
+      if (policy == EvictionPolicy::kClock) {
+        // Reading first keeps hot entries' lines shared between cores
+        if (!entry.referenced.load(std::memory_order_relaxed)) {
+          entry.referenced.store(true, std::memory_order_relaxed);
+        }
+      } else if constexpr (kConcurrent) {
+        drain = RecordRead(*slot);
+      } else {
+        OnHit(*slot);
+      }
+    }
+    if (drain) {
+      // Whoever holds the lock will drain anyway, so never wait for it
+      std::unique_lock guard(lock, std::try_to_lock);
+      if (guard.owns_lock()) {
+        DrainReads();
+      }
+    }
+    return value;
+  }
+
+  bool Put(TKey key, TValue value, std::uint64_t hash) {
+    auto new_weight = static_cast<std::size_t>(weigher(key, value));
+    std::lock_guard guard(lock);
+    DrainReads();
+    auto* existing = index.Find(key);
+    if (new_weight > capacity) {
+      if (existing != nullptr) {
+        Drop(*existing);
+      }
+      return false;
+    }
+    if (policy == EvictionPolicy::kTinyLfu) {
+      sketch.Increment(hash);
+    }
+    std::uint32_t slot;
+    if (existing != nullptr) {
+      slot = *existing;
+      auto& entry = entries[slot];
+      entry.item->second = std::move(value);
+      lists[entry.segment].weight -= entry.weight;
+      lists[entry.segment].weight += new_weight;
+      weight -= entry.weight;
+      entry.weight = new_weight;
+      Touch(slot);
+    } else {
+      slot = Allocate();
+      index.Insert(key, slot);
+      auto& entry = entries[slot];
+      entry.item.emplace(std::move(key), std::move(value));
+      entry.hash = hash;
+      entry.weight = new_weight;
+      PushFront(policy == EvictionPolicy::kTinyLfu ? kWindow : kMain, slot);
+      if (policy == EvictionPolicy::kTinyLfu &&
+          index.Size() > sketch_entries) {
+        sketch_entries = 2 * index.Size();
+        sketch.EnsureCapacity(sketch_entries);
+      }
+    }
+    weight += new_weight;
+    EvictIfNeeded(slot);
+    return true;
+  }
+
+  bool Erase(const TKey& key) {
+    std::lock_guard guard(lock);
+    DrainReads();
+    auto* slot = index.Find(key);
+    if (slot == nullptr) {
+      return false;
+    }
+    Drop(*slot);
+    return true;
+  }
+
+  void Clear() {
+    std::lock_guard guard(lock);
+    read_count.store(0, std::memory_order_relaxed);
+    index.Clear();
+    entries.clear();
+    free_slots.clear();
+    lists = {};
+    weight = 0;
+  }
+
+  std::size_t Size() {
+    std::shared_lock guard(lock);
+    return index.Size();
+  }
+
+  std::size_t Weight() {
+    std::shared_lock guard(lock);
+    return weight;
+  }
+
+  void AddStats(CacheStats& stats) {
+    std::shared_lock guard(lock);
+    stats.hits += hits;
+    stats.misses += misses;
+    stats.evictions += evictions;
+    stats.evicted_weight += evicted_weight;
+  }
+};
+
+}  // namespace detail
+
+/// @brief Bounded key-value cache with O(1) lookup, promotion and eviction,
+/// evicting by EvictionPolicy once the total weight of its entries would
+/// exceed the capacity. The weigher returns an entry's weight, by default 1
+/// so the capacity counts entries; return a byte size to bound memory.
+///
+/// With kConcurrent set, any number of threads may use the cache at once.
+/// It is split into shards by key hash, each behind a reader-writer lock;
+/// Get only takes its shard's lock shared and records what it read in a
+/// buffer replayed later (see detail::CacheShard), so hits on different and
+/// even the same keys do not serialize. Reads are recorded lossily under
+/// contention, which only makes the policy slightly less exact.
+/// @tparam TWeigher callable as weigher(key, value), returning a size_t
+/// @tparam kConcurrent enables sharding and locking
+/// @tparam THash hash of keys, picking the shard and feeding the TinyLFU
+/// sketch. One that does not declare kAvalanching gets a Mix64 on top, as
+/// in Hashmap.
+template <class TKey, class TValue, class TWeigher = UnitWeigher,
+          bool kConcurrent = false, class THash = hash::Hasher<TKey>>
+class Cache {
+  using Shard =
+      detail::CacheShard<TKey, TValue, TWeigher, kConcurrent, THash>;
+
+  std::vector<std::unique_ptr<Shard>> shards;
+  std::size_t capacity;
+  EvictionPolicy policy;
+  THash hasher{};
+
+  Shard& ShardFor(std::uint64_t hash) {
+    return *shards[nll::hash::FastRange32(
+        static_cast<std::uint32_t>(hash >> 32),
+        static_cast<std::uint32_t>(shards.size()))];
+  }
+
+  std::uint64_t Hash(const TKey& key) const {
+    auto value = static_cast<std::uint64_t>(hasher(key));
+    if constexpr (hash::kIsAvalanching<THash>) {
+      return value;
+    } else {
+      return hash::Mix64(value);
+    }
+  }
+
+ public:
+  /// @brief Constructor
+  /// @param options capacity, eviction policy and shard count
+  /// @param weigher gives each entry its weight
+  /// @throws std::invalid_argument if the capacity is 0
+  explicit Cache(const CacheOptions& options = CacheOptions(),
+                 const TWeigher& weigher = TWeigher())
+      : capacity(options.capacity), policy(options.policy) {
+    if (capacity == 0) {
+      throw std::invalid_argument("cache capacity must be positive!");
+    }
+    std::size_t count = 1;
+    if constexpr (kConcurrent) {
+      count = options.shards;
+      if (count == 0) {
+        count = 4 * std::max(std::thread::hardware_concurrency(), 1u);
+      }
+      count = std::min(count, capacity);
+    }
+    for (std::size_t i = 0; i < count; i++) {
+      // Spread the remainder so the shard capacities add up to capacity
+      auto share = capacity / count + (i < capacity % count ? 1 : 0);
+      shards.push_back(std::make_unique<Shard>(share, policy, weigher));
+    }
+  }
+
+  /// @brief Looks up key, counting a hit or a miss
+  /// @return a copy of the value, or std::nullopt if key is not cached
+  std::optional<TValue> Get(const TKey& key) {
+    return ShardFor(Hash(key)).Get(key);
+  }
+
+  /// @brief Inserts or replaces the value of key, then evicts entries until
+  /// the cache is within capacity. With TinyLFU, a new entry may itself be
+  /// evicted soon after if it is less popular than the entries it competes
+  /// with.
+  /// @return false if the entry weighs more than a shard holds, in which case
+  /// key is removed instead
+  bool Put(TKey key, TValue value) {
+    auto hash = Hash(key);
+    return ShardFor(hash).Put(std::move(key), std::move(value), hash);
+  }
+
+  /// @brief Removes key, which does not count as an eviction
+  /// @return true if key was cached
+  bool Erase(const TKey& key) { return ShardFor(Hash(key)).Erase(key); }
+
+  /// @brief Removes every entry. Stats are kept.
+  void Clear() {
+    for (auto& shard : shards) {
+      shard->Clear();
+    }
+  }
+
+  /// @brief Gets the number of cached entries
+  std::size_t Size() const {
+    std::size_t size = 0;
+    for (auto& shard : shards) {
+      size += shard->Size();
+    }
+    return size;
+  }
+
+  /// @brief Returns whether the cache is empty
+  bool Empty() const { return Size() == 0; }
+
+  /// @brief Gets the total weight of the cached entries
+  std::size_t Weight() const {
+    std::size_t weight = 0;
+    for (auto& shard : shards) {
+      weight += shard->Weight();
+    }
+    return weight;
+  }
+
+  /// @brief Gets the largest total weight the cache holds
+  std::size_t Capacity() const { return capacity; }
+
+  /// @brief Gets the eviction policy
+  EvictionPolicy Policy() const { return policy; }
+
+  /// @brief Gets the number of independently locked shards
+  std::size_t ShardCount() const { return shards.size(); }
+
+  /// @brief Gets the hit, miss and eviction counters, summed over the shards
+  CacheStats Stats() const {
+    CacheStats stats;
+    for (auto& shard : shards) {
+      shard->AddStats(stats);
+    }
+    return stats;
+  }
+};
+
+/// @brief Cache any number of threads may use at once
+template <class TKey, class TValue, class TWeigher = UnitWeigher,
+          class THash = hash::Hasher<TKey>>
+using ConcurrentCache = Cache<TKey, TValue, TWeigher, true, THash>;
+
+}  // namespace nll
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "nll/collections/filter_common.hpp"
+
+namespace nll {
+
+/// @brief How a Cache picks what to evict
+enum class EvictionPolicy {
+  /// @brief Least recently used: every hit moves the entry to the front
+  kLru,
+  /// @brief Second chance FIFO: a hit only sets a reference bit, which
+  /// eviction clears once before giving up on the entry. Approximates LRU
+  /// with no list updates on reads, so it scales best with threads.
+  kClock,
+  /// @brief W-TinyLFU (Einziger et al., "TinyLFU: A Highly Efficient Cache
+  /// Admission Policy"): new entries wait in a small LRU window; leaving
+  /// it, they only enter the main segmented LRU if a frequency sketch has
+  /// seen them more often than the entry they would evict. Resists scans
+  /// and one-hit wonders.
+  kTinyLfu,
+};
+
+/// @brief Weigher giving every entry a weight of 1, so a Cache's capacity
+/// is an entry count
+struct UnitWeigher {
+  template <class TKey, class TValue>
+  std::size_t operator()(const TKey&, const TValue&) const {
+    return 1;
+  }
+};
+
+/// @brief Counters of a Cache, summed over its shards
+struct CacheStats {
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+  /// @brief Entries removed to make room, including entries TinyLFU
+  /// declined to admit; Erase and replaced values do not count
+  std::uint64_t evictions = 0;
+  std::uint64_t evicted_weight = 0;
+
+  /// @brief Fraction of Get calls that found their key
+  double HitRate() const {
+    auto lookups = hits + misses;
+    return lookups == 0 ? 0 : static_cast<double>(hits) / lookups;
+  }
+};
+
+/// @brief Options of a Cache
+struct CacheOptions {
+  /// @brief Largest total weight the cache holds
+  std::size_t capacity = 1024;
+  EvictionPolicy policy = EvictionPolicy::kLru;
+  /// @brief Independently locked parts of a concurrent cache, each with an
+  /// equal share of the capacity. 0 picks four per hardware thread.
+  /// Single threaded caches always use one.
+  std::size_t shards = 0;
+};
+
+namespace detail {
+
+/// @brief Count-Min sketch of 4-bit counters estimating how often each
+/// key was seen recently, the popularity measure of TinyLFU. Four counters
+/// per key, one in each of four rows; the estimate is their minimum. Once
+/// increments reach ten times the number of counters per row, every
+/// counter is halved, so old popularity fades.
+class FrequencySketch {
+ public:
+  /// @brief Sizes the sketch for about entries distinct popular keys. Grows
+  /// only, and growing forgets the counts.
+  void EnsureCapacity(std::size_t entries) {
+    std::size_t words = 1;
+    while (words * kCountersPerWord < entries) {
+      words *= 2;
+    }
+    if (words <= words_per_row) {
+      return;
+    }
+    table.assign(words * kRows, 0);
+    words_per_row = words;
+    sample_size = 10 * words * kCountersPerWord;
+    additions = 0;
+  }
+
+  /// @brief Estimated recent occurrences of hash, at most 15
+  unsigned Frequency(std::uint64_t hash) const {
+    if (table.empty()) {
+      return 0;
+    }
+    unsigned frequency = kMaxCount;
+    for (std::size_t row = 0; row < kRows; row++) {
+      auto [word, shift] = Counter(hash, row);
+      frequency = std::min(
+          frequency, static_cast<unsigned>((table[word] >> shift) & 0xf));
+    }
+    return frequency;
+  }
+
+  /// @brief Records one occurrence of hash
+  void Increment(std::uint64_t hash) {
+    if (table.empty()) {
+      return;
+    }
+    bool added = false;
+    for (std::size_t row = 0; row < kRows; row++) {
+      auto [word, shift] = Counter(hash, row);
+      if (((table[word] >> shift) & 0xf) < kMaxCount) {
+        table[word] += std::uint64_t{1} << shift;
+        added = true;
+      }
+    }
+    if (added && ++additions == sample_size) {
+      Age();
+    }
+  }
+
+ private:
+  static constexpr std::size_t kRows = 4;
+  static constexpr std::size_t kCountersPerWord = 16;
+  static constexpr unsigned kMaxCount = 15;
+
+  std::vector<std::uint64_t> table;
+  std::size_t words_per_row = 0;
+  std::size_t sample_size = 0;
+  std::size_t additions = 0;
+
+  std::pair<std::size_t, unsigned> Counter(std::uint64_t hash,
+                                           std::size_t row) const {
+    auto mixed = MixHash(hash + row * 0x9e3779b97f4a7c15ULL);
+    auto word = row * words_per_row +
+                static_cast<std::size_t>(mixed & (words_per_row - 1));
+    auto shift = static_cast<unsigned>(4 * ((mixed >> 60) & 0xf));
+    return {word, shift};
+  }
+
+  /// @brief Halves every counter
+  void Age() {
+    for (auto& word : table) {
+      word = (word >> 1) & 0x7777777777777777ULL;
+    }
+    additions /= 2;
+  }
+};
+
+}  // namespace detail
+
+}  // namespace nll
@@ -0,0 +1,398 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "nll/collections/filter_common.hpp"
+
+namespace nll {
+
+/// @brief Cuckoo filter (Fan et al., 2014): a table of buckets holding four
+/// short key fingerprints each. A key's fingerprint lives in one of two
+/// buckets, and either bucket can be derived from the other and the
+/// fingerprint alone, so entries can be moved while inserting, and removed.
+/// Below 3% false positives it uses fewer bits per key than a Bloom filter.
+/// Lookups compare a whole bucket against the fingerprint in one word-wide
+/// operation.
+///
+/// Only remove keys that were inserted: removing any other key may remove
+/// the fingerprint of a different key that collides with it. A key inserted
+/// twice must be removed twice.
+/// @tparam THash hash of keys; it is mixed further, so std::hash is fine
+/// @tparam TFingerprint slot type, std::uint8_t or std::uint16_t. It bounds
+/// the fingerprint length and so the lowest reachable false positive rate.
+template <class TKey, class THash = std::hash<TKey>,
+          class TFingerprint = std::uint16_t>
+class CuckooFilter {
+  static_assert(std::is_same_v<TFingerprint, std::uint8_t> ||
+                    std::is_same_v<TFingerprint, std::uint16_t>,
+                "fingerprints must be std::uint8_t or std::uint16_t");
+
+  static constexpr std::size_t kSlotsPerBucket = 4;
+  static constexpr std::size_t kMaxKicks = 500;
+  static constexpr std::size_t kPrefetchDistance = 16;
+  // Occupancy cuckoo hashing with 4-way buckets reliably reaches
+  static constexpr double kMaxLoadFactor = 0.95;
+  static constexpr std::uint32_t kMagic = 0x46434c4e;  // "NLCF"
+  static constexpr std::uint8_t kVersion = 1;
+
+  /// @brief A whole bucket, compared against a fingerprint at once
+  using BucketWord =
+      std::conditional_t<sizeof(TFingerprint) == 1, std::uint32_t,
+                         std::uint64_t>;
+  static constexpr BucketWord kLaneOnes =
+      static_cast<BucketWord>(~BucketWord{0}) /
+      static_cast<TFingerprint>(~TFingerprint{0});
+  static constexpr BucketWord kLaneHighBits =
+      kLaneOnes << (8 * sizeof(TFingerprint) - 1);
+
+ public:
+  /// @brief Sizes the filter for expected_keys keys at the given false
+  /// positive rate
+  /// @throws std::invalid_argument if the rate is not in (0, 1) or needs
+  /// longer fingerprints than TFingerprint holds
+  explicit CuckooFilter(std::size_t expected_keys,
+                        double false_positive_rate = 0.01)
+      : fingerprint_bits(FingerprintBitsFor(false_positive_rate)) {
+    auto wanted = static_cast<std::size_t>(std::ceil(
+        static_cast<double>(std::max<std::size_t>(expected_keys, 1)) /
+        (kSlotsPerBucket * kMaxLoadFactor)));
+    // A power of two, so the alternate bucket is an XOR away
+    num_buckets = 1;
+    while (num_buckets < wanted) {
+      num_buckets *= 2;
+    }
+    slots.assign(num_buckets * kSlotsPerBucket, 0);
+  }
+
+  /// @brief Fingerprint length for a false positive rate: a lookup compares
+  /// against 2 buckets of 4 slots, each matching with probability 2^-bits
+  /// @throws std::invalid_argument if TFingerprint is too short for it
+  static unsigned FingerprintBitsFor(double false_positive_rate) {
+    if (!(false_positive_rate > 0 && false_positive_rate < 1)) {
+      throw std::invalid_argument(
+          "false positive rate must be between 0 and 1!");
+    }
+    auto bits = static_cast<unsigned>(std::ceil(
+        std::log2(2.0 * kSlotsPerBucket / false_positive_rate)));
+    if (bits > 8 * sizeof(TFingerprint)) {
+      throw std::invalid_argument(fmt::format(
+          "false positive rate {} needs {}-bit fingerprints",
+          false_positive_rate, bits));
+    }
+    return bits;
+  }
+
+  /// @brief Adds a key
+  /// @return false if the filter is full; it is then unchanged
+  bool Insert(const TKey& key) { return InsertHash(Hash(key)); }
+
+  /// @brief Checks for a key: false means it is not in the filter, true
+  /// means it probably is
+  bool MayContain(const TKey& key) const { return MayContainHash(Hash(key)); }
+
+  /// @brief Removes one copy of a key that was inserted
+  /// @return false if no matching fingerprint was found
+  bool Erase(const TKey& key) {
+    auto hash = Hash(key);
+    auto fingerprint = FingerprintOf(hash);
+    auto first = IndexOf(hash);
+    auto second = AlternateIndex(first, fingerprint);
+    if (victim.used && victim.fingerprint == fingerprint &&
+        (victim.index == first || victim.index == second)) {
+      victim.used = false;
+      size--;
+      return true;
+    }
+    if (!EraseFrom(first, fingerprint) && !EraseFrom(second, fingerprint)) {
+      return false;
+    }
+    size--;
+    // A slot just opened up; give the evicted fingerprint another try
+    if (victim.used) {
+      victim.used = false;
+      size--;
+      InsertFingerprint(victim.index, victim.fingerprint);
+    }
+    return true;
+  }
+
+  /// @brief Inserts every key of a range, prefetching both buckets of the
+  /// keys kPrefetchDistance ahead so their cache misses overlap
+  /// @return the number of keys inserted before the filter filled up
+  template <class TIterator>
+  std::size_t InsertBatch(TIterator first, TIterator last) {
+    std::size_t inserted = 0;
+    bool full = false;
+    ForEachPrefetched(first, last, [&](std::uint64_t hash) {
+      full = full || !InsertHash(hash);
+      inserted += !full;
+    });
+    return inserted;
+  }
+
+  /// @brief Looks up every key of a range, prefetching like InsertBatch, and
+  /// writes one bool per key to out
+  /// @return the output iterator past the last result
+  template <class TIterator, class TOutput>
+  TOutput MayContainBatch(TIterator first, TIterator last, TOutput out) const {
+    ForEachPrefetched(first, last, [this, &out](std::uint64_t hash) {
+      *out = MayContainHash(hash);
+      ++out;
+    });
+    return out;
+  }
+
+  /// @brief Gets the number of keys in the filter
+  std::size_t Size() const { return size; }
+
+  /// @brief Returns whether the filter is empty or not
+  bool Empty() const { return size == 0; }
+
+  /// @brief Gets the number of fingerprint slots
+  std::size_t Capacity() const { return slots.size(); }
+
+  /// @brief Gets the fraction of slots in use
+  double LoadFactor() const {
+    return static_cast<double>(size) / static_cast<double>(slots.size());
+  }
+
+  /// @brief Gets the fingerprint length in bits
+  unsigned FingerprintBits() const { return fingerprint_bits; }
+
+  /// @brief Gets the size of the table in bytes
+  std::size_t MemoryBytes() const {
+    return slots.size() * sizeof(TFingerprint);
+  }
+
+  /// @brief Removes every key
+  void Clear() {
+    std::fill(slots.begin(), slots.end(), TFingerprint{0});
+    victim.used = false;
+    size = 0;
+  }
+
+  /// @brief Encodes the filter in a portable byte format. Reading it back
+  /// only makes sense with the same THash.
+  std::vector<std::uint8_t> Serialize() const {
+    std::vector<std::uint8_t> bytes;
+    bytes.reserve(40 + MemoryBytes());
+    detail::ByteWriter writer(bytes);
+    writer.Write(kMagic);
+    writer.Write(kVersion);
+    writer.Write(static_cast<std::uint8_t>(sizeof(TFingerprint)));
+    writer.Write(static_cast<std::uint8_t>(fingerprint_bits));
+    writer.Write(static_cast<std::uint64_t>(num_buckets));
+    writer.Write(static_cast<std::uint64_t>(size));
+    writer.Write(static_cast<std::uint8_t>(victim.used));
+    writer.Write(static_cast<std::uint64_t>(victim.index));
+    writer.Write(victim.fingerprint);
+    for (auto slot : slots) {
+      writer.Write(slot);
+    }
+    return bytes;
+  }
+
+  /// @brief Decodes a filter written by Serialize
+  /// @throws std::invalid_argument if the bytes are not a serialized filter
+  /// with this fingerprint type
+  static CuckooFilter Deserialize(const std::vector<std::uint8_t>& bytes) {
+    detail::ByteReader reader(bytes.data(), bytes.size());
+    if (reader.Read<std::uint32_t>() != kMagic ||
+        reader.Read<std::uint8_t>() != kVersion) {
+      throw std::invalid_argument("not a serialized cuckoo filter!");
+    }
+    if (reader.Read<std::uint8_t>() != sizeof(TFingerprint)) {
+      throw std::invalid_argument(
+          "serialized cuckoo filter has a different fingerprint type!");
+    }
+    CuckooFilter filter;
+    filter.fingerprint_bits = reader.Read<std::uint8_t>();
+    auto num_buckets = reader.Read<std::uint64_t>();
+    filter.size = reader.Read<std::uint64_t>();
+    filter.victim.used = reader.Read<std::uint8_t>() != 0;
+    filter.victim.index = reader.Read<std::uint64_t>();
+    filter.victim.fingerprint = reader.Read<TFingerprint>();
+    if (filter.fingerprint_bits == 0 ||
+        filter.fingerprint_bits > 8 * sizeof(TFingerprint) ||
+        num_buckets == 0 || (num_buckets & (num_buckets - 1)) != 0 ||
+        num_buckets > bytes.size() / (kSlotsPerBucket * sizeof(TFingerprint)) ||
+        filter.victim.index >= num_buckets) {
+      throw std::invalid_argument("serialized cuckoo filter is corrupt!");
+    }
+    filter.num_buckets = num_buckets;
+    filter.slots.resize(num_buckets * kSlotsPerBucket);
+    for (auto& slot : filter.slots) {
+      slot = reader.Read<TFingerprint>();
+    }
+    if (!reader.AtEnd() || filter.size > filter.slots.size() + 1) {
+      throw std::invalid_argument("serialized cuckoo filter is corrupt!");
+    }
+    return filter;
+  }
+
+ private:
+  /// @brief Fingerprint evicted by a failed insertion, kept so no key is
+  /// lost; while it is set the filter is full
+  struct Victim {
+    bool used = false;
+    std::size_t index = 0;
+    TFingerprint fingerprint = 0;
+  };
+
+  std::vector<TFingerprint> slots;
+  std::size_t num_buckets = 1;
+  std::size_t size = 0;
+  unsigned fingerprint_bits = 0;
+  Victim victim;
+  std::uint64_t random_state = 0x9e3779b97f4a7c15ULL;
+  THash hasher{};
+
+  CuckooFilter() = default;
+
+  std::uint64_t Hash(const TKey& key) const {
+    return detail::MixHash(static_cast<std::uint64_t>(hasher(key)));
+  }
+
+  // The high half of the hash picks the bucket, the low half the
+  // fingerprint. Zero marks an empty slot, so it is not a fingerprint.
+  std::size_t IndexOf(std::uint64_t hash) const {
+    return static_cast<std::size_t>(hash >> 32) & (num_buckets - 1);
+  }
+
+  TFingerprint FingerprintOf(std::uint64_t hash) const {
+    auto mask = (std::uint64_t{1} << fingerprint_bits) - 1;
+    auto fingerprint = static_cast<TFingerprint>(hash & mask);
+    return fingerprint == 0 ? 1 : fingerprint;
+  }
+
+  /// @brief The other bucket of a fingerprint. XOR with a hash of the
+  /// fingerprint is its own inverse, so this maps either bucket to the other.
+  std::size_t AlternateIndex(std::size_t index,
+                             TFingerprint fingerprint) const {
+    auto mixed = static_cast<std::size_t>(fingerprint * 0x5bd1e995U);
+    return (index ^ mixed) & (num_buckets - 1);
+  }
+
+  BucketWord LoadBucket(std::size_t index) const {
+    BucketWord word;
+    std::memcpy(&word, &slots[index * kSlotsPerBucket], sizeof(word));
+    return word;
+  }
+
+  /// @brief Whether any slot of the bucket holds value, by the zero-lane
+  /// test from "Bit Twiddling Hacks": XOR turns matching lanes to zero
+  static bool BucketHas(BucketWord bucket, TFingerprint value) {
+    auto lanes = bucket ^ (kLaneOnes * value);
+    return ((lanes - kLaneOnes) & ~lanes & kLaneHighBits) != 0;
+  }
+
+  bool MayContainHash(std::uint64_t hash) const {
+    auto fingerprint = FingerprintOf(hash);
+    auto first = IndexOf(hash);
+    auto second = AlternateIndex(first, fingerprint);
+    bool in_victim = victim.used && victim.fingerprint == fingerprint &&
+                     (victim.index == first || victim.index == second);
+    return in_victim || BucketHas(LoadBucket(first), fingerprint) ||
+           BucketHas(LoadBucket(second), fingerprint);
+  }
+
+  bool TryPlace(std::size_t index, TFingerprint fingerprint) {
+    auto* bucket = &slots[index * kSlotsPerBucket];
+    for (std::size_t i = 0; i < kSlotsPerBucket; i++) {
+      if (bucket[i] == 0) {
+        bucket[i] = fingerprint;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool EraseFrom(std::size_t index, TFingerprint fingerprint) {
+    auto* bucket = &slots[index * kSlotsPerBucket];
+    for (std::size_t i = 0; i < kSlotsPerBucket; i++) {
+      if (bucket[i] == fingerprint) {
+        bucket[i] = 0;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::size_t NextRandom() {
+    // xorshift64, only used to pick which slot to evict
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return static_cast<std::size_t>(random_state);
+  }
+
+  /// @brief Places a fingerprint in bucket index or its alternate, evicting
+  /// random residents to their alternate buckets when both are full. After
+  /// kMaxKicks evictions the last evicted fingerprint becomes the victim.
+  void InsertFingerprint(std::size_t index, TFingerprint fingerprint) {
+    size++;
+    if (TryPlace(index, fingerprint)) {
+      return;
+    }
+    index = AlternateIndex(index, fingerprint);
+    if (TryPlace(index, fingerprint)) {
+      return;
+    }
+    for (std::size_t kick = 0; kick < kMaxKicks; kick++) {
+      auto& slot =
+          slots[index * kSlotsPerBucket + NextRandom() % kSlotsPerBucket];
+      std::swap(slot, fingerprint);
+      index = AlternateIndex(index, fingerprint);
+      if (TryPlace(index, fingerprint)) {
+        return;
+      }
+    }
+    victim.used = true;
+    victim.index = index;
+    victim.fingerprint = fingerprint;
+  }
+
+  bool InsertHash(std::uint64_t hash) {
+    if (victim.used) {
+      return false;
+    }
+    InsertFingerprint(IndexOf(hash), FingerprintOf(hash));
+    return true;
+  }
+
+  template <class TIterator, class TVisit>
+  void ForEachPrefetched(TIterator first, TIterator last,
+                         TVisit visit) const {
+    std::uint64_t hashes[kPrefetchDistance];
+    std::size_t count = 0;
+    for (; first != last; ++first, ++count) {
+      auto hash = Hash(*first);
+      auto index = IndexOf(hash);
+      detail::PrefetchRead(&slots[index * kSlotsPerBucket]);
+      detail::PrefetchRead(
+          &slots[AlternateIndex(index, FingerprintOf(hash)) *
+                 kSlotsPerBucket]);
+      auto slot = count % kPrefetchDistance;
+      if (count >= kPrefetchDistance) {
+        visit(hashes[slot]);
+      }
+      hashes[slot] = hash;
+    }
+    auto pending = std::min(count, kPrefetchDistance);
+    for (auto i = count - pending; i < count; i++) {
+      visit(hashes[i % kPrefetchDistance]);
+    }
+  }
+};
+
+}  // namespace nll
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace nll {
+
+/// @brief Implicit D-ary min-heap in a vector: the children of slot i are
+/// slots D*i+1 .. D*i+D. A wider heap is shallower, so pops compare more
+/// children per level but visit fewer levels and cache lines; D = 4 puts
+/// a node's int children in one line and usually beats a binary heap. For
+/// priorities that change in place, see IndexedDaryHeap.
+/// @tparam T element type, smallest (per TCompare) on top, may be move-only
+/// @tparam D heap arity
+/// @tparam TCompare strict weak ordering on elements
+/// @tparam TAllocator allocates the vector's storage
+template <class T, std::size_t D = 4, class TCompare = std::less<T>,
+          class TAllocator = std::allocator<T>>
+class DaryHeap {
+  static_assert(D >= 2, "heap arity must be at least 2");
+
+  std::vector<T, TAllocator> heap;
+  TCompare compare{};
+
+  /// @brief Moves the element at pos up until its parent is not larger
+  void SiftUp(std::size_t pos) {
+    auto value = std::move(heap[pos]);
+    while (pos > 0) {
+      auto parent = (pos - 1) / D;
+      if (!compare(value, heap[parent])) {
+        break;
+      }
+      heap[pos] = std::move(heap[parent]);
+      pos = parent;
+    }
+    heap[pos] = std::move(value);
+  }
+
+  /// @brief Moves the element at pos down until no child is smaller
+  void SiftDown(std::size_t pos) {
+    auto value = std::move(heap[pos]);
+    auto size = heap.size();
+    while (true) {
+      auto first_child = pos * D + 1;
+      if (first_child >= size) {
+        break;
+      }
+      auto last_child = std::min(first_child + D, size);
+      auto best = first_child;
+      for (auto child = first_child + 1; child < last_child; child++) {
+        if (compare(heap[child], heap[best])) {
+          best = child;
+        }
+      }
+      if (!compare(heap[best], value)) {
+        break;
+      }
+      heap[pos] = std::move(heap[best]);
+      pos = best;
+    }
+    heap[pos] = std::move(value);
+  }
+
+  /// @brief Restores the heap order over the whole vector bottom-up, O(n)
+  void Heapify() {
+    if (heap.size() < 2) {
+      return;
+    }
+    for (auto pos = (heap.size() - 2) / D + 1; pos-- > 0;) {
+      SiftDown(pos);
+    }
+  }
+
+ public:
+  using allocator_type = TAllocator;
+
+  DaryHeap() = default;
+
+  explicit DaryHeap(const TAllocator& allocator) : heap(allocator) {}
+
+  /// @brief Builds a heap of values in O(n), faster than pushing them one
+  /// by one in O(n log n)
+  explicit DaryHeap(std::vector<T, TAllocator> values)
+      : heap(std::move(values)) {
+    Heapify();
+  }
+
+  /// @brief Gets the allocator the storage comes from
+  TAllocator get_allocator() const { return heap.get_allocator(); }
+
+  /// @brief Gets the number of elements
+  std::size_t Size() const { return heap.size(); }
+
+  /// @brief Returns whether the heap is empty or not
+  bool Empty() const { return heap.empty(); }
+
+  /// @brief Reserves storage for capacity elements
+  void Reserve(std::size_t capacity) { heap.reserve(capacity); }
+
+  /// @brief Removes every element, keeping the storage
+  void Clear() { heap.clear(); }
+
+  /// @brief Inserts a value. O(log_D n).
+  template <class U>
+  void Push(U&& value) {
+    heap.push_back(std::forward<U>(value));
+    SiftUp(heap.size() - 1);
+  }
+
+  /// @brief Constructs a value in place from args and inserts it
+  template <class... TArgs>
+  void Emplace(TArgs&&... args) {
+    heap.emplace_back(std::forward<TArgs>(args)...);
+    SiftUp(heap.size() - 1);
+  }
+
+  /// @brief Inserts the values of [first, last). Rebuilds the whole heap in
+  /// O(n) when that beats sifting each new value up.
+  template <class TIterator>
+  void PushRange(TIterator first, TIterator last) {
+    auto old_size = heap.size();
+    heap.insert(heap.end(), first, last);
+    auto added = heap.size() - old_size;
+    if (added > old_size / 2) {
+      Heapify();
+    } else {
+      for (auto pos = old_size; pos < heap.size(); pos++) {
+        SiftUp(pos);
+      }
+    }
+  }
+
+  /// @brief Gets the smallest element
+  /// @throws std::out_of_range if the heap is empty
+  const T& Top() const {
+    if (heap.empty()) {
+      throw std::out_of_range("heap is empty!");
+    }
+    return heap.front();
+  }
+
+  /// @brief Removes the smallest element and returns it, moved out rather
+  /// than copied. O(D log_D n).
+  /// @throws std::out_of_range if the heap is empty
+  T Pop() {
+    if (heap.empty()) {
+      throw std::out_of_range("heap is empty!");
+    }
+    auto top = std::move(heap.front());
+    if (heap.size() > 1) {
+      heap.front() = std::move(heap.back());
+      heap.pop_back();
+      SiftDown(0);
+    } else {
+      heap.pop_back();
+    }
+    return top;
+  }
+};
+
+namespace pmr {
+
+/// @brief DaryHeap drawing its storage from a std::pmr::memory_resource
+template <class T, std::size_t D = 4, class TCompare = std::less<T>>
+using DaryHeap =
+    nll::DaryHeap<T, D, TCompare, std::pmr::polymorphic_allocator<T>>;
+
+}  // namespace pmr
+
+}  // namespace nll
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "nll/hash/mix.hpp"
+#include "nll/memory/prefetch.hpp"
+
+namespace nll {
+namespace detail {
+
+/// @brief Hashes of std::hash are mixed with Mix64 before use, see
+/// nll/hash/mix.hpp
+inline std::uint64_t MixHash(std::uint64_t value) {
+  return hash::Mix64(value);
+}
+
+using hash::FastRange32;
+using hash::FastRange64;
+
+/// @brief Appends integers in little-endian order, so serialized structures
+/// read back on any host
+class ByteWriter {
+ public:
+  explicit ByteWriter(std::vector<std::uint8_t>& bytes) : bytes(bytes) {}
+
+  template <class T>
+  void Write(T value) {
+    for (std::size_t i = 0; i < sizeof(T); i++) {
+      bytes.push_back(static_cast<std::uint8_t>(
+          static_cast<std::uint64_t>(value) >> (8 * i)));
+    }
+  }
+
+ private:
+  std::vector<std::uint8_t>& bytes;
+};
+
+/// @brief Reads what ByteWriter wrote
+class ByteReader {
+ public:
+  ByteReader(const std::uint8_t* data, std::size_t size)
+      : data(data), size(size) {}
+
+  /// @throws std::invalid_argument if the input is too short
+  template <class T>
+  T Read() {
+    if (size - position < sizeof(T)) {
+      throw std::invalid_argument("serialized data is truncated!");
+    }
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < sizeof(T); i++) {
+      value |= static_cast<std::uint64_t>(data[position++]) << (8 * i);
+    }
+    return static_cast<T>(value);
+  }
+
+  bool AtEnd() const { return position == size; }
+
+ private:
+  const std::uint8_t* data;
+  std::size_t size;
+  std::size_t position = 0;
+};
+
+}  // namespace detail
+}  // namespace nll
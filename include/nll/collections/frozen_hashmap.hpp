@@ -0,0 +1,520 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "nll/collections/filter_common.hpp"
+#include "nll/collections/hashmap.hpp"
+#include "nll/memory/mapped_file.hpp"
+
+namespace nll {
+
+/// On-disk layout of a frozen hashmap file, all integers in native byte
+/// order:
+///
+///   FrozenHashmapHeader        104 bytes at offset 0
+///   pilots   [buckets] uint32  at header.pilots_offset
+///   entries  [size] key, value at header.entries_offset
+///
+/// Sections start on 64 byte boundaries, as in graph files, so both are
+/// used in place once the file is mapped.
+struct FrozenHashmapHeader {
+  static constexpr char kMagic[8] = {'N', 'L', 'L', 'M',
+                                     'P', 'H', 'F', '\0'};
+  static constexpr std::uint32_t kVersion = 1;
+  static constexpr std::uint32_t kByteOrderMark = 0x01020304;
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order_mark;
+  std::uint32_t key_bytes;
+  std::uint32_t value_bytes;
+  std::uint32_t entry_bytes;
+  std::uint32_t reserved;
+  std::uint64_t seed;
+  std::uint64_t size;
+  std::uint64_t num_buckets;
+  std::uint64_t dense_buckets;
+  std::uint64_t pilots_offset;
+  std::uint64_t entries_offset;
+  std::uint64_t pilots_checksum;
+  std::uint64_t entries_checksum;
+  std::uint64_t header_checksum;
+};
+
+static_assert(sizeof(FrozenHashmapHeader) == 104,
+              "frozen hashmap header layout must not change within a version");
+
+/// @brief Options for mapping a frozen hashmap file
+struct FrozenHashmapFileOptions {
+  /// @brief Checksum both sections on open. Touches the whole file; the
+  /// header is always checked.
+  bool verify_checksums = false;
+  /// @brief Ask the kernel to fault the whole file in up front
+  bool populate = false;
+};
+
+namespace detail {
+
+/// @brief A key and its value, stored side by side so a lookup touches one
+/// cache line
+template <class TKey, class TValue>
+struct FrozenEntry {
+  TKey key;
+  TValue value;
+};
+
+/// @brief Seeded hash of a key's bytes, stable across processes of the same
+/// build so files can be shared. Keys of up to 8 bytes go through one
+/// bijective mix and never collide.
+template <class TKey>
+std::uint64_t FrozenHash(const TKey& key, std::uint64_t seed) {
+  if constexpr (sizeof(TKey) <= sizeof(std::uint64_t)) {
+    std::uint64_t word = 0;
+    std::memcpy(&word, &key, sizeof(TKey));
+    return MixHash(word ^ seed);
+  } else {
+    auto bytes = reinterpret_cast<const unsigned char*>(&key);
+    std::uint64_t hash = seed ^ sizeof(TKey);
+    std::size_t i = 0;
+    for (; i + 8 <= sizeof(TKey); i += 8) {
+      std::uint64_t word;
+      std::memcpy(&word, bytes + i, 8);
+      hash = MixHash(hash ^ word);
+    }
+    if (i < sizeof(TKey)) {
+      std::uint64_t word = 0;
+      std::memcpy(&word, bytes + i, sizeof(TKey) - i);
+      hash = MixHash(hash ^ word);
+    }
+    return hash;
+  }
+}
+
+inline std::uint64_t FrozenHeaderChecksum(FrozenHashmapHeader header) {
+  header.header_checksum = 0;
+  return Checksum64(&header, sizeof(header));
+}
+
+}  // namespace detail
+
+/// @brief Immutable hash map over a minimal perfect hash function in the
+/// style of PTHash (Pibiri and Trani, SIGIR 2021). Keys are hashed into
+/// buckets, skewed so 60% of keys fall into 30% of the buckets, and each
+/// bucket stores a pilot chosen at build time so that its keys land on
+/// distinct free slots of a table with exactly one slot per key. A lookup
+/// is one hash, a read of the small pilot array and one access to the
+/// key-value pair: no chains, probes or empty slots. The pilots take
+/// about one byte per key.
+///
+/// Building places the largest buckets first and searches each bucket's
+/// pilot; it takes a few passes over the keys. The map can be written to a
+/// file and mapped back read-only (WriteFile, MapFile) without any
+/// deserialization, so many processes can share one copy through the page
+/// cache. Any pilot maps into the table, so even a corrupt file cannot
+/// cause an out of bounds read.
+/// @tparam TKey trivially copyable key without padding, hashed bytewise
+/// @tparam TValue trivially copyable value
+template <class TKey, class TValue>
+class FrozenHashmap {
+  static_assert(std::is_trivially_copyable<TKey>::value &&
+                    std::has_unique_object_representations<TKey>::value,
+                "frozen hashmap keys must be trivially copyable and have no "
+                "padding");
+  static_assert(std::is_trivially_copyable<TValue>::value,
+                "frozen hashmap values must be trivially copyable");
+
+ public:
+  using Entry = detail::FrozenEntry<TKey, TValue>;
+
+  static_assert(alignof(Entry) <= detail::kSectionAlignment,
+                "entries must fit the file's section alignment");
+
+  /// @brief Average number of keys per bucket, trading pilot space against
+  /// build time
+  static constexpr std::uint64_t kKeysPerBucket = 4;
+
+  /// @brief Empty map
+  FrozenHashmap() { Init(); }
+
+  FrozenHashmap(FrozenHashmap&& other) noexcept { *this = std::move(other); }
+
+  FrozenHashmap& operator=(FrozenHashmap&& other) noexcept {
+    if (this != &other) {
+      seed = other.seed;
+      size = other.size;
+      num_buckets = other.num_buckets;
+      dense_buckets = other.dense_buckets;
+      pilots = other.pilots;
+      entries = other.entries;
+      owned_pilots = std::move(other.owned_pilots);
+      owned_entries = std::move(other.owned_entries);
+      mapping = std::move(other.mapping);
+      other.mapping.reset();
+      other.size = other.num_buckets = other.dense_buckets = 0;
+      other.pilots = nullptr;
+      other.entries = nullptr;
+    }
+    return *this;
+  }
+
+  // Not copyable: a mapped map has nothing to copy, share the file instead
+  FrozenHashmap(const FrozenHashmap&) = delete;
+  FrozenHashmap& operator=(const FrozenHashmap&) = delete;
+
+  /// @brief Builds a map of the pairs in [first, last), anything with
+  /// first and second members
+  /// @throws std::invalid_argument if a key appears twice
+  template <class TIterator>
+  static FrozenHashmap FromRange(TIterator first, TIterator last) {
+    std::vector<Entry> input;
+    for (; first != last; ++first) {
+      input.push_back(Entry{first->first, first->second});
+    }
+    return Build(std::move(input));
+  }
+
+  /// @brief Builds a map of the entries of map
+  template <class TPolicy, class TAllocator, class THash>
+  static FrozenHashmap FromHashmap(
+      const Hashmap<TKey, TValue, TPolicy, TAllocator, THash>& map) {
+    std::vector<Entry> input;
+    input.reserve(map.Size());
+    map.ForEach([&](const TKey& key, const TValue& value) {
+      input.push_back(Entry{key, value});
+    });
+    return Build(std::move(input));
+  }
+
+  /// @brief Maps a file written by WriteFile. Opening only validates the
+  /// header; entries are read straight from the mapping.
+  /// @throws std::system_error if the file cannot be opened or mapped
+  /// @throws std::runtime_error if the file is not a valid frozen hashmap
+  /// @throws std::invalid_argument if the key or value size does not match
+  static FrozenHashmap MapFile(const std::string& path,
+                               const FrozenHashmapFileOptions& options = {}) {
+    FrozenHashmap map;
+    map.mapping.emplace(path, options.populate);
+    auto* data = map.mapping->Data();
+    auto file_size = map.mapping->Size();
+    auto fail = [&](const char* reason) {
+      throw std::runtime_error(fmt::format(
+          "{} is not a valid frozen hashmap file: {}", path, reason));
+    };
+    if (file_size < sizeof(FrozenHashmapHeader)) {
+      fail("too small");
+    }
+    FrozenHashmapHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, FrozenHashmapHeader::kMagic,
+                    sizeof(header.magic)) != 0) {
+      fail("bad magic");
+    }
+    if (header.version != FrozenHashmapHeader::kVersion) {
+      fail("unsupported version");
+    }
+    if (header.byte_order_mark != FrozenHashmapHeader::kByteOrderMark) {
+      fail("written with a different byte order");
+    }
+    if (detail::FrozenHeaderChecksum(header) != header.header_checksum) {
+      fail("header checksum mismatch");
+    }
+    if (header.key_bytes != sizeof(TKey) ||
+        header.value_bytes != sizeof(TValue) ||
+        header.entry_bytes != sizeof(Entry)) {
+      throw std::invalid_argument(fmt::format(
+          "file has {} byte keys and {} byte values, not {} and {}",
+          header.key_bytes, header.value_bytes, sizeof(TKey),
+          sizeof(TValue)));
+    }
+    auto section_fits = [&](std::uint64_t offset, std::uint64_t count,
+                            std::uint64_t element_bytes) {
+      return offset % detail::kSectionAlignment == 0 && offset <= file_size &&
+             count <= (file_size - offset) / element_bytes;
+    };
+    if (header.dense_buckets == 0 ||
+        header.dense_buckets >= header.num_buckets ||
+        header.num_buckets > std::numeric_limits<std::uint32_t>::max()) {
+      fail("bad bucket counts");
+    }
+    if (!section_fits(header.pilots_offset, header.num_buckets,
+                      sizeof(std::uint32_t)) ||
+        !section_fits(header.entries_offset, header.size, sizeof(Entry))) {
+      fail("truncated");
+    }
+    auto pilot_bytes = header.num_buckets * sizeof(std::uint32_t);
+    auto entry_bytes = header.size * sizeof(Entry);
+    if (options.verify_checksums &&
+        (detail::Checksum64(data + header.pilots_offset, pilot_bytes) !=
+             header.pilots_checksum ||
+         detail::Checksum64(data + header.entries_offset, entry_bytes) !=
+             header.entries_checksum)) {
+      fail("section checksum mismatch");
+    }
+    map.seed = header.seed;
+    map.size = header.size;
+    map.num_buckets = header.num_buckets;
+    map.dense_buckets = header.dense_buckets;
+    map.pilots =
+        reinterpret_cast<const std::uint32_t*>(data + header.pilots_offset);
+    map.entries = reinterpret_cast<const Entry*>(data + header.entries_offset);
+    return map;
+  }
+
+  /// @brief Writes the map to a file MapFile can open
+  /// @throws std::runtime_error if the file cannot be written
+  void WriteFile(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      throw std::runtime_error(
+          fmt::format("cannot open {} for writing", path));
+    }
+    FrozenHashmapHeader header{};
+    std::memcpy(header.magic, FrozenHashmapHeader::kMagic,
+                sizeof(header.magic));
+    header.version = FrozenHashmapHeader::kVersion;
+    header.byte_order_mark = FrozenHashmapHeader::kByteOrderMark;
+    header.key_bytes = sizeof(TKey);
+    header.value_bytes = sizeof(TValue);
+    header.entry_bytes = sizeof(Entry);
+    header.seed = seed;
+    header.size = size;
+    header.num_buckets = num_buckets;
+    header.dense_buckets = dense_buckets;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    header.pilots_offset = detail::WriteAlignedSection(
+        out, pilots, num_buckets * sizeof(std::uint32_t),
+        header.pilots_checksum);
+    header.entries_offset = detail::WriteAlignedSection(
+        out, entries, size * sizeof(Entry), header.entries_checksum);
+    header.header_checksum = detail::FrozenHeaderChecksum(header);
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!out.flush()) {
+      throw std::runtime_error(fmt::format("failed writing {}", path));
+    }
+  }
+
+  /// @brief Gets the number of entries
+  std::size_t Size() const { return size; }
+
+  /// @brief Returns whether the map is empty or not
+  bool Empty() const { return size == 0; }
+
+  /// @brief Returns whether the map reads from a mapped file
+  bool IsMapped() const { return mapping.has_value(); }
+
+  /// @brief Gets the number of buckets, each with one pilot
+  std::size_t BucketCount() const { return num_buckets; }
+
+  /// @brief Gets the bytes the pilots and entries take, what a file holds
+  /// apart from its header and padding
+  std::size_t SizeInBytes() const {
+    return num_buckets * sizeof(std::uint32_t) + size * sizeof(Entry);
+  }
+
+  /// @brief Finds the value of key
+  /// @return the value, or nullptr if the key is absent
+  const TValue* Find(const TKey& key) const {
+    if (size == 0) {
+      return nullptr;
+    }
+    auto hash = detail::FrozenHash(key, seed);
+    const auto& entry = entries[Position(hash, pilots[BucketOf(hash)])];
+    return entry.key == key ? &entry.value : nullptr;
+  }
+
+  /// @brief Checks if a key exists in the map
+  bool Contains(const TKey& key) const { return Find(key) != nullptr; }
+
+  /// @brief Gets the value of key
+  /// @throws std::out_of_range if the key is not found
+  const TValue& Get(const TKey& key) const {
+    if (auto* value = Find(key)) {
+      return *value;
+    }
+    throw std::out_of_range("key not found!");
+  }
+
+  /// @brief Iterates the entries in table order
+  const Entry* begin() const { return entries; }
+
+  const Entry* end() const { return entries + size; }
+
+ private:
+  /// @brief Hashes below this 32-bit threshold, 60% of them, go to the
+  /// dense buckets
+  static constexpr std::uint32_t kDenseSelector = 0x9999999a;
+  static constexpr std::uint64_t kSeed = 0x5851f42d4c957f2dULL;
+  static constexpr int kMaxAttempts = 16;
+
+  std::uint64_t seed = kSeed;
+  std::uint64_t size = 0;
+  std::uint64_t num_buckets = 0;
+  std::uint64_t dense_buckets = 0;
+  const std::uint32_t* pilots = nullptr;
+  const Entry* entries = nullptr;
+  std::vector<std::uint32_t> owned_pilots;
+  std::vector<Entry> owned_entries;
+  std::optional<detail::ReadOnlyMapping> mapping;
+
+  /// @brief Sizes the buckets for size keys, at least two so there is one
+  /// dense and one sparse bucket, with zeroed pilots
+  void Init() {
+    num_buckets = std::max<std::uint64_t>(
+        2, (size + kKeysPerBucket - 1) / kKeysPerBucket);
+    dense_buckets = std::max<std::uint64_t>(1, num_buckets * 3 / 10);
+    owned_pilots.assign(num_buckets, 0);
+    owned_entries.clear();
+    pilots = owned_pilots.data();
+    entries = owned_entries.data();
+  }
+
+  std::uint64_t BucketOf(std::uint64_t hash) const {
+    auto selector = static_cast<std::uint32_t>(hash);
+    auto high = static_cast<std::uint32_t>(hash >> 32);
+    if (selector < kDenseSelector) {
+      return detail::FastRange32(high,
+                                 static_cast<std::uint32_t>(dense_buckets));
+    }
+    return dense_buckets +
+           detail::FastRange32(
+               high, static_cast<std::uint32_t>(num_buckets - dense_buckets));
+  }
+
+  /// @brief The slot of a key in its bucket with the given pilot. Mixing
+  /// again, rather than just XORing in the pilot, keeps two keys with
+  /// close hashes from colliding under every pilot.
+  std::uint64_t Position(std::uint64_t hash, std::uint64_t pilot) const {
+    return detail::FastRange64(detail::MixHash(hash ^ pilot), size);
+  }
+
+  static FrozenHashmap Build(std::vector<Entry> input) {
+    if (input.size() > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::length_error("frozen hashmaps hold at most 2^32 - 1 keys!");
+    }
+    FrozenHashmap map;
+    map.size = input.size();
+    map.Init();
+    for (int attempt = 0; !map.TryBuild(input); attempt++) {
+      if (attempt == kMaxAttempts) {
+        throw std::runtime_error(
+            "could not find a perfect hash function for the keys");
+      }
+      map.seed = detail::MixHash(kSeed + attempt + 1);
+    }
+    return map;
+  }
+
+  /// @brief Searches every bucket's pilot and fills the table
+  /// @return false if two distinct keys hash alike under this seed
+  /// @throws std::invalid_argument if a key appears twice
+  bool TryBuild(const std::vector<Entry>& input) {
+    std::vector<std::uint64_t> hashes(size);
+    std::vector<std::uint32_t> bucket_start(num_buckets + 1, 0);
+    for (std::size_t i = 0; i < size; i++) {
+      hashes[i] = detail::FrozenHash(input[i].key, seed);
+      bucket_start[BucketOf(hashes[i]) + 1]++;
+    }
+    std::partial_sum(bucket_start.begin(), bucket_start.end(),
+                     bucket_start.begin());
+    // Keys grouped by bucket, by counting sort
+    std::vector<std::uint32_t> keys(size);
+    {
+      auto cursor = bucket_start;
+      for (std::size_t i = 0; i < size; i++) {
+        keys[cursor[BucketOf(hashes[i])]++] = static_cast<std::uint32_t>(i);
+      }
+    }
+    auto bucket_size = [&](std::uint64_t bucket) {
+      return bucket_start[bucket + 1] - bucket_start[bucket];
+    };
+    // Largest buckets first, while most slots are still free
+    std::vector<std::uint32_t> order(num_buckets);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::uint32_t a, std::uint32_t b) {
+                       return bucket_size(a) > bucket_size(b);
+                     });
+
+    std::vector<std::uint64_t> taken((size + 63) / 64, 0);
+    auto is_taken = [&](std::uint64_t slot) {
+      return (taken[slot / 64] >> (slot % 64)) & 1;
+    };
+    std::vector<std::uint64_t> slots;
+    for (auto bucket : order) {
+      auto first = keys.begin() + bucket_start[bucket];
+      auto last = keys.begin() + bucket_start[bucket + 1];
+      if (first == last) {
+        break;
+      }
+      // Keys with equal hashes land on the same slot under every pilot
+      for (auto a = first; a != last; ++a) {
+        for (auto b = a + 1; b != last; ++b) {
+          if (hashes[*a] == hashes[*b]) {
+            if (input[*a].key == input[*b].key) {
+              throw std::invalid_argument("duplicate key!");
+            }
+            return false;
+          }
+        }
+      }
+      for (std::uint64_t pilot = 0;; pilot++) {
+        if (pilot > std::numeric_limits<std::uint32_t>::max()) {
+          return false;
+        }
+        slots.clear();
+        for (auto key = first; key != last; ++key) {
+          auto slot = Position(hashes[*key], pilot);
+          if (is_taken(slot) ||
+              std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+            break;
+          }
+          slots.push_back(slot);
+        }
+        if (slots.size() == static_cast<std::size_t>(last - first)) {
+          for (auto slot : slots) {
+            taken[slot / 64] |= std::uint64_t{1} << (slot % 64);
+          }
+          owned_pilots[bucket] = static_cast<std::uint32_t>(pilot);
+          break;
+        }
+      }
+    }
+
+    // Entry is trivially copyable, so zeroing its bytes is well defined; a
+    // value-initialized copy would leave the padding unspecified, and the
+    // file's bytes and checksum would then vary between builds. Filling
+    // member by member below keeps the padding zero.
+    owned_entries.resize(size);
+    std::memset(static_cast<void*>(owned_entries.data()), 0,
+                owned_entries.size() * sizeof(Entry));
+    for (std::uint64_t bucket = 0; bucket < num_buckets; bucket++) {
+      for (auto i = bucket_start[bucket]; i < bucket_start[bucket + 1]; i++) {
+        auto key = keys[i];
+        auto& entry =
+            owned_entries[Position(hashes[key], owned_pilots[bucket])];
+        entry.key = input[key].key;
+        entry.value = input[key].value;
+      }
+    }
+    pilots = owned_pilots.data();
+    entries = owned_entries.data();
+    return true;
+  }
+};
+
+}  // namespace nll
@@ -1,63 +1,234 @@
 #pragma once
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "nll/collections/hashmap_policy.hpp"
 #include "nll/collections/linked_list.hpp"
+#include "nll/hash/hasher.hpp"
+#include "nll/hash/mix.hpp"
+#include "nll/memory/prefetch.hpp"
 
 namespace nll {
 
-template <class TKey, class TValue>
-class Hashmap {
+/// @brief Hash map with separate chaining
+/// @tparam TPolicy load factor, growth factor and stats collection, see
+/// DefaultHashmapPolicy
+/// @tparam TAllocator allocates the bucket table and the chain nodes
+/// @tparam THash hash of keys. Buckets are picked from the high bits of the
+/// hash with FastRange64 rather than a modulo, so a hasher that does not
+/// declare kAvalanching, like std::hash, gets a Mix64 on top.
+template <class TKey, class TValue, class TPolicy = DefaultHashmapPolicy,
+          class TAllocator = std::allocator<std::pair<TKey, TValue>>,
+          class THash = hash::Hasher<TKey>>
+class Hashmap
+    : private detail::HashmapStatsStorage<TPolicy::kCollectStats> {
+  static_assert(TPolicy::kMaxLoadFactor > 0,
+                "max load factor must be positive");
+  static_assert(TPolicy::kGrowthFactor > 1,
+                "growth factor must be greater than 1");
+
+  static constexpr bool kCollectStats = TPolicy::kCollectStats;
+
+  using Bucket = SinglyLinkedList<std::pair<TKey, TValue>, TAllocator>;
+  using BucketAllocator = typename std::allocator_traits<
+      TAllocator>::template rebind_alloc<Bucket>;
+
  private:
-  std::vector<SinglyLinkedList<std::pair<TKey, TValue>>> table;
+  std::vector<Bucket, BucketAllocator> table;
   std::size_t num_buckets = 1;
   std::size_t size = 0;
-  const double max_load_factor = 0.75;
-  std::hash<TKey> hasher{};
+  double max_load_factor = TPolicy::kMaxLoadFactor;
+  double growth_factor = TPolicy::kGrowthFactor;
+  THash hasher{};
+
+  template <class TLookup>
+  std::uint64_t HashOf(const TLookup& key) const {
+    auto value = static_cast<std::uint64_t>(hasher(key));
+    if constexpr (hash::kIsAvalanching<THash>) {
+      return value;
+    } else {
+      return hash::Mix64(value);
+    }
+  }
+
+  std::size_t BucketOf(std::uint64_t hash) const {
+    return nll::hash::FastRange64(hash, num_buckets);
+  }
 
   /// @brief Resizes the hashmap to a new number of buckets
   /// @param new_num_buckets
   void Resize(std::size_t new_num_buckets) {
-    std::vector<SinglyLinkedList<std::pair<TKey, TValue>>> new_table(
-        new_num_buckets);
+    if constexpr (kCollectStats) {
+      auto start = std::chrono::steady_clock::now();
+      Rehash(new_num_buckets);
+      this->stats.resizes++;
+      this->stats.resize_time += std::chrono::steady_clock::now() - start;
+    } else {
+      Rehash(new_num_buckets);
+    }
+  }
+
+  /// @brief Fills buckets with count empty buckets, each holding the map's
+  /// allocator so their nodes come from it too. Default constructed ones
+  /// would only get it through pmr's uses-allocator construction.
+  void InitTable(std::vector<Bucket, BucketAllocator>& buckets,
+                 std::size_t count) const {
+    buckets.resize(count, Bucket(get_allocator()));
+  }
+
+  void Rehash(std::size_t new_num_buckets) {
+    std::vector<Bucket, BucketAllocator> new_table(table.get_allocator());
+    InitTable(new_table, new_num_buckets);
     for (auto& list : table) {
       for (auto& pair : list) {
-        auto hash = hasher(pair.first);
-        auto index = hash % new_num_buckets;
-        new_table[index].PushBack(pair);
+        auto index = nll::hash::FastRange64(HashOf(pair.first),
+                                            new_num_buckets);
+        new_table[index].PushBack(std::move(pair));
       }
     }
     table = std::move(new_table);
     num_buckets = new_num_buckets;
   }
 
-  /// @brief Resizes the hashmap if the load factor is exceeded
+  /// @brief Resizes the hashmap if entries would exceed the load factor
   /// @return true if the hashmap was resized
-  bool ResizeIfNeeded() {
-    if (size >= num_buckets * max_load_factor) {
-      Resize(num_buckets * 2);
+  bool ResizeIfNeeded(std::size_t entries) {
+    if (entries >= num_buckets * max_load_factor) {
+      // Enough buckets to get back under the load factor, even when it was
+      // just lowered
+      auto grown = static_cast<std::size_t>(num_buckets * growth_factor);
+      auto needed = static_cast<std::size_t>(entries / max_load_factor) + 1;
+      Resize(std::max({grown, needed, num_buckets + 1}));
       return true;
     }
     return false;
   }
 
-  inline std::size_t GetBucketIndex(TKey key) {
-    auto hash = hasher(key);
-    return hash % num_buckets;
+  template <class TLookup>
+  inline std::size_t GetBucketIndex(const TLookup& key) const {
+    return BucketOf(HashOf(key));
+  }
+
+  /// @brief Finds the entry for key, counting the keys compared when stats
+  /// are enabled
+  /// @return the entry, or nullptr if key is absent
+  template <class TLookup>
+  std::pair<TKey, TValue>* Lookup(const TLookup& key) {
+    return LookupIn(GetBucketIndex(key), key);
+  }
+
+  /// @brief Lookup in bucket index, which the caller already hashed key to
+  template <class TLookup>
+  std::pair<TKey, TValue>* LookupIn(std::size_t index, const TLookup& key) {
+    std::size_t probes = 0;
+    for (auto& pair : table[index]) {
+      probes++;
+      if (pair.first == key) {
+        if constexpr (kCollectStats) {
+          this->stats.RecordLookup(probes, true);
+        }
+        return &pair;
+      }
+    }
+    if constexpr (kCollectStats) {
+      this->stats.RecordLookup(probes, false);
+    }
+    return nullptr;
   }
 
  public:
+  using allocator_type = TAllocator;
+
   /// @brief Default constructor
-  Hashmap() { table.resize(this->num_buckets); }
+  Hashmap() { InitTable(table, this->num_buckets); }
+
+  /// @brief Constructor with the allocator for the table and entries
+  explicit Hashmap(const TAllocator& allocator)
+      : table(BucketAllocator(allocator)) {
+    InitTable(table, this->num_buckets);
+  }
 
   /// @brief Constructor with initial number of buckets
   /// @param num_buckets initial number of buckets
-  explicit Hashmap(std::size_t num_buckets) : num_buckets(num_buckets) {
-    table.resize(this->num_buckets);
+  /// @param allocator allocator for the table and entries
+  explicit Hashmap(std::size_t num_buckets,
+                   const TAllocator& allocator = TAllocator())
+      : table(BucketAllocator(allocator)),
+        num_buckets(std::max<std::size_t>(num_buckets, 1)) {
+    InitTable(table, this->num_buckets);
+  }
+
+  /// @brief Gets the allocator the table and entries come from
+  TAllocator get_allocator() const { return TAllocator(table.get_allocator()); }
+
+  /// @brief Gets the number of buckets
+  std::size_t BucketCount() const { return num_buckets; }
+
+  /// @brief Gets the mean number of entries per bucket
+  double LoadFactor() const {
+    return static_cast<double>(size) / num_buckets;
+  }
+
+  /// @brief Gets the load factor at which the map grows
+  double MaxLoadFactor() const { return max_load_factor; }
+
+  /// @brief Sets the load factor at which the map grows, growing right away
+  /// if it is already above it. Lower trades memory for shorter chains.
+  /// @throws std::invalid_argument if the load factor is not positive
+  void SetMaxLoadFactor(double load_factor) {
+    if (!(load_factor > 0)) {
+      throw std::invalid_argument("max load factor must be positive!");
+    }
+    max_load_factor = load_factor;
+    ResizeIfNeeded(size);
+  }
+
+  /// @brief Gets the factor the bucket count is multiplied by on growth
+  double GrowthFactor() const { return growth_factor; }
+
+  /// @brief Sets the factor the bucket count is multiplied by on growth.
+  /// Lower wastes less memory right after a resize but resizes more often.
+  /// @throws std::invalid_argument if the factor is not greater than 1
+  void SetGrowthFactor(double factor) {
+    if (!(factor > 1)) {
+      throw std::invalid_argument("growth factor must be greater than 1!");
+    }
+    growth_factor = factor;
+  }
+
+  /// @brief Gets the bucket chain length histogram: element k is the number
+  /// of buckets holding k entries. O(buckets), computed on demand.
+  std::vector<std::size_t> ChainLengths() const {
+    std::vector<std::size_t> histogram(1, 0);
+    for (const auto& list : table) {
+      auto length = list.Size();
+      if (length >= histogram.size()) {
+        histogram.resize(length + 1, 0);
+      }
+      histogram[length]++;
+    }
+    return histogram;
+  }
+
+  /// @brief Gets the lookup and resize counters. Only available with a
+  /// WithStats policy.
+  const HashmapStats& Stats() const {
+    static_assert(kCollectStats, "use a WithStats policy to collect stats");
+    return this->stats;
+  }
+
+  /// @brief Zeroes the lookup and resize counters
+  void ResetStats() {
+    static_assert(kCollectStats, "use a WithStats policy to collect stats");
+    this->stats = HashmapStats();
   }
 
   /// @brief Get the current size of the hashmap
@@ -67,6 +238,16 @@ class Hashmap {
   /// @brief Returns whether the hashmap is empty or not
   bool Empty() const { return Size() == 0; }
 
+  /// @brief Calls visit(key, value) on every entry, in no particular order
+  template <class TVisitor>
+  void ForEach(TVisitor&& visit) const {
+    for (const auto& list : table) {
+      list.ForEach([&](const std::pair<TKey, TValue>& pair) {
+        visit(pair.first, pair.second);
+      });
+    }
+  }
+
   /// @brief Clears all key-value pairs from the hashmap
   void Clear() {
     for (auto& list : table) {
@@ -79,38 +260,82 @@ class Hashmap {
   /// @param key the key to insert
   /// @param value the value to insert
   void Insert(TKey key, TValue value) {
-    auto hash = hasher(key);
-    auto index = hash % num_buckets;
+    auto hash = HashOf(key);
+    auto index = BucketOf(hash);
     for (auto& pair : table[index]) {
       if (pair.first == key) {
-        pair.second = value;
+        pair.second = std::move(value);
         return;
       }
     }
-    table[index].PushBack(std::make_pair(key, value));
+    // Grow first, so the new entry is hashed and moved only once
+    if (ResizeIfNeeded(size + 1)) {
+      index = BucketOf(hash);
+    }
+    table[index].PushBack(std::make_pair(std::move(key), std::move(value)));
     size++;
-    ResizeIfNeeded();
   }
 
   /// @brief Removes a key-value pair from the hashmap
   /// @param key the key to remove
-  /// @note TODO: Fix this stupid implementation
+  /// @throws std::out_of_range if the key is not found
   void Remove(TKey key) {
-    auto index = GetBucketIndex(key);
-    table[index].Remove(std::make_pair(key, this->Get(key)));
+    auto& bucket = table[GetBucketIndex(key)];
+    for (auto it = bucket.begin(); it != bucket.end(); ++it) {
+      if (it->first == key) {
+        bucket.Erase(it);
+        size--;
+        return;
+      }
+    }
+    throw std::out_of_range("key not found!");
   }
 
   /// @brief Checks if a key exists in the hashmap
   /// @param key the key to search for
   /// @return true if the key exists
-  bool Contains(TKey key) {
-    auto index = GetBucketIndex(key);
-    for (auto& pair : table[index]) {
-      if (pair.first == key) {
-        return true;
+  bool Contains(TKey key) { return Lookup(key) != nullptr; }
+
+  /// @brief Contains for a key of another type that compares equal to TKey,
+  /// such as a std::string_view for string keys, without converting it.
+  /// Needs a transparent hasher, one declaring is_transparent, that hashes
+  /// equal keys of both types alike.
+  template <class TLookup, class THasher = THash,
+            class = typename THasher::is_transparent>
+  bool Contains(const TLookup& key) {
+    return Lookup(key) != nullptr;
+  }
+
+  /// @brief Finds the value associated with a key without throwing. Writes
+  /// nothing unless the policy collects stats, so concurrent Finds on a map
+  /// no one modifies are safe.
+  /// @return the value, or nullptr if the key is not found
+  TValue* Find(const TKey& key) {
+    auto* pair = Lookup(key);
+    return pair == nullptr ? nullptr : &pair->second;
+  }
+
+  /// @brief Find for count keys at once. The keys of a chunk are hashed
+  /// together, in SIMD lanes when the hasher has a batch form and the
+  /// target has AVX-512DQ (see hash::Mix64Batch), and all of
+  /// their buckets are prefetched before any chain is walked, so the cache
+  /// misses of independent lookups overlap instead of queueing.
+  /// @param values receives the value of each key, or nullptr
+  void FindBatch(const TKey* keys, std::size_t count, TValue** values) {
+    constexpr std::size_t kChunk = 64;
+    std::uint64_t hashes[kChunk];
+    for (std::size_t start = 0; start < count; start += kChunk) {
+      auto chunk = std::min(kChunk, count - start);
+      hash::HashBatch(hasher, keys + start, chunk, hashes);
+      for (std::size_t i = 0; i < chunk; i++) {
+        hashes[i] = BucketOf(hashes[i]);
+        detail::PrefetchRead(&table[hashes[i]]);
+      }
+      for (std::size_t i = 0; i < chunk; i++) {
+        auto* pair = LookupIn(hashes[i], keys[start + i]);
+        values[start + i] = pair == nullptr ? nullptr : &pair->second;
       }
     }
-    return false;
   }
 
   /// @brief Gets the value associated with a key
@@ -118,11 +343,8 @@ class Hashmap {
   /// @return the value associated with the key
   /// @throws std::out_of_range if the key is not found
   TValue& Get(TKey key) {
-    auto index = GetBucketIndex(key);
-    for (auto& pair : table[index]) {
-      if (pair.first == key) {
-        return pair.second;
-      }
+    if (auto* pair = Lookup(key)) {
+      return pair->second;
     }
     throw std::out_of_range("key not found!");
   }
@@ -133,22 +355,36 @@ class Hashmap {
   /// @note if the key does not exist, it will be default created
   TValue& operator[](TKey key) {
     // Find key and return if it exists
-    auto index = GetBucketIndex(key);
+    auto hash = HashOf(key);
+    auto index = BucketOf(hash);
     for (auto& pair : table[index]) {
       if (pair.first == key) {
         return pair.second;
       }
     }
-    // Otherwise, default create a new pair for this key
-    table[index].PushBack(std::make_pair(key, TValue()));
-    size++;
-    // If adding a new element causes us to resize, recompute the index
-    bool did_resize = ResizeIfNeeded();
-    if (did_resize) {
-      index = GetBucketIndex(key);
+    // Otherwise, default create a new pair for this key. Growing first
+    // keeps it at the back of its bucket, which a rehash afterwards would
+    // not when the growth factor is not 2.
+    if (ResizeIfNeeded(size + 1)) {
+      index = BucketOf(hash);
     }
+    table[index].PushBack(std::make_pair(std::move(key), TValue()));
+    size++;
     return table[index].PeekBack().second;
   }
 };
 
+namespace pmr {
+
+/// @brief Hashmap drawing its table and entries from a
+/// std::pmr::memory_resource
+template <class TKey, class TValue, class TPolicy = DefaultHashmapPolicy,
+          class THash = hash::Hasher<TKey>>
+using Hashmap =
+    nll::Hashmap<TKey, TValue, TPolicy,
+                 std::pmr::polymorphic_allocator<std::pair<TKey, TValue>>,
+                 THash>;
+
+}  // namespace pmr
+
 }  // namespace nll
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nll {
+
+/// @brief Compile-time tuning of a Hashmap. A policy is a type with
+///   - kMaxLoadFactor: entries per bucket that trigger growth
+///   - kGrowthFactor: bucket count multiplier on growth, above 1
+///   - kCollectStats: whether lookups and resizes update HashmapStats
+/// The factors are only defaults; a map can change them at runtime.
+struct DefaultHashmapPolicy {
+  static constexpr double kMaxLoadFactor = 0.75;
+  static constexpr double kGrowthFactor = 2.0;
+  static constexpr bool kCollectStats = false;
+};
+
+/// @brief Short chains for the fastest lookups, at about twice the buckets
+struct FastHashmapPolicy : DefaultHashmapPolicy {
+  static constexpr double kMaxLoadFactor = 0.5;
+};
+
+/// @brief Fewer buckets and gentler growth, for maps where memory matters
+/// more than a few extra comparisons per lookup
+struct CompactHashmapPolicy : DefaultHashmapPolicy {
+  static constexpr double kMaxLoadFactor = 2.0;
+  static constexpr double kGrowthFactor = 1.5;
+};
+
+/// @brief Adds statistics collection to another policy, e.g.
+/// Hashmap<int, int, WithStats<CompactHashmapPolicy>>
+template <class TPolicy = DefaultHashmapPolicy>
+struct WithStats : TPolicy {
+  static constexpr bool kCollectStats = true;
+};
+
+/// @brief Counters a Hashmap with a kCollectStats policy keeps up to date
+struct HashmapStats {
+  /// @brief Probe lengths at or above this share the last histogram bin
+  static constexpr std::size_t kMaxProbeLength = 16;
+
+  /// @brief Get and Contains calls that found their key
+  std::uint64_t hits = 0;
+  /// @brief Get and Contains calls that did not find their key
+  std::uint64_t misses = 0;
+  std::uint64_t resizes = 0;
+  std::chrono::nanoseconds resize_time{0};
+  /// @brief probe_lengths[k]: Get and Contains calls that compared k keys
+  std::vector<std::uint64_t> probe_lengths =
+      std::vector<std::uint64_t>(kMaxProbeLength + 1, 0);
+
+  void RecordLookup(std::size_t probes, bool hit) {
+    (hit ? hits : misses)++;
+    probe_lengths[std::min(probes, kMaxProbeLength)]++;
+  }
+
+  /// @brief Mean keys compared per Get or Contains
+  double MeanProbeLength() const {
+    std::uint64_t lookups = 0;
+    std::uint64_t probes = 0;
+    for (std::size_t k = 0; k < probe_lengths.size(); k++) {
+      lookups += probe_lengths[k];
+      probes += k * probe_lengths[k];
+    }
+    return lookups == 0 ? 0 : static_cast<double>(probes) / lookups;
+  }
+};
+
+namespace detail {
+
+/// @brief Base class holding the stats of a Hashmap. The disabled
+/// specialization is empty, so the empty base optimization keeps it out of
+/// the map's layout entirely.
+template <bool kEnabled>
+class HashmapStatsStorage {
+ protected:
+  HashmapStats stats;
+};
+
+template <>
+class HashmapStatsStorage<false> {};
+
+}  // namespace detail
+
+}  // namespace nll
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+namespace nll {
+
+/// @brief Implicit D-ary min-heap over the ids [0, capacity), where each id
+/// holds one priority that can be lowered in place in O(log_D n). A position
+/// table maps every id to its heap slot, so DecreaseKey never searches.
+/// Entries keep their priority next to the id so sifts stay in one array.
+/// @tparam TPriority priority type, smallest (per TCompare) on top
+/// @tparam TIndex unsigned id type
+/// @tparam D heap arity, 4 keeps a node's children in one cache line
+/// @tparam TCompare strict weak ordering on priorities
+template <class TPriority, class TIndex = std::uint32_t, std::size_t D = 4,
+          class TCompare = std::less<TPriority>>
+class IndexedDaryHeap {
+  static_assert(std::is_unsigned<TIndex>::value,
+                "ids must be an unsigned integer type");
+  static_assert(D >= 2, "heap arity must be at least 2");
+
+ public:
+  static constexpr TIndex kNotInHeap = std::numeric_limits<TIndex>::max();
+
+  /// @brief Constructs an empty heap for ids below capacity
+  explicit IndexedDaryHeap(std::size_t capacity = 0)
+      : positions(capacity, kNotInHeap) {}
+
+  /// @brief Grows the id space to at least capacity. Never shrinks.
+  void Reserve(std::size_t capacity) {
+    if (capacity > positions.size()) {
+      positions.resize(capacity, kNotInHeap);
+      heap.reserve(capacity);
+    }
+  }
+
+  /// @brief Gets the number of ids in the heap
+  std::size_t Size() const { return heap.size(); }
+
+  /// @brief Returns whether the heap is empty or not
+  bool Empty() const { return heap.empty(); }
+
+  /// @brief Gets the size of the id space
+  std::size_t Capacity() const { return positions.size(); }
+
+  /// @brief Returns whether id is currently in the heap
+  bool Contains(TIndex id) const {
+    return id < positions.size() && positions[id] != kNotInHeap;
+  }
+
+  /// @brief Gets the current priority of an id
+  /// @throws std::out_of_range if id is not in the heap
+  const TPriority& Priority(TIndex id) const {
+    CheckContained(id);
+    return heap[positions[id]].priority;
+  }
+
+  /// @brief Inserts an id. O(log_D n).
+  /// @throws std::out_of_range if id is outside the id space
+  /// @throws std::invalid_argument if id is already in the heap
+  void Push(TIndex id, TPriority priority) {
+    if (id >= positions.size()) {
+      throw std::out_of_range(fmt::format(
+          "id {} is out of bounds for heap of capacity {}", id,
+          positions.size()));
+    }
+    if (positions[id] != kNotInHeap) {
+      throw std::invalid_argument(
+          fmt::format("id {} is already in the heap", id));
+    }
+    heap.push_back(Entry{std::move(priority), id});
+    SiftUp(heap.size() - 1);
+  }
+
+  /// @brief Lowers the priority of an id already in the heap. O(log_D n).
+  /// @throws std::out_of_range if id is not in the heap
+  /// @throws std::invalid_argument if priority would increase
+  void DecreaseKey(TIndex id, TPriority priority) {
+    CheckContained(id);
+    auto pos = positions[id];
+    if (compare(heap[pos].priority, priority)) {
+      throw std::invalid_argument("DecreaseKey cannot increase a priority!");
+    }
+    heap[pos].priority = std::move(priority);
+    SiftUp(pos);
+  }
+
+  /// @brief Inserts id, or lowers its priority if it is already present and
+  /// the new one is smaller. The common relax step of graph searches.
+  /// @return true if the heap changed
+  bool PushOrDecrease(TIndex id, TPriority priority) {
+    if (!Contains(id)) {
+      Push(id, std::move(priority));
+      return true;
+    }
+    auto pos = positions[id];
+    if (!compare(priority, heap[pos].priority)) {
+      return false;
+    }
+    heap[pos].priority = std::move(priority);
+    SiftUp(pos);
+    return true;
+  }
+
+  /// @brief Gets the id with the smallest priority
+  /// @throws std::out_of_range if the heap is empty
+  TIndex Top() const {
+    CheckNotEmpty();
+    return heap.front().id;
+  }
+
+  /// @brief Gets the smallest priority
+  /// @throws std::out_of_range if the heap is empty
+  const TPriority& TopPriority() const {
+    CheckNotEmpty();
+    return heap.front().priority;
+  }
+
+  /// @brief Removes and returns the id with the smallest priority, along
+  /// with that priority. O(D log_D n).
+  /// @throws std::out_of_range if the heap is empty
+  std::pair<TIndex, TPriority> Pop() {
+    CheckNotEmpty();
+    auto top = std::move(heap.front());
+    positions[top.id] = kNotInHeap;
+    if (heap.size() > 1) {
+      heap.front() = std::move(heap.back());
+      heap.pop_back();
+      SiftDown(0);
+    } else {
+      heap.pop_back();
+    }
+    return {top.id, std::move(top.priority)};
+  }
+
+  /// @brief Removes every id. O(size), not O(capacity), and keeps the
+  /// allocation, so one heap can be reused across many searches.
+  void Clear() {
+    for (const auto& entry : heap) {
+      positions[entry.id] = kNotInHeap;
+    }
+    heap.clear();
+  }
+
+ private:
+  struct Entry {
+    TPriority priority;
+    TIndex id;
+  };
+
+  std::vector<Entry> heap;
+  std::vector<TIndex> positions;
+  TCompare compare{};
+
+  void CheckContained(TIndex id) const {
+    if (!Contains(id)) {
+      throw std::out_of_range(fmt::format("id {} is not in the heap", id));
+    }
+  }
+
+  void CheckNotEmpty() const {
+    if (heap.empty()) {
+      throw std::out_of_range("heap is empty!");
+    }
+  }
+
+  void Place(std::size_t pos, Entry entry) {
+    positions[entry.id] = static_cast<TIndex>(pos);
+    heap[pos] = std::move(entry);
+  }
+
+  /// @brief Moves the entry at pos up until its parent is not larger
+  void SiftUp(std::size_t pos) {
+    auto entry = std::move(heap[pos]);
+    while (pos > 0) {
+      auto parent = (pos - 1) / D;
+      if (!compare(entry.priority, heap[parent].priority)) {
+        break;
+      }
+      Place(pos, std::move(heap[parent]));
+      pos = parent;
+    }
+    Place(pos, std::move(entry));
+  }
+
+  /// @brief Moves the entry at pos down until no child is smaller
+  void SiftDown(std::size_t pos) {
+    auto entry = std::move(heap[pos]);
+    auto size = heap.size();
+    while (true) {
+      auto first_child = pos * D + 1;
+      if (first_child >= size) {
+        break;
+      }
+      auto last_child = std::min(first_child + D, size);
+      auto best = first_child;
+      for (auto child = first_child + 1; child < last_child; child++) {
+        if (compare(heap[child].priority, heap[best].priority)) {
+          best = child;
+        }
+      }
+      if (!compare(heap[best].priority, entry.priority)) {
+        break;
+      }
+      Place(pos, std::move(heap[best]));
+      pos = best;
+    }
+    Place(pos, std::move(entry));
+  }
+};
+
+}  // namespace nll
@@ -2,6 +2,8 @@
 
 #include <cstddef>
 #include <iterator>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
 #include <utility>
 
@@ -9,21 +11,41 @@
 
 namespace nll {
 
-/// @brief Sequence container with O(1) push/pop from front, O(1) push to back
-/// (tail optimization), and O(n) pop from back
+namespace detail {
+
+/// @brief Internal list node. The value is constructed separately through
+/// the list's allocator, so allocator-aware values (pmr strings, nested
+/// containers) get the list's allocator too.
 template <class T>
-class SinglyLinkedList {
- private:
-  /// @brief Internal list node class
-  struct ListNode {
+struct ListNode {
+  ListNode* next = nullptr;
+  union {
     T value;
-    ListNode* next;
-
-    template <class U>
-    explicit ListNode(U&& value)
-        : value(std::forward<U>(value)), next(nullptr){};
   };
 
+  ListNode() {}
+  ~ListNode() {}
+};
+
+template <class T, class TAllocator>
+using ListNodeAllocator = typename std::allocator_traits<
+    TAllocator>::template rebind_alloc<ListNode<T>>;
+
+}  // namespace detail
+
+/// @brief Sequence container with O(1) push/pop from front, O(1) push to back
+/// (tail optimization), and O(n) pop from back
+/// @tparam TAllocator allocates the nodes and constructs the values. It is
+/// held as a base class, so a stateless allocator adds no size.
+template <class T, class TAllocator = std::allocator<T>>
+class SinglyLinkedList
+    : private detail::ListNodeAllocator<T, TAllocator> {
+ private:
+  using ListNode = detail::ListNode<T>;
+  using NodeAllocator = detail::ListNodeAllocator<T, TAllocator>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+  using ValueTraits = std::allocator_traits<TAllocator>;
+
   ListNode* head = nullptr;
 
   ListNode* tail = nullptr;
@@ -64,11 +86,90 @@ class SinglyLinkedList {
     };
 
    private:
+    friend class SinglyLinkedList;
+
     ListNode* ptr = nullptr;
   };
 
+  using allocator_type = TAllocator;
+
+  SinglyLinkedList() = default;
+
+  explicit SinglyLinkedList(const TAllocator& allocator)
+      : NodeAllocator(allocator) {}
+
+  SinglyLinkedList(const SinglyLinkedList& other)
+      : SinglyLinkedList(other,
+                         ValueTraits::select_on_container_copy_construction(
+                             other.get_allocator())) {}
+
+  SinglyLinkedList(const SinglyLinkedList& other, const TAllocator& allocator)
+      : NodeAllocator(allocator) {
+    for (auto* node = other.head; node; node = node->next) {
+      PushBack(node->value);
+    }
+  }
+
+  SinglyLinkedList(SinglyLinkedList&& other) noexcept
+      : NodeAllocator(std::move(other.Allocator())) {
+    Steal(other);
+  }
+
+  SinglyLinkedList(SinglyLinkedList&& other, const TAllocator& allocator)
+      : NodeAllocator(allocator) {
+    if (get_allocator() == other.get_allocator()) {
+      Steal(other);
+    } else {
+      for (auto* node = other.head; node; node = node->next) {
+        PushBack(std::move(node->value));
+      }
+    }
+  }
+
+  /// @brief Copies the elements of other. The allocator is only replaced if
+  /// it propagates on copy assignment, which pmr allocators do not.
+  SinglyLinkedList& operator=(const SinglyLinkedList& other) {
+    if (this == &other) {
+      return *this;
+    }
+    Clear();
+    if constexpr (ValueTraits::propagate_on_container_copy_assignment::value) {
+      Allocator() = other.Allocator();
+    }
+    for (auto* node = other.head; node; node = node->next) {
+      PushBack(node->value);
+    }
+    return *this;
+  }
+
+  /// @brief Takes the nodes of other when the allocators allow it, and
+  /// moves the elements one by one into this list's allocator otherwise
+  SinglyLinkedList& operator=(SinglyLinkedList&& other) noexcept(
+      ValueTraits::propagate_on_container_move_assignment::value ||
+      ValueTraits::is_always_equal::value) {
+    if (this == &other) {
+      return *this;
+    }
+    Clear();
+    if constexpr (ValueTraits::propagate_on_container_move_assignment::value) {
+      Allocator() = std::move(other.Allocator());
+      Steal(other);
+    } else if (get_allocator() == other.get_allocator()) {
+      Steal(other);
+    } else {
+      for (auto* node = other.head; node; node = node->next) {
+        PushBack(std::move(node->value));
+      }
+      other.Clear();
+    }
+    return *this;
+  }
+
   ~SinglyLinkedList() { Clear(); }
 
+  /// @brief Gets the allocator nodes and values come from
+  TAllocator get_allocator() const { return TAllocator(Allocator()); }
+
   Iterator begin() { return Iterator(head); }
 
   Iterator end() { return Iterator(nullptr); }
@@ -79,18 +180,26 @@ class SinglyLinkedList {
 
   /// @brief Gets the current size of the list
   /// @return The current number of items in the list
-  std::size_t Size() { return size; }
+  std::size_t Size() const { return size; }
 
   /// @brief Returns whether the list is empty or not
   /// @return true if the list if empty
-  bool Empty() { return Size() == 0; }
+  bool Empty() const { return Size() == 0; }
+
+  /// @brief Calls visit on every element from front to back, read-only
+  template <class TVisitor>
+  void ForEach(TVisitor&& visit) const {
+    for (const ListNode* node = head; node; node = node->next) {
+      visit(static_cast<const T&>(node->value));
+    }
+  }
 
   /// @brief Deletes all elements from the list
   void Clear() {
     while (head) {
       auto old_head = head;
       head = old_head->next;
-      delete old_head;
+      DestroyNode(old_head);
     }
     head = nullptr;
     tail = nullptr;
@@ -125,7 +234,7 @@ class SinglyLinkedList {
   /// @param value the value to push
   template <class U>
   void PushFront(U&& value) {
-    ListNode* newNode = new ListNode(std::forward<U>(value));
+    ListNode* newNode = CreateNode(std::forward<U>(value));
     newNode->next = head;
     head = newNode;
     if (!tail) {
@@ -162,12 +271,12 @@ class SinglyLinkedList {
   T PopFront() {
     if (head) {
       auto old_head = head;
-      auto val = old_head->value;
+      auto val = std::move(old_head->value);
       if (tail == head) {
         tail = nullptr;
       }
       head = head->next;
-      delete old_head;
+      DestroyNode(old_head);
       size--;
       return val;
     }
@@ -189,10 +298,10 @@ class SinglyLinkedList {
         lastNode = currentNode;
         currentNode = currentNode->next;
       }
-      auto val = currentNode->value;
+      auto val = std::move(currentNode->value);
       lastNode->next = nullptr;
       tail = lastNode;
-      delete currentNode;
+      DestroyNode(currentNode);
       size--;
       return val;
     }
@@ -206,7 +315,7 @@ class SinglyLinkedList {
     if (!head) {
       return PushFront(std::forward<U>(value));
     }
-    auto newNode = new ListNode(std::forward<U>(value));
+    auto newNode = CreateNode(std::forward<U>(value));
     tail->next = newNode;
     tail = newNode;
     size++;
@@ -228,7 +337,7 @@ class SinglyLinkedList {
         if (currentNode == tail) {
           tail = lastNode;
         }
-        delete currentNode;
+        DestroyNode(currentNode);
         size--;
         return;
       }
@@ -258,7 +367,7 @@ class SinglyLinkedList {
         if (currentNode == tail) {
           tail = lastNode;
         }
-        delete currentNode;
+        DestroyNode(currentNode);
         size--;
         return;
       }
@@ -291,5 +400,48 @@ class SinglyLinkedList {
     // Finally, new head is previous node
     head = previous_node;
   }
+
+ private:
+  NodeAllocator& Allocator() { return *this; }
+
+  const NodeAllocator& Allocator() const { return *this; }
+
+  template <class... TArgs>
+  ListNode* CreateNode(TArgs&&... args) {
+    auto* node = NodeTraits::allocate(Allocator(), 1);
+    ::new (static_cast<void*>(node)) ListNode();
+    try {
+      TAllocator allocator(Allocator());
+      ValueTraits::construct(allocator, std::addressof(node->value),
+                             std::forward<TArgs>(args)...);
+    } catch (...) {
+      NodeTraits::deallocate(Allocator(), node, 1);
+      throw;
+    }
+    return node;
+  }
+
+  void DestroyNode(ListNode* node) {
+    TAllocator allocator(Allocator());
+    ValueTraits::destroy(allocator, std::addressof(node->value));
+    node->~ListNode();
+    NodeTraits::deallocate(Allocator(), node, 1);
+  }
+
+  void Steal(SinglyLinkedList& other) {
+    head = std::exchange(other.head, nullptr);
+    tail = std::exchange(other.tail, nullptr);
+    size = std::exchange(other.size, 0);
+  }
 };
+
+namespace pmr {
+
+/// @brief SinglyLinkedList drawing its nodes from a std::pmr::memory_resource
+template <class T>
+using SinglyLinkedList =
+    nll::SinglyLinkedList<T, std::pmr::polymorphic_allocator<T>>;
+
+}  // namespace pmr
+
 }  // namespace nll
\ No newline at end of file
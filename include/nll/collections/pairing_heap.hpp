@@ -0,0 +1,325 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace nll {
+
+namespace detail {
+
+/// @brief Internal pairing heap node: its leftmost child, its right
+/// sibling, and prev, which is the left sibling, or the parent for a
+/// leftmost child. The value is constructed separately through the heap's
+/// allocator, as for ListNode.
+template <class T>
+struct PairingNode {
+  PairingNode* child = nullptr;
+  PairingNode* sibling = nullptr;
+  PairingNode* prev = nullptr;
+  union {
+    T value;
+  };
+
+  PairingNode() {}
+  ~PairingNode() {}
+};
+
+template <class T, class TAllocator>
+using PairingNodeAllocator = typename std::allocator_traits<
+    TAllocator>::template rebind_alloc<PairingNode<T>>;
+
+}  // namespace detail
+
+/// @brief Pairing heap (Fredman et al. 1986): a heap-ordered tree of
+/// nodes with any number of children. Push, Meld and DecreaseKey just link
+/// two trees in O(1); Pop does the deferred work, melding the root's
+/// children pairwise left to right and then right to left, in O(log n)
+/// amortized. The best heap for meld-heavy use, and a fast DecreaseKey
+/// heap when ids are not dense enough for IndexedDaryHeap.
+/// @tparam T element type, smallest (per TCompare) on top
+/// @tparam TCompare strict weak ordering on elements
+/// @tparam TAllocator allocates the nodes and constructs the values
+template <class T, class TCompare = std::less<T>,
+          class TAllocator = std::allocator<T>>
+class PairingHeap
+    : private detail::PairingNodeAllocator<T, TAllocator> {
+  using Node = detail::PairingNode<T>;
+  using NodeAllocator = detail::PairingNodeAllocator<T, TAllocator>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+  using ValueTraits = std::allocator_traits<TAllocator>;
+
+  Node* root = nullptr;
+  std::size_t size = 0;
+  TCompare compare{};
+
+  NodeAllocator& Allocator() { return *this; }
+  const NodeAllocator& Allocator() const { return *this; }
+
+  template <class... TArgs>
+  Node* CreateNode(TArgs&&... args) {
+    auto* node = NodeTraits::allocate(Allocator(), 1);
+    NodeTraits::construct(Allocator(), node);
+    TAllocator value_allocator(Allocator());
+    try {
+      ValueTraits::construct(value_allocator, &node->value,
+                             std::forward<TArgs>(args)...);
+    } catch (...) {
+      NodeTraits::destroy(Allocator(), node);
+      NodeTraits::deallocate(Allocator(), node, 1);
+      throw;
+    }
+    return node;
+  }
+
+  void DestroyNode(Node* node) {
+    TAllocator value_allocator(Allocator());
+    ValueTraits::destroy(value_allocator, &node->value);
+    NodeTraits::destroy(Allocator(), node);
+    NodeTraits::deallocate(Allocator(), node, 1);
+  }
+
+  /// @brief Links two roots, the larger becoming the leftmost child of the
+  /// smaller
+  Node* Link(Node* a, Node* b) {
+    if (compare(b->value, a->value)) {
+      std::swap(a, b);
+    }
+    b->prev = a;
+    b->sibling = a->child;
+    if (a->child != nullptr) {
+      a->child->prev = b;
+    }
+    a->child = b;
+    return a;
+  }
+
+  /// @brief Melds a sibling list into one tree with the two pass rule. The
+  /// first pass threads its results onto a stack through sibling, so the
+  /// second pass walks them right to left without extra memory.
+  Node* MergePairs(Node* first) {
+    if (first == nullptr) {
+      return nullptr;
+    }
+    Node* stack = nullptr;
+    while (first != nullptr) {
+      auto* a = first;
+      auto* b = a->sibling;
+      first = b != nullptr ? b->sibling : nullptr;
+      a->sibling = a->prev = nullptr;
+      if (b != nullptr) {
+        b->sibling = b->prev = nullptr;
+        a = Link(a, b);
+      }
+      a->sibling = stack;
+      stack = a;
+    }
+    auto* result = stack;
+    stack = stack->sibling;
+    result->sibling = nullptr;
+    while (stack != nullptr) {
+      auto* next = stack->sibling;
+      stack->sibling = nullptr;
+      result = Link(result, stack);
+      stack = next;
+    }
+    return result;
+  }
+
+  void Steal(PairingHeap& other) {
+    root = other.root;
+    size = other.size;
+    other.root = nullptr;
+    other.size = 0;
+  }
+
+ public:
+  /// @brief Refers to an element for DecreaseKey. Stays valid until that
+  /// element is popped or the heap is cleared, and moves along when it is
+  /// melded into another heap.
+  class Handle {
+   public:
+    Handle() = default;
+
+    /// @brief Gets the element
+    const T& operator*() const { return node->value; }
+
+    const T* operator->() const { return &node->value; }
+
+    friend bool operator==(const Handle& a, const Handle& b) {
+      return a.node == b.node;
+    }
+
+    friend bool operator!=(const Handle& a, const Handle& b) {
+      return a.node != b.node;
+    }
+
+   private:
+    friend class PairingHeap;
+
+    explicit Handle(Node* node) : node(node) {}
+
+    Node* node = nullptr;
+  };
+
+  using allocator_type = TAllocator;
+
+  PairingHeap() = default;
+
+  explicit PairingHeap(const TAllocator& allocator)
+      : NodeAllocator(allocator) {}
+
+  // Not copyable: a handle could not tell which copy it refers to
+  PairingHeap(const PairingHeap&) = delete;
+  PairingHeap& operator=(const PairingHeap&) = delete;
+
+  PairingHeap(PairingHeap&& other) noexcept
+      : NodeAllocator(std::move(other.Allocator())) {
+    Steal(other);
+  }
+
+  /// @brief Takes the nodes of other. Both heaps must use equal allocators.
+  /// @throws std::invalid_argument if the allocators differ
+  PairingHeap& operator=(PairingHeap&& other) {
+    if (this == &other) {
+      return *this;
+    }
+    Clear();
+    if constexpr (ValueTraits::propagate_on_container_move_assignment::value) {
+      Allocator() = std::move(other.Allocator());
+    } else if (get_allocator() != other.get_allocator()) {
+      throw std::invalid_argument(
+          "cannot move between heaps with different allocators!");
+    }
+    Steal(other);
+    return *this;
+  }
+
+  ~PairingHeap() { Clear(); }
+
+  /// @brief Gets the allocator nodes and values come from
+  TAllocator get_allocator() const { return TAllocator(Allocator()); }
+
+  /// @brief Gets the number of elements
+  std::size_t Size() const { return size; }
+
+  /// @brief Returns whether the heap is empty or not
+  bool Empty() const { return size == 0; }
+
+  /// @brief Inserts a value. O(1).
+  /// @return a handle to the new element
+  template <class U>
+  Handle Push(U&& value) {
+    return Emplace(std::forward<U>(value));
+  }
+
+  /// @brief Constructs a value in place from args and inserts it. O(1).
+  /// @return a handle to the new element
+  template <class... TArgs>
+  Handle Emplace(TArgs&&... args) {
+    auto* node = CreateNode(std::forward<TArgs>(args)...);
+    root = root == nullptr ? node : Link(root, node);
+    size++;
+    return Handle(node);
+  }
+
+  /// @brief Gets the smallest element
+  /// @throws std::out_of_range if the heap is empty
+  const T& Top() const {
+    if (root == nullptr) {
+      throw std::out_of_range("heap is empty!");
+    }
+    return root->value;
+  }
+
+  /// @brief Removes the smallest element and returns it. O(log n)
+  /// amortized.
+  /// @throws std::out_of_range if the heap is empty
+  T Pop() {
+    if (root == nullptr) {
+      throw std::out_of_range("heap is empty!");
+    }
+    auto* old_root = root;
+    root = MergePairs(old_root->child);
+    size--;
+    auto value = std::move(old_root->value);
+    DestroyNode(old_root);
+    return value;
+  }
+
+  /// @brief Lowers the element handle refers to. The element is cut from
+  /// its parent and linked with the root. O(1), but pays off in later Pops.
+  /// @throws std::invalid_argument if value is larger than the element
+  void DecreaseKey(Handle handle, T value) {
+    auto* node = handle.node;
+    if (compare(node->value, value)) {
+      throw std::invalid_argument("DecreaseKey cannot increase a priority!");
+    }
+    node->value = std::move(value);
+    if (node == root) {
+      return;
+    }
+    if (node->prev->child == node) {
+      node->prev->child = node->sibling;
+    } else {
+      node->prev->sibling = node->sibling;
+    }
+    if (node->sibling != nullptr) {
+      node->sibling->prev = node->prev;
+    }
+    node->sibling = node->prev = nullptr;
+    root = Link(root, node);
+  }
+
+  /// @brief Moves every element of other into this heap in O(1), leaving
+  /// other empty. Handles into other stay valid and now refer into this
+  /// heap.
+  /// @throws std::invalid_argument if the allocators differ
+  void Meld(PairingHeap& other) {
+    if (this == &other || other.root == nullptr) {
+      return;
+    }
+    if (get_allocator() != other.get_allocator()) {
+      throw std::invalid_argument(
+          "cannot meld heaps with different allocators!");
+    }
+    root = root == nullptr ? other.root : Link(root, other.root);
+    size += other.size;
+    other.root = nullptr;
+    other.size = 0;
+  }
+
+  /// @brief Removes every element
+  void Clear() {
+    if (root == nullptr) {
+      return;
+    }
+    std::vector<Node*> pending{root};
+    while (!pending.empty()) {
+      auto* node = pending.back();
+      pending.pop_back();
+      for (auto* child = node->child; child != nullptr;
+           child = child->sibling) {
+        pending.push_back(child);
+      }
+      DestroyNode(node);
+    }
+    root = nullptr;
+    size = 0;
+  }
+};
+
+namespace pmr {
+
+/// @brief PairingHeap drawing its nodes from a std::pmr::memory_resource
+template <class T, class TCompare = std::less<T>>
+using PairingHeap =
+    nll::PairingHeap<T, TCompare, std::pmr::polymorphic_allocator<T>>;
+
+}  // namespace pmr
+
+}  // namespace nll
@@ -0,0 +1,738 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include "nll/collections/filter_common.hpp"
+
+namespace nll {
+
+namespace detail {
+
+/// @brief Node of a hash array mapped trie in the CHAMP layout (Steindorfer
+/// and Vinju, "Optimizing Hash-Array Mapped Tries for Fast and Lean
+/// Immutable JVM Collections"). Each of the 32 slots for the next 5 hash
+/// bits is empty, holds an entry inline (a datamap bit) or a child node (a
+/// nodemap bit). Entries and children are stored packed in slot order and
+/// found by the popcount of the map below the slot's bit, so a node only
+/// holds what it uses. Below the last hash bits, a node is a collision node
+/// with unordered entries and no maps.
+///
+/// A node is one allocation: the header, then its children, then its
+/// entries, each array sized exactly for the node. Adding or removing a
+/// slot therefore builds a new node, while updating a value or swapping a
+/// child can happen in place.
+///
+/// Nodes are shared between versions and reference counted. A node whose
+/// only reference comes from a node the caller owns exclusively is owned
+/// exclusively too, and may be edited in place.
+template <class TKey, class TValue>
+struct HamtNode {
+  using Entry = std::pair<TKey, TValue>;
+
+  std::atomic<std::uint32_t> refs{1};
+  std::uint32_t datamap = 0;
+  std::uint32_t nodemap = 0;
+  std::uint32_t num_children = 0;
+  /// @brief Entries constructed so far, all of them once the node is built
+  std::uint32_t num_entries = 0;
+
+  HamtNode(const HamtNode&) = delete;
+  HamtNode& operator=(const HamtNode&) = delete;
+
+  HamtNode** Children() {
+    return reinterpret_cast<HamtNode**>(reinterpret_cast<unsigned char*>(this) +
+                                        ChildrenOffset());
+  }
+
+  HamtNode* const* Children() const {
+    return const_cast<HamtNode*>(this)->Children();
+  }
+
+  Entry* Entries() {
+    return reinterpret_cast<Entry*>(reinterpret_cast<unsigned char*>(this) +
+                                    EntriesOffset(num_children));
+  }
+
+  const Entry* Entries() const {
+    return const_cast<HamtNode*>(this)->Entries();
+  }
+
+  std::span<HamtNode* const> ChildSpan() const {
+    return {Children(), num_children};
+  }
+
+  std::span<Entry> EntrySpan() { return {Entries(), num_entries}; }
+
+  std::span<const Entry> EntrySpan() const { return {Entries(), num_entries}; }
+
+  /// @brief Constructs the next entry in place
+  template <class... TArgs>
+  void EmplaceEntry(TArgs&&... args) {
+    new (Entries() + num_entries) Entry(std::forward<TArgs>(args)...);
+    num_entries++;
+  }
+
+  /// @brief Allocates a node with room for num_children children and
+  /// num_entries entries, then has fill(node) set the children and emplace
+  /// the entries. Children start out null, and a node fill throws out of
+  /// is released, so it only frees what was filled in.
+  template <class TFill>
+  static HamtNode* Build(std::uint32_t datamap, std::uint32_t nodemap,
+                         std::size_t num_children, std::size_t num_entries,
+                         TFill&& fill) {
+    auto bytes = EntriesOffset(num_children) + num_entries * sizeof(Entry);
+    auto* node = new (::operator new(bytes, std::align_val_t{kAlignment}))
+        HamtNode(datamap, nodemap, static_cast<std::uint32_t>(num_children));
+    std::fill_n(node->Children(), num_children, nullptr);
+    try {
+      fill(node);
+    } catch (...) {
+      Release(node);
+      throw;
+    }
+    return node;
+  }
+
+  /// @brief Copies the entries and shares the children
+  static HamtNode* Copy(const HamtNode& other) {
+    return Build(other.datamap, other.nodemap, other.num_children,
+                 other.num_entries, [&](HamtNode* node) {
+                   for (std::uint32_t i = 0; i < other.num_children; i++) {
+                     other.Children()[i]->Retain();
+                     node->Children()[i] = other.Children()[i];
+                   }
+                   for (const auto& entry : other.EntrySpan()) {
+                     node->EmplaceEntry(entry);
+                   }
+                 });
+  }
+
+  void Retain() { refs.fetch_add(1, std::memory_order_relaxed); }
+
+  /// @brief Returns whether the caller holds the only reference. Acquires,
+  /// so edits in place come after other threads are done reading.
+  bool Unique() const { return refs.load(std::memory_order_acquire) == 1; }
+
+  static void Release(HamtNode* node) {
+    if (node != nullptr &&
+        node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      for (auto* child : node->ChildSpan()) {
+        Release(child);
+      }
+      std::destroy_n(node->Entries(), node->num_entries);
+      node->~HamtNode();
+      ::operator delete(node, std::align_val_t{kAlignment});
+    }
+  }
+
+ private:
+  static constexpr std::size_t kAlignment =
+      std::max(alignof(HamtNode*), alignof(Entry));
+
+  static constexpr std::size_t AlignUp(std::size_t offset,
+                                       std::size_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+  }
+
+  static constexpr std::size_t ChildrenOffset() {
+    return AlignUp(sizeof(HamtNode), alignof(HamtNode*));
+  }
+
+  static constexpr std::size_t EntriesOffset(std::size_t num_children) {
+    return AlignUp(ChildrenOffset() + num_children * sizeof(HamtNode*),
+                   alignof(Entry));
+  }
+
+  HamtNode(std::uint32_t datamap, std::uint32_t nodemap,
+           std::uint32_t num_children)
+      : datamap(datamap), nodemap(nodemap), num_children(num_children) {}
+};
+
+}  // namespace detail
+
+template <class TKey, class TValue>
+class VersionedHashmap;
+
+/// @brief Persistent hash map: a hash array mapped trie (Bagwell 2001) whose
+/// updates copy only the path from the root to the changed entry, at most
+/// 13 nodes of 32 slots, and share everything else with the previous
+/// version. Every version stays valid and unchanged, so taking a snapshot
+/// is copying a pointer, and versions can be read from any number of
+/// threads. Lookups walk O(log32 n) nodes.
+///
+/// For bulk updates, a Transient edits the nodes it already copied in
+/// place instead of copying the path again on every change. To publish
+/// versions from a writer to concurrent readers, see VersionedHashmap.
+/// @tparam TKey key type, hashed with std::hash
+/// @tparam TValue value type
+template <class TKey, class TValue>
+class PersistentHashmap {
+  using Node = detail::HamtNode<TKey, TValue>;
+  using Entry = std::pair<TKey, TValue>;
+
+  static constexpr unsigned kBits = 5;
+  static constexpr unsigned kHashBits = 64;
+
+  Node* root = nullptr;
+  std::size_t size = 0;
+
+  PersistentHashmap(Node* root, std::size_t size) : root(root), size(size) {}
+
+  static std::uint64_t HashOf(const TKey& key) {
+    return detail::MixHash(std::hash<TKey>{}(key));
+  }
+
+  static std::uint32_t BitFor(std::uint64_t hash, unsigned shift) {
+    return std::uint32_t{1} << ((hash >> shift) & 31);
+  }
+
+  /// @brief Position of bit's entry or child among those packed for map
+  static std::size_t IndexOf(std::uint32_t map, std::uint32_t bit) {
+    return static_cast<std::size_t>(__builtin_popcount(map & (bit - 1)));
+  }
+
+  static Node* Editable(Node* node, bool unique) {
+    return unique ? node : Node::Copy(*node);
+  }
+
+  /// @brief Emplaces entry into node, moved out when the caller owns it
+  static void TakeEntry(Node* node, Entry& entry, bool unique) {
+    if (unique) {
+      node->EmplaceEntry(std::move_if_noexcept(entry));
+    } else {
+      node->EmplaceEntry(entry);
+    }
+  }
+
+  /// @brief Builds the node replacing node once slots move between its maps.
+  /// Slots set in both the old and new map keep their entry or child, moved
+  /// out of node when unique; the slot new to datamap takes *added and the
+  /// one new to nodemap takes added_child. node itself is left for the
+  /// caller to release.
+  static Node* Rebuild(Node* node, bool unique, std::uint32_t datamap,
+                       std::uint32_t nodemap, Entry* added,
+                       Node* added_child) {
+    return Node::Build(
+        datamap, nodemap, __builtin_popcount(nodemap),
+        __builtin_popcount(datamap), [&](Node* built) {
+          std::size_t i = 0;
+          for (auto map = nodemap; map != 0; map &= map - 1, i++) {
+            auto bit = map & (~map + 1);
+            if (node->nodemap & bit) {
+              auto& child = node->Children()[IndexOf(node->nodemap, bit)];
+              if (unique) {
+                built->Children()[i] = std::exchange(child, nullptr);
+              } else {
+                child->Retain();
+                built->Children()[i] = child;
+              }
+            } else {
+              built->Children()[i] = added_child;
+            }
+          }
+          for (auto map = datamap; map != 0; map &= map - 1) {
+            auto bit = map & (~map + 1);
+            if (node->datamap & bit) {
+              TakeEntry(built, node->Entries()[IndexOf(node->datamap, bit)],
+                        unique);
+            } else {
+              built->EmplaceEntry(std::move(*added));
+            }
+          }
+        });
+  }
+
+  static const TValue* FindIn(const Node* node, const TKey& key) {
+    auto hash = HashOf(key);
+    for (unsigned shift = 0; node != nullptr; shift += kBits) {
+      if (shift >= kHashBits) {
+        for (const auto& entry : node->EntrySpan()) {
+          if (entry.first == key) {
+            return &entry.second;
+          }
+        }
+        return nullptr;
+      }
+      auto bit = BitFor(hash, shift);
+      if (node->datamap & bit) {
+        const auto& entry = node->Entries()[IndexOf(node->datamap, bit)];
+        return entry.first == key ? &entry.second : nullptr;
+      }
+      if (!(node->nodemap & bit)) {
+        return nullptr;
+      }
+      node = node->Children()[IndexOf(node->nodemap, bit)];
+    }
+    return nullptr;
+  }
+
+  /// @brief Builds the subtrie holding two entries whose hashes agree below
+  /// shift
+  static Node* MakePair(Entry a, std::uint64_t a_hash, Entry b,
+                        std::uint64_t b_hash, unsigned shift) {
+    auto emplace_both = [&](Node* node) {
+      node->EmplaceEntry(std::move(a));
+      node->EmplaceEntry(std::move(b));
+    };
+    if (shift >= kHashBits) {
+      return Node::Build(0, 0, 0, 2, emplace_both);
+    }
+    auto a_bit = BitFor(a_hash, shift);
+    auto b_bit = BitFor(b_hash, shift);
+    if (a_bit == b_bit) {
+      return Node::Build(0, a_bit, 1, 0, [&](Node* node) {
+        node->Children()[0] = MakePair(std::move(a), a_hash, std::move(b),
+                                       b_hash, shift + kBits);
+      });
+    }
+    if (a_bit > b_bit) {
+      std::swap(a, b);
+    }
+    return Node::Build(a_bit | b_bit, 0, 0, 2, emplace_both);
+  }
+
+  /// @brief Puts updated in place of node's child at index
+  /// @return node, or the copy of it that holds updated
+  static Node* Replace(Node* node, bool unique, std::size_t index,
+                       Node* child, Node* updated) {
+    if (updated == child) {
+      return node;
+    }
+    auto* edited = Editable(node, unique);
+    Node::Release(edited->Children()[index]);
+    edited->Children()[index] = updated;
+    return edited;
+  }
+
+  /// @brief Sets key to value in the subtrie at node. Edits in place when
+  /// unique, that is when the caller owns node exclusively, and copies
+  /// otherwise.
+  /// @return node, or the node that replaces it
+  template <class U>
+  static Node* InsertInto(Node* node, bool unique, std::uint64_t hash,
+                          unsigned shift, const TKey& key, U&& value,
+                          bool& added) {
+    if (shift >= kHashBits) {
+      for (std::size_t i = 0; i < node->num_entries; i++) {
+        if (node->Entries()[i].first == key) {
+          auto* edited = Editable(node, unique);
+          edited->Entries()[i].second = std::forward<U>(value);
+          return edited;
+        }
+      }
+      auto* grown = Node::Build(0, 0, 0, node->num_entries + 1,
+                                [&](Node* built) {
+                                  for (auto& entry : node->EntrySpan()) {
+                                    TakeEntry(built, entry, unique);
+                                  }
+                                  built->EmplaceEntry(key,
+                                                      std::forward<U>(value));
+                                });
+      added = true;
+      return grown;
+    }
+    auto bit = BitFor(hash, shift);
+    if (node->datamap & bit) {
+      auto index = IndexOf(node->datamap, bit);
+      auto& entry = node->Entries()[index];
+      if (entry.first == key) {
+        auto* edited = Editable(node, unique);
+        edited->Entries()[index].second = std::forward<U>(value);
+        return edited;
+      }
+      // Two keys share the slot: push both down into a new child
+      auto existing_hash = HashOf(entry.first);
+      auto* child = MakePair(unique ? Entry(std::move(entry)) : Entry(entry),
+                             existing_hash, Entry(key, std::forward<U>(value)),
+                             hash, shift + kBits);
+      added = true;
+      return Rebuild(node, unique, node->datamap & ~bit, node->nodemap | bit,
+                     nullptr, child);
+    }
+    if (node->nodemap & bit) {
+      auto index = IndexOf(node->nodemap, bit);
+      auto* child = node->Children()[index];
+      auto* updated =
+          InsertInto(child, unique && child->Unique(), hash, shift + kBits,
+                     key, std::forward<U>(value), added);
+      return Replace(node, unique, index, child, updated);
+    }
+    Entry fresh(key, std::forward<U>(value));
+    added = true;
+    return Rebuild(node, unique, node->datamap | bit, node->nodemap, &fresh,
+                   nullptr);
+  }
+
+  /// @brief Removes key from the subtrie at node, editing in place when
+  /// unique. A child left with a single entry is pulled up into its parent,
+  /// so every trie of the same entries has the same shape.
+  /// @return node if key is absent, or the node that replaces it
+  static Node* EraseFrom(Node* node, bool unique, std::uint64_t hash,
+                         unsigned shift, const TKey& key, bool& removed) {
+    if (shift >= kHashBits) {
+      for (std::size_t i = 0; i < node->num_entries; i++) {
+        if (node->Entries()[i].first == key) {
+          auto* shrunk = Node::Build(
+              0, 0, 0, node->num_entries - 1, [&](Node* built) {
+                for (std::size_t j = 0; j < node->num_entries; j++) {
+                  if (j != i) {
+                    TakeEntry(built, node->Entries()[j], unique);
+                  }
+                }
+              });
+          removed = true;
+          return shrunk;
+        }
+      }
+      return node;
+    }
+    auto bit = BitFor(hash, shift);
+    if (node->datamap & bit) {
+      if (!(node->Entries()[IndexOf(node->datamap, bit)].first == key)) {
+        return node;
+      }
+      removed = true;
+      return Rebuild(node, unique, node->datamap & ~bit, node->nodemap,
+                     nullptr, nullptr);
+    }
+    if (!(node->nodemap & bit)) {
+      return node;
+    }
+    auto index = IndexOf(node->nodemap, bit);
+    auto* child = node->Children()[index];
+    auto* updated = EraseFrom(child, unique && child->Unique(), hash,
+                              shift + kBits, key, removed);
+    if (!removed || updated->nodemap != 0 || updated->num_entries != 1) {
+      return Replace(node, unique, index, child, updated);
+    }
+    // updated is either child edited in place or a fresh node, ours alone
+    // either way, so its last entry can be moved out. The child goes with
+    // node, which the caller releases.
+    auto entry = std::move(updated->Entries()[0]);
+    if (updated != child) {
+      Node::Release(updated);
+    }
+    return Rebuild(node, unique, node->datamap | bit, node->nodemap & ~bit,
+                   &entry, nullptr);
+  }
+
+  /// @brief Sets key in the trie at root, in place as far as unique allows
+  template <class U>
+  static void InsertAt(Node*& root, std::size_t& size, bool unique,
+                       const TKey& key, U&& value) {
+    if (root == nullptr) {
+      root = Node::Build(0, 0, 0, 0, [](Node*) {});
+      unique = true;
+    }
+    bool added = false;
+    auto* updated = InsertInto(root, unique, HashOf(key), 0, key,
+                               std::forward<U>(value), added);
+    if (updated != root) {
+      Node::Release(root);
+      root = updated;
+    }
+    size += added;
+  }
+
+  static bool EraseAt(Node*& root, std::size_t& size, bool unique,
+                      const TKey& key) {
+    if (root == nullptr) {
+      return false;
+    }
+    bool removed = false;
+    auto* updated = EraseFrom(root, unique, HashOf(key), 0, key, removed);
+    if (updated != root) {
+      Node::Release(root);
+      root = updated;
+    }
+    if (root->num_entries == 0 && root->num_children == 0) {
+      Node::Release(root);
+      root = nullptr;
+    }
+    size -= removed;
+    return removed;
+  }
+
+  template <class TVisitor>
+  static void ForEachIn(const Node* node, TVisitor& visit) {
+    for (const auto& entry : node->EntrySpan()) {
+      visit(entry.first, entry.second);
+    }
+    for (const auto* child : node->ChildSpan()) {
+      ForEachIn(child, visit);
+    }
+  }
+
+  friend class VersionedHashmap<TKey, TValue>;
+
+ public:
+  class Transient;
+
+  /// @brief Empty map
+  PersistentHashmap() = default;
+
+  /// @brief Shares other's trie, O(1)
+  PersistentHashmap(const PersistentHashmap& other)
+      : root(other.root), size(other.size) {
+    if (root != nullptr) {
+      root->Retain();
+    }
+  }
+
+  PersistentHashmap(PersistentHashmap&& other) noexcept
+      : root(std::exchange(other.root, nullptr)),
+        size(std::exchange(other.size, 0)) {}
+
+  PersistentHashmap& operator=(PersistentHashmap other) noexcept {
+    std::swap(root, other.root);
+    std::swap(size, other.size);
+    return *this;
+  }
+
+  ~PersistentHashmap() { Node::Release(root); }
+
+  /// @brief Gets the number of entries
+  std::size_t Size() const { return size; }
+
+  /// @brief Returns whether the map is empty or not
+  bool Empty() const { return size == 0; }
+
+  /// @brief Finds the value of key
+  /// @return the value, or nullptr if the key is absent
+  const TValue* Find(const TKey& key) const { return FindIn(root, key); }
+
+  /// @brief Checks if a key exists in the map
+  bool Contains(const TKey& key) const { return Find(key) != nullptr; }
+
+  /// @brief Gets the value of key
+  /// @throws std::out_of_range if the key is not found
+  const TValue& Get(const TKey& key) const {
+    if (auto* value = Find(key)) {
+      return *value;
+    }
+    throw std::out_of_range("key not found!");
+  }
+
+  /// @brief Returns a new version with key set to value, leaving this one
+  /// unchanged. O(log32 n) new nodes.
+  template <class U>
+  PersistentHashmap Insert(const TKey& key, U&& value) const {
+    PersistentHashmap result(*this);
+    InsertAt(result.root, result.size, false, key, std::forward<U>(value));
+    return result;
+  }
+
+  /// @brief Returns a new version without key, leaving this one unchanged
+  PersistentHashmap Erase(const TKey& key) const {
+    PersistentHashmap result(*this);
+    EraseAt(result.root, result.size, false, key);
+    return result;
+  }
+
+  /// @brief Starts a batch of updates from this version
+  Transient AsTransient() const { return Transient(*this); }
+
+  /// @brief Calls visit(key, value) on every entry, in hash order
+  template <class TVisitor>
+  void ForEach(TVisitor&& visit) const {
+    if (root != nullptr) {
+      ForEachIn(root, visit);
+    }
+  }
+
+  /// @brief Batch-mutable view of a PersistentHashmap. Updates copy shared
+  /// nodes like the persistent ones, but edit nodes only this transient
+  /// references in place, so a batch of n updates copies each touched node
+  /// once rather than n times. Versions taken with Persistent() stay
+  /// unchanged by later edits, since they make the nodes shared again.
+  /// Not thread safe.
+  class Transient {
+   public:
+    /// @brief Starts from an empty map
+    Transient() = default;
+
+    /// @brief Starts from a version, sharing its trie until edited
+    explicit Transient(const PersistentHashmap& map)
+        : root(map.root), size(map.size) {
+      if (root != nullptr) {
+        root->Retain();
+      }
+    }
+
+    Transient(Transient&& other) noexcept
+        : root(std::exchange(other.root, nullptr)),
+          size(std::exchange(other.size, 0)) {}
+
+    Transient& operator=(Transient&& other) noexcept {
+      std::swap(root, other.root);
+      std::swap(size, other.size);
+      return *this;
+    }
+
+    Transient(const Transient&) = delete;
+    Transient& operator=(const Transient&) = delete;
+
+    ~Transient() { Node::Release(root); }
+
+    std::size_t Size() const { return size; }
+
+    bool Empty() const { return size == 0; }
+
+    const TValue* Find(const TKey& key) const { return FindIn(root, key); }
+
+    bool Contains(const TKey& key) const { return Find(key) != nullptr; }
+
+    /// @brief Sets key to value
+    template <class U>
+    void Insert(const TKey& key, U&& value) {
+      InsertAt(root, size, root != nullptr && root->Unique(), key,
+               std::forward<U>(value));
+    }
+
+    /// @brief Removes key
+    /// @return true if the key was present
+    bool Erase(const TKey& key) {
+      return EraseAt(root, size, root != nullptr && root->Unique(), key);
+    }
+
+    /// @brief Gets the current contents as a version, O(1)
+    PersistentHashmap Persistent() const {
+      if (root != nullptr) {
+        root->Retain();
+      }
+      return PersistentHashmap(root, size);
+    }
+
+   private:
+    Node* root = nullptr;
+    std::size_t size = 0;
+  };
+};
+
+/// @brief Holds the current version of a PersistentHashmap for one or more
+/// writers and any number of readers. Snapshot() is lock-free: the version
+/// pointer shares one atomic word with a count of readers between loading
+/// it and taking a reference (a split reference count, as in Williams, "C++
+/// Concurrency in Action", 7.2.4). Replacing the version turns those
+/// pending borrows into references, so the old version lives until its last
+/// reader lets go. Writers are serialized by a mutex, and each publishes a
+/// whole new version, so readers never see half of a batch.
+///
+/// The pointer takes the low 48 bits of the word, which holds for user
+/// space addresses on x86-64 and AArch64, and the borrow count the other
+/// 16, so at most 65535 threads can be inside Snapshot() at once.
+template <class TKey, class TValue>
+class VersionedHashmap {
+  struct Version {
+    std::atomic<std::uint32_t> refs{1};
+    PersistentHashmap<TKey, TValue> map;
+
+    explicit Version(PersistentHashmap<TKey, TValue> map)
+        : map(std::move(map)) {}
+  };
+
+  static constexpr unsigned kPointerBits = 48;
+  static constexpr std::uint64_t kPointerMask =
+      (std::uint64_t{1} << kPointerBits) - 1;
+  static constexpr std::uint64_t kBorrow = std::uint64_t{1} << kPointerBits;
+
+  mutable std::atomic<std::uint64_t> current{0};
+  std::mutex writer;
+
+  static Version* VersionOf(std::uint64_t word) {
+    return reinterpret_cast<Version*>(word & kPointerMask);
+  }
+
+  static void Release(Version* version) {
+    if (version->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete version;
+    }
+  }
+
+  /// @brief Publishes map, the writer lock held
+  void Store(PersistentHashmap<TKey, TValue> map) {
+    auto* version = new Version(std::move(map));
+    auto address = reinterpret_cast<std::uintptr_t>(version);
+    if (address & ~kPointerMask) {
+      delete version;
+      throw std::runtime_error("version address does not fit in 48 bits!");
+    }
+    auto old = current.exchange(address, std::memory_order_acq_rel);
+    if (auto* previous = VersionOf(old)) {
+      // Borrows of the old word become references
+      previous->refs.fetch_add(static_cast<std::uint32_t>(old >> kPointerBits),
+                               std::memory_order_relaxed);
+      Release(previous);
+    }
+  }
+
+  /// @brief Gets the current version, the writer lock held
+  const PersistentHashmap<TKey, TValue>& Current() const {
+    return VersionOf(current.load(std::memory_order_acquire))->map;
+  }
+
+ public:
+  /// @brief Starts with an empty map
+  VersionedHashmap() { Store({}); }
+
+  /// @brief Starts with map
+  explicit VersionedHashmap(PersistentHashmap<TKey, TValue> map) {
+    Store(std::move(map));
+  }
+
+  VersionedHashmap(const VersionedHashmap&) = delete;
+  VersionedHashmap& operator=(const VersionedHashmap&) = delete;
+
+  ~VersionedHashmap() { Release(VersionOf(current.load())); }
+
+  /// @brief Gets the current version, which stays readable and unchanged
+  /// however the map is updated afterwards. Lock-free, and O(1).
+  PersistentHashmap<TKey, TValue> Snapshot() const {
+    auto word = current.fetch_add(kBorrow, std::memory_order_acquire) + kBorrow;
+    auto* version = VersionOf(word);
+    auto map = version->map;
+    // Give the borrow back, unless a writer replaced the version meanwhile
+    // and turned the borrow into a reference to drop instead
+    while (true) {
+      if (VersionOf(word) != version) {
+        Release(version);
+        break;
+      }
+      if (current.compare_exchange_weak(word, word - kBorrow,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+        break;
+      }
+    }
+    return map;
+  }
+
+  /// @brief Replaces the current version with map
+  void Publish(PersistentHashmap<TKey, TValue> map) {
+    std::lock_guard<std::mutex> lock(writer);
+    Store(std::move(map));
+  }
+
+  /// @brief Applies a batch of updates to the current version through a
+  /// Transient and publishes the result as one new version
+  /// @param edit called with a PersistentHashmap::Transient&
+  template <class TEdit>
+  void Update(TEdit&& edit) {
+    std::lock_guard<std::mutex> lock(writer);
+    auto transient = Current().AsTransient();
+    edit(transient);
+    Store(transient.Persistent());
+  }
+};
+
+}  // namespace nll
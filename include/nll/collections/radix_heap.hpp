@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+namespace nll {
+
+/// @brief Monotone radix heap (Ahuja et al. 1990) for unsigned integer
+/// keys: every pushed key must be at least the last popped one, which is
+/// always true of Dijkstra's algorithm and event simulations. Bucket 0
+/// holds keys equal to the last popped key, and bucket b > 0 those whose
+/// highest bit differing from it is bit b-1. When bucket 0 runs dry, the
+/// first nonempty bucket's minimum becomes the new last key and its entries
+/// are spread over lower buckets. Each entry moves down at most once per
+/// bit, so Pop is O(log C) amortized for keys below C, with no comparisons
+/// between entries at all.
+/// @tparam TKey unsigned integer key type, smallest on top
+/// @tparam TValue value stored with each key
+template <class TKey, class TValue>
+class RadixHeap {
+  static_assert(std::is_unsigned<TKey>::value &&
+                    sizeof(TKey) <= sizeof(std::uint64_t),
+                "radix heap keys must be an unsigned integer type");
+
+  static constexpr std::size_t kBuckets =
+      std::numeric_limits<TKey>::digits + 1;
+
+  using Entry = std::pair<TKey, TValue>;
+
+  std::array<std::vector<Entry>, kBuckets> buckets;
+  TKey last = 0;
+  std::size_t size = 0;
+
+  std::size_t BucketFor(TKey key) const {
+    auto differing = static_cast<std::uint64_t>(key ^ last);
+    return differing == 0 ? 0 : 64 - __builtin_clzll(differing);
+  }
+
+  /// @brief Makes bucket 0 nonempty, assuming the heap is not
+  void Refill() {
+    if (!buckets[0].empty()) {
+      return;
+    }
+    std::size_t i = 1;
+    while (buckets[i].empty()) {
+      i++;
+    }
+    auto& source = buckets[i];
+    last = source.front().first;
+    for (const auto& entry : source) {
+      if (entry.first < last) {
+        last = entry.first;
+      }
+    }
+    // Every entry lands in a lower bucket, since they agree with the new
+    // minimum on all bits from i-1 up
+    for (auto& entry : source) {
+      buckets[BucketFor(entry.first)].push_back(std::move(entry));
+    }
+    source.clear();
+  }
+
+  void CheckNotEmpty() const {
+    if (size == 0) {
+      throw std::out_of_range("heap is empty!");
+    }
+  }
+
+ public:
+  /// @brief Gets the number of entries
+  std::size_t Size() const { return size; }
+
+  /// @brief Returns whether the heap is empty or not
+  bool Empty() const { return size == 0; }
+
+  /// @brief Gets the last popped key, the smallest key Push accepts
+  TKey LastKey() const { return last; }
+
+  /// @brief Inserts a key with its value. O(1).
+  /// @throws std::invalid_argument if key is below the last popped key
+  template <class U>
+  void Push(TKey key, U&& value) {
+    if (key < last) {
+      throw std::invalid_argument(fmt::format(
+          "key {} is below the last popped key {}", key, last));
+    }
+    buckets[BucketFor(key)].emplace_back(key, std::forward<U>(value));
+    size++;
+  }
+
+  /// @brief Gets the smallest key. Not const, since it may redistribute a
+  /// bucket.
+  /// @throws std::out_of_range if the heap is empty
+  TKey TopKey() {
+    CheckNotEmpty();
+    Refill();
+    return last;
+  }
+
+  /// @brief Removes an entry with the smallest key and returns it. Entries
+  /// with equal keys come out in no particular order.
+  /// @throws std::out_of_range if the heap is empty
+  Entry Pop() {
+    CheckNotEmpty();
+    Refill();
+    auto entry = std::move(buckets[0].back());
+    buckets[0].pop_back();
+    size--;
+    return entry;
+  }
+
+  /// @brief Removes every entry and accepts any key again. Keeps the
+  /// buckets' storage.
+  void Clear() {
+    for (auto& bucket : buckets) {
+      bucket.clear();
+    }
+    last = 0;
+    size = 0;
+  }
+};
+
+}  // namespace nll
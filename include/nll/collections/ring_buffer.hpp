@@ -3,54 +3,70 @@
 #include <array>
 #include <cstddef>
 #include <stdexcept>
+#include <utility>
 
 namespace nll {
 
+/// @brief Fixed capacity FIFO queue overwriting its oldest element when full.
+/// Storage is inline, so the buffer never allocates and takes no allocator:
+/// it lives wherever its owner puts it, an arena included. One of the N
+/// slots always stays free to tell a full buffer from an empty one, so it
+/// holds N - 1 elements.
 template <class T, std::size_t N>
 class RingBuffer {
- private:
-  std::size_t start;
-  std::size_t end;
+  static_assert(N >= 2, "ring buffer needs at least two slots");
 
-  std::array<int, N> buffer;
+ private:
+  std::size_t start = 0;
+  std::size_t end = 0;
 
-  std::size_t buffer_size = N;
+  std::array<T, N> buffer{};
 
  public:
-  void Push(T i) {
-    buffer[end] = i;
-    end = (end + 1) % buffer_size;
+  /// @brief Appends an element, dropping the oldest one if the buffer is
+  /// full. Check Full first to apply backpressure instead.
+  void Push(T value) {
+    buffer[end] = std::move(value);
+    end = (end + 1) % N;
     if (end == start) {
-      ++start;
+      start = (start + 1) % N;
     }
   }
 
+  /// @throws std::out_of_range if the buffer is empty
   T Pop() {
     if (start == end) {
       throw std::out_of_range("ring buffer is empty!");
     }
     auto pos = start;
-    start = (start + 1) % buffer_size;
-    return buffer[pos];
+    start = (start + 1) % N;
+    return std::move(buffer[pos]);
   }
 
-  T Peek() {
+  /// @throws std::out_of_range if the buffer is empty
+  T Peek() const {
     if (start == end) {
       throw std::out_of_range("ring buffer is empty!");
     }
     return buffer[start];
   }
 
-  bool Empty() { return start == end; };
+  bool Empty() const { return start == end; };
+
+  /// @brief Returns whether the next Push would drop the oldest element
+  bool Full() const { return (end + 1) % N == start; }
 
   void Clear() { start = end = 0; }
 
-  std::size_t Size() {
+  std::size_t Size() const {
     if (end >= start) {
       return end - start;
     }
-    return (buffer_size - start) + end;
+    return (N - start) + end;
   }
+
+  /// @brief Gets the number of elements the buffer holds when full
+  static constexpr std::size_t Capacity() { return N - 1; }
 };
 
-}  // namespace nll
\ No newline at end of file
+}  // namespace nll
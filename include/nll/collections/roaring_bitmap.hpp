@@ -0,0 +1,459 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "nll/collections/filter_common.hpp"
+#include "nll/collections/roaring_container.hpp"
+
+namespace nll {
+
+/// @brief Compressed set of 32-bit integers (Chambi, Lemire et al., "Better
+/// bitmap performance with Roaring bitmaps"). Values are grouped by their
+/// high 16 bits; each group keeps its low 16 bits in a sorted array while
+/// sparse, a 65536-bit bitmap while dense, or a list of runs when
+/// RunOptimize finds that smaller. Dense sets of IDs cost a few bits each
+/// and sparse ones about two bytes, where a hash set costs tens of bytes.
+///
+/// Set operations work group by group and stay within the representations:
+/// bitmap pairs combine word by word, array pairs by merging or galloping.
+class RoaringBitmap {
+  using Container = detail::RoaringContainer;
+
+ public:
+  using value_type = std::uint32_t;
+
+  /// @brief Forward iterator visiting the values in increasing order
+  struct Iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::uint32_t;
+    using pointer = const std::uint32_t*;
+    using reference = std::uint32_t;
+
+    Iterator() = default;
+
+    reference operator*() const {
+      return (std::uint32_t{bitmap->keys[index]} << 16) | cursor.value;
+    }
+
+    Iterator& operator++() {
+      if (!bitmap->containers[index].Advance(cursor) &&
+          ++index < bitmap->containers.size()) {
+        cursor = bitmap->containers[index].Begin();
+      }
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    friend bool operator==(const Iterator& a, const Iterator& b) {
+      return a.bitmap == b.bitmap && a.index == b.index &&
+             (a.AtEnd() || a.cursor.value == b.cursor.value);
+    }
+    friend bool operator!=(const Iterator& a, const Iterator& b) {
+      return !(a == b);
+    }
+
+   private:
+    friend class RoaringBitmap;
+
+    Iterator(const RoaringBitmap* bitmap, std::size_t index)
+        : bitmap(bitmap), index(index) {
+      if (index < bitmap->containers.size()) {
+        cursor = bitmap->containers[index].Begin();
+      }
+    }
+
+    const RoaringBitmap* bitmap = nullptr;
+    std::size_t index = 0;
+    Container::Cursor cursor;
+
+    /// @brief Default constructed iterators count as past the end
+    bool AtEnd() const {
+      return bitmap == nullptr || index == bitmap->containers.size();
+    }
+  };
+
+  RoaringBitmap() = default;
+
+  RoaringBitmap(std::initializer_list<std::uint32_t> values)
+      : RoaringBitmap(values.begin(), values.end()) {}
+
+  template <class TIterator>
+  RoaringBitmap(TIterator first, TIterator last) {
+    for (; first != last; ++first) {
+      Add(*first);
+    }
+  }
+
+  /// @brief Adds a value
+  /// @return false if it was already there
+  bool Add(std::uint32_t value) {
+    auto index = FindOrCreate(High(value));
+    return containers[index].Add(Low(value));
+  }
+
+  /// @brief Adds every value from first to last, both included. Groups the
+  /// range covers completely become a single run.
+  void AddRange(std::uint32_t first, std::uint32_t last) {
+    if (first > last) {
+      throw std::invalid_argument(
+          fmt::format("range {}..{} is empty", first, last));
+    }
+    for (std::uint32_t high = High(first); high <= High(last); high++) {
+      auto low_first = high == High(first) ? Low(first) : 0u;
+      auto low_last = high == High(last) ? Low(last) : 0xffffu;
+      auto it = std::lower_bound(keys.begin(), keys.end(), high);
+      auto index = static_cast<std::size_t>(it - keys.begin());
+      if (it == keys.end() || *it != high) {
+        keys.insert(it, static_cast<std::uint16_t>(high));
+        containers.insert(containers.begin() + index,
+                          Container::FromRange(low_first, low_last));
+      } else {
+        containers[index].AddRange(low_first, low_last);
+      }
+    }
+  }
+
+  /// @brief Removes a value
+  /// @return false if it was not there
+  bool Remove(std::uint32_t value) {
+    auto index = Find(High(value));
+    if (index == keys.size() || !containers[index].Remove(Low(value))) {
+      return false;
+    }
+    if (containers[index].Empty()) {
+      keys.erase(keys.begin() + index);
+      containers.erase(containers.begin() + index);
+    }
+    return true;
+  }
+
+  bool Contains(std::uint32_t value) const {
+    auto index = Find(High(value));
+    return index != keys.size() && containers[index].Contains(Low(value));
+  }
+
+  /// @brief Gets the number of values
+  std::uint64_t Cardinality() const {
+    std::uint64_t cardinality = 0;
+    for (const auto& container : containers) {
+      cardinality += container.Cardinality();
+    }
+    return cardinality;
+  }
+
+  /// @brief Returns whether the set is empty or not
+  bool Empty() const { return containers.empty(); }
+
+  /// @brief Removes every value
+  void Clear() {
+    keys.clear();
+    containers.clear();
+  }
+
+  /// @brief Gets the number of values less than or equal to value
+  std::uint64_t Rank(std::uint32_t value) const {
+    std::uint64_t rank = 0;
+    for (std::size_t i = 0; i < keys.size() && keys[i] <= High(value); i++) {
+      rank += keys[i] < High(value) ? containers[i].Cardinality()
+                                    : containers[i].Rank(Low(value));
+    }
+    return rank;
+  }
+
+  /// @brief Gets the value with rank smaller values, so Select(0) is the
+  /// minimum
+  /// @throws std::out_of_range if rank is not below Cardinality()
+  std::uint32_t Select(std::uint64_t rank) const {
+    for (std::size_t i = 0; i < keys.size(); i++) {
+      if (rank < containers[i].Cardinality()) {
+        return (std::uint32_t{keys[i]} << 16) |
+               containers[i].Select(static_cast<std::uint32_t>(rank));
+      }
+      rank -= containers[i].Cardinality();
+    }
+    throw std::out_of_range("rank is past the last value!");
+  }
+
+  /// @throws std::out_of_range if the set is empty
+  std::uint32_t Minimum() const {
+    if (Empty()) {
+      throw std::out_of_range("empty bitmap has no minimum!");
+    }
+    return *begin();
+  }
+
+  /// @throws std::out_of_range if the set is empty
+  std::uint32_t Maximum() const {
+    if (Empty()) {
+      throw std::out_of_range("empty bitmap has no maximum!");
+    }
+    const auto& last = containers.back();
+    return (std::uint32_t{keys.back()} << 16) |
+           last.Select(last.Cardinality() - 1);
+  }
+
+  /// @brief Converts every group to whichever of array, bitmap or runs is
+  /// smallest. Worth calling once a set built value by value is complete.
+  /// @return whether any group is now stored as runs
+  bool RunOptimize() {
+    bool any_runs = false;
+    for (auto& container : containers) {
+      any_runs |= container.RunOptimize();
+    }
+    return any_runs;
+  }
+
+  /// @brief Gets the number of 65536-value groups holding values
+  std::size_t ContainerCount() const { return containers.size(); }
+
+  /// @brief Gets the bytes the set occupies, itself included
+  std::size_t MemoryBytes() const {
+    auto bytes = sizeof(*this) + keys.capacity() * sizeof(std::uint16_t) +
+                 containers.capacity() * sizeof(Container);
+    for (const auto& container : containers) {
+      bytes += container.MemoryBytes();
+    }
+    return bytes;
+  }
+
+  Iterator begin() const { return Iterator(this, 0); }
+
+  Iterator end() const { return Iterator(this, containers.size()); }
+
+  static RoaringBitmap Union(const RoaringBitmap& a, const RoaringBitmap& b) {
+    return Merge(a, b, true, true, Container::Union);
+  }
+
+  static RoaringBitmap Intersection(const RoaringBitmap& a,
+                                    const RoaringBitmap& b) {
+    return Merge(a, b, false, false, Container::Intersection);
+  }
+
+  /// @brief Values of a that are not in b
+  static RoaringBitmap Difference(const RoaringBitmap& a,
+                                  const RoaringBitmap& b) {
+    return Merge(a, b, true, false, Container::Difference);
+  }
+
+  RoaringBitmap& operator|=(const RoaringBitmap& other) {
+    return *this = Union(*this, other);
+  }
+
+  RoaringBitmap& operator&=(const RoaringBitmap& other) {
+    return *this = Intersection(*this, other);
+  }
+
+  RoaringBitmap& operator-=(const RoaringBitmap& other) {
+    return *this = Difference(*this, other);
+  }
+
+  friend RoaringBitmap operator|(const RoaringBitmap& a,
+                                 const RoaringBitmap& b) {
+    return Union(a, b);
+  }
+
+  friend RoaringBitmap operator&(const RoaringBitmap& a,
+                                 const RoaringBitmap& b) {
+    return Intersection(a, b);
+  }
+
+  friend RoaringBitmap operator-(const RoaringBitmap& a,
+                                 const RoaringBitmap& b) {
+    return Difference(a, b);
+  }
+
+  /// @brief Set equality, whatever representation each group uses
+  friend bool operator==(const RoaringBitmap& a, const RoaringBitmap& b) {
+    return a.keys == b.keys && a.containers == b.containers;
+  }
+
+  friend bool operator!=(const RoaringBitmap& a, const RoaringBitmap& b) {
+    return !(a == b);
+  }
+
+  /// @brief Encodes the set in the Roaring portable format
+  /// (github.com/RoaringBitmap/RoaringFormatSpec), which the Roaring
+  /// libraries for C, Java, Go and others read as well
+  std::vector<std::uint8_t> Serialize() const {
+    std::vector<std::uint8_t> bytes;
+    detail::ByteWriter writer(bytes);
+    auto size = containers.size();
+    bool has_runs = std::any_of(
+        containers.begin(), containers.end(), [](const Container& container) {
+          return container.GetKind() == Container::Kind::kRun;
+        });
+    if (has_runs) {
+      writer.Write(static_cast<std::uint16_t>(kCookie));
+      writer.Write(static_cast<std::uint16_t>(size - 1));
+      std::vector<std::uint8_t> run_flags((size + 7) / 8, 0);
+      for (std::size_t i = 0; i < size; i++) {
+        if (containers[i].GetKind() == Container::Kind::kRun) {
+          run_flags[i / 8] |= static_cast<std::uint8_t>(1 << (i % 8));
+        }
+      }
+      bytes.insert(bytes.end(), run_flags.begin(), run_flags.end());
+    } else {
+      writer.Write(kCookieNoRuns);
+      writer.Write(static_cast<std::uint32_t>(size));
+    }
+    for (std::size_t i = 0; i < size; i++) {
+      writer.Write(keys[i]);
+      writer.Write(
+          static_cast<std::uint16_t>(containers[i].Cardinality() - 1));
+    }
+    // Offsets of the container bodies, for readers that seek
+    auto offsets_at = bytes.size();
+    bool has_offsets = !has_runs || size >= kNoOffsetThreshold;
+    if (has_offsets) {
+      bytes.resize(bytes.size() + 4 * size);
+    }
+    for (std::size_t i = 0; i < size; i++) {
+      if (has_offsets) {
+        auto offset = static_cast<std::uint32_t>(bytes.size());
+        for (std::size_t b = 0; b < 4; b++) {
+          bytes[offsets_at + 4 * i + b] =
+              static_cast<std::uint8_t>(offset >> (8 * b));
+        }
+      }
+      containers[i].Write(writer);
+    }
+    return bytes;
+  }
+
+  /// @brief Decodes a set in the Roaring portable format
+  /// @throws std::invalid_argument if the bytes are not a valid bitmap
+  static RoaringBitmap Deserialize(const std::vector<std::uint8_t>& bytes) {
+    detail::ByteReader reader(bytes.data(), bytes.size());
+    auto cookie = reader.Read<std::uint32_t>();
+    std::size_t size = 0;
+    std::vector<std::uint8_t> run_flags;
+    bool has_offsets = true;
+    if ((cookie & 0xffff) == kCookie) {
+      size = (cookie >> 16) + 1;
+      run_flags.resize((size + 7) / 8);
+      for (auto& flags : run_flags) {
+        flags = reader.Read<std::uint8_t>();
+      }
+      has_offsets = size >= kNoOffsetThreshold;
+    } else if (cookie == kCookieNoRuns) {
+      size = reader.Read<std::uint32_t>();
+      if (size > 65536) {
+        throw std::invalid_argument("serialized bitmap is corrupt!");
+      }
+    } else {
+      throw std::invalid_argument("not a serialized roaring bitmap!");
+    }
+    RoaringBitmap bitmap;
+    std::vector<std::uint32_t> cardinalities(size);
+    bitmap.keys.resize(size);
+    for (std::size_t i = 0; i < size; i++) {
+      bitmap.keys[i] = reader.Read<std::uint16_t>();
+      cardinalities[i] = reader.Read<std::uint16_t>() + 1u;
+      if (i > 0 && bitmap.keys[i] <= bitmap.keys[i - 1]) {
+        throw std::invalid_argument("serialized bitmap is corrupt!");
+      }
+    }
+    if (has_offsets) {
+      for (std::size_t i = 0; i < size; i++) {
+        reader.Read<std::uint32_t>();
+      }
+    }
+    bitmap.containers.reserve(size);
+    for (std::size_t i = 0; i < size; i++) {
+      bool is_run = !run_flags.empty() && (run_flags[i / 8] >> (i % 8)) & 1;
+      bitmap.containers.push_back(
+          Container::Read(reader, is_run, cardinalities[i]));
+    }
+    if (!reader.AtEnd()) {
+      throw std::invalid_argument("serialized bitmap is corrupt!");
+    }
+    return bitmap;
+  }
+
+ private:
+  static constexpr std::uint32_t kCookieNoRuns = 12346;
+  static constexpr std::uint32_t kCookie = 12347;
+  /// @brief Bitmaps with runs and fewer containers omit the offsets
+  static constexpr std::size_t kNoOffsetThreshold = 4;
+
+  /// @brief The high 16 bits of every group, sorted
+  std::vector<std::uint16_t> keys;
+  /// @brief containers[i] holds the low 16 bits of values in group keys[i]
+  std::vector<Container> containers;
+
+  static std::uint32_t High(std::uint32_t value) { return value >> 16; }
+
+  static std::uint16_t Low(std::uint32_t value) {
+    return static_cast<std::uint16_t>(value);
+  }
+
+  std::size_t Find(std::uint32_t high) const {
+    auto it = std::lower_bound(keys.begin(), keys.end(), high);
+    return it != keys.end() && *it == high
+               ? static_cast<std::size_t>(it - keys.begin())
+               : keys.size();
+  }
+
+  std::size_t FindOrCreate(std::uint32_t high) {
+    auto it = std::lower_bound(keys.begin(), keys.end(), high);
+    auto index = static_cast<std::size_t>(it - keys.begin());
+    if (it == keys.end() || *it != high) {
+      keys.insert(it, static_cast<std::uint16_t>(high));
+      containers.insert(containers.begin() + index, Container());
+    }
+    return index;
+  }
+
+  /// @brief Walks the groups of a and b in key order, combining groups
+  /// present in both and copying those only in a or only in b when asked
+  template <class TCombine>
+  static RoaringBitmap Merge(const RoaringBitmap& a, const RoaringBitmap& b,
+                             bool keep_only_a, bool keep_only_b,
+                             TCombine combine) {
+    RoaringBitmap result;
+    std::size_t i = 0;
+    std::size_t j = 0;
+    auto append = [&result](std::uint16_t key, Container container) {
+      if (!container.Empty()) {
+        result.keys.push_back(key);
+        result.containers.push_back(std::move(container));
+      }
+    };
+    while (i < a.keys.size() || j < b.keys.size()) {
+      if (j == b.keys.size() ||
+          (i < a.keys.size() && a.keys[i] < b.keys[j])) {
+        if (keep_only_a) {
+          append(a.keys[i], a.containers[i]);
+        }
+        i++;
+      } else if (i == a.keys.size() || b.keys[j] < a.keys[i]) {
+        if (keep_only_b) {
+          append(b.keys[j], b.containers[j]);
+        }
+        j++;
+      } else {
+        append(a.keys[i], combine(a.containers[i], b.containers[j]));
+        i++;
+        j++;
+      }
+    }
+    return result;
+  }
+};
+
+}  // namespace nll
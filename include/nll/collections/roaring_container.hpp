@@ -0,0 +1,843 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+#include "nll/collections/filter_common.hpp"
+
+namespace nll {
+namespace detail {
+
+/// @brief Sets bits first..last, inclusive, of a 65536-bit bitmap
+inline void SetBits(std::uint64_t* words, std::uint32_t first,
+                    std::uint32_t last) {
+  auto first_word = first / 64;
+  auto last_word = last / 64;
+  auto first_mask = ~std::uint64_t{0} << (first % 64);
+  auto last_mask = ~std::uint64_t{0} >> (63 - last % 64);
+  if (first_word == last_word) {
+    words[first_word] |= first_mask & last_mask;
+    return;
+  }
+  words[first_word] |= first_mask;
+  std::fill(words + first_word + 1, words + last_word, ~std::uint64_t{0});
+  words[last_word] |= last_mask;
+}
+
+/// @brief Clears bits first..last, inclusive, of a 65536-bit bitmap
+inline void ClearBits(std::uint64_t* words, std::uint32_t first,
+                      std::uint32_t last) {
+  auto first_word = first / 64;
+  auto last_word = last / 64;
+  auto first_mask = ~std::uint64_t{0} << (first % 64);
+  auto last_mask = ~std::uint64_t{0} >> (63 - last % 64);
+  if (first_word == last_word) {
+    words[first_word] &= ~(first_mask & last_mask);
+    return;
+  }
+  words[first_word] &= ~first_mask;
+  std::fill(words + first_word + 1, words + last_word, std::uint64_t{0});
+  words[last_word] &= ~last_mask;
+}
+
+inline std::uint32_t PopCount(const std::vector<std::uint64_t>& words) {
+  std::uint32_t count = 0;
+  for (auto word : words) {
+    count += static_cast<std::uint32_t>(__builtin_popcountll(word));
+  }
+  return count;
+}
+
+/// @brief Writes the values in both sorted arrays to out, which must have
+/// room for min(a, b) + 8 values; returns how many it wrote. A small array
+/// gallops through a much larger one; arrays of similar size are merged,
+/// eight values against eight at a time with SSE4.2 string compares when
+/// they are enabled (Schlegel et al., "Fast Sorted-Set Intersection using
+/// SIMD Instructions").
+inline std::size_t IntersectSorted(const std::uint16_t* a, std::size_t size_a,
+                                   const std::uint16_t* b, std::size_t size_b,
+                                   std::uint16_t* out) {
+  if (size_a > size_b) {
+    std::swap(a, b);
+    std::swap(size_a, size_b);
+  }
+  std::size_t count = 0;
+  if (size_a * 64 < size_b) {
+    const auto* position = b;
+    const auto* end = b + size_b;
+    for (std::size_t i = 0; i < size_a && position != end; i++) {
+      // Exponential search for a bracket, then binary search inside it
+      std::size_t step = 1;
+      while (step < static_cast<std::size_t>(end - position) &&
+             position[step] < a[i]) {
+        step *= 2;
+      }
+      position = std::lower_bound(
+          position + step / 2,
+          position + std::min(step + 1, static_cast<std::size_t>(end -
+                                                                 position)),
+          a[i]);
+      if (position != end && *position == a[i]) {
+        out[count++] = a[i];
+      }
+    }
+    return count;
+  }
+  std::size_t i = 0;
+  std::size_t j = 0;
+#if defined(__SSE4_2__)
+  struct ShuffleTable {
+    std::uint8_t masks[256][16];
+  };
+  // masks[m] moves the 16-bit lanes set in m to the front
+  static constexpr ShuffleTable kShuffle = [] {
+    ShuffleTable table{};
+    for (int mask = 0; mask < 256; mask++) {
+      int byte = 0;
+      for (int lane = 0; lane < 8; lane++) {
+        if (mask & (1 << lane)) {
+          table.masks[mask][byte++] = static_cast<std::uint8_t>(2 * lane);
+          table.masks[mask][byte++] = static_cast<std::uint8_t>(2 * lane + 1);
+        }
+      }
+      while (byte < 16) {
+        table.masks[mask][byte++] = 0x80;
+      }
+    }
+    return table;
+  }();
+  constexpr std::size_t kLanes = 8;
+  auto blocks_a = size_a / kLanes * kLanes;
+  auto blocks_b = size_b / kLanes * kLanes;
+  if (blocks_a > 0 && blocks_b > 0) {
+    auto load = [](const std::uint16_t* values) {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+    };
+    auto block_a = load(a);
+    auto block_b = load(b);
+    while (true) {
+      // Bit k is set when lane k of block_a equals any lane of block_b
+      auto matches = _mm_cvtsi128_si32(_mm_cmpestrm(
+          block_b, kLanes, block_a, kLanes,
+          _SIDD_UWORD_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK));
+      auto shuffle = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(kShuffle.masks[matches]));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + count),
+                       _mm_shuffle_epi8(block_a, shuffle));
+      count += static_cast<std::size_t>(__builtin_popcount(matches));
+      auto max_a = a[i + kLanes - 1];
+      auto max_b = b[j + kLanes - 1];
+      if (max_a <= max_b) {
+        i += kLanes;
+        if (i == blocks_a) {
+          break;
+        }
+        block_a = load(a + i);
+      }
+      if (max_b <= max_a) {
+        j += kLanes;
+        if (j == blocks_b) {
+          break;
+        }
+        block_b = load(b + j);
+      }
+    }
+  }
+#endif
+  while (i < size_a && j < size_b) {
+    if (a[i] < b[j]) {
+      i++;
+    } else if (b[j] < a[i]) {
+      j++;
+    } else {
+      out[count++] = a[i];
+      i++;
+      j++;
+    }
+  }
+  return count;
+}
+
+/// @brief The low 16 bits of the values of a RoaringBitmap that share their
+/// high 16 bits, in whichever of three forms suits their density:
+///   - array: sorted values, for up to kMaxArraySize of them
+///   - bitmap: 65536 bits, for more
+///   - run: sorted, disjoint [start, last] intervals, for long stretches of
+///     consecutive values. Only RunOptimize and range insertion create runs.
+/// Empty containers are never kept by the bitmap.
+class RoaringContainer {
+ public:
+  enum class Kind : std::uint8_t { kArray, kBitmap, kRun };
+
+  /// @brief Arrays above this size would be larger than a bitmap
+  static constexpr std::uint32_t kMaxArraySize = 4096;
+  static constexpr std::size_t kBitmapWords = 65536 / 64;
+
+  /// @brief Where iteration is: the value, and its array or run index
+  struct Cursor {
+    std::uint32_t index = 0;
+    std::uint32_t value = 0;
+  };
+
+  /// @brief A container holding first..last, inclusive
+  static RoaringContainer FromRange(std::uint32_t first, std::uint32_t last) {
+    RoaringContainer container;
+    container.kind = Kind::kRun;
+    container.values = {static_cast<std::uint16_t>(first),
+                        static_cast<std::uint16_t>(last)};
+    container.cardinality = last - first + 1;
+    return container;
+  }
+
+  Kind GetKind() const { return kind; }
+
+  std::uint32_t Cardinality() const { return cardinality; }
+
+  bool Empty() const { return cardinality == 0; }
+
+  bool Contains(std::uint16_t value) const {
+    switch (kind) {
+      case Kind::kArray:
+        return std::binary_search(values.begin(), values.end(), value);
+      case Kind::kBitmap:
+        return (words[value / 64] >> (value % 64)) & 1;
+      case Kind::kRun: {
+        auto run = FindRun(value);
+        return run < RunCount() && RunStart(run) <= value;
+      }
+    }
+    return false;
+  }
+
+  /// @return whether value was not already there
+  bool Add(std::uint16_t value) {
+    switch (kind) {
+      case Kind::kArray: {
+        auto it = std::lower_bound(values.begin(), values.end(), value);
+        if (it != values.end() && *it == value) {
+          return false;
+        }
+        if (cardinality == kMaxArraySize) {
+          ConvertToBitmap();
+          return Add(value);
+        }
+        values.insert(it, value);
+        break;
+      }
+      case Kind::kBitmap: {
+        auto& word = words[value / 64];
+        auto bit = std::uint64_t{1} << (value % 64);
+        if (word & bit) {
+          return false;
+        }
+        word |= bit;
+        break;
+      }
+      case Kind::kRun:
+        if (Contains(value)) {
+          return false;
+        }
+        InsertRun(value, value);
+        return true;
+    }
+    cardinality++;
+    return true;
+  }
+
+  /// @brief Adds first..last, inclusive
+  void AddRange(std::uint32_t first, std::uint32_t last) {
+    if (kind == Kind::kRun) {
+      InsertRun(first, last);
+      return;
+    }
+    auto bits = ToWords();
+    SetBits(bits.data(), first, last);
+    *this = FromWords(std::move(bits));
+  }
+
+  /// @return whether value was there
+  bool Remove(std::uint16_t value) {
+    switch (kind) {
+      case Kind::kArray: {
+        auto it = std::lower_bound(values.begin(), values.end(), value);
+        if (it == values.end() || *it != value) {
+          return false;
+        }
+        values.erase(it);
+        break;
+      }
+      case Kind::kBitmap: {
+        auto& word = words[value / 64];
+        auto bit = std::uint64_t{1} << (value % 64);
+        if (!(word & bit)) {
+          return false;
+        }
+        word &= ~bit;
+        if (cardinality - 1 == kMaxArraySize) {
+          cardinality--;
+          *this = FromWords(std::move(words));
+          return true;
+        }
+        break;
+      }
+      case Kind::kRun: {
+        auto run = FindRun(value);
+        if (run == RunCount() || RunStart(run) > value) {
+          return false;
+        }
+        RemoveFromRun(run, value);
+        break;
+      }
+    }
+    cardinality--;
+    return true;
+  }
+
+  /// @brief Number of values less than or equal to value
+  std::uint32_t Rank(std::uint16_t value) const {
+    switch (kind) {
+      case Kind::kArray:
+        return static_cast<std::uint32_t>(
+            std::upper_bound(values.begin(), values.end(), value) -
+            values.begin());
+      case Kind::kBitmap: {
+        std::uint32_t rank = 0;
+        for (std::size_t w = 0; w < value / 64u; w++) {
+          rank += static_cast<std::uint32_t>(__builtin_popcountll(words[w]));
+        }
+        auto mask = ~std::uint64_t{0} >> (63 - value % 64);
+        return rank + static_cast<std::uint32_t>(
+                          __builtin_popcountll(words[value / 64] & mask));
+      }
+      case Kind::kRun: {
+        std::uint32_t rank = 0;
+        for (std::size_t run = 0; run < RunCount(); run++) {
+          if (RunStart(run) > value) {
+            break;
+          }
+          rank += std::min<std::uint32_t>(RunLast(run), value) -
+                  RunStart(run) + 1;
+        }
+        return rank;
+      }
+    }
+    return 0;
+  }
+
+  /// @brief The value with rank values smaller than it; rank must be below
+  /// Cardinality()
+  std::uint16_t Select(std::uint32_t rank) const {
+    switch (kind) {
+      case Kind::kArray:
+        return values[rank];
+      case Kind::kBitmap:
+        for (std::size_t w = 0;; w++) {
+          auto count =
+              static_cast<std::uint32_t>(__builtin_popcountll(words[w]));
+          if (rank < count) {
+            auto word = words[w];
+            for (; rank > 0; rank--) {
+              word &= word - 1;
+            }
+            return static_cast<std::uint16_t>(w * 64 + __builtin_ctzll(word));
+          }
+          rank -= count;
+        }
+      case Kind::kRun:
+        for (std::size_t run = 0;; run++) {
+          std::uint32_t length = RunLast(run) - RunStart(run) + 1u;
+          if (rank < length) {
+            return static_cast<std::uint16_t>(RunStart(run) + rank);
+          }
+          rank -= length;
+        }
+    }
+    return 0;
+  }
+
+  /// @brief Places the cursor on the smallest value; the container must
+  /// not be empty
+  Cursor Begin() const {
+    switch (kind) {
+      case Kind::kArray:
+        return {0, values[0]};
+      case Kind::kBitmap:
+        return {0, NextSetBit(0)};
+      case Kind::kRun:
+        return {0, values[0]};
+    }
+    return {};
+  }
+
+  /// @brief Moves the cursor to the next value
+  /// @return false if there is none
+  bool Advance(Cursor& cursor) const {
+    switch (kind) {
+      case Kind::kArray:
+        if (++cursor.index == values.size()) {
+          return false;
+        }
+        cursor.value = values[cursor.index];
+        return true;
+      case Kind::kBitmap:
+        cursor.value = NextSetBit(cursor.value + 1);
+        return cursor.value < 65536;
+      case Kind::kRun:
+        if (cursor.value < RunLast(cursor.index)) {
+          cursor.value++;
+          return true;
+        }
+        if (++cursor.index == RunCount()) {
+          return false;
+        }
+        cursor.value = RunStart(cursor.index);
+        return true;
+    }
+    return false;
+  }
+
+  /// @brief Switches to the form with the smallest serialized size
+  /// @return whether the container is now a run container
+  bool RunOptimize() {
+    auto runs = CountRuns();
+    auto run_bytes = 2 + 4 * std::size_t{runs};
+    auto plain_bytes = cardinality <= kMaxArraySize
+                           ? 2 * std::size_t{cardinality}
+                           : kBitmapWords * 8;
+    if (run_bytes < plain_bytes) {
+      if (kind != Kind::kRun) {
+        ConvertToRuns(runs);
+      }
+      return true;
+    }
+    if (kind == Kind::kRun) {
+      *this = FromWords(ToWords());
+    }
+    return false;
+  }
+
+  /// @brief Heap bytes held, not counting the container itself
+  std::size_t MemoryBytes() const {
+    return values.capacity() * sizeof(std::uint16_t) +
+           words.capacity() * sizeof(std::uint64_t);
+  }
+
+  /// @brief Set equality, whatever the forms of the two containers
+  friend bool operator==(const RoaringContainer& a,
+                         const RoaringContainer& b) {
+    if (a.cardinality != b.cardinality) {
+      return false;
+    }
+    if (a.kind == b.kind && a.kind != Kind::kRun) {
+      return a.values == b.values && a.words == b.words;
+    }
+    return a.ToArray() == b.ToArray();
+  }
+
+  friend bool operator!=(const RoaringContainer& a,
+                         const RoaringContainer& b) {
+    return !(a == b);
+  }
+
+  static RoaringContainer Union(const RoaringContainer& a,
+                                const RoaringContainer& b) {
+    if (a.kind == Kind::kArray && b.kind == Kind::kArray &&
+        a.cardinality + b.cardinality <= kMaxArraySize) {
+      RoaringContainer result;
+      result.values.reserve(a.cardinality + b.cardinality);
+      std::set_union(a.values.begin(), a.values.end(), b.values.begin(),
+                     b.values.end(), std::back_inserter(result.values));
+      result.cardinality = static_cast<std::uint32_t>(result.values.size());
+      return result;
+    }
+    if (a.kind == Kind::kRun && b.kind == Kind::kRun) {
+      auto result = a;
+      for (std::size_t run = 0; run < b.RunCount(); run++) {
+        result.InsertRun(b.RunStart(run), b.RunLast(run));
+      }
+      return result;
+    }
+    const auto& dense = b.kind == Kind::kBitmap ? b : a;
+    const auto& other = &dense == &a ? b : a;
+    auto bits = dense.ToWords();
+    switch (other.kind) {
+      case Kind::kArray:
+        for (auto value : other.values) {
+          bits[value / 64] |= std::uint64_t{1} << (value % 64);
+        }
+        break;
+      case Kind::kBitmap:
+        // A plain loop the compiler vectorizes to the widest enabled ISA
+        for (std::size_t w = 0; w < kBitmapWords; w++) {
+          bits[w] |= other.words[w];
+        }
+        break;
+      case Kind::kRun:
+        for (std::size_t run = 0; run < other.RunCount(); run++) {
+          SetBits(bits.data(), other.RunStart(run), other.RunLast(run));
+        }
+        break;
+    }
+    return FromWords(std::move(bits));
+  }
+
+  static RoaringContainer Intersection(const RoaringContainer& a,
+                                       const RoaringContainer& b) {
+    if (a.kind == Kind::kArray && b.kind == Kind::kArray) {
+      RoaringContainer result;
+      result.values.resize(std::min(a.cardinality, b.cardinality) + 8);
+      auto count = IntersectSorted(a.values.data(), a.values.size(),
+                                   b.values.data(), b.values.size(),
+                                   result.values.data());
+      result.values.resize(count);
+      result.values.shrink_to_fit();
+      result.cardinality = static_cast<std::uint32_t>(count);
+      return result;
+    }
+    if (a.kind == Kind::kArray || b.kind == Kind::kArray) {
+      const auto& array = a.kind == Kind::kArray ? a : b;
+      const auto& other = &array == &a ? b : a;
+      return array.Filtered([&other](auto value) {
+        return other.Contains(value);
+      });
+    }
+    if (a.kind == Kind::kRun && b.kind == Kind::kRun) {
+      RoaringContainer result;
+      result.kind = Kind::kRun;
+      std::size_t i = 0;
+      std::size_t j = 0;
+      while (i < a.RunCount() && j < b.RunCount()) {
+        auto start = std::max(a.RunStart(i), b.RunStart(j));
+        auto last = std::min(a.RunLast(i), b.RunLast(j));
+        if (start <= last) {
+          result.values.push_back(start);
+          result.values.push_back(last);
+          result.cardinality += last - start + 1u;
+        }
+        (a.RunLast(i) < b.RunLast(j) ? i : j)++;
+      }
+      return result;
+    }
+    auto bits = a.ToWords();
+    auto other = b.kind == Kind::kBitmap ? std::vector<std::uint64_t>()
+                                         : b.ToWords();
+    const auto& other_words = b.kind == Kind::kBitmap ? b.words : other;
+    for (std::size_t w = 0; w < kBitmapWords; w++) {
+      bits[w] &= other_words[w];
+    }
+    return FromWords(std::move(bits));
+  }
+
+  /// @brief Values of a that are not in b
+  static RoaringContainer Difference(const RoaringContainer& a,
+                                     const RoaringContainer& b) {
+    if (a.kind == Kind::kArray && b.kind == Kind::kArray) {
+      RoaringContainer result;
+      result.values.reserve(a.cardinality);
+      std::set_difference(a.values.begin(), a.values.end(), b.values.begin(),
+                          b.values.end(), std::back_inserter(result.values));
+      result.values.shrink_to_fit();
+      result.cardinality = static_cast<std::uint32_t>(result.values.size());
+      return result;
+    }
+    if (a.kind == Kind::kArray) {
+      return a.Filtered([&b](auto value) { return !b.Contains(value); });
+    }
+    auto bits = a.ToWords();
+    switch (b.kind) {
+      case Kind::kArray:
+        for (auto value : b.values) {
+          bits[value / 64] &= ~(std::uint64_t{1} << (value % 64));
+        }
+        break;
+      case Kind::kBitmap:
+        for (std::size_t w = 0; w < kBitmapWords; w++) {
+          bits[w] &= ~b.words[w];
+        }
+        break;
+      case Kind::kRun:
+        for (std::size_t run = 0; run < b.RunCount(); run++) {
+          ClearBits(bits.data(), b.RunStart(run), b.RunLast(run));
+        }
+        break;
+    }
+    return FromWords(std::move(bits));
+  }
+
+  /// @brief Appends the container body in the Roaring portable format
+  void Write(ByteWriter& writer) const {
+    switch (kind) {
+      case Kind::kArray:
+        for (auto value : values) {
+          writer.Write(value);
+        }
+        break;
+      case Kind::kBitmap:
+        for (auto word : words) {
+          writer.Write(word);
+        }
+        break;
+      case Kind::kRun:
+        writer.Write(static_cast<std::uint16_t>(RunCount()));
+        for (std::size_t run = 0; run < RunCount(); run++) {
+          writer.Write(RunStart(run));
+          writer.Write(static_cast<std::uint16_t>(RunLast(run) -
+                                                  RunStart(run)));
+        }
+        break;
+    }
+  }
+
+  /// @brief Reads a container body written by Write
+  /// @throws std::invalid_argument if it does not hold cardinality values
+  /// in the expected form
+  static RoaringContainer Read(ByteReader& reader, bool is_run,
+                               std::uint32_t cardinality) {
+    RoaringContainer container;
+    if (is_run) {
+      container.kind = Kind::kRun;
+      auto runs = reader.Read<std::uint16_t>();
+      std::uint32_t total = 0;
+      for (std::size_t run = 0; run < runs; run++) {
+        std::uint32_t start = reader.Read<std::uint16_t>();
+        std::uint32_t last = start + reader.Read<std::uint16_t>();
+        if (last > 0xffff || (run > 0 && start <= container.values.back())) {
+          throw std::invalid_argument("serialized bitmap is corrupt!");
+        }
+        if (run > 0 && start == container.values.back() + 1u) {
+          container.values.back() = static_cast<std::uint16_t>(last);
+        } else {
+          container.values.push_back(static_cast<std::uint16_t>(start));
+          container.values.push_back(static_cast<std::uint16_t>(last));
+        }
+        total += last - start + 1;
+      }
+      container.cardinality = total;
+    } else if (cardinality <= kMaxArraySize) {
+      container.values.resize(cardinality);
+      for (std::size_t i = 0; i < cardinality; i++) {
+        container.values[i] = reader.Read<std::uint16_t>();
+        if (i > 0 && container.values[i] <= container.values[i - 1]) {
+          throw std::invalid_argument("serialized bitmap is corrupt!");
+        }
+      }
+      container.cardinality = cardinality;
+    } else {
+      container.kind = Kind::kBitmap;
+      container.words.resize(kBitmapWords);
+      for (auto& word : container.words) {
+        word = reader.Read<std::uint64_t>();
+      }
+      container.cardinality = PopCount(container.words);
+    }
+    if (container.cardinality != cardinality) {
+      throw std::invalid_argument("serialized bitmap is corrupt!");
+    }
+    return container;
+  }
+
+ private:
+  Kind kind = Kind::kArray;
+  std::uint32_t cardinality = 0;
+  /// @brief Array: the sorted values. Run: start and last of every run.
+  std::vector<std::uint16_t> values;
+  /// @brief Bitmap: kBitmapWords words, bit v of the set being value v
+  std::vector<std::uint64_t> words;
+
+  /// @brief Picks the smaller of array and bitmap for a bitmap's contents
+  static RoaringContainer FromWords(std::vector<std::uint64_t> bits) {
+    RoaringContainer container;
+    container.cardinality = PopCount(bits);
+    if (container.cardinality > kMaxArraySize) {
+      container.kind = Kind::kBitmap;
+      container.words = std::move(bits);
+      return container;
+    }
+    container.values.reserve(container.cardinality);
+    for (std::size_t w = 0; w < kBitmapWords; w++) {
+      for (auto word = bits[w]; word != 0; word &= word - 1) {
+        container.values.push_back(
+            static_cast<std::uint16_t>(w * 64 + __builtin_ctzll(word)));
+      }
+    }
+    return container;
+  }
+
+  std::vector<std::uint64_t> ToWords() const {
+    if (kind == Kind::kBitmap) {
+      return words;
+    }
+    std::vector<std::uint64_t> bits(kBitmapWords, 0);
+    if (kind == Kind::kArray) {
+      for (auto value : values) {
+        bits[value / 64] |= std::uint64_t{1} << (value % 64);
+      }
+    } else {
+      for (std::size_t run = 0; run < RunCount(); run++) {
+        SetBits(bits.data(), RunStart(run), RunLast(run));
+      }
+    }
+    return bits;
+  }
+
+  std::vector<std::uint16_t> ToArray() const {
+    if (kind == Kind::kArray) {
+      return values;
+    }
+    std::vector<std::uint16_t> array;
+    array.reserve(cardinality);
+    auto cursor = Begin();
+    do {
+      array.push_back(static_cast<std::uint16_t>(cursor.value));
+    } while (Advance(cursor));
+    return array;
+  }
+
+  /// @brief Array container of the values of this array that pass keep
+  template <class TPredicate>
+  RoaringContainer Filtered(TPredicate keep) const {
+    RoaringContainer result;
+    result.values.reserve(cardinality);
+    std::copy_if(values.begin(), values.end(),
+                 std::back_inserter(result.values), keep);
+    result.values.shrink_to_fit();
+    result.cardinality = static_cast<std::uint32_t>(result.values.size());
+    return result;
+  }
+
+  void ConvertToBitmap() {
+    words = ToWords();
+    values.clear();
+    values.shrink_to_fit();
+    kind = Kind::kBitmap;
+  }
+
+  std::uint32_t CountRuns() const {
+    switch (kind) {
+      case Kind::kArray: {
+        std::uint32_t runs = cardinality > 0;
+        for (std::size_t i = 1; i < values.size(); i++) {
+          runs += values[i] != values[i - 1] + 1;
+        }
+        return runs;
+      }
+      case Kind::kBitmap: {
+        // A run starts at every set bit whose lower neighbour is clear
+        std::uint32_t runs = 0;
+        std::uint64_t carry = 0;
+        for (auto word : words) {
+          runs += static_cast<std::uint32_t>(
+              __builtin_popcountll(word & ~((word << 1) | carry)));
+          carry = word >> 63;
+        }
+        return runs;
+      }
+      case Kind::kRun:
+        return static_cast<std::uint32_t>(RunCount());
+    }
+    return 0;
+  }
+
+  void ConvertToRuns(std::uint32_t runs) {
+    std::vector<std::uint16_t> run_values;
+    run_values.reserve(2 * std::size_t{runs});
+    auto cursor = Begin();
+    do {
+      if (run_values.empty() || cursor.value != run_values.back() + 1u) {
+        run_values.push_back(static_cast<std::uint16_t>(cursor.value));
+        run_values.push_back(static_cast<std::uint16_t>(cursor.value));
+      } else {
+        run_values.back() = static_cast<std::uint16_t>(cursor.value);
+      }
+    } while (Advance(cursor));
+    values = std::move(run_values);
+    words.clear();
+    words.shrink_to_fit();
+    kind = Kind::kRun;
+  }
+
+  std::size_t RunCount() const { return values.size() / 2; }
+  std::uint16_t RunStart(std::size_t run) const { return values[2 * run]; }
+  std::uint16_t RunLast(std::size_t run) const { return values[2 * run + 1]; }
+
+  /// @brief Index of the first run whose last value is at least value
+  std::size_t FindRun(std::uint32_t value) const {
+    std::size_t low = 0;
+    std::size_t high = RunCount();
+    while (low < high) {
+      auto middle = (low + high) / 2;
+      if (RunLast(middle) < value) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    return low;
+  }
+
+  /// @brief Adds first..last, merging every run it overlaps or touches
+  void InsertRun(std::uint32_t first, std::uint32_t last) {
+    // Runs ending at first - 1 or later and starting at last + 1 or earlier
+    auto begin = FindRun(first == 0 ? 0 : first - 1);
+    auto end = begin;
+    while (end < RunCount() && RunStart(end) <= last + 1) {
+      end++;
+    }
+    if (begin < end) {
+      first = std::min<std::uint32_t>(first, RunStart(begin));
+      last = std::max<std::uint32_t>(last, RunLast(end - 1));
+      for (auto run = begin; run < end; run++) {
+        cardinality -= RunLast(run) - RunStart(run) + 1u;
+      }
+    }
+    values.erase(values.begin() + 2 * begin, values.begin() + 2 * end);
+    std::uint16_t run[] = {static_cast<std::uint16_t>(first),
+                           static_cast<std::uint16_t>(last)};
+    values.insert(values.begin() + 2 * begin, run, run + 2);
+    cardinality += last - first + 1;
+  }
+
+  void RemoveFromRun(std::size_t run, std::uint16_t value) {
+    auto& start = values[2 * run];
+    auto& last = values[2 * run + 1];
+    if (start == last) {
+      values.erase(values.begin() + 2 * run, values.begin() + 2 * run + 2);
+    } else if (value == start) {
+      start++;
+    } else if (value == last) {
+      last--;
+    } else {
+      std::uint16_t tail[] = {static_cast<std::uint16_t>(value + 1), last};
+      last = static_cast<std::uint16_t>(value - 1);
+      values.insert(values.begin() + 2 * run + 2, tail, tail + 2);
+    }
+  }
+
+  /// @brief First set bit at or after from, or 65536
+  std::uint32_t NextSetBit(std::uint32_t from) const {
+    if (from >= 65536) {
+      return 65536;
+    }
+    auto w = from / 64;
+    auto word = words[w] & (~std::uint64_t{0} << (from % 64));
+    while (word == 0) {
+      if (++w == kBitmapWords) {
+        return 65536;
+      }
+      word = words[w];
+    }
+    return static_cast<std::uint32_t>(w * 64 + __builtin_ctzll(word));
+  }
+};
+
+}  // namespace detail
+}  // namespace nll
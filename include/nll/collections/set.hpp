@@ -1,17 +1,58 @@
 #pragma once
 
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
 #include "nll/collections/hashmap.hpp"
+#include "nll/hash/hasher.hpp"
 
 namespace nll {
 
-class Set {
+/// @brief Set of strings
+/// @tparam TAllocator allocates the table, entries and stored strings
+/// @tparam THash hash of the strings, called with the stored strings and
+/// with std::string_view probes
+template <class TAllocator = std::allocator<char>,
+          class THash = hash::Hasher<std::string_view>>
+class BasicSet {
+  using CharAllocator = typename std::allocator_traits<
+      TAllocator>::template rebind_alloc<char>;
+  using String = std::basic_string<char, std::char_traits<char>, CharAllocator>;
+  using EntryAllocator = typename std::allocator_traits<
+      TAllocator>::template rebind_alloc<std::pair<String, bool>>;
+
  private:
-  Hashmap<std::string, std::string> hashmap;
+  Hashmap<String, bool, DefaultHashmapPolicy, EntryAllocator, THash> hashmap;
 
  public:
-  void Add(std::string key) { hashmap[key] = "exists"; }
+  using allocator_type = TAllocator;
+
+  BasicSet() = default;
+
+  explicit BasicSet(const TAllocator& allocator)
+      : hashmap(EntryAllocator(allocator)) {}
+
+  /// @brief Gets the allocator the set's memory comes from
+  TAllocator get_allocator() const { return hashmap.get_allocator(); }
 
-  bool Contains(std::string key) { return hashmap[key] == "exists"; }
+  void Add(std::string_view key) {
+    hashmap[String(key.data(), key.size(), hashmap.get_allocator())] = true;
+  }
+
+  /// @brief Checks for key without copying it; a custom THash must be
+  /// transparent, hashing a std::string_view like the stored string
+  bool Contains(std::string_view key) { return hashmap.Contains(key); }
 };
 
-}  // namespace nll
\ No newline at end of file
+using Set = BasicSet<>;
+
+namespace pmr {
+
+/// @brief Set drawing its memory from a std::pmr::memory_resource
+using Set = BasicSet<std::pmr::polymorphic_allocator<char>>;
+
+}  // namespace pmr
+
+}  // namespace nll
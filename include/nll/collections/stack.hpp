@@ -2,6 +2,8 @@
 
 #include <cstddef>
 #include <iterator>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -11,11 +13,21 @@
 namespace nll {
 
 /// @brief FIFO stack backed by a vector
-template <class T>
+/// @tparam TAllocator allocates the vector's storage
+template <class T, class TAllocator = std::allocator<T>>
 class Stack {
-  std::vector<T> stack;
+  std::vector<T, TAllocator> stack;
 
  public:
+  using allocator_type = TAllocator;
+
+  Stack() = default;
+
+  explicit Stack(const TAllocator& allocator) : stack(allocator) {}
+
+  /// @brief Gets the allocator the storage comes from
+  TAllocator get_allocator() const { return stack.get_allocator(); }
+
   /// @brief Push a value to the top of the stack
   /// @param value the value to push
   template <class U>
@@ -37,7 +49,7 @@ class Stack {
   /// @brief Peek at the value at the top of the stack
   /// @return the value at the top of the stack
   T Peek() {
-    if (stack.Empty()) {
+    if (stack.empty()) {
       throw std::out_of_range("stack is empty!");
     }
     return stack.back();
@@ -62,7 +74,7 @@ class Stack {
     using pointer = T*;
     using reference = T&;
 
-    explicit Iterator(typename std::vector<T>::reverse_iterator ptr)
+    explicit Iterator(typename std::vector<T, TAllocator>::reverse_iterator ptr)
         : ptr(ptr) {};
 
     reference operator*() const { return *ptr; };
@@ -89,7 +101,7 @@ class Stack {
     };
 
    private:
-    typename std::vector<T>::reverse_iterator ptr;
+    typename std::vector<T, TAllocator>::reverse_iterator ptr;
   };
 
   /// @brief Get an iterator to the beginning of the stack
@@ -109,4 +121,12 @@ class Stack {
   const Iterator cend() { return Iterator(stack.crend()); }
 };
 
+namespace pmr {
+
+/// @brief Stack drawing its storage from a std::pmr::memory_resource
+template <class T>
+using Stack = nll::Stack<T, std::pmr::polymorphic_allocator<T>>;
+
+}  // namespace pmr
+
 }  // namespace nll
\ No newline at end of file
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace nll {
+
+/// @brief Handle to a scheduled timer. Handles go stale once their timer
+/// fires or is cancelled, and cancelling a stale handle is a no-op, so
+/// callers may keep them around without tracking expiry.
+struct TimerId {
+  std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+  std::uint32_t generation = 0;
+
+  friend bool operator==(TimerId lhs, TimerId rhs) {
+    return lhs.index == rhs.index && lhs.generation == rhs.generation;
+  }
+};
+
+/// @brief Hierarchical hashed timer wheel (Varghese and Lauck) over integer
+/// ticks. Level L has 64 slots of 64^L ticks each; a timer sits on the
+/// lowest level whose slot still tells its deadline apart from now, and is
+/// cascaded one level down when time reaches its slot, so every timer moves
+/// at most 11 times whatever its delay. Slots are intrusive doubly linked
+/// lists over a node pool addressed by 32-bit index, which makes Schedule
+/// and Cancel O(1) and keeps Schedule free of allocations once the pool has
+/// grown (or been Reserved) to the number of live timers. Per level
+/// occupancy bitmasks let Advance jump straight to the next non-empty slot
+/// instead of stepping tick by tick.
+/// @tparam TPayload data handed back when the timer fires, default
+/// constructible and movable
+template <class TPayload>
+class TimerWheel {
+ public:
+  /// @brief Constructs an empty wheel whose clock reads now
+  explicit TimerWheel(std::uint64_t now = 0) : now(now) {
+    heads.fill(kNil);
+  }
+
+  /// @brief Grows the node pool to hold timers live timers without
+  /// allocating
+  void Reserve(std::size_t timers) { nodes.reserve(timers); }
+
+  /// @brief Gets the number of pending timers
+  std::size_t Size() const { return size; }
+
+  /// @brief Returns whether no timer is pending
+  bool Empty() const { return size == 0; }
+
+  /// @brief Gets the current tick
+  std::uint64_t Now() const { return now; }
+
+  /// @brief Schedules payload to fire delay ticks from now. A delay of 0 is
+  /// rounded up to 1, as the current tick has already been processed.
+  /// @throws std::length_error if 2^32 - 1 timers are already pending
+  TimerId Schedule(std::uint64_t delay, TPayload payload) {
+    return ScheduleAt(Deadline(delay), std::move(payload));
+  }
+
+  /// @brief Schedules payload to fire at tick deadline, or on the next tick
+  /// if that has passed
+  /// @throws std::length_error if 2^32 - 1 timers are already pending
+  TimerId ScheduleAt(std::uint64_t deadline, TPayload payload) {
+    auto index = Allocate();
+    auto& node = nodes[index];
+    node.deadline = deadline > now ? deadline : now + 1;
+    node.payload = std::move(payload);
+    Link(index);
+    size++;
+    return TimerId{index, node.generation};
+  }
+
+  /// @brief Moves a pending timer to fire delay ticks from now, the usual
+  /// idle timeout refresh. O(1).
+  /// @return false if id is stale
+  bool Reschedule(TimerId id, std::uint64_t delay) {
+    if (!Pending(id)) {
+      return false;
+    }
+    Unlink(id.index);
+    nodes[id.index].deadline = Deadline(delay);
+    Link(id.index);
+    return true;
+  }
+
+  /// @brief Cancels a pending timer. O(1).
+  /// @return false if id is stale
+  bool Cancel(TimerId id) {
+    if (!Pending(id)) {
+      return false;
+    }
+    Unlink(id.index);
+    Release(id.index);
+    size--;
+    return true;
+  }
+
+  /// @brief Returns whether id's timer has neither fired nor been cancelled
+  bool Pending(TimerId id) const {
+    return id.index < nodes.size() &&
+           nodes[id.index].generation == id.generation &&
+           nodes[id.index].slot != kFree;
+  }
+
+  /// @brief Gets the deadline of a pending timer
+  /// @throws std::invalid_argument if id is stale
+  std::uint64_t DeadlineOf(TimerId id) const {
+    if (!Pending(id)) {
+      throw std::invalid_argument("timer is not pending!");
+    }
+    return nodes[id.index].deadline;
+  }
+
+  /// @brief Advances the clock by ticks, see AdvanceTo
+  template <class F>
+  std::size_t Advance(std::uint64_t ticks, F&& on_expire) {
+    return AdvanceTo(now + ticks, std::forward<F>(on_expire));
+  }
+
+  /// @brief Moves the clock forward to tick target, calling
+  /// on_expire(TPayload&) for every timer due by then in deadline order.
+  /// Timers sharing a deadline share a slot and fire as one batch: the slot
+  /// is detached whole, then drained. on_expire may schedule and cancel
+  /// timers, including others of the batch being drained; new timers are
+  /// due after the tick being processed, so they never fire in the same
+  /// batch. Targets at or before now are no-ops.
+  /// @return the number of timers fired
+  template <class F>
+  std::size_t AdvanceTo(std::uint64_t target, F&& on_expire) {
+    std::size_t fired = 0;
+    while (now < target) {
+      auto next = NextEvent();
+      if (next > target) {
+        now = target;
+        break;
+      }
+      now = next;
+      Cascade();
+      fired += Expire(on_expire);
+    }
+    return fired;
+  }
+
+  /// @brief Cancels every pending timer, keeping the pool's memory. May be
+  /// called from on_expire, which cancels the rest of the batch.
+  void Clear() {
+    for (std::uint32_t i = 0; i < nodes.size(); i++) {
+      if (nodes[i].slot != kFree) {
+        Release(i);
+      }
+    }
+    heads.fill(kNil);
+    occupied.fill(0);
+    expiring = kNil;
+    size = 0;
+  }
+
+ private:
+  static constexpr std::size_t kSlotBits = 6;
+  static constexpr std::size_t kSlots = std::size_t{1} << kSlotBits;
+  static constexpr std::size_t kLevels = (64 + kSlotBits - 1) / kSlotBits;
+  static constexpr std::uint32_t kNil =
+      std::numeric_limits<std::uint32_t>::max();
+  /// @brief Slot of a pooled node not holding a timer
+  static constexpr std::uint16_t kFree = kLevels * kSlots;
+  /// @brief Slot of a node in the batch being drained
+  static constexpr std::uint16_t kExpiring = kFree + 1;
+
+  struct Node {
+    std::uint64_t deadline = 0;
+    std::uint32_t prev = kNil;
+    std::uint32_t next = kNil;
+    std::uint32_t generation = 0;
+    std::uint16_t slot = kFree;
+    TPayload payload{};
+  };
+
+  std::vector<Node> nodes;
+  /// @brief Head of the free list threaded through Node::next
+  std::uint32_t free_head = kNil;
+  std::array<std::uint32_t, kLevels * kSlots> heads;
+  std::array<std::uint64_t, kLevels> occupied{};
+  /// @brief Head of the detached batch AdvanceTo is draining
+  std::uint32_t expiring = kNil;
+  std::uint64_t now;
+  std::size_t size = 0;
+
+  std::uint64_t Deadline(std::uint64_t delay) const {
+    return now + (delay == 0 ? 1 : delay);
+  }
+
+  std::uint32_t Allocate() {
+    if (free_head != kNil) {
+      auto index = free_head;
+      free_head = nodes[index].next;
+      return index;
+    }
+    if (nodes.size() >= kNil) {
+      throw std::length_error("timer wheel is full!");
+    }
+    nodes.emplace_back();
+    return static_cast<std::uint32_t>(nodes.size() - 1);
+  }
+
+  /// @brief Returns a node to the pool, making its handles stale
+  void Release(std::uint32_t index) {
+    auto& node = nodes[index];
+    node.payload = TPayload{};
+    node.slot = kFree;
+    node.generation++;
+    node.prev = kNil;
+    node.next = free_head;
+    free_head = index;
+  }
+
+  /// @brief Files a node under the highest 6-bit digit where its deadline
+  /// and now differ; a deadline equal to now lands in the slot about to be
+  /// drained
+  void Link(std::uint32_t index) {
+    auto& node = nodes[index];
+    auto differing = node.deadline ^ now;
+    std::size_t level =
+        differing < kSlots
+            ? 0
+            : static_cast<std::size_t>(63 - __builtin_clzll(differing)) /
+                  kSlotBits;
+    auto digit = (node.deadline >> (level * kSlotBits)) & (kSlots - 1);
+    auto slot = level * kSlots + digit;
+    node.slot = static_cast<std::uint16_t>(slot);
+    node.prev = kNil;
+    node.next = heads[slot];
+    if (node.next != kNil) {
+      nodes[node.next].prev = index;
+    }
+    heads[slot] = index;
+    occupied[level] |= std::uint64_t{1} << digit;
+  }
+
+  void Unlink(std::uint32_t index) {
+    auto& node = nodes[index];
+    if (node.next != kNil) {
+      nodes[node.next].prev = node.prev;
+    }
+    if (node.prev != kNil) {
+      nodes[node.prev].next = node.next;
+    } else if (node.slot == kExpiring) {
+      expiring = node.next;
+    } else {
+      heads[node.slot] = node.next;
+      if (node.next == kNil) {
+        occupied[node.slot / kSlots] &=
+            ~(std::uint64_t{1} << (node.slot % kSlots));
+      }
+    }
+  }
+
+  /// @brief Detaches a slot's whole list, returning its head
+  std::uint32_t Detach(std::size_t level, std::size_t digit) {
+    auto head = heads[level * kSlots + digit];
+    heads[level * kSlots + digit] = kNil;
+    occupied[level] &= ~(std::uint64_t{1} << digit);
+    return head;
+  }
+
+  /// @brief Finds the next tick where a slot is due: the first occupied
+  /// slot past now on the lowest level that has one. Slots on higher levels
+  /// all lie beyond the current block of the lower ones, so the lowest
+  /// level's wins.
+  std::uint64_t NextEvent() const {
+    for (std::size_t level = 0; level < kLevels; level++) {
+      auto shift = level * kSlotBits;
+      auto digit = (now >> shift) & (kSlots - 1);
+      auto later = digit == kSlots - 1
+                       ? 0
+                       : occupied[level] & (~std::uint64_t{0} << (digit + 1));
+      if (later == 0) {
+        continue;
+      }
+      auto block_bits = shift + kSlotBits;
+      auto base = block_bits >= 64 ? 0 : now >> block_bits << block_bits;
+      return base + (static_cast<std::uint64_t>(__builtin_ctzll(later))
+                     << shift);
+    }
+    return std::numeric_limits<std::uint64_t>::max();
+  }
+
+  /// @brief Refiles the timers of every level whose slot boundary now sits
+  /// on, top down, so a timer can fall through several levels in one go
+  void Cascade() {
+    std::size_t top = 0;
+    while (top + 1 < kLevels &&
+           (now & ((std::uint64_t{1} << ((top + 1) * kSlotBits)) - 1)) ==
+               0) {
+      top++;
+    }
+    for (std::size_t level = top; level > 0; level--) {
+      auto digit = (now >> (level * kSlotBits)) & (kSlots - 1);
+      auto index = Detach(level, digit);
+      while (index != kNil) {
+        auto next = nodes[index].next;
+        Link(index);
+        index = next;
+      }
+    }
+  }
+
+  /// @brief Drains the level 0 slot of now, whose timers are all due now
+  template <class F>
+  std::size_t Expire(F& on_expire) {
+    expiring = Detach(0, now & (kSlots - 1));
+    for (auto index = expiring; index != kNil; index = nodes[index].next) {
+      nodes[index].slot = kExpiring;
+    }
+    std::size_t fired = 0;
+    while (expiring != kNil) {
+      auto index = expiring;
+      expiring = nodes[index].next;
+      if (expiring != kNil) {
+        nodes[expiring].prev = kNil;
+      }
+      // Moved out first, the callback may grow the pool
+      auto payload = std::move(nodes[index].payload);
+      Release(index);
+      size--;
+      fired++;
+      on_expire(payload);
+    }
+    return fired;
+  }
+};
+
+}  // namespace nll
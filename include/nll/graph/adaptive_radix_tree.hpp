@@ -0,0 +1,982 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace nll {
+namespace binary_tree {
+
+namespace detail {
+
+/// @brief Prefix bytes an inner node stores. Longer prefixes keep their
+/// length but only the first bytes; the rest are checked against a leaf.
+constexpr std::size_t kRadixMaxPrefix = 8;
+
+enum class RadixNodeType : std::uint8_t {
+  kLeaf,
+  kNode4,
+  kNode16,
+  kNode48,
+  kNode256,
+};
+
+struct RadixNode {
+  RadixNodeType type;
+
+  explicit RadixNode(RadixNodeType type) : type(type) {}
+};
+
+/// @brief Fields every inner node shares. The compressed prefix holds the
+/// key bytes all keys below agree on, and terminal the leaf of the key that
+/// ends right after it, if any.
+struct RadixInner : RadixNode {
+  std::uint16_t count = 0;
+  std::uint32_t prefix_length = 0;
+  std::uint8_t prefix[kRadixMaxPrefix] = {};
+  RadixNode* terminal = nullptr;
+
+  explicit RadixInner(RadixNodeType type) : RadixNode(type) {}
+};
+
+/// @brief Up to 4 children with their key bytes, sorted
+struct RadixNode4 : RadixInner {
+  std::uint8_t keys[4] = {};
+  RadixNode* children[4] = {};
+
+  RadixNode4() : RadixInner(RadixNodeType::kNode4) {}
+};
+
+/// @brief Up to 16 children with their key bytes, sorted and searched with
+/// one SIMD compare
+struct RadixNode16 : RadixInner {
+  std::uint8_t keys[16] = {};
+  RadixNode* children[16] = {};
+
+  RadixNode16() : RadixInner(RadixNodeType::kNode16) {}
+};
+
+/// @brief Up to 48 children, found through a 256-entry index of slot + 1
+struct RadixNode48 : RadixInner {
+  std::uint8_t child_index[256] = {};
+  RadixNode* children[48] = {};
+
+  RadixNode48() : RadixInner(RadixNodeType::kNode48) {}
+};
+
+/// @brief A child pointer for every key byte
+struct RadixNode256 : RadixInner {
+  RadixNode* children[256] = {};
+
+  RadixNode256() : RadixInner(RadixNodeType::kNode256) {}
+};
+
+/// @brief Binary-comparable bytes of a key: the string itself, or the
+/// integer big-endian with the sign bit flipped, so byte order is key order
+template <class TKey, class = void>
+struct RadixKeyBytes;
+
+template <>
+struct RadixKeyBytes<std::string> {
+  std::string_view bytes;
+
+  explicit RadixKeyBytes(const std::string& key) : bytes(key) {}
+};
+
+template <class TKey>
+struct RadixKeyBytes<TKey,
+                     std::enable_if_t<std::is_integral<TKey>::value>> {
+  char storage[sizeof(TKey)];
+  std::string_view bytes;
+
+  explicit RadixKeyBytes(TKey key) : bytes(storage, sizeof(TKey)) {
+    using Unsigned = std::make_unsigned_t<TKey>;
+    auto bits = static_cast<Unsigned>(key);
+    if (std::is_signed<TKey>::value) {
+      bits ^= static_cast<Unsigned>(Unsigned{1} << (sizeof(TKey) * 8 - 1));
+    }
+    for (std::size_t i = 0; i < sizeof(TKey); i++) {
+      storage[i] = static_cast<char>(bits >> (8 * (sizeof(TKey) - 1 - i)));
+    }
+  }
+
+  RadixKeyBytes(const RadixKeyBytes&) = delete;
+  RadixKeyBytes& operator=(const RadixKeyBytes&) = delete;
+};
+
+inline std::uint8_t ByteAt(std::string_view bytes, std::size_t i) {
+  return static_cast<std::uint8_t>(bytes[i]);
+}
+
+inline RadixNode* const* FindChild(const RadixInner* node,
+                                   std::uint8_t byte) {
+  switch (node->type) {
+    case RadixNodeType::kNode4: {
+      auto* node4 = static_cast<const RadixNode4*>(node);
+      for (std::size_t i = 0; i < node4->count; i++) {
+        if (node4->keys[i] == byte) {
+          return &node4->children[i];
+        }
+      }
+      return nullptr;
+    }
+    case RadixNodeType::kNode16: {
+      auto* node16 = static_cast<const RadixNode16*>(node);
+#if defined(__SSE2__)
+      auto matches = _mm_cmpeq_epi8(
+          _mm_set1_epi8(static_cast<char>(byte)),
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(node16->keys)));
+      auto mask = static_cast<unsigned>(_mm_movemask_epi8(matches)) &
+                  ((1u << node16->count) - 1);
+      return mask != 0 ? &node16->children[__builtin_ctz(mask)] : nullptr;
+#else
+      for (std::size_t i = 0; i < node16->count; i++) {
+        if (node16->keys[i] == byte) {
+          return &node16->children[i];
+        }
+      }
+      return nullptr;
+#endif
+    }
+    case RadixNodeType::kNode48: {
+      auto* node48 = static_cast<const RadixNode48*>(node);
+      auto slot = node48->child_index[byte];
+      return slot != 0 ? &node48->children[slot - 1] : nullptr;
+    }
+    case RadixNodeType::kNode256: {
+      auto* node256 = static_cast<const RadixNode256*>(node);
+      return node256->children[byte] != nullptr ? &node256->children[byte]
+                                                : nullptr;
+    }
+    default:
+      return nullptr;
+  }
+}
+
+inline RadixNode** FindChild(RadixInner* node, std::uint8_t byte) {
+  return const_cast<RadixNode**>(
+      FindChild(static_cast<const RadixInner*>(node), byte));
+}
+
+/// @brief Calls visit(byte, child) on the children in key byte order until
+/// it returns false
+/// @return false if visit stopped the walk
+template <class TVisitor>
+bool VisitChildren(const RadixInner* node, TVisitor&& visit) {
+  switch (node->type) {
+    case RadixNodeType::kNode4: {
+      auto* node4 = static_cast<const RadixNode4*>(node);
+      for (std::size_t i = 0; i < node4->count; i++) {
+        if (!visit(node4->keys[i], node4->children[i])) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case RadixNodeType::kNode16: {
+      auto* node16 = static_cast<const RadixNode16*>(node);
+      for (std::size_t i = 0; i < node16->count; i++) {
+        if (!visit(node16->keys[i], node16->children[i])) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case RadixNodeType::kNode48: {
+      auto* node48 = static_cast<const RadixNode48*>(node);
+      for (unsigned byte = 0; byte < 256; byte++) {
+        auto slot = node48->child_index[byte];
+        if (slot != 0 && !visit(static_cast<std::uint8_t>(byte),
+                                node48->children[slot - 1])) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case RadixNodeType::kNode256: {
+      auto* node256 = static_cast<const RadixNode256*>(node);
+      for (unsigned byte = 0; byte < 256; byte++) {
+        auto* child = node256->children[byte];
+        if (child != nullptr &&
+            !visit(static_cast<std::uint8_t>(byte), child)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    default:
+      return true;
+  }
+}
+
+inline const RadixNode* FirstChild(const RadixInner* node) {
+  const RadixNode* first = nullptr;
+  VisitChildren(node, [&](std::uint8_t, const RadixNode* child) {
+    first = child;
+    return false;
+  });
+  return first;
+}
+
+inline void DeleteInner(RadixInner* node) {
+  switch (node->type) {
+    case RadixNodeType::kNode4:
+      delete static_cast<RadixNode4*>(node);
+      break;
+    case RadixNodeType::kNode16:
+      delete static_cast<RadixNode16*>(node);
+      break;
+    case RadixNodeType::kNode48:
+      delete static_cast<RadixNode48*>(node);
+      break;
+    case RadixNodeType::kNode256:
+      delete static_cast<RadixNode256*>(node);
+      break;
+    default:
+      break;
+  }
+}
+
+inline void CopyHeader(RadixInner* to, const RadixInner* from) {
+  to->prefix_length = from->prefix_length;
+  std::memcpy(to->prefix, from->prefix, kRadixMaxPrefix);
+  to->terminal = from->terminal;
+}
+
+/// @brief Inserts into sorted key and child arrays with room for one more
+inline void InsertSorted(std::uint8_t* keys, RadixNode** children,
+                         std::uint16_t& count, std::uint8_t byte,
+                         RadixNode* child) {
+  std::size_t position = 0;
+  while (position < count && keys[position] < byte) {
+    position++;
+  }
+  std::memmove(keys + position + 1, keys + position, count - position);
+  std::memmove(children + position + 1, children + position,
+               (count - position) * sizeof(RadixNode*));
+  keys[position] = byte;
+  children[position] = child;
+  count++;
+}
+
+/// @brief Adds a child under a byte the node does not have yet, growing the
+/// node into the next larger type when full
+/// @param slot the pointer to the node, replaced when it grows
+inline void AddChild(RadixNode*& slot, std::uint8_t byte, RadixNode* child) {
+  auto* inner = static_cast<RadixInner*>(slot);
+  switch (inner->type) {
+    case RadixNodeType::kNode4: {
+      auto* node = static_cast<RadixNode4*>(inner);
+      if (node->count < 4) {
+        InsertSorted(node->keys, node->children, node->count, byte, child);
+        return;
+      }
+      auto* grown = new RadixNode16();
+      CopyHeader(grown, node);
+      std::copy(node->keys, node->keys + 4, grown->keys);
+      std::copy(node->children, node->children + 4, grown->children);
+      grown->count = 4;
+      slot = grown;
+      delete node;
+      break;
+    }
+    case RadixNodeType::kNode16: {
+      auto* node = static_cast<RadixNode16*>(inner);
+      if (node->count < 16) {
+        InsertSorted(node->keys, node->children, node->count, byte, child);
+        return;
+      }
+      auto* grown = new RadixNode48();
+      CopyHeader(grown, node);
+      for (std::uint8_t i = 0; i < 16; i++) {
+        grown->child_index[node->keys[i]] = i + 1;
+        grown->children[i] = node->children[i];
+      }
+      grown->count = 16;
+      slot = grown;
+      delete node;
+      break;
+    }
+    case RadixNodeType::kNode48: {
+      auto* node = static_cast<RadixNode48*>(inner);
+      if (node->count < 48) {
+        std::uint8_t free_slot = 0;
+        while (node->children[free_slot] != nullptr) {
+          free_slot++;
+        }
+        node->children[free_slot] = child;
+        node->child_index[byte] = free_slot + 1;
+        node->count++;
+        return;
+      }
+      auto* grown = new RadixNode256();
+      CopyHeader(grown, node);
+      for (unsigned b = 0; b < 256; b++) {
+        if (node->child_index[b] != 0) {
+          grown->children[b] = node->children[node->child_index[b] - 1];
+        }
+      }
+      grown->count = 48;
+      slot = grown;
+      delete node;
+      break;
+    }
+    case RadixNodeType::kNode256: {
+      auto* node = static_cast<RadixNode256*>(inner);
+      node->children[byte] = child;
+      node->count++;
+      return;
+    }
+    default:
+      return;
+  }
+  AddChild(slot, byte, child);
+}
+
+/// @brief Replaces a Node4 left with a single member by that member. A
+/// lone inner child takes over the node's prefix and key byte in front of
+/// its own.
+inline void Collapse(RadixNode*& slot, RadixNode4* node) {
+  RadixNode* member;
+  if (node->count == 0) {
+    member = node->terminal;
+  } else {
+    member = node->children[0];
+    if (member->type != RadixNodeType::kLeaf) {
+      auto* child = static_cast<RadixInner*>(member);
+      std::uint8_t merged[kRadixMaxPrefix];
+      std::size_t stored = 0;
+      auto take = [&](std::uint8_t byte) {
+        if (stored < kRadixMaxPrefix) {
+          merged[stored++] = byte;
+        }
+      };
+      for (std::size_t i = 0;
+           i < std::min<std::size_t>(node->prefix_length, kRadixMaxPrefix);
+           i++) {
+        take(node->prefix[i]);
+      }
+      take(node->keys[0]);
+      for (std::size_t i = 0;
+           i < std::min<std::size_t>(child->prefix_length, kRadixMaxPrefix);
+           i++) {
+        take(child->prefix[i]);
+      }
+      child->prefix_length += node->prefix_length + 1;
+      std::memcpy(child->prefix, merged, stored);
+    }
+  }
+  slot = member;
+  delete node;
+}
+
+/// @brief Shrinks a node that lost a member into the next smaller type,
+/// with some hysteresis against flapping, or collapses a Node4 left with
+/// one member
+inline void Shrink(RadixNode*& slot) {
+  auto* inner = static_cast<RadixInner*>(slot);
+  switch (inner->type) {
+    case RadixNodeType::kNode4: {
+      auto* node = static_cast<RadixNode4*>(inner);
+      if (node->count + (node->terminal != nullptr ? 1 : 0) == 1) {
+        Collapse(slot, node);
+      }
+      return;
+    }
+    case RadixNodeType::kNode16: {
+      auto* node = static_cast<RadixNode16*>(inner);
+      if (node->count > 3) {
+        return;
+      }
+      auto* shrunk = new RadixNode4();
+      CopyHeader(shrunk, node);
+      std::copy(node->keys, node->keys + node->count, shrunk->keys);
+      std::copy(node->children, node->children + node->count,
+                shrunk->children);
+      shrunk->count = node->count;
+      slot = shrunk;
+      delete node;
+      return;
+    }
+    case RadixNodeType::kNode48: {
+      auto* node = static_cast<RadixNode48*>(inner);
+      if (node->count > 12) {
+        return;
+      }
+      auto* shrunk = new RadixNode16();
+      CopyHeader(shrunk, node);
+      for (unsigned b = 0; b < 256; b++) {
+        if (node->child_index[b] != 0) {
+          shrunk->keys[shrunk->count] = static_cast<std::uint8_t>(b);
+          shrunk->children[shrunk->count++] =
+              node->children[node->child_index[b] - 1];
+        }
+      }
+      slot = shrunk;
+      delete node;
+      return;
+    }
+    case RadixNodeType::kNode256: {
+      auto* node = static_cast<RadixNode256*>(inner);
+      if (node->count > 37) {
+        return;
+      }
+      auto* shrunk = new RadixNode48();
+      CopyHeader(shrunk, node);
+      for (unsigned b = 0; b < 256; b++) {
+        if (node->children[b] != nullptr) {
+          shrunk->children[shrunk->count] = node->children[b];
+          shrunk->child_index[b] = static_cast<std::uint8_t>(++shrunk->count);
+        }
+      }
+      slot = shrunk;
+      delete node;
+      return;
+    }
+    default:
+      return;
+  }
+}
+
+/// @brief Unlinks the child under byte, then shrinks the node if needed
+inline void RemoveChild(RadixNode*& slot, std::uint8_t byte) {
+  auto* inner = static_cast<RadixInner*>(slot);
+  auto remove_sorted = [&](std::uint8_t* keys, RadixNode** children) {
+    std::size_t position = 0;
+    while (keys[position] != byte) {
+      position++;
+    }
+    auto after = inner->count - position - 1;
+    std::memmove(keys + position, keys + position + 1, after);
+    std::memmove(children + position, children + position + 1,
+                 after * sizeof(RadixNode*));
+  };
+  switch (inner->type) {
+    case RadixNodeType::kNode4: {
+      auto* node = static_cast<RadixNode4*>(inner);
+      remove_sorted(node->keys, node->children);
+      break;
+    }
+    case RadixNodeType::kNode16: {
+      auto* node = static_cast<RadixNode16*>(inner);
+      remove_sorted(node->keys, node->children);
+      break;
+    }
+    case RadixNodeType::kNode48: {
+      auto* node = static_cast<RadixNode48*>(inner);
+      node->children[node->child_index[byte] - 1] = nullptr;
+      node->child_index[byte] = 0;
+      break;
+    }
+    case RadixNodeType::kNode256: {
+      static_cast<RadixNode256*>(inner)->children[byte] = nullptr;
+      break;
+    }
+    default:
+      return;
+  }
+  inner->count--;
+  Shrink(slot);
+}
+
+}  // namespace detail
+
+/// @brief Adaptive radix tree (Leis et al., "The Adaptive Radix Tree: ARTful
+/// Indexing for Main-Memory Databases", ICDE 2013): a trie over key bytes
+/// whose inner nodes come in four sizes, Node4 and Node16 with sorted key
+/// bytes (Node16 searched with one SSE2 compare), Node48 with a byte index
+/// and Node256 with a direct array, each grown or shrunk as children come
+/// and go. Chains of single-child nodes are compressed into a prefix on
+/// the next node (path compression), and a key with no other key below its
+/// branch is stored as a leaf right there (lazy expansion), so a lookup
+/// visits about one node per distinguishing byte and compares the whole
+/// key once, at the leaf.
+///
+/// Unlike a hash map, keys stay in order: Scan walks them from any lower
+/// bound and ScanPrefix walks those starting with a prefix, both without
+/// hashing or comparing whole keys. String keys may be prefixes of each
+/// other; the shorter one is kept on the inner node where it ends.
+/// @tparam TKey std::string or an integer type
+/// @tparam TValue mapped type
+template <class TKey, class TValue>
+class AdaptiveRadixTree {
+  static_assert(std::is_integral<TKey>::value ||
+                    std::is_same<TKey, std::string>::value,
+                "radix tree keys must be std::string or an integer type");
+
+  using Node = detail::RadixNode;
+  using Inner = detail::RadixInner;
+  using NodeType = detail::RadixNodeType;
+  using KeyBytes = detail::RadixKeyBytes<TKey>;
+
+  static constexpr std::size_t kMaxPrefix = detail::kRadixMaxPrefix;
+
+  struct Leaf : Node {
+    TKey key;
+    TValue value;
+
+    Leaf(TKey key, TValue value)
+        : Node(NodeType::kLeaf),
+          key(std::move(key)),
+          value(std::move(value)) {}
+  };
+
+  Node* root = nullptr;
+  std::size_t size = 0;
+
+  static void Destroy(Node* node) {
+    if (node == nullptr) {
+      return;
+    }
+    if (node->type == NodeType::kLeaf) {
+      delete static_cast<Leaf*>(node);
+      return;
+    }
+    auto* inner = static_cast<Inner*>(node);
+    Destroy(inner->terminal);
+    detail::VisitChildren(inner, [](std::uint8_t, Node* child) {
+      Destroy(child);
+      return true;
+    });
+    detail::DeleteInner(inner);
+  }
+
+  /// @brief Any leaf below node, all of which share node's whole prefix
+  static const Leaf* MinimumLeaf(const Node* node) {
+    while (node->type != NodeType::kLeaf) {
+      auto* inner = static_cast<const Inner*>(node);
+      node = inner->terminal != nullptr ? inner->terminal
+                                        : detail::FirstChild(inner);
+    }
+    return static_cast<const Leaf*>(node);
+  }
+
+  /// @brief Gets the whole prefix of node, which starts at key byte depth
+  static std::string FullPrefix(const Inner* node, std::size_t depth) {
+    if (node->prefix_length <= kMaxPrefix) {
+      return std::string(reinterpret_cast<const char*>(node->prefix),
+                         node->prefix_length);
+    }
+    KeyBytes leaf(MinimumLeaf(node)->key);
+    return std::string(leaf.bytes.substr(depth, node->prefix_length));
+  }
+
+  /// @brief Gets how many bytes of node's prefix match key from depth on,
+  /// reading the bytes the node does not store from a leaf
+  static std::size_t PrefixMismatch(const Inner* node, std::string_view key,
+                                    std::size_t depth) {
+    auto length = std::min<std::size_t>(node->prefix_length,
+                                        key.size() - depth);
+    auto stored = std::min(length, kMaxPrefix);
+    std::size_t i = 0;
+    for (; i < stored; i++) {
+      if (node->prefix[i] != detail::ByteAt(key, depth + i)) {
+        return i;
+      }
+    }
+    if (i < length) {
+      KeyBytes leaf(MinimumLeaf(node)->key);
+      for (; i < length; i++) {
+        if (leaf.bytes[depth + i] != key[depth + i]) {
+          return i;
+        }
+      }
+    }
+    return i;
+  }
+
+  /// @brief Hangs leaf off a node being built, under the byte after depth
+  /// or as its terminal if the key ends there
+  static void Attach(Node*& slot, std::string_view key, std::size_t depth,
+                     Leaf* leaf) {
+    if (key.size() == depth) {
+      static_cast<Inner*>(slot)->terminal = leaf;
+    } else {
+      detail::AddChild(slot, detail::ByteAt(key, depth), leaf);
+    }
+  }
+
+  /// @brief Attaches a new leaf for key. Reads its byte first, since bytes
+  /// may view the key the leaf takes.
+  static void AttachNew(Node*& slot, std::string_view bytes,
+                        std::size_t depth, TKey& key, TValue& value) {
+    if (bytes.size() == depth) {
+      static_cast<Inner*>(slot)->terminal =
+          new Leaf(std::move(key), std::move(value));
+    } else {
+      auto byte = detail::ByteAt(bytes, depth);
+      detail::AddChild(slot, byte, new Leaf(std::move(key), std::move(value)));
+    }
+  }
+
+  bool InsertAt(Node*& slot, std::string_view bytes, std::size_t depth,
+                TKey& key, TValue& value) {
+    if (slot == nullptr) {
+      slot = new Leaf(std::move(key), std::move(value));
+      return true;
+    }
+    if (slot->type == NodeType::kLeaf) {
+      auto* leaf = static_cast<Leaf*>(slot);
+      if (leaf->key == key) {
+        leaf->value = std::move(value);
+        return false;
+      }
+      // Lazy expansion: split the leaf at the first byte the keys differ
+      KeyBytes existing(leaf->key);
+      auto limit = std::min(existing.bytes.size(), bytes.size());
+      auto common = depth;
+      while (common < limit && existing.bytes[common] == bytes[common]) {
+        common++;
+      }
+      auto* node = new detail::RadixNode4();
+      node->prefix_length = static_cast<std::uint32_t>(common - depth);
+      std::memcpy(node->prefix, bytes.data() + depth,
+                  std::min<std::size_t>(node->prefix_length, kMaxPrefix));
+      Node* split = node;
+      Attach(split, existing.bytes, common, leaf);
+      AttachNew(split, bytes, common, key, value);
+      slot = split;
+      return true;
+    }
+    auto* inner = static_cast<Inner*>(slot);
+    if (inner->prefix_length > 0) {
+      auto mismatch = PrefixMismatch(inner, bytes, depth);
+      if (mismatch < inner->prefix_length) {
+        // Split the prefix: a new node keeps the matching part, and the old
+        // node hangs below it with the rest past one key byte
+        auto* node = new detail::RadixNode4();
+        node->prefix_length = static_cast<std::uint32_t>(mismatch);
+        std::memcpy(node->prefix, bytes.data() + depth,
+                    std::min(mismatch, kMaxPrefix));
+        std::uint8_t split_byte;
+        if (inner->prefix_length <= kMaxPrefix) {
+          split_byte = inner->prefix[mismatch];
+          inner->prefix_length -= static_cast<std::uint32_t>(mismatch + 1);
+          std::memmove(inner->prefix, inner->prefix + mismatch + 1,
+                       inner->prefix_length);
+        } else {
+          KeyBytes leaf(MinimumLeaf(inner)->key);
+          split_byte = detail::ByteAt(leaf.bytes, depth + mismatch);
+          inner->prefix_length -= static_cast<std::uint32_t>(mismatch + 1);
+          std::memcpy(inner->prefix, leaf.bytes.data() + depth + mismatch + 1,
+                      std::min<std::size_t>(inner->prefix_length, kMaxPrefix));
+        }
+        Node* split = node;
+        detail::AddChild(split, split_byte, inner);
+        AttachNew(split, bytes, depth + mismatch, key, value);
+        slot = split;
+        return true;
+      }
+      depth += inner->prefix_length;
+    }
+    if (depth == bytes.size()) {
+      if (inner->terminal != nullptr) {
+        static_cast<Leaf*>(inner->terminal)->value = std::move(value);
+        return false;
+      }
+      inner->terminal = new Leaf(std::move(key), std::move(value));
+      return true;
+    }
+    auto byte = detail::ByteAt(bytes, depth);
+    if (auto** child = detail::FindChild(inner, byte)) {
+      return InsertAt(*child, bytes, depth + 1, key, value);
+    }
+    detail::AddChild(slot, byte, new Leaf(std::move(key), std::move(value)));
+    return true;
+  }
+
+  bool EraseAt(Node*& slot, std::string_view bytes, std::size_t depth,
+               const TKey& key) {
+    if (slot == nullptr) {
+      return false;
+    }
+    if (slot->type == NodeType::kLeaf) {
+      auto* leaf = static_cast<Leaf*>(slot);
+      if (!(leaf->key == key)) {
+        return false;
+      }
+      delete leaf;
+      slot = nullptr;
+      return true;
+    }
+    auto* inner = static_cast<Inner*>(slot);
+    if (inner->prefix_length > 0) {
+      if (PrefixMismatch(inner, bytes, depth) != inner->prefix_length) {
+        return false;
+      }
+      depth += inner->prefix_length;
+    }
+    if (depth == bytes.size()) {
+      if (inner->terminal == nullptr) {
+        return false;
+      }
+      delete static_cast<Leaf*>(inner->terminal);
+      inner->terminal = nullptr;
+      detail::Shrink(slot);
+      return true;
+    }
+    auto byte = detail::ByteAt(bytes, depth);
+    auto** child = detail::FindChild(inner, byte);
+    if (child == nullptr) {
+      return false;
+    }
+    if ((*child)->type != NodeType::kLeaf) {
+      return EraseAt(*child, bytes, depth + 1, key);
+    }
+    auto* leaf = static_cast<Leaf*>(*child);
+    if (!(leaf->key == key)) {
+      return false;
+    }
+    delete leaf;
+    detail::RemoveChild(slot, byte);
+    return true;
+  }
+
+  /// @brief Passes every entry below node to fn in key order
+  /// @return false once fn returned false
+  template <class TFunction>
+  static bool VisitAll(const Node* node, TFunction& fn,
+                       std::size_t& visited) {
+    if (node->type == NodeType::kLeaf) {
+      auto* leaf = static_cast<const Leaf*>(node);
+      visited++;
+      return fn(leaf->key, leaf->value);
+    }
+    auto* inner = static_cast<const Inner*>(node);
+    if (inner->terminal != nullptr &&
+        !VisitAll(inner->terminal, fn, visited)) {
+      return false;
+    }
+    return detail::VisitChildren(inner, [&](std::uint8_t, const Node* child) {
+      return VisitAll(child, fn, visited);
+    });
+  }
+
+  /// @brief Passes the entries below node with keys >= from to fn in key
+  /// order, descending along from while it still bounds the subtree
+  template <class TFunction>
+  static bool VisitFrom(const Node* node, std::string_view from,
+                        std::size_t depth, TFunction& fn,
+                        std::size_t& visited) {
+    if (node->type == NodeType::kLeaf) {
+      KeyBytes leaf(static_cast<const Leaf*>(node)->key);
+      return leaf.bytes < from || VisitAll(node, fn, visited);
+    }
+    auto* inner = static_cast<const Inner*>(node);
+    auto prefix = FullPrefix(inner, depth);
+    auto rest = from.substr(depth);
+    auto compared = std::min(prefix.size(), rest.size());
+    auto order = std::string_view(prefix).substr(0, compared).compare(
+        rest.substr(0, compared));
+    if (order < 0) {
+      return true;
+    }
+    if (order > 0 || rest.size() <= prefix.size()) {
+      // Every key below is past from
+      return VisitAll(node, fn, visited);
+    }
+    // The terminal key is a proper prefix of from, so below it
+    depth += prefix.size();
+    auto bound = detail::ByteAt(from, depth);
+    return detail::VisitChildren(
+        inner, [&](std::uint8_t byte, const Node* child) {
+          if (byte < bound) {
+            return true;
+          }
+          if (byte == bound) {
+            return VisitFrom(child, from, depth + 1, fn, visited);
+          }
+          return VisitAll(child, fn, visited);
+        });
+  }
+
+  template <class TFunction>
+  static auto AlwaysContinue(TFunction& fn) {
+    return [&fn](const TKey& key, const TValue& value) {
+      fn(key, value);
+      return true;
+    };
+  }
+
+ public:
+  AdaptiveRadixTree() = default;
+
+  AdaptiveRadixTree(const AdaptiveRadixTree&) = delete;
+  AdaptiveRadixTree& operator=(const AdaptiveRadixTree&) = delete;
+
+  AdaptiveRadixTree(AdaptiveRadixTree&& other) noexcept
+      : root(std::exchange(other.root, nullptr)),
+        size(std::exchange(other.size, 0)) {}
+
+  AdaptiveRadixTree& operator=(AdaptiveRadixTree&& other) noexcept {
+    std::swap(root, other.root);
+    std::swap(size, other.size);
+    return *this;
+  }
+
+  ~AdaptiveRadixTree() { Destroy(root); }
+
+  /// @brief Gets the number of entries
+  std::size_t Size() const { return size; }
+
+  /// @brief Returns whether the tree is empty or not
+  bool Empty() const { return Size() == 0; }
+
+  /// @brief Removes every entry
+  void Clear() {
+    Destroy(root);
+    root = nullptr;
+    size = 0;
+  }
+
+  /// @brief Inserts a key-value pair, overwriting the value if the key exists
+  /// @return true if the key was newly inserted
+  bool Insert(TKey key, TValue value) {
+    KeyBytes bytes(key);
+    bool inserted = InsertAt(root, bytes.bytes, 0, key, value);
+    size += inserted;
+    return inserted;
+  }
+
+  /// @brief Finds the value of key
+  /// @return the value, or nullptr if the key is absent
+  const TValue* Find(const TKey& key) const {
+    KeyBytes encoded(key);
+    auto bytes = encoded.bytes;
+    const Node* node = root;
+    std::size_t depth = 0;
+    while (node != nullptr) {
+      if (node->type == NodeType::kLeaf) {
+        auto* leaf = static_cast<const Leaf*>(node);
+        return leaf->key == key ? &leaf->value : nullptr;
+      }
+      auto* inner = static_cast<const Inner*>(node);
+      if (inner->prefix_length > 0) {
+        // Optimistic: bytes past the stored ones are checked at the leaf
+        if (bytes.size() - depth < inner->prefix_length) {
+          return nullptr;
+        }
+        auto stored = std::min<std::size_t>(inner->prefix_length, kMaxPrefix);
+        for (std::size_t i = 0; i < stored; i++) {
+          if (inner->prefix[i] != detail::ByteAt(bytes, depth + i)) {
+            return nullptr;
+          }
+        }
+        depth += inner->prefix_length;
+      }
+      if (depth == bytes.size()) {
+        node = inner->terminal;
+        continue;
+      }
+      auto* child = detail::FindChild(inner, detail::ByteAt(bytes, depth));
+      if (child == nullptr) {
+        return nullptr;
+      }
+      node = *child;
+      depth++;
+    }
+    return nullptr;
+  }
+
+  TValue* Find(const TKey& key) {
+    return const_cast<TValue*>(std::as_const(*this).Find(key));
+  }
+
+  /// @brief Checks if a key exists in the tree
+  bool Contains(const TKey& key) const { return Find(key) != nullptr; }
+
+  /// @brief Gets the value of key
+  /// @throws std::out_of_range if the key is not found
+  const TValue& Get(const TKey& key) const {
+    if (auto* value = Find(key)) {
+      return *value;
+    }
+    throw std::out_of_range("key not found!");
+  }
+
+  /// @brief Removes key
+  /// @return true if the key was present
+  bool Erase(const TKey& key) {
+    KeyBytes bytes(key);
+    bool erased = EraseAt(root, bytes.bytes, 0, key);
+    size -= erased;
+    return erased;
+  }
+
+  /// @brief Calls fn(key, value) on every entry in increasing key order
+  template <class TFunction>
+  void ForEach(TFunction&& fn) const {
+    if (root != nullptr) {
+      auto visit = AlwaysContinue(fn);
+      std::size_t visited = 0;
+      VisitAll(root, visit, visited);
+    }
+  }
+
+  /// @brief Calls fn(key, value) on entries with keys >= from in increasing
+  /// key order until fn returns false
+  /// @return the number of entries passed to fn
+  template <class TFunction>
+  std::size_t Scan(const TKey& from, TFunction&& fn) const {
+    std::size_t visited = 0;
+    if (root != nullptr) {
+      KeyBytes bytes(from);
+      VisitFrom(root, bytes.bytes, 0, fn, visited);
+    }
+    return visited;
+  }
+
+  /// @brief Calls fn(key, value) on entries whose key starts with prefix in
+  /// increasing key order until fn returns false
+  /// @return the number of entries passed to fn
+  template <class TFunction>
+  std::size_t ScanPrefix(std::string_view prefix, TFunction&& fn) const {
+    static_assert(std::is_same<TKey, std::string>::value,
+                  "prefix scans need string keys");
+    std::size_t visited = 0;
+    const Node* node = root;
+    std::size_t depth = 0;
+    while (node != nullptr) {
+      if (node->type == NodeType::kLeaf) {
+        auto& key = static_cast<const Leaf*>(node)->key;
+        if (std::string_view(key).substr(0, prefix.size()) == prefix) {
+          VisitAll(node, fn, visited);
+        }
+        break;
+      }
+      auto* inner = static_cast<const Inner*>(node);
+      auto node_prefix = FullPrefix(inner, depth);
+      auto rest = prefix.substr(depth);
+      auto compared = std::min(node_prefix.size(), rest.size());
+      if (std::string_view(node_prefix).substr(0, compared) !=
+          rest.substr(0, compared)) {
+        break;
+      }
+      if (rest.size() <= node_prefix.size()) {
+        VisitAll(node, fn, visited);
+        break;
+      }
+      depth += node_prefix.size();
+      auto* child = detail::FindChild(inner, detail::ByteAt(prefix, depth));
+      if (child == nullptr) {
+        break;
+      }
+      node = *child;
+      depth++;
+    }
+    return visited;
+  }
+};
+
+}  // namespace binary_tree
+}  // namespace nll
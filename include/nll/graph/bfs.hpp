@@ -0,0 +1,285 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "nll/graph/csr_graph.hpp"
+
+namespace nll {
+namespace graph {
+
+namespace detail {
+
+/// @brief Fixed size bitset over vertex ids. Set() is atomic so concurrent
+/// writers may share a word; SetUnsynchronized() is for word-owning writers.
+class FrontierBitmap {
+ public:
+  static constexpr std::size_t kBitsPerWord = 64;
+
+  explicit FrontierBitmap(std::size_t num_bits)
+      : words((num_bits + kBitsPerWord - 1) / kBitsPerWord) {}
+
+  std::size_t NumWords() const { return words.size(); }
+
+  bool Get(std::size_t bit) const {
+    return (words[bit / kBitsPerWord].load(std::memory_order_relaxed) >>
+            (bit % kBitsPerWord)) &
+           1;
+  }
+
+  void Set(std::size_t bit) {
+    words[bit / kBitsPerWord].fetch_or(std::uint64_t{1} << (bit % kBitsPerWord),
+                                       std::memory_order_relaxed);
+  }
+
+  void SetUnsynchronized(std::size_t bit) {
+    auto& word = words[bit / kBitsPerWord];
+    word.store(word.load(std::memory_order_relaxed) |
+                   (std::uint64_t{1} << (bit % kBitsPerWord)),
+               std::memory_order_relaxed);
+  }
+
+  std::uint64_t Word(std::size_t index) const {
+    return words[index].load(std::memory_order_relaxed);
+  }
+
+  void Clear() {
+    for (auto& word : words) {
+      word.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  void Swap(FrontierBitmap& other) { words.swap(other.words); }
+
+ private:
+  std::vector<std::atomic<std::uint64_t>> words;
+};
+
+}  // namespace detail
+
+/// @brief Tuning knobs for BreadthFirstSearch
+struct BfsOptions {
+  /// @brief Number of worker threads, 0 uses all hardware threads
+  unsigned num_threads = 0;
+  /// @brief Switch between top-down and bottom-up steps based on frontier
+  /// size. Opt in for symmetric (undirected) graphs only: bottom-up steps
+  /// scan a vertex's neighbors as if they were its in-edges, which gives
+  /// wrong distances on directed ones.
+  bool direction_optimizing = false;
+  /// @brief Go bottom-up once frontier edges exceed unexplored edges / alpha
+  std::size_t alpha = 15;
+  /// @brief Go back top-down once the frontier is below vertices / beta
+  std::size_t beta = 18;
+};
+
+/// @brief Output of BreadthFirstSearch, indexed by vertex id
+template <class TVertex>
+struct BfsResult {
+  /// @brief Marks unreached vertices in both distances and parents
+  static constexpr TVertex kUnreached = std::numeric_limits<TVertex>::max();
+
+  /// @brief Hop count from the source, or kUnreached
+  std::vector<TVertex> distances;
+  /// @brief BFS tree parent, the source is its own parent, or kUnreached
+  std::vector<TVertex> parents;
+};
+
+/// @brief Direction-optimizing parallel breadth-first search (Beamer et al.).
+/// Small frontiers are expanded top-down from a queue, partitioned across
+/// threads by edge count; large frontiers switch to bottom-up steps where
+/// every unvisited vertex scans its neighbors for a parent in a frontier
+/// bitmap and stops at the first hit.
+/// @tparam TGraph a CSR style graph exposing VertexId, NumVertices(),
+/// NumEdges(), Degree(v) and Neighbors(v)
+/// @param graph the graph to search
+/// @param source the vertex to start from
+/// @param options threading and direction switching options
+/// @return distances and parents for every vertex
+/// @throws std::out_of_range if source is not a vertex of the graph
+template <class TGraph>
+BfsResult<typename TGraph::VertexId> BreadthFirstSearch(
+    const TGraph& graph, typename TGraph::VertexId source,
+    const BfsOptions& options = {}) {
+  using TVertex = typename TGraph::VertexId;
+  constexpr auto kUnreached = BfsResult<TVertex>::kUnreached;
+  auto num_vertices = graph.NumVertices();
+  if (source >= num_vertices) {
+    throw std::out_of_range(fmt::format(
+        "source {} is out of bounds for graph with {} vertices", source,
+        num_vertices));
+  }
+  auto num_threads = detail::ResolveThreadCount(options.num_threads);
+
+  BfsResult<TVertex> result;
+  result.distances.assign(num_vertices, kUnreached);
+  std::vector<std::atomic<TVertex>> parents(num_vertices);
+  for (auto& parent : parents) {
+    parent.store(kUnreached, std::memory_order_relaxed);
+  }
+  parents[source].store(source, std::memory_order_relaxed);
+  result.distances[source] = 0;
+
+  std::vector<TVertex> queue{source};
+  std::vector<std::vector<TVertex>> local_queues(num_threads);
+  std::vector<std::size_t> queue_offsets(num_threads + 1);
+  std::vector<std::size_t> frontier_edges(num_threads);
+  detail::FrontierBitmap front(num_vertices);
+  detail::FrontierBitmap next(num_vertices);
+
+  // Expands the queue one level top-down and returns the frontier's edges
+  auto top_down_step = [&](TVertex depth) {
+    // Partition the frontier so every thread sees about the same edge count
+    std::vector<std::size_t> edge_prefix(queue.size() + 1, 0);
+    for (std::size_t i = 0; i < queue.size(); i++) {
+      edge_prefix[i + 1] = edge_prefix[i] + graph.Degree(queue[i]) + 1;
+    }
+    auto total = edge_prefix.back();
+    auto split = [&](unsigned t) {
+      return static_cast<std::size_t>(
+          std::lower_bound(edge_prefix.begin(), edge_prefix.end(),
+                           total * t / num_threads) -
+          edge_prefix.begin());
+    };
+    // Small levels run every chunk on the calling thread
+    detail::ParallelChunks(
+        num_threads, total < detail::kMinItemsPerThread ? 1u : num_threads,
+        [&](unsigned, std::size_t t_begin, std::size_t t_end) {
+          for (auto t = t_begin; t < t_end; t++) {
+            auto& local = local_queues[t];
+            local.clear();
+            std::size_t scout = 0;
+            auto end = std::min(split(static_cast<unsigned>(t + 1)),
+                                queue.size());
+            for (auto i = split(static_cast<unsigned>(t)); i < end; i++) {
+              auto u = queue[i];
+              for (auto v : graph.Neighbors(u)) {
+                auto expected = kUnreached;
+                if (parents[v].load(std::memory_order_relaxed) == kUnreached &&
+                    parents[v].compare_exchange_strong(
+                        expected, u, std::memory_order_relaxed)) {
+                  result.distances[v] = depth + 1;
+                  local.push_back(v);
+                  scout += graph.Degree(v);
+                }
+              }
+            }
+            frontier_edges[t] = scout;
+          }
+        },
+        1);
+    queue_offsets[0] = 0;
+    std::size_t scout_count = 0;
+    for (unsigned t = 0; t < num_threads; t++) {
+      queue_offsets[t + 1] = queue_offsets[t] + local_queues[t].size();
+      scout_count += frontier_edges[t];
+    }
+    queue.resize(queue_offsets[num_threads]);
+    detail::ParallelChunks(
+        num_threads,
+        queue.size() < detail::kMinItemsPerThread ? 1u : num_threads,
+        [&](unsigned, std::size_t t_begin, std::size_t t_end) {
+          for (auto t = t_begin; t < t_end; t++) {
+            std::copy(local_queues[t].begin(), local_queues[t].end(),
+                      queue.begin() + queue_offsets[t]);
+          }
+        },
+        1);
+    return scout_count;
+  };
+
+  // Expands the front bitmap one level bottom-up into next and returns the
+  // number of vertices discovered. Threads claim blocks of whole words.
+  auto bottom_up_step = [&](TVertex depth) {
+    constexpr std::size_t kWordsPerBlock = 16;
+    next.Clear();
+    std::atomic<std::size_t> next_block{0};
+    std::atomic<std::size_t> awake_count{0};
+    auto num_blocks = (next.NumWords() + kWordsPerBlock - 1) / kWordsPerBlock;
+    detail::ParallelChunks(
+        num_threads, num_threads, [&](unsigned, std::size_t, std::size_t) {
+          std::size_t awake = 0;
+          for (auto block = next_block.fetch_add(1); block < num_blocks;
+               block = next_block.fetch_add(1)) {
+            auto first = block * kWordsPerBlock *
+                         detail::FrontierBitmap::kBitsPerWord;
+            auto last = std::min<std::size_t>(
+                num_vertices,
+                first + kWordsPerBlock * detail::FrontierBitmap::kBitsPerWord);
+            for (auto v = first; v < last; v++) {
+              if (parents[v].load(std::memory_order_relaxed) != kUnreached) {
+                continue;
+              }
+              for (auto u : graph.Neighbors(static_cast<TVertex>(v))) {
+                if (front.Get(u)) {
+                  parents[v].store(u, std::memory_order_relaxed);
+                  result.distances[v] = depth + 1;
+                  next.SetUnsynchronized(v);
+                  awake++;
+                  break;
+                }
+              }
+            }
+          }
+          awake_count.fetch_add(awake, std::memory_order_relaxed);
+        },
+        1);
+    front.Swap(next);
+    return awake_count.load();
+  };
+
+  auto queue_to_bitmap = [&] {
+    front.Clear();
+    for (auto v : queue) {
+      front.SetUnsynchronized(v);
+    }
+  };
+
+  auto bitmap_to_queue = [&] {
+    queue.clear();
+    for (std::size_t w = 0; w < front.NumWords(); w++) {
+      for (auto word = front.Word(w); word != 0; word &= word - 1) {
+        queue.push_back(static_cast<TVertex>(
+            w * detail::FrontierBitmap::kBitsPerWord +
+            static_cast<std::size_t>(__builtin_ctzll(word))));
+      }
+    }
+  };
+
+  TVertex depth = 0;
+  std::size_t edges_to_check = graph.NumEdges();
+  std::size_t scout_count = graph.Degree(source);
+  while (!queue.empty()) {
+    if (options.direction_optimizing &&
+        scout_count > edges_to_check / options.alpha) {
+      queue_to_bitmap();
+      std::size_t awake_count = queue.size();
+      std::size_t old_awake_count;
+      do {
+        old_awake_count = awake_count;
+        awake_count = bottom_up_step(depth++);
+      } while (awake_count >= old_awake_count ||
+               awake_count > num_vertices / options.beta);
+      bitmap_to_queue();
+      scout_count = 1;
+    } else {
+      edges_to_check -= std::min(edges_to_check, scout_count);
+      scout_count = top_down_step(depth++);
+    }
+  }
+
+  result.parents.resize(num_vertices);
+  for (std::size_t v = 0; v < num_vertices; v++) {
+    result.parents[v] = parents[v].load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
+}  // namespace graph
+}  // namespace nll
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdlib>
+
 namespace nll {
 namespace binary_tree {
 
@@ -12,11 +15,34 @@ struct Node {
     explicit Node(T val) : value(val) {};
 };
 
+namespace detail {
+
+/// @brief Height of a subtree, or -1 as soon as any subtree in it has
+/// children whose heights differ by more than one
+template <class T>
+int BalancedHeight(const Node<T>* root) {
+    if (!root) {
+        return 0;
+    }
+    auto left = BalancedHeight(root->left);
+    if (left < 0) {
+        return -1;
+    }
+    auto right = BalancedHeight(root->right);
+    if (right < 0 || std::abs(left - right) > 1) {
+        return -1;
+    }
+    return std::max(left, right) + 1;
+}
+
+}  // namespace detail
 
+/// @brief Checks that every node's subtrees differ in height by at most one.
+/// Visits each node once, O(n).
 template <class T>
 bool is_balanced(Node<T>* root) {
-    return true;
+    return detail::BalancedHeight<T>(root) >= 0;
 };
 
 }
-}
\ No newline at end of file
+}
@@ -0,0 +1,621 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+namespace nll {
+namespace binary_tree {
+
+namespace detail {
+
+constexpr std::size_t kCacheLineBytes = 64;
+
+template <class TKey>
+std::size_t ScalarLowerBound(const TKey* keys, std::size_t count, TKey key) {
+  std::size_t i = 0;
+  while (i < count && keys[i] < key) {
+    i++;
+  }
+  return i;
+}
+
+/// @brief Index of the first of count sorted keys that is not less than key.
+/// 32-bit keys are compared four at a time with SSE2, 64-bit keys two at a
+/// time when SSE4.2 is enabled; since keys are sorted the lanes that compare
+/// less always form a prefix, so the first block with a clear lane ends the
+/// search. Other widths and targets fall back to a linear scan, which is
+/// still the right choice for a handful of keys within one node.
+template <class TKey>
+std::size_t NodeLowerBound(const TKey* keys, std::size_t count, TKey key) {
+#if defined(__SSE2__)
+  if constexpr (sizeof(TKey) == 4) {
+    // SSE2 only compares signed lanes, so flip the sign bit of unsigned keys
+    const std::int32_t flip = std::is_signed<TKey>::value ? 0 : INT32_MIN;
+    auto bias = _mm_set1_epi32(flip);
+    auto needle = _mm_set1_epi32(static_cast<std::int32_t>(key) ^ flip);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      auto block = _mm_xor_si128(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), bias);
+      auto less = _mm_movemask_ps(
+          _mm_castsi128_ps(_mm_cmplt_epi32(block, needle)));
+      if (less != 0xF) {
+        return i + __builtin_popcount(less);
+      }
+    }
+    return i + ScalarLowerBound(keys + i, count - i, key);
+  }
+#endif
+#if defined(__SSE4_2__)
+  if constexpr (sizeof(TKey) == 8) {
+    const std::int64_t flip = std::is_signed<TKey>::value ? 0 : INT64_MIN;
+    auto bias = _mm_set1_epi64x(flip);
+    auto needle = _mm_set1_epi64x(static_cast<std::int64_t>(key) ^ flip);
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+      auto block = _mm_xor_si128(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), bias);
+      auto less = _mm_movemask_pd(
+          _mm_castsi128_pd(_mm_cmpgt_epi64(needle, block)));
+      if (less != 0x3) {
+        return i + __builtin_popcount(less);
+      }
+    }
+    return i + ScalarLowerBound(keys + i, count - i, key);
+  }
+#endif
+  return ScalarLowerBound(keys, count, key);
+}
+
+/// @brief Per-node lock for BPlusTree. The single threaded variant does
+/// nothing and compiles away.
+template <bool kConcurrent>
+struct OptimisticLock {
+  std::uint64_t ReadLock() const { return 0; }
+
+  bool Validate(std::uint64_t) const { return true; }
+
+  bool TryUpgrade(std::uint64_t) { return true; }
+
+  void WriteUnlock() {}
+};
+
+/// @brief Optimistic lock: a version counter whose low bit means a writer
+/// holds the node. Readers never write shared memory; they remember the
+/// version before reading a node and Validate that it is unchanged after.
+template <>
+struct OptimisticLock<true> {
+  std::atomic<std::uint64_t> version{0};
+
+  /// @brief Waits out any writer and returns the version to validate against
+  std::uint64_t ReadLock() const {
+    auto current = version.load(std::memory_order_acquire);
+    while (current & 1) {
+      std::this_thread::yield();
+      current = version.load(std::memory_order_acquire);
+    }
+    return current;
+  }
+
+  /// @brief Returns whether nothing was written since ReadLock returned seen
+  bool Validate(std::uint64_t seen) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version.load(std::memory_order_relaxed) == seen;
+  }
+
+  /// @brief Turns a read into a write lock, failing if a writer got there
+  /// first
+  bool TryUpgrade(std::uint64_t seen) {
+    return version.compare_exchange_strong(seen, seen + 1,
+                                           std::memory_order_acquire);
+  }
+
+  void WriteUnlock() { version.fetch_add(1, std::memory_order_release); }
+};
+
+}  // namespace detail
+
+/// @brief B+-tree on integer keys. Nodes are kNodeBytes (a multiple of the
+/// cache line) and cache line aligned, so an inner node holds ~20 keys and a
+/// lookup touches a few lines per level instead of one line per comparison
+/// like a tree of Node<T>. Inner nodes are searched with SIMD compares,
+/// entries live only in the leaves, and leaves are chained for sequential
+/// range scans. Erasing is not supported.
+///
+/// With kConcurrent set, every node carries an optimistic lock and any number
+/// of threads may Insert, Find and Scan at once (optimistic lock coupling,
+/// Leis et al. 2016): readers take no locks and retry from the root if a node
+/// they read changed underneath them, writers lock at most a node and its
+/// parent, and full nodes are split on the way down so a split never has to
+/// propagate upwards. Nodes are only freed when the tree is destroyed, which
+/// is what lets readers safely follow stale pointers. Keys and values must be
+/// trivially copyable in this mode, since readers may copy them mid-write
+/// before discarding the copy.
+/// @tparam TKey integer key type
+/// @tparam TValue mapped type
+/// @tparam kConcurrent enables optimistic lock coupling
+/// @tparam kNodeBytes node size, a multiple of 64
+template <class TKey, class TValue, bool kConcurrent = false,
+          std::size_t kNodeBytes = 256>
+class BPlusTree {
+  static_assert(std::is_integral<TKey>::value,
+                "B+-tree keys must be an integer type");
+  static_assert(kNodeBytes % detail::kCacheLineBytes == 0,
+                "node size must be a multiple of the cache line");
+  static_assert(!kConcurrent || (std::is_trivially_copyable<TKey>::value &&
+                                 std::is_trivially_copyable<TValue>::value),
+                "concurrent trees need trivially copyable keys and values");
+
+  struct NodeBase {
+    detail::OptimisticLock<kConcurrent> lock;
+    std::uint16_t count = 0;
+    bool is_leaf;
+
+    explicit NodeBase(bool is_leaf) : is_leaf(is_leaf) {};
+  };
+
+  // Bytes taken by NodeBase once padded to pointer alignment
+  static constexpr std::size_t kHeaderBytes =
+      (sizeof(NodeBase) + alignof(void*) - 1) / alignof(void*) *
+      alignof(void*);
+
+ public:
+  /// @brief Maximum number of separator keys in an inner node
+  static constexpr std::size_t kInnerCapacity =
+      (kNodeBytes - kHeaderBytes - sizeof(void*)) /
+      (sizeof(TKey) + sizeof(void*));
+  /// @brief Maximum number of entries in a leaf
+  static constexpr std::size_t kLeafCapacity =
+      (kNodeBytes - kHeaderBytes - sizeof(void*) - alignof(TValue)) /
+      (sizeof(TKey) + sizeof(TValue));
+
+  static_assert(kInnerCapacity >= 3 && kLeafCapacity >= 2,
+                "node size is too small for the key and value types");
+
+ private:
+  /// @brief children[i] holds the keys <= keys[i], and children[count] the
+  /// keys greater than every separator
+  struct alignas(detail::kCacheLineBytes) Inner : NodeBase {
+    NodeBase* children[kInnerCapacity + 1];
+    TKey keys[kInnerCapacity];
+
+    Inner() : NodeBase(false) {};
+
+    std::size_t LowerBound(TKey key) const {
+      return detail::NodeLowerBound(keys, this->count, key);
+    }
+
+    /// @brief Moves the upper half into a new node, returning it and the
+    /// separator key that moves up to the parent
+    Inner* Split(TKey& separator) {
+      auto* right = new Inner();
+      std::size_t middle = this->count / 2;
+      separator = keys[middle];
+      right->count = static_cast<std::uint16_t>(this->count - middle - 1);
+      std::copy(keys + middle + 1, keys + this->count, right->keys);
+      std::copy(children + middle + 1, children + this->count + 1,
+                right->children);
+      this->count = static_cast<std::uint16_t>(middle);
+      return right;
+    }
+
+    /// @brief Adds child as the right neighbour of the child that used to
+    /// hold separator. The node must not be full.
+    void InsertChild(TKey separator, NodeBase* child) {
+      auto position = LowerBound(separator);
+      std::copy_backward(keys + position, keys + this->count,
+                         keys + this->count + 1);
+      std::copy_backward(children + position + 1,
+                         children + this->count + 1,
+                         children + this->count + 2);
+      keys[position] = separator;
+      children[position + 1] = child;
+      this->count++;
+    }
+  };
+
+  struct alignas(detail::kCacheLineBytes) Leaf : NodeBase {
+    Leaf* next = nullptr;
+    TKey keys[kLeafCapacity];
+    TValue values[kLeafCapacity];
+
+    Leaf() : NodeBase(true) {};
+
+    std::size_t LowerBound(TKey key) const {
+      return detail::NodeLowerBound(keys, this->count, key);
+    }
+
+    /// @brief Inserts or overwrites an entry. The leaf must not be full.
+    /// @return true if the key is new
+    bool Insert(TKey key, const TValue& value) {
+      auto position = LowerBound(key);
+      if (position < this->count && keys[position] == key) {
+        values[position] = value;
+        return false;
+      }
+      std::copy_backward(keys + position, keys + this->count,
+                         keys + this->count + 1);
+      std::copy_backward(values + position, values + this->count,
+                         values + this->count + 1);
+      keys[position] = key;
+      values[position] = value;
+      this->count++;
+      return true;
+    }
+
+    /// @brief Moves the upper half into a new leaf linked after this one,
+    /// returning it and this leaf's new largest key as the separator
+    Leaf* Split(TKey& separator) {
+      auto* right = new Leaf();
+      std::size_t half = this->count / 2;
+      right->count = static_cast<std::uint16_t>(this->count - half);
+      std::copy(keys + half, keys + this->count, right->keys);
+      std::copy(values + half, values + this->count, right->values);
+      this->count = static_cast<std::uint16_t>(half);
+      separator = keys[half - 1];
+      right->next = next;
+      next = right;
+      return right;
+    }
+  };
+
+  static_assert(sizeof(Inner) <= kNodeBytes && sizeof(Leaf) <= kNodeBytes,
+                "node layout exceeds the node size");
+
+  std::atomic<NodeBase*> root;
+  std::conditional_t<kConcurrent, std::atomic<std::size_t>, std::size_t> size{
+      0};
+
+ public:
+  BPlusTree() : root(new Leaf()) {}
+
+  BPlusTree(const BPlusTree&) = delete;
+  BPlusTree& operator=(const BPlusTree&) = delete;
+
+  /// @brief Takes other's nodes, leaving it empty. Not thread safe.
+  BPlusTree(BPlusTree&& other)
+      : root(other.root.exchange(new Leaf())), size(other.Size()) {
+    other.size = 0;
+  }
+
+  BPlusTree& operator=(BPlusTree&& other) {
+    if (this != &other) {
+      Destroy(root.exchange(other.root.exchange(new Leaf())));
+      size = other.Size();
+      other.size = 0;
+    }
+    return *this;
+  }
+
+  ~BPlusTree() { Destroy(root.load()); }
+
+  /// @brief Builds a tree from entries sorted by strictly increasing key,
+  /// packing full leaves left to right. O(n).
+  /// @throws std::invalid_argument if keys are not strictly increasing
+  static BPlusTree FromSorted(
+      const std::vector<std::pair<TKey, TValue>>& entries) {
+    for (std::size_t i = 1; i < entries.size(); i++) {
+      if (!(entries[i - 1].first < entries[i].first)) {
+        throw std::invalid_argument(
+            "entries must be sorted by strictly increasing key!");
+      }
+    }
+    BPlusTree tree;
+    if (entries.empty()) {
+      return tree;
+    }
+    std::vector<NodeBase*> level;
+    std::vector<TKey> maxima;
+    Leaf* previous = nullptr;
+    for (std::size_t i = 0; i < entries.size(); i += kLeafCapacity) {
+      auto* leaf = new Leaf();
+      auto end = std::min(i + kLeafCapacity, entries.size());
+      for (auto j = i; j < end; j++) {
+        leaf->keys[j - i] = entries[j].first;
+        leaf->values[j - i] = entries[j].second;
+      }
+      leaf->count = static_cast<std::uint16_t>(end - i);
+      if (previous) {
+        previous->next = leaf;
+      }
+      previous = leaf;
+      level.push_back(leaf);
+      maxima.push_back(entries[end - 1].first);
+    }
+    while (level.size() > 1) {
+      std::vector<NodeBase*> parents;
+      std::vector<TKey> parent_maxima;
+      for (std::size_t i = 0; i < level.size(); i += kInnerCapacity + 1) {
+        auto* inner = new Inner();
+        auto end = std::min(i + kInnerCapacity + 1, level.size());
+        std::copy(level.begin() + i, level.begin() + end, inner->children);
+        std::copy(maxima.begin() + i, maxima.begin() + end - 1, inner->keys);
+        inner->count = static_cast<std::uint16_t>(end - i - 1);
+        parents.push_back(inner);
+        parent_maxima.push_back(maxima[end - 1]);
+      }
+      level = std::move(parents);
+      maxima = std::move(parent_maxima);
+    }
+    Destroy(tree.root.exchange(level.front()));
+    tree.size = entries.size();
+    return tree;
+  }
+
+  /// @brief Gets the number of entries
+  std::size_t Size() const { return size; }
+
+  /// @brief Returns whether the tree is empty or not
+  bool Empty() const { return Size() == 0; }
+
+  /// @brief Gets the number of levels, 1 for a lone leaf
+  std::size_t Height() const {
+    std::size_t height = 1;
+    for (auto* node = root.load(); !node->is_leaf; height++) {
+      node = static_cast<Inner*>(node)->children[0];
+    }
+    return height;
+  }
+
+  /// @brief Inserts a key-value pair, overwriting the value if the key exists
+  /// @return true if the key was newly inserted
+  bool Insert(TKey key, const TValue& value) {
+    bool inserted = false;
+    while (!TryInsert(key, value, inserted)) {
+    }
+    return inserted;
+  }
+
+  /// @brief Gets a copy of the value for a key, if present
+  std::optional<TValue> Find(TKey key) const {
+    for (;;) {
+      const Leaf* leaf;
+      std::uint64_t version;
+      if (!TryFindLeaf(key, leaf, version)) {
+        continue;
+      }
+      std::optional<TValue> found;
+      auto position = leaf->LowerBound(key);
+      if (position < leaf->count && leaf->keys[position] == key) {
+        found = leaf->values[position];
+      }
+      if (leaf->lock.Validate(version)) {
+        return found;
+      }
+    }
+  }
+
+  /// @brief Checks if a key exists in the tree
+  bool Contains(TKey key) const { return Find(key).has_value(); }
+
+  /// @brief Gets a copy of the value for a key
+  /// @throws std::out_of_range if the key is not found
+  TValue Get(TKey key) const {
+    auto found = Find(key);
+    if (!found) {
+      throw std::out_of_range("key not found!");
+    }
+    return *found;
+  }
+
+  /// @brief Calls fn(key, value) on entries with keys >= from in increasing
+  /// key order, walking the leaf chain, until fn returns false. In
+  /// concurrent mode each leaf is copied and validated before its entries are
+  /// handed out, so fn never sees a torn entry.
+  /// @return the number of entries passed to fn
+  template <class TFunction>
+  std::size_t Scan(TKey from, TFunction&& fn) const {
+    std::size_t visited = 0;
+    if constexpr (!kConcurrent) {
+      const Leaf* leaf;
+      std::uint64_t version;
+      TryFindLeaf(from, leaf, version);
+      for (auto position = leaf->LowerBound(from); leaf;
+           leaf = leaf->next, position = 0) {
+        for (; position < leaf->count; position++) {
+          visited++;
+          if (!fn(leaf->keys[position], leaf->values[position])) {
+            return visited;
+          }
+        }
+      }
+      return visited;
+    } else {
+      TKey resume = from;
+      bool inclusive = true;
+      TKey keys[kLeafCapacity];
+      TValue values[kLeafCapacity];
+      for (;;) {
+        const Leaf* leaf;
+        std::uint64_t version;
+        if (!TryFindLeaf(resume, leaf, version)) {
+          continue;
+        }
+        while (leaf) {
+          std::size_t copied = 0;
+          for (std::size_t i = 0; i < leaf->count; i++) {
+            auto key = leaf->keys[i];
+            if (key > resume || (inclusive && key == resume)) {
+              keys[copied] = key;
+              values[copied++] = leaf->values[i];
+            }
+          }
+          const Leaf* next = leaf->next;
+          if (!leaf->lock.Validate(version)) {
+            // Descend again from the last key handed out
+            break;
+          }
+          for (std::size_t i = 0; i < copied; i++) {
+            visited++;
+            if (!fn(keys[i], values[i])) {
+              return visited;
+            }
+            resume = keys[i];
+            inclusive = false;
+          }
+          leaf = next;
+          if (leaf) {
+            version = leaf->lock.ReadLock();
+          }
+        }
+        if (!leaf) {
+          return visited;
+        }
+      }
+    }
+  }
+
+ private:
+  static void Destroy(NodeBase* node) {
+    if (node->is_leaf) {
+      delete static_cast<Leaf*>(node);
+      return;
+    }
+    auto* inner = static_cast<Inner*>(node);
+    for (std::size_t i = 0; i <= inner->count; i++) {
+      Destroy(inner->children[i]);
+    }
+    delete inner;
+  }
+
+  /// @brief Descends to the leaf that would hold key, coupling read locks
+  /// down the path
+  /// @return false if a node changed during the descent and it must restart
+  bool TryFindLeaf(TKey key, const Leaf*& leaf,
+                   std::uint64_t& version) const {
+    const NodeBase* node = root.load(std::memory_order_acquire);
+    version = node->lock.ReadLock();
+    if (node != root.load(std::memory_order_acquire)) {
+      return false;
+    }
+    const Inner* parent = nullptr;
+    std::uint64_t parent_version = 0;
+    while (!node->is_leaf) {
+      auto* inner = static_cast<const Inner*>(node);
+      node = inner->children[inner->LowerBound(key)];
+      if (!inner->lock.Validate(version)) {
+        return false;
+      }
+      if (parent && !parent->lock.Validate(parent_version)) {
+        return false;
+      }
+      parent = inner;
+      parent_version = version;
+      version = node->lock.ReadLock();
+    }
+    // A split between reading the pointer and locking the leaf shows up in
+    // the parent's version
+    if (parent && !parent->lock.Validate(parent_version)) {
+      return false;
+    }
+    leaf = static_cast<const Leaf*>(node);
+    return true;
+  }
+
+  /// @brief Splits node under its parent, or grows a new root. Locks both,
+  /// and does nothing if either changed since it was read.
+  void TrySplit(NodeBase* node, std::uint64_t version, Inner* parent,
+                std::uint64_t parent_version) {
+    if (parent && !parent->lock.TryUpgrade(parent_version)) {
+      return;
+    }
+    if (!node->lock.TryUpgrade(version)) {
+      if (parent) {
+        parent->lock.WriteUnlock();
+      }
+      return;
+    }
+    if (!parent && node != root.load(std::memory_order_acquire)) {
+      // Another thread grew a new root above node
+      node->lock.WriteUnlock();
+      return;
+    }
+    TKey separator;
+    NodeBase* sibling =
+        node->is_leaf
+            ? static_cast<NodeBase*>(
+                  static_cast<Leaf*>(node)->Split(separator))
+            : static_cast<NodeBase*>(
+                  static_cast<Inner*>(node)->Split(separator));
+    if (parent) {
+      parent->InsertChild(separator, sibling);
+    } else {
+      auto* new_root = new Inner();
+      new_root->count = 1;
+      new_root->keys[0] = separator;
+      new_root->children[0] = node;
+      new_root->children[1] = sibling;
+      root.store(new_root, std::memory_order_release);
+    }
+    node->lock.WriteUnlock();
+    if (parent) {
+      parent->lock.WriteUnlock();
+    }
+  }
+
+  /// @brief One insert attempt. Full nodes met on the way down are split
+  /// first, so the parent of any split always has room.
+  /// @return false if it must restart from the root
+  bool TryInsert(TKey key, const TValue& value, bool& inserted) {
+    NodeBase* node = root.load(std::memory_order_acquire);
+    auto version = node->lock.ReadLock();
+    if (node != root.load(std::memory_order_acquire)) {
+      return false;
+    }
+    Inner* parent = nullptr;
+    std::uint64_t parent_version = 0;
+    while (!node->is_leaf) {
+      auto* inner = static_cast<Inner*>(node);
+      if (inner->count == kInnerCapacity) {
+        TrySplit(node, version, parent, parent_version);
+        return false;
+      }
+      if (parent && !parent->lock.Validate(parent_version)) {
+        return false;
+      }
+      parent = inner;
+      parent_version = version;
+      node = inner->children[inner->LowerBound(key)];
+      if (!inner->lock.Validate(version)) {
+        return false;
+      }
+      version = node->lock.ReadLock();
+    }
+    auto* leaf = static_cast<Leaf*>(node);
+    if (leaf->count == kLeafCapacity) {
+      TrySplit(node, version, parent, parent_version);
+      return false;
+    }
+    if (!leaf->lock.TryUpgrade(version)) {
+      return false;
+    }
+    if (parent && !parent->lock.Validate(parent_version)) {
+      leaf->lock.WriteUnlock();
+      return false;
+    }
+    inserted = leaf->Insert(key, value);
+    leaf->lock.WriteUnlock();
+    if (inserted) {
+      size++;
+    }
+    return true;
+  }
+};
+
+}  // namespace binary_tree
+}  // namespace nll
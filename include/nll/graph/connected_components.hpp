@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "nll/graph/csr_graph.hpp"
+#include "nll/graph/disjoint_set.hpp"
+#include "nll/graph/unweighted_graph.hpp"
+
+namespace nll {
+namespace graph {
+
+/// @brief Tuning knobs for ConnectedComponents
+struct ComponentsOptions {
+  /// @brief Number of worker threads, 0 uses all hardware threads
+  unsigned num_threads = 0;
+  /// @brief Neighbors linked per vertex before sampling for the giant
+  /// component
+  std::size_t neighbor_rounds = 2;
+  /// @brief Vertices sampled to guess the giant component
+  std::size_t num_samples = 1024;
+};
+
+/// @brief Parallel connected components of an undirected graph using
+/// Afforest (Sutton et al.). Every vertex first links to a couple of its
+/// neighbors, which already merges most of the giant component; a random
+/// sample then guesses which component that is, and only vertices outside
+/// it go on to link their remaining edges. Links go through a
+/// ConcurrentDisjointSet, so no locks are taken.
+/// @tparam TGraph a symmetric CSR style graph exposing VertexId,
+/// NumVertices(), Degree(v) and Neighbors(v)
+/// @param graph the graph, every edge must be present in both directions
+/// @param options threading and sampling options
+/// @return a label per vertex, the smallest vertex id in its component
+template <class TGraph>
+std::vector<typename TGraph::VertexId> ConnectedComponents(
+    const TGraph& graph, const ComponentsOptions& options = {}) {
+  using TVertex = typename TGraph::VertexId;
+  auto num_vertices = graph.NumVertices();
+  auto num_threads = detail::ResolveThreadCount(options.num_threads);
+  ConcurrentDisjointSet<TVertex> set(num_vertices);
+  if (num_vertices == 0) {
+    return {};
+  }
+
+  // Link every vertex to its first few neighbors
+  for (std::size_t round = 0; round < options.neighbor_rounds; round++) {
+    detail::ParallelChunks(
+        num_vertices, num_threads,
+        [&](unsigned, std::size_t begin, std::size_t end) {
+          for (auto v = begin; v < end; v++) {
+            auto neighbors = graph.Neighbors(static_cast<TVertex>(v));
+            if (round < neighbors.size()) {
+              set.Union(static_cast<TVertex>(v), neighbors[round]);
+            }
+          }
+        });
+  }
+
+  // Guess the largest component from a sample of compressed labels
+  auto labels = set.Labels(num_threads);
+  std::mt19937_64 rng(num_vertices);
+  std::uniform_int_distribution<std::size_t> pick(0, num_vertices - 1);
+  std::unordered_map<TVertex, std::size_t> counts;
+  TVertex giant = labels[0];
+  std::size_t giant_count = 0;
+  for (std::size_t i = 0; i < options.num_samples; i++) {
+    auto label = labels[pick(rng)];
+    if (++counts[label] > giant_count) {
+      giant = label;
+      giant_count = counts[label];
+    }
+  }
+
+  // Finish the remaining edges of every vertex outside the giant component.
+  // Edges from inside it are covered from their other endpoint.
+  detail::ParallelChunks(
+      num_vertices, num_threads,
+      [&](unsigned, std::size_t begin, std::size_t end) {
+        for (auto v = begin; v < end; v++) {
+          if (labels[v] == giant) {
+            continue;
+          }
+          auto neighbors = graph.Neighbors(static_cast<TVertex>(v));
+          for (auto i = options.neighbor_rounds; i < neighbors.size(); i++) {
+            set.Union(static_cast<TVertex>(v), neighbors[i]);
+          }
+        }
+      });
+  return set.Labels(num_threads);
+}
+
+/// @brief Connected components of an UnweightedGraph, whose AddNeighbor
+/// always adds both directions
+/// @return a label per node in graph.nodes order, the index of the first
+/// node of its component
+template <class T>
+std::vector<std::uint32_t> ConnectedComponents(
+    const UnweightedGraph<T>& graph,
+    const ComponentsOptions& options = {}) {
+  return ConnectedComponents(ToCsr<std::uint32_t>(graph), options);
+}
+
+}  // namespace graph
+}  // namespace nll
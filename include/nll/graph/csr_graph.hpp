@@ -0,0 +1,409 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "nll/graph/unweighted_graph.hpp"
+
+namespace nll {
+namespace graph {
+
+namespace detail {
+
+/// @brief Resolves a requested thread count, where 0 means "use all cores"
+inline unsigned ResolveThreadCount(unsigned requested) {
+  if (requested != 0) {
+    return requested;
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/// @brief Fewest items worth a thread of their own in ParallelChunks
+inline constexpr std::size_t kMinItemsPerThread = 4096;
+
+/// @brief Splits [0, n) into one contiguous chunk per thread and calls
+/// fn(thread_index, begin, end) for each. The calling thread runs chunk 0.
+/// Every thread gets at least min_items items, so small inputs run serially
+/// on the calling thread instead of paying for starting threads.
+template <class TFunc>
+void ParallelChunks(std::size_t n, unsigned num_threads, TFunc&& fn,
+                    std::size_t min_items = kMinItemsPerThread) {
+  num_threads = static_cast<unsigned>(std::max<std::size_t>(
+      1, std::min<std::size_t>(num_threads,
+                               n / std::max<std::size_t>(1, min_items))));
+  if (num_threads == 1) {
+    fn(0u, std::size_t{0}, n);
+    return;
+  }
+  std::vector<std::thread> workers;
+  workers.reserve(num_threads - 1);
+  auto chunk_begin = [&](unsigned t) { return n * t / num_threads; };
+  for (unsigned t = 1; t < num_threads; t++) {
+    workers.emplace_back(
+        [&fn, t, begin = chunk_begin(t), end = chunk_begin(t + 1)] {
+          fn(t, begin, end);
+        });
+  }
+  fn(0u, std::size_t{0}, chunk_begin(1));
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+/// @brief Replaces counts with their exclusive prefix sum and returns the
+/// total. Runs as a two pass blocked scan across num_threads threads.
+template <class TCount>
+TCount ExclusiveScan(std::vector<TCount>& counts, unsigned num_threads) {
+  num_threads = static_cast<unsigned>(std::max<std::size_t>(
+      1, std::min<std::size_t>(num_threads,
+                               counts.size() / kMinItemsPerThread)));
+  std::vector<TCount> block_sums(num_threads + 1, 0);
+  ParallelChunks(counts.size(), num_threads,
+                 [&](unsigned t, std::size_t begin, std::size_t end) {
+                   TCount sum = 0;
+                   for (auto i = begin; i < end; i++) {
+                     sum += counts[i];
+                   }
+                   block_sums[t + 1] = sum;
+                 });
+  for (unsigned t = 0; t < num_threads; t++) {
+    block_sums[t + 1] += block_sums[t];
+  }
+  ParallelChunks(counts.size(), num_threads,
+                 [&](unsigned t, std::size_t begin, std::size_t end) {
+                   TCount running = block_sums[t];
+                   for (auto i = begin; i < end; i++) {
+                     auto count = counts[i];
+                     counts[i] = running;
+                     running += count;
+                   }
+                 });
+  return block_sums[num_threads];
+}
+
+}  // namespace detail
+
+/// @brief Options for building a CsrGraph from an edge list
+struct CsrBuildOptions {
+  /// @brief Number of builder threads, 0 uses all hardware threads
+  unsigned num_threads = 0;
+  /// @brief Also insert (dst, src) for every (src, dst), for undirected graphs
+  bool symmetrize = false;
+  /// @brief Drop edges whose source and target are the same vertex
+  bool remove_self_loops = false;
+  /// @brief Sort every adjacency list and drop parallel edges
+  bool deduplicate = false;
+};
+
+namespace detail {
+
+/// @brief Per edge data of a graph without any, which BuildCsr skips
+struct NoPayload {};
+
+/// @brief An input edge as BuildCsr sees it
+template <class TVertex, class TPayload>
+struct BuilderEdge {
+  TVertex source;
+  TVertex target;
+  TPayload payload;
+};
+
+/// @brief Output of BuildCsr; payloads is parallel to targets, and left
+/// empty for NoPayload
+template <class TVertex, class TPayload>
+struct CsrArrays {
+  std::vector<std::uint64_t> offsets;
+  std::vector<TVertex> targets;
+  std::vector<TPayload> payloads;
+};
+
+/// @brief Counting sort of an edge list on the source vertex, the builder
+/// behind every CSR graph's FromEdges: counts out degrees, prefix sums them
+/// into offsets and scatters each edge into its source's range, every pass
+/// across num_threads threads. O(V + E) work. Symmetrized copies carry the
+/// payload of the edge they mirror.
+/// @param unpack maps an input edge to its BuilderEdge
+/// @throws std::out_of_range if an edge endpoint is >= num_vertices
+/// @throws std::length_error if num_vertices does not fit in TVertex
+template <class TVertex, class TPayload, class TEdge, class TUnpack>
+CsrArrays<TVertex, TPayload> BuildCsr(const std::vector<TEdge>& edges,
+                                      std::size_t num_vertices,
+                                      const CsrBuildOptions& options,
+                                      unsigned num_threads,
+                                      const TUnpack& unpack) {
+  using EdgeIndex = std::uint64_t;
+  constexpr bool kHasPayload = !std::is_same<TPayload, NoPayload>::value;
+  if (num_vertices > std::numeric_limits<TVertex>::max()) {
+    throw std::length_error(fmt::format(
+        "{} vertices do not fit in the vertex id type", num_vertices));
+  }
+  auto keep = [&](const BuilderEdge<TVertex, TPayload>& edge) {
+    return !(options.remove_self_loops && edge.source == edge.target);
+  };
+
+  // Pass 1: count the out degree of every vertex
+  std::vector<std::atomic<EdgeIndex>> cursors(num_vertices);
+  std::atomic<bool> out_of_range{false};
+  ParallelChunks(edges.size(), num_threads,
+                 [&](unsigned, std::size_t begin, std::size_t end) {
+                   for (auto i = begin; i < end; i++) {
+                     auto edge = unpack(edges[i]);
+                     if (edge.source >= num_vertices ||
+                         edge.target >= num_vertices) {
+                       out_of_range.store(true, std::memory_order_relaxed);
+                       return;
+                     }
+                     if (!keep(edge)) {
+                       continue;
+                     }
+                     cursors[edge.source].fetch_add(
+                         1, std::memory_order_relaxed);
+                     if (options.symmetrize) {
+                       cursors[edge.target].fetch_add(
+                           1, std::memory_order_relaxed);
+                     }
+                   }
+                 });
+  if (out_of_range.load()) {
+    throw std::out_of_range(fmt::format(
+        "edge endpoint is out of bounds for graph with {} vertices",
+        num_vertices));
+  }
+
+  // Pass 2: prefix sum the degrees into offsets
+  CsrArrays<TVertex, TPayload> arrays;
+  arrays.offsets.assign(num_vertices + 1, 0);
+  for (std::size_t v = 0; v < num_vertices; v++) {
+    arrays.offsets[v] = cursors[v].load(std::memory_order_relaxed);
+  }
+  auto num_edges = ExclusiveScan(arrays.offsets, num_threads);
+  for (std::size_t v = 0; v < num_vertices; v++) {
+    cursors[v].store(arrays.offsets[v], std::memory_order_relaxed);
+  }
+
+  // Pass 3: scatter every edge into its source's slot range
+  arrays.targets.resize(num_edges);
+  if constexpr (kHasPayload) {
+    arrays.payloads.resize(num_edges);
+  }
+  auto place = [&](TVertex from, TVertex to, const TPayload& payload) {
+    auto slot = cursors[from].fetch_add(1, std::memory_order_relaxed);
+    arrays.targets[slot] = to;
+    if constexpr (kHasPayload) {
+      arrays.payloads[slot] = payload;
+    }
+  };
+  ParallelChunks(edges.size(), num_threads,
+                 [&](unsigned, std::size_t begin, std::size_t end) {
+                   for (auto i = begin; i < end; i++) {
+                     auto edge = unpack(edges[i]);
+                     if (!keep(edge)) {
+                       continue;
+                     }
+                     place(edge.source, edge.target, edge.payload);
+                     if (options.symmetrize) {
+                       place(edge.target, edge.source, edge.payload);
+                     }
+                   }
+                 });
+  return arrays;
+}
+
+}  // namespace detail
+
+/// @brief Immutable graph in compressed sparse row form. The neighbors of
+/// vertex v are targets[offsets[v] .. offsets[v + 1]), so the whole graph is
+/// two contiguous arrays and a traversal never chases pointers.
+/// @tparam TVertex unsigned vertex id type, std::uint32_t or std::uint64_t
+template <class TVertex = std::uint32_t>
+class CsrGraph {
+  static_assert(std::is_unsigned<TVertex>::value,
+                "vertex ids must be an unsigned integer type");
+
+ public:
+  using VertexId = TVertex;
+  using EdgeIndex = std::uint64_t;
+  using Edge = std::pair<TVertex, TVertex>;
+
+  /// @brief Contiguous view over the neighbors of a single vertex
+  class NeighborRange {
+   public:
+    NeighborRange(const TVertex* first, const TVertex* last)
+        : first(first), last(last) {}
+
+    const TVertex* begin() const { return first; }
+
+    const TVertex* end() const { return last; }
+
+    std::size_t size() const { return static_cast<std::size_t>(last - first); }
+
+    bool empty() const { return first == last; }
+
+    TVertex operator[](std::size_t index) const { return first[index]; }
+
+   private:
+    const TVertex* first;
+    const TVertex* last;
+  };
+
+  /// @brief Constructs an empty graph with no vertices
+  CsrGraph() : offsets(1, 0) {}
+
+  /// @brief Constructs a graph from prebuilt CSR arrays
+  /// @param offsets num_vertices + 1 non-decreasing edge offsets
+  /// @param targets neighbor ids, offsets.back() of them
+  /// @throws std::invalid_argument if the arrays do not form a valid graph
+  CsrGraph(std::vector<EdgeIndex> offsets, std::vector<TVertex> targets)
+      : offsets(std::move(offsets)), targets(std::move(targets)) {
+    if (this->offsets.empty() || this->offsets.front() != 0 ||
+        this->offsets.back() != this->targets.size() ||
+        !std::is_sorted(this->offsets.begin(), this->offsets.end())) {
+      throw std::invalid_argument("offsets do not describe the targets!");
+    }
+    for (auto target : this->targets) {
+      if (target >= NumVertices()) {
+        throw std::invalid_argument(fmt::format(
+            "target {} is out of bounds for graph with {} vertices", target,
+            NumVertices()));
+      }
+    }
+  }
+
+  /// @brief Builds a graph from a list of directed (source, target) edges by
+  /// a parallel counting sort on the source vertex. O(V + E) work.
+  /// @param edges the edge list
+  /// @param num_vertices number of vertices, every id must be below this
+  /// @param options threading, symmetrization and deduplication options
+  /// @throws std::out_of_range if an edge endpoint is >= num_vertices
+  /// @throws std::length_error if num_vertices does not fit in TVertex
+  static CsrGraph FromEdges(const std::vector<Edge>& edges,
+                            std::size_t num_vertices,
+                            const CsrBuildOptions& options = {}) {
+    auto num_threads = detail::ResolveThreadCount(options.num_threads);
+    auto arrays = detail::BuildCsr<TVertex, detail::NoPayload>(
+        edges, num_vertices, options, num_threads, [](const Edge& edge) {
+          return detail::BuilderEdge<TVertex, detail::NoPayload>{
+              edge.first, edge.second, {}};
+        });
+    CsrGraph graph;
+    graph.offsets = std::move(arrays.offsets);
+    graph.targets = std::move(arrays.targets);
+    if (options.deduplicate) {
+      graph.Deduplicate(num_threads);
+    }
+    return graph;
+  }
+
+  /// @brief Gets the number of vertices
+  std::size_t NumVertices() const { return offsets.size() - 1; }
+
+  /// @brief Gets the number of directed edges (twice the undirected count)
+  std::size_t NumEdges() const { return targets.size(); }
+
+  /// @brief Gets the number of neighbors of a vertex
+  std::size_t Degree(TVertex vertex) const {
+    return static_cast<std::size_t>(offsets[vertex + 1] - offsets[vertex]);
+  }
+
+  /// @brief Gets the neighbors of a vertex. Does not bounds check.
+  NeighborRange Neighbors(TVertex vertex) const {
+    return NeighborRange(targets.data() + offsets[vertex],
+                         targets.data() + offsets[vertex + 1]);
+  }
+
+  /// @brief Gets the raw offsets array, NumVertices() + 1 entries
+  const std::vector<EdgeIndex>& Offsets() const { return offsets; }
+
+  /// @brief Gets the raw targets array, NumEdges() entries
+  const std::vector<TVertex>& Targets() const { return targets; }
+
+  /// @brief Gets the number of bytes held by the offsets and targets arrays
+  std::size_t MemoryBytes() const {
+    return offsets.capacity() * sizeof(EdgeIndex) +
+           targets.capacity() * sizeof(TVertex);
+  }
+
+ private:
+  std::vector<EdgeIndex> offsets;
+  std::vector<TVertex> targets;
+
+  /// @brief Sorts every adjacency list and compacts out duplicate neighbors
+  void Deduplicate(unsigned num_threads) {
+    auto num_vertices = NumVertices();
+    std::vector<EdgeIndex> unique_counts(num_vertices + 1, 0);
+    detail::ParallelChunks(
+        num_vertices, num_threads,
+        [&](unsigned, std::size_t begin, std::size_t end) {
+          for (auto v = begin; v < end; v++) {
+            auto first = targets.begin() + offsets[v];
+            auto last = targets.begin() + offsets[v + 1];
+            std::sort(first, last);
+            unique_counts[v] = std::unique(first, last) - first;
+          }
+        });
+    auto num_unique = detail::ExclusiveScan(unique_counts, num_threads);
+    unique_counts[num_vertices] = num_unique;
+    std::vector<TVertex> unique_targets(num_unique);
+    detail::ParallelChunks(
+        num_vertices, num_threads,
+        [&](unsigned, std::size_t begin, std::size_t end) {
+          for (auto v = begin; v < end; v++) {
+            std::copy_n(targets.begin() + offsets[v],
+                        unique_counts[v + 1] - unique_counts[v],
+                        unique_targets.begin() + unique_counts[v]);
+          }
+        });
+    offsets = std::move(unique_counts);
+    targets = std::move(unique_targets);
+  }
+};
+
+using CsrGraph32 = CsrGraph<std::uint32_t>;
+using CsrGraph64 = CsrGraph<std::uint64_t>;
+
+/// @brief Converts a pointer based UnweightedGraph into CSR form. Vertex i of
+/// the result is graph.nodes[i], so node values can be looked up by id.
+/// @param graph the graph to convert
+/// @return the CSR graph, with neighbors in the same order as the source
+/// @throws std::invalid_argument if a neighbor is not a node of this graph
+template <class TVertex = std::uint32_t, class T>
+CsrGraph<TVertex> ToCsr(const UnweightedGraph<T>& graph) {
+  using EdgeIndex = typename CsrGraph<TVertex>::EdgeIndex;
+  if (graph.nodes.size() > std::numeric_limits<TVertex>::max()) {
+    throw std::length_error(fmt::format(
+        "{} vertices do not fit in the vertex id type", graph.nodes.size()));
+  }
+  std::unordered_map<const UnweightedGraphNode<T>*, TVertex> ids;
+  ids.reserve(graph.nodes.size());
+  std::vector<EdgeIndex> offsets(graph.nodes.size() + 1, 0);
+  for (std::size_t i = 0; i < graph.nodes.size(); i++) {
+    ids.emplace(graph.nodes[i].get(), static_cast<TVertex>(i));
+    offsets[i + 1] = offsets[i] + graph.nodes[i]->neighbors.size();
+  }
+  std::vector<TVertex> targets;
+  targets.reserve(offsets.back());
+  for (const auto& node : graph.nodes) {
+    for (const auto* neighbor : node->neighbors) {
+      auto it = ids.find(neighbor);
+      if (it == ids.end()) {
+        throw std::invalid_argument("neighbor is not a node of this graph!");
+      }
+      targets.push_back(it->second);
+    }
+  }
+  return CsrGraph<TVertex>(std::move(offsets), std::move(targets));
+}
+
+}  // namespace graph
+}  // namespace nll
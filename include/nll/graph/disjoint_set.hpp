@@ -0,0 +1,215 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "nll/graph/csr_graph.hpp"
+
+namespace nll {
+namespace graph {
+
+/// @brief Union-find over the integers [0, size) with path compression and
+/// union by rank, giving near constant amortized Find and Union
+template <class TIndex = std::uint32_t>
+class DisjointSet {
+  static_assert(std::is_unsigned<TIndex>::value,
+                "indices must be an unsigned integer type");
+
+ public:
+  /// @brief Constructs size singleton sets
+  explicit DisjointSet(std::size_t size)
+      : parents(size), ranks(size, 0), num_sets(size) {
+    if (size > std::numeric_limits<TIndex>::max()) {
+      throw std::length_error(
+          fmt::format("{} elements do not fit in the index type", size));
+    }
+    for (std::size_t i = 0; i < size; i++) {
+      parents[i] = static_cast<TIndex>(i);
+    }
+  }
+
+  /// @brief Gets the number of elements
+  std::size_t Size() const { return parents.size(); }
+
+  /// @brief Gets the number of disjoint sets
+  std::size_t NumSets() const { return num_sets; }
+
+  /// @brief Finds the representative of x's set, pointing every element on
+  /// the way directly at it
+  /// @throws std::out_of_range if x is not an element
+  TIndex Find(TIndex x) {
+    CheckIndex(x);
+    auto root = x;
+    while (parents[root] != root) {
+      root = parents[root];
+    }
+    while (parents[x] != root) {
+      x = std::exchange(parents[x], root);
+    }
+    return root;
+  }
+
+  /// @brief Merges the sets containing a and b
+  /// @return true if they were in different sets
+  bool Union(TIndex a, TIndex b) {
+    a = Find(a);
+    b = Find(b);
+    if (a == b) {
+      return false;
+    }
+    if (ranks[a] < ranks[b]) {
+      std::swap(a, b);
+    }
+    parents[b] = a;
+    if (ranks[a] == ranks[b]) {
+      ranks[a]++;
+    }
+    num_sets--;
+    return true;
+  }
+
+  /// @brief Returns whether a and b are in the same set
+  bool Connected(TIndex a, TIndex b) { return Find(a) == Find(b); }
+
+ private:
+  std::vector<TIndex> parents;
+  std::vector<std::uint8_t> ranks;
+  std::size_t num_sets;
+
+  void CheckIndex(TIndex x) const {
+    if (x >= parents.size()) {
+      throw std::out_of_range(fmt::format(
+          "index {} is out of bounds for set of size {}", x, parents.size()));
+    }
+  }
+};
+
+/// @brief Lock-free union-find that many threads may Find and Union in at
+/// once. Roots are linked with a compare-and-swap, always hooking the larger
+/// index under the smaller one, so no cycles can form and the final
+/// representative of every set is its smallest element. Find shortens paths
+/// by halving, also with a compare-and-swap.
+template <class TIndex = std::uint32_t>
+class ConcurrentDisjointSet {
+  static_assert(std::is_unsigned<TIndex>::value,
+                "indices must be an unsigned integer type");
+
+ public:
+  /// @brief Constructs size singleton sets
+  explicit ConcurrentDisjointSet(std::size_t size) : parents(size) {
+    if (size > std::numeric_limits<TIndex>::max()) {
+      throw std::length_error(
+          fmt::format("{} elements do not fit in the index type", size));
+    }
+    for (std::size_t i = 0; i < size; i++) {
+      parents[i].store(static_cast<TIndex>(i), std::memory_order_relaxed);
+    }
+  }
+
+  /// @brief Gets the number of elements
+  std::size_t Size() const { return parents.size(); }
+
+  /// @brief Finds the current representative of x's set. Does not bounds
+  /// check, since it sits on the hot path of every concurrent union.
+  TIndex Find(TIndex x) {
+    while (true) {
+      auto parent = parents[x].load(std::memory_order_acquire);
+      if (parent == x) {
+        return x;
+      }
+      auto grandparent = parents[parent].load(std::memory_order_acquire);
+      if (grandparent != parent) {
+        parents[x].compare_exchange_weak(parent, grandparent,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed);
+      }
+      x = grandparent;
+    }
+  }
+
+  /// @brief Merges the sets containing a and b
+  /// @return true if this call linked two different sets
+  bool Union(TIndex a, TIndex b) {
+    while (true) {
+      a = Find(a);
+      b = Find(b);
+      if (a == b) {
+        return false;
+      }
+      if (a < b) {
+        std::swap(a, b);
+      }
+      // a is the larger root, hook it under b if nobody else moved it
+      auto expected = a;
+      if (parents[a].compare_exchange_strong(expected, b,
+                                             std::memory_order_acq_rel)) {
+        return true;
+      }
+    }
+  }
+
+  /// @brief Returns whether a and b are currently in the same set
+  bool Connected(TIndex a, TIndex b) {
+    while (true) {
+      a = Find(a);
+      b = Find(b);
+      if (a == b) {
+        return true;
+      }
+      // a may have been linked between the two finds, so only trust a root
+      if (parents[a].load(std::memory_order_acquire) == a) {
+        return false;
+      }
+    }
+  }
+
+  /// @brief Unions every pair in edges, split across num_threads threads
+  /// @throws std::out_of_range if an endpoint is not an element
+  void UnionAll(const std::vector<std::pair<TIndex, TIndex>>& edges,
+                unsigned num_threads = 0) {
+    for (const auto& edge : edges) {
+      if (edge.first >= Size() || edge.second >= Size()) {
+        throw std::out_of_range(fmt::format(
+            "edge ({}, {}) is out of bounds for set of size {}", edge.first,
+            edge.second, Size()));
+      }
+    }
+    detail::ParallelChunks(edges.size(),
+                           detail::ResolveThreadCount(num_threads),
+                           [&](unsigned, std::size_t begin, std::size_t end) {
+                             for (auto i = begin; i < end; i++) {
+                               Union(edges[i].first, edges[i].second);
+                             }
+                           });
+  }
+
+  /// @brief Points every element directly at its representative and returns
+  /// the representatives. Must not run concurrently with Union.
+  std::vector<TIndex> Labels(unsigned num_threads = 0) {
+    std::vector<TIndex> labels(Size());
+    detail::ParallelChunks(Size(), detail::ResolveThreadCount(num_threads),
+                           [&](unsigned, std::size_t begin, std::size_t end) {
+                             for (auto i = begin; i < end; i++) {
+                               auto root = Find(static_cast<TIndex>(i));
+                               parents[i].store(root,
+                                                std::memory_order_relaxed);
+                               labels[i] = root;
+                             }
+                           });
+    return labels;
+  }
+
+ private:
+  std::vector<std::atomic<TIndex>> parents;
+};
+
+}  // namespace graph
+}  // namespace nll
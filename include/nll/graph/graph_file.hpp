@@ -0,0 +1,623 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "nll/graph/csr_graph.hpp"
+#include "nll/graph/weighted_csr_graph.hpp"
+#include "nll/memory/mapped_file.hpp"
+
+namespace nll {
+namespace graph {
+
+/// On-disk layout of a graph file, all integers in native byte order:
+///
+///   GraphFileHeader            112 bytes at offset 0
+///   offsets  [V + 1] uint64    at header.offsets_offset
+///   targets  [E] vertex ids    at header.targets_offset
+///   weights  [E] (optional)    at header.weights_offset
+///   values   [V] (optional)    at header.values_offset
+///
+/// Every section starts on a 64 byte boundary so it can be used in place
+/// once the file is mapped. Each section has its own checksum, and the
+/// header has one over itself with header_checksum zeroed.
+struct GraphFileHeader {
+  static constexpr char kMagic[8] = {'N', 'L', 'L', 'C',
+                                     'S', 'R', '\0', '\0'};
+  static constexpr std::uint32_t kVersion = 1;
+  static constexpr std::uint32_t kByteOrderMark = 0x01020304;
+
+  /// @brief Element kinds for the optional weight and value sections
+  enum Kind : std::uint8_t {
+    kNone = 0,
+    kUnsigned = 1,
+    kSigned = 2,
+    kFloat = 3,
+  };
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order_mark;
+  std::uint8_t vertex_bytes;
+  std::uint8_t weight_kind;
+  std::uint8_t weight_bytes;
+  std::uint8_t value_kind;
+  std::uint32_t value_bytes;
+  std::uint64_t num_vertices;
+  std::uint64_t num_edges;
+  std::uint64_t offsets_offset;
+  std::uint64_t targets_offset;
+  std::uint64_t weights_offset;
+  std::uint64_t values_offset;
+  std::uint64_t offsets_checksum;
+  std::uint64_t targets_checksum;
+  std::uint64_t weights_checksum;
+  std::uint64_t values_checksum;
+  std::uint64_t header_checksum;
+};
+
+static_assert(sizeof(GraphFileHeader) == 112,
+              "graph file header layout must not change within a version");
+
+namespace detail {
+
+using nll::detail::Checksum64;
+using nll::detail::kSectionAlignment;
+using nll::detail::ReadOnlyMapping;
+
+template <class T>
+constexpr std::uint8_t KindOf() {
+  if (std::is_floating_point<T>::value) {
+    return GraphFileHeader::kFloat;
+  }
+  return std::is_signed<T>::value ? GraphFileHeader::kSigned
+                                  : GraphFileHeader::kUnsigned;
+}
+
+inline std::uint64_t HeaderChecksum(GraphFileHeader header) {
+  header.header_checksum = 0;
+  return Checksum64(&header, sizeof(header));
+}
+
+/// @brief Writes one section at its aligned offset and returns the offset
+template <class T>
+std::uint64_t WriteSection(std::ofstream& out, const std::vector<T>& data,
+                           std::uint64_t& checksum) {
+  return nll::detail::WriteAlignedSection(out, data.data(),
+                                          data.size() * sizeof(T), checksum);
+}
+
+template <class TVertex, class TWeight, class TValue>
+void WriteGraphFileImpl(const std::string& path,
+                        const std::vector<std::uint64_t>& offsets,
+                        const std::vector<TVertex>& targets,
+                        const std::vector<TWeight>* weights,
+                        const std::vector<TValue>* values) {
+  static_assert(std::is_trivially_copyable<TWeight>::value &&
+                    std::is_trivially_copyable<TValue>::value,
+                "weights and values must be trivially copyable");
+  if (values && values->size() != offsets.size() - 1) {
+    throw std::invalid_argument(fmt::format(
+        "got {} values for a graph with {} vertices", values->size(),
+        offsets.size() - 1));
+  }
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    throw std::runtime_error(fmt::format("cannot open {} for writing", path));
+  }
+  GraphFileHeader header{};
+  std::memcpy(header.magic, GraphFileHeader::kMagic, sizeof(header.magic));
+  header.version = GraphFileHeader::kVersion;
+  header.byte_order_mark = GraphFileHeader::kByteOrderMark;
+  header.vertex_bytes = sizeof(TVertex);
+  header.num_vertices = offsets.size() - 1;
+  header.num_edges = targets.size();
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  header.offsets_offset = WriteSection(out, offsets, header.offsets_checksum);
+  header.targets_offset = WriteSection(out, targets, header.targets_checksum);
+  if (weights) {
+    header.weight_kind = KindOf<TWeight>();
+    header.weight_bytes = sizeof(TWeight);
+    header.weights_offset =
+        WriteSection(out, *weights, header.weights_checksum);
+  }
+  if (values) {
+    header.value_kind = KindOf<TValue>();
+    header.value_bytes = sizeof(TValue);
+    header.values_offset = WriteSection(out, *values, header.values_checksum);
+  }
+  header.header_checksum = HeaderChecksum(header);
+  out.seekp(0);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (!out.flush()) {
+    throw std::runtime_error(fmt::format("failed writing {}", path));
+  }
+}
+
+}  // namespace detail
+
+/// @brief Writes a graph, and optionally one trivially copyable value per
+/// vertex, to a graph file
+/// @throws std::runtime_error if the file cannot be written
+template <class TVertex, class TValue = std::uint8_t>
+void WriteGraphFile(const std::string& path, const CsrGraph<TVertex>& graph,
+                    const std::vector<TValue>* values = nullptr) {
+  detail::WriteGraphFileImpl<TVertex, std::uint8_t, TValue>(
+      path, graph.Offsets(), graph.Targets(), nullptr, values);
+}
+
+/// @brief Writes a weighted graph, and optionally one trivially copyable
+/// value per vertex, to a graph file
+/// @throws std::runtime_error if the file cannot be written
+template <class TWeight, class TVertex, class TValue = std::uint8_t>
+void WriteGraphFile(const std::string& path,
+                    const WeightedCsrGraph<TWeight, TVertex>& graph,
+                    const std::vector<TValue>* values = nullptr) {
+  detail::WriteGraphFileImpl<TVertex, TWeight, TValue>(
+      path, graph.Offsets(), graph.Targets(), &graph.EdgeWeights(), values);
+}
+
+/// @brief Read-only CSR graph over borrowed arrays, with the same interface
+/// as CsrGraph so every graph algorithm runs on it unchanged
+template <class TVertex>
+class CsrGraphView {
+ public:
+  using VertexId = TVertex;
+  using EdgeIndex = std::uint64_t;
+  using NeighborRange = typename CsrGraph<TVertex>::NeighborRange;
+
+  CsrGraphView(const EdgeIndex* offsets, const TVertex* targets,
+               std::size_t num_vertices)
+      : offsets(offsets), targets(targets), num_vertices(num_vertices) {}
+
+  std::size_t NumVertices() const { return num_vertices; }
+
+  std::size_t NumEdges() const {
+    return static_cast<std::size_t>(offsets[num_vertices]);
+  }
+
+  std::size_t Degree(TVertex vertex) const {
+    return static_cast<std::size_t>(offsets[vertex + 1] - offsets[vertex]);
+  }
+
+  NeighborRange Neighbors(TVertex vertex) const {
+    return NeighborRange(targets + offsets[vertex],
+                         targets + offsets[vertex + 1]);
+  }
+
+ private:
+  const EdgeIndex* offsets;
+  const TVertex* targets;
+  std::size_t num_vertices;
+};
+
+/// @brief Read-only weighted CSR graph over borrowed arrays, with the same
+/// interface as WeightedCsrGraph
+template <class TWeight, class TVertex>
+class WeightedCsrGraphView : public CsrGraphView<TVertex> {
+ public:
+  using Weight = TWeight;
+  using WeightRange =
+      typename WeightedCsrGraph<TWeight, TVertex>::WeightRange;
+
+  WeightedCsrGraphView(const std::uint64_t* offsets, const TVertex* targets,
+                       const TWeight* weights, std::size_t num_vertices)
+      : CsrGraphView<TVertex>(offsets, targets, num_vertices),
+        offsets(offsets),
+        weights(weights) {}
+
+  WeightRange Weights(TVertex vertex) const {
+    return WeightRange(weights + offsets[vertex],
+                       weights + offsets[vertex + 1]);
+  }
+
+ private:
+  const std::uint64_t* offsets;
+  const TWeight* weights;
+};
+
+/// @brief Options for opening a MappedGraphFile
+struct GraphFileOptions {
+  /// @brief Checksum every section on open. Touches the whole file, so it
+  /// gives up the constant time open; the header is always checked.
+  bool verify_checksums = false;
+  /// @brief Check the offsets never decrease and every target id is below
+  /// the vertex count, so algorithms can index by them. Reads the offsets
+  /// and targets sections; only turn it off for files from a trusted writer.
+  bool verify_ids = true;
+  /// @brief Ask the kernel to fault the whole file in up front
+  bool populate = false;
+};
+
+/// @brief A graph file mapped read-only into memory. Opening does no parsing
+/// or copying, only validation: the header, and by default one read-only
+/// pass checking the vertex ids (see GraphFileOptions). Views point straight
+/// into the mapping and pages are faulted in as they are touched. The views
+/// must not outlive it.
+class MappedGraphFile {
+ public:
+  /// @brief Maps and validates the graph file at path
+  /// @throws std::system_error if the file cannot be opened or mapped
+  /// @throws std::runtime_error if the file is not a valid graph file
+  explicit MappedGraphFile(const std::string& path,
+                           const GraphFileOptions& options = {})
+      : mapping(path, options.populate) {
+    data = mapping.Data();
+    size = mapping.Size();
+    if (size < sizeof(GraphFileHeader)) {
+      throw std::runtime_error(
+          fmt::format("{} is too small to be a graph file", path));
+    }
+    Validate(path, options);
+  }
+
+  /// @brief Gets the validated file header
+  const GraphFileHeader& Header() const {
+    return *reinterpret_cast<const GraphFileHeader*>(data);
+  }
+
+  std::size_t NumVertices() const { return Header().num_vertices; }
+
+  std::size_t NumEdges() const { return Header().num_edges; }
+
+  bool HasWeights() const {
+    return Header().weight_kind != GraphFileHeader::kNone;
+  }
+
+  bool HasValues() const {
+    return Header().value_kind != GraphFileHeader::kNone;
+  }
+
+  /// @brief Gets the graph as a zero-copy view
+  /// @throws std::invalid_argument if TVertex does not match the file
+  template <class TVertex>
+  CsrGraphView<TVertex> Graph() const {
+    CheckVertexType<TVertex>();
+    return CsrGraphView<TVertex>(
+        Section<std::uint64_t>(Header().offsets_offset),
+        Section<TVertex>(Header().targets_offset), NumVertices());
+  }
+
+  /// @brief Gets the weighted graph as a zero-copy view
+  /// @throws std::invalid_argument if the types do not match the file
+  template <class TWeight, class TVertex>
+  WeightedCsrGraphView<TWeight, TVertex> WeightedGraph() const {
+    CheckVertexType<TVertex>();
+    if (Header().weight_kind != detail::KindOf<TWeight>() ||
+        Header().weight_bytes != sizeof(TWeight)) {
+      throw std::invalid_argument("weight type does not match the file!");
+    }
+    return WeightedCsrGraphView<TWeight, TVertex>(
+        Section<std::uint64_t>(Header().offsets_offset),
+        Section<TVertex>(Header().targets_offset),
+        Section<TWeight>(Header().weights_offset), NumVertices());
+  }
+
+  /// @brief Gets the per-vertex values, NumVertices() of them
+  /// @throws std::invalid_argument if TValue does not match the file
+  template <class TValue>
+  const TValue* Values() const {
+    if (Header().value_kind != detail::KindOf<TValue>() ||
+        Header().value_bytes != sizeof(TValue)) {
+      throw std::invalid_argument("value type does not match the file!");
+    }
+    return Section<TValue>(Header().values_offset);
+  }
+
+ private:
+  detail::ReadOnlyMapping mapping;
+  const unsigned char* data = nullptr;
+  std::size_t size = 0;
+
+  template <class T>
+  const T* Section(std::uint64_t offset) const {
+    return reinterpret_cast<const T*>(data + offset);
+  }
+
+  template <class TVertex>
+  void CheckVertexType() const {
+    if (Header().vertex_bytes != sizeof(TVertex)) {
+      throw std::invalid_argument(fmt::format(
+          "file has {} byte vertex ids, not {}", Header().vertex_bytes,
+          sizeof(TVertex)));
+    }
+  }
+
+  /// @brief Returns whether every id in a targets section is below
+  /// num_vertices
+  template <class TVertex>
+  bool TargetsInRange() const {
+    auto targets = Section<TVertex>(Header().targets_offset);
+    auto num_vertices = Header().num_vertices;
+    return std::all_of(targets, targets + Header().num_edges,
+                       [&](TVertex target) {
+                         return static_cast<std::uint64_t>(target) <
+                                num_vertices;
+                       });
+  }
+
+  bool TargetsInRange() const {
+    switch (Header().vertex_bytes) {
+      case 1:
+        return TargetsInRange<std::uint8_t>();
+      case 2:
+        return TargetsInRange<std::uint16_t>();
+      case 4:
+        return TargetsInRange<std::uint32_t>();
+      default:
+        return TargetsInRange<std::uint64_t>();
+    }
+  }
+
+  void Validate(const std::string& path,
+                const GraphFileOptions& options) const {
+    const auto& header = Header();
+    auto fail = [&](const char* reason) {
+      throw std::runtime_error(
+          fmt::format("{} is not a valid graph file: {}", path, reason));
+    };
+    if (std::memcmp(header.magic, GraphFileHeader::kMagic,
+                    sizeof(header.magic)) != 0) {
+      fail("bad magic");
+    }
+    if (header.version != GraphFileHeader::kVersion) {
+      fail("unsupported version");
+    }
+    if (header.byte_order_mark != GraphFileHeader::kByteOrderMark) {
+      fail("written with a different byte order");
+    }
+    if (detail::HeaderChecksum(header) != header.header_checksum) {
+      fail("header checksum mismatch");
+    }
+    // Bounded before anything computes num_vertices + 1
+    if (header.num_vertices >= std::numeric_limits<std::uint64_t>::max()) {
+      fail("vertex count out of range");
+    }
+    if (header.vertex_bytes != 1 && header.vertex_bytes != 2 &&
+        header.vertex_bytes != 4 && header.vertex_bytes != 8) {
+      fail("unsupported vertex id width");
+    }
+    // Check every section lies inside the file before anything reads it
+    auto section_fits = [&](std::uint64_t offset, std::uint64_t count,
+                            std::uint64_t element_bytes) {
+      return offset % detail::kSectionAlignment == 0 && offset <= size &&
+             count <= (size - offset) / std::max<std::uint64_t>(
+                                            1, element_bytes);
+    };
+    if (!section_fits(header.offsets_offset, header.num_vertices + 1, 8) ||
+        !section_fits(header.targets_offset, header.num_edges,
+                      header.vertex_bytes) ||
+        (header.weight_kind != GraphFileHeader::kNone &&
+         !section_fits(header.weights_offset, header.num_edges,
+                       header.weight_bytes)) ||
+        (header.value_kind != GraphFileHeader::kNone &&
+         !section_fits(header.values_offset, header.num_vertices,
+                       header.value_bytes))) {
+      fail("truncated");
+    }
+    auto offsets = Section<std::uint64_t>(header.offsets_offset);
+    if (offsets[0] != 0 || offsets[header.num_vertices] != header.num_edges) {
+      fail("offsets do not match the edge count");
+    }
+    if (options.verify_ids) {
+      if (!std::is_sorted(offsets, offsets + header.num_vertices + 1)) {
+        fail("offsets decrease");
+      }
+      if (!TargetsInRange()) {
+        fail("target id out of range");
+      }
+    }
+    if (!options.verify_checksums) {
+      return;
+    }
+    auto checksum = [&](std::uint64_t offset, std::uint64_t bytes) {
+      return detail::Checksum64(data + offset, bytes);
+    };
+    if (checksum(header.offsets_offset, (header.num_vertices + 1) * 8) !=
+            header.offsets_checksum ||
+        checksum(header.targets_offset,
+                 header.num_edges * header.vertex_bytes) !=
+            header.targets_checksum ||
+        (header.weight_kind != GraphFileHeader::kNone &&
+         checksum(header.weights_offset,
+                  header.num_edges * header.weight_bytes) !=
+             header.weights_checksum) ||
+        (header.value_kind != GraphFileHeader::kNone &&
+         checksum(header.values_offset,
+                  header.num_vertices * header.value_bytes) !=
+             header.values_checksum)) {
+      fail("section checksum mismatch");
+    }
+  }
+};
+
+namespace detail {
+
+/// @brief Parses one integer or floating point field and advances text
+template <class T>
+bool ParseField(const char*& first, const char* last, T& value) {
+  while (first < last && (*first == ' ' || *first == '\t' || *first == ',')) {
+    first++;
+  }
+  auto result = std::from_chars(first, last, value);
+  if (result.ec != std::errc()) {
+    return false;
+  }
+  first = result.ptr;
+  return true;
+}
+
+/// @brief Returns whether nothing but whitespace follows the parsed fields
+inline bool OnlyBlanksLeft(const char* first, const char* last) {
+  return std::all_of(first, last, [](char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+  });
+}
+
+template <class TVertex>
+bool ParseEdge(const char*& first, const char* last,
+               std::pair<TVertex, TVertex>& edge) {
+  return ParseField(first, last, edge.first) &&
+         ParseField(first, last, edge.second);
+}
+
+template <class TEdge>
+bool ParseEdge(const char*& first, const char* last, TEdge& edge) {
+  return ParseField(first, last, edge.source) &&
+         ParseField(first, last, edge.target) &&
+         ParseField(first, last, edge.weight);
+}
+
+}  // namespace detail
+
+/// @brief Parses a text edge list with one "source target [weight]" per line,
+/// separated by spaces, tabs or commas. Blank lines and lines starting with
+/// '#' or '%' are skipped. The text is split at line boundaries into one
+/// chunk per thread and parsed in parallel. A line with anything but
+/// whitespace after its fields is malformed.
+/// @tparam TEdge CsrGraph::Edge, or WeightedCsrGraph::Edge to read weights
+/// @throws std::invalid_argument naming the first malformed line's offset
+template <class TEdge>
+std::vector<TEdge> ParseEdgeList(std::string_view text,
+                                 unsigned num_threads = 0) {
+  num_threads = static_cast<unsigned>(std::max<std::size_t>(
+      1, std::min<std::size_t>(detail::ResolveThreadCount(num_threads),
+                               text.size() / detail::kMinItemsPerThread)));
+  std::vector<std::size_t> starts(num_threads + 1, text.size());
+  starts[0] = 0;
+  for (unsigned t = 1; t < num_threads; t++) {
+    auto newline = text.find('\n', text.size() * t / num_threads);
+    starts[t] = newline == std::string_view::npos
+                    ? text.size()
+                    : std::max(newline + 1, starts[t - 1]);
+  }
+  std::vector<std::vector<TEdge>> chunks(num_threads);
+  std::vector<std::size_t> bad_line(num_threads, text.size());
+  detail::ParallelChunks(
+      num_threads, num_threads,
+      [&](unsigned, std::size_t t_begin, std::size_t t_end) {
+        for (auto t = t_begin; t < t_end; t++) {
+          const char* first = text.data() + starts[t];
+          const char* chunk_end = text.data() + starts[t + 1];
+          while (first < chunk_end) {
+            auto line_end = static_cast<const char*>(
+                std::memchr(first, '\n', chunk_end - first));
+            if (!line_end) {
+              line_end = chunk_end;
+            }
+            auto line = first;
+            while (line < line_end && (*line == ' ' || *line == '\t' ||
+                                       *line == '\r')) {
+              line++;
+            }
+            if (line < line_end && *line != '#' && *line != '%') {
+              TEdge edge{};
+              if (!detail::ParseEdge(line, line_end, edge) ||
+                  !detail::OnlyBlanksLeft(line, line_end)) {
+                bad_line[t] = static_cast<std::size_t>(first - text.data());
+                return;
+              }
+              chunks[t].push_back(edge);
+            }
+            first = line_end + 1;
+          }
+        }
+      },
+      1);
+  for (unsigned t = 0; t < num_threads; t++) {
+    if (bad_line[t] != text.size()) {
+      throw std::invalid_argument(fmt::format(
+          "malformed edge list line at byte offset {}", bad_line[t]));
+    }
+  }
+  std::vector<TEdge> edges;
+  std::size_t total = 0;
+  for (const auto& chunk : chunks) {
+    total += chunk.size();
+  }
+  edges.reserve(total);
+  for (const auto& chunk : chunks) {
+    edges.insert(edges.end(), chunk.begin(), chunk.end());
+  }
+  return edges;
+}
+
+namespace detail {
+
+template <class TVertex>
+TVertex SourceOf(const std::pair<TVertex, TVertex>& edge) {
+  return edge.first;
+}
+
+template <class TVertex>
+TVertex TargetOf(const std::pair<TVertex, TVertex>& edge) {
+  return edge.second;
+}
+
+template <class TEdge>
+auto SourceOf(const TEdge& edge) {
+  return edge.source;
+}
+
+template <class TEdge>
+auto TargetOf(const TEdge& edge) {
+  return edge.target;
+}
+
+}  // namespace detail
+
+/// @brief Reads a text edge list file (see ParseEdgeList) into a graph. The
+/// file is mapped rather than streamed, parsed in parallel, and the graph
+/// is built with the parallel FromEdges. The vertex count is one more than
+/// the largest id seen.
+/// @tparam TGraph CsrGraph or WeightedCsrGraph
+template <class TGraph>
+TGraph ReadEdgeListFile(const std::string& path,
+                        const CsrBuildOptions& options = {}) {
+  detail::ReadOnlyMapping text(path, true);
+  auto edges = ParseEdgeList<typename TGraph::Edge>(
+      std::string_view(reinterpret_cast<const char*>(text.Data()),
+                       text.Size()),
+      options.num_threads);
+  std::vector<std::size_t> chunk_max(
+      detail::ResolveThreadCount(options.num_threads), 0);
+  detail::ParallelChunks(
+      edges.size(), static_cast<unsigned>(chunk_max.size()),
+      [&](unsigned t, std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; i++) {
+          chunk_max[t] = std::max<std::size_t>(
+              {chunk_max[t], detail::SourceOf(edges[i]) + std::size_t{1},
+               detail::TargetOf(edges[i]) + std::size_t{1}});
+        }
+      });
+  auto num_vertices = *std::max_element(chunk_max.begin(), chunk_max.end());
+  return TGraph::FromEdges(edges, num_vertices, options);
+}
+
+/// @brief Converts a text edge list file into a graph file
+/// @tparam TGraph CsrGraph or WeightedCsrGraph, picks the id and weight types
+/// @return the number of vertices and edges written
+template <class TGraph>
+std::pair<std::size_t, std::size_t> ConvertEdgeListToGraphFile(
+    const std::string& text_path, const std::string& graph_path,
+    const CsrBuildOptions& options = {}) {
+  auto graph = ReadEdgeListFile<TGraph>(text_path, options);
+  WriteGraphFile(graph_path, graph);
+  return {graph.NumVertices(), graph.NumEdges()};
+}
+
+}  // namespace graph
+}  // namespace nll
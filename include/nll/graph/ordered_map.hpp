@@ -0,0 +1,448 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "nll/graph/binary_tree.hpp"
+
+namespace nll {
+namespace binary_tree {
+
+/// @brief Ordered map backed by an AVL tree. Instead of a heap allocation
+/// per node with raw left/right pointers like Node<T>, every node lives in
+/// one contiguous arena and links are 32-bit indices into it, which halves
+/// link size and keeps nodes built together close in memory. Erased slots go
+/// on a free list and are reused by later inserts.
+/// @tparam TKey key type
+/// @tparam TValue mapped type
+/// @tparam TCompare strict weak ordering on keys
+template <class TKey, class TValue, class TCompare = std::less<TKey>>
+class OrderedMap {
+ private:
+  using Index = std::uint32_t;
+  static constexpr Index kNull = std::numeric_limits<Index>::max();
+
+  /// @brief Internal arena node, the index based cousin of Node<T>
+  struct ArenaNode {
+    TKey key;
+    TValue value;
+    Index left = kNull;
+    Index right = kNull;
+    Index parent = kNull;
+    std::uint8_t height = 1;
+
+    ArenaNode(TKey key, TValue value, Index parent)
+        : key(std::move(key)), value(std::move(value)), parent(parent) {}
+  };
+
+  std::vector<ArenaNode> nodes;
+  std::vector<Index> free_slots;
+  Index root = kNull;
+  std::size_t size = 0;
+  TCompare compare{};
+
+ public:
+  /// @brief Iterator type for class, visits entries in key order. Entries
+  /// are exposed as a pair of references, so keys cannot be modified.
+  struct Iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::pair<TKey, TValue>;
+    using reference = std::pair<const TKey&, TValue&>;
+
+    /// @brief Lets operator-> hand out a pointer to a temporary pair
+    struct pointer {
+      reference entry;
+      reference* operator->() { return &entry; }
+    };
+
+    Iterator(OrderedMap* map, Index index) : map(map), index(index) {}
+
+    reference operator*() const {
+      auto& node = map->nodes[index];
+      return reference(node.key, node.value);
+    };
+
+    pointer operator->() const { return pointer{**this}; };
+
+    Iterator& operator++() {
+      index = map->Successor(index);
+      return *this;
+    };
+
+    Iterator operator++(int) {
+      Iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    friend bool operator==(const Iterator& a, const Iterator& b) {
+      return a.index == b.index;
+    };
+    friend bool operator!=(const Iterator& a, const Iterator& b) {
+      return a.index != b.index;
+    };
+
+   private:
+    OrderedMap* map;
+    Index index;
+  };
+
+  /// @brief Half open range of iterators, usable in range-based for loops
+  struct EntryRange {
+    Iterator first;
+    Iterator last;
+
+    Iterator begin() const { return first; }
+
+    Iterator end() const { return last; }
+  };
+
+  OrderedMap() = default;
+
+  /// @brief Builds a perfectly balanced map from entries sorted by strictly
+  /// increasing key in O(n), with nodes laid out in key order
+  /// @throws std::invalid_argument if keys are not strictly increasing
+  static OrderedMap FromSorted(std::vector<std::pair<TKey, TValue>> entries) {
+    OrderedMap map;
+    for (std::size_t i = 1; i < entries.size(); i++) {
+      if (!map.compare(entries[i - 1].first, entries[i].first)) {
+        throw std::invalid_argument(
+            "entries must be sorted by strictly increasing key!");
+      }
+    }
+    CheckCapacity(entries.size());
+    map.nodes.reserve(entries.size());
+    for (auto& entry : entries) {
+      map.nodes.emplace_back(std::move(entry.first), std::move(entry.second),
+                             kNull);
+    }
+    map.root = map.BuildBalanced(0, static_cast<Index>(entries.size()), kNull);
+    map.size = entries.size();
+    return map;
+  }
+
+  Iterator begin() {
+    return Iterator(this, root == kNull ? kNull : Leftmost(root));
+  }
+
+  Iterator end() { return Iterator(this, kNull); }
+
+  /// @brief Gets the number of entries
+  std::size_t Size() const { return size; }
+
+  /// @brief Returns whether the map is empty or not
+  bool Empty() const { return size == 0; }
+
+  /// @brief Removes every entry and releases the arena
+  void Clear() {
+    nodes.clear();
+    free_slots.clear();
+    root = kNull;
+    size = 0;
+  }
+
+  /// @brief Inserts a key-value pair, overwriting the value if the key exists.
+  /// O(log n).
+  /// @return true if the key was newly inserted
+  bool Insert(TKey key, TValue value) {
+    auto [index, inserted] = FindOrInsert(std::move(key));
+    nodes[index].value = std::move(value);
+    return inserted;
+  }
+
+  /// @brief Removes a key. Invalidates iterators. O(log n).
+  /// @return true if the key was present
+  bool Erase(const TKey& key) {
+    auto index = FindIndex(key);
+    if (index == kNull) {
+      return false;
+    }
+    // Two children: move the successor's entry here, then unlink the
+    // successor, which has no left child
+    if (nodes[index].left != kNull && nodes[index].right != kNull) {
+      auto successor = Leftmost(nodes[index].right);
+      std::swap(nodes[index].key, nodes[successor].key);
+      std::swap(nodes[index].value, nodes[successor].value);
+      index = successor;
+    }
+    auto& node = nodes[index];
+    auto child = node.left != kNull ? node.left : node.right;
+    auto parent = node.parent;
+    ReplaceChild(parent, index, child);
+    if (child != kNull) {
+      nodes[child].parent = parent;
+    }
+    free_slots.push_back(index);
+    size--;
+    Retrace(parent);
+    return true;
+  }
+
+  /// @brief Checks if a key exists in the map
+  bool Contains(const TKey& key) const { return FindIndex(key) != kNull; }
+
+  /// @brief Gets the value associated with a key
+  /// @throws std::out_of_range if the key is not found
+  TValue& Get(const TKey& key) {
+    auto index = FindIndex(key);
+    if (index == kNull) {
+      throw std::out_of_range("key not found!");
+    }
+    return nodes[index].value;
+  }
+
+  /// @brief Gets the value for a key, default creating it if absent
+  TValue& operator[](TKey key) {
+    return nodes[FindOrInsert(std::move(key)).first].value;
+  }
+
+  /// @brief Finds the entry for a key, or end()
+  Iterator Find(const TKey& key) { return Iterator(this, FindIndex(key)); }
+
+  /// @brief Finds the first entry whose key is not less than key, or end()
+  Iterator LowerBound(const TKey& key) {
+    auto index = root;
+    auto best = kNull;
+    while (index != kNull) {
+      if (compare(nodes[index].key, key)) {
+        index = nodes[index].right;
+      } else {
+        best = index;
+        index = nodes[index].left;
+      }
+    }
+    return Iterator(this, best);
+  }
+
+  /// @brief Finds the first entry whose key is greater than key, or end()
+  Iterator UpperBound(const TKey& key) {
+    auto index = root;
+    auto best = kNull;
+    while (index != kNull) {
+      if (compare(key, nodes[index].key)) {
+        best = index;
+        index = nodes[index].left;
+      } else {
+        index = nodes[index].right;
+      }
+    }
+    return Iterator(this, best);
+  }
+
+  /// @brief Gets the entries with first <= key < last, in order
+  EntryRange Range(const TKey& first, const TKey& last) {
+    auto range_begin = LowerBound(first);
+    auto range_end = LowerBound(last);
+    if (!compare(first, last)) {
+      range_end = range_begin;
+    }
+    return EntryRange{range_begin, range_end};
+  }
+
+  /// @brief Verifies the AVL invariant from scratch, recomputing every
+  /// height instead of trusting the stored ones. O(n).
+  bool IsBalanced() const { return BalancedHeight(root) >= 0; }
+
+ private:
+  static void CheckCapacity(std::size_t count) {
+    if (count >= kNull) {
+      throw std::length_error(fmt::format(
+          "{} entries do not fit in 32-bit node indices", count));
+    }
+  }
+
+  int Height(Index index) const {
+    return index == kNull ? 0 : nodes[index].height;
+  }
+
+  int BalanceFactor(Index index) const {
+    return Height(nodes[index].left) - Height(nodes[index].right);
+  }
+
+  void UpdateHeight(Index index) {
+    nodes[index].height = static_cast<std::uint8_t>(
+        std::max(Height(nodes[index].left), Height(nodes[index].right)) + 1);
+  }
+
+  int BalancedHeight(Index index) const {
+    if (index == kNull) {
+      return 0;
+    }
+    auto left = BalancedHeight(nodes[index].left);
+    if (left < 0) {
+      return -1;
+    }
+    auto right = BalancedHeight(nodes[index].right);
+    if (right < 0 || std::abs(left - right) > 1) {
+      return -1;
+    }
+    return std::max(left, right) + 1;
+  }
+
+  Index Leftmost(Index index) const {
+    while (nodes[index].left != kNull) {
+      index = nodes[index].left;
+    }
+    return index;
+  }
+
+  Index Successor(Index index) const {
+    if (nodes[index].right != kNull) {
+      return Leftmost(nodes[index].right);
+    }
+    auto parent = nodes[index].parent;
+    while (parent != kNull && nodes[parent].right == index) {
+      index = parent;
+      parent = nodes[parent].parent;
+    }
+    return parent;
+  }
+
+  Index FindIndex(const TKey& key) const {
+    auto index = root;
+    while (index != kNull) {
+      if (compare(key, nodes[index].key)) {
+        index = nodes[index].left;
+      } else if (compare(nodes[index].key, key)) {
+        index = nodes[index].right;
+      } else {
+        return index;
+      }
+    }
+    return kNull;
+  }
+
+  /// @brief Finds key's node, or inserts a default valued one and rebalances
+  std::pair<Index, bool> FindOrInsert(TKey key) {
+    auto parent = kNull;
+    auto index = root;
+    bool go_left = false;
+    while (index != kNull) {
+      parent = index;
+      if (compare(key, nodes[index].key)) {
+        go_left = true;
+        index = nodes[index].left;
+      } else if (compare(nodes[index].key, key)) {
+        go_left = false;
+        index = nodes[index].right;
+      } else {
+        return {index, false};
+      }
+    }
+    auto created = Allocate(std::move(key), parent);
+    if (parent == kNull) {
+      root = created;
+    } else if (go_left) {
+      nodes[parent].left = created;
+    } else {
+      nodes[parent].right = created;
+    }
+    size++;
+    Retrace(parent);
+    return {created, true};
+  }
+
+  Index Allocate(TKey key, Index parent) {
+    if (!free_slots.empty()) {
+      auto index = free_slots.back();
+      free_slots.pop_back();
+      nodes[index] = ArenaNode(std::move(key), TValue(), parent);
+      return index;
+    }
+    CheckCapacity(nodes.size() + 1);
+    nodes.emplace_back(std::move(key), TValue(), parent);
+    return static_cast<Index>(nodes.size() - 1);
+  }
+
+  /// @brief Points parent (or the root) at new_child instead of old_child
+  void ReplaceChild(Index parent, Index old_child, Index new_child) {
+    if (parent == kNull) {
+      root = new_child;
+    } else if (nodes[parent].left == old_child) {
+      nodes[parent].left = new_child;
+    } else {
+      nodes[parent].right = new_child;
+    }
+  }
+
+  Index RotateLeft(Index x) {
+    auto y = nodes[x].right;
+    nodes[x].right = nodes[y].left;
+    if (nodes[y].left != kNull) {
+      nodes[nodes[y].left].parent = x;
+    }
+    nodes[y].parent = nodes[x].parent;
+    ReplaceChild(nodes[x].parent, x, y);
+    nodes[y].left = x;
+    nodes[x].parent = y;
+    UpdateHeight(x);
+    UpdateHeight(y);
+    return y;
+  }
+
+  Index RotateRight(Index x) {
+    auto y = nodes[x].left;
+    nodes[x].left = nodes[y].right;
+    if (nodes[y].right != kNull) {
+      nodes[nodes[y].right].parent = x;
+    }
+    nodes[y].parent = nodes[x].parent;
+    ReplaceChild(nodes[x].parent, x, y);
+    nodes[y].right = x;
+    nodes[x].parent = y;
+    UpdateHeight(x);
+    UpdateHeight(y);
+    return y;
+  }
+
+  /// @brief Walks from index up to the root fixing heights and rotating any
+  /// node whose subtrees differ in height by two
+  void Retrace(Index index) {
+    while (index != kNull) {
+      auto balance = BalanceFactor(index);
+      if (balance > 1) {
+        if (BalanceFactor(nodes[index].left) < 0) {
+          RotateLeft(nodes[index].left);
+        }
+        index = RotateRight(index);
+      } else if (balance < -1) {
+        if (BalanceFactor(nodes[index].right) > 0) {
+          RotateRight(nodes[index].right);
+        }
+        index = RotateLeft(index);
+      } else {
+        UpdateHeight(index);
+      }
+      index = nodes[index].parent;
+    }
+  }
+
+  /// @brief Links the already placed nodes [first, last) into a balanced
+  /// subtree and returns its root
+  Index BuildBalanced(Index first, Index last, Index parent) {
+    if (first >= last) {
+      return kNull;
+    }
+    auto middle = first + (last - first) / 2;
+    auto& node = nodes[middle];
+    node.parent = parent;
+    node.left = BuildBalanced(first, middle, middle);
+    node.right = BuildBalanced(middle + 1, last, middle);
+    UpdateHeight(middle);
+    return middle;
+  }
+};
+
+}  // namespace binary_tree
+}  // namespace nll
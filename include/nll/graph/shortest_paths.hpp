@@ -0,0 +1,358 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "nll/collections/indexed_heap.hpp"
+#include "nll/graph/csr_graph.hpp"
+#include "nll/parallel/parallel_for.hpp"
+
+namespace nll {
+namespace graph {
+
+namespace detail {
+
+/// @brief One worker's delta-stepping buckets, indexed by bucket number
+/// modulo a power of two. Pending buckets all lie within max weight / delta
+/// of the current one, so the ring only grows to that span however long
+/// the search runs, and drained buckets are reused with their capacity.
+template <class TVertex>
+class BucketRing {
+ public:
+  static constexpr std::size_t kNone = std::numeric_limits<std::size_t>::max();
+
+  /// @brief Files v into bucket, which must not be below current
+  void Push(std::size_t bucket, std::size_t current, TVertex v) {
+    if (bucket - current >= buckets.size()) {
+      Grow(bucket - current + 1, current);
+    }
+    buckets[bucket & (buckets.size() - 1)].push_back(v);
+  }
+
+  /// @brief Gets the first non-empty bucket at or after current, or kNone
+  std::size_t FirstNonEmpty(std::size_t current) const {
+    for (std::size_t i = 0; i < buckets.size(); i++) {
+      if (!buckets[(current + i) & (buckets.size() - 1)].empty()) {
+        return current + i;
+      }
+    }
+    return kNone;
+  }
+
+  /// @brief Moves the vertices of bucket to the end of out
+  void Drain(std::size_t bucket, std::vector<TVertex>& out) {
+    if (buckets.empty()) {
+      return;
+    }
+    auto& drained = buckets[bucket & (buckets.size() - 1)];
+    out.insert(out.end(), drained.begin(), drained.end());
+    drained.clear();
+  }
+
+ private:
+  std::vector<std::vector<TVertex>> buckets;
+
+  /// @brief Doubles the ring until it spans span buckets from current,
+  /// moving the pending ones to their new slots
+  void Grow(std::size_t span, std::size_t current) {
+    auto size = std::max<std::size_t>(buckets.size(), 8);
+    while (size < span) {
+      size *= 2;
+    }
+    std::vector<std::vector<TVertex>> grown(size);
+    for (std::size_t i = 0; i < buckets.size(); i++) {
+      auto bucket = current + i;
+      grown[bucket & (size - 1)] =
+          std::move(buckets[bucket & (buckets.size() - 1)]);
+    }
+    buckets = std::move(grown);
+  }
+};
+
+}  // namespace detail
+
+/// @brief Single source shortest paths by Dijkstra's algorithm with an
+/// indexed 4-ary heap and DecreaseKey. All per-query state is allocated once
+/// in the constructor and reset in O(vertices touched) by the next Run, so
+/// answering many queries does not allocate.
+/// @tparam TGraph a weighted CSR style graph such as WeightedCsrGraph,
+/// exposing VertexId, Weight, NumVertices(), Neighbors(v) and Weights(v)
+template <class TGraph>
+class Dijkstra {
+ public:
+  using VertexId = typename TGraph::VertexId;
+  using Weight = typename TGraph::Weight;
+
+  static constexpr Weight kInfinity = std::numeric_limits<Weight>::max();
+  static constexpr VertexId kNoVertex = std::numeric_limits<VertexId>::max();
+
+  /// @brief Prepares scratch space for searches over graph, which must
+  /// outlive this object
+  explicit Dijkstra(const TGraph& graph)
+      : graph(graph),
+        distances(graph.NumVertices(), kInfinity),
+        parents(graph.NumVertices(), kNoVertex),
+        heap(graph.NumVertices()) {
+    touched.reserve(graph.NumVertices());
+  }
+
+  /// @brief Computes shortest paths from source
+  /// @param source the vertex to start from
+  /// @param target if set, stop as soon as this vertex is settled. Only
+  /// vertices settled before it then have final distances.
+  /// @throws std::out_of_range if source is not a vertex of the graph
+  void Run(VertexId source, VertexId target = kNoVertex) {
+    if (source >= graph.NumVertices()) {
+      throw std::out_of_range(fmt::format(
+          "source {} is out of bounds for graph with {} vertices", source,
+          graph.NumVertices()));
+    }
+    for (auto v : touched) {
+      distances[v] = kInfinity;
+      parents[v] = kNoVertex;
+    }
+    touched.clear();
+    heap.Clear();
+
+    distances[source] = Weight{};
+    parents[source] = source;
+    touched.push_back(source);
+    heap.Push(source, Weight{});
+    while (!heap.Empty()) {
+      auto [u, distance] = heap.Pop();
+      if (u == target) {
+        return;
+      }
+      auto neighbors = graph.Neighbors(u);
+      auto weights = graph.Weights(u);
+      for (std::size_t i = 0; i < neighbors.size(); i++) {
+        auto v = neighbors[i];
+        auto candidate = distance + weights[i];
+        if (candidate < distances[v]) {
+          if (distances[v] == kInfinity) {
+            touched.push_back(v);
+          }
+          distances[v] = candidate;
+          parents[v] = u;
+          heap.PushOrDecrease(v, candidate);
+        }
+      }
+    }
+  }
+
+  /// @brief Gets the distance to v from the last source, or kInfinity
+  Weight Distance(VertexId v) const { return distances[v]; }
+
+  /// @brief Returns whether the last search reached v
+  bool Reached(VertexId v) const { return distances[v] != kInfinity; }
+
+  /// @brief Gets v's predecessor on its shortest path, the source is its own
+  /// parent, or kNoVertex if unreached
+  VertexId Parent(VertexId v) const { return parents[v]; }
+
+  /// @brief Gets the vertices on the shortest path from the last source to v
+  /// @return the path including both ends, or empty if v was not reached
+  std::vector<VertexId> PathTo(VertexId v) const {
+    std::vector<VertexId> path;
+    if (!Reached(v)) {
+      return path;
+    }
+    while (parents[v] != v) {
+      path.push_back(v);
+      v = parents[v];
+    }
+    path.push_back(v);
+    std::reverse(path.begin(), path.end());
+    return path;
+  }
+
+ private:
+  const TGraph& graph;
+  std::vector<Weight> distances;
+  std::vector<VertexId> parents;
+  IndexedDaryHeap<Weight, VertexId> heap;
+  std::vector<VertexId> touched;
+};
+
+/// @brief Tuning knobs for DeltaStepping
+struct DeltaSteppingOptions {
+  /// @brief Number of worker threads of a pool owned by the search, 0
+  /// shares parallel::DefaultPool
+  unsigned num_threads = 0;
+  /// @brief Width of a distance bucket. Around the average edge weight is a
+  /// good start; larger buckets mean more parallelism and more rework.
+  double delta = 1.0;
+};
+
+/// @brief Parallel single source shortest paths by delta-stepping (Meyer and
+/// Sanders, in the bucket-per-thread form of the GAP suite). Vertices are
+/// bucketed by floor(distance / delta). Each round, one task per worker
+/// slot claims blocks of the current bucket, relaxes them with an atomic
+/// compare-and-swap minimum and files improved vertices into its own
+/// buckets; the next round starts from the smallest non-empty bucket of any
+/// slot. Tasks run on a parallel::ThreadPool. Buckets and distances live as
+/// long as this object and are reset in O(vertices touched), so once the
+/// buckets have grown to size a query only allocates the pool's tasks, one
+/// per slot and round.
+/// @tparam TGraph a weighted CSR style graph such as WeightedCsrGraph
+template <class TGraph>
+class DeltaStepping {
+ public:
+  using VertexId = typename TGraph::VertexId;
+  using Weight = typename TGraph::Weight;
+
+  static constexpr Weight kInfinity = std::numeric_limits<Weight>::max();
+
+  /// @brief Prepares scratch space for searches over graph, which must
+  /// outlive this object
+  /// @throws std::invalid_argument if options.delta is not positive
+  explicit DeltaStepping(const TGraph& graph,
+                         const DeltaSteppingOptions& options = {})
+      : graph(graph),
+        delta(static_cast<Weight>(options.delta)),
+        owned_pool(MakePool(options.num_threads)),
+        pool(owned_pool ? *owned_pool : parallel::DefaultPool()),
+        distances(graph.NumVertices()),
+        local_buckets(pool.WorkerCount() + 1),
+        local_touched(pool.WorkerCount() + 1) {
+    if (!(delta > Weight{})) {
+      throw std::invalid_argument("delta must be positive!");
+    }
+    for (auto& distance : distances) {
+      distance.store(kInfinity, std::memory_order_relaxed);
+    }
+  }
+
+  /// @brief Computes shortest path distances from source
+  /// @throws std::out_of_range if source is not a vertex of the graph
+  void Run(VertexId source) {
+    if (source >= graph.NumVertices()) {
+      throw std::out_of_range(fmt::format(
+          "source {} is out of bounds for graph with {} vertices", source,
+          graph.NumVertices()));
+    }
+    for (auto& touched : local_touched) {
+      for (auto v : touched) {
+        distances[v].store(kInfinity, std::memory_order_relaxed);
+      }
+      touched.clear();
+    }
+    distances[source].store(Weight{}, std::memory_order_relaxed);
+    local_touched[0].push_back(source);
+    frontier.assign(1, source);
+    current_bucket = 0;
+    while (!frontier.empty()) {
+      next_index.store(0, std::memory_order_relaxed);
+      // One task per slot, each claiming frontier blocks until none are
+      // left, so a slot's buckets are only ever touched by one thread
+      parallel::ParallelFor(
+          std::size_t{0}, local_buckets.size(),
+          [this](std::size_t slot) { RelaxFrontier(slot); }, 1, pool);
+      NextBucket();
+    }
+  }
+
+  /// @brief Gets the distance to v from the last source, or kInfinity
+  Weight Distance(VertexId v) const {
+    return distances[v].load(std::memory_order_relaxed);
+  }
+
+  /// @brief Returns whether the last search reached v
+  bool Reached(VertexId v) const { return Distance(v) != kInfinity; }
+
+ private:
+  using Buckets = detail::BucketRing<VertexId>;
+
+  static constexpr std::size_t kFrontierBlock = 64;
+
+  const TGraph& graph;
+  Weight delta;
+  std::unique_ptr<parallel::ThreadPool> owned_pool;
+  parallel::ThreadPool& pool;
+  std::vector<std::atomic<Weight>> distances;
+  std::vector<Buckets> local_buckets;
+  std::vector<std::vector<VertexId>> local_touched;
+  std::vector<VertexId> frontier;
+  std::size_t current_bucket = 0;
+  std::atomic<std::size_t> next_index{0};
+
+  static std::unique_ptr<parallel::ThreadPool> MakePool(unsigned threads) {
+    if (threads == 0) {
+      return nullptr;
+    }
+    parallel::ThreadPoolOptions options;
+    options.threads = threads;
+    return std::make_unique<parallel::ThreadPool>(options);
+  }
+
+  std::size_t BucketOf(Weight distance) const {
+    return static_cast<std::size_t>(distance / delta);
+  }
+
+  /// @brief Relaxes frontier blocks into the slot's buckets until the
+  /// frontier is used up
+  void RelaxFrontier(std::size_t slot) {
+    auto& buckets = local_buckets[slot];
+    auto& touched = local_touched[slot];
+    auto claim = [this] { return next_index.fetch_add(kFrontierBlock); };
+    for (auto block = claim(); block < frontier.size(); block = claim()) {
+      auto end = std::min(block + kFrontierBlock, frontier.size());
+      for (auto i = block; i < end; i++) {
+        Relax(frontier[i], buckets, touched);
+      }
+    }
+  }
+
+  /// @brief Moves on to the smallest non-empty bucket of any slot and
+  /// gathers it into the frontier, which stays empty once all are drained
+  void NextBucket() {
+    frontier.clear();
+    auto next = Buckets::kNone;
+    for (const auto& buckets : local_buckets) {
+      next = std::min(next, buckets.FirstNonEmpty(current_bucket));
+    }
+    if (next == Buckets::kNone) {
+      return;
+    }
+    current_bucket = next;
+    for (auto& buckets : local_buckets) {
+      buckets.Drain(current_bucket, frontier);
+    }
+  }
+
+  void Relax(VertexId u, Buckets& buckets, std::vector<VertexId>& touched) {
+    auto distance = distances[u].load(std::memory_order_relaxed);
+    // Stale entry, u already settled from an earlier bucket
+    if (BucketOf(distance) < current_bucket) {
+      return;
+    }
+    auto neighbors = graph.Neighbors(u);
+    auto weights = graph.Weights(u);
+    for (std::size_t i = 0; i < neighbors.size(); i++) {
+      auto v = neighbors[i];
+      auto candidate = distance + weights[i];
+      auto old = distances[v].load(std::memory_order_relaxed);
+      while (candidate < old) {
+        if (distances[v].compare_exchange_weak(old, candidate,
+                                               std::memory_order_relaxed)) {
+          if (old == kInfinity) {
+            touched.push_back(v);
+          }
+          buckets.Push(BucketOf(candidate), current_bucket, v);
+          break;
+        }
+      }
+    }
+  }
+};
+
+}  // namespace graph
+}  // namespace nll
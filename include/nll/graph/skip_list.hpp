@@ -0,0 +1,464 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <random>
+#include <thread>
+#include <utility>
+
+#include "nll/memory/epoch_domain.hpp"
+
+namespace nll {
+namespace binary_tree {
+
+/// @brief Lock-free ordered map over a skip list (Fraser's design, as in
+/// Herlihy & Shavit, "The Art of Multiprocessor Programming", ch. 14). Any
+/// number of threads may Insert, Erase, Find, LowerBound and Scan at once:
+/// every update is a compare-and-swap on one link, and readers take no locks
+/// and never retry.
+///
+/// Each node keeps its tower of next links inline after the entry, so a
+/// node is one allocation, carved from chunks of a shared arena with an
+/// atomic bump pointer. Erase marks a node's links and unlinks it, and the
+/// node is reclaimed through an EpochDomain once no reader can still be on
+/// it; reclaimed nodes go on a free list per tower height for later
+/// inserts, and memory returns upstream only when the list is destroyed.
+///
+/// Insert does not overwrite: a key keeps the value it was inserted with
+/// until erased. Scan is weakly consistent, it sees every entry present for
+/// the whole scan and may or may not see ones inserted or erased meanwhile.
+/// @tparam TKey key type
+/// @tparam TValue mapped type
+/// @tparam TCompare strict weak ordering on keys
+template <class TKey, class TValue, class TCompare = std::less<TKey>>
+class ConcurrentSkipList {
+  using Link = std::atomic<std::uintptr_t>;
+
+  /// @brief Tall enough for 4^16 entries at one level per 4 nodes
+  static constexpr int kMaxHeight = 16;
+  static constexpr std::uintptr_t kMarked = 1;
+
+  /// @brief An entry followed by height links, each tagged with kMarked once
+  /// the node is being erased at that level
+  struct alignas(alignof(Link)) Node {
+    TKey key;
+    TValue value;
+    int height;
+
+    Node(TKey key, TValue value, int height)
+        : key(std::move(key)), value(std::move(value)), height(height) {}
+
+    Link* Tower() const { return TowerOf(this); }
+
+    Link& Next(int level) const { return Tower()[level]; }
+  };
+
+  static constexpr std::size_t kTowerOffset =
+      (sizeof(Node) + alignof(Link) - 1) / alignof(Link) * alignof(Link);
+
+  /// @brief Gets the links after a node's memory, whether or not the entry
+  /// in it is alive
+  static Link* TowerOf(const void* node) {
+    return reinterpret_cast<Link*>(const_cast<std::byte*>(
+        static_cast<const std::byte*>(node) + kTowerOffset));
+  }
+
+  static std::size_t NodeBytes(int height) {
+    return kTowerOffset + height * sizeof(Link);
+  }
+
+  static Node* Pointer(std::uintptr_t link) {
+    return reinterpret_cast<Node*>(link & ~kMarked);
+  }
+
+  static bool Marked(std::uintptr_t link) { return (link & kMarked) != 0; }
+
+  static std::uintptr_t Tag(Node* node) {
+    return reinterpret_cast<std::uintptr_t>(node);
+  }
+
+  /// @brief Chunked bump allocator shared by all threads. The bump is a
+  /// fetch_add on the current chunk; only starting a new chunk takes a lock.
+  class NodeArena {
+    struct Chunk {
+      Chunk* next;
+      std::size_t bytes;
+      std::atomic<std::size_t> used;
+    };
+
+    static constexpr std::size_t kHeaderBytes =
+        (sizeof(Chunk) + alignof(Node) - 1) / alignof(Node) * alignof(Node);
+    static constexpr std::size_t kMaxChunkBytes = std::size_t{1} << 24;
+
+    std::pmr::memory_resource* upstream;
+    std::atomic<Chunk*> current{nullptr};
+    std::mutex grow_mutex;
+    std::size_t next_chunk_bytes = std::size_t{1} << 16;
+
+   public:
+    explicit NodeArena(std::pmr::memory_resource* upstream)
+        : upstream(upstream) {}
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    ~NodeArena() {
+      auto* chunk = current.load(std::memory_order_relaxed);
+      while (chunk != nullptr) {
+        auto* next = chunk->next;
+        upstream->deallocate(chunk, chunk->bytes, alignof(Node));
+        chunk = next;
+      }
+    }
+
+    void* Allocate(std::size_t bytes) {
+      bytes = (bytes + alignof(Node) - 1) / alignof(Node) * alignof(Node);
+      while (true) {
+        auto* chunk = current.load(std::memory_order_acquire);
+        if (chunk != nullptr) {
+          auto offset = chunk->used.fetch_add(bytes, std::memory_order_relaxed);
+          if (offset + bytes <= chunk->bytes) {
+            return reinterpret_cast<std::byte*>(chunk) + offset;
+          }
+        }
+        std::lock_guard<std::mutex> lock(grow_mutex);
+        if (current.load(std::memory_order_relaxed) == chunk) {
+          auto chunk_bytes = std::max(next_chunk_bytes, kHeaderBytes + bytes);
+          auto* fresh = static_cast<Chunk*>(
+              upstream->allocate(chunk_bytes, alignof(Node)));
+          fresh->next = chunk;
+          fresh->bytes = chunk_bytes;
+          new (&fresh->used) std::atomic<std::size_t>(kHeaderBytes);
+          next_chunk_bytes = std::min(next_chunk_bytes * 2, kMaxChunkBytes);
+          current.store(fresh, std::memory_order_release);
+        }
+      }
+    }
+  };
+
+  NodeArena arena;
+  /// @brief Reclaimed nodes by height, linked through their first link.
+  /// Only epoch reclamation pushes, so a node cannot come back to the top
+  /// while a pinned thread is popping it.
+  std::atomic<Node*> free_nodes[kMaxHeight + 1] = {};
+  mutable memory::EpochDomain epochs;
+  Link head[kMaxHeight] = {};
+  std::atomic<int> height{1};
+  std::atomic<std::size_t> size{0};
+  TCompare compare{};
+
+  static int RandomHeight() {
+    thread_local std::minstd_rand random(static_cast<unsigned>(
+        std::hash<std::thread::id>{}(std::this_thread::get_id())));
+    int levels = 1;
+    while (levels < kMaxHeight && (random() & 3) == 0) {
+      levels++;
+    }
+    return levels;
+  }
+
+  /// @brief Takes a node of the given height from its free list or the
+  /// arena and builds the entry in it. The caller must be pinned.
+  Node* NewNode(const TKey& key, const TValue& value, int levels) {
+    auto& free_list = free_nodes[levels];
+    auto* memory = free_list.load(std::memory_order_acquire);
+    while (memory != nullptr &&
+           !free_list.compare_exchange_weak(
+               memory, Pointer(TowerOf(memory)[0].load(
+                           std::memory_order_relaxed)),
+               std::memory_order_acquire, std::memory_order_acquire)) {
+    }
+    if (memory != nullptr) {
+      // A pinned thread popping this node may still load its first link
+      for (int level = 0; level < levels; level++) {
+        TowerOf(memory)[level].store(0, std::memory_order_relaxed);
+      }
+      return new (memory) Node(key, value, levels);
+    }
+    void* storage = arena.Allocate(NodeBytes(levels));
+    for (int level = 0; level < levels; level++) {
+      new (TowerOf(storage) + level) Link(0);
+    }
+    return new (storage) Node(key, value, levels);
+  }
+
+  /// @brief Destroys the entry of a node no thread can reach and puts it on
+  /// the free list of its height
+  static void Recycle(void* retired, void* list) {
+    auto* node = static_cast<Node*>(retired);
+    auto levels = node->height;
+    node->~Node();
+    // The links outlive the entry, as the free list runs through them
+    auto* self = static_cast<ConcurrentSkipList*>(list);
+    auto& free_list = self->free_nodes[levels];
+    auto* top = free_list.load(std::memory_order_relaxed);
+    do {
+      TowerOf(node)[0].store(Tag(top), std::memory_order_relaxed);
+    } while (!free_list.compare_exchange_weak(top, node,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+  }
+
+  bool Less(const TKey& a, const TKey& b) const { return compare(a, b); }
+
+  /// @brief Finds, at every level, the last node before key and the first
+  /// at or after it, unlinking marked nodes on the way
+  /// @return whether the node found at level 0 holds key
+  bool Search(const TKey& key, Link** preds, Node** succs) {
+  retry:
+    Link* pred = head;
+    for (int level = kMaxHeight - 1; level >= 0; level--) {
+      auto* current = Pointer(pred[level].load(std::memory_order_acquire));
+      while (current != nullptr) {
+        auto next = current->Next(level).load(std::memory_order_acquire);
+        if (Marked(next)) {
+          auto expected = Tag(current);
+          if (!pred[level].compare_exchange_strong(
+                  expected, next & ~kMarked, std::memory_order_acq_rel,
+                  std::memory_order_acquire)) {
+            goto retry;
+          }
+          current = Pointer(next);
+        } else if (Less(current->key, key)) {
+          pred = current->Tower();
+          current = Pointer(next);
+        } else {
+          break;
+        }
+      }
+      preds[level] = pred;
+      succs[level] = current;
+    }
+    return succs[0] != nullptr && !Less(key, succs[0]->key);
+  }
+
+  /// @brief Finds the first live node at or after key without writing
+  const Node* Seek(const TKey& key) const {
+    const Link* pred = head;
+    auto top = height.load(std::memory_order_relaxed);
+    const Node* current = nullptr;
+    for (int level = top - 1; level >= 0; level--) {
+      current = Pointer(pred[level].load(std::memory_order_acquire));
+      while (current != nullptr) {
+        auto next = current->Next(level).load(std::memory_order_acquire);
+        if (!Marked(next) && !Less(current->key, key)) {
+          break;
+        }
+        if (!Marked(next)) {
+          pred = current->Tower();
+        }
+        current = Pointer(next);
+      }
+    }
+    return current;
+  }
+
+  /// @brief Follows level 0 to the next node not erased, from current on
+  static const Node* SkipErased(const Node* current) {
+    while (current != nullptr) {
+      auto next = current->Next(0).load(std::memory_order_acquire);
+      if (!Marked(next)) {
+        return current;
+      }
+      current = Pointer(next);
+    }
+    return nullptr;
+  }
+
+  void RaiseHeight(int levels) {
+    auto top = height.load(std::memory_order_relaxed);
+    while (top < levels && !height.compare_exchange_weak(
+                               top, levels, std::memory_order_relaxed)) {
+    }
+  }
+
+ public:
+  /// @param upstream where the node arena takes its chunks from
+  explicit ConcurrentSkipList(
+      std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+      : arena(upstream) {}
+
+  ConcurrentSkipList(const ConcurrentSkipList&) = delete;
+  ConcurrentSkipList& operator=(const ConcurrentSkipList&) = delete;
+
+  /// @brief Destroys the entries. No other thread may use the list.
+  ~ConcurrentSkipList() {
+    auto* node = Pointer(head[0].load(std::memory_order_acquire));
+    while (node != nullptr) {
+      auto* next = Pointer(node->Next(0).load(std::memory_order_relaxed));
+      node->~Node();
+      node = next;
+    }
+  }
+
+  /// @brief Gets the number of entries, exact once updates have finished
+  std::size_t Size() const { return size.load(std::memory_order_relaxed); }
+
+  /// @brief Returns whether the list is empty or not
+  bool Empty() const { return Size() == 0; }
+
+  /// @brief Inserts a key-value pair if the key is absent
+  /// @return true if the key was inserted, false if it was already present
+  bool Insert(const TKey& key, const TValue& value) {
+    auto guard = epochs.Pin();
+    Link* preds[kMaxHeight];
+    Node* succs[kMaxHeight];
+    auto levels = RandomHeight();
+    Node* node = nullptr;
+    while (true) {
+      if (Search(key, preds, succs)) {
+        if (node != nullptr) {
+          // Never published, but a free list pop may still be reading it
+          guard.Retire(node, &ConcurrentSkipList::Recycle, this);
+        }
+        return false;
+      }
+      if (node == nullptr) {
+        node = NewNode(key, value, levels);
+      }
+      for (int level = 0; level < levels; level++) {
+        node->Next(level).store(Tag(succs[level]), std::memory_order_relaxed);
+      }
+      auto expected = Tag(succs[0]);
+      if (preds[0][0].compare_exchange_strong(expected, Tag(node),
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+        break;
+      }
+    }
+    size.fetch_add(1, std::memory_order_relaxed);
+    RaiseHeight(levels);
+    // The entry is in; link the upper levels, stopping if it gets erased
+    for (int level = 1; level < levels; level++) {
+      while (true) {
+        auto next = node->Next(level).load(std::memory_order_acquire);
+        if (Marked(next)) {
+          return true;
+        }
+        if (Pointer(next) != succs[level] &&
+            !node->Next(level).compare_exchange_strong(
+                next, Tag(succs[level]), std::memory_order_release,
+                std::memory_order_relaxed)) {
+          continue;
+        }
+        auto expected = Tag(succs[level]);
+        if (preds[level][level].compare_exchange_strong(
+                expected, Tag(node), std::memory_order_release,
+                std::memory_order_relaxed)) {
+          if (Marked(node->Next(level).load(std::memory_order_acquire))) {
+            // Erased while linking: the eraser may have already searched
+            // past this level, so unlink it here before unpinning
+            Search(key, preds, succs);
+            return true;
+          }
+          break;
+        }
+        if (!Search(key, preds, succs) || succs[0] != node) {
+          return true;
+        }
+      }
+    }
+    return true;
+  }
+
+  /// @brief Removes key
+  /// @return true if this call removed it
+  bool Erase(const TKey& key) {
+    auto guard = epochs.Pin();
+    Link* preds[kMaxHeight];
+    Node* succs[kMaxHeight];
+    if (!Search(key, preds, succs)) {
+      return false;
+    }
+    auto* node = succs[0];
+    for (int level = node->height - 1; level >= 1; level--) {
+      auto next = node->Next(level).load(std::memory_order_relaxed);
+      while (!Marked(next) &&
+             !node->Next(level).compare_exchange_weak(
+                 next, next | kMarked, std::memory_order_acq_rel,
+                 std::memory_order_relaxed)) {
+      }
+    }
+    // Marking level 0 is the linearization point; one eraser wins it
+    auto next = node->Next(0).load(std::memory_order_relaxed);
+    while (true) {
+      if (Marked(next)) {
+        return false;
+      }
+      if (node->Next(0).compare_exchange_weak(next, next | kMarked,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_relaxed)) {
+        break;
+      }
+    }
+    size.fetch_sub(1, std::memory_order_relaxed);
+    Search(key, preds, succs);
+    guard.Retire(node, &ConcurrentSkipList::Recycle, this);
+    return true;
+  }
+
+  /// @brief Finds the value of key
+  std::optional<TValue> Find(const TKey& key) const {
+    auto guard = epochs.Pin();
+    auto* node = SkipErased(Seek(key));
+    if (node == nullptr || Less(key, node->key)) {
+      return std::nullopt;
+    }
+    return node->value;
+  }
+
+  /// @brief Checks if a key exists in the list
+  bool Contains(const TKey& key) const { return Find(key).has_value(); }
+
+  /// @brief Finds the first entry with a key not less than key
+  std::optional<std::pair<TKey, TValue>> LowerBound(const TKey& key) const {
+    auto guard = epochs.Pin();
+    auto* node = SkipErased(Seek(key));
+    if (node == nullptr) {
+      return std::nullopt;
+    }
+    return std::pair<TKey, TValue>(node->key, node->value);
+  }
+
+  /// @brief Calls fn(key, value) on entries with keys not less than from, in
+  /// increasing key order, until fn returns false. The calling thread stays
+  /// pinned for the whole scan.
+  /// @return the number of entries passed to fn
+  template <class TFunction>
+  std::size_t Scan(const TKey& from, TFunction&& fn) const {
+    auto guard = epochs.Pin();
+    std::size_t visited = 0;
+    for (auto* node = SkipErased(Seek(from)); node != nullptr;
+         node = SkipErased(
+             Pointer(node->Next(0).load(std::memory_order_acquire)))) {
+      visited++;
+      if (!fn(node->key, node->value)) {
+        break;
+      }
+    }
+    return visited;
+  }
+
+  /// @brief Calls fn(key, value) on every entry in increasing key order
+  template <class TFunction>
+  void ForEach(TFunction&& fn) const {
+    auto guard = epochs.Pin();
+    for (auto* node = SkipErased(Pointer(head[0].load(
+             std::memory_order_acquire)));
+         node != nullptr;
+         node = SkipErased(
+             Pointer(node->Next(0).load(std::memory_order_acquire)))) {
+      fn(node->key, node->value);
+    }
+  }
+};
+
+}  // namespace binary_tree
+}  // namespace nll
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "nll/graph/binary_tree.hpp"
+
+namespace nll {
+namespace binary_tree {
+
+namespace detail {
+
+/// @brief Allocator handing out kAlignment aligned blocks, so element 0 of a
+/// vector starts a cache line
+template <class T, std::size_t kAlignment>
+struct AlignedAllocator {
+  using value_type = T;
+
+  template <class U>
+  struct rebind {
+    using other = AlignedAllocator<U, kAlignment>;
+  };
+
+  AlignedAllocator() = default;
+
+  template <class U>
+  AlignedAllocator(const AlignedAllocator<U, kAlignment>&) {}
+
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(
+        ::operator new(n * sizeof(T), std::align_val_t(kAlignment)));
+  }
+
+  void deallocate(T* pointer, std::size_t) {
+    ::operator delete(pointer, std::align_val_t(kAlignment));
+  }
+
+  friend bool operator==(const AlignedAllocator&, const AlignedAllocator&) {
+    return true;
+  }
+  friend bool operator!=(const AlignedAllocator&, const AlignedAllocator&) {
+    return false;
+  }
+};
+
+}  // namespace detail
+
+/// @brief Memory order of the nodes of a StaticSearchTree
+enum class SearchTreeLayout {
+  /// @brief Breadth-first order: node k has children 2k and 2k + 1. The next
+  /// four levels below a node share a few cache lines, so they are
+  /// prefetched while the node is compared.
+  kEytzinger,
+  /// @brief van Emde Boas order: the top half of the levels is stored first,
+  /// followed by each subtree hanging off it, recursively. Every subtree of
+  /// height h lies in 2^h consecutive slots, so a search touches
+  /// O(log_B n) blocks at every level of the memory hierarchy, including
+  /// pages. The tree is padded to a complete one, using up to twice the
+  /// space.
+  kVanEmdeBoas,
+};
+
+/// @brief Read-only sorted set laid out as an implicit binary search tree.
+/// Unlike a sorted vector, whose binary search jumps across the array and
+/// misses cache on nearly every probe once it outgrows L2, the first levels
+/// of the tree stay hot and the descent is branchless.
+/// @tparam T element type
+/// @tparam TCompare strict weak ordering on elements
+template <class T, class TCompare = std::less<T>>
+class StaticSearchTree {
+  static constexpr std::size_t kCacheLineBytes = 64;
+  // The Eytzinger descendants of slot k that are log2(kPrefetchStride)
+  // levels down fill the cache line starting at slot kPrefetchStride * k
+  static constexpr std::size_t kPrefetchStride =
+      std::max<std::size_t>(1, kCacheLineBytes / sizeof(T));
+
+  using Rank = std::uint32_t;
+  static constexpr std::size_t kNoSlot =
+      std::numeric_limits<std::size_t>::max();
+
+ public:
+  StaticSearchTree() = default;
+
+  /// @brief Builds the tree from a sorted range. Duplicates are allowed.
+  /// O(n).
+  /// @throws std::invalid_argument if the range is not sorted
+  template <class TIterator>
+  StaticSearchTree(TIterator first, TIterator last,
+                   SearchTreeLayout layout = SearchTreeLayout::kEytzinger)
+      : layout(layout) {
+    Build(std::vector<T>(first, last));
+  }
+
+  /// @brief Builds the tree from the in-order traversal of a binary search
+  /// tree of Node<T>
+  /// @throws std::invalid_argument if the tree is not a search tree
+  explicit StaticSearchTree(
+      const Node<T>* root,
+      SearchTreeLayout layout = SearchTreeLayout::kEytzinger)
+      : layout(layout) {
+    std::vector<T> sorted;
+    std::vector<const Node<T>*> stack;
+    for (auto* node = root; node || !stack.empty();) {
+      for (; node; node = node->left) {
+        stack.push_back(node);
+      }
+      node = stack.back();
+      stack.pop_back();
+      sorted.push_back(node->value);
+      node = node->right;
+    }
+    Build(std::move(sorted));
+  }
+
+  /// @brief Gets the number of elements
+  std::size_t Size() const { return size; }
+
+  /// @brief Returns whether the tree is empty or not
+  bool Empty() const { return size == 0; }
+
+  /// @brief Gets the layout chosen at construction
+  SearchTreeLayout Layout() const { return layout; }
+
+  /// @brief Gets the number of bytes used by nodes and ranks
+  std::size_t MemoryBytes() const {
+    return nodes.capacity() * sizeof(T) + ranks.capacity() * sizeof(Rank);
+  }
+
+  /// @brief Gets the position in sorted order of the first element not less
+  /// than key, or Size() if there is none. Sorted positions let callers keep
+  /// payloads in a plain array next to the tree.
+  std::size_t LowerBound(const T& key) const {
+    auto slot = LowerBoundSlot(key);
+    return slot == kNoSlot ? size : ranks[slot];
+  }
+
+  /// @brief Checks if an element equivalent to key exists
+  bool Contains(const T& key) const {
+    auto slot = LowerBoundSlot(key);
+    return slot != kNoSlot && !compare(key, nodes[slot]);
+  }
+
+ private:
+  using NodeVector =
+      std::vector<T, detail::AlignedAllocator<T, kCacheLineBytes>>;
+
+  SearchTreeLayout layout = SearchTreeLayout::kEytzinger;
+  TCompare compare{};
+  std::size_t size = 0;
+  NodeVector nodes;
+  std::vector<Rank> ranks;
+  // van Emde Boas navigation tables, indexed by depth: the depth of the root
+  // of the enclosing subtree, and the sizes of its top and bottom trees
+  std::vector<std::uint8_t> top_depths;
+  std::vector<std::size_t> top_sizes;
+  std::vector<std::size_t> bottom_sizes;
+
+  void Build(std::vector<T> sorted) {
+    for (std::size_t i = 1; i < sorted.size(); i++) {
+      if (compare(sorted[i], sorted[i - 1])) {
+        throw std::invalid_argument("elements must be sorted!");
+      }
+    }
+    if (sorted.size() >= std::numeric_limits<Rank>::max()) {
+      throw std::length_error(fmt::format(
+          "{} elements do not fit in 32-bit ranks", sorted.size()));
+    }
+    size = sorted.size();
+    if (layout == SearchTreeLayout::kEytzinger) {
+      BuildEytzinger(sorted);
+    } else {
+      BuildVanEmdeBoas(sorted);
+    }
+  }
+
+  /// @brief Hands out sorted ranks to the breadth-first slots [1, count]
+  /// of the subtree rooted at slot k by walking it in order
+  /// @return the next unassigned rank
+  template <class TAssign>
+  static std::size_t InOrder(std::size_t k, std::size_t count,
+                             std::size_t next, TAssign& assign) {
+    if (k > count) {
+      return next;
+    }
+    next = InOrder(2 * k, count, next, assign);
+    assign(k, next++);
+    return InOrder(2 * k + 1, count, next, assign);
+  }
+
+  void BuildEytzinger(const std::vector<T>& sorted) {
+    // Slot 0 is unused so that children of k are 2k and 2k + 1
+    nodes.assign(size + 1, T());
+    ranks.assign(size + 1, 0);
+    if (size == 0) {
+      return;
+    }
+    auto assign = [&](std::size_t slot, std::size_t rank) {
+      nodes[slot] = sorted[rank];
+      ranks[slot] = static_cast<Rank>(rank);
+    };
+    InOrder(1, size, 0, assign);
+  }
+
+  /// @brief Fills the navigation tables for a subtree of height levels whose
+  /// root is at depth root_depth, splitting it into a top tree of
+  /// floor(height / 2) levels and bottom trees below
+  void SplitLevels(std::size_t root_depth, std::size_t height) {
+    if (height <= 1) {
+      return;
+    }
+    auto top = height / 2;
+    auto bottom = height - top;
+    auto depth = root_depth + top;
+    top_depths[depth] = static_cast<std::uint8_t>(root_depth);
+    top_sizes[depth] = (std::size_t{1} << top) - 1;
+    bottom_sizes[depth] = (std::size_t{1} << bottom) - 1;
+    SplitLevels(root_depth, top);
+    SplitLevels(depth, bottom);
+  }
+
+  /// @brief Position of breadth-first slot k (depth > 0) in the van Emde
+  /// Boas order. It roots one of the bottom trees of the subtree whose root
+  /// is its ancestor at top_depths[depth]; those bottom trees follow that
+  /// subtree's top tree in left to right order, and the low bits of k say
+  /// which one it is.
+  std::size_t VanEmdeBoasPosition(std::size_t k, std::size_t depth,
+                                  std::size_t ancestor_position) const {
+    return ancestor_position + top_sizes[depth] +
+           (k & top_sizes[depth]) * bottom_sizes[depth];
+  }
+
+  void BuildVanEmdeBoas(const std::vector<T>& sorted) {
+    std::size_t height = 0;
+    while ((std::size_t{1} << height) - 1 < size) {
+      height++;
+    }
+    top_depths.assign(height, 0);
+    top_sizes.assign(height, 0);
+    bottom_sizes.assign(height, 0);
+    SplitLevels(0, height);
+    auto count = (std::size_t{1} << height) - 1;
+    nodes.assign(count, T());
+    ranks.assign(count, 0);
+    if (size == 0) {
+      return;
+    }
+    // Padding slots repeat the largest element with rank size, so they sort
+    // after every real element and never win a lower bound the real one
+    // would
+    std::vector<std::size_t> positions(count + 1, 0);
+    for (std::size_t k = 2; k <= count; k++) {
+      auto depth = static_cast<std::size_t>(63 - __builtin_clzll(k));
+      auto ancestor = k >> (depth - top_depths[depth]);
+      positions[k] = VanEmdeBoasPosition(k, depth, positions[ancestor]);
+    }
+    auto assign = [&](std::size_t slot, std::size_t rank) {
+      auto position = positions[slot];
+      nodes[position] = rank < size ? sorted[rank] : sorted.back();
+      ranks[position] = static_cast<Rank>(std::min(rank, size));
+    };
+    InOrder(1, count, 0, assign);
+  }
+
+  std::size_t LowerBoundSlot(const T& key) const {
+    if (size == 0) {
+      return kNoSlot;
+    }
+    if (layout == SearchTreeLayout::kEytzinger) {
+      const T* data = nodes.data();
+      std::size_t k = 1;
+      while (k <= size) {
+        __builtin_prefetch(data + k * kPrefetchStride);
+        k = 2 * k + compare(data[k], key);
+      }
+      // k encodes the path with a 1 for every right turn; drop the trailing
+      // right turns and the last left turn to land on the answer
+      k >>= __builtin_ffsll(static_cast<long long>(~k));
+      return k == 0 ? kNoSlot : k;
+    }
+    // Positions of the nodes on the search path, by depth
+    std::size_t path[64];
+    std::size_t answer = kNoSlot;
+    std::size_t k = 1;
+    for (std::size_t depth = 0; depth < top_sizes.size(); depth++) {
+      auto position =
+          depth == 0 ? 0
+                     : VanEmdeBoasPosition(k, depth, path[top_depths[depth]]);
+      path[depth] = position;
+      bool right = compare(nodes[position], key);
+      answer = right ? answer : position;
+      k = 2 * k + right;
+    }
+    return answer;
+  }
+};
+
+}  // namespace binary_tree
+}  // namespace nll
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "nll/graph/csr_graph.hpp"
+
+namespace nll {
+namespace graph {
+
+/// @brief Immutable weighted graph in compressed sparse row form. Same layout
+/// as CsrGraph, plus a weights array parallel to targets, so the edges of
+/// vertex v are (targets[i], weights[i]) for i in offsets[v] .. offsets[v+1].
+/// @tparam TWeight non-negative edge weight type, integral or floating
+/// @tparam TVertex unsigned vertex id type
+template <class TWeight, class TVertex = std::uint32_t>
+class WeightedCsrGraph {
+  static_assert(std::is_unsigned<TVertex>::value,
+                "vertex ids must be an unsigned integer type");
+  static_assert(std::is_arithmetic<TWeight>::value,
+                "weights must be an arithmetic type");
+
+ public:
+  using VertexId = TVertex;
+  using Weight = TWeight;
+  using EdgeIndex = std::uint64_t;
+  using NeighborRange = typename CsrGraph<TVertex>::NeighborRange;
+
+  /// @brief Directed weighted edge, the input to FromEdges
+  struct Edge {
+    TVertex source;
+    TVertex target;
+    TWeight weight;
+  };
+
+  /// @brief Contiguous view over the weights of a single vertex's edges
+  class WeightRange {
+   public:
+    WeightRange(const TWeight* first, const TWeight* last)
+        : first(first), last(last) {}
+
+    const TWeight* begin() const { return first; }
+
+    const TWeight* end() const { return last; }
+
+    std::size_t size() const { return static_cast<std::size_t>(last - first); }
+
+    TWeight operator[](std::size_t index) const { return first[index]; }
+
+   private:
+    const TWeight* first;
+    const TWeight* last;
+  };
+
+  /// @brief Constructs an empty graph with no vertices
+  WeightedCsrGraph() : offsets(1, 0) {}
+
+  /// @brief Builds a graph from weighted edges by a parallel counting sort on
+  /// the source vertex, like CsrGraph::FromEdges. With deduplicate set,
+  /// parallel edges collapse to the one with the smallest weight.
+  /// @throws std::out_of_range if an edge endpoint is >= num_vertices
+  /// @throws std::invalid_argument if an edge weight is negative or NaN
+  /// @throws std::length_error if num_vertices does not fit in TVertex
+  static WeightedCsrGraph FromEdges(const std::vector<Edge>& edges,
+                                    std::size_t num_vertices,
+                                    const CsrBuildOptions& options = {}) {
+    for (const auto& edge : edges) {
+      // Written so NaN fails it too
+      if (!(edge.weight >= TWeight{})) {
+        throw std::invalid_argument("edge weights must be non-negative!");
+      }
+    }
+    auto num_threads = detail::ResolveThreadCount(options.num_threads);
+    auto arrays = detail::BuildCsr<TVertex, TWeight>(
+        edges, num_vertices, options, num_threads, [](const Edge& edge) {
+          return detail::BuilderEdge<TVertex, TWeight>{
+              edge.source, edge.target, edge.weight};
+        });
+    WeightedCsrGraph graph;
+    graph.offsets = std::move(arrays.offsets);
+    graph.targets = std::move(arrays.targets);
+    graph.weights = std::move(arrays.payloads);
+    if (options.deduplicate) {
+      graph.Deduplicate(num_threads);
+    }
+    return graph;
+  }
+
+  /// @brief Gets the number of vertices
+  std::size_t NumVertices() const { return offsets.size() - 1; }
+
+  /// @brief Gets the number of directed edges
+  std::size_t NumEdges() const { return targets.size(); }
+
+  /// @brief Gets the number of outgoing edges of a vertex
+  std::size_t Degree(TVertex vertex) const {
+    return static_cast<std::size_t>(offsets[vertex + 1] - offsets[vertex]);
+  }
+
+  /// @brief Gets the targets of a vertex's edges. Does not bounds check.
+  NeighborRange Neighbors(TVertex vertex) const {
+    return NeighborRange(targets.data() + offsets[vertex],
+                         targets.data() + offsets[vertex + 1]);
+  }
+
+  /// @brief Gets the weights of a vertex's edges, in Neighbors() order
+  WeightRange Weights(TVertex vertex) const {
+    return WeightRange(weights.data() + offsets[vertex],
+                       weights.data() + offsets[vertex + 1]);
+  }
+
+  /// @brief Gets the raw offsets array, NumVertices() + 1 entries
+  const std::vector<EdgeIndex>& Offsets() const { return offsets; }
+
+  /// @brief Gets the raw targets array, NumEdges() entries
+  const std::vector<TVertex>& Targets() const { return targets; }
+
+  /// @brief Gets the raw weights array, NumEdges() entries
+  const std::vector<TWeight>& EdgeWeights() const { return weights; }
+
+ private:
+  std::vector<EdgeIndex> offsets;
+  std::vector<TVertex> targets;
+  std::vector<TWeight> weights;
+
+  /// @brief Sorts every adjacency by (target, weight) and keeps the lightest
+  /// edge to each target
+  void Deduplicate(unsigned num_threads) {
+    auto num_vertices = NumVertices();
+    std::vector<EdgeIndex> unique_counts(num_vertices + 1, 0);
+    std::vector<std::pair<TVertex, TWeight>> sorted(NumEdges());
+    detail::ParallelChunks(
+        num_vertices, num_threads,
+        [&](unsigned, std::size_t begin, std::size_t end) {
+          for (auto v = begin; v < end; v++) {
+            auto first = sorted.begin() + offsets[v];
+            auto last = sorted.begin() + offsets[v + 1];
+            for (auto i = offsets[v]; i < offsets[v + 1]; i++) {
+              sorted[i] = {targets[i], weights[i]};
+            }
+            std::sort(first, last);
+            unique_counts[v] =
+                std::unique(first, last,
+                            [](const auto& a, const auto& b) {
+                              return a.first == b.first;
+                            }) -
+                first;
+          }
+        });
+    auto num_unique = detail::ExclusiveScan(unique_counts, num_threads);
+    unique_counts[num_vertices] = num_unique;
+    targets.resize(num_unique);
+    weights.resize(num_unique);
+    for (std::size_t v = 0; v < num_vertices; v++) {
+      for (EdgeIndex i = 0; i < unique_counts[v + 1] - unique_counts[v]; i++) {
+        targets[unique_counts[v] + i] = sorted[offsets[v] + i].first;
+        weights[unique_counts[v] + i] = sorted[offsets[v] + i].second;
+      }
+    }
+    offsets = std::move(unique_counts);
+  }
+};
+
+}  // namespace graph
+}  // namespace nll
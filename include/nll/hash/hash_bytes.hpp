@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "nll/hash/mix.hpp"
+
+namespace nll {
+namespace hash {
+
+namespace detail {
+
+inline constexpr std::uint64_t kSecret[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL,
+    0x4d5a2da51de1aa47ULL};
+
+// Unaligned loads in host byte order; hashes are only meant to be compared
+// on the machine that computed them
+inline std::uint64_t Read64(const std::uint8_t* p) {
+  std::uint64_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline std::uint64_t Read32(const std::uint8_t* p) {
+  std::uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+/// @brief First, middle and last byte of a 1 to 3 byte input
+inline std::uint64_t Read1To3(const std::uint8_t* p, std::size_t length) {
+  return (static_cast<std::uint64_t>(p[0]) << 16) |
+         (static_cast<std::uint64_t>(p[length >> 1]) << 8) | p[length - 1];
+}
+
+}  // namespace detail
+
+/// @brief Hashes length bytes with wyhash (Wang Yi, final version 4): 48
+/// bytes per round through three independent 64x64->128 bit multiplies, and
+/// inputs up to 16 bytes in two possibly overlapping loads with no loop.
+/// Not cryptographic, so an adversary who knows the seed can still craft
+/// colliding keys.
+inline std::uint64_t HashBytes(const void* data, std::size_t length,
+                               std::uint64_t seed = 0) {
+  using detail::kSecret;
+  using detail::MultiplyFold;
+  using detail::Read32;
+  using detail::Read64;
+  auto* p = static_cast<const std::uint8_t*>(data);
+  seed ^= MultiplyFold(seed ^ kSecret[0], kSecret[1]);
+  std::uint64_t a = 0;
+  std::uint64_t b = 0;
+  if (length <= 16) {
+    if (length >= 4) {
+      // Two loads from each end cover the input, overlapping when short
+      auto middle = (length >> 3) << 2;
+      a = (Read32(p) << 32) | Read32(p + middle);
+      b = (Read32(p + length - 4) << 32) | Read32(p + length - 4 - middle);
+    } else if (length > 0) {
+      a = detail::Read1To3(p, length);
+    }
+  } else {
+    auto left = length;
+    if (left > 48) {
+      auto see1 = seed;
+      auto see2 = seed;
+      do {
+        seed = MultiplyFold(Read64(p) ^ kSecret[1], Read64(p + 8) ^ seed);
+        see1 = MultiplyFold(Read64(p + 16) ^ kSecret[2], Read64(p + 24) ^ see1);
+        see2 = MultiplyFold(Read64(p + 32) ^ kSecret[3], Read64(p + 40) ^ see2);
+        p += 48;
+        left -= 48;
+      } while (left > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (left > 16) {
+      seed = MultiplyFold(Read64(p) ^ kSecret[1], Read64(p + 8) ^ seed);
+      p += 16;
+      left -= 16;
+    }
+    // The last 16 bytes, overlapping what the rounds consumed
+    a = Read64(p + left - 16);
+    b = Read64(p + left - 8);
+  }
+  a ^= kSecret[1];
+  b ^= seed;
+  auto product = static_cast<unsigned __int128>(a) * b;
+  a = static_cast<std::uint64_t>(product);
+  b = static_cast<std::uint64_t>(product >> 64);
+  return MultiplyFold(a ^ kSecret[0] ^ length, b ^ kSecret[1]);
+}
+
+}  // namespace hash
+}  // namespace nll
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX512DQ__)
+#include <immintrin.h>
+#endif
+
+#include "nll/hash/hash_bytes.hpp"
+#include "nll/hash/mix.hpp"
+
+namespace nll {
+namespace hash {
+
+namespace detail {
+
+#if defined(__AVX512DQ__)
+inline __m512i Mix64(__m512i value) {
+  const auto first =
+      _mm512_set1_epi64(static_cast<long long>(0xff51afd7ed558ccdULL));
+  const auto second =
+      _mm512_set1_epi64(static_cast<long long>(0xc4ceb9fe1a85ec53ULL));
+  value = _mm512_xor_si512(value, _mm512_srli_epi64(value, 33));
+  value = _mm512_mullo_epi64(value, first);
+  value = _mm512_xor_si512(value, _mm512_srli_epi64(value, 33));
+  value = _mm512_mullo_epi64(value, second);
+  return _mm512_xor_si512(value, _mm512_srli_epi64(value, 33));
+}
+#endif
+
+}  // namespace detail
+
+/// @brief Mix64 of count words at once. out may be values; results match
+/// Mix64 bit for bit. The SIMD path, eight words per instruction with
+/// AVX-512DQ's 64-bit multiply, is only compiled when the target enables
+/// AVX-512DQ (e.g. -march=skylake-avx512); every other build, the default
+/// one included, runs the scalar loop. AVX2 has no 64-bit multiply, and
+/// emulating it with three 32-bit ones measured slower than the scalar
+/// loop, so it gets no path of its own.
+inline void Mix64Batch(const std::uint64_t* values, std::size_t count,
+                       std::uint64_t* out) {
+  std::size_t i = 0;
+#if defined(__AVX512DQ__)
+  for (; i + 8 <= count; i += 8) {
+    _mm512_storeu_si512(out + i,
+                        detail::Mix64(_mm512_loadu_si512(values + i)));
+  }
+#endif
+  for (; i < count; i++) {
+    out[i] = Mix64(values[i]);
+  }
+}
+
+/// @brief Default hasher of the library's hash tables. Every specialization
+/// avalanches, i.e. each input bit flips each output bit with probability
+/// about 1/2, so tables may reduce hashes with FastRange (which keeps the
+/// high bits) or a mask (which keeps the low ones) alike. Integers, enums
+/// and pointers go through Mix64, strings through HashBytes; any other type
+/// has its std::hash mixed with Mix64.
+template <class T, class = void>
+struct Hasher {
+  static constexpr bool kAvalanching = true;
+
+  std::uint64_t operator()(const T& value) const {
+    return Mix64(static_cast<std::uint64_t>(std::hash<T>{}(value)));
+  }
+};
+
+template <class T>
+struct Hasher<T, std::enable_if_t<std::is_integral_v<T> ||
+                                  std::is_enum_v<T>>> {
+  static constexpr bool kAvalanching = true;
+
+  std::uint64_t operator()(T value) const {
+    return Mix64(static_cast<std::uint64_t>(value));
+  }
+
+  /// @brief Hashes count keys at once, see Mix64Batch
+  static void Batch(const T* keys, std::size_t count, std::uint64_t* out) {
+    for (std::size_t i = 0; i < count; i++) {
+      out[i] = static_cast<std::uint64_t>(keys[i]);
+    }
+    Mix64Batch(out, count, out);
+  }
+};
+
+template <class T>
+struct Hasher<T*, void> {
+  static constexpr bool kAvalanching = true;
+
+  std::uint64_t operator()(const T* pointer) const {
+    return Mix64(reinterpret_cast<std::uintptr_t>(pointer));
+  }
+};
+
+namespace detail {
+
+/// @brief Hashes anything convertible to std::string_view, so strings with
+/// any allocator and views of them hash alike
+struct StringHasher {
+  static constexpr bool kAvalanching = true;
+  using is_transparent = void;
+
+  std::uint64_t operator()(std::string_view value) const {
+    return HashBytes(value.data(), value.size());
+  }
+};
+
+}  // namespace detail
+
+template <>
+struct Hasher<std::string_view, void> : detail::StringHasher {};
+
+template <class TAllocator>
+struct Hasher<std::basic_string<char, std::char_traits<char>, TAllocator>,
+              void> : detail::StringHasher {};
+
+namespace detail {
+
+template <class THash, class = void>
+struct IsAvalanching : std::false_type {};
+
+template <class THash>
+struct IsAvalanching<THash, std::enable_if_t<THash::kAvalanching>>
+    : std::true_type {};
+
+template <class THash, class TKey, class = void>
+struct HasBatch : std::false_type {};
+
+template <class THash, class TKey>
+struct HasBatch<THash, TKey,
+                std::void_t<decltype(THash::Batch(
+                    std::declval<const TKey*>(), std::size_t{},
+                    std::declval<std::uint64_t*>()))>> : std::true_type {};
+
+}  // namespace detail
+
+/// @brief Whether THash declares kAvalanching, i.e. its output can be used
+/// as is. Others, like std::hash of integers, need a Mix64 on top.
+template <class THash>
+inline constexpr bool kIsAvalanching = detail::IsAvalanching<THash>::value;
+
+/// @brief Hashes count keys with hasher, through its static Batch when it
+/// has one and one key at a time otherwise. The hashes are finished with
+/// Mix64 unless the hasher avalanches, so they are always fit for
+/// FastRange64.
+template <class THash, class TKey>
+void HashBatch(const THash& hasher, const TKey* keys, std::size_t count,
+               std::uint64_t* out) {
+  if constexpr (detail::HasBatch<THash, TKey>::value) {
+    THash::Batch(keys, count, out);
+  } else {
+    for (std::size_t i = 0; i < count; i++) {
+      out[i] = static_cast<std::uint64_t>(hasher(keys[i]));
+    }
+  }
+  if constexpr (!kIsAvalanching<THash>) {
+    Mix64Batch(out, count, out);
+  }
+}
+
+}  // namespace hash
+}  // namespace nll
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+namespace nll {
+namespace hash {
+
+/// @brief Finalizer of MurmurHash3: a bijection on 64-bit words that
+/// spreads every input bit over the whole word. std::hash of integers is
+/// the identity on common standard libraries, which would put consecutive
+/// keys in neighbouring slots and leave the high bits zero.
+inline std::uint64_t Mix64(std::uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ULL;
+  value ^= value >> 33;
+  return value;
+}
+
+/// @brief The 32-bit finalizer of MurmurHash3, for 32-bit tables
+inline std::uint32_t Mix32(std::uint32_t value) {
+  value ^= value >> 16;
+  value *= 0x85ebca6bU;
+  value ^= value >> 13;
+  value *= 0xc2b2ae35U;
+  value ^= value >> 16;
+  return value;
+}
+
+/// @brief Maps a uniform 32-bit value onto [0, range) with a multiply and a
+/// shift instead of a modulo (Lemire's fastrange). Only the high bits of
+/// value matter, so it must be well mixed.
+inline std::uint32_t FastRange32(std::uint32_t value, std::uint32_t range) {
+  return static_cast<std::uint32_t>(
+      (static_cast<std::uint64_t>(value) * range) >> 32);
+}
+
+/// @brief FastRange32 for a uniform 64-bit value and a 64-bit range
+inline std::uint64_t FastRange64(std::uint64_t value, std::uint64_t range) {
+  return static_cast<std::uint64_t>(
+      (static_cast<unsigned __int128>(value) * range) >> 64);
+}
+
+namespace detail {
+
+/// @brief Multiplies a by b into 128 bits and folds the halves with XOR,
+/// the mixing step of wyhash
+inline std::uint64_t MultiplyFold(std::uint64_t a, std::uint64_t b) {
+  auto product = static_cast<unsigned __int128>(a) * b;
+  return static_cast<std::uint64_t>(product) ^
+         static_cast<std::uint64_t>(product >> 64);
+}
+
+}  // namespace detail
+
+}  // namespace hash
+}  // namespace nll
@@ -0,0 +1,179 @@
+#pragma once
+
+/// Replaces the global operator new and delete with versions that report to
+/// AllocationTracker. Replacement operators are ordinary (non-inline)
+/// definitions, so include this header in exactly one translation unit of a
+/// binary, typically the one holding main.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "nll/instrumentation/allocation_tracker.hpp"
+
+namespace nll {
+namespace instrumentation {
+namespace detail {
+
+// Every block is preceded by a header whose last bytes hold the requested
+// size, so delete can count the bytes even when the size is not passed
+constexpr std::size_t kMinHeaderBytes = alignof(std::max_align_t);
+
+inline void* TrackedAllocate(std::size_t size, std::size_t alignment) {
+  auto header = std::max(alignment, kMinHeaderBytes);
+  void* base;
+  if (alignment <= kMinHeaderBytes) {
+    base = std::malloc(size + header);
+  } else {
+    // aligned_alloc wants a multiple of the alignment
+    base = std::aligned_alloc(
+        alignment, (size + header + alignment - 1) / alignment * alignment);
+  }
+  if (!base) {
+    return nullptr;
+  }
+  auto* block = static_cast<char*>(base) + header;
+  std::memcpy(block - sizeof(size), &size, sizeof(size));
+  AllocationTracker::RecordAllocation(size);
+  return block;
+}
+
+inline void TrackedFree(void* pointer, std::size_t alignment) noexcept {
+  if (!pointer) {
+    return;
+  }
+  auto* block = static_cast<char*>(pointer);
+  std::size_t size;
+  std::memcpy(&size, block - sizeof(size), sizeof(size));
+  AllocationTracker::RecordDeallocation(size);
+  std::free(block - std::max(alignment, kMinHeaderBytes));
+}
+
+/// @brief Allocates like the standard operator new: retries through the new
+/// handler and throws std::bad_alloc once there is none
+inline void* TrackedNew(std::size_t size, std::size_t alignment) {
+  size = std::max<std::size_t>(size, 1);
+  while (true) {
+    if (auto* block = TrackedAllocate(size, alignment)) {
+      return block;
+    }
+    auto handler = std::get_new_handler();
+    if (!handler) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+inline void* TrackedNewNoThrow(std::size_t size,
+                               std::size_t alignment) noexcept {
+  try {
+    return TrackedNew(size, alignment);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+inline const bool kHooksEnabled = AllocationTracker::MarkEnabled();
+
+}  // namespace detail
+}  // namespace instrumentation
+}  // namespace nll
+
+void* operator new(std::size_t size) {
+  return nll::instrumentation::detail::TrackedNew(size, 0);
+}
+
+void* operator new[](std::size_t size) {
+  return nll::instrumentation::detail::TrackedNew(size, 0);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return nll::instrumentation::detail::TrackedNewNoThrow(size, 0);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return nll::instrumentation::detail::TrackedNewNoThrow(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return nll::instrumentation::detail::TrackedNew(
+      size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return nll::instrumentation::detail::TrackedNew(
+      size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment,
+                   const std::nothrow_t&) noexcept {
+  return nll::instrumentation::detail::TrackedNewNoThrow(
+      size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept {
+  return nll::instrumentation::detail::TrackedNewNoThrow(
+      size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept {
+  nll::instrumentation::detail::TrackedFree(pointer, 0);
+}
+
+void operator delete[](void* pointer) noexcept {
+  nll::instrumentation::detail::TrackedFree(pointer, 0);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  nll::instrumentation::detail::TrackedFree(pointer, 0);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+  nll::instrumentation::detail::TrackedFree(pointer, 0);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+  nll::instrumentation::detail::TrackedFree(pointer, 0);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+  nll::instrumentation::detail::TrackedFree(pointer, 0);
+}
+
+void operator delete(void* pointer, std::align_val_t alignment) noexcept {
+  nll::instrumentation::detail::TrackedFree(
+      pointer, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept {
+  nll::instrumentation::detail::TrackedFree(
+      pointer, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer, std::size_t,
+                     std::align_val_t alignment) noexcept {
+  nll::instrumentation::detail::TrackedFree(
+      pointer, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* pointer, std::size_t,
+                       std::align_val_t alignment) noexcept {
+  nll::instrumentation::detail::TrackedFree(
+      pointer, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer, std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept {
+  nll::instrumentation::detail::TrackedFree(
+      pointer, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment,
+                       const std::nothrow_t&) noexcept {
+  nll::instrumentation::detail::TrackedFree(
+      pointer, static_cast<std::size_t>(alignment));
+}
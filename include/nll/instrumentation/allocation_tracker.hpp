@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace nll {
+namespace instrumentation {
+
+/// @brief Heap activity counted by AllocationTracker
+struct AllocationStats {
+  std::uint64_t allocations = 0;
+  std::uint64_t deallocations = 0;
+  std::uint64_t bytes_allocated = 0;
+  std::uint64_t bytes_freed = 0;
+  /// @brief Highest live byte count since the last ResetPeak
+  std::uint64_t peak_live_bytes = 0;
+
+  /// @brief Gets the number of bytes allocated and not yet freed
+  std::uint64_t LiveBytes() const { return bytes_allocated - bytes_freed; }
+
+  /// @brief Gets the activity between an earlier snapshot and this one. The
+  /// peak is kept as is, since peaks do not subtract.
+  AllocationStats operator-(const AllocationStats& earlier) const {
+    AllocationStats delta = *this;
+    delta.allocations -= earlier.allocations;
+    delta.deallocations -= earlier.deallocations;
+    delta.bytes_allocated -= earlier.bytes_allocated;
+    delta.bytes_freed -= earlier.bytes_freed;
+    return delta;
+  }
+};
+
+/// @brief Process wide counters of every operator new and delete call. They
+/// only move in binaries that include nll/instrumentation/allocation_hooks.hpp
+/// in one translation unit, which replaces the global operators; Enabled()
+/// says whether that happened. Counters are relaxed atomics, so snapshots
+/// taken while other threads allocate are approximate.
+class AllocationTracker {
+ public:
+  /// @brief Returns whether the allocation hooks are linked in
+  static bool Enabled() { return enabled.load(std::memory_order_relaxed); }
+
+  /// @brief Gets the totals since the process started
+  static AllocationStats Snapshot() {
+    AllocationStats stats;
+    stats.allocations = allocations.load(std::memory_order_relaxed);
+    stats.deallocations = deallocations.load(std::memory_order_relaxed);
+    stats.bytes_allocated = bytes_allocated.load(std::memory_order_relaxed);
+    stats.bytes_freed = bytes_freed.load(std::memory_order_relaxed);
+    stats.peak_live_bytes = peak_live_bytes.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+  /// @brief Restarts peak tracking from the bytes live right now
+  static void ResetPeak() {
+    peak_live_bytes.store(live_bytes.load(std::memory_order_relaxed),
+                          std::memory_order_relaxed);
+  }
+
+  /// @brief Counts an allocation. Called by the hooks.
+  static void RecordAllocation(std::size_t bytes) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+    auto live = live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    auto peak = peak_live_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !peak_live_bytes.compare_exchange_weak(
+                              peak, live, std::memory_order_relaxed)) {
+    }
+  }
+
+  /// @brief Counts a deallocation. Called by the hooks.
+  static void RecordDeallocation(std::size_t bytes) noexcept {
+    deallocations.fetch_add(1, std::memory_order_relaxed);
+    bytes_freed.fetch_add(bytes, std::memory_order_relaxed);
+    live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
+  /// @brief Marks the hooks as linked in. Called by the hooks.
+  static bool MarkEnabled() {
+    enabled.store(true, std::memory_order_relaxed);
+    return true;
+  }
+
+ private:
+  static inline std::atomic<bool> enabled{false};
+  static inline std::atomic<std::uint64_t> allocations{0};
+  static inline std::atomic<std::uint64_t> deallocations{0};
+  static inline std::atomic<std::uint64_t> bytes_allocated{0};
+  static inline std::atomic<std::uint64_t> bytes_freed{0};
+  static inline std::atomic<std::uint64_t> live_bytes{0};
+  static inline std::atomic<std::uint64_t> peak_live_bytes{0};
+};
+
+}  // namespace instrumentation
+}  // namespace nll
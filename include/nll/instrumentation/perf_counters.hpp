@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace nll {
+namespace instrumentation {
+
+/// @brief Hardware event counts over a measured region
+struct PerfCounterValues {
+  std::uint64_t cycles = 0;
+  std::uint64_t instructions = 0;
+  std::uint64_t cache_misses = 0;
+  std::uint64_t branch_misses = 0;
+};
+
+/// @brief CPU cycles, retired instructions, last level cache misses and
+/// branch misses of the calling thread, read through Linux perf_event_open
+/// as one group so all four cover exactly the same instructions. Only user
+/// space is counted, which most perf_event_paranoid settings allow.
+/// Counters may still be unavailable (another OS, a container without
+/// access, a VM without a PMU); Available() is then false and Stop() returns
+/// zeros, so callers can run unchanged.
+class PerfCounters {
+ public:
+  PerfCounters() {
+#if defined(__linux__)
+    constexpr std::array<std::uint64_t, kNumEvents> kEvents = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    for (std::size_t i = 0; i < kNumEvents; i++) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = kEvents[i];
+      attr.disabled = i == 0;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP;
+      auto fd = syscall(SYS_perf_event_open, &attr, 0, -1,
+                        i == 0 ? -1 : descriptors[0], 0);
+      if (fd < 0) {
+        Close();
+        return;
+      }
+      descriptors[i] = static_cast<int>(fd);
+    }
+#endif
+  }
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  ~PerfCounters() { Close(); }
+
+  /// @brief Returns whether the counters could be opened
+  bool Available() const { return descriptors[0] >= 0; }
+
+  /// @brief Zeroes the counters and starts counting
+  void Start() {
+#if defined(__linux__)
+    if (Available()) {
+      ioctl(descriptors[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ioctl(descriptors[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+  }
+
+  /// @brief Stops counting and gets the counts since Start
+  PerfCounterValues Stop() {
+    PerfCounterValues values;
+#if defined(__linux__)
+    if (!Available()) {
+      return values;
+    }
+    ioctl(descriptors[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    // With PERF_FORMAT_GROUP a read yields the event count, then each value
+    std::array<std::uint64_t, kNumEvents + 1> buffer{};
+    if (read(descriptors[0], buffer.data(), sizeof(buffer)) !=
+        static_cast<ssize_t>(sizeof(buffer))) {
+      return values;
+    }
+    values.cycles = buffer[1];
+    values.instructions = buffer[2];
+    values.cache_misses = buffer[3];
+    values.branch_misses = buffer[4];
+#endif
+    return values;
+  }
+
+ private:
+  static constexpr std::size_t kNumEvents = 4;
+
+  std::array<int, kNumEvents> descriptors = {-1, -1, -1, -1};
+
+  void Close() {
+    for (auto& descriptor : descriptors) {
+#if defined(__linux__)
+      if (descriptor >= 0) {
+        close(descriptor);
+      }
+#endif
+      descriptor = -1;
+    }
+  }
+};
+
+}  // namespace instrumentation
+}  // namespace nll
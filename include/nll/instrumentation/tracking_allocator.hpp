@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
+namespace nll {
+namespace instrumentation {
+
+/// @brief Memory drawn through one or more TrackingAllocators
+struct MemoryStats {
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+  std::size_t live_bytes = 0;
+  std::size_t peak_bytes = 0;
+};
+
+/// @brief Allocator adaptor that reports a single container's live and peak
+/// memory into a MemoryStats it points to, forwarding the allocations to
+/// TUpstream. Copies and rebinds share the same stats, so node allocations
+/// of a map are counted with its bucket array. The stats are plain
+/// integers; do not share them between threads.
+/// @tparam T element type
+/// @tparam TUpstream allocator that does the allocating
+template <class T, class TUpstream = std::allocator<T>>
+class TrackingAllocator {
+  template <class U, class TOtherUpstream>
+  friend class TrackingAllocator;
+
+  using UpstreamTraits = std::allocator_traits<TUpstream>;
+
+ public:
+  using value_type = T;
+
+  template <class U>
+  struct rebind {
+    using other = TrackingAllocator<
+        U, typename UpstreamTraits::template rebind_alloc<U>>;
+  };
+
+  /// @brief Constructs an allocator reporting into stats, which must outlive
+  /// every container using it
+  explicit TrackingAllocator(MemoryStats* stats,
+                             TUpstream upstream = TUpstream())
+      : stats(stats), upstream(std::move(upstream)) {}
+
+  template <class U, class TOtherUpstream>
+  TrackingAllocator(const TrackingAllocator<U, TOtherUpstream>& other)
+      : stats(other.stats), upstream(other.upstream) {}
+
+  T* allocate(std::size_t n) {
+    auto* pointer = UpstreamTraits::allocate(upstream, n);
+    stats->allocations++;
+    stats->live_bytes += n * sizeof(T);
+    stats->peak_bytes = std::max(stats->peak_bytes, stats->live_bytes);
+    return pointer;
+  }
+
+  void deallocate(T* pointer, std::size_t n) {
+    stats->deallocations++;
+    stats->live_bytes -= n * sizeof(T);
+    UpstreamTraits::deallocate(upstream, pointer, n);
+  }
+
+  /// @brief Gets the stats this allocator reports into
+  MemoryStats* Stats() const { return stats; }
+
+  template <class U, class TOtherUpstream>
+  bool operator==(const TrackingAllocator<U, TOtherUpstream>& other) const {
+    return stats == other.stats && upstream == other.upstream;
+  }
+
+  template <class U, class TOtherUpstream>
+  bool operator!=(const TrackingAllocator<U, TOtherUpstream>& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  MemoryStats* stats;
+  TUpstream upstream;
+};
+
+}  // namespace instrumentation
+}  // namespace nll
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace nll {
+namespace memory {
+
+/// @brief Epoch-based reclamation (Fraser, "Practical lock-freedom", 2004)
+/// for lock-free structures whose readers follow pointers other threads may
+/// unlink at any time. Threads Pin the domain around every access; an
+/// object unlinked while pinned is Retired rather than freed, and reclaimed
+/// once every thread pinned at the time has unpinned.
+///
+/// The domain keeps a global epoch and a slot per pinned thread holding the
+/// epoch it pinned in. The epoch only advances when every pinned slot has
+/// seen the current one, so an object retired in epoch e can no longer be
+/// reached by anyone once the epoch reaches e + 2. Pinning is a slot claim
+/// and a fence; retired objects wait in the slot and are reclaimed in
+/// batches by whichever thread fills the batch.
+class EpochDomain {
+  struct Retired {
+    void* object;
+    void (*reclaim)(void* object, void* context);
+    void* context;
+    std::uint64_t epoch;
+  };
+
+  /// @brief A pinned thread's state, on its own cache line. epoch is 0
+  /// while the slot is not pinned; limbo is only touched by the claimant.
+  struct alignas(64) Slot {
+    std::atomic<bool> claimed{false};
+    std::atomic<std::uint64_t> epoch{0};
+    std::vector<Retired> limbo;
+  };
+
+  static constexpr std::size_t kSlots = 128;
+  static constexpr std::size_t kCollectThreshold = 64;
+
+  std::atomic<std::uint64_t> global_epoch{1};
+  std::unique_ptr<Slot[]> slots;
+
+  /// @brief Advances the global epoch if every pinned slot is in it
+  /// @return the global epoch after the attempt
+  std::uint64_t TryAdvance() {
+    auto epoch = global_epoch.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // Acquire pairs with unpinning, so whatever a thread read while pinned
+    // happens before the objects it kept alive are reclaimed
+    for (std::size_t i = 0; i < kSlots; i++) {
+      auto pinned = slots[i].epoch.load(std::memory_order_acquire);
+      if (pinned != 0 && pinned != epoch) {
+        return epoch;
+      }
+    }
+    if (global_epoch.compare_exchange_strong(epoch, epoch + 1,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
+      return epoch + 1;
+    }
+    return epoch;
+  }
+
+  /// @brief Reclaims the objects of a claimed slot whose grace period is over
+  void CollectSlot(Slot& slot) {
+    auto epoch = TryAdvance();
+    auto& limbo = slot.limbo;
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < limbo.size(); i++) {
+      if (limbo[i].epoch + 2 <= epoch) {
+        limbo[i].reclaim(limbo[i].object, limbo[i].context);
+      } else {
+        limbo[kept++] = limbo[i];
+      }
+    }
+    limbo.resize(kept);
+  }
+
+ public:
+  /// @brief Keeps the calling thread pinned until destroyed. Pointers read
+  /// from the protected structure stay valid while it lives.
+  class Guard {
+    friend class EpochDomain;
+
+    EpochDomain* domain;
+    Slot* slot;
+
+    Guard(EpochDomain* domain, Slot* slot) : domain(domain), slot(slot) {}
+
+   public:
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+
+    Guard(Guard&& other) noexcept
+        : domain(other.domain), slot(std::exchange(other.slot, nullptr)) {}
+
+    Guard& operator=(Guard&& other) noexcept {
+      std::swap(domain, other.domain);
+      std::swap(slot, other.slot);
+      return *this;
+    }
+
+    ~Guard() {
+      if (slot != nullptr) {
+        slot->epoch.store(0, std::memory_order_release);
+        slot->claimed.store(false, std::memory_order_release);
+      }
+    }
+
+    /// @brief Hands an object no longer reachable from the structure to the
+    /// domain, which calls reclaim(object, context) once no thread pinned
+    /// now can still hold it
+    void Retire(void* object, void (*reclaim)(void*, void*),
+                void* context = nullptr) {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      auto epoch = domain->global_epoch.load(std::memory_order_acquire);
+      slot->limbo.push_back({object, reclaim, context, epoch});
+      if (slot->limbo.size() >= kCollectThreshold) {
+        domain->CollectSlot(*slot);
+      }
+    }
+
+    /// @brief Retires an object allocated with new, deleting it when safe
+    template <class T>
+    void Retire(T* object) {
+      Retire(object, [](void* retired, void*) {
+        delete static_cast<T*>(retired);
+      });
+    }
+  };
+
+  EpochDomain() : slots(std::make_unique<Slot[]>(kSlots)) {}
+
+  EpochDomain(const EpochDomain&) = delete;
+  EpochDomain& operator=(const EpochDomain&) = delete;
+
+  /// @brief Reclaims everything still retired. No thread may be pinned.
+  ~EpochDomain() {
+    for (std::size_t i = 0; i < kSlots; i++) {
+      for (const auto& retired : slots[i].limbo) {
+        retired.reclaim(retired.object, retired.context);
+      }
+    }
+  }
+
+  /// @brief Pins the calling thread, spinning only if every slot is taken
+  Guard Pin() {
+    // Thread ids hash to aligned addresses, so mix before picking a slot
+    auto start = static_cast<std::size_t>(
+        (std::hash<std::thread::id>{}(std::this_thread::get_id()) *
+         0x9E3779B97F4A7C15ull) >>
+        32);
+    for (std::size_t attempt = 0;; attempt++) {
+      auto& slot = slots[(start + attempt) % kSlots];
+      bool expected = false;
+      if (!slot.claimed.load(std::memory_order_relaxed) &&
+          slot.claimed.compare_exchange_strong(expected, true,
+                                               std::memory_order_acquire,
+                                               std::memory_order_relaxed)) {
+        slot.epoch.store(global_epoch.load(std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return Guard(this, &slot);
+      }
+      if (attempt % kSlots == kSlots - 1) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  /// @brief Reclaims what it can from every slot no thread holds. Retired
+  /// objects are otherwise reclaimed in batches as more are retired.
+  void Collect() {
+    for (std::size_t i = 0; i < kSlots; i++) {
+      auto& slot = slots[i];
+      bool expected = false;
+      if (slot.claimed.compare_exchange_strong(expected, true,
+                                               std::memory_order_acquire,
+                                               std::memory_order_relaxed)) {
+        CollectSlot(slot);
+        slot.claimed.store(false, std::memory_order_release);
+      }
+    }
+  }
+
+  /// @brief Gets the global epoch
+  std::uint64_t Epoch() const {
+    return global_epoch.load(std::memory_order_relaxed);
+  }
+};
+
+}  // namespace memory
+}  // namespace nll
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fmt/core.h>
+
+namespace nll {
+namespace detail {
+
+/// @brief Alignment of every section in the mappable file formats, so
+/// sections can be used in place once the file is mapped
+constexpr std::uint64_t kSectionAlignment = 64;
+
+inline std::uint64_t AlignSection(std::uint64_t offset) {
+  return (offset + kSectionAlignment - 1) / kSectionAlignment *
+         kSectionAlignment;
+}
+
+inline std::uint64_t RotateLeft(std::uint64_t x, int bits) {
+  return (x << bits) | (x >> (64 - bits));
+}
+
+/// @brief Fast 64 bit checksum, one multiply-rotate round per 8 bytes in the
+/// style of xxHash64. Detects corruption, not tampering.
+inline std::uint64_t Checksum64(const void* data, std::size_t size) {
+  constexpr std::uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+  constexpr std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+  auto bytes = static_cast<const unsigned char*>(data);
+  std::uint64_t hash = kPrime2 ^ size;
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, bytes + i, 8);
+    hash ^= RotateLeft(word * kPrime2, 31) * kPrime1;
+    hash = RotateLeft(hash, 27) * kPrime1 + kPrime2;
+  }
+  for (; i < size; i++) {
+    hash ^= bytes[i] * kPrime1;
+    hash = RotateLeft(hash, 11) * kPrime2;
+  }
+  hash ^= hash >> 33;
+  hash *= kPrime2;
+  hash ^= hash >> 29;
+  return hash;
+}
+
+/// @brief Pads out to the next section boundary, writes one section there
+/// and checksums it
+/// @return the section's offset
+inline std::uint64_t WriteAlignedSection(std::ostream& out, const void* data,
+                                         std::size_t bytes,
+                                         std::uint64_t& checksum) {
+  auto offset = AlignSection(static_cast<std::uint64_t>(out.tellp()));
+  static const char kPadding[kSectionAlignment] = {};
+  out.write(kPadding, static_cast<std::streamsize>(
+                          offset - static_cast<std::uint64_t>(out.tellp())));
+  out.write(static_cast<const char*>(data),
+            static_cast<std::streamsize>(bytes));
+  checksum = Checksum64(data, bytes);
+  return offset;
+}
+
+/// @brief Whole file mapped read-only, unmapped on destruction. Move-only.
+class ReadOnlyMapping {
+ public:
+  /// @throws std::system_error if the file cannot be opened or mapped
+  ReadOnlyMapping(const std::string& path, bool populate) {
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(),
+                              fmt::format("cannot open {}", path));
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0) {
+      auto error = errno;
+      ::close(fd);
+      throw std::system_error(error, std::generic_category(),
+                              fmt::format("cannot stat {}", path));
+    }
+    size = static_cast<std::size_t>(info.st_size);
+    if (size == 0) {
+      // mmap rejects empty mappings, an empty file is just an empty range
+      ::close(fd);
+      return;
+    }
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (populate) {
+      flags |= MAP_POPULATE;
+    }
+#endif
+    auto mapping = ::mmap(nullptr, size, PROT_READ, flags, fd, 0);
+    auto error = errno;
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+      throw std::system_error(error, std::generic_category(),
+                              fmt::format("cannot map {}", path));
+    }
+    data = static_cast<const unsigned char*>(mapping);
+  }
+
+  ReadOnlyMapping(ReadOnlyMapping&& other) noexcept
+      : data(std::exchange(other.data, nullptr)),
+        size(std::exchange(other.size, 0)) {}
+
+  ReadOnlyMapping& operator=(ReadOnlyMapping&& other) noexcept {
+    if (this != &other) {
+      Unmap();
+      data = std::exchange(other.data, nullptr);
+      size = std::exchange(other.size, 0);
+    }
+    return *this;
+  }
+
+  ReadOnlyMapping(const ReadOnlyMapping&) = delete;
+  ReadOnlyMapping& operator=(const ReadOnlyMapping&) = delete;
+
+  ~ReadOnlyMapping() { Unmap(); }
+
+  const unsigned char* Data() const { return data; }
+
+  std::size_t Size() const { return size; }
+
+ private:
+  const unsigned char* data = nullptr;
+  std::size_t size = 0;
+
+  void Unmap() {
+    if (data) {
+      ::munmap(const_cast<unsigned char*>(data), size);
+      data = nullptr;
+    }
+  }
+};
+
+}  // namespace detail
+}  // namespace nll
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+namespace nll {
+namespace memory {
+
+/// @brief Bump-pointer memory resource for request-scoped data. Allocation
+/// is a pointer increment; deallocation does nothing, and everything is
+/// freed at once by Reset or Release. Blocks come from the upstream
+/// resource in chunks that double in size.
+///
+/// Unlike std::pmr::monotonic_buffer_resource, whose release() hands every
+/// chunk back upstream, Reset keeps memory for the next round, so an arena
+/// reused across requests of a steady size stops touching the upstream
+/// resource after the first one. Not thread safe.
+class MonotonicArena : public std::pmr::memory_resource {
+ public:
+  /// @param initial_chunk_bytes size of the first chunk taken from upstream
+  /// @param upstream where chunks come from
+  explicit MonotonicArena(
+      std::size_t initial_chunk_bytes = 4096,
+      std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+      : upstream(upstream),
+        next_chunk_bytes(std::max(initial_chunk_bytes, kMinChunkBytes)) {}
+
+  /// @brief Serves allocations from buffer before going upstream. The
+  /// buffer is not owned and must outlive the arena.
+  MonotonicArena(
+      void* buffer, std::size_t buffer_bytes,
+      std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+      : upstream(upstream),
+        next_chunk_bytes(std::max(buffer_bytes * 2, kMinChunkBytes)),
+        initial_buffer(static_cast<std::byte*>(buffer)),
+        initial_buffer_bytes(buffer_bytes),
+        current(initial_buffer),
+        current_end(initial_buffer + buffer_bytes) {}
+
+  MonotonicArena(const MonotonicArena&) = delete;
+  MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+  ~MonotonicArena() override { Release(); }
+
+  /// @brief Frees every allocation but keeps one chunk as large as all the
+  /// chunks it held, so the next request of the same size is served
+  /// without going upstream. Everything allocated from the arena must be
+  /// dead.
+  void Reset() {
+    if (chunks && chunks->next) {
+      auto total = reserved_bytes;
+      Release();
+      NewChunk(total - kHeaderBytes);
+    } else if (chunks) {
+      current = ChunkData(chunks);
+      current_end = reinterpret_cast<std::byte*>(chunks) + chunks->bytes;
+    } else {
+      current = initial_buffer;
+    }
+    used_bytes = 0;
+  }
+
+  /// @brief Frees every allocation and returns all chunks upstream
+  void Release() {
+    while (chunks) {
+      auto* next = chunks->next;
+      FreeChunk(chunks);
+      chunks = next;
+    }
+    current = initial_buffer;
+    current_end = initial_buffer + initial_buffer_bytes;
+    used_bytes = 0;
+  }
+
+  /// @brief Gets the bytes handed out since the last Reset or Release,
+  /// including alignment padding
+  std::size_t BytesUsed() const { return used_bytes; }
+
+  /// @brief Gets the bytes held from upstream
+  std::size_t BytesReserved() const { return reserved_bytes; }
+
+  /// @brief Gets the resource chunks come from
+  std::pmr::memory_resource* Upstream() const { return upstream; }
+
+ protected:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    auto address = reinterpret_cast<std::uintptr_t>(current);
+    auto padding = (alignment - address % alignment) % alignment;
+    if (padding + bytes > static_cast<std::size_t>(current_end - current)) {
+      NewChunk(bytes + alignment);
+      address = reinterpret_cast<std::uintptr_t>(current);
+      padding = (alignment - address % alignment) % alignment;
+    }
+    auto* block = current + padding;
+    current = block + bytes;
+    used_bytes += padding + bytes;
+    return block;
+  }
+
+  void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+ private:
+  /// @brief Header at the start of every chunk
+  struct Chunk {
+    Chunk* next;
+    std::size_t bytes;
+  };
+
+  static constexpr std::size_t kMinChunkBytes = 256;
+  static constexpr std::size_t kChunkAlignment = alignof(std::max_align_t);
+  static constexpr std::size_t kHeaderBytes =
+      (sizeof(Chunk) + kChunkAlignment - 1) / kChunkAlignment *
+      kChunkAlignment;
+
+  std::pmr::memory_resource* upstream;
+  std::size_t next_chunk_bytes;
+  std::byte* initial_buffer = nullptr;
+  std::size_t initial_buffer_bytes = 0;
+  std::byte* current = nullptr;
+  std::byte* current_end = nullptr;
+  Chunk* chunks = nullptr;
+  std::size_t used_bytes = 0;
+  std::size_t reserved_bytes = 0;
+
+  static std::byte* ChunkData(Chunk* chunk) {
+    return reinterpret_cast<std::byte*>(chunk) + kHeaderBytes;
+  }
+
+  void NewChunk(std::size_t min_bytes) {
+    auto bytes = std::max(next_chunk_bytes, min_bytes + kHeaderBytes);
+    auto* chunk = static_cast<Chunk*>(upstream->allocate(bytes,
+                                                         kChunkAlignment));
+    chunk->next = chunks;
+    chunk->bytes = bytes;
+    chunks = chunk;
+    reserved_bytes += bytes;
+    next_chunk_bytes = bytes * 2;
+    current = ChunkData(chunk);
+    current_end = reinterpret_cast<std::byte*>(chunk) + bytes;
+  }
+
+  void FreeChunk(Chunk* chunk) {
+    reserved_bytes -= chunk->bytes;
+    upstream->deallocate(chunk, chunk->bytes, kChunkAlignment);
+  }
+};
+
+}  // namespace memory
+}  // namespace nll
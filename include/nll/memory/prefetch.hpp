@@ -0,0 +1,17 @@
+#pragma once
+
+namespace nll {
+namespace detail {
+
+/// @brief Hints that address will be read soon, so independent cache misses
+/// can overlap. A no-op on compilers without __builtin_prefetch.
+inline void PrefetchRead(const void* address) {
+#if defined(__GNUC__)
+  __builtin_prefetch(address, 0, 3);
+#else
+  (void)address;
+#endif
+}
+
+}  // namespace detail
+}  // namespace nll
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace nll {
+namespace parallel {
+
+/// @brief Work-stealing deque (Chase and Lev, "Dynamic Circular
+/// Work-Stealing Deque", with the C11 memory orderings of Le et al.,
+/// "Correct and Efficient Work-Stealing for Weak Memory Models"). One owner
+/// thread pushes and pops at the bottom, LIFO, so it keeps working on what
+/// it touched last; any thread may steal from the top, FIFO, taking the
+/// oldest and usually largest piece of work. The owner's operations only
+/// contend with thieves over the last element.
+///
+/// The ring grows when full. Outgrown rings are kept until the deque is
+/// destroyed, since a thief may still be reading one.
+/// @tparam T trivially copyable element, typically a pointer
+template <class T>
+class ChaseLevDeque {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "deque elements must be trivially copyable");
+
+  struct Ring {
+    std::int64_t capacity;
+    std::unique_ptr<std::atomic<T>[]> slots;
+
+    explicit Ring(std::int64_t capacity)
+        : capacity(capacity), slots(new std::atomic<T>[capacity]) {}
+
+    T Get(std::int64_t i) const {
+      return slots[i & (capacity - 1)].load(std::memory_order_relaxed);
+    }
+
+    void Put(std::int64_t i, T value) {
+      slots[i & (capacity - 1)].store(value, std::memory_order_relaxed);
+    }
+  };
+
+  // top and bottom on their own cache lines, so thieves hammering top do
+  // not slow down the owner's pushes
+  alignas(64) std::atomic<std::int64_t> top{0};
+  alignas(64) std::atomic<std::int64_t> bottom{0};
+  alignas(64) std::atomic<Ring*> ring;
+  std::vector<std::unique_ptr<Ring>> rings;
+
+  Ring* Grow(Ring* old, std::int64_t first, std::int64_t last) {
+    auto grown = std::make_unique<Ring>(old->capacity * 2);
+    for (auto i = first; i < last; i++) {
+      grown->Put(i, old->Get(i));
+    }
+    auto* raw = grown.get();
+    rings.push_back(std::move(grown));
+    ring.store(raw, std::memory_order_release);
+    return raw;
+  }
+
+ public:
+  /// @brief Constructor
+  /// @param capacity initial capacity, rounded up to a power of two
+  explicit ChaseLevDeque(std::size_t capacity = 256) {
+    std::int64_t rounded = 1;
+    while (rounded < static_cast<std::int64_t>(capacity)) {
+      rounded *= 2;
+    }
+    rings.push_back(std::make_unique<Ring>(rounded));
+    ring.store(rings.back().get(), std::memory_order_relaxed);
+  }
+
+  ChaseLevDeque(const ChaseLevDeque&) = delete;
+  ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+  /// @brief Pushes value at the bottom. Owner only.
+  void Push(T value) {
+    auto b = bottom.load(std::memory_order_relaxed);
+    auto t = top.load(std::memory_order_acquire);
+    auto* current = ring.load(std::memory_order_relaxed);
+    if (b - t > current->capacity - 1) {
+      current = Grow(current, t, b);
+    }
+    current->Put(b, value);
+    // A release store rather than the paper's release fence: the same code
+    // on x86 and ARM, and visible to ThreadSanitizer
+    bottom.store(b + 1, std::memory_order_release);
+  }
+
+  /// @brief Pops the most recently pushed element. Owner only.
+  /// @return the element, or std::nullopt if empty or a thief took the last
+  std::optional<T> Pop() {
+    auto b = bottom.load(std::memory_order_relaxed) - 1;
+    auto* current = ring.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto t = top.load(std::memory_order_relaxed);
+    if (t > b) {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+    auto value = current->Get(b);
+    if (t == b) {
+      // The last element: race the thieves for it
+      bool won = top.compare_exchange_strong(
+          t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      bottom.store(b + 1, std::memory_order_relaxed);
+      if (!won) {
+        return std::nullopt;
+      }
+    }
+    return value;
+  }
+
+  /// @brief Takes the oldest element. Any thread.
+  /// @return the element, or std::nullopt if empty or another thread won
+  /// the race for it
+  std::optional<T> Steal() {
+    auto t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto b = bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+      return std::nullopt;
+    }
+    auto value = ring.load(std::memory_order_acquire)->Get(t);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed)) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  /// @brief Gets the number of elements. Only a hint while other threads
+  /// push or steal.
+  std::size_t Size() const {
+    auto b = bottom.load(std::memory_order_relaxed);
+    auto t = top.load(std::memory_order_relaxed);
+    return b > t ? static_cast<std::size_t>(b - t) : 0;
+  }
+
+  /// @brief Returns whether the deque looks empty, see Size
+  bool Empty() const { return Size() == 0; }
+
+  /// @brief Gets the number of slots in the current ring
+  std::size_t Capacity() const {
+    return static_cast<std::size_t>(
+        ring.load(std::memory_order_relaxed)->capacity);
+  }
+};
+
+}  // namespace parallel
+}  // namespace nll
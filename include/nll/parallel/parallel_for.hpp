@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "nll/parallel/thread_pool.hpp"
+
+namespace nll {
+namespace parallel {
+
+namespace detail {
+
+/// @brief Picks the grain of a loop over count indices: the given one, or
+/// for 0 enough chunks to give every worker about eight to balance with
+template <class TIndex>
+TIndex GrainFor(TIndex count, std::size_t grain, const ThreadPool& pool) {
+  if (grain == 0) {
+    grain = static_cast<std::size_t>(count) / (8 * pool.WorkerCount());
+  }
+  return static_cast<TIndex>(std::max<std::size_t>(grain, 1));
+}
+
+/// @brief Runs body(first, last) over [begin, end) in chunks of at most
+/// grain. Halves the range, forking the upper half, until it fits a chunk:
+/// idle workers then steal the largest halves first.
+template <class TIndex, class TBody>
+void ForChunks(TaskGroup& group, TIndex begin, TIndex end, TIndex grain,
+               const TBody& body) {
+  while (end - begin > grain) {
+    auto middle = begin + (end - begin) / 2;
+    group.Run([&group, middle, end, grain, &body] {
+      ForChunks(group, middle, end, grain, body);
+    });
+    end = middle;
+  }
+  body(begin, end);
+}
+
+template <class T, class TIndex, class TMap, class TReduce>
+T ReduceChunks(ThreadPool& pool, TIndex begin, TIndex end, TIndex grain,
+               const T& identity, const TMap& map, const TReduce& reduce) {
+  if (end - begin <= grain) {
+    T result = identity;
+    for (auto i = begin; i < end; i++) {
+      result = reduce(std::move(result), map(i));
+    }
+    return result;
+  }
+  auto middle = begin + (end - begin) / 2;
+  std::optional<T> upper;
+  TaskGroup group(pool);
+  group.Run([&] {
+    upper.emplace(
+        ReduceChunks(pool, middle, end, grain, identity, map, reduce));
+  });
+  auto lower = ReduceChunks(pool, begin, middle, grain, identity, map, reduce);
+  group.Wait();
+  return reduce(std::move(lower), std::move(*upper));
+}
+
+}  // namespace detail
+
+/// @brief Calls body(i) for every i in [begin, end) on the pool's workers
+/// and the calling thread, returning once all calls finished
+/// @param grain most indices one task runs; 0 splits the range into about
+/// eight chunks per worker. Raise it when body is tiny, so scheduling does
+/// not dominate.
+/// @throws the first exception body threw
+template <class TIndex, class TBody>
+void ParallelFor(TIndex begin, TIndex end, const TBody& body,
+                 std::size_t grain = 0, ThreadPool& pool = DefaultPool()) {
+  static_assert(std::is_integral<TIndex>::value,
+                "parallel loops need an integer index");
+  if (begin >= end) {
+    return;
+  }
+  auto chunk = detail::GrainFor<TIndex>(end - begin, grain, pool);
+  // Named, since tasks still use it after ForChunks returns
+  auto chunk_body = [&body](TIndex first, TIndex last) {
+    for (auto i = first; i < last; i++) {
+      body(i);
+    }
+  };
+  TaskGroup group(pool);
+  detail::ForChunks(group, begin, end, chunk, chunk_body);
+  group.Wait();
+}
+
+/// @brief Like ParallelFor, but calls body(first, last) once per chunk, for
+/// loops that set up state per chunk or vectorize over it
+template <class TIndex, class TBody>
+void ParallelForRange(TIndex begin, TIndex end, const TBody& body,
+                      std::size_t grain = 0,
+                      ThreadPool& pool = DefaultPool()) {
+  static_assert(std::is_integral<TIndex>::value,
+                "parallel loops need an integer index");
+  if (begin >= end) {
+    return;
+  }
+  auto chunk = detail::GrainFor<TIndex>(end - begin, grain, pool);
+  TaskGroup group(pool);
+  detail::ForChunks(group, begin, end, chunk, body);
+  group.Wait();
+}
+
+/// @brief Folds map(i) over [begin, end) with reduce, in parallel. Chunks
+/// are combined in index order, so reduce needs to be associative but not
+/// commutative.
+/// @param identity value that reduce leaves the other operand unchanged
+/// with, the result of an empty range
+/// @param map called as map(i), returning a T
+/// @param reduce called as reduce(T, T), returning a T
+/// @param grain most indices one task folds, 0 as for ParallelFor
+/// @throws the first exception map or reduce threw
+template <class T, class TIndex, class TMap, class TReduce>
+T ParallelReduce(TIndex begin, TIndex end, const T& identity,
+                 const TMap& map, const TReduce& reduce,
+                 std::size_t grain = 0, ThreadPool& pool = DefaultPool()) {
+  static_assert(std::is_integral<TIndex>::value,
+                "parallel loops need an integer index");
+  if (begin >= end) {
+    return identity;
+  }
+  auto chunk = detail::GrainFor<TIndex>(end - begin, grain, pool);
+  return detail::ReduceChunks(pool, begin, end, chunk, identity, map, reduce);
+}
+
+/// @brief Runs every function in parallel on the default pool, the last
+/// one on the calling thread, and returns once all finished
+/// @throws the first exception a function threw
+template <class... TFunctions>
+void ParallelInvoke(TFunctions&&... functions) {
+  static_assert(sizeof...(TFunctions) > 0, "nothing to invoke");
+  TaskGroup group;
+  auto invoke = [&group, count = std::size_t{0}](auto&& function) mutable {
+    if (++count < sizeof...(TFunctions)) {
+      group.Run(std::forward<decltype(function)>(function));
+    } else {
+      function();
+    }
+  };
+  (invoke(std::forward<TFunctions>(functions)), ...);
+  group.Wait();
+}
+
+}  // namespace parallel
+}  // namespace nll
@@ -0,0 +1,604 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "nll/collections/ring_buffer.hpp"
+
+namespace nll {
+namespace parallel {
+
+/// @brief Lazy sequence produced by a coroutine with co_yield. Nothing runs
+/// until the first element is asked for, and each step of a range-for
+/// resumes the coroutine just long enough to yield the next element, so
+/// generators that consume generators fuse into one loop on one thread.
+template <class T>
+class Generator {
+ public:
+  struct promise_type {
+    T* current = nullptr;
+    /// @brief Copy of the last lvalue yielded, so consumers may move from
+    /// it without touching the coroutine's own variable
+    std::optional<T> copy;
+    std::exception_ptr error;
+
+    Generator get_return_object() {
+      return Generator(
+          std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+
+    std::suspend_always yield_value(const T& value) {
+      copy.emplace(value);
+      current = std::addressof(*copy);
+      return {};
+    }
+
+    // A yielded rvalue lives in the coroutine frame until it resumes, and
+    // is the consumer's to move from
+    std::suspend_always yield_value(T&& value) noexcept {
+      current = std::addressof(value);
+      return {};
+    }
+
+    void return_void() {}
+    void unhandled_exception() { error = std::current_exception(); }
+  };
+
+  using Handle = std::coroutine_handle<promise_type>;
+
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using reference = T&;
+    using pointer = T*;
+
+    Iterator() = default;
+    explicit Iterator(Handle handle) : handle(handle) {}
+
+    T& operator*() const { return *handle.promise().current; }
+    T* operator->() const { return handle.promise().current; }
+
+    Iterator& operator++() {
+      Advance(handle);
+      return *this;
+    }
+
+    void operator++(int) { ++*this; }
+
+    bool operator==(std::default_sentinel_t) const {
+      return !handle || handle.done();
+    }
+
+   private:
+    Handle handle;
+  };
+
+  Generator(Generator&& other) noexcept
+      : handle(std::exchange(other.handle, nullptr)) {}
+
+  Generator& operator=(Generator other) noexcept {
+    std::swap(handle, other.handle);
+    return *this;
+  }
+
+  ~Generator() {
+    if (handle) {
+      handle.destroy();
+    }
+  }
+
+  /// @brief Starts the coroutine and runs it to its first co_yield
+  /// @throws whatever the coroutine throws before yielding
+  Iterator begin() {
+    Advance(handle);
+    return Iterator(handle);
+  }
+
+  std::default_sentinel_t end() { return {}; }
+
+ private:
+  Handle handle;
+
+  explicit Generator(Handle handle) : handle(handle) {}
+
+  static void Advance(Handle handle) {
+    handle.resume();
+    if (handle.promise().error) {
+      std::rethrow_exception(std::exchange(handle.promise().error, nullptr));
+    }
+  }
+};
+
+class Pipeline;
+
+/// @brief Thrown into a stage waiting on a channel of a pipeline that is
+/// shutting down because another stage failed
+class PipelineCancelled : public std::runtime_error {
+ public:
+  PipelineCancelled() : std::runtime_error("pipeline was cancelled!") {}
+};
+
+namespace detail {
+
+/// @brief Run queue of suspended stages, drained by one thread. A stage is
+/// always resumed by the scheduler it was added to, whichever thread made
+/// it runnable.
+class StageScheduler {
+ public:
+  /// @param exclusive whether every stage of the pipeline runs here, in
+  /// which case an empty queue with stages left is a deadlock
+  explicit StageScheduler(bool exclusive) : exclusive(exclusive) {}
+
+  void Add() { live++; }
+
+  void Post(std::coroutine_handle<> handle) {
+    {
+      std::lock_guard guard(mutex);
+      ready.push_back(handle);
+    }
+    wake.notify_one();
+  }
+
+  void Finished() {
+    {
+      std::lock_guard guard(mutex);
+      live--;
+    }
+    wake.notify_one();
+  }
+
+  /// @brief Resumes stages until all of them have finished
+  /// @throws std::logic_error if the stages of an exclusive scheduler all
+  /// wait on each other
+  void Run() {
+    std::unique_lock lock(mutex);
+    while (true) {
+      if (ready.empty() && live > 0 && exclusive) {
+        throw std::logic_error("pipeline stages deadlocked!");
+      }
+      wake.wait(lock, [&] { return !ready.empty() || live == 0; });
+      if (ready.empty()) {
+        return;
+      }
+      auto handle = ready.front();
+      ready.pop_front();
+      lock.unlock();
+      handle.resume();
+      lock.lock();
+    }
+  }
+
+ private:
+  const bool exclusive;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::deque<std::coroutine_handle<>> ready;
+  std::size_t live = 0;
+};
+
+/// @brief A suspended stage and the scheduler that resumes it
+struct Waiter {
+  std::coroutine_handle<> handle;
+  StageScheduler* scheduler = nullptr;
+
+  explicit operator bool() const { return static_cast<bool>(handle); }
+
+  void Resume() const { scheduler->Post(handle); }
+};
+
+class ChannelBase {
+ public:
+  virtual ~ChannelBase() = default;
+  virtual void Cancel() = 0;
+};
+
+}  // namespace detail
+
+/// @brief Coroutine of a pipeline stage: a loop that co_awaits batches from
+/// input channels and sends batches to output channels, handed to
+/// Pipeline::Add. It starts when the pipeline runs.
+class Stage {
+ public:
+  struct promise_type {
+    detail::StageScheduler* scheduler = nullptr;
+    Pipeline* pipeline = nullptr;
+
+    Stage get_return_object() {
+      return Stage(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    auto final_suspend() noexcept {
+      struct Finish {
+        bool await_ready() noexcept { return false; }
+        void await_suspend(
+            std::coroutine_handle<promise_type> handle) noexcept {
+          handle.promise().scheduler->Finished();
+        }
+        void await_resume() noexcept {}
+      };
+      return Finish();
+    }
+
+    void return_void() {}
+    void unhandled_exception();
+  };
+
+  using Handle = std::coroutine_handle<promise_type>;
+
+  Stage(Stage&& other) noexcept
+      : handle(std::exchange(other.handle, nullptr)) {}
+
+  Stage& operator=(Stage other) noexcept {
+    std::swap(handle, other.handle);
+    return *this;
+  }
+
+  ~Stage() {
+    if (handle) {
+      handle.destroy();
+    }
+  }
+
+ private:
+  friend class Pipeline;
+
+  Handle handle;
+
+  explicit Stage(Handle handle) : handle(handle) {}
+};
+
+/// @brief Bounded channel of batches between two pipeline stages, stored
+/// in a RingBuffer of kBatches batches. A sender that finds it full is
+/// suspended until the receiver frees a slot, so a fast stage cannot run
+/// ahead of a slow one by more than the channel holds. One lock is taken
+/// per batch rather than per item. Each channel has one sending and one
+/// receiving stage.
+template <class T, std::size_t kBatches = 8>
+class Channel : public detail::ChannelBase {
+ public:
+  using Batch = std::vector<T>;
+
+  class SendAwaiter {
+   public:
+    bool await_ready() const noexcept { return batch.empty(); }
+
+    bool await_suspend(Stage::Handle handle) {
+      std::unique_lock lock(channel->mutex);
+      if (channel->cancelled) {
+        cancelled = true;
+        return false;
+      }
+      if (channel->closed) {
+        throw std::logic_error("send on a closed channel!");
+      }
+      if (channel->receiver) {
+        // The receiver only waits on an empty ring: hand the batch over
+        *channel->received = std::move(batch);
+        auto receiver = std::exchange(channel->receiver, {});
+        lock.unlock();
+        receiver.Resume();
+        return false;
+      }
+      if (!channel->ring.Full()) {
+        channel->ring.Push(std::move(batch));
+        return false;
+      }
+      // The receiver pushes batch for us when it frees a slot
+      channel->sender = {handle, handle.promise().scheduler};
+      channel->pending = &batch;
+      suspended = true;
+      return true;
+    }
+
+    /// @throws PipelineCancelled if the pipeline is shutting down
+    void await_resume() const {
+      // Only a suspended sender can miss the cancellation, and it checks
+      // once per batch rather than once per item
+      if (cancelled || (suspended && channel->IsCancelled())) {
+        throw PipelineCancelled();
+      }
+    }
+
+   private:
+    friend class Channel;
+
+    Channel* channel;
+    Batch batch;
+    bool suspended = false;
+    bool cancelled = false;
+
+    SendAwaiter(Channel* channel, Batch batch)
+        : channel(channel), batch(std::move(batch)) {}
+  };
+
+  class ReceiveAwaiter {
+   public:
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(Stage::Handle handle) {
+      std::unique_lock lock(channel->mutex);
+      if (channel->cancelled) {
+        cancelled = true;
+        return false;
+      }
+      if (!channel->ring.Empty()) {
+        result = channel->ring.Pop();
+        if (channel->sender) {
+          channel->ring.Push(std::move(*channel->pending));
+          channel->pending = nullptr;
+          auto sender = std::exchange(channel->sender, {});
+          lock.unlock();
+          sender.Resume();
+        }
+        return false;
+      }
+      if (channel->closed) {
+        return false;
+      }
+      channel->receiver = {handle, handle.promise().scheduler};
+      channel->received = &result;
+      suspended = true;
+      return true;
+    }
+
+    /// @return the next batch, or nothing once the channel is closed and
+    /// drained
+    /// @throws PipelineCancelled if the pipeline is shutting down
+    std::optional<Batch> await_resume() {
+      if (cancelled || (suspended && channel->IsCancelled())) {
+        throw PipelineCancelled();
+      }
+      return std::move(result);
+    }
+
+   private:
+    friend class Channel;
+
+    Channel* channel;
+    std::optional<Batch> result;
+    bool suspended = false;
+    bool cancelled = false;
+
+    explicit ReceiveAwaiter(Channel* channel) : channel(channel) {}
+  };
+
+  Channel() = default;
+  Channel(const Channel&) = delete;
+  Channel& operator=(const Channel&) = delete;
+
+  /// @brief co_await suspends while the channel is full. Sending an empty
+  /// batch does nothing.
+  /// @throws std::logic_error if the channel was closed
+  SendAwaiter Send(Batch batch) { return SendAwaiter(this, std::move(batch)); }
+
+  /// @brief co_await gets the next batch, suspending while the channel is
+  /// empty; nothing once it is closed and drained
+  ReceiveAwaiter Receive() { return ReceiveAwaiter(this); }
+
+  /// @brief Ends the stream: the receiver drains what was sent and then
+  /// gets nothing
+  void Close() {
+    std::unique_lock lock(mutex);
+    closed = true;
+    if (receiver) {
+      auto waiting = std::exchange(receiver, {});
+      lock.unlock();
+      waiting.Resume();
+    }
+  }
+
+  /// @brief Drops what is queued and wakes both ends, which then throw
+  /// PipelineCancelled
+  void Cancel() override {
+    std::unique_lock lock(mutex);
+    cancelled = closed = true;
+    ring.Clear();
+    auto waiting_sender = std::exchange(sender, {});
+    auto waiting_receiver = std::exchange(receiver, {});
+    pending = nullptr;
+    received = nullptr;
+    lock.unlock();
+    if (waiting_sender) {
+      waiting_sender.Resume();
+    }
+    if (waiting_receiver) {
+      waiting_receiver.Resume();
+    }
+  }
+
+ private:
+  mutable std::mutex mutex;
+  RingBuffer<Batch, kBatches + 1> ring;
+  bool closed = false;
+  bool cancelled = false;
+  // At most one of each waits: the sender on a full ring with its batch,
+  // the receiver on an empty one with the slot to fill
+  detail::Waiter sender;
+  Batch* pending = nullptr;
+  detail::Waiter receiver;
+  std::optional<Batch>* received = nullptr;
+
+  bool IsCancelled() const {
+    std::lock_guard guard(mutex);
+    return cancelled;
+  }
+};
+
+/// @brief Sends items one at a time but over the channel in batches of
+/// batch_size: co_await on Push only suspends when a full batch meets a
+/// full channel
+template <class T, std::size_t kBatches = 8>
+class BatchWriter {
+ public:
+  BatchWriter(Channel<T, kBatches>& channel, std::size_t batch_size)
+      : channel(channel), batch_size(batch_size) {
+    batch.reserve(batch_size);
+  }
+
+  auto Push(T value) {
+    batch.push_back(std::move(value));
+    if (batch.size() < batch_size) {
+      return channel.Send({});
+    }
+    return Flush();
+  }
+
+  /// @brief Sends what is buffered, even if it is less than a batch
+  auto Flush() {
+    auto full = std::exchange(batch, {});
+    batch.reserve(batch_size);
+    return channel.Send(std::move(full));
+  }
+
+ private:
+  Channel<T, kBatches>& channel;
+  std::size_t batch_size;
+  std::vector<T> batch;
+};
+
+/// @brief How a Pipeline maps stages onto threads
+enum class PipelineMode {
+  /// @brief Every stage on the thread calling Run, switching stages only
+  /// when a channel fills or empties
+  kFused,
+  /// @brief A thread per stage
+  kThreaded,
+};
+
+/// @brief Owns the stages and channels of a streaming pipeline and runs it.
+/// Stages are coroutines returning Stage that talk through the pipeline's
+/// channels; a Generator feeds one with Pipeline::Feed. Fused, a pipeline
+/// behaves like a hand-written loop that processes a batch per stage in
+/// turn; threaded, the stages overlap and the channels absorb their jitter.
+///
+/// If a stage throws, every channel is cancelled so the other stages unwind,
+/// and Run rethrows the first exception.
+class Pipeline {
+ public:
+  explicit Pipeline(PipelineMode mode = PipelineMode::kFused)
+      : mode(mode) {
+    if (mode == PipelineMode::kFused) {
+      schedulers.push_back(std::make_unique<detail::StageScheduler>(true));
+    }
+  }
+
+  Pipeline(const Pipeline&) = delete;
+  Pipeline& operator=(const Pipeline&) = delete;
+
+  /// @brief Creates a channel the pipeline owns, for stages to share
+  template <class T, std::size_t kBatches = 8>
+  Channel<T, kBatches>& MakeChannel() {
+    auto channel = std::make_unique<Channel<T, kBatches>>();
+    auto& result = *channel;
+    channels.push_back(std::move(channel));
+    return result;
+  }
+
+  /// @brief Adds a stage to start on Run
+  void Add(Stage stage) {
+    auto& promise = stage.handle.promise();
+    if (mode == PipelineMode::kThreaded) {
+      schedulers.push_back(std::make_unique<detail::StageScheduler>(false));
+    }
+    promise.scheduler = schedulers.back().get();
+    promise.pipeline = this;
+    promise.scheduler->Add();
+    stages.push_back(std::move(stage));
+  }
+
+  /// @brief Adds a stage sending everything source yields to channel, in
+  /// batches of batch_size, then closing it
+  template <class T, std::size_t kBatches>
+  void Feed(Generator<T> source, Channel<T, kBatches>& channel,
+            std::size_t batch_size) {
+    Add(FeedStage(std::move(source), channel, batch_size));
+  }
+
+  /// @brief Runs every stage to completion
+  /// @throws the first exception a stage threw
+  /// @throws std::logic_error if fused stages wait on each other forever
+  void Run() {
+    for (auto& stage : stages) {
+      stage.handle.promise().scheduler->Post(stage.handle);
+    }
+    if (mode == PipelineMode::kFused) {
+      schedulers.front()->Run();
+    } else {
+      std::vector<std::thread> threads;
+      for (auto& scheduler : schedulers) {
+        threads.emplace_back([&scheduler] { scheduler->Run(); });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+ private:
+  friend struct Stage::promise_type;
+
+  PipelineMode mode;
+  std::vector<std::unique_ptr<detail::StageScheduler>> schedulers;
+  std::vector<std::unique_ptr<detail::ChannelBase>> channels;
+  std::vector<Stage> stages;
+  std::mutex error_mutex;
+  std::exception_ptr error;
+
+  void Fail(std::exception_ptr failure) {
+    {
+      std::lock_guard guard(error_mutex);
+      if (error) {
+        return;
+      }
+      error = std::move(failure);
+    }
+    for (auto& channel : channels) {
+      channel->Cancel();
+    }
+  }
+
+  template <class T, std::size_t kBatches>
+  static Stage FeedStage(Generator<T> source, Channel<T, kBatches>& channel,
+                         std::size_t batch_size) {
+    BatchWriter<T, kBatches> writer(channel, batch_size);
+    for (auto& value : source) {
+      co_await writer.Push(std::move(value));
+    }
+    co_await writer.Flush();
+    channel.Close();
+  }
+};
+
+inline void Stage::promise_type::unhandled_exception() {
+  // Unwinding from cancellation is not a failure of its own
+  try {
+    throw;
+  } catch (const PipelineCancelled&) {
+  } catch (...) {
+    pipeline->Fail(std::current_exception());
+  }
+}
+
+}  // namespace parallel
+}  // namespace nll
@@ -0,0 +1,384 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "nll/parallel/chase_lev_deque.hpp"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace nll {
+namespace parallel {
+
+/// @brief Options of a ThreadPool
+struct ThreadPoolOptions {
+  /// @brief Number of worker threads, 0 for one per hardware thread
+  std::size_t threads = 0;
+  /// @brief Pins worker i to cpus[i % cpus.size()], so it keeps its caches
+  /// and stays on one NUMA node. Failing to pin is not an error.
+  bool pin_threads = false;
+  /// @brief CPUs to pin to, in order; empty means the CPUs the process may
+  /// run on, so workers fill cores in their numbering order
+  std::vector<int> cpus;
+};
+
+class ThreadPool;
+class TaskGroup;
+
+namespace detail {
+
+/// @brief Unit of work queued in a ThreadPool
+struct Task {
+  virtual ~Task() = default;
+  virtual void Run() = 0;
+};
+
+/// @brief Which pool and worker the calling thread is, if any
+struct WorkerContext {
+  const ThreadPool* pool = nullptr;
+  std::size_t index = 0;
+};
+
+inline WorkerContext& CurrentWorker() {
+  thread_local WorkerContext context;
+  return context;
+}
+
+/// @brief Gets the CPUs the calling process may run on
+inline std::vector<int> AllowedCpus() {
+  std::vector<int> cpus;
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+#endif
+  return cpus;
+}
+
+/// @brief Restricts thread to one CPU
+/// @return false if pinning is unsupported or failed
+inline bool PinThread(std::thread& thread, int cpu) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) ==
+         0;
+#else
+  (void)thread;
+  (void)cpu;
+  return false;
+#endif
+}
+
+}  // namespace detail
+
+/// @brief Work-stealing thread pool. Every worker owns a ChaseLevDeque:
+/// tasks spawned on a worker go to the bottom of its own deque and it pops
+/// them back LIFO, while idle workers steal FIFO from a random victim's top.
+/// Tasks from threads outside the pool go through a shared queue. Workers
+/// that find nothing spin briefly, then sleep until new work is queued.
+///
+/// Work is submitted through a TaskGroup, or the ParallelFor family in
+/// parallel_for.hpp.
+class ThreadPool {
+ public:
+  /// @brief Starts the workers
+  explicit ThreadPool(const ThreadPoolOptions& options = ThreadPoolOptions()) {
+    auto count = options.threads;
+    if (count == 0) {
+      count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    auto cpus = options.cpus.empty() ? detail::AllowedCpus() : options.cpus;
+    for (std::size_t i = 0; i < count; i++) {
+      workers.push_back(std::make_unique<Worker>());
+      workers.back()->random_state = 0x9e3779b97f4a7c15ULL * (i + 1);
+    }
+    for (std::size_t i = 0; i < count; i++) {
+      workers[i]->thread = std::thread([this, i] { WorkerLoop(i); });
+      if (options.pin_threads && !cpus.empty()) {
+        detail::PinThread(workers[i]->thread, cpus[i % cpus.size()]);
+      }
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// @brief Stops and joins the workers. Every TaskGroup using the pool must
+  /// have finished.
+  ~ThreadPool() {
+    {
+      std::lock_guard guard(sleep_mutex);
+      stopping.store(true, std::memory_order_relaxed);
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+      worker->thread.join();
+    }
+  }
+
+  /// @brief Gets the number of worker threads
+  std::size_t WorkerCount() const { return workers.size(); }
+
+  /// @brief Returns whether the calling thread is one of this pool's workers
+  bool IsWorkerThread() const { return detail::CurrentWorker().pool == this; }
+
+ private:
+  friend class TaskGroup;
+
+  static constexpr std::size_t kNotAWorker =
+      std::numeric_limits<std::size_t>::max();
+  static constexpr int kSpinRounds = 64;
+
+  struct alignas(64) Worker {
+    ChaseLevDeque<detail::Task*> deque;
+    std::uint64_t random_state = 0;
+    std::thread thread;
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers;
+
+  std::mutex injected_mutex;
+  std::deque<detail::Task*> injected;
+  std::atomic<std::size_t> injected_count{0};
+
+  std::mutex sleep_mutex;
+  std::condition_variable wake;
+  std::atomic<std::size_t> sleepers{0};
+  std::atomic<bool> stopping{false};
+
+  std::size_t WorkerIndex() const {
+    auto& context = detail::CurrentWorker();
+    return context.pool == this ? context.index : kNotAWorker;
+  }
+
+  /// @brief Queues task on the calling worker's deque, or the shared queue
+  /// from other threads
+  void Submit(detail::Task* task) {
+    auto index = WorkerIndex();
+    if (index != kNotAWorker) {
+      workers[index]->deque.Push(task);
+    } else {
+      std::lock_guard guard(injected_mutex);
+      injected.push_back(task);
+      injected_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Pairs with the fence in Sleep: either this sees the sleeper, or the
+    // sleeper sees the task
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers.load(std::memory_order_relaxed) > 0) {
+      std::lock_guard guard(sleep_mutex);
+      wake.notify_one();
+    }
+  }
+
+  bool HasQueuedTasks() const {
+    if (injected_count.load(std::memory_order_relaxed) > 0) {
+      return true;
+    }
+    return std::any_of(workers.begin(), workers.end(),
+                       [](auto& worker) { return !worker->deque.Empty(); });
+  }
+
+  detail::Task* TakeInjected() {
+    if (injected_count.load(std::memory_order_relaxed) == 0) {
+      return nullptr;
+    }
+    std::lock_guard guard(injected_mutex);
+    if (injected.empty()) {
+      return nullptr;
+    }
+    auto* task = injected.front();
+    injected.pop_front();
+    injected_count.fetch_sub(1, std::memory_order_relaxed);
+    return task;
+  }
+
+  /// @brief Steals from every other worker once, starting at a random one
+  detail::Task* StealFromOthers(std::size_t thief, std::uint64_t& random) {
+    // xorshift64
+    random ^= random << 13;
+    random ^= random >> 7;
+    random ^= random << 17;
+    auto count = workers.size();
+    auto start = static_cast<std::size_t>(random % count);
+    for (std::size_t i = 0; i < count; i++) {
+      auto victim = (start + i) % count;
+      if (victim == thief) {
+        continue;
+      }
+      if (auto task = workers[victim]->deque.Steal()) {
+        return *task;
+      }
+    }
+    return nullptr;
+  }
+
+  /// @brief Finds a task for the worker at index, or for an outside thread
+  /// if index is kNotAWorker: its own deque first, then the shared queue,
+  /// then other workers' deques
+  detail::Task* FindTask(std::size_t index, std::uint64_t& random) {
+    if (index != kNotAWorker) {
+      if (auto task = workers[index]->deque.Pop()) {
+        return *task;
+      }
+    }
+    if (auto* task = TakeInjected()) {
+      return task;
+    }
+    return StealFromOthers(index, random);
+  }
+
+  static void Execute(detail::Task* task) {
+    task->Run();
+    delete task;
+  }
+
+  /// @brief Runs one queued task on the calling thread, which helps the
+  /// pool while it waits for a TaskGroup
+  /// @return false if no task was found
+  bool RunOneTask() {
+    auto index = WorkerIndex();
+    thread_local std::uint64_t outside_random = 0x2545f4914f6cdd1dULL;
+    auto& random =
+        index == kNotAWorker ? outside_random : workers[index]->random_state;
+    if (auto* task = FindTask(index, random)) {
+      Execute(task);
+      return true;
+    }
+    return false;
+  }
+
+  /// @brief Blocks the worker until a task may be queued or the pool stops
+  void Sleep() {
+    std::unique_lock guard(sleep_mutex);
+    sleepers.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!HasQueuedTasks() && !stopping.load(std::memory_order_relaxed)) {
+      wake.wait(guard);
+    }
+    sleepers.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void WorkerLoop(std::size_t index) {
+    detail::CurrentWorker() = {this, index};
+    auto& random = workers[index]->random_state;
+    int idle_rounds = 0;
+    while (!stopping.load(std::memory_order_relaxed)) {
+      if (auto* task = FindTask(index, random)) {
+        Execute(task);
+        idle_rounds = 0;
+      } else if (++idle_rounds < kSpinRounds) {
+        std::this_thread::yield();
+      } else {
+        Sleep();
+        idle_rounds = 0;
+      }
+    }
+  }
+};
+
+/// @brief Gets the pool the parallel algorithms use unless given another,
+/// one worker per hardware thread, started on first use
+inline ThreadPool& DefaultPool() {
+  static ThreadPool pool;
+  return pool;
+}
+
+/// @brief Fork-join scope: Run queues tasks on a pool, Wait returns once
+/// all of them finished. A thread waiting runs queued tasks itself instead
+/// of blocking, so groups nest freely, including inside tasks of the same
+/// pool.
+class TaskGroup {
+ public:
+  explicit TaskGroup(ThreadPool& pool = DefaultPool()) : pool(pool) {}
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  /// @brief Waits for the tasks still running, dropping their exceptions
+  ~TaskGroup() { WaitForTasks(); }
+
+  /// @brief Queues function to run on the pool
+  template <class TFunction>
+  void Run(TFunction&& function) {
+    pending.fetch_add(1, std::memory_order_relaxed);
+    pool.Submit(new GroupTask<std::decay_t<TFunction>>(
+        *this, std::forward<TFunction>(function)));
+  }
+
+  /// @brief Waits for every task run so far
+  /// @throws the first exception a task threw
+  void Wait() {
+    WaitForTasks();
+    if (error) {
+      auto rethrown = std::move(error);
+      error = nullptr;
+      std::rethrow_exception(rethrown);
+    }
+  }
+
+ private:
+  template <class TFunction>
+  struct GroupTask : detail::Task {
+    TaskGroup& group;
+    TFunction function;
+
+    GroupTask(TaskGroup& group, TFunction function)
+        : group(group), function(std::move(function)) {}
+
+    void Run() override {
+      try {
+        function();
+      } catch (...) {
+        group.SetError(std::current_exception());
+      }
+      group.pending.fetch_sub(1, std::memory_order_release);
+    }
+  };
+
+  ThreadPool& pool;
+  std::atomic<std::size_t> pending{0};
+  std::mutex error_mutex;
+  std::exception_ptr error;
+
+  void SetError(std::exception_ptr thrown) {
+    std::lock_guard guard(error_mutex);
+    if (!error) {
+      error = thrown;
+    }
+  }
+
+  void WaitForTasks() {
+    while (pending.load(std::memory_order_acquire) > 0) {
+      if (!pool.RunOneTask()) {
+        std::this_thread::yield();
+      }
+    }
+  }
+};
+
+}  // namespace parallel
+}  // namespace nll
@@ -0,0 +1,56 @@
+#include "compare/json_reader.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using nll::bench::json::Parse;
+using nll::bench::json::Value;
+
+TEST(JsonReaderTest, ParsesScalars) {
+  ASSERT_EQ(Parse("null").type, Value::Type::kNull);
+  ASSERT_TRUE(Parse(" true ").boolean);
+  ASSERT_FALSE(Parse("false").boolean);
+  ASSERT_DOUBLE_EQ(Parse("-12.5e-1").number, -1.25);
+  ASSERT_DOUBLE_EQ(Parse("3.5534124354815395e+02").number,
+                   3.5534124354815395e+02);
+  ASSERT_EQ(Parse("\"a\\\"b\\\\c\\n\"").string, "a\"b\\c\n");
+}
+
+TEST(JsonReaderTest, DecodesUnicodeEscapes) {
+  ASSERT_EQ(Parse("\"\\u00e9\"").string, "\xc3\xa9");
+  ASSERT_EQ(Parse("\"\\u20ac\"").string, "\xe2\x82\xac");
+  ASSERT_EQ(Parse("\"\\ud83d\\ude00\"").string, "\xf0\x9f\x98\x80");
+}
+
+TEST(JsonReaderTest, ParsesNestedDocuments) {
+  auto document = Parse(R"({
+    "context": {"num_cpus": 8},
+    "benchmarks": [
+      {"name": "BM_A/16", "real_time": 1.5, "time_unit": "ns"},
+      {"name": "BM_B/16", "real_time": 2e3, "time_unit": "us"}
+    ]
+  })");
+  ASSERT_TRUE(document.IsObject());
+  ASSERT_DOUBLE_EQ(document.Find("context")->Find("num_cpus")->number, 8);
+  auto* benchmarks = document.Find("benchmarks");
+  ASSERT_TRUE(benchmarks->IsArray());
+  ASSERT_EQ(benchmarks->elements.size(), 2);
+  ASSERT_EQ(benchmarks->elements[1].Find("name")->string, "BM_B/16");
+  ASSERT_DOUBLE_EQ(benchmarks->elements[1].Find("real_time")->number, 2000);
+  ASSERT_EQ(document.Find("missing"), nullptr);
+  ASSERT_EQ(Parse("[]").elements.size(), 0);
+  ASSERT_EQ(Parse("{}").keys.size(), 0);
+}
+
+TEST(JsonReaderTest, RejectsInvalidDocuments) {
+  std::vector<std::string> invalid = {
+      "",     "[1,", "[1 2]", "{\"a\" 1}", "{1: 2}", "\"open", "01x",
+      "-",    "1.",  "1e",    "tru",      "[1] 2",  "\"\\q\"",
+      std::string(300, '[')};
+  for (const auto& text : invalid) {
+    ASSERT_THROW(Parse(text), std::runtime_error) << text;
+  }
+}
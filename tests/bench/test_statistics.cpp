@@ -0,0 +1,125 @@
+#include "compare/statistics.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace nll::bench::statistics;
+
+TEST(StatisticsTest, NormalQuantileInvertsCdf) {
+  ASSERT_NEAR(NormalCdf(0), 0.5, 1e-12);
+  ASSERT_NEAR(NormalQuantile(0.975), 1.959964, 1e-6);
+  ASSERT_NEAR(NormalQuantile(0.025), -1.959964, 1e-6);
+  ASSERT_THROW(NormalQuantile(1), std::invalid_argument);
+}
+
+TEST(StatisticsTest, Median) {
+  ASSERT_DOUBLE_EQ(Median({3, 1, 2}), 2);
+  ASSERT_DOUBLE_EQ(Median({4, 1, 3, 2}), 2.5);
+  ASSERT_THROW(Median({}), std::invalid_argument);
+}
+
+TEST(StatisticsTest, ExactDistributionMatchesEnumeration) {
+  // Every way of choosing which 4 of 9 ranked values are x's is equally
+  // likely; U counts the y's below each x
+  constexpr std::size_t m = 4;
+  constexpr std::size_t n = 5;
+  std::vector<double> counts(m * n + 1, 0);
+  std::vector<bool> is_x(m + n, false);
+  std::fill(is_x.begin() + n, is_x.end(), true);
+  double orderings = 0;
+  do {
+    std::size_t u = 0;
+    std::size_t ys = 0;
+    for (bool x : is_x) {
+      x ? u += ys : ys++;
+    }
+    counts[u]++;
+    orderings++;
+  } while (std::next_permutation(is_x.begin(), is_x.end()));
+
+  auto distribution = MannWhitneyDistribution(m, n);
+  ASSERT_EQ(distribution.size(), counts.size());
+  for (std::size_t u = 0; u < counts.size(); u++) {
+    ASSERT_NEAR(distribution[u], counts[u] / orderings, 1e-12) << u;
+  }
+  ASSERT_NEAR(MinimumPValue(m, n), 2 * counts[0] / orderings, 1e-12);
+}
+
+TEST(StatisticsTest, MannWhitneyExact) {
+  // Complete separation of 5 and 5: two of the C(10, 5) orderings are as
+  // extreme
+  auto result = MannWhitneyU({1, 2, 3, 4, 5}, {6, 7, 8, 9, 10});
+  ASSERT_TRUE(result.exact);
+  ASSERT_DOUBLE_EQ(result.u, 0);
+  ASSERT_NEAR(result.p_value, 2.0 / 252, 1e-12);
+
+  result = MannWhitneyU({1, 3, 5, 7, 9}, {2, 4, 6, 8, 10});
+  ASSERT_DOUBLE_EQ(result.u, 10);
+  ASSERT_GT(result.p_value, 0.5);
+}
+
+TEST(StatisticsTest, MannWhitneyApproximatesWithTies) {
+  auto result = MannWhitneyU({1, 1, 2, 2, 3}, {3, 4, 4, 5, 5});
+  ASSERT_FALSE(result.exact);
+  ASSERT_DOUBLE_EQ(result.u, 0.5);
+  ASSERT_LT(result.p_value, 0.02);
+
+  result = MannWhitneyU({7, 7, 7}, {7, 7, 7});
+  ASSERT_DOUBLE_EQ(result.p_value, 1);
+}
+
+TEST(StatisticsTest, MannWhitneyLargeSamples) {
+  std::mt19937 generator(7);
+  std::normal_distribution<double> noise(100, 5);
+  std::vector<double> x;
+  std::vector<double> same;
+  std::vector<double> shifted;
+  for (int i = 0; i < 200; i++) {
+    x.push_back(noise(generator));
+    same.push_back(noise(generator));
+    shifted.push_back(noise(generator) + 5);
+  }
+  ASSERT_GT(MannWhitneyU(x, same).p_value, 0.05);
+  ASSERT_LT(MannWhitneyU(x, shifted).p_value, 1e-6);
+}
+
+TEST(StatisticsTest, HodgesLehmannShift) {
+  std::vector<double> x = {10, 12, 11, 13, 9, 14};
+  std::vector<double> y;
+  for (auto value : x) {
+    y.push_back(value + 3);
+  }
+  auto shift = HodgesLehmannShift(x, y);
+  ASSERT_DOUBLE_EQ(shift.estimate, 3);
+  ASSERT_LT(shift.lower, 3);
+  ASSERT_GT(shift.upper, 3);
+  // 6 and 6 samples: P(U <= 5) <= 0.025 < P(U <= 6), so the 95% interval
+  // drops the 5 smallest and largest of the 36 differences
+  std::vector<double> differences;
+  for (auto a : x) {
+    for (auto b : y) {
+      differences.push_back(b - a);
+    }
+  }
+  std::sort(differences.begin(), differences.end());
+  ASSERT_DOUBLE_EQ(shift.lower, differences[5]);
+  ASSERT_DOUBLE_EQ(shift.upper, differences[30]);
+
+  auto wider = HodgesLehmannShift(x, y, 0.99);
+  ASSERT_LE(wider.lower, shift.lower);
+  ASSERT_GE(wider.upper, shift.upper);
+}
+
+TEST(StatisticsTest, HodgesLehmannShiftWithFewSamples) {
+  // No 2 by 2 ordering is rare enough for 95%, so the interval spans every
+  // difference
+  auto shift = HodgesLehmannShift({1, 2}, {5, 9});
+  ASSERT_DOUBLE_EQ(shift.lower, 3);
+  ASSERT_DOUBLE_EQ(shift.upper, 8);
+  ASSERT_DOUBLE_EQ(shift.estimate, 5.5);
+  ASSERT_THROW(HodgesLehmannShift({}, {1}), std::invalid_argument);
+}
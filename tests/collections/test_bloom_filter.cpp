@@ -0,0 +1,126 @@
+#include "nll/collections/bloom_filter.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+/// @brief Fraction of keys in [first, first + count) the filter accepts
+template <class TFilter>
+double AcceptedFraction(const TFilter& filter, int first, int count) {
+  int accepted = 0;
+  for (int key = first; key < first + count; key++) {
+    accepted += filter.MayContain(key);
+  }
+  return static_cast<double>(accepted) / count;
+}
+
+}  // namespace
+
+TEST(BlockedBloomFilterTest, NoFalseNegatives) {
+  nll::BlockedBloomFilter<int> filter(10000);
+  for (int key = 0; key < 10000; key++) {
+    filter.Insert(key);
+  }
+  ASSERT_EQ(AcceptedFraction(filter, 0, 10000), 1.0);
+}
+
+TEST(BlockedBloomFilterTest, FalsePositiveRateNearTarget) {
+  for (double target : {0.05, 0.01, 0.001}) {
+    nll::BlockedBloomFilter<int> filter(20000, target);
+    for (int key = 0; key < 20000; key++) {
+      filter.Insert(key);
+    }
+    auto measured = AcceptedFraction(filter, 1000000, 200000);
+    ASSERT_LT(measured, target * 1.5) << "target " << target;
+  }
+}
+
+TEST(BlockedBloomFilterTest, BitsPerKeyGrowWithAccuracy) {
+  auto loose = nll::BlockedBloomFilter<int>::BitsPerKeyFor(0.01);
+  auto tight = nll::BlockedBloomFilter<int>::BitsPerKeyFor(0.001);
+  ASSERT_GT(loose, 8);
+  ASSERT_LT(loose, 12);
+  ASSERT_GT(tight, loose);
+  ASSERT_LE(nll::BlockedBloomFilter<int>::FalsePositiveRate(loose), 0.01);
+  ASSERT_THROW(nll::BlockedBloomFilter<int>(10, 0), std::invalid_argument);
+  ASSERT_THROW(nll::BlockedBloomFilter<int>(10, 1), std::invalid_argument);
+  ASSERT_THROW(nll::BlockedBloomFilter<int>(10, 1e-30),
+               std::invalid_argument);
+}
+
+TEST(BlockedBloomFilterTest, BatchMatchesSingleCalls) {
+  std::vector<int> inserted;
+  for (int key = 0; key < 1000; key++) {
+    inserted.push_back(key * 7);
+  }
+  nll::BlockedBloomFilter<int> single(1000);
+  nll::BlockedBloomFilter<int> batch(1000);
+  for (auto key : inserted) {
+    single.Insert(key);
+  }
+  batch.InsertBatch(inserted.begin(), inserted.end());
+  ASSERT_EQ(single.Serialize(), batch.Serialize());
+
+  std::vector<int> queries;
+  for (int key = 0; key < 5000; key++) {
+    queries.push_back(key);
+  }
+  std::vector<bool> results;
+  batch.MayContainBatch(queries.begin(), queries.end(),
+                        std::back_inserter(results));
+  ASSERT_EQ(results.size(), queries.size());
+  for (std::size_t i = 0; i < queries.size(); i++) {
+    ASSERT_EQ(results[i], single.MayContain(queries[i]));
+  }
+}
+
+TEST(BlockedBloomFilterTest, StringKeys) {
+  nll::BlockedBloomFilter<std::string> filter(100);
+  filter.Insert("alpha");
+  filter.Insert("beta");
+  ASSERT_TRUE(filter.MayContain("alpha"));
+  ASSERT_TRUE(filter.MayContain("beta"));
+  filter.Clear();
+  ASSERT_FALSE(filter.MayContain("alpha"));
+}
+
+TEST(BlockedBloomFilterTest, SerializeRoundTrip) {
+  nll::BlockedBloomFilter<int> filter(5000);
+  for (int key = 0; key < 5000; key += 3) {
+    filter.Insert(key);
+  }
+  auto bytes = filter.Serialize();
+  auto copy = nll::BlockedBloomFilter<int>::Deserialize(bytes);
+  ASSERT_EQ(copy.BlockCount(), filter.BlockCount());
+  ASSERT_EQ(copy.MemoryBytes(), filter.MemoryBytes());
+  for (int key = 0; key < 20000; key++) {
+    ASSERT_EQ(copy.MayContain(key), filter.MayContain(key));
+  }
+}
+
+TEST(BlockedBloomFilterTest, DeserializeRejectsBadInput) {
+  using Filter = nll::BlockedBloomFilter<int>;
+  auto bytes = Filter(100).Serialize();
+  ASSERT_THROW(Filter::Deserialize({}), std::invalid_argument);
+
+  auto truncated = bytes;
+  truncated.pop_back();
+  ASSERT_THROW(Filter::Deserialize(truncated), std::invalid_argument);
+
+  auto trailing = bytes;
+  trailing.push_back(0);
+  ASSERT_THROW(Filter::Deserialize(trailing), std::invalid_argument);
+
+  auto bad_magic = bytes;
+  bad_magic[0] ^= 1;
+  ASSERT_THROW(Filter::Deserialize(bad_magic), std::invalid_argument);
+
+  auto huge = bytes;
+  huge[12] = 0x7f;
+  ASSERT_THROW(Filter::Deserialize(huge), std::invalid_argument);
+}
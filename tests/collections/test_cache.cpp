@@ -0,0 +1,203 @@
+#include "nll/collections/cache.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+nll::CacheOptions Options(std::size_t capacity, nll::EvictionPolicy policy) {
+  nll::CacheOptions options;
+  options.capacity = capacity;
+  options.policy = policy;
+  return options;
+}
+
+/// @brief Weighs a string entry by its length
+struct LengthWeigher {
+  std::size_t operator()(int, const std::string& value) const {
+    return value.size();
+  }
+};
+
+}  // namespace
+
+TEST(CacheTest, PutAndGet) {
+  for (auto policy : {nll::EvictionPolicy::kLru, nll::EvictionPolicy::kClock,
+                      nll::EvictionPolicy::kTinyLfu}) {
+    nll::Cache<int, std::string> cache(Options(100, policy));
+    ASSERT_TRUE(cache.Empty());
+    ASSERT_TRUE(cache.Put(1, "one"));
+    ASSERT_TRUE(cache.Put(2, "two"));
+    ASSERT_EQ(cache.Get(1), "one");
+    ASSERT_EQ(cache.Get(3), std::nullopt);
+    ASSERT_TRUE(cache.Put(1, "uno"));
+    ASSERT_EQ(cache.Get(1), "uno");
+    ASSERT_EQ(cache.Size(), 2);
+    ASSERT_EQ(cache.Weight(), 2);
+  }
+}
+
+TEST(CacheTest, ZeroCapacityThrows) {
+  ASSERT_THROW((nll::Cache<int, int>(Options(0, nll::EvictionPolicy::kLru))),
+               std::invalid_argument);
+}
+
+TEST(CacheTest, LruEvictsLeastRecentlyUsed) {
+  nll::Cache<int, int> cache(Options(3, nll::EvictionPolicy::kLru));
+  cache.Put(1, 1);
+  cache.Put(2, 2);
+  cache.Put(3, 3);
+  cache.Get(1);
+  cache.Put(4, 4);
+  ASSERT_EQ(cache.Get(2), std::nullopt);
+  ASSERT_EQ(cache.Get(1), 1);
+  ASSERT_EQ(cache.Get(3), 3);
+  ASSERT_EQ(cache.Get(4), 4);
+  ASSERT_EQ(cache.Size(), 3);
+}
+
+TEST(CacheTest, ClockGivesReferencedEntriesASecondChance) {
+  nll::Cache<int, int> cache(Options(3, nll::EvictionPolicy::kClock));
+  cache.Put(1, 1);
+  cache.Put(2, 2);
+  cache.Put(3, 3);
+  cache.Get(1);
+  cache.Put(4, 4);
+  // 1 was the oldest but referenced, so 2 goes
+  ASSERT_EQ(cache.Get(2), std::nullopt);
+  ASSERT_EQ(cache.Get(1), 1);
+  cache.Put(5, 5);
+  // 1's bit was cleared when it was passed over, but it was read again
+  ASSERT_EQ(cache.Get(3), std::nullopt);
+  ASSERT_EQ(cache.Size(), 3);
+}
+
+TEST(CacheTest, TinyLfuResistsScans) {
+  constexpr int kHotKeys = 50;
+  auto hot_survivors = [](nll::EvictionPolicy policy) {
+    nll::Cache<int, int> cache(Options(100, policy));
+    for (int round = 0; round < 10; round++) {
+      for (int key = 0; key < kHotKeys; key++) {
+        if (!cache.Get(key)) {
+          cache.Put(key, key);
+        }
+      }
+    }
+    for (int key = 1000; key < 11000; key++) {
+      cache.Put(key, key);
+    }
+    int survivors = 0;
+    for (int key = 0; key < kHotKeys; key++) {
+      survivors += cache.Get(key).has_value();
+    }
+    return survivors;
+  };
+  ASSERT_EQ(hot_survivors(nll::EvictionPolicy::kLru), 0);
+  ASSERT_GE(hot_survivors(nll::EvictionPolicy::kTinyLfu), kHotKeys * 9 / 10);
+}
+
+TEST(CacheTest, TinyLfuRejectsBeforeEvicting) {
+  nll::Cache<int, std::string, LengthWeigher> cache(
+      Options(100, nll::EvictionPolicy::kTinyLfu));
+  // A cold entry on probation and a hot one protected fill the main area
+  ASSERT_TRUE(cache.Put(1, std::string(49, 'a')));
+  ASSERT_TRUE(cache.Put(2, std::string(49, 'b')));
+  for (int i = 0; i < 5; i++) {
+    ASSERT_TRUE(cache.Get(2));
+  }
+  // The candidate beats the cold entry but not the hot one, and needs the
+  // room of both, so it is rejected and the cold entry stays
+  ASSERT_TRUE(cache.Put(3, "c"));
+  ASSERT_TRUE(cache.Put(3, std::string(60, 'c')));
+  ASSERT_EQ(cache.Get(3), std::nullopt);
+  ASSERT_TRUE(cache.Get(1));
+  ASSERT_TRUE(cache.Get(2));
+  ASSERT_EQ(cache.Stats().evictions, 1u);
+}
+
+TEST(CacheTest, WeigherBoundsTotalWeight) {
+  nll::Cache<int, std::string, LengthWeigher> cache(
+      Options(10, nll::EvictionPolicy::kLru));
+  ASSERT_TRUE(cache.Put(1, "aaaa"));
+  ASSERT_TRUE(cache.Put(2, "bbbb"));
+  ASSERT_EQ(cache.Weight(), 8);
+  ASSERT_TRUE(cache.Put(3, "cccc"));
+  ASSERT_EQ(cache.Weight(), 8);
+  ASSERT_EQ(cache.Get(1), std::nullopt);
+  // Growing a value evicts others, never itself
+  ASSERT_TRUE(cache.Put(3, "cccccccccc"));
+  ASSERT_EQ(cache.Size(), 1);
+  ASSERT_EQ(cache.Weight(), 10);
+  // Too heavy to ever fit, so the old value goes too
+  ASSERT_FALSE(cache.Put(3, "ccccccccccc"));
+  ASSERT_EQ(cache.Get(3), std::nullopt);
+  ASSERT_EQ(cache.Weight(), 0);
+}
+
+TEST(CacheTest, Stats) {
+  nll::Cache<int, int> cache(Options(2, nll::EvictionPolicy::kLru));
+  cache.Put(1, 1);
+  cache.Put(2, 2);
+  cache.Get(1);
+  cache.Get(3);
+  cache.Put(3, 3);
+  cache.Erase(1);
+  auto stats = cache.Stats();
+  ASSERT_EQ(stats.hits, 1);
+  ASSERT_EQ(stats.misses, 1);
+  ASSERT_EQ(stats.evictions, 1);
+  ASSERT_EQ(stats.evicted_weight, 1);
+  ASSERT_DOUBLE_EQ(stats.HitRate(), 0.5);
+}
+
+TEST(CacheTest, EraseAndClear) {
+  nll::Cache<int, int> cache(Options(10, nll::EvictionPolicy::kTinyLfu));
+  for (int key = 0; key < 10; key++) {
+    cache.Put(key, key);
+  }
+  ASSERT_TRUE(cache.Erase(9));
+  ASSERT_FALSE(cache.Erase(9));
+  ASSERT_EQ(cache.Get(9), std::nullopt);
+  cache.Clear();
+  ASSERT_TRUE(cache.Empty());
+  ASSERT_EQ(cache.Weight(), 0);
+  cache.Put(1, 1);
+  ASSERT_EQ(cache.Get(1), 1);
+}
+
+TEST(ConcurrentCacheTest, ParallelGetAndPut) {
+  for (auto policy : {nll::EvictionPolicy::kLru, nll::EvictionPolicy::kClock,
+                      nll::EvictionPolicy::kTinyLfu}) {
+    auto options = Options(1000, policy);
+    options.shards = 8;
+    nll::ConcurrentCache<int, int> cache(options);
+    ASSERT_EQ(cache.ShardCount(), 8);
+    constexpr int kThreads = 4;
+    constexpr int kOperations = 20000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+      threads.emplace_back([&cache, t] {
+        for (int i = 0; i < kOperations; i++) {
+          auto key = (i * 7 + t) % 3000;
+          if (auto value = cache.Get(key)) {
+            EXPECT_EQ(*value, key);
+          } else {
+            cache.Put(key, key);
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    ASSERT_LE(cache.Weight(), cache.Capacity());
+    ASSERT_EQ(cache.Size(), cache.Weight());
+    auto stats = cache.Stats();
+    ASSERT_EQ(stats.hits + stats.misses, kThreads * kOperations);
+  }
+}
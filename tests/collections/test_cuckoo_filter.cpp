@@ -0,0 +1,156 @@
+#include "nll/collections/cuckoo_filter.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(CuckooFilterTest, NoFalseNegatives) {
+  nll::CuckooFilter<int> filter(10000);
+  for (int key = 0; key < 10000; key++) {
+    ASSERT_TRUE(filter.Insert(key));
+  }
+  ASSERT_EQ(filter.Size(), 10000);
+  for (int key = 0; key < 10000; key++) {
+    ASSERT_TRUE(filter.MayContain(key));
+  }
+}
+
+TEST(CuckooFilterTest, FalsePositiveRateNearTarget) {
+  for (double target : {0.03, 0.001}) {
+    nll::CuckooFilter<int> filter(20000, target);
+    for (int key = 0; key < 20000; key++) {
+      ASSERT_TRUE(filter.Insert(key));
+    }
+    int accepted = 0;
+    for (int key = 1000000; key < 1200000; key++) {
+      accepted += filter.MayContain(key);
+    }
+    ASSERT_LT(accepted / 200000.0, target) << "target " << target;
+  }
+}
+
+TEST(CuckooFilterTest, FingerprintWidth) {
+  ASSERT_EQ(nll::CuckooFilter<int>::FingerprintBitsFor(0.01), 10);
+  ASSERT_EQ((nll::CuckooFilter<int, std::hash<int>, std::uint8_t>::
+                 FingerprintBitsFor(0.05)),
+            8);
+  ASSERT_THROW((nll::CuckooFilter<int, std::hash<int>, std::uint8_t>(10,
+                                                                      0.01)),
+               std::invalid_argument);
+  ASSERT_THROW(nll::CuckooFilter<int>(10, 0), std::invalid_argument);
+}
+
+TEST(CuckooFilterTest, Erase) {
+  nll::CuckooFilter<int> filter(1000);
+  for (int key = 0; key < 1000; key++) {
+    filter.Insert(key);
+  }
+  for (int key = 0; key < 1000; key += 2) {
+    ASSERT_TRUE(filter.Erase(key));
+  }
+  ASSERT_EQ(filter.Size(), 500);
+  for (int key = 1; key < 1000; key += 2) {
+    ASSERT_TRUE(filter.MayContain(key));
+  }
+  int accepted = 0;
+  for (int key = 0; key < 1000; key += 2) {
+    accepted += filter.MayContain(key);
+  }
+  ASSERT_LT(accepted, 10);
+}
+
+TEST(CuckooFilterTest, DuplicatesNeedOneEraseEach) {
+  nll::CuckooFilter<int> filter(100);
+  filter.Insert(42);
+  filter.Insert(42);
+  ASSERT_TRUE(filter.Erase(42));
+  ASSERT_TRUE(filter.MayContain(42));
+  ASSERT_TRUE(filter.Erase(42));
+  ASSERT_FALSE(filter.MayContain(42));
+  ASSERT_TRUE(filter.Empty());
+}
+
+TEST(CuckooFilterTest, FullFilterRejectsAndKeepsKeys) {
+  nll::CuckooFilter<int, std::hash<int>, std::uint8_t> filter(64, 0.05);
+  std::vector<int> inserted;
+  for (int key = 0; key < 10000; key++) {
+    if (!filter.Insert(key)) {
+      break;
+    }
+    inserted.push_back(key);
+  }
+  ASSERT_LT(inserted.size(), 10000);
+  ASSERT_GE(filter.LoadFactor(), 0.9);
+  for (auto key : inserted) {
+    ASSERT_TRUE(filter.MayContain(key));
+  }
+  auto size = filter.Size();
+  ASSERT_FALSE(filter.Insert(-1));
+  ASSERT_EQ(filter.Size(), size);
+
+  // Freeing a slot makes room again
+  ASSERT_TRUE(filter.Erase(inserted.front()));
+  ASSERT_TRUE(filter.Insert(-1));
+  for (std::size_t i = 1; i < inserted.size(); i++) {
+    ASSERT_TRUE(filter.MayContain(inserted[i]));
+  }
+}
+
+TEST(CuckooFilterTest, BatchMatchesSingleCalls) {
+  std::vector<int> keys;
+  for (int key = 0; key < 2000; key++) {
+    keys.push_back(key * 13);
+  }
+  nll::CuckooFilter<int> filter(2000);
+  ASSERT_EQ(filter.InsertBatch(keys.begin(), keys.end()), keys.size());
+  std::vector<int> queries;
+  for (int key = 0; key < 30000; key += 3) {
+    queries.push_back(key);
+  }
+  std::vector<bool> results;
+  filter.MayContainBatch(queries.begin(), queries.end(),
+                         std::back_inserter(results));
+  for (std::size_t i = 0; i < queries.size(); i++) {
+    ASSERT_EQ(results[i], filter.MayContain(queries[i]));
+  }
+}
+
+TEST(CuckooFilterTest, SerializeRoundTrip) {
+  nll::CuckooFilter<int> filter(3000, 0.001);
+  for (int key = 0; key < 3000; key++) {
+    filter.Insert(key);
+  }
+  auto copy = nll::CuckooFilter<int>::Deserialize(filter.Serialize());
+  ASSERT_EQ(copy.Size(), filter.Size());
+  ASSERT_EQ(copy.FingerprintBits(), filter.FingerprintBits());
+  ASSERT_EQ(copy.Capacity(), filter.Capacity());
+  for (int key = 0; key < 20000; key++) {
+    ASSERT_EQ(copy.MayContain(key), filter.MayContain(key));
+  }
+  ASSERT_TRUE(copy.Erase(7));
+}
+
+TEST(CuckooFilterTest, DeserializeRejectsBadInput) {
+  using Filter = nll::CuckooFilter<int>;
+  auto bytes = Filter(100).Serialize();
+  ASSERT_THROW(Filter::Deserialize({}), std::invalid_argument);
+
+  auto truncated = bytes;
+  truncated.pop_back();
+  ASSERT_THROW(Filter::Deserialize(truncated), std::invalid_argument);
+
+  auto bad_magic = bytes;
+  bad_magic[1] ^= 1;
+  ASSERT_THROW(Filter::Deserialize(bad_magic), std::invalid_argument);
+
+  ASSERT_THROW(
+      (nll::CuckooFilter<int, std::hash<int>, std::uint8_t>::Deserialize(
+          bytes)),
+      std::invalid_argument);
+
+  auto bad_buckets = bytes;
+  bad_buckets[7] = 3;  // not a power of two
+  ASSERT_THROW(Filter::Deserialize(bad_buckets), std::invalid_argument);
+}
@@ -0,0 +1,114 @@
+#include "nll/collections/dary_heap.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+template <class THeap>
+std::vector<int> Drain(THeap& heap) {
+  std::vector<int> values;
+  while (!heap.Empty()) {
+    values.push_back(heap.Pop());
+  }
+  return values;
+}
+
+std::vector<int> RandomValues(std::size_t count) {
+  std::mt19937 random(7);
+  std::uniform_int_distribution<int> distribution(-1000, 1000);
+  std::vector<int> values(count);
+  for (auto& value : values) {
+    value = distribution(random);
+  }
+  return values;
+}
+
+}  // namespace
+
+TEST(DaryHeapTest, PopsInOrder) {
+  auto values = RandomValues(1000);
+  nll::DaryHeap<int> heap;
+  for (auto value : values) {
+    heap.Push(value);
+  }
+  ASSERT_EQ(heap.Size(), 1000);
+  ASSERT_EQ(heap.Top(), *std::min_element(values.begin(), values.end()));
+  std::sort(values.begin(), values.end());
+  ASSERT_EQ(Drain(heap), values);
+}
+
+TEST(DaryHeapTest, ArityAndComparator) {
+  auto values = RandomValues(500);
+  nll::DaryHeap<int, 2, std::greater<int>> binary_max;
+  nll::DaryHeap<int, 8> octal;
+  for (auto value : values) {
+    binary_max.Push(value);
+    octal.Push(value);
+  }
+  auto ascending = values;
+  std::sort(ascending.begin(), ascending.end());
+  ASSERT_EQ(Drain(octal), ascending);
+  std::reverse(ascending.begin(), ascending.end());
+  ASSERT_EQ(Drain(binary_max), ascending);
+}
+
+TEST(DaryHeapTest, BulkHeapify) {
+  auto values = RandomValues(1001);
+  nll::DaryHeap<int, 3> heap(values);
+  std::sort(values.begin(), values.end());
+  ASSERT_EQ(Drain(heap), values);
+}
+
+TEST(DaryHeapTest, PushRange) {
+  auto values = RandomValues(300);
+  nll::DaryHeap<int> heap;
+  // Small batches sift up, large ones rebuild
+  heap.PushRange(values.begin(), values.begin() + 200);
+  heap.PushRange(values.begin() + 200, values.begin() + 210);
+  heap.PushRange(values.begin() + 210, values.end());
+  std::sort(values.begin(), values.end());
+  ASSERT_EQ(Drain(heap), values);
+}
+
+TEST(DaryHeapTest, MoveOnlyElements) {
+  struct Less {
+    bool operator()(const std::unique_ptr<int>& a,
+                    const std::unique_ptr<int>& b) const {
+      return *a < *b;
+    }
+  };
+  nll::DaryHeap<std::unique_ptr<int>, 4, Less> heap;
+  heap.Push(std::make_unique<int>(3));
+  heap.Emplace(new int(1));
+  heap.Push(std::make_unique<int>(2));
+  ASSERT_EQ(*heap.Pop(), 1);
+  ASSERT_EQ(*heap.Pop(), 2);
+  ASSERT_EQ(*heap.Pop(), 3);
+}
+
+TEST(DaryHeapTest, EmptyThrows) {
+  nll::DaryHeap<int> heap;
+  ASSERT_THROW(heap.Top(), std::out_of_range);
+  ASSERT_THROW(heap.Pop(), std::out_of_range);
+  heap.Push(1);
+  heap.Clear();
+  ASSERT_TRUE(heap.Empty());
+}
+
+TEST(DaryHeapTest, PmrAllocator) {
+  std::pmr::monotonic_buffer_resource resource;
+  nll::pmr::DaryHeap<int> heap(&resource);
+  for (int i = 100; i > 0; i--) {
+    heap.Push(i);
+  }
+  ASSERT_EQ(heap.get_allocator().resource(), &resource);
+  ASSERT_EQ(heap.Pop(), 1);
+}
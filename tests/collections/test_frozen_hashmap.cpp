@@ -0,0 +1,181 @@
+#include "nll/collections/frozen_hashmap.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+std::vector<std::pair<std::uint64_t, std::uint32_t>> RandomEntries(
+    std::size_t count) {
+  std::mt19937_64 random(7);
+  std::unordered_map<std::uint64_t, std::uint32_t> unique;
+  while (unique.size() < count) {
+    unique.emplace(random(), static_cast<std::uint32_t>(unique.size()));
+  }
+  return {unique.begin(), unique.end()};
+}
+
+}  // namespace
+
+TEST(FrozenHashmapTest, FindsEveryKeyAndNoOther) {
+  auto input = RandomEntries(10000);
+  auto map = nll::FrozenHashmap<std::uint64_t, std::uint32_t>::FromRange(
+      input.begin(), input.end());
+  ASSERT_EQ(map.Size(), input.size());
+  for (const auto& [key, value] : input) {
+    ASSERT_NE(map.Find(key), nullptr);
+    ASSERT_EQ(map.Get(key), value);
+  }
+  // Every slot holds exactly one key, so absent keys always miss
+  std::mt19937_64 random(8);
+  for (int i = 0; i < 1000; i++) {
+    auto key = random();
+    ASSERT_EQ(map.Contains(key),
+              std::find_if(input.begin(), input.end(), [&](const auto& e) {
+                return e.first == key;
+              }) != input.end());
+  }
+  ASSERT_THROW(map.Get(input[0].first + 1), std::out_of_range);
+  // Minimal: one pilot per four keys and no empty slots
+  ASSERT_EQ(map.SizeInBytes(),
+            map.BucketCount() * 4 + input.size() * sizeof(map.begin()[0]));
+  ASSERT_EQ(std::distance(map.begin(), map.end()), input.size());
+}
+
+TEST(FrozenHashmapTest, EmptyAndSingletonMaps) {
+  nll::FrozenHashmap<std::uint32_t, int> empty;
+  ASSERT_TRUE(empty.Empty());
+  ASSERT_FALSE(empty.Contains(0));
+
+  std::vector<std::pair<std::uint32_t, int>> one{{42, 7}};
+  auto map = nll::FrozenHashmap<std::uint32_t, int>::FromRange(one.begin(),
+                                                               one.end());
+  ASSERT_EQ(map.Get(42), 7);
+  ASSERT_FALSE(map.Contains(0));
+}
+
+TEST(FrozenHashmapTest, BuildsFromHashmap) {
+  nll::Hashmap<int, double> source;
+  for (int i = 0; i < 500; i++) {
+    source.Insert(i * 3, i * 0.5);
+  }
+  auto map = nll::FrozenHashmap<int, double>::FromHashmap(source);
+  ASSERT_EQ(map.Size(), 500);
+  for (int i = 0; i < 500; i++) {
+    ASSERT_EQ(map.Get(i * 3), i * 0.5);
+    ASSERT_FALSE(map.Contains(i * 3 + 1));
+  }
+}
+
+TEST(FrozenHashmapTest, RejectsDuplicateKeys) {
+  std::vector<std::pair<int, int>> input{{1, 1}, {2, 2}, {1, 3}};
+  ASSERT_THROW((nll::FrozenHashmap<int, int>::FromRange(input.begin(),
+                                                        input.end())),
+               std::invalid_argument);
+}
+
+TEST(FrozenHashmapTest, SupportsKeysWiderThanAWord) {
+  using Key = std::array<std::uint32_t, 5>;
+  std::vector<std::pair<Key, int>> input;
+  for (std::uint32_t i = 0; i < 2000; i++) {
+    input.push_back({Key{i, i * 7, 0, 1, i % 3}, static_cast<int>(i)});
+  }
+  auto map =
+      nll::FrozenHashmap<Key, int>::FromRange(input.begin(), input.end());
+  for (const auto& [key, value] : input) {
+    ASSERT_EQ(map.Get(key), value);
+  }
+  ASSERT_FALSE(map.Contains(Key{1, 7, 0, 1, 2}));
+}
+
+class FrozenHashmapFileTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    path = (std::filesystem::temp_directory_path() /
+            ("nll_frozen_hashmap_test_" +
+             std::to_string(reinterpret_cast<std::uintptr_t>(this))))
+               .string();
+  }
+
+  void TearDown() override { std::filesystem::remove(path); }
+
+  std::string path;
+};
+
+TEST_F(FrozenHashmapFileTest, MappedFileAnswersLikeTheOriginal) {
+  auto input = RandomEntries(5000);
+  auto built = nll::FrozenHashmap<std::uint64_t, std::uint32_t>::FromRange(
+      input.begin(), input.end());
+  built.WriteFile(path);
+
+  nll::FrozenHashmapFileOptions options;
+  options.verify_checksums = true;
+  auto mapped =
+      nll::FrozenHashmap<std::uint64_t, std::uint32_t>::MapFile(path, options);
+  ASSERT_TRUE(mapped.IsMapped());
+  ASSERT_EQ(mapped.Size(), input.size());
+  for (const auto& [key, value] : input) {
+    ASSERT_EQ(mapped.Get(key), value);
+  }
+  ASSERT_FALSE(mapped.Contains(input[0].first ^ 1));
+
+  // Moving keeps the mapping alive in the new owner
+  auto moved = std::move(mapped);
+  ASSERT_EQ(moved.Get(input[1].first), input[1].second);
+  ASSERT_TRUE(mapped.Empty());
+}
+
+TEST_F(FrozenHashmapFileTest, WritesTheSameBytesForTheSameMap) {
+  // 12 bytes of entry and 4 of padding, which must not carry heap garbage
+  auto input = RandomEntries(1000);
+  auto write = [&](const std::string& file) {
+    nll::FrozenHashmap<std::uint64_t, std::uint32_t>::FromRange(
+        input.begin(), input.end())
+        .WriteFile(file);
+    std::ifstream in(file, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), {});
+  };
+  auto first = write(path);
+  auto second = write(path + ".2");
+  std::filesystem::remove(path + ".2");
+  ASSERT_EQ(first, second);
+}
+
+TEST_F(FrozenHashmapFileTest, EmptyMapRoundTrips) {
+  nll::FrozenHashmap<int, int>().WriteFile(path);
+  auto mapped = nll::FrozenHashmap<int, int>::MapFile(path);
+  ASSERT_TRUE(mapped.Empty());
+  ASSERT_FALSE(mapped.Contains(3));
+}
+
+TEST_F(FrozenHashmapFileTest, RejectsMismatchedOrCorruptFiles) {
+  std::vector<std::pair<int, int>> input{{1, 10}, {2, 20}, {3, 30}};
+  nll::FrozenHashmap<int, int>::FromRange(input.begin(), input.end())
+      .WriteFile(path);
+  ASSERT_THROW((nll::FrozenHashmap<std::uint64_t, int>::MapFile(path)),
+               std::invalid_argument);
+
+  {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(offsetof(nll::FrozenHashmapHeader, size));
+    file.put(100);
+  }
+  ASSERT_THROW((nll::FrozenHashmap<int, int>::MapFile(path)),
+               std::runtime_error);
+  ASSERT_THROW((nll::FrozenHashmap<int, int>::MapFile(path + ".missing")),
+               std::system_error);
+}
@@ -1,12 +1,39 @@
 #include "nll/collections/hashmap.hpp"
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 
+#include "nll/instrumentation/tracking_allocator.hpp"
+#include "nll/memory/monotonic_arena.hpp"
+
+namespace {
+
+/// @brief Lies about avalanching, to make collisions predictable
+struct IdentityHash {
+  static constexpr bool kAvalanching = true;
+
+  std::uint64_t operator()(int key) const {
+    return static_cast<std::uint64_t>(key);
+  }
+};
+
+template <class THash>
+using IntHashmapWith =
+    nll::Hashmap<int, int, nll::DefaultHashmapPolicy,
+                 std::allocator<std::pair<int, int>>, THash>;
+
+}  // namespace
+
 class BaseHashmapTest : public testing::Test {
  protected:
   nll::Hashmap<std::string, std::string> map;
@@ -65,6 +92,20 @@ TEST_F(BaseHashmapTest, NonexistentKeyThrows) {
   ASSERT_THROW(map.Get("any_key"), std::out_of_range);
 }
 
+TEST_F(BaseHashmapTest, ForEachVisitsEveryEntryOnce) {
+  for (int i = 0; i < 32; i++) {
+    map.Insert("key" + std::to_string(i), std::to_string(i));
+  }
+  std::vector<std::string> seen;
+  map.ForEach([&](const std::string& key, const std::string& value) {
+    ASSERT_EQ(key, "key" + value);
+    seen.push_back(value);
+  });
+  ASSERT_EQ(seen.size(), 32);
+  std::sort(seen.begin(), seen.end());
+  ASSERT_EQ(std::unique(seen.begin(), seen.end()), seen.end());
+}
+
 TEST_F(BaseHashmapTest, IndexOperatorSetSucceeds) {
   ASSERT_NO_FATAL_FAILURE(map["Hello"] = "World");
 }
@@ -91,3 +132,214 @@ TEST_F(BaseHashmapTest, IndexOperatorOverwritingValueSucceeds) {
   ASSERT_NO_FATAL_FAILURE(map["Apples"] = "Pears");
   ASSERT_EQ(map["Apples"], "Pears");
 }
+
+TEST_F(BaseHashmapTest, RemoveShrinksSize) {
+  map.Insert("Hello", "World");
+  map.Insert("Apples", "Oranges");
+  map.Remove("Hello");
+  ASSERT_EQ(map.Size(), 1);
+  ASSERT_EQ(map.Get("Apples"), "Oranges");
+  ASSERT_THROW(map.Remove("Hello"), std::out_of_range);
+}
+
+TEST(HashmapPolicyTest, DisabledStatsTakeNoSpace) {
+  ASSERT_EQ(sizeof(nll::Hashmap<int, int>),
+            sizeof(nll::Hashmap<int, int, nll::CompactHashmapPolicy>));
+  ASSERT_LT(sizeof(nll::Hashmap<int, int>),
+            sizeof(nll::Hashmap<int, int, nll::WithStats<>>));
+}
+
+TEST(HashmapPolicyTest, PolicySetsDefaultFactors) {
+  nll::Hashmap<int, int, nll::CompactHashmapPolicy> compact;
+  ASSERT_DOUBLE_EQ(compact.MaxLoadFactor(), 2.0);
+  ASSERT_DOUBLE_EQ(compact.GrowthFactor(), 1.5);
+  nll::Hashmap<int, int, nll::FastHashmapPolicy> fast;
+  for (int i = 0; i < 1000; i++) {
+    compact.Insert(i, i);
+    fast.Insert(i, i);
+  }
+  ASSERT_LT(fast.LoadFactor(), 0.5);
+  ASSERT_LT(compact.LoadFactor(), 2.0);
+  ASSERT_LT(compact.BucketCount(), fast.BucketCount());
+}
+
+TEST(HashmapPolicyTest, LoweringLoadFactorGrowsRightAway) {
+  nll::Hashmap<int, int> map;
+  for (int i = 0; i < 100; i++) {
+    map.Insert(i, i);
+  }
+  map.SetMaxLoadFactor(0.25);
+  ASSERT_LT(map.LoadFactor(), 0.25);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(map.Get(i), i);
+  }
+  ASSERT_THROW(map.SetMaxLoadFactor(0), std::invalid_argument);
+  ASSERT_THROW(map.SetGrowthFactor(1), std::invalid_argument);
+}
+
+TEST(HashmapPolicyTest, GrowthFactorSetsResizeSteps) {
+  nll::Hashmap<int, int> map(10);
+  map.SetGrowthFactor(3);
+  for (int i = 0; i < 8; i++) {
+    map.Insert(i, i);
+  }
+  ASSERT_EQ(map.BucketCount(), 30);
+}
+
+TEST(HashmapPolicyTest, ChainLengthsCoverEveryBucket) {
+  IntHashmapWith<IdentityHash> map(8);
+  for (int i = 0; i < 5; i++) {
+    map.Insert(i * 8, i);
+  }
+  // Buckets come from the high bits of the hash, so small keys under an
+  // identity hash that claims to avalanche all share the first bucket
+  auto histogram = map.ChainLengths();
+  std::size_t buckets = 0;
+  std::size_t entries = 0;
+  for (std::size_t k = 0; k < histogram.size(); k++) {
+    buckets += histogram[k];
+    entries += k * histogram[k];
+  }
+  ASSERT_EQ(buckets, map.BucketCount());
+  ASSERT_EQ(entries, map.Size());
+  ASSERT_EQ(histogram.size(), 6);
+  ASSERT_EQ(histogram[5], 1);
+}
+
+TEST(HashmapPolicyTest, StatsCountLookupsAndResizes) {
+  nll::Hashmap<int, int, nll::WithStats<>> map(4);
+  for (int i = 0; i < 100; i++) {
+    map.Insert(i, i);
+  }
+  const auto& stats = map.Stats();
+  ASSERT_GT(stats.resizes, 0);
+  ASSERT_GT(stats.resize_time.count(), 0);
+  ASSERT_EQ(stats.hits, 0);
+
+  map.ResetStats();
+  for (int i = 0; i < 150; i++) {
+    map.Contains(i);
+  }
+  ASSERT_EQ(map.Get(42), 42);
+  ASSERT_THROW(map.Get(1000), std::out_of_range);
+  ASSERT_EQ(stats.hits, 101);
+  ASSERT_EQ(stats.misses, 51);
+  ASSERT_EQ(stats.resizes, 0);
+  std::uint64_t lookups = 0;
+  for (auto count : stats.probe_lengths) {
+    lookups += count;
+  }
+  ASSERT_EQ(lookups, 152);
+  ASSERT_GT(stats.MeanProbeLength(), 0);
+}
+
+TEST(HashmapHashTest, StdHashIsMixedBeforeFastRange) {
+  // std::hash<int> is the identity; unmixed, fastrange would put every
+  // small key in bucket 0
+  IntHashmapWith<std::hash<int>> map;
+  for (int i = 0; i < 4096; i++) {
+    map.Insert(i, i);
+  }
+  ASSERT_LT(map.ChainLengths().size(), 10);
+  ASSERT_EQ(map.Get(1234), 1234);
+}
+
+TEST(HashmapHashTest, StridedKeysSpreadOverBuckets) {
+  // Multiples of a power of two used to share the bucket of a modulo by
+  // a power of two
+  nll::Hashmap<std::uint64_t, int> map;
+  for (int i = 0; i < 4096; i++) {
+    map.Insert(static_cast<std::uint64_t>(i) << 20, i);
+  }
+  ASSERT_LT(map.ChainLengths().size(), 10);
+}
+
+TEST(HashmapHashTest, FindBatchMatchesFind) {
+  nll::Hashmap<int, int> map;
+  for (int i = 0; i < 1000; i += 2) {
+    map.Insert(i, -i);
+  }
+  std::vector<int> keys;
+  for (int i = 0; i < 101; i++) {
+    keys.push_back(i * 7);
+  }
+  std::vector<int*> values(keys.size());
+  map.FindBatch(keys.data(), keys.size(), values.data());
+  for (std::size_t i = 0; i < keys.size(); i++) {
+    ASSERT_EQ(values[i], map.Find(keys[i]));
+  }
+}
+
+TEST(HashmapHashTest, FindBatchHashesStringsOneByOne) {
+  nll::Hashmap<std::string, int> map;
+  map.Insert("apple", 1);
+  map.Insert("pear", 2);
+  std::string keys[] = {"pear", "plum", "apple"};
+  int* values[3];
+  map.FindBatch(keys, 3, values);
+  ASSERT_EQ(*values[0], 2);
+  ASSERT_EQ(values[1], nullptr);
+  ASSERT_EQ(*values[2], 1);
+}
+
+TEST(HashmapHashTest, ContainsTakesAStringView) {
+  nll::Hashmap<std::string, int> map;
+  map.Insert("a key long enough to need an allocation of its own", 1);
+  std::string_view probe = "a key long enough to need an allocation of its own";
+  ASSERT_TRUE(map.Contains(probe));
+  ASSERT_FALSE(map.Contains(probe.substr(1)));
+  ASSERT_TRUE(map.Contains(std::string(probe)));
+}
+
+TEST(HashmapAllocatorTest, NodesComeFromAStatefulAllocator) {
+  // TrackingAllocator has no default constructor, so no bucket can fall
+  // back to a default constructed one
+  using Allocator =
+      nll::instrumentation::TrackingAllocator<std::pair<int, int>>;
+  nll::instrumentation::MemoryStats stats;
+  {
+    nll::Hashmap<int, int, nll::DefaultHashmapPolicy, Allocator> map(
+        1024, Allocator(&stats));
+    ASSERT_EQ(stats.allocations, 1u);
+    for (int i = 0; i < 100; i++) {
+      map.Insert(i, i);
+    }
+    // The table and one node per entry
+    ASSERT_EQ(stats.allocations, 101u);
+    for (int i = 100; i < 10000; i++) {
+      map.Insert(i, i);
+    }
+    ASSERT_EQ(map.Get(9999), 9999);
+    ASSERT_EQ(map.get_allocator().Stats(), &stats);
+  }
+  ASSERT_GT(stats.allocations, 10000u);
+  ASSERT_EQ(stats.deallocations, stats.allocations);
+  ASSERT_EQ(stats.live_bytes, 0u);
+}
+
+TEST(PmrHashmapTest, TableAndEntriesComeFromTheResource) {
+  nll::memory::MonotonicArena arena;
+  nll::pmr::Hashmap<std::pmr::string, int> map(&arena);
+  for (int i = 0; i < 100; i++) {
+    map.Insert(std::pmr::string("a key long enough to allocate " +
+                                std::to_string(i)),
+               i);
+  }
+  ASSERT_EQ(map.Get("a key long enough to allocate 42"), 42);
+  ASSERT_EQ(map.get_allocator().resource(), &arena);
+  map["a key long enough to allocate 100"] = 100;
+  ASSERT_EQ(map.Size(), 101);
+  // 101 nodes plus out of line key strings at the very least
+  ASSERT_GT(arena.BytesUsed(), 101 * 64);
+}
+
+TEST(PmrHashmapTest, IndexOperatorSurvivesUnevenGrowth) {
+  nll::memory::MonotonicArena arena;
+  nll::pmr::Hashmap<int, int, nll::CompactHashmapPolicy> map(&arena);
+  for (int i = 0; i < 1000; i++) {
+    map[i] = i;
+  }
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(map.Get(i), i);
+  }
+}
@@ -0,0 +1,86 @@
+#include "nll/collections/indexed_heap.hpp"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+class BaseIndexedHeapTest : public testing::Test {
+ protected:
+  nll::IndexedDaryHeap<int> heap{8};
+};
+
+TEST_F(BaseIndexedHeapTest, EmptyHeapIsEmpty) {
+  ASSERT_TRUE(heap.Empty());
+  ASSERT_EQ(heap.Capacity(), 8);
+}
+
+TEST_F(BaseIndexedHeapTest, PopFromEmptyHeapThrows) {
+  ASSERT_THROW(heap.Pop(), std::out_of_range);
+  ASSERT_THROW(heap.Top(), std::out_of_range);
+}
+
+TEST_F(BaseIndexedHeapTest, PopsInPriorityOrder) {
+  heap.Push(3, 30);
+  heap.Push(1, 10);
+  heap.Push(5, 50);
+  heap.Push(0, 20);
+  ASSERT_EQ(heap.Pop(), std::make_pair(1u, 10));
+  ASSERT_EQ(heap.Pop(), std::make_pair(0u, 20));
+  ASSERT_EQ(heap.Pop(), std::make_pair(3u, 30));
+  ASSERT_EQ(heap.Pop(), std::make_pair(5u, 50));
+  ASSERT_TRUE(heap.Empty());
+}
+
+TEST_F(BaseIndexedHeapTest, DecreaseKeyMovesToTop) {
+  heap.Push(2, 20);
+  heap.Push(4, 40);
+  heap.DecreaseKey(4, 5);
+  ASSERT_EQ(heap.Top(), 4u);
+  ASSERT_EQ(heap.Priority(4), 5);
+  ASSERT_THROW(heap.DecreaseKey(4, 100), std::invalid_argument);
+}
+
+TEST_F(BaseIndexedHeapTest, PushOrDecreaseOnlyLowers) {
+  ASSERT_TRUE(heap.PushOrDecrease(1, 10));
+  ASSERT_FALSE(heap.PushOrDecrease(1, 15));
+  ASSERT_TRUE(heap.PushOrDecrease(1, 5));
+  ASSERT_EQ(heap.TopPriority(), 5);
+}
+
+TEST_F(BaseIndexedHeapTest, DuplicateOrOutOfRangePushThrows) {
+  heap.Push(1, 10);
+  ASSERT_THROW(heap.Push(1, 5), std::invalid_argument);
+  ASSERT_THROW(heap.Push(8, 5), std::out_of_range);
+}
+
+TEST_F(BaseIndexedHeapTest, ClearAllowsReuse) {
+  heap.Push(1, 10);
+  heap.Push(2, 20);
+  heap.Clear();
+  ASSERT_TRUE(heap.Empty());
+  ASSERT_FALSE(heap.Contains(1));
+  ASSERT_NO_THROW(heap.Push(1, 3));
+}
+
+TEST(IndexedHeapTest, RandomOperationsPopSorted) {
+  constexpr unsigned kSize = 1000;
+  nll::IndexedDaryHeap<int, unsigned, 3> heap(kSize);
+  std::vector<int> priorities(kSize);
+  std::mt19937 rng(5);
+  for (unsigned i = 0; i < kSize; i++) {
+    priorities[i] = static_cast<int>(rng() % 100000);
+    heap.Push(i, priorities[i]);
+  }
+  for (unsigned i = 0; i < kSize; i += 3) {
+    priorities[i] -= 50000;
+    heap.DecreaseKey(i, priorities[i]);
+  }
+  std::sort(priorities.begin(), priorities.end());
+  for (auto expected : priorities) {
+    ASSERT_EQ(heap.Pop().second, expected);
+  }
+}
@@ -1,12 +1,16 @@
 #include "nll/collections/linked_list.hpp"
 
 #include <algorithm>
+#include <cstddef>
+#include <memory_resource>
 #include <stdexcept>
 #include <string>
 #include <utility>
 
 #include <gtest/gtest.h>
 
+#include "nll/memory/monotonic_arena.hpp"
+
 class BaseSinglyLinkedListTest : public testing::Test {
  protected:
   nll::SinglyLinkedList<int> list;
@@ -228,4 +232,56 @@ TEST_F(BaseSinglyLinkedListTest, ReverseSucceeds) {
   for (int i = 0; i < 5; i++) {
     ASSERT_EQ(list[i], 5 - 1 - i);
   }
-}
\ No newline at end of file
+}
+
+TEST(MiscSinglyLinkedListTest, CopiesAndMovesOwnTheirNodes) {
+  nll::SinglyLinkedList<std::string> list;
+  list.PushBack("Hello");
+  list.PushBack("World");
+  auto copy = list;
+  copy.PopFront();
+  ASSERT_EQ(list.Size(), 2);
+  ASSERT_EQ(copy.PeekFront(), "World");
+  auto moved = std::move(list);
+  ASSERT_EQ(moved.Size(), 2);
+  ASSERT_TRUE(list.Empty());
+  copy = moved;
+  ASSERT_EQ(copy.Size(), 2);
+  ASSERT_EQ(copy.PeekBack(), "World");
+}
+
+TEST(PmrSinglyLinkedListTest, NodesAndValuesComeFromTheResource) {
+  nll::memory::MonotonicArena arena;
+  nll::pmr::SinglyLinkedList<std::pmr::string> list(&arena);
+  list.PushBack("a string long enough to need its own allocation");
+  auto used = arena.BytesUsed();
+  ASSERT_GT(used, 48);
+  ASSERT_EQ(list.PeekFront().get_allocator().resource(), &arena);
+  list.PushFront("short");
+  ASSERT_GT(arena.BytesUsed(), used);
+  ASSERT_EQ(list.PopFront(), "short");
+}
+
+TEST(PmrSinglyLinkedListTest, MoveAcrossResourcesCopiesElements) {
+  nll::memory::MonotonicArena first;
+  nll::memory::MonotonicArena second;
+  nll::pmr::SinglyLinkedList<int> source(&first);
+  for (int i = 0; i < 10; i++) {
+    source.PushBack(i);
+  }
+  nll::pmr::SinglyLinkedList<int> target(&second);
+  target = std::move(source);
+  ASSERT_EQ(target.get_allocator().resource(), &second);
+  ASSERT_EQ(target.Size(), 10);
+  ASSERT_EQ(target.PeekBack(), 9);
+  ASSERT_GT(second.BytesUsed(), 0);
+}
+
+TEST(PmrSinglyLinkedListTest, StdAllocatorAddsNoSize) {
+  struct ThreeWords {
+    void* head;
+    void* tail;
+    std::size_t size;
+  };
+  ASSERT_EQ(sizeof(nll::SinglyLinkedList<int>), sizeof(ThreeWords));
+}
@@ -0,0 +1,111 @@
+#include "nll/collections/pairing_heap.hpp"
+
+#include <algorithm>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+template <class THeap>
+auto Drain(THeap& heap) {
+  std::vector<std::decay_t<decltype(heap.Top())>> values;
+  while (!heap.Empty()) {
+    values.push_back(heap.Pop());
+  }
+  return values;
+}
+
+}  // namespace
+
+TEST(PairingHeapTest, PopsInOrder) {
+  std::mt19937 random(3);
+  std::vector<int> values(2000);
+  for (auto& value : values) {
+    value = static_cast<int>(random() % 5000);
+  }
+  nll::PairingHeap<int> heap;
+  for (auto value : values) {
+    heap.Push(value);
+  }
+  ASSERT_EQ(heap.Size(), values.size());
+  std::sort(values.begin(), values.end());
+  ASSERT_EQ(heap.Top(), values.front());
+  ASSERT_EQ(Drain(heap), values);
+}
+
+TEST(PairingHeapTest, DecreaseKey) {
+  nll::PairingHeap<int> heap;
+  std::vector<nll::PairingHeap<int>::Handle> handles;
+  for (int i = 0; i < 100; i++) {
+    handles.push_back(heap.Push(1000 + i));
+  }
+  // Pop once so the root has structured children to cut from
+  ASSERT_EQ(heap.Pop(), 1000);
+  heap.DecreaseKey(handles[50], 5);
+  heap.DecreaseKey(handles[99], 3);
+  heap.DecreaseKey(handles[10], 1010);
+  ASSERT_EQ(*handles[99], 3);
+  ASSERT_THROW(heap.DecreaseKey(handles[20], 2000), std::invalid_argument);
+  ASSERT_EQ(heap.Pop(), 3);
+  ASSERT_EQ(heap.Pop(), 5);
+  auto rest = Drain(heap);
+  ASSERT_EQ(rest.size(), 97);
+  ASSERT_TRUE(std::is_sorted(rest.begin(), rest.end()));
+}
+
+TEST(PairingHeapTest, Meld) {
+  nll::PairingHeap<int> odd;
+  nll::PairingHeap<int> even;
+  for (int i = 0; i < 50; i++) {
+    odd.Push(2 * i + 1);
+    even.Push(2 * i);
+  }
+  auto handle = even.Push(200);
+  odd.Meld(even);
+  ASSERT_TRUE(even.Empty());
+  ASSERT_EQ(odd.Size(), 101);
+  // Handles follow their elements into the melded heap
+  odd.DecreaseKey(handle, -1);
+  ASSERT_EQ(odd.Pop(), -1);
+  auto values = Drain(odd);
+  ASSERT_EQ(values.size(), 100);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(values[i], i);
+  }
+}
+
+TEST(PairingHeapTest, MoveAndClear) {
+  nll::PairingHeap<std::string> heap;
+  heap.Push("pear");
+  heap.Emplace(3, 'a');
+  heap.Push("apple");
+  nll::PairingHeap<std::string> moved(std::move(heap));
+  ASSERT_TRUE(heap.Empty());
+  ASSERT_EQ(moved.Top(), "aaa");
+  heap = std::move(moved);
+  ASSERT_EQ(heap.Size(), 3);
+  heap.Clear();
+  ASSERT_TRUE(heap.Empty());
+  ASSERT_THROW(heap.Top(), std::out_of_range);
+  ASSERT_THROW(heap.Pop(), std::out_of_range);
+}
+
+TEST(PairingHeapTest, PmrAllocator) {
+  std::pmr::monotonic_buffer_resource first;
+  std::pmr::monotonic_buffer_resource second;
+  nll::pmr::PairingHeap<int> a(&first);
+  nll::pmr::PairingHeap<int> b(&second);
+  a.Push(1);
+  b.Push(2);
+  ASSERT_THROW(a.Meld(b), std::invalid_argument);
+  nll::pmr::PairingHeap<int> c(&first);
+  c.Push(0);
+  a.Meld(c);
+  ASSERT_EQ(a.Pop(), 0);
+  ASSERT_EQ(a.Pop(), 1);
+}
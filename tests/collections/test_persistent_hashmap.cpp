@@ -0,0 +1,244 @@
+#include "nll/collections/persistent_hashmap.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+/// @brief Key whose hashes all collide, to reach the collision nodes below
+/// the last hash bits
+struct CollidingKey {
+  int id;
+
+  friend bool operator==(const CollidingKey& a, const CollidingKey& b) {
+    return a.id == b.id;
+  }
+};
+
+}  // namespace
+
+template <>
+struct std::hash<CollidingKey> {
+  std::size_t operator()(const CollidingKey&) const { return 42; }
+};
+
+TEST(PersistentHashmapTest, OldVersionsStayUnchanged) {
+  nll::PersistentHashmap<int, std::string> empty;
+  auto one = empty.Insert(1, "one");
+  auto two = one.Insert(2, "two");
+  auto changed = two.Insert(1, "uno");
+  auto erased = changed.Erase(2);
+
+  ASSERT_TRUE(empty.Empty());
+  ASSERT_EQ(one.Size(), 1);
+  ASSERT_EQ(one.Get(1), "one");
+  ASSERT_FALSE(one.Contains(2));
+  ASSERT_EQ(two.Size(), 2);
+  ASSERT_EQ(two.Get(1), "one");
+  ASSERT_EQ(changed.Get(1), "uno");
+  ASSERT_EQ(changed.Size(), 2);
+  ASSERT_EQ(erased.Size(), 1);
+  ASSERT_FALSE(erased.Contains(2));
+  ASSERT_EQ(two.Get(2), "two");
+  ASSERT_THROW(erased.Get(2), std::out_of_range);
+}
+
+TEST(PersistentHashmapTest, MatchesUnorderedMapUnderRandomUpdates) {
+  std::mt19937 random(3);
+  std::uniform_int_distribution<int> keys(0, 3000);
+  nll::PersistentHashmap<int, int> map;
+  std::unordered_map<int, int> expected;
+  std::vector<std::pair<nll::PersistentHashmap<int, int>,
+                        std::unordered_map<int, int>>>
+      versions;
+  for (int step = 0; step < 20000; step++) {
+    auto key = keys(random);
+    if (random() % 3 == 0) {
+      map = map.Erase(key);
+      expected.erase(key);
+    } else {
+      map = map.Insert(key, step);
+      expected[key] = step;
+    }
+    if (step % 2000 == 0) {
+      versions.emplace_back(map, expected);
+    }
+  }
+  versions.emplace_back(map, expected);
+  for (const auto& [version, contents] : versions) {
+    ASSERT_EQ(version.Size(), contents.size());
+    for (int key = 0; key <= 3000; key++) {
+      auto* value = version.Find(key);
+      auto it = contents.find(key);
+      ASSERT_EQ(value != nullptr, it != contents.end());
+      if (value != nullptr) {
+        ASSERT_EQ(*value, it->second);
+      }
+    }
+  }
+}
+
+TEST(PersistentHashmapTest, TransientMovesStringEntriesBetweenNodes) {
+  // Strings too long for the small buffer, so an entry copied or moved
+  // into the wrong node, or left behind, shows up under the sanitizers
+  auto text = [](int i) { return std::string(40, 'k') + std::to_string(i); };
+  std::mt19937 random(5);
+  std::uniform_int_distribution<int> keys(0, 500);
+  auto transient = nll::PersistentHashmap<std::string, std::string>()
+                       .AsTransient();
+  std::unordered_map<std::string, std::string> expected;
+  auto snapshot = transient.Persistent();
+  auto snapshot_contents = expected;
+  for (int step = 0; step < 5000; step++) {
+    auto key = text(keys(random));
+    if (random() % 3 == 0) {
+      ASSERT_EQ(transient.Erase(key), expected.erase(key) == 1);
+    } else {
+      transient.Insert(key, text(step));
+      expected[key] = text(step);
+    }
+    if (step == 2500) {
+      snapshot = transient.Persistent();
+      snapshot_contents = expected;
+    }
+  }
+  ASSERT_EQ(transient.Size(), expected.size());
+  for (const auto& [key, value] : expected) {
+    ASSERT_EQ(*transient.Find(key), value);
+  }
+  ASSERT_EQ(snapshot.Size(), snapshot_contents.size());
+  for (const auto& [key, value] : snapshot_contents) {
+    ASSERT_EQ(snapshot.Get(key), value);
+  }
+}
+
+TEST(PersistentHashmapTest, ErasingEverythingEmptiesTheTrie) {
+  nll::PersistentHashmap<int, int> map;
+  for (int i = 0; i < 1000; i++) {
+    map = map.Insert(i, i);
+  }
+  auto full = map;
+  for (int i = 0; i < 1000; i++) {
+    map = map.Erase(i);
+    ASSERT_FALSE(map.Contains(i));
+    ASSERT_EQ(map.Size(), 999 - i);
+  }
+  ASSERT_TRUE(map.Empty());
+  ASSERT_EQ(full.Size(), 1000);
+  ASSERT_EQ(full.Get(500), 500);
+}
+
+TEST(PersistentHashmapTest, HandlesFullHashCollisions) {
+  nll::PersistentHashmap<CollidingKey, int> map;
+  for (int i = 0; i < 10; i++) {
+    map = map.Insert(CollidingKey{i}, i);
+  }
+  auto before = map;
+  map = map.Insert(CollidingKey{3}, 33).Erase(CollidingKey{5});
+  ASSERT_EQ(map.Size(), 9);
+  ASSERT_EQ(map.Get(CollidingKey{3}), 33);
+  ASSERT_FALSE(map.Contains(CollidingKey{5}));
+  ASSERT_EQ(before.Get(CollidingKey{3}), 3);
+  ASSERT_EQ(before.Get(CollidingKey{5}), 5);
+  for (int i = 0; i < 10; i++) {
+    map = map.Erase(CollidingKey{i});
+  }
+  ASSERT_TRUE(map.Empty());
+}
+
+TEST(PersistentHashmapTest, TransientBatchLeavesSourceAndPersistedVersions) {
+  nll::PersistentHashmap<int, int> base;
+  for (int i = 0; i < 100; i++) {
+    base = base.Insert(i, i);
+  }
+  auto transient = base.AsTransient();
+  for (int i = 100; i < 5000; i++) {
+    transient.Insert(i, i * 2);
+  }
+  auto middle = transient.Persistent();
+  for (int i = 0; i < 5000; i += 2) {
+    ASSERT_TRUE(transient.Erase(i));
+  }
+  ASSERT_FALSE(transient.Erase(0));
+  transient.Insert(1, -1);
+  auto last = transient.Persistent();
+
+  ASSERT_EQ(base.Size(), 100);
+  ASSERT_EQ(base.Get(1), 1);
+  ASSERT_FALSE(base.Contains(100));
+  ASSERT_EQ(middle.Size(), 5000);
+  ASSERT_EQ(middle.Get(1), 1);
+  ASSERT_EQ(middle.Get(4000), 8000);
+  ASSERT_EQ(last.Size(), 2500);
+  ASSERT_EQ(last.Get(1), -1);
+  ASSERT_FALSE(last.Contains(4000));
+  ASSERT_EQ(last.Get(4001), 8002);
+}
+
+TEST(PersistentHashmapTest, ForEachVisitsEveryEntry) {
+  auto transient = nll::PersistentHashmap<int, int>().AsTransient();
+  for (int i = 0; i < 300; i++) {
+    transient.Insert(i, -i);
+  }
+  std::vector<int> keys;
+  transient.Persistent().ForEach([&](int key, int value) {
+    ASSERT_EQ(value, -key);
+    keys.push_back(key);
+  });
+  std::sort(keys.begin(), keys.end());
+  ASSERT_EQ(keys.size(), 300);
+  ASSERT_EQ(std::unique(keys.begin(), keys.end()), keys.end());
+}
+
+TEST(VersionedHashmapTest, ReadersSeeWholeBatches) {
+  nll::VersionedHashmap<int, int> map;
+  constexpr int kBatches = 200;
+  constexpr int kBatchSize = 50;
+  std::atomic<bool> done{false};
+  std::atomic<int> failures{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 3; t++) {
+    readers.emplace_back([&] {
+      while (!done.load()) {
+        // Every batch publishes keys 0..n-1, all with value n
+        auto snapshot = map.Snapshot();
+        auto size = static_cast<int>(snapshot.Size());
+        if (size % kBatchSize != 0) {
+          failures++;
+        }
+        for (int key = 0; key < size; key += 7) {
+          auto* value = snapshot.Find(key);
+          if (value == nullptr || *value != size) {
+            failures++;
+          }
+        }
+      }
+    });
+  }
+  for (int batch = 1; batch <= kBatches; batch++) {
+    map.Update([&](auto& transient) {
+      auto size = batch * kBatchSize;
+      for (int key = 0; key < size; key++) {
+        transient.Insert(key, size);
+      }
+    });
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  ASSERT_EQ(failures.load(), 0);
+  ASSERT_EQ(map.Snapshot().Size(), kBatches * kBatchSize);
+  map.Publish({});
+  ASSERT_TRUE(map.Snapshot().Empty());
+}
@@ -0,0 +1,69 @@
+#include "nll/collections/radix_heap.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(RadixHeapTest, PopsInOrder) {
+  std::mt19937 random(11);
+  std::vector<std::uint32_t> keys(3000);
+  for (auto& key : keys) {
+    key = random();
+  }
+  nll::RadixHeap<std::uint32_t, int> heap;
+  for (std::size_t i = 0; i < keys.size(); i++) {
+    heap.Push(keys[i], static_cast<int>(i));
+  }
+  ASSERT_EQ(heap.Size(), keys.size());
+  std::vector<std::uint32_t> popped;
+  while (!heap.Empty()) {
+    auto [key, index] = heap.Pop();
+    ASSERT_EQ(keys[index], key);
+    popped.push_back(key);
+  }
+  std::sort(keys.begin(), keys.end());
+  ASSERT_EQ(popped, keys);
+}
+
+TEST(RadixHeapTest, MonotoneInterleaving) {
+  // Dijkstra-like: each pop pushes keys at or above the popped one
+  std::mt19937 random(5);
+  nll::RadixHeap<std::uint64_t, std::string> heap;
+  heap.Push(0, "source");
+  std::uint64_t previous = 0;
+  int pops = 0;
+  while (!heap.Empty() && pops < 10000) {
+    // TopKey moves LastKey up to the smallest key
+    auto top = heap.TopKey();
+    ASSERT_EQ(top, heap.LastKey());
+    auto [key, value] = heap.Pop();
+    ASSERT_GE(key, previous);
+    previous = key;
+    pops++;
+    for (int i = 0; i < 2; i++) {
+      heap.Push(key + random() % 1000, value);
+    }
+  }
+  ASSERT_EQ(pops, 10000);
+}
+
+TEST(RadixHeapTest, RejectsKeysBelowLastPopped) {
+  nll::RadixHeap<std::uint8_t, int> heap;
+  heap.Push(10, 0);
+  heap.Push(255, 1);
+  ASSERT_EQ(heap.Pop().first, 10);
+  ASSERT_THROW(heap.Push(9, 2), std::invalid_argument);
+  heap.Push(10, 3);
+  ASSERT_EQ(heap.Pop().second, 3);
+  ASSERT_EQ(heap.Pop().first, 255);
+  ASSERT_THROW(heap.Pop(), std::out_of_range);
+  ASSERT_THROW(heap.TopKey(), std::out_of_range);
+  heap.Clear();
+  heap.Push(0, 4);
+  ASSERT_EQ(heap.Pop().second, 4);
+}
@@ -1,5 +1,6 @@
 #include "nll/collections/ring_buffer.hpp"
 
+#include <memory>
 #include <stdexcept>
 
 #include <gtest/gtest.h>
@@ -73,4 +74,23 @@ TEST(RingBufferTest, CanClear) {
   queue.Clear();
 
   EXPECT_EQ(queue.Size(), 0);
-}
\ No newline at end of file
+}
+
+TEST(RingBufferTest, FullBeforeOverwriting) {
+  nll::RingBuffer<int, 4> queue;
+  ASSERT_EQ(queue.Capacity(), 3);
+  for (int i = 0; i < 3; i++) {
+    ASSERT_FALSE(queue.Full());
+    queue.Push(i);
+  }
+  ASSERT_TRUE(queue.Full());
+  queue.Push(3);
+  ASSERT_EQ(queue.Size(), 3);
+  ASSERT_EQ(queue.Peek(), 1);
+}
+
+TEST(RingBufferTest, HoldsMoveOnlyElements) {
+  nll::RingBuffer<std::unique_ptr<int>, 4> queue;
+  queue.Push(std::make_unique<int>(7));
+  ASSERT_EQ(*queue.Pop(), 7);
+}
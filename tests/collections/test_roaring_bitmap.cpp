@@ -0,0 +1,294 @@
+#include "nll/collections/roaring_bitmap.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+std::vector<std::uint32_t> ToVector(const nll::RoaringBitmap& bitmap) {
+  return std::vector<std::uint32_t>(bitmap.begin(), bitmap.end());
+}
+
+/// @brief Random values mixing every container form: a sparse group, a
+/// dense group and a group of long runs
+std::set<std::uint32_t> MixedValues(unsigned seed) {
+  std::mt19937 random(seed);
+  std::set<std::uint32_t> values;
+  for (int i = 0; i < 500; i++) {
+    values.insert(random() % 65536);
+  }
+  for (int i = 0; i < 20000; i++) {
+    values.insert((1u << 16) + random() % 65536);
+  }
+  for (std::uint32_t start = 0; start < 65536; start += 1000) {
+    auto first = (5u << 16) + start + random() % 100;
+    for (std::uint32_t value = first; value < first + 400; value++) {
+      values.insert(value);
+    }
+  }
+  values.insert(UINT32_MAX);
+  return values;
+}
+
+nll::RoaringBitmap BitmapOf(const std::set<std::uint32_t>& values) {
+  return nll::RoaringBitmap(values.begin(), values.end());
+}
+
+}  // namespace
+
+TEST(RoaringBitmapTest, AddRemoveContains) {
+  nll::RoaringBitmap bitmap;
+  ASSERT_TRUE(bitmap.Empty());
+  ASSERT_TRUE(bitmap.Add(7));
+  ASSERT_FALSE(bitmap.Add(7));
+  ASSERT_TRUE(bitmap.Add(1u << 20));
+  ASSERT_TRUE(bitmap.Add(UINT32_MAX));
+  ASSERT_TRUE(bitmap.Contains(7));
+  ASSERT_TRUE(bitmap.Contains(UINT32_MAX));
+  ASSERT_FALSE(bitmap.Contains(8));
+  ASSERT_EQ(bitmap.Cardinality(), 3);
+  ASSERT_EQ(bitmap.ContainerCount(), 3);
+  ASSERT_TRUE(bitmap.Remove(1u << 20));
+  ASSERT_FALSE(bitmap.Remove(1u << 20));
+  ASSERT_EQ(bitmap.ContainerCount(), 2);
+  ASSERT_EQ(ToVector(bitmap), (std::vector<std::uint32_t>{7, UINT32_MAX}));
+}
+
+TEST(RoaringBitmapTest, ArrayBecomesBitmapAndBack) {
+  nll::RoaringBitmap bitmap;
+  for (std::uint32_t value = 0; value < 10000; value += 2) {
+    bitmap.Add(value);
+  }
+  ASSERT_EQ(bitmap.Cardinality(), 5000);
+  auto dense_bytes = bitmap.MemoryBytes();
+  ASSERT_LT(dense_bytes, 5000 * 2);
+  for (std::uint32_t value = 0; value < 4000; value += 2) {
+    ASSERT_TRUE(bitmap.Remove(value));
+  }
+  ASSERT_EQ(bitmap.Cardinality(), 3000);
+  ASSERT_FALSE(bitmap.Contains(3998));
+  ASSERT_TRUE(bitmap.Contains(4000));
+  ASSERT_EQ(bitmap.Rank(9998), 3000);
+}
+
+TEST(RoaringBitmapTest, MatchesStdSet) {
+  auto values = MixedValues(1);
+  auto bitmap = BitmapOf(values);
+  ASSERT_EQ(bitmap.Cardinality(), values.size());
+  ASSERT_EQ(ToVector(bitmap),
+            std::vector<std::uint32_t>(values.begin(), values.end()));
+  ASSERT_TRUE(bitmap.RunOptimize());
+  ASSERT_EQ(ToVector(bitmap),
+            std::vector<std::uint32_t>(values.begin(), values.end()));
+  std::mt19937 random(2);
+  for (int i = 0; i < 20000; i++) {
+    auto value = random() % (6u << 16);
+    ASSERT_EQ(bitmap.Contains(value), values.count(value) == 1) << value;
+  }
+}
+
+TEST(RoaringBitmapTest, RunsShrinkConsecutiveValues) {
+  nll::RoaringBitmap bitmap;
+  for (std::uint32_t value = 100; value < 300000; value++) {
+    bitmap.Add(value);
+  }
+  auto before = bitmap.MemoryBytes();
+  ASSERT_TRUE(bitmap.RunOptimize());
+  ASSERT_LT(bitmap.MemoryBytes() * 10, before);
+  ASSERT_EQ(bitmap.Cardinality(), 300000 - 100);
+
+  // Edits keep the runs consistent
+  ASSERT_TRUE(bitmap.Remove(1000));
+  ASSERT_FALSE(bitmap.Contains(1000));
+  ASSERT_TRUE(bitmap.Contains(999));
+  ASSERT_TRUE(bitmap.Contains(1001));
+  ASSERT_TRUE(bitmap.Add(1000));
+  ASSERT_TRUE(bitmap.Add(99));
+  ASSERT_TRUE(bitmap.Add(300000));
+  ASSERT_EQ(bitmap.Minimum(), 99);
+  ASSERT_EQ(bitmap.Maximum(), 300000);
+  ASSERT_EQ(bitmap.Cardinality(), 300000 - 98);
+}
+
+TEST(RoaringBitmapTest, AddRange) {
+  nll::RoaringBitmap bitmap{5, 200000};
+  bitmap.AddRange(10, 140000);
+  ASSERT_EQ(bitmap.Cardinality(), 140000 - 10 + 1 + 2);
+  ASSERT_TRUE(bitmap.Contains(10));
+  ASSERT_TRUE(bitmap.Contains(65535));
+  ASSERT_TRUE(bitmap.Contains(65536));
+  ASSERT_TRUE(bitmap.Contains(140000));
+  ASSERT_FALSE(bitmap.Contains(140001));
+  ASSERT_FALSE(bitmap.Contains(9));
+  bitmap.AddRange(140001, 140001);
+  ASSERT_EQ(bitmap.Maximum(), 200000);
+  ASSERT_EQ(bitmap.Rank(140001), 140001 - 10 + 1 + 1);
+  ASSERT_THROW(bitmap.AddRange(2, 1), std::invalid_argument);
+
+  nll::RoaringBitmap everything;
+  everything.AddRange(0, UINT32_MAX);
+  ASSERT_EQ(everything.Cardinality(), std::uint64_t{1} << 32);
+  ASSERT_EQ(everything.Select(123456789), 123456789u);
+}
+
+TEST(RoaringBitmapTest, SetOperationsMatchStdSet) {
+  auto values_a = MixedValues(3);
+  auto values_b = MixedValues(4);
+  for (bool optimize_a : {false, true}) {
+    for (bool optimize_b : {false, true}) {
+      auto a = BitmapOf(values_a);
+      auto b = BitmapOf(values_b);
+      if (optimize_a) {
+        a.RunOptimize();
+      }
+      if (optimize_b) {
+        b.RunOptimize();
+      }
+      std::vector<std::uint32_t> expected;
+      std::set_union(values_a.begin(), values_a.end(), values_b.begin(),
+                     values_b.end(), std::back_inserter(expected));
+      ASSERT_EQ(ToVector(a | b), expected);
+      expected.clear();
+      std::set_intersection(values_a.begin(), values_a.end(),
+                            values_b.begin(), values_b.end(),
+                            std::back_inserter(expected));
+      ASSERT_EQ(ToVector(a & b), expected);
+      expected.clear();
+      std::set_difference(values_a.begin(), values_a.end(), values_b.begin(),
+                          values_b.end(), std::back_inserter(expected));
+      ASSERT_EQ(ToVector(a - b), expected);
+      ASSERT_EQ((a - b).Cardinality(), expected.size());
+    }
+  }
+}
+
+TEST(RoaringBitmapTest, IntersectionOfSkewedArrays) {
+  nll::RoaringBitmap small{3, 510, 4000, 59993};
+  nll::RoaringBitmap large;
+  for (std::uint32_t value = 0; value < 65536; value += 17) {
+    large.Add(value);
+  }
+  ASSERT_EQ(ToVector(small & large), (std::vector<std::uint32_t>{510, 59993}));
+  nll::RoaringBitmap empty;
+  ASSERT_TRUE((small & empty).Empty());
+  ASSERT_EQ(small | empty, small);
+  ASSERT_TRUE((small - small).Empty());
+}
+
+TEST(RoaringBitmapTest, CompoundAssignment) {
+  nll::RoaringBitmap bitmap{1, 2, 3};
+  bitmap |= nll::RoaringBitmap{3, 4};
+  bitmap &= nll::RoaringBitmap{2, 3, 4, 5};
+  bitmap -= nll::RoaringBitmap{3};
+  ASSERT_EQ(bitmap, (nll::RoaringBitmap{2, 4}));
+  ASSERT_NE(bitmap, (nll::RoaringBitmap{2}));
+}
+
+TEST(RoaringBitmapTest, EqualityIgnoresRepresentation) {
+  auto values = MixedValues(5);
+  auto plain = BitmapOf(values);
+  auto optimized = BitmapOf(values);
+  optimized.RunOptimize();
+  ASSERT_EQ(plain, optimized);
+  optimized.Remove(*values.begin());
+  ASSERT_NE(plain, optimized);
+}
+
+TEST(RoaringBitmapTest, RankAndSelect) {
+  auto values = MixedValues(6);
+  auto bitmap = BitmapOf(values);
+  for (bool optimized : {false, true}) {
+    if (optimized) {
+      bitmap.RunOptimize();
+    }
+    std::uint64_t rank = 0;
+    for (auto value : values) {
+      ASSERT_EQ(bitmap.Select(rank), value);
+      ASSERT_EQ(bitmap.Rank(value), rank + 1);
+      rank++;
+    }
+    ASSERT_EQ(bitmap.Rank(0), values.count(0));
+    ASSERT_THROW(bitmap.Select(rank), std::out_of_range);
+  }
+  nll::RoaringBitmap empty;
+  ASSERT_EQ(empty.Rank(100), 0);
+  ASSERT_THROW(empty.Minimum(), std::out_of_range);
+  ASSERT_THROW(empty.Maximum(), std::out_of_range);
+}
+
+TEST(RoaringBitmapTest, SerializeRoundTrip) {
+  auto values = MixedValues(7);
+  auto bitmap = BitmapOf(values);
+  for (bool optimized : {false, true}) {
+    if (optimized) {
+      ASSERT_TRUE(bitmap.RunOptimize());
+    }
+    auto copy = nll::RoaringBitmap::Deserialize(bitmap.Serialize());
+    ASSERT_EQ(copy, bitmap);
+    ASSERT_EQ(copy.Cardinality(), values.size());
+  }
+  nll::RoaringBitmap empty;
+  ASSERT_TRUE(nll::RoaringBitmap::Deserialize(empty.Serialize()).Empty());
+}
+
+TEST(RoaringBitmapTest, SerializesTheSpecExample) {
+  // {0, 1, 2} in the Roaring portable format without runs: cookie, one
+  // container, key 0 with cardinality 3, its offset, then the values
+  std::vector<std::uint8_t> expected = {
+      0x3a, 0x30, 0, 0, 1, 0, 0, 0, 0, 0, 2, 0, 16, 0, 0, 0,
+      0,    0,    1, 0, 2, 0};
+  nll::RoaringBitmap bitmap{0, 1, 2};
+  ASSERT_EQ(bitmap.Serialize(), expected);
+
+  // The same values as one run: cookie with the container count, the run
+  // flags, key and cardinality, then one run of start 0 and length 3
+  std::vector<std::uint8_t> expected_runs = {0x3b, 0x30, 0, 0, 1, 0, 0,
+                                             2,    0,    1, 0, 0, 0, 2, 0};
+  nll::RoaringBitmap runs;
+  runs.AddRange(0, 2);
+  ASSERT_EQ(runs.Serialize(), expected_runs);
+  ASSERT_EQ(nll::RoaringBitmap::Deserialize(expected_runs), bitmap);
+}
+
+TEST(RoaringBitmapTest, DeserializeRejectsBadInput) {
+  auto bytes = BitmapOf(MixedValues(8)).Serialize();
+  ASSERT_THROW(nll::RoaringBitmap::Deserialize({}), std::invalid_argument);
+
+  auto truncated = bytes;
+  truncated.pop_back();
+  ASSERT_THROW(nll::RoaringBitmap::Deserialize(truncated),
+               std::invalid_argument);
+
+  auto trailing = bytes;
+  trailing.push_back(0);
+  ASSERT_THROW(nll::RoaringBitmap::Deserialize(trailing),
+               std::invalid_argument);
+
+  auto bad_cookie = bytes;
+  bad_cookie[0] = 0;
+  ASSERT_THROW(nll::RoaringBitmap::Deserialize(bad_cookie),
+               std::invalid_argument);
+
+  // Array values out of order
+  std::vector<std::uint8_t> unsorted = {0x3a, 0x30, 0, 0, 1, 0, 0, 0, 0, 0,
+                                        1,    0,    16, 0, 0, 0, 5, 0, 4, 0};
+  ASSERT_THROW(nll::RoaringBitmap::Deserialize(unsorted),
+               std::invalid_argument);
+}
+
+TEST(RoaringBitmapTest, DefaultIteratorsCompareEqual) {
+  nll::RoaringBitmap::Iterator a, b;
+  ASSERT_TRUE(a == b);
+  ASSERT_FALSE(a != b);
+
+  nll::RoaringBitmap empty;
+  ASSERT_TRUE(empty.begin() == empty.end());
+  ASSERT_TRUE(a != empty.end());
+}
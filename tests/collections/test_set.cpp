@@ -7,6 +7,8 @@
 
 #include <gtest/gtest.h>
 
+#include "nll/memory/monotonic_arena.hpp"
+
 class BaseSetTest : public testing::Test {
  protected:
   nll::Set set;
@@ -23,4 +25,20 @@ TEST_F(BaseSetTest, ContainsSucceeds) {
   ASSERT_TRUE(set.Contains("Bananas"));
 }
 
+TEST_F(BaseSetTest, ContainsDoesNotAdd) {
+  ASSERT_FALSE(set.Contains("Apples"));
+  ASSERT_FALSE(set.Contains("Apples"));
+  set.Add("Apples");
+  ASSERT_TRUE(set.Contains("Apples"));
+}
 
+TEST(PmrSetTest, StringsComeFromTheResource) {
+  nll::memory::MonotonicArena arena;
+  nll::pmr::Set set(&arena);
+  set.Add("a member long enough to need its own allocation");
+  auto used = arena.BytesUsed();
+  ASSERT_GT(used, 48);
+  ASSERT_TRUE(set.Contains("a member long enough to need its own allocation"));
+  ASSERT_FALSE(set.Contains("a string that was never added to the set"));
+  ASSERT_EQ(arena.BytesUsed(), used);
+}
@@ -0,0 +1,31 @@
+#include "nll/collections/stack.hpp"
+
+#include <memory_resource>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "nll/memory/monotonic_arena.hpp"
+
+TEST(StackTest, PushPeekPop) {
+  nll::Stack<int> stack;
+  stack.Push(1);
+  stack.Push(2);
+  ASSERT_EQ(stack.Peek(), 2);
+  ASSERT_EQ(stack.Pop(), 2);
+  ASSERT_EQ(stack.Size(), 1);
+  ASSERT_EQ(stack.Pop(), 1);
+  ASSERT_THROW(stack.Peek(), std::out_of_range);
+  ASSERT_THROW(stack.Pop(), std::out_of_range);
+}
+
+TEST(PmrStackTest, StorageComesFromTheResource) {
+  nll::memory::MonotonicArena arena;
+  nll::pmr::Stack<int> stack(&arena);
+  for (int i = 0; i < 100; i++) {
+    stack.Push(i);
+  }
+  ASSERT_EQ(stack.Peek(), 99);
+  ASSERT_EQ(stack.get_allocator().resource(), &arena);
+  ASSERT_GE(arena.BytesUsed(), 100 * sizeof(int));
+}
@@ -0,0 +1,169 @@
+#include "nll/collections/timer_wheel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using Fired = std::vector<std::pair<std::uint64_t, int>>;
+
+}  // namespace
+
+TEST(TimerWheelTest, FiresAtDeadline) {
+  nll::TimerWheel<int> wheel;
+  wheel.Schedule(5, 1);
+  wheel.Schedule(3, 2);
+  ASSERT_EQ(wheel.Size(), 2u);
+  std::vector<int> fired;
+  auto collect = [&](int& payload) { fired.push_back(payload); };
+  ASSERT_EQ(wheel.Advance(2, collect), 0u);
+  ASSERT_EQ(wheel.Advance(1, collect), 1u);
+  ASSERT_EQ(fired, (std::vector<int>{2}));
+  ASSERT_EQ(wheel.Advance(10, collect), 1u);
+  ASSERT_EQ(fired, (std::vector<int>{2, 1}));
+  ASSERT_EQ(wheel.Now(), 13u);
+  ASSERT_TRUE(wheel.Empty());
+}
+
+TEST(TimerWheelTest, MatchesSortedOrderAcrossLevels) {
+  // Delays up to 2^40 fired in big jumps, and up to 2^18 in small steps
+  std::mt19937_64 random(7);
+  for (auto [shift, step] : {std::pair<int, std::uint64_t>{24, 1ULL << 36},
+                             std::pair<int, std::uint64_t>{46, 997}}) {
+    nll::TimerWheel<int> wheel(12345);
+    Fired expected;
+    for (int i = 0; i < 5000; i++) {
+      auto delay = random() >> (shift + random() % (64 - shift));
+      auto id = wheel.Schedule(delay, i);
+      expected.emplace_back(wheel.DeadlineOf(id), i);
+    }
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const auto& lhs, const auto& rhs) {
+                       return lhs.first < rhs.first;
+                     });
+    Fired fired;
+    while (!wheel.Empty()) {
+      wheel.Advance(step, [&](int& payload) {
+        fired.emplace_back(wheel.Now(), payload);
+      });
+    }
+    ASSERT_EQ(fired.size(), expected.size());
+    for (std::size_t i = 0; i < fired.size(); i++) {
+      ASSERT_EQ(fired[i].first, expected[i].first);
+    }
+  }
+}
+
+TEST(TimerWheelTest, CancelAndStaleHandles) {
+  nll::TimerWheel<int> wheel;
+  auto first = wheel.Schedule(100, 1);
+  auto second = wheel.Schedule(100, 2);
+  auto third = wheel.Schedule(100, 3);
+  ASSERT_TRUE(wheel.Cancel(second));
+  ASSERT_FALSE(wheel.Cancel(second));
+  ASSERT_FALSE(wheel.Pending(second));
+  ASSERT_THROW(wheel.DeadlineOf(second), std::invalid_argument);
+  // The freed node is reused under a new generation
+  auto fourth = wheel.Schedule(50, 4);
+  ASSERT_EQ(fourth.index, second.index);
+  ASSERT_FALSE(wheel.Cancel(second));
+  ASSERT_TRUE(wheel.Pending(fourth));
+  std::vector<int> fired;
+  wheel.Advance(100, [&](int& payload) { fired.push_back(payload); });
+  std::sort(fired.begin(), fired.end());
+  ASSERT_EQ(fired, (std::vector<int>{1, 3, 4}));
+  ASSERT_FALSE(wheel.Cancel(first));
+  ASSERT_FALSE(wheel.Cancel(third));
+}
+
+TEST(TimerWheelTest, RescheduleMovesTheDeadline) {
+  nll::TimerWheel<int> wheel;
+  auto id = wheel.Schedule(10, 1);
+  int fired = 0;
+  auto count = [&](int&) { fired++; };
+  for (int i = 0; i < 100; i++) {
+    wheel.Advance(5, count);
+    ASSERT_TRUE(wheel.Reschedule(id, 10));
+  }
+  ASSERT_EQ(fired, 0);
+  ASSERT_EQ(wheel.DeadlineOf(id), 510u);
+  wheel.Advance(10, count);
+  ASSERT_EQ(fired, 1);
+  ASSERT_FALSE(wheel.Reschedule(id, 10));
+}
+
+TEST(TimerWheelTest, CallbackSchedulesAndCancels) {
+  nll::TimerWheel<int> wheel;
+  std::vector<nll::TimerId> batch;
+  for (int i = 0; i < 4; i++) {
+    batch.push_back(wheel.Schedule(200, i));
+  }
+  std::vector<int> fired;
+  wheel.AdvanceTo(1000, [&](int& payload) {
+    fired.push_back(payload);
+    if (fired.size() == 1) {
+      // Cancels the batch members still waiting to be drained
+      for (auto id : batch) {
+        wheel.Cancel(id);
+      }
+      wheel.Schedule(0, 10);
+    } else if (payload == 10) {
+      wheel.Schedule(1000, 11);
+    }
+  });
+  ASSERT_EQ(fired.size(), 2u);
+  ASSERT_EQ(fired[1], 10);
+  ASSERT_EQ(wheel.Size(), 1u);
+  ASSERT_EQ(wheel.Now(), 1000u);
+}
+
+TEST(TimerWheelTest, PastDeadlinesFireOnTheNextTick) {
+  nll::TimerWheel<int> wheel(50);
+  wheel.ScheduleAt(10, 1);
+  wheel.Schedule(0, 2);
+  ASSERT_EQ(wheel.Advance(1, [](int&) {}), 2u);
+}
+
+TEST(TimerWheelTest, ClearKeepsHandlesStale) {
+  nll::TimerWheel<int> wheel;
+  auto id = wheel.Schedule(1 << 20, 1);
+  wheel.Clear();
+  ASSERT_TRUE(wheel.Empty());
+  ASSERT_FALSE(wheel.Cancel(id));
+  ASSERT_EQ(wheel.Advance(1 << 21, [](int&) {}), 0u);
+}
+
+TEST(TimerWheelTest, ClearFromCallbackStopsTheBatch) {
+  nll::TimerWheel<int> wheel;
+  for (int i = 0; i < 5; i++) {
+    wheel.Schedule(10, i);
+  }
+  wheel.Schedule(20, 5);
+  int fired = 0;
+  ASSERT_EQ(wheel.Advance(10,
+                          [&](int&) {
+                            fired++;
+                            wheel.Clear();
+                          }),
+            1u);
+  ASSERT_EQ(fired, 1);
+  ASSERT_TRUE(wheel.Empty());
+  // The pool's free list must still hand out every node once
+  std::vector<nll::TimerId> ids;
+  for (int i = 0; i < 6; i++) {
+    ids.push_back(wheel.Schedule(1, i));
+  }
+  for (std::size_t i = 0; i < ids.size(); i++) {
+    for (std::size_t j = 0; j < i; j++) {
+      ASSERT_NE(ids[i].index, ids[j].index);
+    }
+  }
+  ASSERT_EQ(wheel.Advance(1, [](int&) {}), 6u);
+  ASSERT_TRUE(wheel.Empty());
+}
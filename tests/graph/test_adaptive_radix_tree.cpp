@@ -0,0 +1,211 @@
+#include "nll/graph/adaptive_radix_tree.hpp"
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using StringRadixTree = nll::binary_tree::AdaptiveRadixTree<std::string, int>;
+
+/// @brief Walks the tree in order, checking it against the reference map
+template <class TKey>
+void ExpectSameEntries(
+    const nll::binary_tree::AdaptiveRadixTree<TKey, int>& tree,
+    const std::map<TKey, int>& expected) {
+  std::vector<std::pair<TKey, int>> entries;
+  tree.ForEach(
+      [&](const TKey& key, int value) { entries.emplace_back(key, value); });
+  ASSERT_EQ(tree.Size(), expected.size());
+  ASSERT_EQ(entries, (std::vector<std::pair<TKey, int>>(expected.begin(),
+                                                         expected.end())));
+}
+
+}  // namespace
+
+TEST(RadixKeyBytesTest, IntegersCompareLikeTheirBytes) {
+  std::vector<std::int32_t> keys = {-2147483647 - 1, -70000, -1, 0,
+                                    1,               255,    256, 2147483647};
+  for (std::size_t i = 1; i < keys.size(); i++) {
+    nll::binary_tree::detail::RadixKeyBytes<std::int32_t> low(keys[i - 1]);
+    nll::binary_tree::detail::RadixKeyBytes<std::int32_t> high(keys[i]);
+    ASSERT_LT(low.bytes, high.bytes);
+  }
+}
+
+TEST(AdaptiveRadixTreeTest, EmptyTreeIsEmpty) {
+  StringRadixTree tree;
+  ASSERT_TRUE(tree.Empty());
+  ASSERT_FALSE(tree.Contains(""));
+  ASSERT_THROW(tree.Get("a"), std::out_of_range);
+  ASSERT_FALSE(tree.Erase("a"));
+  ASSERT_EQ(tree.Scan("", [](const std::string&, int) { return true; }), 0);
+}
+
+TEST(AdaptiveRadixTreeTest, InsertOverwrites) {
+  StringRadixTree tree;
+  ASSERT_TRUE(tree.Insert("key", 1));
+  ASSERT_FALSE(tree.Insert("key", 2));
+  ASSERT_EQ(tree.Size(), 1);
+  ASSERT_EQ(tree.Get("key"), 2);
+}
+
+TEST(AdaptiveRadixTreeTest, KeysThatArePrefixesOfOthers) {
+  StringRadixTree tree;
+  std::map<std::string, int> expected;
+  for (const auto& key : std::vector<std::string>{
+           "", "a", "ab", "abc", "abcdefghijklmnop", "abcdefghijklmnopq",
+           "abcdefghijklmnoq", "b", std::string("a\0b", 3)}) {
+    tree.Insert(key, static_cast<int>(key.size()));
+    expected[key] = static_cast<int>(key.size());
+  }
+  for (const auto& [key, value] : expected) {
+    ASSERT_EQ(tree.Get(key), value);
+  }
+  ASSERT_FALSE(tree.Contains("abcd"));
+  ASSERT_FALSE(tree.Contains("abcdefghijklmno"));
+  ASSERT_FALSE(tree.Contains("abcdefghijklmnoz"));
+  ExpectSameEntries(tree, expected);
+}
+
+TEST(AdaptiveRadixTreeTest, NodesGrowAndShrink) {
+  // One byte fans out to 256 children, then erasing walks every node type
+  // back down until the last key collapses the tree into a leaf
+  StringRadixTree tree;
+  std::map<std::string, int> expected;
+  for (int byte = 0; byte < 256; byte++) {
+    std::string key = "prefix/" + std::string(1, static_cast<char>(byte));
+    tree.Insert(key, byte);
+    expected[key] = byte;
+    ASSERT_EQ(tree.Get(key), byte);
+  }
+  ExpectSameEntries(tree, expected);
+  for (int byte = 255; byte > 0; byte--) {
+    std::string key = "prefix/" + std::string(1, static_cast<char>(byte));
+    ASSERT_TRUE(tree.Erase(key));
+    ASSERT_FALSE(tree.Erase(key));
+    expected.erase(key);
+    ASSERT_EQ(tree.Get("prefix/" + std::string(1, '\0')), 0);
+  }
+  ExpectSameEntries(tree, expected);
+}
+
+TEST(AdaptiveRadixTreeTest, MatchesStdMapUnderRandomEdits) {
+  std::mt19937 random(7);
+  std::uniform_int_distribution<int> length(0, 20);
+  std::uniform_int_distribution<int> letter('a', 'd');
+  std::uniform_int_distribution<int> action(0, 2);
+  StringRadixTree tree;
+  std::map<std::string, int> expected;
+  for (int i = 0; i < 20000; i++) {
+    // Half the keys share a stem longer than the prefix bytes nodes store
+    std::string key(length(random), ' ');
+    for (auto& c : key) {
+      c = static_cast<char>(letter(random));
+    }
+    if (i % 2 == 0) {
+      key = "https://www.example.com/" + key;
+    }
+    if (action(random) == 0) {
+      ASSERT_EQ(tree.Erase(key), expected.erase(key) == 1);
+    } else {
+      ASSERT_EQ(tree.Insert(key, i), expected.count(key) == 0);
+      expected[key] = i;
+    }
+    auto* value = tree.Find(key);
+    auto it = expected.find(key);
+    ASSERT_EQ(value != nullptr, it != expected.end());
+    if (value != nullptr) {
+      ASSERT_EQ(*value, it->second);
+    }
+  }
+  ExpectSameEntries(tree, expected);
+}
+
+TEST(AdaptiveRadixTreeTest, ScanStartsAtLowerBound) {
+  StringRadixTree tree;
+  std::map<std::string, int> expected;
+  for (int i = 0; i < 2000; i++) {
+    auto key = "https://example.com/item/" + std::to_string(i * 7);
+    tree.Insert(key, i);
+    expected[key] = i;
+  }
+  for (const std::string from :
+       {"", "a", "https://example.com/item/", "https://example.com/item/35",
+        "https://example.com/item/350", "https://example.com/item/9",
+        "https://example.com/item/99999", "https://example.com/j", "z"}) {
+    std::vector<std::string> keys;
+    tree.Scan(from, [&](const std::string& key, int) {
+      keys.push_back(key);
+      return true;
+    });
+    std::vector<std::string> reference;
+    for (auto it = expected.lower_bound(from); it != expected.end(); ++it) {
+      reference.push_back(it->first);
+    }
+    ASSERT_EQ(keys, reference) << from;
+  }
+  std::size_t calls = 0;
+  auto visited = tree.Scan("https://example.com/item/1",
+                           [&](const std::string&, int) {
+                             return ++calls < 10;
+                           });
+  ASSERT_EQ(visited, 10);
+}
+
+TEST(AdaptiveRadixTreeTest, ScanPrefixVisitsMatchingKeys) {
+  StringRadixTree tree;
+  for (const std::string key :
+       {"/", "/api", "/api/users", "/api/users/1", "/api/users/2",
+        "/api/v2/users", "/apis", "/static/app.js"}) {
+    tree.Insert(key, 0);
+  }
+  auto prefixed = [&](std::string_view prefix) {
+    std::vector<std::string> keys;
+    tree.ScanPrefix(prefix, [&](const std::string& key, int) {
+      keys.push_back(key);
+      return true;
+    });
+    return keys;
+  };
+  ASSERT_EQ(prefixed("/api/users"),
+            (std::vector<std::string>{"/api/users", "/api/users/1",
+                                      "/api/users/2"}));
+  ASSERT_EQ(prefixed("/api/u"),
+            (std::vector<std::string>{"/api/users", "/api/users/1",
+                                      "/api/users/2"}));
+  ASSERT_EQ(prefixed("/apis"), std::vector<std::string>{"/apis"});
+  ASSERT_EQ(prefixed("/static/app.js"),
+            std::vector<std::string>{"/static/app.js"});
+  ASSERT_TRUE(prefixed("/static/app.jsx").empty());
+  ASSERT_TRUE(prefixed("/b").empty());
+  ASSERT_EQ(prefixed("").size(), tree.Size());
+}
+
+TEST(AdaptiveRadixTreeTest, IntegerKeysIterateInNumericOrder) {
+  nll::binary_tree::AdaptiveRadixTree<std::int64_t, int> tree;
+  std::map<std::int64_t, int> expected;
+  std::mt19937_64 random(3);
+  for (int i = 0; i < 5000; i++) {
+    auto key = static_cast<std::int64_t>(random()) >> (i % 50);
+    tree.Insert(key, i);
+    expected[key] = i;
+  }
+  ExpectSameEntries(tree, expected);
+  std::vector<std::int64_t> keys;
+  tree.Scan(-1000, [&](std::int64_t key, int) {
+    keys.push_back(key);
+    return true;
+  });
+  ASSERT_EQ(keys.size(), static_cast<std::size_t>(std::distance(
+                             expected.lower_bound(-1000), expected.end())));
+  for (auto key : keys) {
+    ASSERT_GE(key, -1000);
+  }
+}
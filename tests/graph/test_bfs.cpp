@@ -0,0 +1,115 @@
+#include "nll/graph/bfs.hpp"
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using Graph = nll::graph::CsrGraph32;
+using Result = nll::graph::BfsResult<std::uint32_t>;
+
+static Graph RandomUndirectedGraph(std::uint32_t num_vertices,
+                                   std::size_t num_edges) {
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<std::uint32_t> pick(0, num_vertices - 1);
+  std::vector<Graph::Edge> edges;
+  for (std::size_t i = 0; i < num_edges; i++) {
+    edges.emplace_back(pick(rng), pick(rng));
+  }
+  nll::graph::CsrBuildOptions options;
+  options.symmetrize = true;
+  options.deduplicate = true;
+  return Graph::FromEdges(edges, num_vertices, options);
+}
+
+/// @brief Checks that every reached vertex's parent is a neighbor one hop
+/// closer to the source
+static void ExpectValidTree(const Graph& graph, const Result& result,
+                            std::uint32_t source) {
+  ASSERT_EQ(result.parents[source], source);
+  for (std::uint32_t v = 0; v < graph.NumVertices(); v++) {
+    if (v == source) {
+      continue;
+    }
+    if (result.distances[v] == Result::kUnreached) {
+      ASSERT_EQ(result.parents[v], Result::kUnreached);
+      continue;
+    }
+    auto parent = result.parents[v];
+    ASSERT_EQ(result.distances[parent] + 1, result.distances[v]);
+    bool adjacent = false;
+    for (auto u : graph.Neighbors(parent)) {
+      adjacent = adjacent || u == v;
+    }
+    ASSERT_TRUE(adjacent);
+  }
+}
+
+TEST(BfsTest, PathGraphDistances) {
+  nll::graph::CsrBuildOptions options;
+  options.symmetrize = true;
+  auto graph = Graph::FromEdges({{0, 1}, {1, 2}, {2, 3}}, 5, options);
+  auto result = nll::graph::BreadthFirstSearch(graph, 0u);
+  ASSERT_EQ(result.distances,
+            (std::vector<std::uint32_t>{0, 1, 2, 3, Result::kUnreached}));
+  ASSERT_EQ(result.parents, (std::vector<std::uint32_t>{0, 0, 1, 2,
+                                                        Result::kUnreached}));
+}
+
+TEST(BfsTest, DirectionOptimizingMatchesTopDown) {
+  auto graph = RandomUndirectedGraph(5000, 40000);
+  nll::graph::BfsOptions top_down;
+  top_down.num_threads = 1;
+  auto expected = nll::graph::BreadthFirstSearch(graph, 3u, top_down);
+
+  for (unsigned threads : {1u, 4u}) {
+    nll::graph::BfsOptions options;
+    options.direction_optimizing = true;
+    options.num_threads = threads;
+    auto result = nll::graph::BreadthFirstSearch(graph, 3u, options);
+    ASSERT_EQ(result.distances, expected.distances);
+    ExpectValidTree(graph, result, 3u);
+  }
+}
+
+TEST(BfsTest, DirectedGraphFollowsOutEdgesOnly) {
+  // The source's fan-out is big enough for the direction heuristic to go
+  // bottom-up, where every vertex pointing back at the source would look
+  // reached
+  std::vector<Graph::Edge> edges;
+  for (std::uint32_t v = 1; v <= 100; v++) {
+    edges.emplace_back(0, v);
+  }
+  for (std::uint32_t v = 101; v < 1000; v++) {
+    edges.emplace_back(v, 0);
+  }
+  auto graph = Graph::FromEdges(edges, 1000);
+  auto result = nll::graph::BreadthFirstSearch(graph, 0u);
+  for (std::uint32_t v = 1; v < 1000; v++) {
+    ASSERT_EQ(result.distances[v], v <= 100 ? 1u : Result::kUnreached);
+  }
+  ExpectValidTree(graph, result, 0u);
+}
+
+TEST(BfsTest, RunsOnConvertedUnweightedGraph) {
+  nll::graph::UnweightedGraph<int> source;
+  auto node1 = source.AddNode(1);
+  auto node2 = source.AddNode(2);
+  auto node3 = source.AddNode(3);
+  auto node4 = source.AddNode(4);
+  node1->AddNeighbor(node2);
+  node1->AddNeighbor(node3);
+  node2->AddNeighbor(node4);
+
+  auto graph = nll::graph::ToCsr(source);
+  auto result = nll::graph::BreadthFirstSearch(graph, 0u);
+  ASSERT_EQ(result.distances, (std::vector<std::uint32_t>{0, 1, 1, 2}));
+  ASSERT_EQ(result.parents[3], 1u);
+}
+
+TEST(BfsTest, OutOfRangeSourceThrows) {
+  Graph graph;
+  ASSERT_THROW(nll::graph::BreadthFirstSearch(graph, 0u), std::out_of_range);
+}
@@ -11,4 +11,30 @@ TEST(BinaryTreeTest, Basic) {
   delete node->right;
   delete node->left;
   delete node;
-}
\ No newline at end of file
+}
+
+TEST(BinaryTreeTest, ChainIsNotBalanced) {
+  auto node = new nll::binary_tree::Node<int>(1);
+  node->right = new nll::binary_tree::Node<int>(2);
+  node->right->right = new nll::binary_tree::Node<int>(3);
+
+  ASSERT_FALSE(nll::binary_tree::is_balanced(node));
+  node->left = new nll::binary_tree::Node<int>(0);
+  node->left->left = new nll::binary_tree::Node<int>(-1);
+  ASSERT_TRUE(nll::binary_tree::is_balanced(node));
+  node->right->right->right = new nll::binary_tree::Node<int>(4);
+  node->left->left->left = new nll::binary_tree::Node<int>(-2);
+  // Root is even, but both of its children lean by two
+  ASSERT_FALSE(nll::binary_tree::is_balanced(node));
+  delete node->left->left->left;
+  delete node->right->right->right;
+  delete node->left->left;
+  delete node->left;
+  delete node->right->right;
+  delete node->right;
+  delete node;
+}
+
+TEST(BinaryTreeTest, Empty) {
+  ASSERT_TRUE(nll::binary_tree::is_balanced<int>(nullptr));
+}
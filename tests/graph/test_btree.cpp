@@ -0,0 +1,181 @@
+#include "nll/graph/btree.hpp"
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(NodeLowerBoundTest, MatchesLinearSearch) {
+  std::vector<std::uint32_t> unsigned_keys = {1, 5, 9, 0x80000000u,
+                                              0xFFFFFFF0u, 0xFFFFFFFFu};
+  std::vector<std::int32_t> signed_keys = {-100, -3, 0, 7, 8, 1000};
+  std::vector<std::uint64_t> wide_keys = {2, 4, 1ull << 63, ~0ull};
+  for (std::size_t i = 0; i <= unsigned_keys.size(); i++) {
+    auto probe = i < unsigned_keys.size() ? unsigned_keys[i] : 0u;
+    ASSERT_EQ(nll::binary_tree::detail::NodeLowerBound(
+                  unsigned_keys.data(), unsigned_keys.size(), probe),
+              nll::binary_tree::detail::ScalarLowerBound(
+                  unsigned_keys.data(), unsigned_keys.size(), probe));
+  }
+  for (std::int32_t probe : {-101, -3, -2, 7, 9, 1001}) {
+    ASSERT_EQ(nll::binary_tree::detail::NodeLowerBound(
+                  signed_keys.data(), signed_keys.size(), probe),
+              nll::binary_tree::detail::ScalarLowerBound(
+                  signed_keys.data(), signed_keys.size(), probe));
+  }
+  for (std::uint64_t probe : {0ull, 3ull, 1ull << 63, ~0ull}) {
+    ASSERT_EQ(nll::binary_tree::detail::NodeLowerBound(
+                  wide_keys.data(), wide_keys.size(), probe),
+              nll::binary_tree::detail::ScalarLowerBound(
+                  wide_keys.data(), wide_keys.size(), probe));
+  }
+}
+
+class BaseBPlusTreeTest : public testing::Test {
+ protected:
+  nll::binary_tree::BPlusTree<std::uint32_t, std::string> tree;
+};
+
+TEST_F(BaseBPlusTreeTest, EmptyTreeIsEmpty) {
+  ASSERT_TRUE(tree.Empty());
+  ASSERT_EQ(tree.Height(), 1);
+  ASSERT_FALSE(tree.Contains(0));
+  ASSERT_THROW(tree.Get(0), std::out_of_range);
+}
+
+TEST_F(BaseBPlusTreeTest, InsertOverwrites) {
+  ASSERT_TRUE(tree.Insert(7, "seven"));
+  ASSERT_FALSE(tree.Insert(7, "sept"));
+  ASSERT_EQ(tree.Size(), 1);
+  ASSERT_EQ(tree.Get(7), "sept");
+}
+
+TEST_F(BaseBPlusTreeTest, SplitsKeepEveryKey) {
+  for (std::uint32_t key = 0; key < 5000; key++) {
+    tree.Insert(key * 7 % 5000, std::to_string(key * 7 % 5000));
+  }
+  ASSERT_EQ(tree.Size(), 5000);
+  ASSERT_GT(tree.Height(), 2);
+  for (std::uint32_t key = 0; key < 5000; key++) {
+    ASSERT_EQ(tree.Get(key), std::to_string(key));
+  }
+  ASSERT_FALSE(tree.Contains(5000));
+}
+
+TEST_F(BaseBPlusTreeTest, ScanWalksLeavesInOrder) {
+  for (std::uint32_t key = 0; key < 1000; key += 2) {
+    tree.Insert(key, "");
+  }
+  std::vector<std::uint32_t> keys;
+  auto visited = tree.Scan(501, [&](std::uint32_t key, const std::string&) {
+    keys.push_back(key);
+    return keys.size() < 100;
+  });
+  ASSERT_EQ(visited, 100);
+  for (std::size_t i = 0; i < keys.size(); i++) {
+    ASSERT_EQ(keys[i], 502 + 2 * i);
+  }
+  ASSERT_EQ(tree.Scan(0, [](auto, const auto&) { return true; }), 500);
+  ASSERT_EQ(tree.Scan(999, [](auto, const auto&) { return true; }), 0);
+}
+
+TEST(BPlusTreeTest, FromSortedMatchesInsertion) {
+  using Tree = nll::binary_tree::BPlusTree<std::int64_t, std::int64_t>;
+  std::vector<std::pair<std::int64_t, std::int64_t>> entries;
+  for (std::int64_t key = -20000; key < 20000; key += 3) {
+    entries.emplace_back(key, key * 2);
+  }
+  auto tree = Tree::FromSorted(entries);
+  ASSERT_EQ(tree.Size(), entries.size());
+  for (const auto& entry : entries) {
+    ASSERT_EQ(tree.Get(entry.first), entry.second);
+    ASSERT_FALSE(tree.Contains(entry.first + 1));
+  }
+  std::int64_t expected = -20000;
+  tree.Scan(-30000, [&](std::int64_t key, std::int64_t) {
+    EXPECT_EQ(key, expected);
+    expected += 3;
+    return true;
+  });
+  // Inserting into packed leaves splits them
+  for (std::int64_t key = -20000; key < 20000; key += 3) {
+    tree.Insert(key + 1, 0);
+  }
+  ASSERT_EQ(tree.Size(), 2 * entries.size());
+  ASSERT_EQ(tree.Get(-19999), 0);
+  ASSERT_EQ(tree.Get(19996), 39992);
+}
+
+TEST(BPlusTreeTest, FromSortedRejectsUnsortedInput) {
+  using Tree = nll::binary_tree::BPlusTree<int, int>;
+  ASSERT_THROW(Tree::FromSorted({{2, 0}, {1, 0}}), std::invalid_argument);
+  ASSERT_TRUE(Tree::FromSorted({}).Empty());
+}
+
+TEST(BPlusTreeTest, MatchesStdMapUnderRandomInserts) {
+  nll::binary_tree::BPlusTree<std::uint64_t, std::uint64_t, false, 128> tree;
+  std::map<std::uint64_t, std::uint64_t> reference;
+  std::mt19937_64 rng(3);
+  for (int i = 0; i < 20000; i++) {
+    auto key = rng() % 8000;
+    ASSERT_EQ(tree.Insert(key, i), reference.insert_or_assign(key, i).second);
+  }
+  ASSERT_EQ(tree.Size(), reference.size());
+  auto it = reference.begin();
+  tree.Scan(0, [&](std::uint64_t key, std::uint64_t value) {
+    EXPECT_EQ(key, it->first);
+    EXPECT_EQ(value, it->second);
+    ++it;
+    return true;
+  });
+  ASSERT_TRUE(it == reference.end());
+}
+
+TEST(BPlusTreeTest, ConcurrentInsertsAndReads) {
+  nll::binary_tree::BPlusTree<std::uint32_t, std::uint32_t, true> tree;
+  constexpr std::uint32_t kThreads = 4;
+  constexpr std::uint32_t kPerThread = 20000;
+  std::vector<std::thread> threads;
+  for (std::uint32_t t = 0; t < kThreads; t++) {
+    threads.emplace_back([&tree, t] {
+      for (std::uint32_t i = 0; i < kPerThread; i++) {
+        auto key = i * kThreads + t;
+        tree.Insert(key, key + 1);
+        // Keys this thread inserted stay visible to it
+        if (tree.Get(key) != key + 1) {
+          ADD_FAILURE() << "lost key " << key;
+          return;
+        }
+      }
+    });
+  }
+  threads.emplace_back([&tree] {
+    for (int round = 0; round < 50; round++) {
+      std::uint32_t previous = 0;
+      bool first = true;
+      tree.Scan(0, [&](std::uint32_t key, std::uint32_t value) {
+        EXPECT_TRUE(first || key > previous);
+        EXPECT_EQ(value, key + 1);
+        previous = key;
+        first = false;
+        return true;
+      });
+    }
+  });
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(tree.Size(), kThreads * kPerThread);
+  std::uint32_t expected = 0;
+  tree.Scan(0, [&](std::uint32_t key, std::uint32_t) {
+    EXPECT_EQ(key, expected++);
+    return true;
+  });
+  ASSERT_EQ(expected, kThreads * kPerThread);
+}
@@ -0,0 +1,54 @@
+#include "nll/graph/connected_components.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "nll/graph/bfs.hpp"
+
+TEST(ConnectedComponentsTest, LabelsAreSmallestVertexOfComponent) {
+  nll::graph::CsrBuildOptions options;
+  options.symmetrize = true;
+  auto graph = nll::graph::CsrGraph32::FromEdges(
+      {{4, 2}, {2, 0}, {5, 3}, {6, 6}}, 7, options);
+  auto labels = nll::graph::ConnectedComponents(graph);
+  ASSERT_EQ(labels, (std::vector<std::uint32_t>{0, 1, 0, 3, 0, 3, 6}));
+}
+
+TEST(ConnectedComponentsTest, MatchesBfsReachability) {
+  std::mt19937 rng(11);
+  std::uniform_int_distribution<std::uint32_t> pick(0, 2999);
+  std::vector<nll::graph::CsrGraph32::Edge> edges;
+  for (int i = 0; i < 2500; i++) {
+    edges.emplace_back(pick(rng), pick(rng));
+  }
+  nll::graph::CsrBuildOptions build;
+  build.symmetrize = true;
+  auto graph = nll::graph::CsrGraph32::FromEdges(edges, 3000, build);
+
+  nll::graph::ComponentsOptions options;
+  options.num_threads = 4;
+  options.num_samples = 64;
+  auto labels = nll::graph::ConnectedComponents(graph, options);
+  for (std::uint32_t source : {0u, 17u, 2999u}) {
+    auto bfs = nll::graph::BreadthFirstSearch(graph, source);
+    for (std::uint32_t v = 0; v < 3000; v++) {
+      bool reached = bfs.distances[v] != bfs.kUnreached;
+      ASSERT_EQ(labels[v] == labels[source], reached);
+    }
+  }
+}
+
+TEST(ConnectedComponentsTest, WorksOnUnweightedGraph) {
+  nll::graph::UnweightedGraph<int> graph;
+  auto node1 = graph.AddNode(1);
+  auto node2 = graph.AddNode(2);
+  auto node3 = graph.AddNode(3);
+  auto node4 = graph.AddNode(4);
+  node1->AddNeighbor(node3);
+  node2->AddNeighbor(node4);
+  auto labels = nll::graph::ConnectedComponents(graph);
+  ASSERT_EQ(labels, (std::vector<std::uint32_t>{0, 1, 0, 1}));
+}
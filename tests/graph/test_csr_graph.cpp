@@ -0,0 +1,114 @@
+#include "nll/graph/csr_graph.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using Graph = nll::graph::CsrGraph32;
+
+static std::vector<std::uint32_t> SortedNeighbors(const Graph& graph,
+                                                  std::uint32_t v) {
+  auto neighbors = graph.Neighbors(v);
+  std::vector<std::uint32_t> result(neighbors.begin(), neighbors.end());
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+TEST(CsrGraphTest, EmptyGraphHasNoVertices) {
+  Graph graph;
+  ASSERT_EQ(graph.NumVertices(), 0);
+  ASSERT_EQ(graph.NumEdges(), 0);
+}
+
+TEST(CsrGraphTest, FromEdgesGroupsBySource) {
+  auto graph = Graph::FromEdges({{0, 1}, {2, 0}, {0, 2}, {1, 2}}, 3);
+  ASSERT_EQ(graph.NumVertices(), 3);
+  ASSERT_EQ(graph.NumEdges(), 4);
+  ASSERT_EQ(SortedNeighbors(graph, 0), (std::vector<std::uint32_t>{1, 2}));
+  ASSERT_EQ(SortedNeighbors(graph, 1), (std::vector<std::uint32_t>{2}));
+  ASSERT_EQ(SortedNeighbors(graph, 2), (std::vector<std::uint32_t>{0}));
+}
+
+TEST(CsrGraphTest, SymmetrizeAddsReverseEdges) {
+  nll::graph::CsrBuildOptions options;
+  options.symmetrize = true;
+  auto graph = Graph::FromEdges({{0, 1}, {1, 2}}, 3, options);
+  ASSERT_EQ(graph.NumEdges(), 4);
+  ASSERT_EQ(SortedNeighbors(graph, 1), (std::vector<std::uint32_t>{0, 2}));
+}
+
+TEST(CsrGraphTest, DeduplicateDropsParallelEdgesAndSorts) {
+  nll::graph::CsrBuildOptions options;
+  options.deduplicate = true;
+  options.remove_self_loops = true;
+  auto graph =
+      Graph::FromEdges({{0, 2}, {0, 1}, {0, 2}, {1, 1}, {0, 1}}, 3, options);
+  ASSERT_EQ(graph.NumEdges(), 2);
+  auto neighbors = graph.Neighbors(0);
+  ASSERT_EQ(std::vector<std::uint32_t>(neighbors.begin(), neighbors.end()),
+            (std::vector<std::uint32_t>{1, 2}));
+  ASSERT_EQ(graph.Degree(1), 0);
+}
+
+TEST(CsrGraphTest, ParallelBuildMatchesSequentialBuild) {
+  std::vector<Graph::Edge> edges;
+  for (std::uint32_t i = 0; i < 20000; i++) {
+    edges.emplace_back(i % 997, (i * 7919) % 997);
+  }
+  nll::graph::CsrBuildOptions options;
+  options.deduplicate = true;
+  options.num_threads = 1;
+  auto sequential = Graph::FromEdges(edges, 997, options);
+  options.num_threads = 4;
+  auto parallel = Graph::FromEdges(edges, 997, options);
+  ASSERT_EQ(sequential.Offsets(), parallel.Offsets());
+  ASSERT_EQ(sequential.Targets(), parallel.Targets());
+}
+
+TEST(CsrGraphTest, OutOfRangeEdgeThrows) {
+  ASSERT_THROW(Graph::FromEdges({{0, 3}}, 3), std::out_of_range);
+}
+
+TEST(CsrGraphTest, InvalidArraysThrow) {
+  ASSERT_THROW(Graph({0, 2}, {0}), std::invalid_argument);
+  ASSERT_THROW(Graph({0, 1}, {1}), std::invalid_argument);
+}
+
+TEST(CsrGraphTest, ConvertsUnweightedGraph) {
+  nll::graph::UnweightedGraph<int> source;
+  auto node1 = source.AddNode(1);
+  auto node2 = source.AddNode(2);
+  auto node3 = source.AddNode(3);
+  node1->AddNeighbor(node2);
+  node1->AddNeighbor(node3);
+
+  auto graph = nll::graph::ToCsr<std::uint64_t>(source);
+  ASSERT_EQ(graph.NumVertices(), 3);
+  ASSERT_EQ(graph.NumEdges(), 4);
+  ASSERT_EQ(graph.Degree(0), 2);
+  ASSERT_EQ(graph.Neighbors(0)[0], 1);
+  ASSERT_EQ(graph.Neighbors(0)[1], 2);
+  ASSERT_EQ(graph.Neighbors(2)[0], 0);
+}
+
+TEST(CsrGraphTest, SmallInputsRunOnTheCallingThread) {
+  std::vector<unsigned> chunks;
+  nll::graph::detail::ParallelChunks(
+      100, 8, [&](unsigned t, std::size_t begin, std::size_t end) {
+        chunks.push_back(t);
+        ASSERT_EQ(begin, 0u);
+        ASSERT_EQ(end, 100u);
+      });
+  ASSERT_EQ(chunks, (std::vector<unsigned>{0}));
+  std::vector<std::size_t> covered(4, 0);
+  nll::graph::detail::ParallelChunks(
+      4, 4,
+      [&](unsigned t, std::size_t begin, std::size_t end) {
+        covered[t] = end - begin;
+      },
+      1);
+  ASSERT_EQ(covered, (std::vector<std::size_t>{1, 1, 1, 1}));
+}
@@ -0,0 +1,74 @@
+#include "nll/graph/disjoint_set.hpp"
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(DisjointSetTest, StartsAsSingletons) {
+  nll::graph::DisjointSet<> set(4);
+  ASSERT_EQ(set.NumSets(), 4);
+  ASSERT_FALSE(set.Connected(0, 1));
+  ASSERT_EQ(set.Find(2), 2);
+}
+
+TEST(DisjointSetTest, UnionMergesSets) {
+  nll::graph::DisjointSet<> set(5);
+  ASSERT_TRUE(set.Union(0, 1));
+  ASSERT_TRUE(set.Union(3, 4));
+  ASSERT_TRUE(set.Union(1, 4));
+  ASSERT_FALSE(set.Union(0, 3));
+  ASSERT_EQ(set.NumSets(), 2);
+  ASSERT_TRUE(set.Connected(0, 4));
+  ASSERT_FALSE(set.Connected(2, 4));
+}
+
+TEST(DisjointSetTest, OutOfRangeThrows) {
+  nll::graph::DisjointSet<> set(2);
+  ASSERT_THROW(set.Find(2), std::out_of_range);
+}
+
+TEST(ConcurrentDisjointSetTest, RepresentativeIsSmallestElement) {
+  nll::graph::ConcurrentDisjointSet<> set(6);
+  set.Union(5, 3);
+  set.Union(3, 4);
+  set.Union(1, 2);
+  ASSERT_TRUE(set.Connected(4, 5));
+  ASSERT_FALSE(set.Connected(2, 3));
+  ASSERT_EQ(set.Labels(1), (std::vector<std::uint32_t>{0, 1, 1, 3, 3, 3}));
+}
+
+TEST(ConcurrentDisjointSetTest, ParallelUnionAllMatchesSequential) {
+  constexpr std::uint32_t kSize = 10000;
+  std::mt19937 rng(3);
+  std::uniform_int_distribution<std::uint32_t> pick(0, kSize - 1);
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+  for (std::uint32_t i = 0; i < kSize / 2; i++) {
+    edges.emplace_back(pick(rng), pick(rng));
+  }
+  nll::graph::ConcurrentDisjointSet<> concurrent(kSize);
+  concurrent.UnionAll(edges, 4);
+  nll::graph::DisjointSet<> sequential(kSize);
+  for (const auto& edge : edges) {
+    sequential.Union(edge.first, edge.second);
+  }
+
+  // The concurrent representative is the smallest element of each set
+  std::vector<std::uint32_t> smallest(kSize, kSize);
+  auto labels = concurrent.Labels(4);
+  for (std::uint32_t i = 0; i < kSize; i++) {
+    auto root = sequential.Find(i);
+    if (smallest[root] == kSize) {
+      smallest[root] = i;
+    }
+    ASSERT_EQ(labels[i], smallest[root]);
+  }
+}
+
+TEST(ConcurrentDisjointSetTest, UnionAllOutOfRangeThrows) {
+  nll::graph::ConcurrentDisjointSet<> set(2);
+  ASSERT_THROW(set.UnionAll({{0, 2}}), std::out_of_range);
+}
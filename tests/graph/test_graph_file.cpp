@@ -0,0 +1,193 @@
+#include "nll/graph/graph_file.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "nll/graph/bfs.hpp"
+
+class GraphFileTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    directory = std::filesystem::temp_directory_path() /
+                ("nll_graph_file_test_" +
+                 std::to_string(reinterpret_cast<std::uintptr_t>(this)));
+    std::filesystem::create_directories(directory);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory); }
+
+  std::string PathTo(const std::string& name) {
+    return (directory / name).string();
+  }
+
+  std::filesystem::path directory;
+};
+
+TEST_F(GraphFileTest, RoundTripsUnweightedGraphWithValues) {
+  auto graph = nll::graph::CsrGraph32::FromEdges({{0, 1}, {0, 2}, {2, 1}}, 4);
+  std::vector<double> values{0.5, 1.5, 2.5, 3.5};
+  nll::graph::WriteGraphFile(PathTo("g.bin"), graph, &values);
+
+  nll::graph::GraphFileOptions options;
+  options.verify_checksums = true;
+  nll::graph::MappedGraphFile file(PathTo("g.bin"), options);
+  ASSERT_EQ(file.NumVertices(), 4);
+  ASSERT_EQ(file.NumEdges(), 3);
+  ASSERT_FALSE(file.HasWeights());
+  auto view = file.Graph<std::uint32_t>();
+  for (std::uint32_t v = 0; v < 4; v++) {
+    auto expected = graph.Neighbors(v);
+    auto actual = view.Neighbors(v);
+    ASSERT_EQ(std::vector<std::uint32_t>(actual.begin(), actual.end()),
+              std::vector<std::uint32_t>(expected.begin(), expected.end()));
+  }
+  ASSERT_EQ(file.Values<double>()[2], 2.5);
+}
+
+TEST_F(GraphFileTest, AlgorithmsRunOnMappedView) {
+  nll::graph::CsrBuildOptions build;
+  build.symmetrize = true;
+  auto graph =
+      nll::graph::CsrGraph32::FromEdges({{0, 1}, {1, 2}, {2, 3}}, 4, build);
+  nll::graph::WriteGraphFile(PathTo("g.bin"), graph);
+  nll::graph::MappedGraphFile file(PathTo("g.bin"));
+  auto result = nll::graph::BreadthFirstSearch(file.Graph<std::uint32_t>(), 0u);
+  ASSERT_EQ(result.distances, (std::vector<std::uint32_t>{0, 1, 2, 3}));
+}
+
+TEST_F(GraphFileTest, RoundTripsWeightedGraph) {
+  auto graph = nll::graph::WeightedCsrGraph<float>::FromEdges(
+      {{0, 1, 1.25f}, {1, 0, 2.5f}}, 2);
+  nll::graph::WriteGraphFile(PathTo("w.bin"), graph);
+  nll::graph::MappedGraphFile file(PathTo("w.bin"));
+  ASSERT_TRUE(file.HasWeights());
+  auto view = file.WeightedGraph<float, std::uint32_t>();
+  ASSERT_EQ(view.Weights(1)[0], 2.5f);
+  ASSERT_THROW((file.WeightedGraph<double, std::uint32_t>()),
+               std::invalid_argument);
+  ASSERT_THROW(file.Graph<std::uint64_t>(), std::invalid_argument);
+}
+
+TEST_F(GraphFileTest, DetectsCorruption) {
+  auto graph = nll::graph::CsrGraph32::FromEdges({{0, 1}, {1, 0}}, 2);
+  nll::graph::WriteGraphFile(PathTo("g.bin"), graph);
+  {
+    std::fstream file(PathTo("g.bin"),
+                      std::ios::in | std::ios::out | std::ios::binary);
+    // Swaps the last target for another valid id, which only the
+    // checksums catch
+    file.seekp(-4, std::ios::end);
+    file.put('\x01');
+  }
+  ASSERT_NO_THROW(nll::graph::MappedGraphFile(PathTo("g.bin")));
+  nll::graph::GraphFileOptions options;
+  options.verify_checksums = true;
+  ASSERT_THROW(nll::graph::MappedGraphFile(PathTo("g.bin"), options),
+               std::runtime_error);
+}
+
+TEST_F(GraphFileTest, RejectsOutOfRangeIds) {
+  auto graph = nll::graph::CsrGraph32::FromEdges({{0, 1}, {1, 0}}, 2);
+  nll::graph::WriteGraphFile(PathTo("g.bin"), graph);
+  nll::graph::GraphFileHeader header;
+  {
+    std::fstream file(PathTo("g.bin"),
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    std::uint32_t target = 7;
+    file.seekp(static_cast<std::streamoff>(header.targets_offset));
+    file.write(reinterpret_cast<const char*>(&target), sizeof(target));
+  }
+  ASSERT_THROW(nll::graph::MappedGraphFile(PathTo("g.bin")),
+               std::runtime_error);
+  nll::graph::GraphFileOptions options;
+  options.verify_ids = false;
+  ASSERT_NO_THROW(nll::graph::MappedGraphFile(PathTo("g.bin"), options));
+  // A vertex count whose + 1 wraps must not get past the bounds checks
+  header.num_vertices = std::numeric_limits<std::uint64_t>::max();
+  header.header_checksum = nll::graph::detail::HeaderChecksum(header);
+  {
+    std::fstream file(PathTo("g.bin"),
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  }
+  ASSERT_THROW(nll::graph::MappedGraphFile(PathTo("g.bin"), options),
+               std::runtime_error);
+}
+
+TEST_F(GraphFileTest, RejectsNonGraphFiles) {
+  {
+    std::ofstream file(PathTo("junk.bin"));
+    file << std::string(200, 'x');
+  }
+  ASSERT_THROW(nll::graph::MappedGraphFile(PathTo("junk.bin")),
+               std::runtime_error);
+  ASSERT_THROW(nll::graph::MappedGraphFile(PathTo("missing.bin")),
+               std::system_error);
+}
+
+TEST(ParseEdgeListTest, ParsesAcrossThreads) {
+  std::string text = "# comment\n0 1\n1\t2\n\n% other comment\n2,3\n3 0";
+  for (unsigned threads : {1u, 3u, 8u}) {
+    auto edges =
+        nll::graph::ParseEdgeList<nll::graph::CsrGraph32::Edge>(text, threads);
+    ASSERT_EQ(edges, (std::vector<nll::graph::CsrGraph32::Edge>{
+                         {0, 1}, {1, 2}, {2, 3}, {3, 0}}));
+  }
+  // Big enough that every thread gets a chunk of its own
+  std::string big;
+  std::vector<nll::graph::CsrGraph32::Edge> expected;
+  for (std::uint32_t i = 0; i < 20000; i++) {
+    big += std::to_string(i) + " " + std::to_string(i + 1) + "\n";
+    expected.emplace_back(i, i + 1);
+  }
+  ASSERT_EQ(nll::graph::ParseEdgeList<nll::graph::CsrGraph32::Edge>(big, 8),
+            expected);
+}
+
+TEST(ParseEdgeListTest, ParsesWeights) {
+  using Edge = nll::graph::WeightedCsrGraph<double>::Edge;
+  auto edges = nll::graph::ParseEdgeList<Edge>("0 1 0.5\n1 2 2\n", 1);
+  ASSERT_EQ(edges.size(), 2);
+  ASSERT_EQ(edges[0].weight, 0.5);
+  ASSERT_EQ(edges[1].target, 2u);
+}
+
+TEST(ParseEdgeListTest, MalformedLineThrows) {
+  ASSERT_THROW(
+      nll::graph::ParseEdgeList<nll::graph::CsrGraph32::Edge>("0 1\nx 2\n"),
+      std::invalid_argument);
+}
+
+TEST(ParseEdgeListTest, TrailingJunkThrows) {
+  using Edge = nll::graph::CsrGraph32::Edge;
+  ASSERT_EQ(nll::graph::ParseEdgeList<Edge>("0 1 \t\r\n1 2\n", 1).size(),
+            2);
+  ASSERT_THROW(nll::graph::ParseEdgeList<Edge>("0 1\n1 2 garbage\n"),
+               std::invalid_argument);
+  ASSERT_THROW(nll::graph::ParseEdgeList<Edge>("0 1x\n"),
+               std::invalid_argument);
+}
+
+TEST_F(GraphFileTest, ConvertsTextEdgeList) {
+  {
+    std::ofstream text(PathTo("edges.txt"));
+    text << "0 1\n1 2\n4 2\n";
+  }
+  auto [num_vertices, num_edges] =
+      nll::graph::ConvertEdgeListToGraphFile<nll::graph::CsrGraph32>(
+          PathTo("edges.txt"), PathTo("g.bin"));
+  ASSERT_EQ(num_vertices, 5);
+  ASSERT_EQ(num_edges, 3);
+  nll::graph::MappedGraphFile file(PathTo("g.bin"));
+  ASSERT_EQ(file.Graph<std::uint32_t>().Neighbors(4)[0], 2u);
+}
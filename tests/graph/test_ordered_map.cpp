@@ -0,0 +1,144 @@
+#include "nll/graph/ordered_map.hpp"
+
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+class BaseOrderedMapTest : public testing::Test {
+ protected:
+  nll::binary_tree::OrderedMap<int, std::string> map;
+};
+
+TEST_F(BaseOrderedMapTest, EmptyMapIsEmpty) {
+  ASSERT_TRUE(map.Empty());
+  ASSERT_EQ(map.Size(), 0);
+  ASSERT_TRUE(map.begin() == map.end());
+  ASSERT_TRUE(map.IsBalanced());
+}
+
+TEST_F(BaseOrderedMapTest, InsertAndGet) {
+  ASSERT_TRUE(map.Insert(2, "two"));
+  ASSERT_TRUE(map.Insert(1, "one"));
+  ASSERT_FALSE(map.Insert(2, "deux"));
+  ASSERT_EQ(map.Size(), 2);
+  ASSERT_EQ(map.Get(2), "deux");
+  ASSERT_TRUE(map.Contains(1));
+  ASSERT_FALSE(map.Contains(3));
+  ASSERT_THROW(map.Get(3), std::out_of_range);
+}
+
+TEST_F(BaseOrderedMapTest, SubscriptDefaultConstructs) {
+  map[5] += "five";
+  ASSERT_EQ(map.Get(5), "five");
+  ASSERT_EQ(map.Size(), 1);
+}
+
+TEST_F(BaseOrderedMapTest, IteratesInKeyOrder) {
+  for (int key : {5, 3, 8, 1, 4, 7, 9}) {
+    map.Insert(key, std::to_string(key));
+  }
+  std::vector<int> keys;
+  for (auto entry : map) {
+    keys.push_back(entry.first);
+    ASSERT_EQ(entry.second, std::to_string(entry.first));
+  }
+  ASSERT_EQ(keys, (std::vector<int>{1, 3, 4, 5, 7, 8, 9}));
+}
+
+TEST_F(BaseOrderedMapTest, SequentialInsertStaysBalanced) {
+  for (int key = 0; key < 1000; key++) {
+    map.Insert(key, "");
+  }
+  ASSERT_TRUE(map.IsBalanced());
+  ASSERT_EQ(map.Size(), 1000);
+}
+
+TEST_F(BaseOrderedMapTest, LowerAndUpperBound) {
+  for (int key : {10, 20, 30}) {
+    map.Insert(key, "");
+  }
+  ASSERT_EQ(map.LowerBound(20)->first, 20);
+  ASSERT_EQ(map.LowerBound(21)->first, 30);
+  ASSERT_EQ(map.UpperBound(20)->first, 30);
+  ASSERT_EQ(map.LowerBound(5)->first, 10);
+  ASSERT_TRUE(map.LowerBound(31) == map.end());
+  ASSERT_TRUE(map.UpperBound(30) == map.end());
+}
+
+TEST_F(BaseOrderedMapTest, RangeIsHalfOpen) {
+  for (int key = 0; key < 20; key += 2) {
+    map.Insert(key, "");
+  }
+  std::vector<int> keys;
+  for (auto entry : map.Range(3, 10)) {
+    keys.push_back(entry.first);
+  }
+  ASSERT_EQ(keys, (std::vector<int>{4, 6, 8}));
+  ASSERT_TRUE(map.Range(10, 3).begin() == map.Range(10, 3).end());
+}
+
+TEST_F(BaseOrderedMapTest, EraseReusesSlots) {
+  for (int key = 0; key < 8; key++) {
+    map.Insert(key, std::to_string(key));
+  }
+  ASSERT_TRUE(map.Erase(3));
+  ASSERT_FALSE(map.Erase(3));
+  ASSERT_FALSE(map.Contains(3));
+  ASSERT_EQ(map.Get(4), "4");
+  map.Insert(100, "100");
+  ASSERT_EQ(map.Size(), 8);
+  ASSERT_TRUE(map.IsBalanced());
+}
+
+TEST(OrderedMapTest, FromSortedBuildsBalancedTree) {
+  std::vector<std::pair<int, int>> entries;
+  for (int key = 0; key < 1023; key++) {
+    entries.emplace_back(key, key * key);
+  }
+  auto map = nll::binary_tree::OrderedMap<int, int>::FromSorted(entries);
+  ASSERT_EQ(map.Size(), 1023);
+  ASSERT_TRUE(map.IsBalanced());
+  ASSERT_EQ(map.Get(31), 961);
+  int expected = 0;
+  for (auto entry : map) {
+    ASSERT_EQ(entry.first, expected++);
+  }
+  map.Insert(2000, 0);
+  map.Erase(0);
+  ASSERT_TRUE(map.IsBalanced());
+}
+
+TEST(OrderedMapTest, FromSortedRejectsUnsortedInput) {
+  using Map = nll::binary_tree::OrderedMap<int, int>;
+  ASSERT_THROW(Map::FromSorted({{2, 0}, {1, 0}}), std::invalid_argument);
+  ASSERT_THROW(Map::FromSorted({{1, 0}, {1, 0}}), std::invalid_argument);
+}
+
+TEST(OrderedMapTest, MatchesStdMapUnderRandomOperations) {
+  nll::binary_tree::OrderedMap<int, int> map;
+  std::map<int, int> reference;
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> keys(0, 500);
+  for (int i = 0; i < 20000; i++) {
+    auto key = keys(rng);
+    if (rng() % 3 == 0) {
+      ASSERT_EQ(map.Erase(key), reference.erase(key) == 1);
+    } else {
+      map.Insert(key, i);
+      reference[key] = i;
+    }
+  }
+  ASSERT_TRUE(map.IsBalanced());
+  ASSERT_EQ(map.Size(), reference.size());
+  auto it = reference.begin();
+  for (auto entry : map) {
+    ASSERT_EQ(entry.first, it->first);
+    ASSERT_EQ(entry.second, it->second);
+    ++it;
+  }
+}
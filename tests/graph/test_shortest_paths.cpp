@@ -0,0 +1,119 @@
+#include "nll/graph/shortest_paths.hpp"
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "nll/graph/weighted_csr_graph.hpp"
+
+using Graph = nll::graph::WeightedCsrGraph<std::uint32_t>;
+
+// 0 --4--> 1 --1--> 3
+//  \--1--> 2 --2--/
+static Graph DiamondGraph() {
+  return Graph::FromEdges({{0, 1, 4}, {0, 2, 1}, {1, 3, 1}, {2, 3, 2}}, 5);
+}
+
+static Graph RandomGraph(std::uint32_t num_vertices, std::size_t num_edges) {
+  std::mt19937 rng(9);
+  std::uniform_int_distribution<std::uint32_t> pick(0, num_vertices - 1);
+  std::uniform_int_distribution<std::uint32_t> weight(1, 100);
+  std::vector<Graph::Edge> edges;
+  for (std::size_t i = 0; i < num_edges; i++) {
+    edges.push_back({pick(rng), pick(rng), weight(rng)});
+  }
+  return Graph::FromEdges(edges, num_vertices);
+}
+
+TEST(DijkstraTest, FindsShortestPath) {
+  auto graph = DiamondGraph();
+  nll::graph::Dijkstra<Graph> dijkstra(graph);
+  dijkstra.Run(0);
+  ASSERT_EQ(dijkstra.Distance(3), 3u);
+  ASSERT_EQ(dijkstra.PathTo(3), (std::vector<std::uint32_t>{0, 2, 3}));
+  ASSERT_FALSE(dijkstra.Reached(4));
+  ASSERT_TRUE(dijkstra.PathTo(4).empty());
+}
+
+TEST(DijkstraTest, RerunResetsState) {
+  auto graph = DiamondGraph();
+  nll::graph::Dijkstra<Graph> dijkstra(graph);
+  dijkstra.Run(0);
+  dijkstra.Run(1);
+  ASSERT_FALSE(dijkstra.Reached(0));
+  ASSERT_FALSE(dijkstra.Reached(2));
+  ASSERT_EQ(dijkstra.Distance(3), 1u);
+}
+
+TEST(DijkstraTest, EarlyExitSettlesTarget) {
+  auto graph = DiamondGraph();
+  nll::graph::Dijkstra<Graph> dijkstra(graph);
+  dijkstra.Run(0, 2);
+  ASSERT_EQ(dijkstra.Distance(2), 1u);
+}
+
+TEST(DijkstraTest, OutOfRangeSourceThrows) {
+  auto graph = DiamondGraph();
+  nll::graph::Dijkstra<Graph> dijkstra(graph);
+  ASSERT_THROW(dijkstra.Run(5), std::out_of_range);
+}
+
+TEST(DeltaSteppingTest, MatchesDijkstra) {
+  auto graph = RandomGraph(2000, 10000);
+  nll::graph::Dijkstra<Graph> dijkstra(graph);
+  for (unsigned threads : {1u, 4u}) {
+    nll::graph::DeltaSteppingOptions options;
+    options.num_threads = threads;
+    options.delta = 32;
+    nll::graph::DeltaStepping<Graph> delta_stepping(graph, options);
+    for (std::uint32_t source : {0u, 1234u}) {
+      dijkstra.Run(source);
+      delta_stepping.Run(source);
+      for (std::uint32_t v = 0; v < 2000; v++) {
+        ASSERT_EQ(delta_stepping.Distance(v), dijkstra.Distance(v));
+      }
+    }
+  }
+}
+
+TEST(DeltaSteppingTest, LongPathReusesBuckets) {
+  // Distances reach bucket 10^6 while at most 101 buckets are ever pending,
+  // so the bucket ring wraps many times over
+  constexpr std::uint32_t kLength = 10000;
+  std::vector<Graph::Edge> edges;
+  for (std::uint32_t v = 0; v + 1 < kLength; v++) {
+    edges.push_back({v, v + 1, 100});
+    if (v + 2 < kLength) {
+      edges.push_back({v, v + 2, 250});
+    }
+  }
+  auto graph = Graph::FromEdges(edges, kLength);
+  nll::graph::Dijkstra<Graph> dijkstra(graph);
+  dijkstra.Run(0);
+  nll::graph::DeltaSteppingOptions options;
+  options.num_threads = 2;
+  nll::graph::DeltaStepping<Graph> delta_stepping(graph, options);
+  delta_stepping.Run(0);
+  for (std::uint32_t v = 0; v < kLength; v++) {
+    ASSERT_EQ(delta_stepping.Distance(v), dijkstra.Distance(v));
+  }
+}
+
+TEST(DeltaSteppingTest, FloatingWeights) {
+  auto graph = nll::graph::WeightedCsrGraph<double>::FromEdges(
+      {{0, 1, 0.25}, {1, 2, 0.5}, {0, 2, 1.0}}, 3);
+  nll::graph::DeltaStepping<decltype(graph)> delta_stepping(graph);
+  delta_stepping.Run(0);
+  ASSERT_DOUBLE_EQ(delta_stepping.Distance(2), 0.75);
+}
+
+TEST(DeltaSteppingTest, NonPositiveDeltaThrows) {
+  auto graph = DiamondGraph();
+  nll::graph::DeltaSteppingOptions options;
+  options.delta = 0;
+  ASSERT_THROW(nll::graph::DeltaStepping<Graph>(graph, options),
+               std::invalid_argument);
+}
@@ -0,0 +1,155 @@
+#include "nll/graph/skip_list.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using IntSkipList = nll::binary_tree::ConcurrentSkipList<int, int>;
+
+std::vector<int> KeysOf(const IntSkipList& list) {
+  std::vector<int> keys;
+  list.ForEach([&](int key, int) { keys.push_back(key); });
+  return keys;
+}
+
+}  // namespace
+
+TEST(ConcurrentSkipListTest, EmptyListIsEmpty) {
+  IntSkipList list;
+  ASSERT_TRUE(list.Empty());
+  ASSERT_FALSE(list.Find(0));
+  ASSERT_FALSE(list.LowerBound(0));
+  ASSERT_FALSE(list.Erase(0));
+}
+
+TEST(ConcurrentSkipListTest, InsertKeepsFirstValue) {
+  nll::binary_tree::ConcurrentSkipList<std::string, std::string> list;
+  ASSERT_TRUE(list.Insert("key", "first"));
+  ASSERT_FALSE(list.Insert("key", "second"));
+  ASSERT_EQ(list.Size(), 1);
+  ASSERT_EQ(list.Find("key"), "first");
+  ASSERT_TRUE(list.Erase("key"));
+  ASSERT_TRUE(list.Insert("key", "second"));
+  ASSERT_EQ(list.Find("key"), "second");
+}
+
+TEST(ConcurrentSkipListTest, MatchesStdMapUnderRandomEdits) {
+  IntSkipList list;
+  std::map<int, int> expected;
+  std::mt19937 random(5);
+  std::uniform_int_distribution<int> keys(0, 999);
+  for (int i = 0; i < 20000; i++) {
+    auto key = keys(random);
+    if (random() % 3 == 0) {
+      ASSERT_EQ(list.Erase(key), expected.erase(key) == 1);
+    } else {
+      ASSERT_EQ(list.Insert(key, i), expected.emplace(key, i).second);
+    }
+    auto probe = keys(random);
+    auto bound = list.LowerBound(probe);
+    auto it = expected.lower_bound(probe);
+    ASSERT_EQ(bound.has_value(), it != expected.end());
+    if (bound) {
+      ASSERT_EQ(*bound, (std::pair<int, int>(*it)));
+    }
+  }
+  ASSERT_EQ(list.Size(), expected.size());
+  std::vector<int> expected_keys;
+  for (const auto& entry : expected) {
+    expected_keys.push_back(entry.first);
+  }
+  ASSERT_EQ(KeysOf(list), expected_keys);
+}
+
+TEST(ConcurrentSkipListTest, ScanStopsWhenAsked) {
+  IntSkipList list;
+  for (int key = 0; key < 100; key += 2) {
+    list.Insert(key, key);
+  }
+  std::vector<int> keys;
+  auto visited = list.Scan(31, [&](int key, int) {
+    keys.push_back(key);
+    return keys.size() < 5;
+  });
+  ASSERT_EQ(visited, 5);
+  ASSERT_EQ(keys, (std::vector<int>{32, 34, 36, 38, 40}));
+}
+
+TEST(ConcurrentSkipListTest, ConcurrentInsertsAllLand) {
+  IntSkipList list;
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 5000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < kPerThread; i++) {
+        ASSERT_TRUE(list.Insert(i * kThreads + t, t));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(list.Size(), kThreads * kPerThread);
+  auto keys = KeysOf(list);
+  ASSERT_EQ(keys.size(), static_cast<std::size_t>(kThreads * kPerThread));
+  for (std::size_t i = 0; i < keys.size(); i++) {
+    ASSERT_EQ(keys[i], static_cast<int>(i));
+  }
+}
+
+TEST(ConcurrentSkipListTest, ScansSeeStableKeysDuringChurn) {
+  // Even keys stay put while writers insert and erase odd ones around them;
+  // every scan must see each even key exactly once and in order
+  IntSkipList list;
+  constexpr int kKeys = 2000;
+  for (int key = 0; key < kKeys; key += 2) {
+    list.Insert(key, key);
+  }
+  std::atomic<bool> done{false};
+  std::vector<std::thread> writers;
+  for (int t = 0; t < 2; t++) {
+    writers.emplace_back([&, t] {
+      std::mt19937 random(t);
+      for (int i = 0; i < 20000; i++) {
+        auto key = static_cast<int>(random() % (kKeys / 2)) * 2 + 1;
+        if (random() % 2 == 0) {
+          list.Insert(key, key);
+        } else {
+          list.Erase(key);
+        }
+      }
+    });
+  }
+  std::thread reader([&] {
+    while (!done.load()) {
+      int expected = 0;
+      int previous = -1;
+      list.Scan(0, [&](int key, int value) {
+        EXPECT_GT(key, previous);
+        EXPECT_EQ(key, value);
+        previous = key;
+        if (key % 2 == 0) {
+          EXPECT_EQ(key, expected);
+          expected += 2;
+        }
+        return true;
+      });
+      EXPECT_EQ(expected, kKeys);
+    }
+  });
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  done = true;
+  reader.join();
+}
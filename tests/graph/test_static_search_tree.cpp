@@ -0,0 +1,101 @@
+#include "nll/graph/static_search_tree.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using nll::binary_tree::SearchTreeLayout;
+using nll::binary_tree::StaticSearchTree;
+
+class StaticSearchTreeTest
+    : public testing::TestWithParam<SearchTreeLayout> {};
+
+TEST_P(StaticSearchTreeTest, EmptyTree) {
+  std::vector<int> empty;
+  StaticSearchTree<int> tree(empty.begin(), empty.end(), GetParam());
+  ASSERT_TRUE(tree.Empty());
+  ASSERT_EQ(tree.LowerBound(3), 0);
+  ASSERT_FALSE(tree.Contains(3));
+}
+
+TEST_P(StaticSearchTreeTest, MatchesStdLowerBoundForEverySize) {
+  for (std::size_t size = 1; size < 70; size++) {
+    std::vector<int> sorted;
+    for (std::size_t i = 0; i < size; i++) {
+      sorted.push_back(static_cast<int>(3 * i));
+    }
+    StaticSearchTree<int> tree(sorted.begin(), sorted.end(), GetParam());
+    ASSERT_EQ(tree.Size(), size);
+    for (int key = -1; key <= static_cast<int>(3 * size); key++) {
+      auto expected = std::lower_bound(sorted.begin(), sorted.end(), key) -
+                      sorted.begin();
+      ASSERT_EQ(tree.LowerBound(key), expected) << size << " " << key;
+      ASSERT_EQ(tree.Contains(key), key % 3 == 0 && key >= 0 &&
+                                        key < static_cast<int>(3 * size));
+    }
+  }
+}
+
+TEST_P(StaticSearchTreeTest, DuplicatesReturnFirstRank) {
+  std::vector<std::uint64_t> sorted = {1, 2, 2, 2, 5, 5, 9};
+  StaticSearchTree<std::uint64_t> tree(sorted.begin(), sorted.end(),
+                                       GetParam());
+  ASSERT_EQ(tree.LowerBound(2), 1);
+  ASSERT_EQ(tree.LowerBound(5), 4);
+  ASSERT_EQ(tree.LowerBound(9), 6);
+  ASSERT_EQ(tree.LowerBound(10), 7);
+}
+
+TEST_P(StaticSearchTreeTest, RandomKeys) {
+  std::mt19937 rng(11);
+  std::vector<std::uint32_t> sorted(5000);
+  for (auto& key : sorted) {
+    key = rng() % 100000;
+  }
+  std::sort(sorted.begin(), sorted.end());
+  StaticSearchTree<std::uint32_t> tree(sorted.begin(), sorted.end(),
+                                       GetParam());
+  for (int i = 0; i < 5000; i++) {
+    auto key = rng() % 100001;
+    auto expected = std::lower_bound(sorted.begin(), sorted.end(), key) -
+                    sorted.begin();
+    ASSERT_EQ(tree.LowerBound(key), expected);
+  }
+}
+
+TEST_P(StaticSearchTreeTest, BuildsFromNodeTree) {
+  using Node = nll::binary_tree::Node<int>;
+  auto root = new Node(4);
+  root->left = new Node(2);
+  root->left->left = new Node(1);
+  root->right = new Node(6);
+  root->right->right = new Node(8);
+  StaticSearchTree<int> tree(root, GetParam());
+  ASSERT_EQ(tree.Size(), 5);
+  ASSERT_EQ(tree.LowerBound(5), 3);
+  ASSERT_TRUE(tree.Contains(8));
+  ASSERT_FALSE(tree.Contains(7));
+
+  // Swapping children breaks the search tree order
+  std::swap(root->left, root->right);
+  ASSERT_THROW(StaticSearchTree<int>(root, GetParam()), std::invalid_argument);
+  delete root->right->left;
+  delete root->right;
+  delete root->left->right;
+  delete root->left;
+  delete root;
+}
+
+TEST(StaticSearchTreeLayoutTest, RejectsUnsortedRange) {
+  std::vector<int> unsorted = {1, 3, 2};
+  ASSERT_THROW(StaticSearchTree<int>(unsorted.begin(), unsorted.end()),
+               std::invalid_argument);
+}
+
+INSTANTIATE_TEST_SUITE_P(Layouts, StaticSearchTreeTest,
+                         testing::Values(SearchTreeLayout::kEytzinger,
+                                         SearchTreeLayout::kVanEmdeBoas));
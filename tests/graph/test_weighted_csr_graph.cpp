@@ -0,0 +1,46 @@
+#include "nll/graph/weighted_csr_graph.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using Graph = nll::graph::WeightedCsrGraph<double>;
+
+TEST(WeightedCsrGraphTest, WeightsFollowNeighbors) {
+  auto graph = Graph::FromEdges({{0, 1, 1.5}, {1, 2, 2.5}, {0, 2, 4.0}}, 3);
+  ASSERT_EQ(graph.NumEdges(), 3);
+  auto neighbors = graph.Neighbors(0);
+  auto weights = graph.Weights(0);
+  ASSERT_EQ(neighbors.size(), 2);
+  for (std::size_t i = 0; i < neighbors.size(); i++) {
+    ASSERT_EQ(weights[i], neighbors[i] == 1 ? 1.5 : 4.0);
+  }
+}
+
+TEST(WeightedCsrGraphTest, DeduplicateKeepsLightestEdge) {
+  nll::graph::CsrBuildOptions options;
+  options.symmetrize = true;
+  options.deduplicate = true;
+  auto graph = Graph::FromEdges({{0, 1, 3.0}, {1, 0, 1.0}, {0, 1, 2.0}}, 2,
+                                options);
+  ASSERT_EQ(graph.NumEdges(), 2);
+  ASSERT_EQ(graph.Weights(0)[0], 1.0);
+  ASSERT_EQ(graph.Weights(1)[0], 1.0);
+}
+
+TEST(WeightedCsrGraphTest, NegativeWeightThrows) {
+  ASSERT_THROW(Graph::FromEdges({{0, 1, -1.0}}, 2), std::invalid_argument);
+}
+
+TEST(WeightedCsrGraphTest, NanWeightThrows) {
+  ASSERT_THROW(
+      Graph::FromEdges({{0, 1, std::numeric_limits<double>::quiet_NaN()}}, 2),
+      std::invalid_argument);
+}
+
+TEST(WeightedCsrGraphTest, OutOfRangeEdgeThrows) {
+  ASSERT_THROW(Graph::FromEdges({{0, 2, 1.0}}, 2), std::out_of_range);
+}
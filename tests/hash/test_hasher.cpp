@@ -0,0 +1,112 @@
+#include "nll/hash/hasher.hpp"
+
+#include <bitset>
+#include <cstdint>
+#include <memory_resource>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "nll/hash/hash_bytes.hpp"
+#include "nll/hash/mix.hpp"
+
+namespace {
+
+int BitsFlipped(std::uint64_t a, std::uint64_t b) {
+  return static_cast<int>(std::bitset<64>(a ^ b).count());
+}
+
+}  // namespace
+
+TEST(HashBytesTest, EveryLengthAndSeedHashesApart) {
+  // Lengths around every branch: short reads, 16-byte rounds, 48-byte rounds
+  std::string bytes(200, 'x');
+  std::set<std::uint64_t> hashes;
+  for (std::size_t length = 0; length <= bytes.size(); length++) {
+    hashes.insert(nll::hash::HashBytes(bytes.data(), length));
+    hashes.insert(nll::hash::HashBytes(bytes.data(), length, 1));
+  }
+  ASSERT_EQ(hashes.size(), 2 * (bytes.size() + 1));
+  ASSERT_EQ(nll::hash::HashBytes(bytes.data(), 100),
+            nll::hash::HashBytes(std::string(100, 'x').data(), 100));
+}
+
+TEST(HashBytesTest, OneBitFlipsAboutHalfTheHash) {
+  std::vector<std::uint8_t> bytes(64, 0);
+  for (std::size_t length : {1, 3, 8, 13, 16, 31, 48, 64}) {
+    auto base = nll::hash::HashBytes(bytes.data(), length);
+    int flipped = 0;
+    for (std::size_t bit = 0; bit < length * 8; bit++) {
+      bytes[bit / 8] ^= static_cast<std::uint8_t>(1 << (bit % 8));
+      flipped += BitsFlipped(base, nll::hash::HashBytes(bytes.data(), length));
+      bytes[bit / 8] ^= static_cast<std::uint8_t>(1 << (bit % 8));
+    }
+    auto mean = static_cast<double>(flipped) / (length * 8);
+    ASSERT_GT(mean, 24) << length;
+    ASSERT_LT(mean, 40) << length;
+  }
+}
+
+TEST(MixTest, Mix64SpreadsSequentialKeys) {
+  int flipped = 0;
+  for (std::uint64_t key = 0; key < 1000; key++) {
+    flipped += BitsFlipped(nll::hash::Mix64(key), nll::hash::Mix64(key + 1));
+  }
+  ASSERT_GT(flipped / 1000.0, 28);
+  ASSERT_LT(flipped / 1000.0, 36);
+  ASSERT_NE(nll::hash::Mix32(1), nll::hash::Mix32(2));
+}
+
+TEST(MixTest, FastRangeStaysInRange) {
+  for (std::uint64_t key = 0; key < 1000; key++) {
+    ASSERT_LT(nll::hash::FastRange64(nll::hash::Mix64(key), 7), 7);
+    ASSERT_LT(nll::hash::FastRange32(nll::hash::Mix32(key), 7), 7);
+  }
+  ASSERT_EQ(nll::hash::FastRange64(~std::uint64_t{0}, 10), 9);
+}
+
+TEST(HasherTest, StringsHashAlikeAcrossTypes) {
+  std::pmr::string pmr_string("a longer string that allocates");
+  std::string string(pmr_string.data(), pmr_string.size());
+  ASSERT_EQ(nll::hash::Hasher<std::string>{}(string),
+            nll::hash::Hasher<std::pmr::string>{}(pmr_string));
+  ASSERT_EQ(nll::hash::Hasher<std::string>{}(string),
+            nll::hash::Hasher<std::string_view>{}(string));
+}
+
+TEST(HasherTest, EveryHasherAvalanches) {
+  enum class Color { kRed, kGreen };
+  ASSERT_TRUE(nll::hash::kIsAvalanching<nll::hash::Hasher<int>>);
+  ASSERT_TRUE(nll::hash::kIsAvalanching<nll::hash::Hasher<Color>>);
+  ASSERT_TRUE(nll::hash::kIsAvalanching<nll::hash::Hasher<int*>>);
+  ASSERT_TRUE(nll::hash::kIsAvalanching<nll::hash::Hasher<double>>);
+  ASSERT_FALSE(nll::hash::kIsAvalanching<std::hash<int>>);
+  ASSERT_NE(nll::hash::Hasher<Color>{}(Color::kRed),
+            nll::hash::Hasher<Color>{}(Color::kGreen));
+}
+
+TEST(HashBatchTest, MatchesOneAtATime) {
+  std::vector<std::int32_t> keys;
+  for (std::int32_t i = -50; i < 53; i++) {
+    keys.push_back(i * 4096);
+  }
+  std::vector<std::uint64_t> hashes(keys.size());
+  nll::hash::Hasher<std::int32_t> hasher;
+  nll::hash::HashBatch(hasher, keys.data(), keys.size(), hashes.data());
+  for (std::size_t i = 0; i < keys.size(); i++) {
+    ASSERT_EQ(hashes[i], hasher(keys[i]));
+  }
+}
+
+TEST(HashBatchTest, MixesHashersThatDoNotAvalanche) {
+  std::uint64_t keys[] = {1, 2, 3};
+  std::uint64_t hashes[3];
+  nll::hash::HashBatch(std::hash<std::uint64_t>{}, keys, 3, hashes);
+  for (std::size_t i = 0; i < 3; i++) {
+    ASSERT_EQ(hashes[i],
+              nll::hash::Mix64(std::hash<std::uint64_t>{}(keys[i])));
+  }
+}
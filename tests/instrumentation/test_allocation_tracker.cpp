@@ -0,0 +1,66 @@
+#include "nll/instrumentation/allocation_tracker.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// The test binary gets its operator new and delete from here
+#include "nll/instrumentation/allocation_hooks.hpp"
+
+using nll::instrumentation::AllocationTracker;
+
+TEST(AllocationTrackerTest, HooksAreEnabled) {
+  ASSERT_TRUE(AllocationTracker::Enabled());
+}
+
+TEST(AllocationTrackerTest, CountsNewAndDelete) {
+  auto before = AllocationTracker::Snapshot();
+  auto* value = new std::uint64_t(7);
+  auto during = AllocationTracker::Snapshot() - before;
+  delete value;
+  auto after = AllocationTracker::Snapshot() - before;
+  ASSERT_EQ(during.allocations, 1);
+  ASSERT_EQ(during.bytes_allocated, sizeof(std::uint64_t));
+  ASSERT_EQ(after.deallocations, 1);
+  ASSERT_EQ(after.bytes_freed, sizeof(std::uint64_t));
+}
+
+TEST(AllocationTrackerTest, CountsArraysAndAlignedAllocations) {
+  struct alignas(64) Line {
+    char bytes[64];
+  };
+  auto before = AllocationTracker::Snapshot();
+  auto* array = new int[10];
+  auto* line = new Line();
+  ASSERT_EQ(reinterpret_cast<std::uintptr_t>(line) % 64, 0);
+  auto during = AllocationTracker::Snapshot() - before;
+  delete line;
+  delete[] array;
+  auto after = AllocationTracker::Snapshot() - before;
+  ASSERT_EQ(during.allocations, 2);
+  ASSERT_EQ(during.bytes_allocated, 10 * sizeof(int) + sizeof(Line));
+  ASSERT_EQ(after.bytes_freed, during.bytes_allocated);
+}
+
+TEST(AllocationTrackerTest, TracksPeakLiveBytes) {
+  AllocationTracker::ResetPeak();
+  auto base = AllocationTracker::Snapshot();
+  {
+    std::vector<char> big(1 << 20);
+    std::vector<char> small(1 << 10);
+  }
+  auto after = AllocationTracker::Snapshot();
+  ASSERT_GE(after.peak_live_bytes, base.LiveBytes() + (1 << 20) + (1 << 10));
+  ASSERT_EQ(after.LiveBytes(), base.LiveBytes());
+}
+
+TEST(AllocationTrackerTest, NoThrowNewReturnsMemory) {
+  auto before = AllocationTracker::Snapshot();
+  auto* value = new (std::nothrow) int(3);
+  ASSERT_NE(value, nullptr);
+  delete value;
+  ASSERT_EQ((AllocationTracker::Snapshot() - before).allocations, 1);
+}
@@ -0,0 +1,23 @@
+#include "nll/instrumentation/perf_counters.hpp"
+
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+TEST(PerfCountersTest, CountsWorkWhenAvailable) {
+  nll::instrumentation::PerfCounters counters;
+  counters.Start();
+  volatile std::uint64_t sum = 0;
+  for (int i = 0; i < 100000; i++) {
+    sum = sum + i;
+  }
+  auto values = counters.Stop();
+  if (!counters.Available()) {
+    // Unavailable counters must read as zero rather than fail
+    ASSERT_EQ(values.cycles, 0);
+    ASSERT_EQ(values.instructions, 0);
+    GTEST_SKIP() << "perf_event_open is not available here";
+  }
+  ASSERT_GT(values.cycles, 0);
+  ASSERT_GT(values.instructions, 100000);
+}
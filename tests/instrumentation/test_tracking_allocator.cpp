@@ -0,0 +1,47 @@
+#include "nll/instrumentation/tracking_allocator.hpp"
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using nll::instrumentation::MemoryStats;
+using nll::instrumentation::TrackingAllocator;
+
+TEST(TrackingAllocatorTest, ReportsLiveAndPeakBytes) {
+  MemoryStats stats;
+  {
+    std::vector<int, TrackingAllocator<int>> vector{
+        TrackingAllocator<int>(&stats)};
+    vector.reserve(100);
+    ASSERT_EQ(stats.live_bytes, 100 * sizeof(int));
+    vector.shrink_to_fit();
+    vector.clear();
+    vector.shrink_to_fit();
+    ASSERT_EQ(stats.live_bytes, 0);
+  }
+  ASSERT_EQ(stats.peak_bytes, 100 * sizeof(int));
+  ASSERT_EQ(stats.allocations, stats.deallocations);
+}
+
+TEST(TrackingAllocatorTest, ReboundCopiesShareStats) {
+  MemoryStats stats;
+  using Allocator = TrackingAllocator<std::pair<const int, int>>;
+  std::map<int, int, std::less<int>, Allocator> map{Allocator(&stats)};
+  for (int i = 0; i < 10; i++) {
+    map[i] = i;
+  }
+  // Nodes are allocated through a rebound copy
+  ASSERT_EQ(stats.allocations, 10);
+  ASSERT_GT(stats.live_bytes, 10 * sizeof(std::pair<const int, int>));
+  map.clear();
+  ASSERT_EQ(stats.live_bytes, 0);
+}
+
+TEST(TrackingAllocatorTest, EqualityFollowsStats) {
+  MemoryStats a;
+  MemoryStats b;
+  ASSERT_TRUE(TrackingAllocator<int>(&a) == TrackingAllocator<long>(&a));
+  ASSERT_TRUE(TrackingAllocator<int>(&a) != TrackingAllocator<int>(&b));
+}
@@ -0,0 +1,70 @@
+#include "nll/memory/epoch_domain.hpp"
+
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+void CountReclaim(void*, void* counter) {
+  static_cast<std::atomic<int>*>(counter)->fetch_add(1);
+}
+
+}  // namespace
+
+TEST(EpochDomainTest, PinnedThreadHoldsBackReclamation) {
+  nll::memory::EpochDomain domain;
+  std::atomic<int> reclaimed{0};
+  int object = 0;
+  auto reader = domain.Pin();
+  {
+    auto writer = domain.Pin();
+    writer.Retire(&object, CountReclaim, &reclaimed);
+  }
+  for (int i = 0; i < 10; i++) {
+    domain.Collect();
+  }
+  ASSERT_EQ(reclaimed.load(), 0);
+  reader = domain.Pin();
+  {
+    // The old reader slot is released once the moved-from guard is gone
+    auto released = std::move(reader);
+  }
+  for (int i = 0; i < 10; i++) {
+    domain.Collect();
+  }
+  ASSERT_EQ(reclaimed.load(), 1);
+}
+
+TEST(EpochDomainTest, DestructionReclaimsTheRest) {
+  std::atomic<int> reclaimed{0};
+  int objects[3] = {};
+  {
+    nll::memory::EpochDomain domain;
+    auto guard = domain.Pin();
+    for (auto& object : objects) {
+      guard.Retire(&object, CountReclaim, &reclaimed);
+    }
+  }
+  ASSERT_EQ(reclaimed.load(), 3);
+}
+
+TEST(EpochDomainTest, RetireDeletesInBatches) {
+  nll::memory::EpochDomain domain;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < 10000; i++) {
+        auto guard = domain.Pin();
+        guard.Retire(new int(i));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_GT(domain.Epoch(), 2);
+}
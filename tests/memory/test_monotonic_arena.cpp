@@ -0,0 +1,144 @@
+#include "nll/memory/monotonic_arena.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using nll::memory::MonotonicArena;
+
+namespace {
+
+/// @brief Upstream resource counting what the arena takes from it
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  std::size_t allocations = 0;
+  std::size_t live_bytes = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    allocations++;
+    live_bytes += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* pointer, std::size_t bytes,
+                     std::size_t alignment) override {
+    live_bytes -= bytes;
+    std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+  }
+
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+bool IsAligned(void* pointer, std::size_t alignment) {
+  return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+}
+
+}  // namespace
+
+TEST(MonotonicArenaTest, BumpsWithinAChunk) {
+  CountingResource upstream;
+  MonotonicArena arena(1024, &upstream);
+  auto* first = static_cast<char*>(arena.allocate(16, 1));
+  auto* second = static_cast<char*>(arena.allocate(16, 1));
+  ASSERT_EQ(second, first + 16);
+  ASSERT_EQ(upstream.allocations, 1);
+  ASSERT_EQ(arena.BytesUsed(), 32);
+}
+
+TEST(MonotonicArenaTest, RespectsAlignment) {
+  MonotonicArena arena;
+  ASSERT_NE(arena.allocate(1, 1), nullptr);
+  for (std::size_t alignment : {2, 8, 16, 64, 256}) {
+    ASSERT_TRUE(IsAligned(arena.allocate(3, alignment), alignment))
+        << alignment;
+  }
+}
+
+TEST(MonotonicArenaTest, GrowsChunksGeometrically) {
+  CountingResource upstream;
+  MonotonicArena arena(256, &upstream);
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_NE(arena.allocate(64, 8), nullptr);
+  }
+  // 64000 bytes from doubling chunks starting at 256
+  ASSERT_LE(upstream.allocations, 10);
+  ASSERT_EQ(upstream.live_bytes, arena.BytesReserved());
+}
+
+TEST(MonotonicArenaTest, ServesOversizedRequests) {
+  CountingResource upstream;
+  MonotonicArena arena(256, &upstream);
+  auto* block = arena.allocate(100000, 64);
+  ASSERT_TRUE(IsAligned(block, 64));
+  ASSERT_GE(arena.BytesReserved(), 100000);
+}
+
+TEST(MonotonicArenaTest, ResetKeepsMemoryForTheNextRound) {
+  CountingResource upstream;
+  MonotonicArena arena(256, &upstream);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_NE(arena.allocate(64, 8), nullptr);
+  }
+  arena.Reset();
+  auto allocations = upstream.allocations;
+  ASSERT_EQ(arena.BytesUsed(), 0);
+  ASSERT_GT(arena.BytesReserved(), 6400);
+  for (int round = 0; round < 10; round++) {
+    for (int i = 0; i < 100; i++) {
+      ASSERT_NE(arena.allocate(64, 8), nullptr);
+    }
+    arena.Reset();
+  }
+  ASSERT_EQ(upstream.allocations, allocations);
+}
+
+TEST(MonotonicArenaTest, ReleaseReturnsEverything) {
+  CountingResource upstream;
+  {
+    MonotonicArena arena(256, &upstream);
+    ASSERT_NE(arena.allocate(1000, 8), nullptr);
+    arena.Release();
+    ASSERT_EQ(upstream.live_bytes, 0);
+    ASSERT_EQ(arena.BytesReserved(), 0);
+    ASSERT_NE(arena.allocate(1000, 8), nullptr);
+  }
+  ASSERT_EQ(upstream.live_bytes, 0);
+}
+
+TEST(MonotonicArenaTest, UsesInitialBufferFirst) {
+  CountingResource upstream;
+  alignas(16) std::byte buffer[512];
+  MonotonicArena arena(buffer, sizeof(buffer), &upstream);
+  auto* block = static_cast<std::byte*>(arena.allocate(256, 16));
+  ASSERT_GE(block, buffer);
+  ASSERT_LT(block, buffer + sizeof(buffer));
+  ASSERT_EQ(upstream.allocations, 0);
+  ASSERT_NE(arena.allocate(512, 16), nullptr);
+  ASSERT_EQ(upstream.allocations, 1);
+  arena.Release();
+  ASSERT_EQ(arena.allocate(16, 16), buffer);
+}
+
+TEST(MonotonicArenaTest, BacksPmrContainers) {
+  CountingResource upstream;
+  MonotonicArena arena(4096, &upstream);
+  {
+    std::pmr::vector<int> values(&arena);
+    for (int i = 0; i < 100; i++) {
+      values.push_back(i);
+    }
+    ASSERT_EQ(values[99], 99);
+  }
+  ASSERT_GT(arena.BytesUsed(), 100 * sizeof(int));
+  ASSERT_EQ(upstream.allocations, 1);
+  ASSERT_TRUE(arena.is_equal(arena));
+  MonotonicArena other;
+  ASSERT_FALSE(arena.is_equal(other));
+}
@@ -0,0 +1,73 @@
+#include "nll/parallel/chase_lev_deque.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(ChaseLevDequeTest, OwnerPopsLifoThievesStealFifo) {
+  nll::parallel::ChaseLevDeque<int> deque;
+  ASSERT_TRUE(deque.Empty());
+  ASSERT_EQ(deque.Pop(), std::nullopt);
+  ASSERT_EQ(deque.Steal(), std::nullopt);
+  deque.Push(1);
+  deque.Push(2);
+  deque.Push(3);
+  ASSERT_EQ(deque.Size(), 3);
+  ASSERT_EQ(deque.Pop(), 3);
+  ASSERT_EQ(deque.Steal(), 1);
+  ASSERT_EQ(deque.Pop(), 2);
+  ASSERT_TRUE(deque.Empty());
+}
+
+TEST(ChaseLevDequeTest, Grows) {
+  nll::parallel::ChaseLevDeque<int> deque(4);
+  ASSERT_EQ(deque.Capacity(), 4);
+  for (int i = 0; i < 100; i++) {
+    deque.Push(i);
+  }
+  ASSERT_GE(deque.Capacity(), 100);
+  for (int i = 0; i < 50; i++) {
+    ASSERT_EQ(deque.Steal(), i);
+  }
+  for (int i = 99; i >= 50; i--) {
+    ASSERT_EQ(deque.Pop(), i);
+  }
+}
+
+TEST(ChaseLevDequeTest, EveryElementTakenOnceUnderContention) {
+  constexpr int kElements = 100000;
+  constexpr int kThieves = 3;
+  nll::parallel::ChaseLevDeque<int> deque(16);
+  std::vector<std::atomic<int>> taken(kElements);
+  std::atomic<bool> done{false};
+  std::vector<std::thread> thieves;
+  for (int t = 0; t < kThieves; t++) {
+    thieves.emplace_back([&] {
+      while (!done.load() || !deque.Empty()) {
+        if (auto value = deque.Steal()) {
+          taken[*value]++;
+        }
+      }
+    });
+  }
+  for (int i = 0; i < kElements; i++) {
+    deque.Push(i);
+    if (i % 3 == 0) {
+      if (auto value = deque.Pop()) {
+        taken[*value]++;
+      }
+    }
+  }
+  while (auto value = deque.Pop()) {
+    taken[*value]++;
+  }
+  done = true;
+  for (auto& thief : thieves) {
+    thief.join();
+  }
+  for (int i = 0; i < kElements; i++) {
+    ASSERT_EQ(taken[i].load(), 1) << "element " << i;
+  }
+}
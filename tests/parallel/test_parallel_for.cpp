@@ -0,0 +1,102 @@
+#include "nll/parallel/parallel_for.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+nll::parallel::ThreadPoolOptions Threads(std::size_t threads) {
+  nll::parallel::ThreadPoolOptions options;
+  options.threads = threads;
+  return options;
+}
+
+}  // namespace
+
+TEST(ParallelForTest, VisitsEveryIndexOnce) {
+  nll::parallel::ThreadPool pool(Threads(4));
+  for (std::size_t grain : {0, 1, 7, 1000, 100000}) {
+    std::vector<int> visits(10000, 0);
+    nll::parallel::ParallelFor(
+        0, 10000, [&](int i) { visits[i]++; }, grain, pool);
+    for (int i = 0; i < 10000; i++) {
+      ASSERT_EQ(visits[i], 1) << "grain " << grain << " index " << i;
+    }
+  }
+}
+
+TEST(ParallelForTest, EmptyRange) {
+  int calls = 0;
+  nll::parallel::ParallelFor(5, 5, [&](int) { calls++; });
+  nll::parallel::ParallelFor(5, 2, [&](int) { calls++; });
+  ASSERT_EQ(calls, 0);
+}
+
+TEST(ParallelForTest, RangeChunksRespectGrain) {
+  nll::parallel::ThreadPool pool(Threads(4));
+  std::atomic<std::int64_t> covered{0};
+  std::atomic<bool> oversized{false};
+  nll::parallel::ParallelForRange(
+      std::int64_t{0}, std::int64_t{12345},
+      [&](std::int64_t first, std::int64_t last) {
+        covered += last - first;
+        if (last - first > 100) {
+          oversized = true;
+        }
+      },
+      100, pool);
+  ASSERT_EQ(covered.load(), 12345);
+  ASSERT_FALSE(oversized.load());
+}
+
+TEST(ParallelForTest, RethrowsBodyException) {
+  ASSERT_THROW(nll::parallel::ParallelFor(0, 1000,
+                                          [](int i) {
+                                            if (i == 567) {
+                                              throw std::out_of_range("567!");
+                                            }
+                                          }),
+               std::out_of_range);
+}
+
+TEST(ParallelReduceTest, Sum) {
+  nll::parallel::ThreadPool pool(Threads(4));
+  auto sum = nll::parallel::ParallelReduce(
+      std::int64_t{1}, std::int64_t{100001}, std::int64_t{0},
+      [](std::int64_t i) { return i; },
+      [](std::int64_t a, std::int64_t b) { return a + b; }, 0, pool);
+  ASSERT_EQ(sum, 5000050000);
+  ASSERT_EQ(nll::parallel::ParallelReduce(
+                3, 3, 42, [](int i) { return i; },
+                [](int a, int b) { return a + b; }),
+            42);
+}
+
+TEST(ParallelReduceTest, KeepsIndexOrder) {
+  // Concatenation is associative but not commutative
+  auto digits = nll::parallel::ParallelReduce(
+      0, 200, std::string(),
+      [](int i) { return std::string(1, static_cast<char>('0' + i % 10)); },
+      [](std::string a, const std::string& b) { return a + b; }, 3);
+  std::string expected;
+  for (int i = 0; i < 200; i++) {
+    expected += static_cast<char>('0' + i % 10);
+  }
+  ASSERT_EQ(digits, expected);
+}
+
+TEST(ParallelInvokeTest, RunsEveryFunction) {
+  int a = 0;
+  int b = 0;
+  int c = 0;
+  nll::parallel::ParallelInvoke([&] { a = 1; }, [&] { b = 2; },
+                                [&] { c = 3; });
+  ASSERT_EQ(a + b + c, 6);
+  nll::parallel::ParallelInvoke([&] { a = 10; });
+  ASSERT_EQ(a, 10);
+}
@@ -0,0 +1,203 @@
+#include "nll/parallel/pipeline.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using nll::parallel::BatchWriter;
+using nll::parallel::Channel;
+using nll::parallel::Generator;
+using nll::parallel::Pipeline;
+using nll::parallel::PipelineMode;
+using nll::parallel::Stage;
+
+Generator<int> Count(int n, int* produced = nullptr) {
+  for (int i = 0; i < n; i++) {
+    if (produced != nullptr) {
+      ++*produced;
+    }
+    co_yield i;
+  }
+}
+
+Generator<int> Evens(Generator<int> source) {
+  for (int value : source) {
+    if (value % 2 == 0) {
+      co_yield value;
+    }
+  }
+}
+
+Stage Square(Channel<int>& in, Channel<std::int64_t>& out) {
+  while (auto batch = co_await in.Receive()) {
+    std::vector<std::int64_t> squares;
+    for (int value : *batch) {
+      squares.push_back(static_cast<std::int64_t>(value) * value);
+    }
+    co_await out.Send(std::move(squares));
+  }
+  out.Close();
+}
+
+Stage Sum(Channel<std::int64_t>& in, std::int64_t& total) {
+  while (auto batch = co_await in.Receive()) {
+    for (auto value : *batch) {
+      total += value;
+    }
+  }
+}
+
+std::int64_t SquareSum(PipelineMode mode, int n) {
+  Pipeline pipeline(mode);
+  auto& numbers = pipeline.MakeChannel<int>();
+  auto& squares = pipeline.MakeChannel<std::int64_t>();
+  std::int64_t total = 0;
+  pipeline.Feed(Count(n), numbers, 64);
+  pipeline.Add(Square(numbers, squares));
+  pipeline.Add(Sum(squares, total));
+  pipeline.Run();
+  return total;
+}
+
+/// @brief Yields named strings and records what each holds after its
+/// co_yield, which a consumer moving from the yielded value must not change
+Generator<std::string> Words(std::vector<std::string>& after_yield) {
+  for (int i = 0; i < 3; i++) {
+    std::string word = "a word long enough to live on the heap " +
+                       std::to_string(i);
+    co_yield word;
+    after_yield.push_back(word);
+  }
+}
+
+Stage Collect(Channel<std::string>& in, std::vector<std::string>& out) {
+  while (auto batch = co_await in.Receive()) {
+    for (auto& word : *batch) {
+      out.push_back(std::move(word));
+    }
+  }
+}
+
+}  // namespace
+
+TEST(GeneratorTest, YieldsLazily) {
+  int produced = 0;
+  auto evens = Evens(Count(100, &produced));
+  ASSERT_EQ(produced, 0);
+  std::vector<int> seen;
+  for (int value : evens) {
+    seen.push_back(value);
+    if (seen.size() == 3) {
+      break;
+    }
+  }
+  ASSERT_EQ(seen, (std::vector<int>{0, 2, 4}));
+  ASSERT_EQ(produced, 5);
+}
+
+TEST(GeneratorTest, RethrowsFromTheCoroutine) {
+  auto failing = []() -> Generator<int> {
+    co_yield 1;
+    throw std::runtime_error("bad input");
+  }();
+  auto it = failing.begin();
+  ASSERT_EQ(*it, 1);
+  ASSERT_THROW(++it, std::runtime_error);
+}
+
+TEST(PipelineTest, FeedLeavesYieldedLvaluesIntact) {
+  Pipeline pipeline;
+  auto& words = pipeline.MakeChannel<std::string>();
+  std::vector<std::string> after_yield;
+  std::vector<std::string> received;
+  pipeline.Feed(Words(after_yield), words, 2);
+  pipeline.Add(Collect(words, received));
+  pipeline.Run();
+  ASSERT_EQ(received.size(), 3u);
+  ASSERT_EQ(after_yield, received);
+}
+
+TEST(PipelineTest, FusedMatchesLoop) {
+  std::int64_t expected = 0;
+  for (std::int64_t i = 0; i < 10000; i++) {
+    expected += i * i;
+  }
+  ASSERT_EQ(SquareSum(PipelineMode::kFused, 10000), expected);
+}
+
+TEST(PipelineTest, ThreadedMatchesFused) {
+  ASSERT_EQ(SquareSum(PipelineMode::kThreaded, 100000),
+            SquareSum(PipelineMode::kFused, 100000));
+}
+
+TEST(PipelineTest, FullChannelHoldsBackTheSender) {
+  // The sender may only run ahead by the channel's two batches, the one it
+  // waits to send and the one it is filling
+  constexpr std::size_t kBatch = 10;
+  Pipeline pipeline;
+  auto& channel = pipeline.MakeChannel<int, 2>();
+  int sent = 0;
+  int received = 0;
+  int max_ahead = 0;
+  pipeline.Add([](Channel<int, 2>& out, int& sent) -> Stage {
+    BatchWriter<int, 2> writer(out, kBatch);
+    for (int i = 0; i < 1000; i++) {
+      co_await writer.Push(i);
+      sent++;
+    }
+    co_await writer.Flush();
+    out.Close();
+  }(channel, sent));
+  pipeline.Add([](Channel<int, 2>& in, int& sent, int& received,
+                  int& max_ahead) -> Stage {
+    int expected = 0;
+    while (auto batch = co_await in.Receive()) {
+      for (int value : *batch) {
+        EXPECT_EQ(value, expected++);
+      }
+      max_ahead = std::max(max_ahead, sent - received);
+      received += static_cast<int>(batch->size());
+    }
+  }(channel, sent, received, max_ahead));
+  pipeline.Run();
+  ASSERT_EQ(received, 1000);
+  ASSERT_LE(max_ahead, static_cast<int>(4 * kBatch));
+}
+
+TEST(PipelineTest, FailingStageCancelsTheOthers) {
+  for (auto mode : {PipelineMode::kFused, PipelineMode::kThreaded}) {
+    Pipeline pipeline(mode);
+    auto& numbers = pipeline.MakeChannel<int, 1>();
+    // An endless source only stops if the pipeline cancels it
+    pipeline.Add([](Channel<int, 1>& out) -> Stage {
+      for (int i = 0;; i++) {
+        std::vector<int> batch(1, i);
+        co_await out.Send(std::move(batch));
+      }
+    }(numbers));
+    pipeline.Add([](Channel<int, 1>& in) -> Stage {
+      while (auto batch = co_await in.Receive()) {
+        if (batch->front() == 100) {
+          throw std::invalid_argument("bad record");
+        }
+      }
+    }(numbers));
+    ASSERT_THROW(pipeline.Run(), std::invalid_argument);
+  }
+}
+
+TEST(PipelineTest, FusedDeadlockIsReported) {
+  Pipeline pipeline;
+  auto& never = pipeline.MakeChannel<int>();
+  pipeline.Add([](Channel<int>& in) -> Stage {
+    co_await in.Receive();
+  }(never));
+  ASSERT_THROW(pipeline.Run(), std::logic_error);
+}
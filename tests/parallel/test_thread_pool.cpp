@@ -0,0 +1,119 @@
+#include "nll/parallel/thread_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+nll::parallel::ThreadPoolOptions Threads(std::size_t threads) {
+  nll::parallel::ThreadPoolOptions options;
+  options.threads = threads;
+  return options;
+}
+
+/// @brief Naive recursive Fibonacci, forking one branch per call
+int Fibonacci(nll::parallel::ThreadPool& pool, int n) {
+  if (n < 2) {
+    return n;
+  }
+  int first = 0;
+  nll::parallel::TaskGroup group(pool);
+  group.Run([&] { first = Fibonacci(pool, n - 1); });
+  int second = Fibonacci(pool, n - 2);
+  group.Wait();
+  return first + second;
+}
+
+}  // namespace
+
+TEST(ThreadPoolTest, WorkerCount) {
+  nll::parallel::ThreadPool pool(Threads(3));
+  ASSERT_EQ(pool.WorkerCount(), 3);
+  ASSERT_FALSE(pool.IsWorkerThread());
+  ASSERT_GE(nll::parallel::ThreadPool().WorkerCount(), 1);
+}
+
+TEST(ThreadPoolTest, TaskGroupRunsEveryTask) {
+  nll::parallel::ThreadPool pool(Threads(4));
+  std::atomic<int> sum{0};
+  nll::parallel::TaskGroup group(pool);
+  for (int i = 1; i <= 1000; i++) {
+    group.Run([&, i] { sum += i; });
+  }
+  group.Wait();
+  ASSERT_EQ(sum.load(), 500500);
+}
+
+TEST(ThreadPoolTest, WorkersRunTasksWithoutWaiting) {
+  nll::parallel::ThreadPool pool(Threads(2));
+  std::atomic<bool> ran{false};
+  std::atomic<bool> on_worker{false};
+  nll::parallel::TaskGroup group(pool);
+  group.Run([&] {
+    on_worker = pool.IsWorkerThread();
+    ran = true;
+  });
+  // Not waiting on the group, so only a worker can pick the task up
+  while (!ran.load()) {
+    std::this_thread::yield();
+  }
+  ASSERT_TRUE(on_worker.load());
+  group.Wait();
+}
+
+TEST(ThreadPoolTest, NestedGroups) {
+  nll::parallel::ThreadPool pool(Threads(4));
+  ASSERT_EQ(Fibonacci(pool, 20), 6765);
+}
+
+TEST(ThreadPoolTest, WaitRethrowsTaskException) {
+  nll::parallel::ThreadPool pool(Threads(2));
+  nll::parallel::TaskGroup group(pool);
+  std::atomic<int> finished{0};
+  for (int i = 0; i < 10; i++) {
+    group.Run([&, i] {
+      if (i == 5) {
+        throw std::runtime_error("task failed!");
+      }
+      finished++;
+    });
+  }
+  ASSERT_THROW(group.Wait(), std::runtime_error);
+  ASSERT_EQ(finished.load(), 9);
+  // The group is usable again once the error was reported
+  group.Run([&] { finished++; });
+  group.Wait();
+  ASSERT_EQ(finished.load(), 10);
+}
+
+TEST(ThreadPoolTest, PinnedWorkersRun) {
+  auto options = Threads(2);
+  options.pin_threads = true;
+  nll::parallel::ThreadPool pool(options);
+  std::atomic<int> count{0};
+  nll::parallel::TaskGroup group(pool);
+  for (int i = 0; i < 100; i++) {
+    group.Run([&] { count++; });
+  }
+  group.Wait();
+  ASSERT_EQ(count.load(), 100);
+}
+
+TEST(ThreadPoolTest, WorkersWakeAfterSleeping) {
+  nll::parallel::ThreadPool pool(Threads(2));
+  for (int round = 0; round < 3; round++) {
+    // Long enough for the workers to give up spinning
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::atomic<int> count{0};
+    nll::parallel::TaskGroup group(pool);
+    for (int i = 0; i < 50; i++) {
+      group.Run([&] { count++; });
+    }
+    group.Wait();
+    ASSERT_EQ(count.load(), 50);
+  }
+}